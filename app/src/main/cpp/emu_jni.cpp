@@ -10,6 +10,10 @@
 #include "skyline/common/signal.h"
 #include "skyline/common/android_settings.h"
 #include "skyline/common/trace.h"
+#include "skyline/common/call_profiler.h"
+#include "skyline/common/frame_statistics.h"
+#include "skyline/common/memory_report.h"
+#include "skyline/common/benchmark.h"
 #include "skyline/loader/loader.h"
 #include "skyline/vfs/android_asset_filesystem.h"
 #include "skyline/os.h"
@@ -22,6 +26,8 @@
 jint Fps; //!< An approximation of the amount of frames being submitted every second
 jfloat AverageFrametimeMs; //!< The average time it takes for a frame to be rendered and presented in milliseconds
 jfloat AverageFrametimeDeviationMs; //!< The average deviation of the average frametimes in milliseconds
+jfloat AveragePresentLatencyMs; //!< The average time between a frame being queued for presentation and it being displayed in milliseconds
+jint DroppedFrames; //!< The amount of frames that were displayed later than the refresh they were scheduled for
 
 std::weak_ptr<skyline::kernel::OS> OsWeak;
 std::weak_ptr<skyline::gpu::GPU> GpuWeak;
@@ -79,7 +85,8 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
 ) {
     skyline::signal::ScopedStackBlocker stackBlocker; // We do not want anything to unwind past JNI code as there are invalid stack frames which can lead to a segmentation fault
     Fps = 0;
-    AverageFrametimeMs = AverageFrametimeDeviationMs = 0.0f;
+    AverageFrametimeMs = AverageFrametimeDeviationMs = AveragePresentLatencyMs = 0.0f;
+    DroppedFrames = 0;
 
     pthread_setname_np(pthread_self(), "EmuMain");
 
@@ -95,6 +102,8 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
     // Initialize tracing
     perfetto::TracingInitArgs args;
     args.backends |= perfetto::kSystemBackend;
+    if (*settings->flightRecorderThreshold)
+        args.backends |= perfetto::kInProcessBackend; // The flight recorder traces into an in-process ring buffer
     perfetto::Tracing::Initialize(args);
     perfetto::TrackEvent::Register();
 
@@ -130,6 +139,8 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_executeApplication(
     }
 
     perfetto::TrackEvent::Flush();
+    if (skyline::Logger::configLevel >= skyline::Logger::LogLevel::Debug)
+        skyline::Logger::DebugNoPrefix("SVC and service command profile:\n{}", skyline::CallProfiler::Dump());
 
     InputWeak.reset();
 
@@ -151,6 +162,10 @@ extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_stopEmulation(J
     return true;
 }
 
+extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_configureBenchmark(JNIEnv *env, jobject, jint frames, jstring scriptPathJstring) {
+    skyline::Benchmark::Configure(static_cast<skyline::u32>(std::max(frames, 0)), scriptPathJstring ? skyline::JniString(env, scriptPathJstring) : std::string{});
+}
+
 extern "C" JNIEXPORT jboolean Java_emu_skyline_EmulationActivity_setSurface(JNIEnv *, jobject, jobject surface) {
     auto gpu{GpuWeak.lock()};
     if (!gpu)
@@ -187,6 +202,69 @@ extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_updatePerformanceSt
     if (!averageFrametimeDeviationField)
         averageFrametimeDeviationField = env->GetFieldID(clazz, "averageFrametimeDeviation", "F");
     env->SetFloatField(thiz, averageFrametimeDeviationField, AverageFrametimeDeviationMs);
+
+    static jfieldID averagePresentLatencyField{};
+    if (!averagePresentLatencyField)
+        averagePresentLatencyField = env->GetFieldID(clazz, "averagePresentLatency", "F");
+    env->SetFloatField(thiz, averagePresentLatencyField, AveragePresentLatencyMs);
+
+    static jfieldID droppedFramesField{};
+    if (!droppedFramesField)
+        droppedFramesField = env->GetFieldID(clazz, "droppedFrames", "I");
+    env->SetIntField(thiz, droppedFramesField, DroppedFrames);
+}
+
+extern "C" JNIEXPORT jfloatArray Java_emu_skyline_EmulationActivity_getFrameStatistics(JNIEnv *env, jobject) {
+    using skyline::FrameStatistics;
+    std::array<FrameStatistics::FrameRecord, FrameStatistics::HistorySize> frames;
+    size_t frameCount{FrameStatistics::ReadFrames(frames)};
+
+    // The layout is the amount of frames, their average frametime, the average time spent in every phase in milliseconds and the total amount of shader compilations
+    std::array<jfloat, 3 + FrameStatistics::PhaseCount> values{static_cast<jfloat>(frameCount)};
+    if (frameCount) {
+        skyline::u64 frametimeNs{}, shaderCompiles{};
+        std::array<skyline::u64, FrameStatistics::PhaseCount> phaseNs{};
+        for (const auto &frame : skyline::span(frames).first(frameCount)) {
+            frametimeNs += frame.frametimeNs;
+            shaderCompiles += frame.shaderCompiles;
+            for (size_t phase{}; phase < FrameStatistics::PhaseCount; phase++)
+                phaseNs[phase] += frame.phaseNs[phase];
+        }
+
+        auto averageMs{[frameCount](skyline::u64 totalNs) { return static_cast<jfloat>(totalNs) / static_cast<jfloat>(frameCount) / skyline::constant::NsInMillisecond; }};
+        values[1] = averageMs(frametimeNs);
+        for (size_t phase{}; phase < FrameStatistics::PhaseCount; phase++)
+            values[2 + phase] = averageMs(phaseNs[phase]);
+        values.back() = static_cast<jfloat>(shaderCompiles);
+    }
+
+    auto array{env->NewFloatArray(static_cast<jsize>(values.size()))};
+    env->SetFloatArrayRegion(array, 0, static_cast<jsize>(values.size()), values.data());
+    return array;
+}
+
+extern "C" JNIEXPORT jstring Java_emu_skyline_EmulationActivity_dumpCallProfile(JNIEnv *env, jobject) {
+    return env->NewStringUTF(skyline::CallProfiler::Dump().c_str());
+}
+
+extern "C" JNIEXPORT jstring Java_emu_skyline_EmulationActivity_dumpAudioStatistics(JNIEnv *env, jobject) {
+    auto audio{AudioWeak.lock()};
+    return env->NewStringUTF(audio ? audio->DumpStatistics().c_str() : "");
+}
+
+extern "C" JNIEXPORT jstring Java_emu_skyline_EmulationActivity_dumpMemoryUsage(JNIEnv *env, jobject) {
+    auto os{OsWeak.lock()};
+    return env->NewStringUTF(os ? skyline::MemoryReport::Collect(os->state).Format().c_str() : "");
+}
+
+extern "C" JNIEXPORT jstring Java_emu_skyline_EmulationActivity_dumpGuestProfile(JNIEnv *env, jobject) {
+    auto os{OsWeak.lock()};
+    return env->NewStringUTF((os && os->guestProfiler) ? os->guestProfiler->Dump().c_str() : "");
+}
+
+extern "C" JNIEXPORT void Java_emu_skyline_EmulationActivity_trimMemory(JNIEnv *, jobject) {
+    if (auto os{OsWeak.lock()})
+        skyline::MemoryReport::Trim(os->state);
 }
 
 extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Companion_setController(JNIEnv *, jobject, jint index, jint type, jint partnerIndex) {
@@ -203,18 +281,14 @@ extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Compa
     auto input{InputWeak.lock()};
     if (!input)
         return; // We don't mind if we miss button updates while input hasn't been initialized
-    auto device{input->npad.controllers[static_cast<size_t>(index)].device};
-    if (device)
-        device->SetButtonState(skyline::input::NpadButton{.raw = static_cast<skyline::u64>(mask)}, pressed);
+    input->QueueButtonState(static_cast<size_t>(index), skyline::input::NpadButton{.raw = static_cast<skyline::u64>(mask)}, pressed);
 }
 
 extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Companion_setAxisValue(JNIEnv *, jobject, jint index, jint axis, jint value) {
     auto input{InputWeak.lock()};
     if (!input)
         return; // We don't mind if we miss axis updates while input hasn't been initialized
-    auto device{input->npad.controllers[static_cast<size_t>(index)].device};
-    if (device)
-        device->SetAxisValue(static_cast<skyline::input::NpadAxisId>(axis), value);
+    input->QueueAxisValue(static_cast<size_t>(index), static_cast<skyline::input::NpadAxisId>(axis), value);
 }
 
 extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Companion_setMotionState(JNIEnv *env, jobject, jint index, jint motionId, jobject value) {
@@ -223,10 +297,7 @@ extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Compa
         return; // We don't mind if we miss motion updates while input hasn't been initialized
 
     const auto motionValue = reinterpret_cast<skyline::input::MotionSensorState*>(env->GetDirectBufferAddress(value));
-
-    auto device{input->npad.controllers[static_cast<size_t>(index)].device};
-    if (device)
-        device->SetMotionValue(static_cast<skyline::input::MotionId>(motionId), motionValue);
+    input->QueueMotionValue(static_cast<size_t>(index), static_cast<skyline::input::MotionId>(motionId), *motionValue);
 }
 
 extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Companion_setTouchState(JNIEnv *env, jobject, jintArray pointsJni) {
@@ -239,7 +310,7 @@ extern "C" JNIEXPORT void JNICALL Java_emu_skyline_input_InputHandler_00024Compa
 
     skyline::span<Point> points(reinterpret_cast<Point *>(env->GetIntArrayElements(pointsJni, &isCopy)),
                                 static_cast<size_t>(env->GetArrayLength(pointsJni)) / (sizeof(Point) / sizeof(jint)));
-    input->touch.SetState(points);
+    input->QueueTouchState(points);
     env->ReleaseIntArrayElements(pointsJni, reinterpret_cast<jint *>(points.data()), JNI_ABORT);
 }
 
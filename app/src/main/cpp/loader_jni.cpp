@@ -10,15 +10,44 @@
 #include "skyline/loader/nca.h"
 #include "skyline/loader/xci.h"
 #include "skyline/loader/nsp.h"
+#include "skyline/loader/metadata_cache.h"
 #include "skyline/jvm.h"
 
-extern "C" JNIEXPORT jint JNICALL Java_emu_skyline_loader_RomFile_populate(JNIEnv *env, jobject thiz, jint jformat, jint fd, jstring appFilesPathJstring, jint systemLanguage) {
+extern "C" JNIEXPORT jint JNICALL Java_emu_skyline_loader_RomFile_populate(JNIEnv *env, jobject thiz, jint jformat, jint fd, jstring appFilesPathJstring, jstring metadataCachePathJstring, jint systemLanguage) {
     skyline::signal::ScopedStackBlocker stackBlocker;
 
     skyline::loader::RomFormat format{static_cast<skyline::loader::RomFormat>(jformat)};
 
     skyline::Logger::SetContext(&skyline::Logger::LoaderContext);
 
+    jclass clazz{env->GetObjectClass(thiz)};
+    jfieldID applicationNameField{env->GetFieldID(clazz, "applicationName", "Ljava/lang/String;")};
+    jfieldID applicationTitleIdField{env->GetFieldID(clazz, "applicationTitleId", "Ljava/lang/String;")};
+    jfieldID applicationAuthorField{env->GetFieldID(clazz, "applicationAuthor", "Ljava/lang/String;")};
+    jfieldID rawIconField{env->GetFieldID(clazz, "rawIcon", "[B")};
+    jfieldID applicationVersionField{env->GetFieldID(clazz, "applicationVersion", "Ljava/lang/String;")};
+
+    auto populateFields{[&](const skyline::loader::RomMetadata &metadata) {
+        env->SetObjectField(thiz, applicationNameField, env->NewStringUTF(metadata.applicationName.c_str()));
+        env->SetObjectField(thiz, applicationVersionField, env->NewStringUTF(metadata.applicationVersion.c_str()));
+        env->SetObjectField(thiz, applicationTitleIdField, env->NewStringUTF(metadata.applicationTitleId.c_str()));
+        env->SetObjectField(thiz, applicationAuthorField, env->NewStringUTF(metadata.applicationAuthor.c_str()));
+
+        jbyteArray iconByteArray{env->NewByteArray(static_cast<jsize>(metadata.icon.size()))};
+        env->SetByteArrayRegion(iconByteArray, 0, static_cast<jsize>(metadata.icon.size()), reinterpret_cast<const jbyte *>(metadata.icon.data()));
+        env->SetObjectField(thiz, rawIconField, iconByteArray);
+    }};
+
+    // Fully parsing a ROM requires deriving keys and decrypting its NCAs, so the metadata of ROMs which haven't changed since the last scan is read from the cache
+    skyline::loader::MetadataCache metadataCache{skyline::JniString(env, metadataCachePathJstring)};
+    auto cacheKey{skyline::loader::MetadataCache::GetKey(fd, static_cast<skyline::u32>(systemLanguage))};
+    if (cacheKey) {
+        if (auto metadata{metadataCache.Read(*cacheKey)}) {
+            populateFields(*metadata);
+            return static_cast<jint>(skyline::loader::LoaderResult::Success);
+        }
+    }
+
     auto keyStore{std::make_shared<skyline::crypto::KeyStore>(skyline::JniString(env, appFilesPathJstring))};
     std::unique_ptr<skyline::loader::Loader> loader;
     try {
@@ -49,27 +78,22 @@ extern "C" JNIEXPORT jint JNICALL Java_emu_skyline_loader_RomFile_populate(JNIEn
         return static_cast<jint>(skyline::loader::LoaderResult::ParsingError);
     }
 
-    jclass clazz{env->GetObjectClass(thiz)};
-    jfieldID applicationNameField{env->GetFieldID(clazz, "applicationName", "Ljava/lang/String;")};
-    jfieldID applicationTitleIdField{env->GetFieldID(clazz, "applicationTitleId", "Ljava/lang/String;")};
-    jfieldID applicationAuthorField{env->GetFieldID(clazz, "applicationAuthor", "Ljava/lang/String;")};
-    jfieldID rawIconField{env->GetFieldID(clazz, "rawIcon", "[B")};
-    jfieldID applicationVersionField{env->GetFieldID(clazz, "applicationVersion", "Ljava/lang/String;")};
-
     if (loader->nacp) {
         auto language{skyline::language::GetApplicationLanguage(static_cast<skyline::language::SystemLanguage>(systemLanguage))};
         if (((1 << static_cast<skyline::u32>(language)) & loader->nacp->supportedTitleLanguages) == 0)
             language = loader->nacp->GetFirstSupportedTitleLanguage();
 
-        env->SetObjectField(thiz, applicationNameField, env->NewStringUTF(loader->nacp->GetApplicationName(language).c_str()));
-        env->SetObjectField(thiz, applicationVersionField, env->NewStringUTF(loader->nacp->GetApplicationVersion().c_str()));
-        env->SetObjectField(thiz, applicationTitleIdField, env->NewStringUTF(loader->nacp->GetSaveDataOwnerId().c_str()));
-        env->SetObjectField(thiz, applicationAuthorField, env->NewStringUTF(loader->nacp->GetApplicationPublisher(language).c_str()));
+        skyline::loader::RomMetadata metadata{
+            .applicationName = loader->nacp->GetApplicationName(language),
+            .applicationVersion = loader->nacp->GetApplicationVersion(),
+            .applicationTitleId = loader->nacp->GetSaveDataOwnerId(),
+            .applicationAuthor = loader->nacp->GetApplicationPublisher(language),
+            .icon = loader->GetIcon(language),
+        };
 
-        auto icon{loader->GetIcon(language)};
-        jbyteArray iconByteArray{env->NewByteArray(static_cast<jsize>(icon.size()))};
-        env->SetByteArrayRegion(iconByteArray, 0, static_cast<jsize>(icon.size()), reinterpret_cast<const jbyte *>(icon.data()));
-        env->SetObjectField(thiz, rawIconField, iconByteArray);
+        populateFields(metadata);
+        if (cacheKey)
+            metadataCache.Write(*cacheKey, metadata);
     }
 
     return static_cast<jint>(skyline::loader::LoaderResult::Success);
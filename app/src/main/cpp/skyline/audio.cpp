@@ -1,6 +1,10 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <common/trace.h>
+#include <audio/mixer.h>
 #include "audio.h"
 
 namespace skyline::audio {
@@ -10,24 +14,80 @@ namespace skyline::audio {
         builder.setChannelCount(constant::StereoChannelCount);
         builder.setSampleRate(constant::SampleRate);
         builder.setFormat(constant::PcmFormat);
+        builder.setFormatConversionAllowed(true); // Devices which can't output floats natively have samples converted by Oboe rather than failing to open
         builder.setUsage(oboe::Usage::Game);
         builder.setCallback(this);
         builder.setSharingMode(oboe::SharingMode::Exclusive);
         builder.setPerformanceMode(oboe::PerformanceMode::LowLatency);
 
+        releaseThread = std::thread(&Audio::ReleaseThread, this);
+
         builder.openManagedStream(outputStream);
         outputStream->requestStart();
     }
 
     Audio::~Audio() {
         outputStream->requestStop();
+        outputStream->close(); // This waits for the callback to return so the published snapshot can be freed
+
+        exitRelease = true;
+        WakeReleaseThread();
+        releaseThread.join();
+
+        delete publishedTracks.load();
+    }
+
+    void Audio::PublishTracks() {
+        auto previousTracks{publishedTracks.exchange(new TrackList{audioTracks})};
+
+        // The callback may still be reading the previous snapshot if it was running during the exchange, we wait for that invocation to exit as it's bounded by the duration of a single callback
+        auto sequence{callbackSequence.load()};
+        if (sequence & 1)
+            while (callbackSequence.load() == sequence)
+                std::this_thread::yield();
+
+        delete previousTracks;
+    }
+
+    void Audio::WakeReleaseThread() {
+        releaseFutex.fetch_add(1, std::memory_order_release);
+        syscall(SYS_futex, reinterpret_cast<u32 *>(&releaseFutex), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+    void Audio::ReleaseThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-AudioRelease")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        while (true) {
+            // The futex value is read prior to checking the tracks so any wake that occurs during the check will cause the wait to return immediately
+            u32 value{releaseFutex.load(std::memory_order_acquire)};
+            if (exitRelease)
+                return;
+
+            {
+                std::scoped_lock trackGuard{trackLock};
+                for (size_t index{}; index < audioTracks.size(); index++) {
+                    auto &track{audioTracks[index]};
+                    std::scoped_lock bufferGuard{track->bufferLock};
+                    track->CheckReleasedBuffers();
+
+                    // Perfetto requires counter names to be static strings, so only a fixed amount of tracks have their fill level traced
+                    constexpr std::array<const char *, 4> TrackFillCounterNames{"Audio Track 0 Fill", "Audio Track 1 Fill", "Audio Track 2 Fill", "Audio Track 3 Fill"};
+                    if (index < TrackFillCounterNames.size())
+                        TRACE_COUNTER("audio", perfetto::CounterTrack{TrackFillCounterNames[index], "samples"}, track->samples.Size());
+                }
+            }
+
+            syscall(SYS_futex, reinterpret_cast<u32 *>(&releaseFutex), FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+        }
     }
 
     std::shared_ptr<AudioTrack> Audio::OpenTrack(u8 channelCount, u32 sampleRate, const std::function<void()> &releaseCallback) {
         std::scoped_lock trackGuard{trackLock};
 
-        auto track{std::make_shared<AudioTrack>(channelCount, sampleRate, releaseCallback)};
+        auto track{std::make_shared<AudioTrack>(channelCount, sampleRate, releaseCallback, *settings->audioTimeStretching)};
         audioTracks.push_back(track);
+        PublishTracks();
 
         return track;
     }
@@ -36,40 +96,106 @@ namespace skyline::audio {
         std::scoped_lock trackGuard{trackLock};
 
         audioTracks.erase(std::remove(audioTracks.begin(), audioTracks.end(), track), audioTracks.end());
+        PublishTracks();
     }
 
-    oboe::DataCallbackResult Audio::onAudioReady(oboe::AudioStream *audioStream, void *audioData, int32_t numFrames) {
-        auto destBuffer{static_cast<i16 *>(audioData)};
-        auto streamSamples{static_cast<size_t>(numFrames) * static_cast<size_t>(audioStream->getChannelCount())};
-        size_t writtenSamples{};
+    std::string Audio::DumpStatistics() {
+        std::string report{statistics.callback.Format("Audio Callback")};
+        report += statistics.requestUpdate.Format("Renderer RequestUpdate");
+        report += statistics.rendererMix.Format("Renderer Mix");
+        report += statistics.voiceMix.Format("Voice Mix");
+
+        std::scoped_lock trackGuard{trackLock};
+        for (size_t index{}; index < audioTracks.size(); index++) {
+            auto &track{audioTracks[index]};
+            auto bufferedSamples{track->samples.Size()};
+            report += util::Format("Track {}: {} samples buffered ({:.1f}ms), {} underruns\n", index, bufferedSamples, static_cast<double>(bufferedSamples) / constant::StereoChannelCount / constant::SampleRate * 1000.0, track->underrunCount.load(std::memory_order_relaxed));
+        }
+        return report;
+    }
 
+    u64 Audio::GetUnderrunCount() {
+        std::scoped_lock trackGuard{trackLock};
+        u64 count{};
+        for (const auto &track : audioTracks)
+            count += track->underrunCount.load(std::memory_order_relaxed);
+        return count;
+    }
+
+    size_t Audio::GetMemoryUsage() {
+        size_t trackCount;
         {
             std::scoped_lock trackGuard{trackLock};
+            trackCount = audioTracks.size();
+        }
+        return trackCount * sizeof(AudioTrack) + adpcmCache.GetCachedSize();
+    }
+
+    oboe::DataCallbackResult Audio::onAudioReady(oboe::AudioStream *audioStream, void *audioData, int32_t numFrames) {
+        TRACE_EVENT("audio", "onAudioReady");
+        auto startTime{util::GetTimeNs()};
+
+        // The callback thread is owned by Oboe so its affinity can only be set from within the callback, this is redone if the stream is recreated on a new thread
+        thread_local bool affinitySet{};
+        if (!affinitySet) {
+            host::Topology::Get().SetThreadAffinity(*settings->audioAffinity);
+            affinitySet = true;
+        }
 
-            for (auto &track : audioTracks) {
-                if (track->playbackState == AudioOutState::Stopped)
+        auto destBuffer{static_cast<float *>(audioData)};
+        auto streamSamples{static_cast<size_t>(numFrames) * static_cast<size_t>(audioStream->getChannelCount())};
+        size_t writtenSamples{};
+        bool releasePending{};
+
+        // This is a real-time thread so it must never block on any locks that guest threads could hold, the tracks are accessed through a snapshot and their samples through lock-free ring buffers
+        callbackSequence.fetch_add(1);
+        if (auto tracks{publishedTracks.load()}) {
+            bool outputDisabled{*settings->isAudioOutputDisabled};
+            for (auto &track : *tracks) {
+                if (track->playbackState.load(std::memory_order_relaxed) == AudioOutState::Stopped)
                     continue;
 
-                std::scoped_lock bufferGuard{track->bufferLock};
+                // Samples are summed with any samples that prior tracks have written and copied past that, they're still consumed when output is disabled for buffers to be released at the same rate
+                auto trackSamples{track->samples.Read(streamSamples, [&](span<const float> source, size_t offset) {
+                    if (outputDisabled)
+                        return;
 
-                if (!*settings->isAudioOutputDisabled) {
-                    auto trackSamples{track->samples.Read(span(destBuffer, streamSamples), [](i16 *source, i16 *destination) {
-                        *destination = Saturate<i16, i32>(static_cast<u32>(*destination) + static_cast<u32>(*source));
-                    }, static_cast<ssize_t>(writtenSamples))};
+                    float *destination{destBuffer + offset};
+                    size_t mixedSamples{writtenSamples > offset ? std::min(writtenSamples - offset, source.size()) : 0};
+                    MixFloat(destination, source.data(), mixedSamples);
+                    std::memcpy(destination + mixedSamples, source.data() + mixedSamples, (source.size() - mixedSamples) * sizeof(float));
+                })};
 
+                if (!outputDisabled)
                     writtenSamples = std::max(trackSamples, writtenSamples);
 
-                    track->sampleCounter += trackSamples;
+                // Only the transition into running out of samples is counted, so a track that's idle isn't counted as underrunning on every callback
+                if (trackSamples < streamSamples) {
+                    if (!track->starved) {
+                        track->underrunCount.fetch_add(1, std::memory_order_relaxed);
+                        TRACE_EVENT_INSTANT("audio", "Underrun");
+                    }
+                    track->starved = true;
                 } else {
-                    track->sampleCounter += streamSamples;
+                    track->starved = false;
                 }
-                track->CheckReleasedBuffers();
+
+                auto playedSamples{track->sampleCounter.load(std::memory_order_relaxed) + trackSamples};
+                track->sampleCounter.store(playedSamples, std::memory_order_release);
+                releasePending |= playedSamples >= track->nextReleaseSample.load(std::memory_order_acquire);
             }
         }
+        callbackSequence.fetch_add(1);
+
+        if (releasePending)
+            WakeReleaseThread(); // Signalling the guest can block on kernel locks so it's deferred to the release thread
 
+        // Samples are only clamped once all tracks have been mixed, so intermediate sums can exceed the output range without clipping
+        ClampFloat(destBuffer, writtenSamples);
         if (streamSamples > writtenSamples)
-            memset(destBuffer + writtenSamples, 0, (streamSamples - writtenSamples) * sizeof(i16));
+            std::fill(destBuffer + writtenSamples, destBuffer + streamSamples, 0.0f);
 
+        statistics.callback.Record(static_cast<u64>(util::GetTimeNs() - startTime));
         return oboe::DataCallbackResult::Continue;
     }
 
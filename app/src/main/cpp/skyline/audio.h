@@ -5,6 +5,8 @@
 
 #include <common/settings.h>
 #include <audio/track.h>
+#include <audio/adpcm_decoder.h>
+#include <audio/statistics.h>
 
 namespace skyline::audio {
     /**
@@ -14,11 +16,35 @@ namespace skyline::audio {
       private:
         oboe::AudioStreamBuilder builder;
         oboe::ManagedStream outputStream;
-        std::vector<std::shared_ptr<AudioTrack>> audioTracks;
-        std::mutex trackLock; //!< Synchronizes modifications to the audio tracks
+        using TrackList = std::vector<std::shared_ptr<AudioTrack>>;
+
+        TrackList audioTracks;
+        std::mutex trackLock; //!< Synchronizes modifications to the audio tracks, this is never locked by the audio callback
+        std::atomic<const TrackList *> publishedTracks{}; //!< An immutable snapshot of the audio tracks which is read by the audio callback, this is replaced with a new snapshot whenever the tracks are modified
+        std::atomic<u32> callbackSequence{}; //!< A counter incremented on entry and exit from the audio callback, it's odd while the callback is running and is used to determine when a replaced snapshot can be freed
         std::shared_ptr<Settings> settings;
 
+        std::thread releaseThread; //!< A thread which checks for released buffers and signals the guest on behalf of the audio callback as that can block
+        std::atomic<u32> releaseFutex{}; //!< A futex word which is advanced to wake the release thread
+        std::atomic<bool> exitRelease{}; //!< If the release thread should exit
+
+        /**
+         * @brief Publishes a new snapshot of the audio tracks to the audio callback and frees the prior one once the callback can't be using it anymore
+         * @note trackLock MUST be locked when calling this
+         */
+        void PublishTracks();
+
+        /**
+         * @brief Wakes the release thread, this never blocks so it can be called from the audio callback
+         */
+        void WakeReleaseThread();
+
+        void ReleaseThread();
+
       public:
+        AdpcmCache adpcmCache; //!< A cache of decoded ADPCM buffers shared across all audio renderers
+        AudioStatistics statistics;
+
         Audio(const DeviceState &state);
 
         ~Audio();
@@ -45,6 +71,21 @@ namespace skyline::audio {
          */
         void CloseTrack(std::shared_ptr<AudioTrack> &track);
 
+        /**
+         * @return A report of the timing statistics of every stage of the audio pipeline alongside the fill level and underruns of every track
+         */
+        std::string DumpStatistics();
+
+        /**
+         * @return The total amount of underruns of all open tracks
+         */
+        u64 GetUnderrunCount();
+
+        /**
+         * @return The amount of memory in bytes that is used by the sample buffers of all tracks and the ADPCM cache
+         */
+        size_t GetMemoryUsage();
+
         /**
          * @brief The callback oboe uses to get audio sample data
          * @param audioStream The audio stream we are being called by
@@ -1,52 +1,104 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <arm_neon.h>
+#include <xxhash.h>
 #include "common.h"
 #include "adpcm_decoder.h"
 
 namespace skyline::audio {
-    AdpcmDecoder::AdpcmDecoder(std::vector<std::array<i16, 2>> coefficients) : coefficients(std::move(coefficients)) {}
+    std::shared_ptr<const std::vector<i16>> AdpcmCache::Lookup(const Key &key, std::array<i32, 2> &history) {
+        std::scoped_lock lock{mutex};
+        auto entry{std::find_if(entries.begin(), entries.end(), [&](const Entry &entry) { return entry.key == key; })};
+        if (entry == entries.end())
+            return nullptr;
 
-    std::vector<i16> AdpcmDecoder::Decode(span<u8> adpcmData) {
-        constexpr size_t BytesPerFrame{0x8};
-        constexpr size_t SamplesPerFrame{0xE};
+        entries.splice(entries.begin(), entries, entry);
+        history = entry->history;
+        return entry->samples;
+    }
 
-        size_t remainingSamples{(adpcmData.size() / BytesPerFrame) * SamplesPerFrame};
+    void AdpcmCache::Insert(const Key &key, std::shared_ptr<const std::vector<i16>> samples, const std::array<i32, 2> &history) {
+        if (samples->size() > MaxCachedSamples)
+            return;
 
-        std::vector<i16> output;
-        output.reserve(remainingSamples);
+        std::scoped_lock lock{mutex};
+        // Another voice may have decoded the same buffer concurrently, in which case it'll already be present
+        if (std::any_of(entries.begin(), entries.end(), [&](const Entry &entry) { return entry.key == key; }))
+            return;
 
-        size_t inputOffset{};
+        while (cachedSamples + samples->size() > MaxCachedSamples) {
+            cachedSamples -= entries.back().samples->size();
+            entries.pop_back();
+        }
 
-        while (inputOffset < adpcmData.size()) {
-            FrameHeader header{adpcmData[inputOffset++]};
+        cachedSamples += samples->size();
+        entries.push_front(Entry{key, std::move(samples), history});
+    }
 
-            size_t frameSamples{std::min(SamplesPerFrame, remainingSamples)};
+    size_t AdpcmCache::GetCachedSize() {
+        std::scoped_lock lock{mutex};
+        return cachedSamples * sizeof(i16);
+    }
 
-            i32 ctx{};
+    void AdpcmCache::Clear() {
+        std::scoped_lock lock{mutex};
+        entries.clear();
+        cachedSamples = 0;
+    }
 
-            for (size_t index{}; index < frameSamples; index++) {
-                i32 sample{};
+    AdpcmDecoder::AdpcmDecoder(span<const std::array<i16, 2>> pCoefficients) {
+        span(coefficients).copy_from(pCoefficients, std::min(pCoefficients.size(), coefficients.size()));
+        coefficientHash = XXH3_64bits(coefficients.data(), sizeof(coefficients));
+    }
 
-                if (index & 1) {
-                    sample = (ctx << 28) >> 28;
-                } else {
-                    ctx = adpcmData[inputOffset++];
-                    sample = (ctx << 24) >> 28;
-                }
+    void AdpcmDecoder::DecodeFrames(span<const u8> adpcmData, span<i16> outputBuffer) {
+        i16 *output{outputBuffer.data()};
+        // Any trailing partial frame is ignored as it can't contain a complete set of samples
+        for (size_t inputOffset{}; inputOffset + BytesPerFrame <= adpcmData.size(); inputOffset += BytesPerFrame) {
+            FrameHeader header{adpcmData[inputOffset]};
+            const auto &coefficient{coefficients[header.coefficientIndex]};
 
-                i32 prediction{history[0] * coefficients[header.coefficientIndex][0] + history[1] * coefficients[header.coefficientIndex][1]};
-                sample = (sample * (0x800 << header.scale) + prediction + 0x400) >> 11;
+            // The nibbles of an entire frame are sign-extended and scaled together, only the prediction depends on prior samples and has to be done serially
+            std::array<i32, 16> scaled;
+            int8x8_t bytes{vreinterpret_s8_u8(vext_u8(vld1_u8(adpcmData.data() + inputOffset), vdup_n_u8(0), 1))}; // The header is shifted out of the frame
+            int8x8x2_t nibbles{vzip_s8(vshr_n_s8(bytes, 4), vshr_n_s8(vshl_n_s8(bytes, 4), 4))}; // The high nibble of each byte is the earlier sample
+            int32x4_t shift{vdupq_n_s32(11 + header.scale)};
+            for (size_t half{}; half < 2; half++) {
+                int16x8_t wide{vmovl_s8(nibbles.val[half])};
+                vst1q_s32(scaled.data() + half * 8, vshlq_s32(vmovl_s16(vget_low_s16(wide)), shift));
+                vst1q_s32(scaled.data() + half * 8 + 4, vshlq_s32(vmovl_high_s16(wide), shift));
+            }
 
-                auto saturated{audio::Saturate<i16, i32>(sample)};
-                output.push_back(saturated);
+            for (size_t index{}; index < SamplesPerFrame; index++) {
+                i32 prediction{history[0] * coefficient[0] + history[1] * coefficient[1]};
+                auto saturated{audio::Saturate<i16, i32>((scaled[index] + prediction + 0x400) >> 11)};
+                *output++ = saturated;
                 history[1] = history[0];
                 history[0] = saturated;
             }
-
-            remainingSamples -= frameSamples;
         }
+    }
+
+    std::shared_ptr<const std::vector<i16>> AdpcmDecoder::DecodeCached(span<const u8> adpcmData, AdpcmCache &cache) {
+        if (adpcmData.size() > AdpcmCache::MaxBufferSize)
+            return nullptr;
+
+        // Hashing the data is far cheaper than decoding it, so misses only add a small overhead
+        AdpcmCache::Key key{
+            .address = adpcmData.data(),
+            .size = adpcmData.size(),
+            .dataHash = XXH3_64bits(adpcmData.data(), adpcmData.size()),
+            .coefficientHash = coefficientHash,
+            .history = history,
+        };
+        if (auto samples{cache.Lookup(key, history)})
+            return samples;
 
-        return output;
+        // Only misses allocate, which happens once for every distinct buffer while it remains cached
+        auto samples{std::make_shared<std::vector<i16>>((adpcmData.size() / BytesPerFrame) * SamplesPerFrame)};
+        DecodeFrames(adpcmData, *samples);
+        cache.Insert(key, samples, history);
+        return samples;
     }
 }
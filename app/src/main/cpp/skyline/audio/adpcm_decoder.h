@@ -3,9 +3,66 @@
 
 #pragma once
 
+#include <list>
 #include <common.h>
 
 namespace skyline::audio {
+    /**
+     * @brief A small LRU cache of decoded ADPCM buffers, this avoids repeatedly decoding short sound effects which are played many times over
+     * @note Entries are keyed on a hash of the ADPCM data alongside its address, so they remain correct when the guest reuses memory for a different buffer
+     */
+    class AdpcmCache {
+      public:
+        static constexpr size_t MaxBufferSize{0x8000}; //!< The largest ADPCM buffer that will be cached in bytes, larger buffers are usually streamed music which won't be replayed soon enough to benefit
+        static constexpr size_t MaxCachedSamples{0x200000}; //!< The maximum amount of decoded samples held by the cache (4 MiB)
+
+        /**
+         * @brief The state which uniquely determines the output of decoding an ADPCM buffer
+         */
+        struct Key {
+            const u8 *address;
+            size_t size;
+            u64 dataHash; //!< An XXH3 hash of the ADPCM data
+            u64 coefficientHash; //!< An XXH3 hash of the coefficients the data is decoded with
+            std::array<i32, 2> history; //!< The decoder history prior to decoding the buffer
+
+            bool operator==(const Key &) const = default;
+        };
+
+      private:
+        struct Entry {
+            Key key;
+            std::shared_ptr<const std::vector<i16>> samples; //!< The decoded samples, these are shared with any voices playing them so eviction doesn't invalidate them
+            std::array<i32, 2> history; //!< The decoder history after decoding the buffer
+        };
+
+        std::mutex mutex; //!< Synchronizes access to the cache as voices can be decoded from multiple threads
+        std::list<Entry> entries; //!< The cached entries in order of most to least recently used
+        size_t cachedSamples{}; //!< The total amount of samples across all entries
+
+      public:
+        /**
+         * @param history The decoder history which is set to the history after decoding the buffer on a hit
+         * @return The decoded samples for the supplied key if they're cached, otherwise nullptr
+         */
+        std::shared_ptr<const std::vector<i16>> Lookup(const Key &key, std::array<i32, 2> &history);
+
+        /**
+         * @brief Inserts the decoded samples for the supplied key, evicting the least recently used entries to make space for them
+         */
+        void Insert(const Key &key, std::shared_ptr<const std::vector<i16>> samples, const std::array<i32, 2> &history);
+
+        /**
+         * @return The amount of memory in bytes that is used by decoded samples in the cache
+         */
+        size_t GetCachedSize();
+
+        /**
+         * @brief Evicts all entries, this is used to release memory when the host is running low on it
+         */
+        void Clear();
+    };
+
     /**
      * @brief The AdpcmDecoder class handles decoding single channel ADPCM (Adaptive Differential Pulse-Code Modulation) data
      */
@@ -23,14 +80,25 @@ namespace skyline::audio {
         static_assert(sizeof(FrameHeader) == 0x1);
 
         std::array<i32, 2> history{}; //!< The previous samples for decoding the ADPCM stream
-        std::vector<std::array<i16, 2>> coefficients; //!< The coefficients for decoding the ADPCM stream
+        std::array<std::array<i16, 2>, 8> coefficients{}; //!< The coefficients for decoding the ADPCM stream, there can be at most 8 as the index in the frame header is 3 bits
+        u64 coefficientHash; //!< A hash of the coefficients, this is used for looking up buffers in an AdpcmCache
 
       public:
-        AdpcmDecoder(std::vector<std::array<i16, 2>> coefficients);
+        static constexpr size_t BytesPerFrame{0x8};
+        static constexpr size_t SamplesPerFrame{0xE};
+
+        AdpcmDecoder(span<const std::array<i16, 2>> pCoefficients);
+
+        /**
+         * @brief Decodes all complete frames in a buffer of ADPCM data into I16 PCM
+         * @param output The buffer to decode into, this must be large enough to hold all samples
+         */
+        void DecodeFrames(span<const u8> adpcmData, span<i16> output);
 
         /**
-         * @brief Decodes a buffer of ADPCM data into I16 PCM
+         * @brief Decodes an entire buffer of ADPCM data through the supplied cache, the decoder's history is advanced to the end of the buffer
+         * @return The decoded samples or nullptr if the buffer is too large to be cached, in which case it should be decoded with DecodeFrames instead
          */
-        std::vector<i16> Decode(span <u8> adpcmData);
+        std::shared_ptr<const std::vector<i16>> DecodeCached(span<const u8> adpcmData, AdpcmCache &cache);
     };
 }
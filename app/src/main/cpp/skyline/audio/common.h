@@ -12,10 +12,12 @@ namespace skyline {
         constexpr u8 StereoChannelCount{2}; //!< Channels to use for stereo audio output
         constexpr u8 SurroundChannelCount{6}; //!< Channels to use for surround audio output (downsampled by backend)
         constexpr u16 MixBufferSize{960}; //!< Default size of the audren mix buffer
-        constexpr auto PcmFormat{oboe::AudioFormat::I16}; //!< PCM data format to use for audio output
+        constexpr auto PcmFormat{oboe::AudioFormat::Float}; //!< PCM data format to use for audio output, samples are normalized floats from the renderer mix through to the output
     }
 
     namespace audio {
+        constexpr float SampleScale{1.0f / 0x8000}; //!< The scale from the range of i16 samples to that of normalized floating-point samples
+
         enum class AudioFormat : u8 {
             Invalid = 0, //!< An invalid PCM format
             Int8 = 1,    //!< 8 bit integer PCM
@@ -28,30 +28,49 @@ namespace skyline::audio {
     };
 
     /**
-     * @brief Downmixes a buffer of 5.1 surround audio to stereo
+     * @brief Downmixes a buffer of 5.1 surround audio into a buffer of stereo audio of the same length
+     * @note The stereo buffer may be the start of the surround buffer as each frame is fully read before it's overwritten
      */
-    inline std::vector<StereoSample> DownMix(span<Surround51Sample> surroundSamples) {
+    inline void DownMix(span<const Surround51Sample> surroundSamples, span<StereoSample> stereoSamples) {
         constexpr i16 FixedPointMultiplier{1000}; //!< Avoids using floating point maths
         constexpr i16 Attenuation3Db{707}; //! 10^(-3/20)
         constexpr i16 Attenuation6Db{501}; //! 10^(-6/20)
         constexpr i16 Attenuation12Db{251}; //! 10^(-6/20)
 
         auto downmixChannel{[](i32 front, i32 centre, i32 lowFrequency, i32 back) {
-            return static_cast<i16>(front +
-                                    (centre * Attenuation3Db +
-                                     lowFrequency * Attenuation12Db +
-                                     back * Attenuation6Db) / FixedPointMultiplier);
+            // The sum of all channels can exceed the range of i16, it's saturated rather than being allowed to wrap around
+            return Saturate<i16, i32>(front +
+                                      (centre * Attenuation3Db +
+                                       lowFrequency * Attenuation12Db +
+                                       back * Attenuation6Db) / FixedPointMultiplier);
         }};
 
-        std::vector<StereoSample> stereoSamples(surroundSamples.size());
         for (size_t i{}; i < surroundSamples.size(); i++) {
-            auto &surroundSample = surroundSamples[i];
+            auto surroundSample = surroundSamples[i];
             auto &stereoSample = stereoSamples[i];
 
             stereoSample.left = downmixChannel(surroundSample.frontLeft, surroundSample.centre, surroundSample.lowFrequency, surroundSample.backLeft);
             stereoSample.right = downmixChannel(surroundSample.frontRight, surroundSample.centre, surroundSample.lowFrequency, surroundSample.backRight);
         }
+    }
+
+    /**
+     * @brief Downmixes a buffer of 5.1 surround audio into interleaved normalized floating-point stereo audio of the same length
+     * @note No clamping is done as that only occurs once at the output
+     */
+    inline void DownMix(span<const Surround51Sample> surroundSamples, span<float> stereoSamples) {
+        constexpr float Attenuation3Db{0.707f * SampleScale}; //! 10^(-3/20)
+        constexpr float Attenuation6Db{0.501f * SampleScale}; //! 10^(-6/20)
+        constexpr float Attenuation12Db{0.251f * SampleScale}; //! 10^(-12/20)
 
-        return stereoSamples;
+        auto downmixChannel{[](float front, float centre, float lowFrequency, float back) {
+            return front * SampleScale + centre * Attenuation3Db + lowFrequency * Attenuation12Db + back * Attenuation6Db;
+        }};
+
+        for (size_t i{}; i < surroundSamples.size(); i++) {
+            auto surroundSample = surroundSamples[i];
+            stereoSamples[i * constant::StereoChannelCount] = downmixChannel(surroundSample.frontLeft, surroundSample.centre, surroundSample.lowFrequency, surroundSample.backLeft);
+            stereoSamples[i * constant::StereoChannelCount + 1] = downmixChannel(surroundSample.frontRight, surroundSample.centre, surroundSample.lowFrequency, surroundSample.backRight);
+        }
     }
 }
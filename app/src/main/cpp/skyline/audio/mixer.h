@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <arm_neon.h>
+#include <common.h>
+#include "common.h"
+
+namespace skyline::audio {
+    /**
+     * @brief Adds the source samples to the destination samples, no clamping is done as that only occurs once at the output
+     */
+    inline void MixFloat(float *destination, const float *source, size_t count) {
+        size_t index{};
+        for (; index + 4 <= count; index += 4)
+            vst1q_f32(destination + index, vaddq_f32(vld1q_f32(destination + index), vld1q_f32(source + index)));
+
+        for (; index < count; index++)
+            destination[index] += source[index];
+    }
+
+    /**
+     * @brief Multiplies the source samples by the supplied volume and accumulates them into a floating-point mix bus, no clamping is done till the output
+     */
+    inline void AccumulateScaled(float *bus, const i16 *source, float volume, size_t count) {
+        size_t index{};
+        for (; index + 8 <= count; index += 8) {
+            int16x8_t samples{vld1q_s16(source + index)};
+            float32x4_t low{vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples)))}, high{vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples)))};
+            vst1q_f32(bus + index, vmlaq_n_f32(vld1q_f32(bus + index), low, volume));
+            vst1q_f32(bus + index + 4, vmlaq_n_f32(vld1q_f32(bus + index + 4), high, volume));
+        }
+
+        for (; index < count; index++)
+            bus[index] += static_cast<float>(source[index]) * volume;
+    }
+
+    /**
+     * @brief Converts i16 samples into normalized floating-point samples
+     */
+    inline void ConvertToFloat(float *destination, const i16 *source, size_t count) {
+        size_t index{};
+        for (; index + 8 <= count; index += 8) {
+            int16x8_t samples{vld1q_s16(source + index)};
+            vst1q_f32(destination + index, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), SampleScale));
+            vst1q_f32(destination + index + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_high_s16(samples)), SampleScale));
+        }
+
+        for (; index < count; index++)
+            destination[index] = static_cast<float>(source[index]) * SampleScale;
+    }
+
+    /**
+     * @brief Clamps normalized floating-point samples to [-1, 1], this is the only point at which mixed audio is clipped
+     */
+    inline void ClampFloat(float *samples, size_t count) {
+        size_t index{};
+        float32x4_t minimum{vdupq_n_f32(-1.0f)}, maximum{vdupq_n_f32(1.0f)};
+        for (; index + 4 <= count; index += 4)
+            vst1q_f32(samples + index, vminq_f32(vmaxq_f32(vld1q_f32(samples + index), minimum), maximum));
+
+        for (; index < count; index++)
+            samples[index] = std::clamp(samples[index], -1.0f, 1.0f);
+    }
+}
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <arm_neon.h>
 #include "common.h"
 #include "resampler.h"
 
@@ -9,11 +10,12 @@ namespace skyline::audio {
      * @brief The coefficients for each index of a single output frame
      */
     struct LutEntry {
-        i32 a;
-        i32 b;
-        i32 c;
-        i32 d;
+        i16 a;
+        i16 b;
+        i16 c;
+        i16 d;
     };
+    static_assert(sizeof(LutEntry) == sizeof(int16x4_t)); // Entries are loaded as a single vector
 
     // @fmt:off
     constexpr std::array<LutEntry, 128> CurveLut0{{
@@ -119,33 +121,161 @@ namespace skyline::audio {
         {-42, 3751, 26253, 2811},   {-38, 3608, 26270, 2936},   {-34, 3467, 26281, 3064},   {-32, 3329, 26287, 3195}}};
     // @fmt:on
 
-    std::vector<i16> Resampler::ResampleBuffer(span<i16> inputBuffer, double ratio, u8 channelCount) {
-        auto step{static_cast<u32>(ratio * 0x8000)};
-        auto outputSize{static_cast<size_t>(inputBuffer.size() / ratio)};
-        std::vector<i16> outputBuffer(outputSize);
+    constexpr size_t PolyphaseTapCount{16}; //!< The amount of input frames that contribute to every output frame in the polyphase mode
+    constexpr size_t PolyphasePhaseCount{128}; //!< The amount of fractional positions between input frames that have their own coefficients, this matches the resolution of the LUTs
+    constexpr size_t PolyphaseTapOffset{6}; //!< The offset of the first tap before the input index, the output frame is positioned between the 7th and 8th taps like it is between the 2nd and 3rd for the LUTs
+    constexpr size_t PolyphaseCutoffSteps{32}; //!< The amount of steps that the cutoff frequency is quantized to, this bounds the amount of tables that are generated
+    constexpr size_t PolyphaseMinimumCutoffStep{4}; //!< The lowest quantized cutoff, ratios beyond 8x are rare and would require considerably more taps to filter well anyway
 
-        const std::array<LutEntry, 128> &lut = [step] {
+    /**
+     * @brief Q15 coefficients for all phases of a windowed-sinc low-pass filter with a specific cutoff
+     */
+    using PolyphaseTable = std::array<std::array<i16, PolyphaseTapCount>, PolyphasePhaseCount>;
+
+    /**
+     * @return The polyphase table for the supplied step, tables are generated on their first use and are never freed
+     */
+    static const PolyphaseTable &GetPolyphaseTable(u32 step) {
+        // Downsampling requires the cutoff to be lowered to the output Nyquist frequency to avoid aliasing
+        double cutoff{step > 0x8000 ? static_cast<double>(0x8000) / step : 1.0};
+        size_t cutoffStep{std::clamp(static_cast<size_t>(std::lround(cutoff * PolyphaseCutoffSteps)), PolyphaseMinimumCutoffStep, PolyphaseCutoffSteps)};
+
+        static std::array<std::unique_ptr<PolyphaseTable>, PolyphaseCutoffSteps + 1> tables;
+        static std::mutex tableMutex;
+        std::scoped_lock lock{tableMutex};
+        auto &table{tables[cutoffStep]};
+        if (table)
+            return *table;
+
+        table = std::make_unique<PolyphaseTable>();
+        cutoff = static_cast<double>(cutoffStep) / PolyphaseCutoffSteps;
+        constexpr double HalfWindow{static_cast<double>(PolyphaseTapCount) / 2};
+        for (size_t phase{}; phase < PolyphasePhaseCount; phase++) {
+            std::array<double, PolyphaseTapCount> weights;
+            double weightSum{};
+            for (size_t tap{}; tap < PolyphaseTapCount; tap++) {
+                // The distance of the tap from the output frame in input frames, this is weighted by a Blackman window
+                double distance{static_cast<double>(tap) - static_cast<double>(PolyphaseTapOffset + 1) - static_cast<double>(phase) / PolyphasePhaseCount};
+                double sinc{distance == 0 ? 1.0 : std::sin(M_PI * cutoff * distance) / (M_PI * cutoff * distance)};
+                double window{0.42 + 0.5 * std::cos(M_PI * distance / HalfWindow) + 0.08 * std::cos(2 * M_PI * distance / HalfWindow)};
+                weights[tap] = std::abs(distance) < HalfWindow ? sinc * window : 0;
+                weightSum += weights[tap];
+            }
+
+            // Coefficients are normalized to unity gain, any rounding error is folded into the center tap
+            i32 coefficientSum{};
+            for (size_t tap{}; tap < PolyphaseTapCount; tap++) {
+                (*table)[phase][tap] = static_cast<i16>(std::lround(weights[tap] / weightSum * 0x8000));
+                coefficientSum += (*table)[phase][tap];
+            }
+            (*table)[phase][PolyphaseTapOffset + 1] = static_cast<i16>((*table)[phase][PolyphaseTapOffset + 1] + (0x8000 - coefficientSum));
+        }
+        return *table;
+    }
+
+    Resampler::Resampler(Quality quality) : quality{quality} {}
+
+    size_t Resampler::GetOutputSize(size_t inputSize, double ratio, u8 channelCount) {
+        return static_cast<size_t>(static_cast<double>(inputSize / channelCount) / ratio) * channelCount;
+    }
+
+    size_t Resampler::GetTapOffset() const {
+        return quality == Quality::Polyphase ? PolyphaseTapOffset : 0;
+    }
+
+    size_t Resampler::Resample(span<const i16> input, span<i16> output, u32 step, u8 channelCount, size_t outputFrames, size_t &inIndex, bool stream) {
+        size_t inputFrames{input.size() / channelCount};
+        if (!inputFrames)
+            return 0;
+
+        // Frames outside the input are clamped to its edges, this is only required for the frames at the edges of the input so it's done on a slower path
+        auto clampedSample{[&](ssize_t frame, u8 channel) -> i32 {
+            return input[static_cast<size_t>(std::clamp<ssize_t>(frame, 0, static_cast<ssize_t>(inputFrames) - 1)) * channelCount + channel];
+        }};
+
+        if (quality == Quality::Polyphase) {
+            const auto &table{GetPolyphaseTable(step)};
+            for (size_t outFrame{}; outFrame < outputFrames; outFrame++) {
+                if (stream && inIndex - PolyphaseTapOffset + PolyphaseTapCount > inputFrames)
+                    return outFrame * channelCount;
+
+                const auto &coefficients{table[fraction >> 8]};
+                i16 *destination{output.data() + outFrame * channelCount};
+
+                if (inIndex >= PolyphaseTapOffset && inIndex - PolyphaseTapOffset + PolyphaseTapCount <= inputFrames && channelCount <= constant::StereoChannelCount) [[likely]] {
+                    const i16 *source{input.data() + (inIndex - PolyphaseTapOffset) * channelCount};
+                    int16x8_t lowCoefficients{vld1q_s16(coefficients.data())}, highCoefficients{vld1q_s16(coefficients.data() + 8)};
+                    auto filter{[&](int16x8_t low, int16x8_t high) {
+                        int32x4_t accumulator{vmull_s16(vget_low_s16(low), vget_low_s16(lowCoefficients))};
+                        accumulator = vmlal_high_s16(accumulator, low, lowCoefficients);
+                        accumulator = vmlal_s16(accumulator, vget_low_s16(high), vget_low_s16(highCoefficients));
+                        accumulator = vmlal_high_s16(accumulator, high, highCoefficients);
+                        return Saturate<i16, i32>(vaddvq_s32(accumulator) >> 15);
+                    }};
+
+                    if (channelCount == constant::StereoChannelCount) {
+                        // The channels are deinterleaved while loading, so each channel is filtered with the same coefficient vectors
+                        int16x8x2_t low{vld2q_s16(source)}, high{vld2q_s16(source + 16)};
+                        destination[0] = filter(low.val[0], high.val[0]);
+                        destination[1] = filter(low.val[1], high.val[1]);
+                    } else {
+                        destination[0] = filter(vld1q_s16(source), vld1q_s16(source + 8));
+                    }
+                } else {
+                    for (u8 channel{}; channel < channelCount; channel++) {
+                        i32 data{};
+                        for (size_t tap{}; tap < PolyphaseTapCount; tap++)
+                            data += clampedSample(static_cast<ssize_t>(inIndex + tap) - static_cast<ssize_t>(PolyphaseTapOffset), channel) * coefficients[tap];
+                        destination[channel] = Saturate<i16, i32>(data >> 15);
+                    }
+                }
+
+                u32 newOffset{fraction + step};
+                inIndex += newOffset >> 15;
+                fraction = newOffset & 0x7FFF;
+            }
+            return outputFrames * channelCount;
+        }
+
+        const auto &lut{[step]() -> const std::array<LutEntry, 128> & {
             if (step > 0xAAAA)
                 return CurveLut0;
             else if (step <= 0x8000)
                 return CurveLut1;
             else
                 return CurveLut2;
-        }();
+        }()};
 
-        for (size_t outIndex{}, inIndex{}; outIndex < outputSize; outIndex += channelCount) {
-            u32 lutIndex{fraction >> 8};
+        for (size_t outFrame{}; outFrame < outputFrames; outFrame++) {
+            if (stream && inIndex + 4 > inputFrames)
+                return outFrame * channelCount;
 
-            for (u8 channel{}; channel < channelCount; channel++) {
-                if (((inIndex + 3) * channelCount + channel) >= inputBuffer.size())
-                    continue;
+            const auto &entry{lut[fraction >> 8]};
+            i16 *destination{output.data() + outFrame * channelCount};
 
-                i32 data{inputBuffer[(inIndex + 0) * channelCount + channel] * lut[lutIndex].a +
-                         inputBuffer[(inIndex + 1) * channelCount + channel] * lut[lutIndex].b +
-                         inputBuffer[(inIndex + 2) * channelCount + channel] * lut[lutIndex].c +
-                         inputBuffer[(inIndex + 3) * channelCount + channel] * lut[lutIndex].d};
-
-                outputBuffer[outIndex + channel] = Saturate<i16, i32>(data >> 15);
+            if (inIndex + 3 < inputFrames && channelCount <= constant::StereoChannelCount) [[likely]] {
+                const i16 *source{input.data() + inIndex * channelCount};
+                int16x4_t coefficients{vld1_s16(&entry.a)};
+                if (channelCount == constant::StereoChannelCount) {
+                    // Each coefficient is duplicated for both channels of the interleaved frames, the products for the first and last two frames are then summed
+                    int16x8_t frames{vld1q_s16(source)};
+                    int32x4_t accumulator{vmull_s16(vget_low_s16(frames), vzip1_s16(coefficients, coefficients))};
+                    accumulator = vmlal_s16(accumulator, vget_high_s16(frames), vzip2_s16(coefficients, coefficients));
+                    int16x4_t result{vqmovn_s32(vcombine_s32(vshr_n_s32(vadd_s32(vget_low_s32(accumulator), vget_high_s32(accumulator)), 15), vdup_n_s32(0)))};
+                    destination[0] = vget_lane_s16(result, 0);
+                    destination[1] = vget_lane_s16(result, 1);
+                } else {
+                    destination[0] = Saturate<i16, i32>(vaddvq_s32(vmull_s16(vld1_s16(source), coefficients)) >> 15);
+                }
+            } else {
+                for (u8 channel{}; channel < channelCount; channel++) {
+                    auto frame{static_cast<ssize_t>(inIndex)};
+                    i32 data{clampedSample(frame, channel) * entry.a +
+                             clampedSample(frame + 1, channel) * entry.b +
+                             clampedSample(frame + 2, channel) * entry.c +
+                             clampedSample(frame + 3, channel) * entry.d};
+                    destination[channel] = Saturate<i16, i32>(data >> 15);
+                }
             }
 
             u32 newOffset{fraction + step};
@@ -153,6 +283,32 @@ namespace skyline::audio {
             fraction = newOffset & 0x7FFF;
         }
 
-        return outputBuffer;
+        return outputFrames * channelCount;
+    }
+
+    size_t Resampler::ResampleBuffer(span<const i16> input, span<i16> output, double ratio, u8 channelCount) {
+        size_t inIndex{};
+        return Resample(input, output, static_cast<u32>(ratio * 0x8000), channelCount, std::min(output.size(), GetOutputSize(input.size(), ratio, channelCount)) / channelCount, inIndex, false);
+    }
+
+    size_t Resampler::ResampleStream(span<const i16> input, span<i16> output, double ratio, u8 channelCount, size_t &consumedFrames) {
+        // Frames that were stepped over by the prior chunk but weren't present in it are skipped before resampling
+        size_t inputFrames{input.size() / channelCount};
+        size_t skippedFrames{std::min(pendingSkipFrames, inputFrames)};
+        pendingSkipFrames -= skippedFrames;
+
+        // The position starts at the offset of the first tap, so the first output frame only uses frames from the start of the input
+        size_t tapOffset{GetTapOffset()}, inIndex{tapOffset};
+        size_t written{Resample(input.subspan(skippedFrames * channelCount), output, static_cast<u32>(ratio * 0x8000), channelCount, output.size() / channelCount, inIndex, true)};
+
+        size_t advancedFrames{inIndex - tapOffset}, availableFrames{inputFrames - skippedFrames};
+        consumedFrames = skippedFrames + std::min(advancedFrames, availableFrames);
+        pendingSkipFrames += advancedFrames - std::min(advancedFrames, availableFrames);
+        return written;
+    }
+
+    void Resampler::Reset() {
+        fraction = 0;
+        pendingSkipFrames = 0;
     }
 }
@@ -10,16 +10,59 @@ namespace skyline::audio {
      * @brief The Resampler class handles resampling audio PCM data
      */
     class Resampler {
+      public:
+        enum class Quality : u8 {
+            Fast, //!< 4-tap interpolation using the same curves as the official DSP
+            Polyphase, //!< 16-tap windowed-sinc polyphase filtering, this band-limits downsampling to avoid aliasing at the cost of roughly 4x the work
+        };
+
       private:
         u32 fraction{}; //!< The fractional value used for storing the resamplers last frame
+        size_t pendingSkipFrames{}; //!< The amount of frames at the start of the next streamed chunk which were already stepped over
+        Quality quality;
+
+        /**
+         * @return The amount of frames before the input position that contribute to an output frame
+         */
+        size_t GetTapOffset() const;
+
+        /**
+         * @param inIndex The position in the input which is advanced past all resampled frames
+         * @param stream If resampling should stop at the first output frame that requires frames past the end of the input, rather than clamping to its edges
+         * @return The amount of samples written into the output buffer
+         */
+        size_t Resample(span<const i16> input, span<i16> output, u32 step, u8 channelCount, size_t outputFrames, size_t &inIndex, bool stream);
 
       public:
+        Resampler(Quality quality = Quality::Fast);
+
         /**
-         * @brief Resamples the given sample buffer by the given ratio
-         * @param inputBuffer A buffer containing PCM sample data
-         * @param ratio The conversion ratio needed
+         * @return The amount of samples that resampling a buffer of the supplied size by the supplied ratio will result in
+         */
+        static size_t GetOutputSize(size_t inputSize, double ratio, u8 channelCount);
+
+        /**
+         * @brief Resamples the given sample buffer by the given ratio into the output buffer
+         * @param input A buffer containing interleaved PCM sample data
+         * @param output A buffer to write the resampled samples into, this should be at least as large as GetOutputSize
+         * @param ratio The conversion ratio needed, this can be changed between calls for pitch changes
          * @param channelCount The amount of channels the buffer contains
+         * @return The amount of samples written into the output buffer
+         */
+        size_t ResampleBuffer(span<const i16> input, span<i16> output, double ratio, u8 channelCount);
+
+        /**
+         * @brief Resamples a chunk of a continuous stream, as many output frames are produced as is possible without requiring frames past the end of the chunk
+         * @param input A buffer containing interleaved PCM sample data, this should start with the frames that weren't consumed from the prior chunk
+         * @param consumedFrames Set to the amount of frames at the start of the input which aren't required anymore
+         * @return The amount of samples written into the output buffer
+         * @note This avoids the discontinuities that resampling each chunk separately with ResampleBuffer would cause at chunk boundaries
+         */
+        size_t ResampleStream(span<const i16> input, span<i16> output, double ratio, u8 channelCount, size_t &consumedFrames);
+
+        /**
+         * @brief Resets the state of the resampler for a new stream
          */
-        std::vector<i16> ResampleBuffer(span <i16> inputBuffer, double ratio, u8 channelCount);
+        void Reset();
     };
 }
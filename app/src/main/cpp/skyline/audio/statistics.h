@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <atomic>
+#include <common.h>
+
+namespace skyline::audio {
+    /**
+     * @brief Aggregate timing statistics for a single stage of the audio pipeline
+     * @note These are recorded from real-time threads, so only relaxed atomics are used and readers may observe slightly torn statistics
+     */
+    struct TimingStatistics {
+        std::atomic<u64> count{};
+        std::atomic<u64> totalNs{};
+        std::atomic<u64> maxNs{};
+
+        void Record(u64 durationNs) {
+            count.fetch_add(1, std::memory_order_relaxed);
+            totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+
+            u64 max{maxNs.load(std::memory_order_relaxed)};
+            while (durationNs > max && !maxNs.compare_exchange_weak(max, durationNs, std::memory_order_relaxed));
+        }
+
+        /**
+         * @return A single line summary of the statistics
+         */
+        std::string Format(std::string_view name) const {
+            u64 samples{count.load(std::memory_order_relaxed)};
+            return util::Format("{}: {} samples, {:.1f}us average, {:.1f}us maximum\n", name, samples, samples ? static_cast<double>(totalNs.load(std::memory_order_relaxed)) / static_cast<double>(samples) / 1000.0 : 0.0, static_cast<double>(maxNs.load(std::memory_order_relaxed)) / 1000.0);
+        }
+    };
+
+    /**
+     * @brief Statistics for the entire audio pipeline, these allow audio glitches to be correlated with the cost of each stage
+     */
+    struct AudioStatistics {
+        TimingStatistics callback; //!< The duration of the Oboe audio callback
+        TimingStatistics requestUpdate; //!< The duration of audio renderer updates from the guest
+        TimingStatistics voiceMix; //!< The duration of rendering and mixing a single voice
+        TimingStatistics rendererMix; //!< The duration of mixing an entire audio renderer output buffer
+    };
+}
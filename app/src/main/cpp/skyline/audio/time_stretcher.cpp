@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "time_stretcher.h"
+
+namespace skyline::audio {
+    constexpr size_t ChannelCount{constant::StereoChannelCount};
+
+    size_t TimeStretcher::FindBestOffset() const {
+        // Similarity is the normalized cross-correlation of the sum of both channels, every other frame is skipped to halve the cost as the result only guides the choice of offset
+        auto correlate{[this](size_t offset) {
+            double product{}, energy{};
+            const float *candidate{input.data() + offset * ChannelCount};
+            for (size_t frame{}; frame < OverlapFrames; frame += 2) {
+                auto reference{static_cast<double>(overlap[frame * ChannelCount] + overlap[frame * ChannelCount + 1])};
+                auto sample{static_cast<double>(candidate[frame * ChannelCount] + candidate[frame * ChannelCount + 1])};
+                product += reference * sample;
+                energy += sample * sample;
+            }
+            return energy > 0 ? product / std::sqrt(energy) : 0.0;
+        }};
+
+        constexpr size_t CoarseStep{4};
+        size_t bestOffset{};
+        double bestCorrelation{-std::numeric_limits<double>::infinity()};
+        for (size_t offset{}; offset < SeekFrames; offset += CoarseStep) {
+            if (auto correlation{correlate(offset)}; correlation > bestCorrelation) {
+                bestCorrelation = correlation;
+                bestOffset = offset;
+            }
+        }
+
+        size_t coarseOffset{bestOffset};
+        for (size_t offset{coarseOffset > CoarseStep ? coarseOffset - CoarseStep + 1 : 0}; offset < std::min(coarseOffset + CoarseStep, SeekFrames); offset++) {
+            if (auto correlation{correlate(offset)}; correlation > bestCorrelation) {
+                bestCorrelation = correlation;
+                bestOffset = offset;
+            }
+        }
+        return bestOffset;
+    }
+
+    void TimeStretcher::Process(span<const float> samples, double tempo, std::vector<float> &output) {
+        tempo = std::clamp(tempo, MinimumTempo, MaximumTempo);
+        input.insert(input.end(), samples.begin(), samples.end());
+
+        if (!primed) {
+            if (input.size() < overlap.size())
+                return;
+
+            // The overlap is seeded with the first input frames without consuming them, so the first segment is matched against the same frames and starts seamlessly
+            std::copy_n(input.begin(), overlap.size(), overlap.begin());
+            continuationFrame = OverlapFrames;
+            primed = true;
+        }
+
+        while (input.size() / ChannelCount >= SeekFrames + SequenceFrames) {
+            size_t offset{FindBestOffset()};
+            const float *segment{input.data() + offset * ChannelCount};
+
+            for (size_t frame{}; frame < OverlapFrames; frame++) {
+                float weight{static_cast<float>(frame) / static_cast<float>(OverlapFrames)};
+                for (size_t channel{}; channel < ChannelCount; channel++) {
+                    size_t index{frame * ChannelCount + channel};
+                    output.push_back(overlap[index] + (segment[index] - overlap[index]) * weight);
+                }
+            }
+            output.insert(output.end(), segment + OverlapFrames * ChannelCount, segment + (SequenceFrames - OverlapFrames) * ChannelCount);
+            std::copy_n(segment + (SequenceFrames - OverlapFrames) * ChannelCount, overlap.size(), overlap.begin());
+
+            // Every segment outputs SequenceFrames - OverlapFrames frames, the input is advanced by that scaled by the tempo
+            double skip{static_cast<double>(SequenceFrames - OverlapFrames) * tempo + skipFraction};
+            auto skipFrames{static_cast<size_t>(skip)};
+            skipFraction = skip - static_cast<double>(skipFrames);
+            continuationFrame = offset + SequenceFrames - skipFrames;
+            input.erase(input.begin(), input.begin() + static_cast<ssize_t>(skipFrames * ChannelCount));
+        }
+    }
+
+    void TimeStretcher::Flush(std::vector<float> &output) {
+        if (primed) {
+            output.insert(output.end(), overlap.begin(), overlap.end());
+            output.insert(output.end(), input.begin() + static_cast<ssize_t>(std::min(continuationFrame * ChannelCount, input.size())), input.end());
+        } else {
+            output.insert(output.end(), input.begin(), input.end());
+        }
+
+        input.clear();
+        skipFraction = 0;
+        primed = false;
+    }
+
+    size_t TimeStretcher::GetHeldFrames() const {
+        if (!primed)
+            return input.size() / ChannelCount;
+        return OverlapFrames + (input.size() / ChannelCount - std::min(continuationFrame, input.size() / ChannelCount));
+    }
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+#include "common.h"
+
+namespace skyline::audio {
+    /**
+     * @brief A WSOLA (Waveform Similarity Overlap-Add) time-stretcher for normalized floating-point stereo audio, this changes the playback duration of audio without affecting its pitch
+     * @details Audio is split into overlapping segments, every segment is taken from around its nominal position in the input at the offset where it's most similar to the end of the prior segment and crossfaded with it
+     */
+    class TimeStretcher {
+      public:
+        static constexpr size_t SequenceFrames{960}; //!< The length of a single segment including both of its overlaps (20ms)
+        static constexpr size_t OverlapFrames{240}; //!< The length of the crossfade between segments (5ms)
+        static constexpr size_t SeekFrames{384}; //!< The range of offsets from the nominal position that segments are searched for at (8ms)
+        static constexpr double MinimumTempo{0.5}; //!< The slowest supported tempo, stretching any further than this causes audible repetition
+        static constexpr double MaximumTempo{1.0}; //!< The fastest supported tempo, audio is only ever stretched and never compressed
+
+      private:
+        std::vector<float> input; //!< Interleaved input frames which haven't been consumed yet
+        std::array<float, OverlapFrames * constant::StereoChannelCount> overlap{}; //!< The tail of the prior segment which is crossfaded with the next one
+        size_t continuationFrame{}; //!< The index of the input frame which naturally follows the overlap, output is resumed from here when flushed
+        double skipFraction{}; //!< The fractional part of the skip between segments carried over to the next segment
+        bool primed{}; //!< If the overlap has been seeded from the input
+
+        /**
+         * @return The offset in the input which is most similar to the overlap, this is searched on a coarse grid of offsets first and refined around the best of them
+         */
+        size_t FindBestOffset() const;
+
+      public:
+        /**
+         * @brief Stretches the supplied samples by the supplied tempo and appends any completed output to the output buffer, samples may be held back till enough input is available for a segment
+         * @param tempo The rate at which input is consumed relative to output, values below 1 stretch the audio
+         */
+        void Process(span<const float> samples, double tempo, std::vector<float> &output);
+
+        /**
+         * @brief Appends all held samples to the output buffer without stretching them and resets the stretcher
+         */
+        void Flush(std::vector<float> &output);
+
+        /**
+         * @return The amount of frames held by the stretcher which haven't been output yet
+         */
+        size_t GetHeldFrames() const;
+    };
+}
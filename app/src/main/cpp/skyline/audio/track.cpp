@@ -2,13 +2,15 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include "downmixer.h"
+#include "mixer.h"
 #include "track.h"
 
 namespace skyline::audio {
-    AudioTrack::AudioTrack(u8 channelCount, u32 sampleRate, std::function<void()> releaseCallback)
+    AudioTrack::AudioTrack(u8 channelCount, u32 sampleRate, std::function<void()> releaseCallback, bool timeStretching)
         : channelCount(channelCount),
           sampleRate(sampleRate),
-          releaseCallback(std::move(releaseCallback)) {
+          releaseCallback(std::move(releaseCallback)),
+          timeStretching(timeStretching) {
         if (sampleRate != constant::SampleRate)
             throw exception("Unsupported audio sample rate: {}", sampleRate);
 
@@ -58,34 +60,118 @@ namespace skyline::audio {
     void AudioTrack::AppendBuffer(u64 tag, span<i16> buffer) {
         std::scoped_lock lock(bufferLock);
 
-        size_t size{(channelCount == constant::SurroundChannelCount) ? (buffer.size() / sizeof(Surround51Sample)) * sizeof(StereoSample) : buffer.size()};
-        BufferIdentifier identifier{
-            .released = false,
-            .tag = tag,
-            .finalSample = identifiers.empty() ? size : (size + identifiers.front().finalSample)
-        };
-
-        identifiers.push_front(identifier);
+        size_t frameCount{buffer.size() / channelCount};
+        auto convert{[&](span<float> destination, size_t offset) {
+            // The sample buffer is only ever written and read in entire stereo frames, so a run never starts or ends within a frame
+            if (channelCount == constant::SurroundChannelCount)
+                DownMix(span(buffer.cast<Surround51Sample>().data() + offset / constant::StereoChannelCount, destination.size() / constant::StereoChannelCount), destination);
+            else
+                ConvertToFloat(destination.data(), buffer.data() + offset, destination.size());
+        }};
 
-        if (channelCount == constant::SurroundChannelCount) {
-            auto stereoBuffer{DownMix(buffer.cast<Surround51Sample>())};
-            samples.Append(span(stereoBuffer).cast<i16>());
+        double tempo{GetAppendTempo(frameCount)};
+        if (tempo != 1.0 || stretching) {
+            // The stretcher requires all samples upfront, so they're converted into an intermediate buffer
+            convertedSamples.resize(frameCount * constant::StereoChannelCount);
+            convert(convertedSamples, 0);
+            AppendStereoSamples(tag, convertedSamples, tempo);
         } else {
-            samples.Append(buffer);
+            // The final sample is determined by the amount of samples actually written as any samples that don't fit in the ring buffer are dropped and will never be played
+            appendedSamples += samples.Write(frameCount * constant::StereoChannelCount, convert);
+            QueueIdentifier(tag);
+        }
+    }
+
+    void AudioTrack::AppendBuffer(u64 tag, span<const float> buffer) {
+        std::scoped_lock lock(bufferLock);
+        AppendStereoSamples(tag, buffer, GetAppendTempo(buffer.size() / constant::StereoChannelCount));
+    }
+
+    double AudioTrack::GetAppendTempo(size_t appendedFrames) {
+        return (timeStretching && appendedFrames) ? UpdateTempo(appendedFrames) : 1.0;
+    }
+
+    void AudioTrack::AppendStereoSamples(u64 tag, span<const float> stereoBuffer, double tempo) {
+        if (tempo != 1.0 || stretching) {
+            stretchedSamples.clear();
+            if (tempo != 1.0) {
+                stretcher.Process(stereoBuffer, tempo, stretchedSamples);
+                stretching = true;
+                stereoBuffer = stretchedSamples;
+            } else if (stretching) {
+                // Any samples held by the stretcher precede the appended samples, so they must be written first
+                stretcher.Flush(stretchedSamples);
+                stretchedSamples.insert(stretchedSamples.end(), stereoBuffer.begin(), stereoBuffer.end());
+                stretching = false;
+                stereoBuffer = stretchedSamples;
+            }
+        }
+
+        // The final sample is determined by the amount of samples actually written as any samples that don't fit in the ring buffer are dropped and will never be played
+        appendedSamples += samples.Write(stereoBuffer);
+        QueueIdentifier(tag);
+    }
+
+    void AudioTrack::QueueIdentifier(u64 tag) {
+        identifiers.push_front(BufferIdentifier{
+            .tag = tag,
+            .finalSample = appendedSamples,
+            .released = false,
+        });
+        UpdateNextReleaseSample();
+    }
+
+    double AudioTrack::UpdateTempo(size_t appendedFrames) {
+        constexpr double SmoothingFactor{0.1}; //!< The weight of every new measurement in the moving averages
+        constexpr double MinimumLatency{0.02}, MaximumLatency{0.25}; //!< The bounds of the amount of buffered audio targeted in seconds
+        constexpr double MaximumPauseInterval{1.0}; //!< Intervals between appends longer than this are treated as the guest pausing audio (e.g. during loading) rather than running slowly
+
+        auto now{std::chrono::steady_clock::now()};
+        auto previousAppendTime{std::exchange(lastAppendTime, now)};
+        double interval{std::chrono::duration<double>(now - previousAppendTime).count()};
+        if (previousAppendTime == std::chrono::steady_clock::time_point{} || interval > MaximumPauseInterval)
+            return 1.0;
+
+        // Guests often append several buffers back-to-back, so the ratio of a single append is bounded to avoid those skewing the average
+        double duration{static_cast<double>(appendedFrames) / constant::SampleRate};
+        appendJitter += (std::abs(interval - appendInterval) - appendJitter) * SmoothingFactor;
+        appendInterval += (interval - appendInterval) * SmoothingFactor;
+        submissionRatio += (std::min(duration / std::max(interval, 1e-4), 4.0) - submissionRatio) * SmoothingFactor;
+
+        // Enough audio should be buffered to cover the usual gap between appends alongside its jitter, latency is only built up beyond what the guest itself queues when it can't keep up
+        double targetLatency{std::clamp(appendInterval + 2 * appendJitter, MinimumLatency, MaximumLatency)};
+        double bufferedLatency{static_cast<double>(samples.Size() / constant::StereoChannelCount + stretcher.GetHeldFrames()) / constant::SampleRate};
+        double fill{bufferedLatency / targetLatency};
+
+        // Stretching continues till the buffer has recovered somewhat past the target to avoid rapidly toggling it
+        if (fill < 1.0 || (stretching && fill < 1.5)) {
+            // The tempo matches the rate at which the guest submits audio, it's lowered further as the buffer approaches running dry so it can be refilled
+            double recoveryTempo{1.0 - 0.2 * (1.0 - std::min(fill, 1.0))};
+            return std::clamp(std::min(submissionRatio, recoveryTempo), TimeStretcher::MinimumTempo, TimeStretcher::MaximumTempo);
         }
+        return 1.0;
+    }
+
+    void AudioTrack::UpdateNextReleaseSample() {
+        // Identifiers are pushed to the front so the oldest unreleased buffer is the last one that isn't released
+        auto oldestUnreleased{std::find_if(identifiers.crbegin(), identifiers.crend(), [](const BufferIdentifier &identifier) { return !identifier.released; })};
+        nextReleaseSample.store(oldestUnreleased != identifiers.crend() ? oldestUnreleased->finalSample : std::numeric_limits<u64>::max(), std::memory_order_release);
     }
 
     void AudioTrack::CheckReleasedBuffers() {
         bool anyReleased{};
+        u64 playedSamples{sampleCounter.load(std::memory_order_acquire)};
 
         for (auto &identifier : identifiers) {
-            if (identifier.finalSample <= sampleCounter && !identifier.released) {
+            if (identifier.finalSample <= playedSamples && !identifier.released) {
                 anyReleased = true;
                 identifier.released = true;
             }
         }
 
-        if (anyReleased)
+        if (anyReleased) {
+            UpdateNextReleaseSample();
             releaseCallback();
+        }
     }
 }
@@ -5,8 +5,9 @@
 
 #include <deque>
 #include <kernel/types/KEvent.h>
-#include <common/circular_buffer.h>
+#include <common/spsc_ring_buffer.h>
 #include "common.h"
+#include "time_stretcher.h"
 
 namespace skyline::audio {
     /**
@@ -20,19 +21,67 @@ namespace skyline::audio {
         u8 channelCount;
         u32 sampleRate;
 
+        u64 appendedSamples{}; //!< The total amount of samples that have been written into the sample buffer
+        std::vector<float> convertedSamples; //!< A buffer for appended samples converted to floating-point stereo which is reused across appends
+
+        bool timeStretching; //!< If appended audio should be time-stretched when the guest doesn't submit it fast enough to keep the sample buffer filled
+        bool stretching{}; //!< If the stretcher is currently being used, it needs to be flushed prior to appending unstretched samples
+        TimeStretcher stretcher;
+        std::vector<float> stretchedSamples; //!< A buffer for time-stretched samples which is reused across appends
+        std::chrono::steady_clock::time_point lastAppendTime{}; //!< The time at which samples were last appended
+        double appendInterval{}; //!< An exponential moving average of the time between appends in seconds
+        double appendJitter{}; //!< An exponential moving average of the deviation of the time between appends from its average
+        double submissionRatio{1.0}; //!< An exponential moving average of the duration of appended audio relative to the time between appends, this is below 1 when the guest is running slower than real-time
+
+        /**
+         * @brief Updates the sample count at which the audio callback should request released buffers to be checked
+         * @note bufferLock MUST be locked when calling this
+         */
+        void UpdateNextReleaseSample();
+
+        /**
+         * @brief Updates the statistics of guest submissions with an append and determines the tempo that the appended samples should be played at
+         * @return The tempo to play the appended samples at, this is 1 if they shouldn't be stretched
+         * @note bufferLock MUST be locked when calling this
+         */
+        double UpdateTempo(size_t appendedFrames);
+
+        /**
+         * @return The tempo to play appended samples at, this is always 1 when time-stretching is disabled
+         * @note bufferLock MUST be locked when calling this
+         */
+        double GetAppendTempo(size_t appendedFrames);
+
+        /**
+         * @brief Appends interleaved normalized floating-point stereo samples to the sample buffer
+         * @param tempo The tempo from GetAppendTempo to play the samples at
+         * @note bufferLock MUST be locked when calling this
+         */
+        void AppendStereoSamples(u64 tag, span<const float> stereoBuffer, double tempo);
+
+        /**
+         * @brief Queues the identifier of a buffer which ends at the current end of the sample buffer
+         * @note bufferLock MUST be locked when calling this
+         */
+        void QueueIdentifier(u64 tag);
+
       public:
-        CircularBuffer<i16, constant::SampleRate * constant::StereoChannelCount * 10> samples; //!< A circular buffer with all appended audio samples
-        std::mutex bufferLock; //!< Synchronizes appending to audio buffers
+        SpscRingBuffer<float, constant::SampleRate * constant::StereoChannelCount * 10> samples; //!< A ring buffer with all appended audio samples, this is produced into under bufferLock and consumed by the audio callback without any locks
+        std::mutex bufferLock; //!< Synchronizes appending to audio buffers and the buffer identifiers, this MUST never be locked by the audio callback
 
-        AudioOutState playbackState{AudioOutState::Stopped}; //!< The current state of playback
-        u64 sampleCounter{}; //!< A counter used for tracking when buffers have been played and can be released
+        std::atomic<AudioOutState> playbackState{AudioOutState::Stopped}; //!< The current state of playback
+        std::atomic<u64> sampleCounter{}; //!< A counter used for tracking when buffers have been played and can be released, this is only written by the audio callback
+        std::atomic<u64> nextReleaseSample{std::numeric_limits<u64>::max()}; //!< The value of the sample counter at which the oldest unreleased buffer will have been played
+        std::atomic<u64> underrunCount{}; //!< The amount of times the audio callback ran out of samples after having had enough, this is only written by the audio callback
+        bool starved{true}; //!< If the audio callback ran out of samples during its last invocation, this is only accessed by the audio callback
 
         /**
          * @param channelCount The amount channels that will be present in the track
          * @param sampleRate The sample rate to use for the track
          * @param releaseCallback A callback to call when a buffer has been played
+         * @param timeStretching If appended audio should be time-stretched to avoid underruns when the guest doesn't keep up
          */
-        AudioTrack(u8 channelCount, u32 sampleRate, std::function<void()> releaseCallback);
+        AudioTrack(u8 channelCount, u32 sampleRate, std::function<void()> releaseCallback, bool timeStretching);
 
         /**
          * @brief Starts audio playback using data from appended buffers
@@ -63,13 +112,20 @@ namespace skyline::audio {
         /**
          * @brief Appends audio samples to the output buffer
          * @param tag The tag of the buffer
-         * @param buffer A span containing the source sample buffer
+         * @param buffer A span containing the source sample buffer, these are converted to floating-point directly into the sample buffer unless they need to be time-stretched
          */
         void AppendBuffer(u64 tag, span<i16> buffer = {});
 
+        /**
+         * @brief Appends normalized floating-point stereo samples to the output buffer without any conversion
+         * @param tag The tag of the buffer
+         * @param buffer A span containing interleaved stereo samples, the track MUST have been opened with a stereo channel count
+         */
+        void AppendBuffer(u64 tag, span<const float> buffer);
+
         /**
          * @brief Checks if any buffers have been released and calls the appropriate callback for them
-         * @note bufferLock MUST be locked when calling this
+         * @note bufferLock MUST be locked when calling this, so this must not be called from the audio callback
          */
         void CheckReleasedBuffers();
     };
@@ -17,6 +17,12 @@ namespace skyline {
 
     struct EmptyStruct {};
 
+    /**
+     * @brief A callback that's called with every CPU memory region accessed by a memory manager operation, nullptr can be supplied when none is needed so the call is compiled out
+     */
+    template<typename T>
+    concept CpuAccessCallback = std::is_null_pointer_v<std::remove_cvref_t<T>> || std::invocable<T, span<u8>>;
+
     /**
      * @brief FlatAddressSpaceMap provides a generic VA->PA mapping implementation using a sorted vector
      */
@@ -108,24 +114,83 @@ namespace skyline {
 
         static constexpr size_t AddressSpaceSize{1ULL << AddressSpaceBits};
         SegmentTable<SegmentTableEntry, AddressSpaceSize, VaGranularityBits, VaL2GranularityBits> blockSegmentTable; //!< A page table of all buffer mappings for O(1) lookups on full matches
+        std::atomic<u32> segmentTableSequence{}; //!< A sequence counter for `blockSegmentTable` which is odd while it's being modified, this allows lookups to skip locking by retrying if they raced with a modification
 
-        TranslatedAddressRange TranslateRangeImpl(VaType virt, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
+        template<typename Callback>
+        static void InvokeCpuAccessCallback(Callback &&cpuAccessCallback, span<u8> region) {
+            if constexpr (!std::is_null_pointer_v<std::remove_cvref_t<Callback>>)
+                cpuAccessCallback(region);
+        }
 
-        std::pair<span<u8>, size_t> LookupBlockLocked(VaType virt, std::function<void(span<u8>)> cpuAccessCallback = {}) {
-            const auto &blockEntry{this->blockSegmentTable[virt]};
-            VaType segmentOffset{virt - blockEntry.virt};
+        /**
+         * @brief Marks the start of a modification of the segment table, readers of the table are guaranteed to observe either none or all of the changes made until `EndSegmentUpdateLocked()` is called
+         * @note blockMutex MUST be exclusively locked when calling this
+         */
+        void BeginSegmentUpdateLocked() {
+            segmentTableSequence.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
 
-            if (blockEntry.extraInfo.sparseMapped || blockEntry.phys == nullptr)
-                return {span<u8>{static_cast<u8*>(nullptr), blockEntry.extent}, segmentOffset};
+        /**
+         * @note blockMutex MUST be exclusively locked when calling this
+         */
+        void EndSegmentUpdateLocked() {
+            segmentTableSequence.fetch_add(1, std::memory_order_release);
+        }
 
-            span<u8> blockSpan{blockEntry.phys, blockEntry.extent};
-            if (cpuAccessCallback)
-                cpuAccessCallback(blockSpan);
+        /**
+         * @brief Applies a single mapping change to both the segment table and the block map
+         * @note blockMutex MUST be exclusively locked and `BeginSegmentUpdateLocked()` MUST have been called when calling this
+         */
+        void ApplyMappingLocked(VaType virt, u8 *phys, VaType size, MemoryManagerBlockInfo extraInfo) {
+            if (phys) {
+                blockSegmentTable.Set(virt, virt + size, {virt, phys, size, extraInfo});
+                this->MapLocked(virt, phys, size, extraInfo);
+            } else {
+                blockSegmentTable.Set(virt, virt + size, {});
+                this->UnmapLocked(virt, size);
+            }
+        }
 
-            return {blockSpan, segmentOffset};
+        /**
+         * @return The segment table entry for the given VA, this doesn't lock unless a concurrent modification of the table is detected
+         */
+        __attribute__((always_inline)) SegmentTableEntry LookupSegment(VaType virt) {
+            u32 sequence{segmentTableSequence.load(std::memory_order_acquire)};
+            if (!(sequence & 1)) [[likely]] {
+                SegmentTableEntry entry{blockSegmentTable[virt]};
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (segmentTableSequence.load(std::memory_order_relaxed) == sequence) [[likely]]
+                    return entry;
+            }
+
+            std::shared_lock lock{this->blockMutex};
+            return blockSegmentTable[virt];
         }
 
+        TranslatedAddressRange TranslateRangeImpl(VaType virt, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
+
+        /**
+         * @brief Reads a range which may span multiple blocks by walking the block map
+         */
+        void ReadImpl(u8 *destination, VaType virt, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
+
+        /**
+         * @brief Writes a range which may span multiple blocks by walking the block map
+         */
+        void WriteImpl(VaType virt, u8 *source, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
+
       public:
+        /**
+         * @brief A single change to the mappings of the AS for use with `MapBatch()`
+         */
+        struct MappingUpdate {
+            VaType virt;
+            u8 *phys; //!< The PA to map the region to, nullptr will unmap the region instead
+            VaType size;
+            MemoryManagerBlockInfo extraInfo;
+        };
+
         FlatMemoryManager();
 
         ~FlatMemoryManager();
@@ -140,39 +205,65 @@ namespace skyline {
         /**
          * @brief Looks up the mapped region that contains the given VA
          * @return A span of the mapped region and the offset of the input VA in the region
+         * @note This doesn't lock, the mapping is only guaranteed to be valid so long as the guest doesn't concurrently unmap it
          */
-        __attribute__((always_inline)) std::pair<span<u8>, VaType> LookupBlock(VaType virt, std::function<void(span<u8>)> cpuAccessCallback = {}) {
-            std::shared_lock lock{this->blockMutex};
-            return LookupBlockLocked(virt, cpuAccessCallback);
+        template<CpuAccessCallback Callback = std::nullptr_t>
+        __attribute__((always_inline)) std::pair<span<u8>, VaType> LookupBlock(VaType virt, Callback &&cpuAccessCallback = nullptr) {
+            auto blockEntry{LookupSegment(virt)};
+            VaType segmentOffset{virt - blockEntry.virt};
+
+            if (blockEntry.extraInfo.sparseMapped || blockEntry.phys == nullptr)
+                return {span<u8>{static_cast<u8 *>(nullptr), blockEntry.extent}, segmentOffset};
+
+            span<u8> blockSpan{blockEntry.phys, blockEntry.extent};
+            InvokeCpuAccessCallback(cpuAccessCallback, blockSpan);
+
+            return {blockSpan, segmentOffset};
         }
 
         /**
          * @brief Translates a region in the VA space to a corresponding set of regions in the PA space
          */
-        TranslatedAddressRange TranslateRange(VaType virt, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {}) {
-            std::shared_lock lock{this->blockMutex};
-
+        template<CpuAccessCallback Callback = std::nullptr_t>
+        TranslatedAddressRange TranslateRange(VaType virt, VaType size, Callback &&cpuAccessCallback = nullptr) {
             // Fast path for when the range is mapped in a single block
-            auto [blockSpan, rangeOffset]{LookupBlockLocked(virt, cpuAccessCallback)};
+            auto [blockSpan, rangeOffset]{LookupBlock(virt, cpuAccessCallback)};
             if (blockSpan.size() - rangeOffset >= size) {
                 TranslatedAddressRange ranges;
                 ranges.push_back(blockSpan.subspan(blockSpan.valid() ? rangeOffset : 0, size));
                 return ranges;
             }
 
+            std::shared_lock lock{this->blockMutex};
             return TranslateRangeImpl(virt, size, cpuAccessCallback);
         }
 
+        template<CpuAccessCallback Callback = std::nullptr_t>
+        void Read(u8 *destination, VaType virt, VaType size, Callback &&cpuAccessCallback = nullptr) {
+            // Fast path for when the range is mapped in a single block, this avoids locking and searching the block map
+            auto blockEntry{LookupSegment(virt)};
+            VaType segmentOffset{virt - blockEntry.virt};
+            if (blockEntry.phys && segmentOffset + size <= blockEntry.extent) [[likely]] {
+                if (blockEntry.extraInfo.sparseMapped) { // Sparse mappings read all zeroes
+                    std::memset(destination, 0, size);
+                } else {
+                    span<u8> region{blockEntry.phys + segmentOffset, size};
+                    InvokeCpuAccessCallback(cpuAccessCallback, region);
+                    std::memcpy(destination, region.data(), size);
+                }
+                return;
+            }
 
-        void Read(u8 *destination, VaType virt, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
+            ReadImpl(destination, virt, size, cpuAccessCallback);
+        }
 
-        template<typename T>
-        void Read(span <T> destination, VaType virt, std::function<void(span<u8>)> cpuAccessCallback = {}) {
+        template<typename T, CpuAccessCallback Callback = std::nullptr_t>
+        void Read(span <T> destination, VaType virt, Callback &&cpuAccessCallback = nullptr) {
             Read(reinterpret_cast<u8 *>(destination.data()), virt, destination.size_bytes(), cpuAccessCallback);
         }
 
-        template<typename T>
-        T Read(VaType virt, std::function<void(span<u8>)> cpuAccessCallback = {}) {
+        template<typename T, CpuAccessCallback Callback = std::nullptr_t>
+        T Read(VaType virt, Callback &&cpuAccessCallback = nullptr) {
             T obj;
             Read(reinterpret_cast<u8 *>(&obj), virt, sizeof(T), cpuAccessCallback);
             return obj;
@@ -185,8 +276,8 @@ namespace skyline {
          * @note The function will **NOT** be run on any sparse block
          * @note The function will provide no feedback on if the end has been reached or if there was an early exit
          */
-        template<typename Function, typename Container>
-        span<u8> ReadTill(Container& destination, VaType virt, Function function, std::function<void(span<u8>)> cpuAccessCallback = {}) {
+        template<typename Function, typename Container, CpuAccessCallback Callback = std::nullptr_t>
+        span<u8> ReadTill(Container& destination, VaType virt, Function function, Callback &&cpuAccessCallback = nullptr) {
             //TRACE_EVENT("containers", "FlatMemoryManager::ReadTill");
 
             std::shared_lock lock(this->blockMutex);
@@ -211,8 +302,7 @@ namespace skyline {
                         std::memset(pointer, 0, blockReadSize);
                     } else {
                         span<u8> cpuBlock{blockPhys, blockReadSize};
-                        if (cpuAccessCallback)
-                            cpuAccessCallback(cpuBlock);
+                        InvokeCpuAccessCallback(cpuAccessCallback, cpuBlock);
 
                         auto end{function(cpuBlock)};
                         std::memcpy(pointer, blockPhys, end ? *end : blockReadSize);
@@ -234,14 +324,30 @@ namespace skyline {
             return {destination.data(), destination.size()};
         }
 
-        void Write(VaType virt, u8 *source, VaType size, std::function<void(span<u8>)> cpuAccessCallback = {});
+        template<CpuAccessCallback Callback = std::nullptr_t>
+        void Write(VaType virt, u8 *source, VaType size, Callback &&cpuAccessCallback = nullptr) {
+            // Fast path for when the range is mapped in a single block, this avoids locking and searching the block map
+            auto blockEntry{LookupSegment(virt)};
+            VaType segmentOffset{virt - blockEntry.virt};
+            if (blockEntry.phys && segmentOffset + size <= blockEntry.extent) [[likely]] {
+                if (!blockEntry.extraInfo.sparseMapped) { // Sparse mappings ignore writes
+                    span<u8> region{blockEntry.phys + segmentOffset, size};
+                    InvokeCpuAccessCallback(cpuAccessCallback, region);
+                    std::memcpy(region.data(), source, size);
+                }
+                return;
+            }
+
+            WriteImpl(virt, source, size, cpuAccessCallback);
+        }
 
-        template<typename T>
-        void Write(VaType virt, span<T> source, std::function<void(span<u8>)> cpuAccessCallback = {}) {
-            Write(virt, reinterpret_cast<u8 *>(source.data()), source.size_bytes());
+        template<typename T, CpuAccessCallback Callback = std::nullptr_t>
+        void Write(VaType virt, span<T> source, Callback &&cpuAccessCallback = nullptr) {
+            Write(virt, reinterpret_cast<u8 *>(source.data()), source.size_bytes(), cpuAccessCallback);
         }
 
-        void Write(VaType virt, util::TrivialObject auto source, std::function<void(span<u8>)> cpuAccessCallback = {}) {
+        template<util::TrivialObject T, CpuAccessCallback Callback = std::nullptr_t>
+        void Write(VaType virt, T source, Callback &&cpuAccessCallback = nullptr) {
             Write(virt, reinterpret_cast<u8 *>(&source), sizeof(source), cpuAccessCallback);
         }
 
@@ -249,14 +355,34 @@ namespace skyline {
 
         void Map(VaType virt, u8 *phys, VaType size, MemoryManagerBlockInfo extraInfo = {}) {
             std::scoped_lock lock(this->blockMutex);
-            blockSegmentTable.Set(virt, virt + size, {virt, phys, size, extraInfo});
-            this->MapLocked(virt, phys, size, extraInfo);
+            BeginSegmentUpdateLocked();
+            ApplyMappingLocked(virt, phys, size, extraInfo);
+            EndSegmentUpdateLocked();
         }
 
         void Unmap(VaType virt, VaType size) {
             std::scoped_lock lock(this->blockMutex);
-            blockSegmentTable.Set(virt, virt + size, {});
-            this->UnmapLocked(virt, size);
+            BeginSegmentUpdateLocked();
+            ApplyMappingLocked(virt, nullptr, size, {});
+            EndSegmentUpdateLocked();
+        }
+
+        /**
+         * @brief Applies a batch of mapping changes in order under a single lock acquisition, lookups will observe either none or all of the changes
+         */
+        void MapBatch(span<const MappingUpdate> updates) {
+            std::scoped_lock lock(this->blockMutex);
+            BeginSegmentUpdateLocked();
+            for (const auto &update : updates)
+                ApplyMappingLocked(update.virt, update.phys, update.size, update.extraInfo);
+            EndSegmentUpdateLocked();
+        }
+
+        /**
+         * @return A value that changes whenever the mappings of the AS are modified, this can be used to validate cached lookups without repeating them
+         */
+        u32 GetMappingSequence() const {
+            return segmentTableSequence.load(std::memory_order_acquire);
         }
     };
 
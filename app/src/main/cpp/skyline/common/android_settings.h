@@ -36,19 +36,43 @@ namespace skyline {
             profilePictureValue = ktSettings.GetString("profilePictureValue");
             systemLanguage = ktSettings.GetInt<skyline::language::SystemLanguage>("systemLanguage");
             systemRegion = ktSettings.GetInt<skyline::region::RegionCode>("systemRegion");
+            pinGuestCores = ktSettings.GetBool("pinGuestCores");
+            gpfifoAffinity = ktSettings.GetInt<host::AffinityClass>("gpfifoAffinity");
+            commandRecordAffinity = ktSettings.GetInt<host::AffinityClass>("commandRecordAffinity");
+            pipelineCompileAffinity = ktSettings.GetInt<host::AffinityClass>("pipelineCompileAffinity");
+            audioAffinity = ktSettings.GetInt<host::AffinityClass>("audioAffinity");
+            prefaultGuestMemory = ktSettings.GetBool("prefaultGuestMemory");
+            warmBootSnapshot = ktSettings.GetBool("warmBootSnapshot");
+            romFsCacheSize = ktSettings.GetInt<u32>("romFsCacheSize");
             forceTripleBuffering = ktSettings.GetBool("forceTripleBuffering");
             disableFrameThrottling = ktSettings.GetBool("disableFrameThrottling");
+            lowLatencyPresentation = ktSettings.GetBool("lowLatencyPresentation");
             gpuDriver = ktSettings.GetString("gpuDriver");
             gpuDriverLibraryName = ktSettings.GetString("gpuDriverLibraryName");
             executorSlotCountScale = ktSettings.GetInt<u32>("executorSlotCountScale");
             executorFlushThreshold = ktSettings.GetInt<u32>("executorFlushThreshold");
             useDirectMemoryImport = ktSettings.GetBool("useDirectMemoryImport");
             forceMaxGpuClocks = ktSettings.GetBool("forceMaxGpuClocks");
+            useGpuTextureDeswizzle = ktSettings.GetBool("useGpuTextureDeswizzle");
+            asyncWriteTracking = ktSettings.GetBool("asyncWriteTracking");
+            asyncPipelineCreation = ktSettings.GetBool("asyncPipelineCreation");
+            textureMemoryBudget = ktSettings.GetInt<u32>("textureMemoryBudget");
+            resolutionScale = ktSettings.GetInt<u32>("resolutionScale");
             disableShaderCache = ktSettings.GetBool("disableShaderCache");
+            disableTextureCache = ktSettings.GetBool("disableTextureCache");
             enableFastGpuReadbackHack = ktSettings.GetBool("enableFastGpuReadbackHack");
             disableSubgroupShuffle = ktSettings.GetBool("disableSubgroupShuffle");
+            hleServiceFastPath = ktSettings.GetBool("hleServiceFastPath");
             isAudioOutputDisabled = ktSettings.GetBool("isAudioOutputDisabled");
+            highQualityAudioResampling = ktSettings.GetBool("highQualityAudioResampling");
+            audioTimeStretching = ktSettings.GetBool("audioTimeStretching");
             validationLayer = ktSettings.GetBool("validationLayer");
+            logUnhandledMacros = ktSettings.GetBool("logUnhandledMacros");
+            guestProfiler = ktSettings.GetBool("guestProfiler");
+            flightRecorderThreshold = ktSettings.GetInt<u32>("flightRecorderThreshold");
+            gpfifoCapture = ktSettings.GetBool("gpfifoCapture");
+
+            ApplyTitleProfile();
         };
     };
 }
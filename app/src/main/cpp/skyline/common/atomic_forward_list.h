@@ -4,6 +4,7 @@
 #pragma once
 
 #include <atomic>
+#include "object_pool.h"
 
 namespace skyline {
     /**
@@ -17,6 +18,13 @@ namespace skyline {
             Type value;
         };
 
+        using NodePool = ObjectPool<sizeof(Node), alignof(Node)>; //!< Nodes are pooled as they're allocated and freed at high rates by fence cycle dependencies
+
+        template<typename... Args>
+        static Node *AllocateNode(Args &&... args) {
+            return new (NodePool::Allocate()) Node{std::forward<Args>(args)...};
+        }
+
         std::atomic<Node *> head{}; //!< The head of the list
 
       public:
@@ -40,7 +48,8 @@ namespace skyline {
             auto current{head.exchange(nullptr, std::memory_order_acquire)};
             while (current) {
                 auto next{current->next};
-                delete current;
+                std::destroy_at(current);
+                NodePool::Deallocate(current);
                 current = next;
             }
         }
@@ -49,7 +58,7 @@ namespace skyline {
          * @brief Appends an item to the start of the list
          */
         void Append(Type item) {
-            auto node{new Node{nullptr, item}};
+            auto node{AllocateNode(nullptr, item)};
             auto next{head.load(std::memory_order_consume)};
             do {
                 node->next = next;
@@ -63,10 +72,10 @@ namespace skyline {
             if (std::empty(items))
                 return;
 
-            Node* firstNode{new Node{nullptr, *items.begin()}};
+            Node* firstNode{AllocateNode(nullptr, *items.begin())};
             Node* lastNode{firstNode};
             for (auto item{items.begin() + 1}; item != items.end(); item++)
-                lastNode = new Node{lastNode, *item};
+                lastNode = AllocateNode(lastNode, *item);
 
             auto next{head.load(std::memory_order_consume)};
             do {
@@ -79,6 +88,30 @@ namespace skyline {
             Append(std::initializer_list<Type>{std::forward<Items>(items)...});
         }
 
+        /**
+         * @brief Removes all items from the list and calls the given function on them in the order they were appended in, prior to deallocating them
+         * @note Items appended during this call are left in the list for the next one
+         */
+        template<typename Function>
+        void Drain(Function function) {
+            // The list is in reverse order of appending, it's reversed in-place so it can be walked from the oldest item
+            Node *current{head.exchange(nullptr, std::memory_order_acquire)}, *oldest{};
+            while (current) {
+                auto next{current->next};
+                current->next = oldest;
+                oldest = current;
+                current = next;
+            }
+
+            while (oldest) {
+                auto next{oldest->next};
+                function(oldest->value);
+                std::destroy_at(oldest);
+                NodePool::Deallocate(oldest);
+                oldest = next;
+            }
+        }
+
         /**
          * @brief Iterates over every single list item and calls the given function
          * @note This function is **not** thread-safe when used with Clear() as the item may be deallocated while iterating
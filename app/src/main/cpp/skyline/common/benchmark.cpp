@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <gpu.h>
+#include <audio.h>
+#include <input.h>
+#include <os.h>
+#include <kernel/types/KProcess.h>
+#include "benchmark.h"
+
+namespace skyline {
+    namespace {
+        constexpr std::array<const char *, MemoryReport::CategoryCount> CategoryKeys{
+            "guestUser",
+            "guestSystemResource",
+            "vulkanTexture",
+            "vulkanBuffer",
+            "vulkanMegaBuffer",
+            "vulkanStaging",
+            "vulkanStagingIdle",
+            "vulkanMiscellaneous",
+            "pipelineCacheMapping",
+            "romFsCache",
+            "audio",
+        };
+
+        constexpr std::array<const char *, FrameStatistics::PhaseCount> PhaseKeys{
+            "guestCpuNs",
+            "gpfifoDecodeNs",
+            "commandRecordingNs",
+            "gpuExecutionNs",
+            "presentWaitNs",
+        };
+    }
+
+    Benchmark::Benchmark(const DeviceState &state, u32 frameCount, std::vector<InputEvent> events) : state{state}, frameCount{frameCount}, events{std::move(events)} {
+        frames.reserve(frameCount);
+    }
+
+    std::vector<Benchmark::InputEvent> Benchmark::ParseScript(const std::string &path) {
+        std::ifstream file{path};
+        if (!file)
+            throw exception("Failed to open the benchmark input script '{}'", path);
+
+        std::vector<InputEvent> events;
+        std::string line;
+        for (size_t lineNumber{1}; std::getline(file, line); lineNumber++) {
+            std::istringstream stream{line};
+            u32 frame;
+            std::string type;
+            if (!(stream >> frame >> type)) {
+                if (line.find_first_not_of(" \t\r") == std::string::npos || line.front() == '#')
+                    continue;
+                throw exception("Malformed line {} in the benchmark input script: '{}'", lineNumber, line);
+            }
+
+            InputEvent event{.frame = frame};
+            if (type == "button") {
+                u64 mask;
+                int pressed;
+                if (!(stream >> std::hex >> mask >> std::dec >> pressed))
+                    throw exception("Malformed button event on line {} in the benchmark input script: '{}'", lineNumber, line);
+                event.buttons = input::NpadButton{.raw = mask};
+                event.pressed = pressed != 0;
+            } else if (type == "axis") {
+                std::string axis;
+                if (!(stream >> axis >> event.value))
+                    throw exception("Malformed axis event on line {} in the benchmark input script: '{}'", lineNumber, line);
+                event.isAxis = true;
+                if (axis == "LX")
+                    event.axis = input::NpadAxisId::LX;
+                else if (axis == "LY")
+                    event.axis = input::NpadAxisId::LY;
+                else if (axis == "RX")
+                    event.axis = input::NpadAxisId::RX;
+                else if (axis == "RY")
+                    event.axis = input::NpadAxisId::RY;
+                else
+                    throw exception("Unknown axis '{}' on line {} in the benchmark input script", axis, lineNumber);
+            } else {
+                throw exception("Unknown event type '{}' on line {} in the benchmark input script", type, lineNumber);
+            }
+            events.push_back(event);
+        }
+
+        // Events on the same frame are applied in the order they were written in
+        std::stable_sort(events.begin(), events.end(), [](const InputEvent &a, const InputEvent &b) { return a.frame < b.frame; });
+        return events;
+    }
+
+    void Benchmark::Configure(u32 frames, std::string scriptPath) {
+        configuredFrames = frames;
+        configuredScriptPath = std::move(scriptPath);
+    }
+
+    std::unique_ptr<Benchmark> Benchmark::Create(const DeviceState &state) {
+        if (!configuredFrames)
+            return nullptr;
+
+        std::vector<InputEvent> events;
+        if (!configuredScriptPath.empty())
+            events = ParseScript(configuredScriptPath);
+
+        Logger::Info("Benchmarking for {} frames with {} scripted input events", configuredFrames, events.size());
+        return std::unique_ptr<Benchmark>{new Benchmark(state, configuredFrames, std::move(events))};
+    }
+
+    std::pair<u64, u64> Benchmark::GetLookupCounts() {
+        if (state.gpu && state.gpu->graphicsPipelineManager)
+            return state.gpu->graphicsPipelineManager->GetLookupCounts();
+        return {};
+    }
+
+    void Benchmark::SampleMemory() {
+        auto report{MemoryReport::Collect(state)};
+        u64 total{};
+        for (size_t index{}; index < MemoryReport::CategoryCount; index++) {
+            peakMemory.bytes[index] = std::max(peakMemory.bytes[index], report.bytes[index]);
+            total += report.bytes[index];
+        }
+        peakTotalMemory = std::max(peakTotalMemory, total);
+    }
+
+    void Benchmark::OnFrame(const FrameStatistics::FrameRecord &record) {
+        if (finished)
+            return;
+
+        if (frames.empty()) {
+            // The counters are cumulative over the session, so they're offset by their values at the start of the benchmark
+            startLookupCounts = GetLookupCounts();
+            startUnderruns = state.audio ? state.audio->GetUnderrunCount() : 0;
+        }
+
+        frames.push_back(record);
+        if (frames.size() % MemorySampleInterval == 1)
+            SampleMemory();
+
+        if (frames.size() >= frameCount) {
+            Finish();
+            return;
+        }
+
+        auto currentFrame{static_cast<u32>(frames.size())};
+        for (; nextEvent < events.size() && events[nextEvent].frame <= currentFrame; nextEvent++) {
+            const auto &event{events[nextEvent]};
+            if (event.isAxis)
+                state.input->QueueAxisValue(0, event.axis, event.value);
+            else
+                state.input->QueueButtonState(0, event.buttons, event.pressed);
+        }
+    }
+
+    void Benchmark::Finish() {
+        finished = true;
+        SampleMemory();
+
+        std::vector<u64> frametimes;
+        frametimes.reserve(frames.size());
+        u64 totalFrametime{}, totalShaderCompiles{};
+        for (const auto &frame : frames) {
+            frametimes.push_back(frame.frametimeNs);
+            totalFrametime += frame.frametimeNs;
+            totalShaderCompiles += frame.shaderCompiles;
+        }
+        std::sort(frametimes.begin(), frametimes.end());
+        auto percentile{[&](size_t percent) { return frametimes[(frametimes.size() - 1) * percent / 100]; }};
+
+        auto [hits, misses]{GetLookupCounts()};
+        hits -= startLookupCounts.first;
+        misses -= startLookupCounts.second;
+        u64 underruns{(state.audio ? state.audio->GetUnderrunCount() : 0) - startUnderruns};
+
+        std::string report{"{\n"};
+        report += fmt::format("  \"frames\": {},\n", frames.size());
+        report += fmt::format("  \"durationNs\": {},\n", totalFrametime);
+        report += fmt::format("  \"averageFps\": {:.2f},\n", totalFrametime ? static_cast<double>(frames.size()) * constant::NsInSecond / static_cast<double>(totalFrametime) : 0.0);
+        report += fmt::format("  \"frametimeNs\": {{\"average\": {}, \"p50\": {}, \"p90\": {}, \"p99\": {}, \"max\": {}}},\n", totalFrametime / frames.size(), percentile(50), percentile(90), percentile(99), frametimes.back());
+        report += fmt::format("  \"shaderCompiles\": {},\n", totalShaderCompiles);
+        report += fmt::format("  \"pipelineCache\": {{\"hits\": {}, \"misses\": {}, \"hitRate\": {:.4f}}},\n", hits, misses, (hits + misses) ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0);
+        report += fmt::format("  \"audioUnderruns\": {},\n", underruns);
+
+        report += fmt::format("  \"peakMemoryBytes\": {{\"total\": {}", peakTotalMemory);
+        for (size_t index{}; index < MemoryReport::CategoryCount; index++)
+            report += fmt::format(", \"{}\": {}", CategoryKeys[index], peakMemory.bytes[index]);
+        report += "},\n";
+
+        report += "  \"frameRecords\": [\n";
+        for (size_t index{}; index < frames.size(); index++) {
+            const auto &frame{frames[index]};
+            report += fmt::format("    {{\"frametimeNs\": {}", frame.frametimeNs);
+            for (size_t phase{}; phase < FrameStatistics::PhaseCount; phase++)
+                report += fmt::format(", \"{}\": {}", PhaseKeys[phase], frame.phaseNs[phase]);
+            report += fmt::format(", \"shaderCompiles\": {}}}{}\n", frame.shaderCompiles, (index + 1 < frames.size()) ? "," : "");
+        }
+        report += "  ]\n}\n";
+
+        std::string directory{state.os->publicAppFilesPath + "benchmarks/"};
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            Logger::Warn("Failed to create the benchmark directory '{}': {}", directory, error.message());
+        } else {
+            auto path{fmt::format("{}{}.json", directory, std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count())};
+            std::ofstream file{path, std::ios::trunc};
+            if (file << report)
+                Logger::Info("Wrote the benchmark report to '{}'", path);
+            else
+                Logger::Warn("Failed to write the benchmark report to '{}'", path);
+        }
+
+        // Emulation is stopped in the same way as the frontend does, the activity finishes once the emulation thread returns
+        if (auto process{state.process})
+            process->Kill(false, false, true);
+    }
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+#include <common/frame_statistics.h>
+#include <common/memory_report.h>
+#include <input/npad_device.h>
+
+namespace skyline {
+    /**
+     * @brief Runs a title non-interactively for a fixed amount of frames with scripted input and writes a JSON report of its performance, this is used to compare builds on CI devices
+     * @details The input script is a text file where every line is an event applied when its frame is presented, `<frame> button <mask> <0|1>` sets the state of the buttons in the hexadecimal mask and `<frame> axis <LX|LY|RX|RY> <value>` sets the value of a stick axis, empty lines and lines starting with '#' are ignored
+     * @note The benchmark must be configured prior to emulation starting as it's only picked up when the presentation engine is created
+     */
+    class Benchmark {
+      private:
+        static constexpr u32 MemorySampleInterval{30}; //!< The interval in frames at which memory usage is sampled, collecting a memory report is too expensive to do every frame
+
+        /**
+         * @brief A single event from the input script
+         */
+        struct InputEvent {
+            u32 frame; //!< The frame at which the event is applied
+            bool isAxis; //!< If this sets the value of an axis rather than the state of buttons
+            input::NpadButton buttons; //!< The buttons to set the state of
+            bool pressed;
+            input::NpadAxisId axis;
+            i32 value;
+        };
+
+        inline static u32 configuredFrames{}; //!< The amount of frames to run for, zero if benchmarking is disabled
+        inline static std::string configuredScriptPath; //!< The path to the input script, empty if there's no input
+
+        const DeviceState &state;
+        u32 frameCount; //!< The amount of frames to run for
+        std::vector<InputEvent> events; //!< All events from the input script sorted by frame
+        size_t nextEvent{}; //!< The index of the next event to be applied
+        std::vector<FrameStatistics::FrameRecord> frames; //!< The records of all frames presented so far
+        MemoryReport peakMemory{}; //!< The peak usage of every memory category
+        u64 peakTotalMemory{}; //!< The peak total memory usage across all categories, this isn't the sum of the peaks as they might not coincide
+        std::pair<u64, u64> startLookupCounts{}; //!< The pipeline cache hit and miss counts at the start of the benchmark
+        u64 startUnderruns{}; //!< The amount of audio underruns at the start of the benchmark
+        bool finished{};
+
+        Benchmark(const DeviceState &state, u32 frameCount, std::vector<InputEvent> events);
+
+        /**
+         * @brief Parses the input script at the supplied path
+         */
+        static std::vector<InputEvent> ParseScript(const std::string &path);
+
+        std::pair<u64, u64> GetLookupCounts();
+
+        void SampleMemory();
+
+        /**
+         * @brief Writes the report out to a file in the public app files directory and stops emulation
+         */
+        void Finish();
+
+      public:
+        /**
+         * @brief Sets the parameters of the benchmark for the next emulation session
+         * @param frames The amount of frames to run for, zero disables benchmarking
+         * @param scriptPath The path to the input script, this can be empty for no input
+         */
+        static void Configure(u32 frames, std::string scriptPath);
+
+        /**
+         * @return A benchmark for the configured parameters or nullptr if benchmarking is disabled
+         */
+        static std::unique_ptr<Benchmark> Create(const DeviceState &state);
+
+        /**
+         * @brief Records a presented frame and applies any scripted input for the next one, emulation is stopped once all frames have been presented
+         * @note This must only be called from a single thread
+         */
+        void OnFrame(const FrameStatistics::FrameRecord &record);
+    };
+}
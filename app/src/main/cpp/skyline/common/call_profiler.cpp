@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "trace.h"
+#include "call_profiler.h"
+
+namespace skyline {
+    void CallProfiler::CallStatistics::Record(u64 durationNs) {
+        // There's a single writer for any statistics so a load and store is sufficient, this avoids the cost of an atomic RMW on every call
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        totalNs.store(totalNs.load(std::memory_order_relaxed) + durationNs, std::memory_order_relaxed);
+
+        size_t bucket{std::min<size_t>(durationNs ? static_cast<size_t>(std::bit_width(durationNs) - 1) : 0, HistogramBucketCount - 1)};
+        histogram[bucket].store(histogram[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    CallProfiler::ThreadProfile::ThreadProfile(size_t threadId) : threadId{threadId} {}
+
+    CallProfiler::CallStatistics *CallProfiler::ThreadProfile::GetServiceCommand(const char *name) {
+        // Names are static strings so their addresses uniquely identify them, a Fibonacci hash spreads them across the table
+        constexpr u64 FibonacciMultiplier{0x9E3779B97F4A7C15};
+        size_t index{static_cast<size_t>((reinterpret_cast<u64>(name) * FibonacciMultiplier) >> (64 - std::countr_zero(ServiceCommandCapacity)))};
+        for (size_t probe{}; probe < ServiceCommandCapacity; probe++) {
+            auto &statistics{serviceCommands[(index + probe) & (ServiceCommandCapacity - 1)]};
+            auto entryName{statistics.name.load(std::memory_order_relaxed)};
+            if (entryName == name)
+                return &statistics;
+
+            if (!entryName) {
+                statistics.name.store(name, std::memory_order_release);
+                return &statistics;
+            }
+        }
+        return nullptr;
+    }
+
+    CallProfiler::ThreadProfile &CallProfiler::GetThreadProfile(size_t threadId) {
+        if (threadProfile && threadProfile->threadId == threadId) [[likely]]
+            return *threadProfile;
+
+        // Profiles are intentionally leaked so they can be dumped after the thread exits, there's only a profile per guest thread
+        threadProfile = new ThreadProfile(threadId);
+        auto head{profiles.load(std::memory_order_relaxed)};
+        do {
+            threadProfile->next = head;
+        } while (!profiles.compare_exchange_weak(head, threadProfile, std::memory_order_release, std::memory_order_relaxed));
+        return *threadProfile;
+    }
+
+    void CallProfiler::EmitTraceCounters(u64 timestamp) {
+        constexpr u64 CounterInterval{100 * constant::NsInMillisecond}; //!< The minimum interval between counters being emitted, this bounds the overhead of aggregating them
+
+        auto lastTimestamp{lastCounterTimestamp.load(std::memory_order_relaxed)};
+        if (timestamp - lastTimestamp < CounterInterval || !lastCounterTimestamp.compare_exchange_strong(lastTimestamp, timestamp, std::memory_order_relaxed))
+            return; // Only a single thread emits counters for every interval
+
+        std::array<u64, ThreadProfile::SvcCount> svcCounts{};
+        std::array<const char *, ThreadProfile::SvcCount> svcNames{};
+        std::unordered_map<const char *, u64> serviceCounts;
+        for (auto profile{profiles.load(std::memory_order_acquire)}; profile; profile = profile->next) {
+            for (size_t svc{}; svc < ThreadProfile::SvcCount; svc++) {
+                if (auto name{profile->svcs[svc].name.load(std::memory_order_acquire)}) {
+                    svcNames[svc] = name;
+                    svcCounts[svc] += profile->svcs[svc].count.load(std::memory_order_relaxed);
+                }
+            }
+
+            for (auto &command : profile->serviceCommands)
+                if (auto name{command.name.load(std::memory_order_acquire)})
+                    serviceCounts[name] += command.count.load(std::memory_order_relaxed);
+        }
+
+        for (size_t svc{}; svc < ThreadProfile::SvcCount; svc++)
+            if (svcNames[svc])
+                TRACE_COUNTER("kernel", perfetto::CounterTrack{svcNames[svc], "calls"}, svcCounts[svc]);
+
+        for (const auto &[name, count] : serviceCounts)
+            TRACE_COUNTER("service", perfetto::CounterTrack{name, "calls"}, count);
+    }
+
+    void CallProfiler::RecordSvc(size_t threadId, u16 svcId, const char *name, u64 startNs, u64 endNs) {
+        if (svcId >= ThreadProfile::SvcCount) [[unlikely]]
+            return;
+
+        auto &statistics{GetThreadProfile(threadId).svcs[svcId]};
+        if (!statistics.name.load(std::memory_order_relaxed)) [[unlikely]]
+            statistics.name.store(name, std::memory_order_release);
+        statistics.Record(endNs - startNs);
+
+        if (TRACE_EVENT_CATEGORY_ENABLED("kernel")) [[unlikely]]
+            EmitTraceCounters(endNs);
+    }
+
+    void CallProfiler::RecordServiceCommand(size_t threadId, const char *name, u64 startNs, u64 endNs) {
+        if (auto statistics{GetThreadProfile(threadId).GetServiceCommand(name)}) [[likely]]
+            statistics->Record(endNs - startNs);
+    }
+
+    std::string CallProfiler::Dump() {
+        auto percentile{[](const std::array<u64, HistogramBucketCount> &histogram, u64 count, double fraction) -> u64 {
+            u64 target{static_cast<u64>(static_cast<double>(count) * fraction)}, seen{};
+            for (size_t bucket{}; bucket < HistogramBucketCount; bucket++) {
+                seen += histogram[bucket];
+                if (seen > target)
+                    return 2ULL << bucket; // The upper bound of the bucket
+            }
+            return 2ULL << (HistogramBucketCount - 1);
+        }};
+
+        struct Entry {
+            const char *name;
+            u64 count;
+            u64 totalNs;
+            std::array<u64, HistogramBucketCount> histogram;
+        };
+
+        auto dumpStatistics{[&](std::string &output, std::vector<Entry> &entries) {
+            std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) { return lhs.totalNs > rhs.totalNs; });
+            for (const auto &entry : entries)
+                output += fmt::format("  {}: {} calls, {:.3f}ms total, {}ns average, p50 < {}ns, p99 < {}ns\n", entry.name, entry.count, static_cast<double>(entry.totalNs) / constant::NsInMillisecond, entry.count ? entry.totalNs / entry.count : 0, percentile(entry.histogram, entry.count, 0.5), percentile(entry.histogram, entry.count, 0.99));
+        }};
+
+        auto readStatistics{[](const CallStatistics &statistics) -> std::optional<Entry> {
+            auto name{statistics.name.load(std::memory_order_acquire)};
+            if (!name)
+                return std::nullopt;
+
+            Entry entry{name, statistics.count.load(std::memory_order_relaxed), statistics.totalNs.load(std::memory_order_relaxed)};
+            for (size_t bucket{}; bucket < HistogramBucketCount; bucket++)
+                entry.histogram[bucket] = statistics.histogram[bucket].load(std::memory_order_relaxed);
+            return entry;
+        }};
+
+        std::string output;
+        std::vector<Entry> entries;
+        for (auto profile{profiles.load(std::memory_order_acquire)}; profile; profile = profile->next) {
+            entries.clear();
+            for (const auto &svc : profile->svcs)
+                if (auto entry{readStatistics(svc)})
+                    entries.push_back(*entry);
+            for (const auto &command : profile->serviceCommands)
+                if (auto entry{readStatistics(command)})
+                    entries.push_back(*entry);
+
+            if (entries.empty())
+                continue;
+
+            output += fmt::format("Thread #{}:\n", profile->threadId);
+            dumpStatistics(output, entries);
+        }
+        return output;
+    }
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <atomic>
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief Records the call count and latency distribution of every SVC and service command issued by each guest thread
+     * @note Statistics are written only by the thread they belong to so recording doesn't need any locks or atomic RMW operations, readers may observe slightly torn statistics which is acceptable for profiling
+     */
+    class CallProfiler {
+      public:
+        static constexpr size_t HistogramBucketCount{24}; //!< The amount of power-of-two latency buckets, bucket N holds calls taking [2^N, 2^(N+1)) ns while the last bucket holds any calls longer than that
+
+        /**
+         * @brief The statistics for a single SVC or service command on a single thread
+         */
+        struct CallStatistics {
+            std::atomic<const char *> name{}; //!< A static string with the name of the call, this is null till the call has been recorded once
+            std::atomic<u64> count{};
+            std::atomic<u64> totalNs{};
+            std::array<std::atomic<u32>, HistogramBucketCount> histogram{};
+
+            /**
+             * @note This must only be called by the thread owning the statistics
+             */
+            void Record(u64 durationNs);
+        };
+
+        /**
+         * @brief All statistics for a single guest thread, these are never freed so they remain available after the thread exits
+         */
+        struct ThreadProfile {
+            static constexpr size_t SvcCount{0x80};
+            static constexpr size_t ServiceCommandCapacity{0x100}; //!< The capacity of the open-addressed table of service commands, this must be a power of two and commands past it are dropped
+
+            size_t threadId; //!< The ID of the guest thread in its process
+            ThreadProfile *next{}; //!< The next profile in the list of all profiles
+            std::array<CallStatistics, SvcCount> svcs{};
+            std::array<CallStatistics, ServiceCommandCapacity> serviceCommands{};
+
+            ThreadProfile(size_t threadId);
+
+            /**
+             * @return The statistics for the service command with the supplied name or nullptr if the table is full
+             * @note This must only be called by the thread owning the profile
+             */
+            CallStatistics *GetServiceCommand(const char *name);
+        };
+
+      private:
+        static inline std::atomic<ThreadProfile *> profiles{}; //!< An intrusive lock-free list of all profiles, entries are only ever prepended
+        static inline thread_local ThreadProfile *threadProfile{};
+        static inline std::atomic<u64> lastCounterTimestamp{}; //!< The timestamp in ns at which trace counters were last emitted
+
+        static ThreadProfile &GetThreadProfile(size_t threadId);
+
+        /**
+         * @brief Emits the aggregated statistics as perfetto counters if tracing is enabled and enough time has passed since they were last emitted
+         */
+        static void EmitTraceCounters(u64 timestamp);
+
+      public:
+        /**
+         * @brief Records an SVC made by the supplied guest thread which took the supplied duration
+         */
+        static void RecordSvc(size_t threadId, u16 svcId, const char *name, u64 startNs, u64 endNs);
+
+        /**
+         * @brief Records a service command made by the supplied guest thread which took the supplied duration
+         */
+        static void RecordServiceCommand(size_t threadId, const char *name, u64 startNs, u64 endNs);
+
+        /**
+         * @return A human-readable report of the statistics of all threads, calls are sorted by the total time spent in them
+         */
+        static std::string Dump();
+    };
+}
@@ -77,6 +77,24 @@ namespace skyline {
             }
         }
 
+        /**
+         * @return If there are no items in the queue, this includes items that are still being processed by Process
+         */
+        bool Empty() {
+            return start == end;
+        }
+
+        /**
+         * @return The amount of items in the queue, this includes items that are still being processed by Process
+         * @note This is only a snapshot as items may be concurrently pushed or consumed
+         */
+        size_t Size() const {
+            size_t capacity{vector.size() / sizeof(Type)};
+            auto queueBegin{reinterpret_cast<const Type *>(vector.data())};
+            auto startIndex{static_cast<size_t>(start.load(std::memory_order_relaxed) - queueBegin)}, endIndex{static_cast<size_t>(end.load(std::memory_order_relaxed) - queueBegin)};
+            return (endIndex + capacity - startIndex) % capacity;
+        }
+
         Type Pop() {
             {
                 std::unique_lock productionLock{productionMutex};
@@ -120,11 +138,48 @@ namespace skyline {
         }
 
         /**
-         * @note The appended elements may not necessarily be directly contiguous as another thread could push elements in between those in the span
+         * @brief Appends all items in the buffer to the queue with a single lock acquisition and wakeup, this only blocks if the queue doesn't have enough free space for all of them
+         * @note The appended elements may not necessarily be directly contiguous if the queue fills up as another thread could push elements in between those in the span
          */
-        void Append(span<Type> buffer) {
-            for (const auto &item : buffer)
-                Push(item);
+        void Append(span<const Type> buffer) {
+            auto queueBegin{reinterpret_cast<Type *>(vector.begin().base())};
+            size_t capacity{vector.size() / sizeof(Type)};
+
+            while (true) {
+                Type *waitNext{};
+                {
+                    std::scoped_lock lock{productionMutex};
+                    size_t startIndex{static_cast<size_t>(start - queueBegin)};
+                    size_t endIndex{static_cast<size_t>(end - queueBegin)};
+
+                    // Copy as many items as there's space for, this is split into two contiguous copies when wrapping around
+                    bool produced{};
+                    while (!buffer.empty()) {
+                        size_t writeIndex{(endIndex + 1) % capacity};
+                        if (writeIndex == startIndex)
+                            break;
+
+                        size_t count{std::min(buffer.size(), (writeIndex < startIndex ? startIndex : capacity) - writeIndex)};
+                        std::copy_n(buffer.begin(), count, queueBegin + writeIndex);
+                        buffer = buffer.subspan(count);
+
+                        endIndex = writeIndex + count - 1;
+                        end = queueBegin + endIndex;
+                        produced = true;
+                    }
+
+                    if (produced)
+                        produceCondition.notify_one();
+
+                    if (buffer.empty())
+                        return;
+
+                    waitNext = queueBegin + startIndex;
+                }
+
+                std::unique_lock consumeLock{consumptionMutex};
+                consumeCondition.wait(consumeLock, [=]() { return waitNext != start; });
+            }
         }
 
         /**
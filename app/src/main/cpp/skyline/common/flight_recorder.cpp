@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <filesystem>
+#include <fstream>
+#include <common/settings.h>
+#include <os.h>
+#include "flight_recorder.h"
+
+namespace skyline {
+    FlightRecorder::FlightRecorder(std::string directory, u64 thresholdNs) : directory{std::move(directory)}, thresholdNs{thresholdNs} {
+        StartSession();
+    }
+
+    std::unique_ptr<FlightRecorder> FlightRecorder::Create(const DeviceState &state) {
+        u32 thresholdMs{*state.settings->flightRecorderThreshold};
+        if (!thresholdMs)
+            return nullptr;
+
+        std::string directory{state.os->publicAppFilesPath + "flight_recorder/"};
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            Logger::Warn("Failed to create the flight recorder directory '{}': {}", directory, error.message());
+            return nullptr;
+        }
+
+        return std::unique_ptr<FlightRecorder>{new FlightRecorder(std::move(directory), static_cast<u64>(thresholdMs) * constant::NsInMillisecond)};
+    }
+
+    FlightRecorder::~FlightRecorder() {
+        if (captureThread.joinable())
+            captureThread.join();
+        if (session)
+            session->StopBlocking();
+    }
+
+    void FlightRecorder::StartSession() {
+        perfetto::TraceConfig config;
+        auto buffer{config.add_buffers()};
+        buffer->set_size_kb(BufferSizeKb);
+        buffer->set_fill_policy(perfetto::TraceConfig::BufferConfig::RING_BUFFER); // The oldest events are overwritten, so the buffer always holds the events leading up to a spike
+
+        perfetto::protos::gen::TrackEventConfig trackEventConfig;
+        trackEventConfig.add_enabled_categories("*");
+        auto dataSource{config.add_data_sources()->mutable_config()};
+        dataSource->set_name("track_event");
+        dataSource->set_track_event_config_raw(trackEventConfig.SerializeAsString());
+
+        session = perfetto::Tracing::NewTrace(perfetto::kInProcessBackend);
+        session->Setup(config);
+        session->StartBlocking();
+        sessionStart = static_cast<u64>(util::GetTimeNs());
+    }
+
+    void FlightRecorder::Capture(u64 frametimeNs) {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-FlightRec")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        session->FlushBlocking();
+        session->StopBlocking();
+        std::vector<char> trace{session->ReadTraceBlocking()};
+        session.reset();
+
+        auto path{fmt::format("{}{}_{}ms.perfetto-trace", directory, std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count(), frametimeNs / constant::NsInMillisecond)};
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        if (file.write(trace.data(), static_cast<std::streamsize>(trace.size())))
+            Logger::Info("Captured a {}ms frame to '{}' ({} KiB)", frametimeNs / constant::NsInMillisecond, path, trace.size() / 1024);
+        else
+            Logger::Warn("Failed to write the flight recorder capture to '{}'", path);
+        file.close();
+
+        StartSession();
+        lastCaptureEnd = static_cast<u64>(util::GetTimeNs());
+        capturing.store(false, std::memory_order_release);
+    }
+
+    void FlightRecorder::OnFrame(u64 timestamp, u64 frametimeNs) {
+        if (frametimeNs < thresholdNs || capturing.load(std::memory_order_acquire))
+            return;
+
+        // The session timestamps are only written by the capture thread prior to it clearing the capturing flag, so they're safe to read here
+        if (timestamp < sessionStart + WarmupDuration || (lastCaptureEnd && timestamp < lastCaptureEnd + CaptureCooldown))
+            return;
+
+        if (captureThread.joinable())
+            captureThread.join();
+
+        capturing.store(true, std::memory_order_relaxed);
+        captureThread = std::thread{&FlightRecorder::Capture, this, frametimeNs};
+    }
+}
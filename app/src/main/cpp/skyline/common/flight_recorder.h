@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common/trace.h>
+
+namespace skyline {
+    /**
+     * @brief Continuously records all trace events into an in-memory ring buffer and writes it out to a file when a frame takes longer than a threshold, this captures the events leading up to rare stutters without having to trace an entire session
+     * @details The ring buffer is an in-process perfetto session, on a spike it's stopped and read out on a separate thread after which a new session is started, events during that window aren't recorded
+     * @note The in-process perfetto backend must have been initialized for this to be used, this is done at startup when the threshold is non-zero
+     */
+    class FlightRecorder {
+      private:
+        static constexpr u32 BufferSizeKb{32 * 1024}; //!< The size of the ring buffer, this corresponds to a few seconds of events in practice
+        static constexpr u64 CaptureCooldown{10 * constant::NsInSecond}; //!< The minimum duration between the end of a capture and the next one in nanoseconds, this avoids filling storage during sustained stutters such as loading screens
+        static constexpr u64 WarmupDuration{constant::NsInSecond}; //!< The duration after a session starts during which spikes are ignored as the buffer doesn't hold enough context yet
+
+        std::string directory; //!< The directory that captures are written to
+        u64 thresholdNs; //!< The frametime above which a capture is triggered in nanoseconds
+        std::unique_ptr<perfetto::TracingSession> session;
+        u64 sessionStart{}; //!< The timestamp at which the current session started
+        u64 lastCaptureEnd{}; //!< The timestamp at which the last capture was finished
+        std::atomic<bool> capturing{}; //!< If a capture is being written out by the capture thread, the session must not be touched by the presentation thread while this is set
+        std::thread captureThread;
+
+        FlightRecorder(std::string directory, u64 thresholdNs);
+
+        void StartSession();
+
+        /**
+         * @brief Stops the current session, writes its contents to a file and starts a new one
+         * @param frametimeNs The frametime of the frame which triggered the capture, it's used for the name of the file
+         */
+        void Capture(u64 frametimeNs);
+
+      public:
+        /**
+         * @return A flight recorder for the threshold in the settings or nullptr if it's disabled
+         */
+        static std::unique_ptr<FlightRecorder> Create(const DeviceState &state);
+
+        ~FlightRecorder();
+
+        /**
+         * @brief Triggers a capture if the supplied frame was a spike and no capture is in progress
+         * @note This must only be called from a single thread
+         */
+        void OnFrame(u64 timestamp, u64 frametimeNs);
+    };
+}
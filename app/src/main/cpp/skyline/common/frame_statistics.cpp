@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "frame_statistics.h"
+
+namespace skyline {
+    FrameStatistics::FrameRecord FrameStatistics::EndFrame(u64 timestamp) {
+        FrameRecord record{
+            .timestamp = timestamp,
+            .frametimeNs = lastFrameTimestamp ? timestamp - lastFrameTimestamp : 0,
+            .shaderCompiles = shaderCompileAccumulator.exchange(0, std::memory_order_relaxed),
+        };
+        for (size_t phase{}; phase < PhaseCount; phase++)
+            record.phaseNs[phase] = phaseAccumulators[phase].exchange(0, std::memory_order_relaxed);
+        lastFrameTimestamp = timestamp;
+
+        history.Write(span<const FrameRecord>{&record, 1});
+        return record;
+    }
+
+    size_t FrameStatistics::ReadFrames(span<FrameRecord> output) {
+        return history.Read(output.size(), [&](span<const FrameRecord> frames, size_t offset) {
+            std::copy(frames.begin(), frames.end(), output.begin() + static_cast<ssize_t>(offset));
+        });
+    }
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <atomic>
+#include <common.h>
+#include "spsc_ring_buffer.h"
+
+namespace skyline {
+    /**
+     * @brief Breaks down the host time spent on every presented frame by the subsystem it was spent in, this allows bottlenecks to be diagnosed on-device from an overlay
+     * @note Phases are accumulated from any thread with relaxed atomics and attributed to the next frame that's presented, so work which overlaps the presentation of a frame may be attributed to either side of it
+     */
+    class FrameStatistics {
+      public:
+        enum class Phase : u8 {
+            GuestCpu, //!< Time guest threads spent executing guest code between SVCs, this is summed across all guest threads
+            GpfifoDecode, //!< Time spent processing GPFIFO pushbuffers, this includes emulating the methods in them
+            CommandRecording, //!< Time spent recording command nodes into Vulkan command buffers
+            GpuExecution, //!< Time the GPU was busy with executions, this is approximated from when an execution was queued or the prior one completed till its fence was signalled
+            PresentWait, //!< Time the presentation thread spent waiting on frames to finish rendering and swapchain images to become available
+        };
+        static constexpr size_t PhaseCount{5};
+
+        struct FrameRecord {
+            u64 timestamp; //!< The time at which the frame was presented in nanoseconds
+            u64 frametimeNs; //!< The time between the presentation of the prior frame and this one
+            std::array<u64, PhaseCount> phaseNs; //!< The time spent in every phase during the frame
+            u32 shaderCompiles; //!< The amount of shaders that were compiled during the frame
+        };
+
+        static constexpr size_t HistorySize{256}; //!< The amount of frames held in the history, frames are dropped if it isn't read quickly enough
+
+        /**
+         * @brief Records the duration of a phase between its construction and destruction
+         */
+        struct ScopedPhase {
+            Phase phase;
+            u64 start;
+
+            ScopedPhase(Phase phase) : phase{phase}, start{static_cast<u64>(util::GetTimeNs())} {}
+
+            ~ScopedPhase() {
+                Record(phase, static_cast<u64>(util::GetTimeNs()) - start);
+            }
+        };
+
+      private:
+        static inline std::array<std::atomic<u64>, PhaseCount> phaseAccumulators{}; //!< The time spent in every phase since the last frame
+        static inline std::atomic<u32> shaderCompileAccumulator{}; //!< The amount of shaders compiled since the last frame
+        static inline u64 lastFrameTimestamp{}; //!< The timestamp of the last frame, this is only accessed by the presentation thread
+        static inline SpscRingBuffer<FrameRecord, HistorySize> history; //!< Frames which haven't been read yet, the presentation thread is the producer and the frontend is the consumer
+
+      public:
+        static void Record(Phase phase, u64 durationNs) {
+            phaseAccumulators[static_cast<size_t>(phase)].fetch_add(durationNs, std::memory_order_relaxed);
+        }
+
+        static void RecordShaderCompile() {
+            shaderCompileAccumulator.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Finishes the current frame with everything accumulated since the last one and appends it to the history
+         * @return The record of the finished frame
+         * @note This must only be called by the presentation thread
+         */
+        static FrameRecord EndFrame(u64 timestamp);
+
+        /**
+         * @brief Consumes the oldest frames in the history
+         * @return The amount of frames that were written to the output
+         * @note This must only be called by a single consumer at a time
+         */
+        static size_t ReadFrames(span<FrameRecord> output);
+    };
+}
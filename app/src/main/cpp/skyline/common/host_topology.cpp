@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include <thread>
+#include <range/v3/algorithm.hpp>
+#include "host_topology.h"
+
+namespace skyline::host {
+    /**
+     * @return The maximum frequency of the supplied host core in kHz or 0 if it couldn't be determined
+     */
+    static u32 GetCoreMaxFrequency(u32 core) {
+        std::ifstream stream{fmt::format("/sys/devices/system/cpu/cpu{}/cpufreq/cpuinfo_max_freq", core)};
+        u32 frequency{};
+        if (!(stream >> frequency))
+            return 0;
+        return frequency;
+    }
+
+    Topology::Topology() : coreCount{std::max(std::thread::hardware_concurrency(), 1U)} {
+        std::vector<u32> frequencies(coreCount);
+        for (u32 core{}; core < coreCount; core++)
+            frequencies[core] = GetCoreMaxFrequency(core);
+
+        auto [minFrequency, maxFrequency]{ranges::minmax(frequencies)};
+        heterogeneous = coreCount >= 2 && minFrequency != 0 && minFrequency != maxFrequency;
+
+        for (size_t index{}; index < AffinityClassCount; index++) {
+            auto affinityClass{static_cast<AffinityClass>(index)};
+            auto &cores{classCores[index]};
+            CPU_ZERO(&cores);
+
+            u32 count{};
+            for (u32 core{}; core < coreCount; core++) {
+                u32 frequency{frequencies[core]};
+                bool inClass{[&]() {
+                    if (!heterogeneous)
+                        return true;
+
+                    switch (affinityClass) {
+                        case AffinityClass::Prime:
+                            return frequency == maxFrequency;
+                        case AffinityClass::Performance:
+                            return frequency != minFrequency;
+                        case AffinityClass::Background:
+                            return frequency != maxFrequency;
+                        case AffinityClass::Efficiency:
+                            return frequency == minFrequency;
+                        default:
+                            return true;
+                    }
+                }()};
+
+                if (inClass) {
+                    CPU_SET(core, &cores);
+                    count++;
+                }
+            }
+            classCoreCounts[index] = count;
+        }
+
+        if (heterogeneous)
+            Logger::Info("Host CPU topology: {} prime, {} performance, {} efficiency cores out of {}", GetCoreCount(AffinityClass::Prime), GetCoreCount(AffinityClass::Performance), GetCoreCount(AffinityClass::Efficiency), coreCount);
+    }
+
+    const Topology &Topology::Get() {
+        static Topology topology;
+        return topology;
+    }
+
+    void Topology::SetThreadAffinity(AffinityClass affinityClass) const {
+        if (!heterogeneous)
+            return;
+
+        if (sched_setaffinity(0, sizeof(cpu_set_t), &GetCores(affinityClass)))
+            Logger::Warn("Failed to set the thread affinity to {} cores: {}", GetCoreCount(affinityClass), strerror(errno));
+    }
+}
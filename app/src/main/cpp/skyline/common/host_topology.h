@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <sched.h>
+#include <common.h>
+
+namespace skyline {
+    namespace host {
+        /**
+         * @brief A class of host cores that a thread can be restricted to, these are derived from clustering host cores by their maximum frequency
+         * @note All classes correspond to all cores on homogeneous CPUs or when the topology couldn't be determined
+         */
+        enum class AffinityClass : u8 {
+            Any = 0, //!< All host cores
+            Prime = 1, //!< The cores of the fastest cluster
+            Performance = 2, //!< The cores of all clusters aside from the slowest one, this is the same as Prime on CPUs with two clusters
+            Background = 3, //!< The cores of all clusters aside from the fastest one
+            Efficiency = 4, //!< The cores of the slowest cluster
+        };
+
+        /**
+         * @brief The topology of the host CPU in terms of its clusters of cores, this is used for mapping threads onto appropriate cores on heterogeneous (big.LITTLE) CPUs
+         */
+        class Topology {
+          private:
+            static constexpr size_t AffinityClassCount{static_cast<size_t>(AffinityClass::Efficiency) + 1};
+
+            u32 coreCount;
+            bool heterogeneous{}; //!< If the host has more than a single cluster of cores with distinct frequencies
+            std::array<cpu_set_t, AffinityClassCount> classCores; //!< The set of cores for every affinity class
+            std::array<u32, AffinityClassCount> classCoreCounts;
+
+            Topology();
+
+          public:
+            /**
+             * @return The topology of the host CPU, this is determined on the first call
+             */
+            static const Topology &Get();
+
+            bool IsHeterogeneous() const {
+                return heterogeneous;
+            }
+
+            const cpu_set_t &GetCores(AffinityClass affinityClass) const {
+                return classCores[static_cast<size_t>(affinityClass)];
+            }
+
+            /**
+             * @return The amount of host cores in the supplied affinity class
+             */
+            u32 GetCoreCount(AffinityClass affinityClass) const {
+                return classCoreCounts[static_cast<size_t>(affinityClass)];
+            }
+
+            /**
+             * @brief Restricts the calling thread to running on the cores of the supplied affinity class
+             * @note This is a no-op on homogeneous CPUs as every class covers all cores
+             */
+            void SetThreadAffinity(AffinityClass affinityClass) const;
+        };
+    }
+}
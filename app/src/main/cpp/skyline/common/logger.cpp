@@ -2,32 +2,143 @@
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <android/log.h>
+#include "spsc_ring_buffer.h"
 #include "utils.h"
 #include "logger.h"
 
 namespace skyline {
+    namespace {
+        /**
+         * @brief The header of a single message in the ring of a thread, it's immediately followed by the message itself
+         */
+        struct RecordHeader {
+            Logger::LogLevel level;
+            u32 length; //!< The length of the message in bytes
+            u64 timestamp; //!< The time the message was written at in nanoseconds
+            Logger::LoggerContext *context; //!< The context of the writing thread at the time of writing
+            std::array<char, 16> threadName;
+        };
+
+        constexpr size_t ThreadRingSize{0x10000}; //!< The size of the message ring of every thread (64 KiB)
+        constexpr std::chrono::milliseconds LoggerInterval{10}; //!< The interval at which the logger thread writes out queued messages when it isn't woken up explicitly
+
+        struct ThreadRing {
+            SpscRingBuffer<u8, ThreadRingSize> ring;
+            std::vector<u8> record; //!< A buffer for assembling records prior to them being written to the ring, this is only used by the producer
+        };
+
+        struct LoggerState {
+            std::mutex registryMutex;
+            std::vector<std::shared_ptr<ThreadRing>> rings; //!< The rings of all threads which have logged, a ring is only held here after its thread exits till it's been drained
+            std::mutex drainMutex; //!< Serializes the consumers of all rings
+            std::mutex wakeMutex;
+            std::condition_variable wakeCondition; //!< Signalled to have the logger thread write out queued messages immediately
+            std::once_flag threadFlag;
+        };
+
+        /**
+         * @note The state is intentionally leaked as threads may still log during static destruction
+         */
+        LoggerState &GetState() {
+            static auto *state{new LoggerState()};
+            return *state;
+        }
+
+        void WriteAndroid(Logger::LogLevel level, const char *threadName, const std::string &str) {
+            constexpr std::array<int, 5> levelAlog{ANDROID_LOG_ERROR, ANDROID_LOG_WARN, ANDROID_LOG_INFO, ANDROID_LOG_DEBUG, ANDROID_LOG_VERBOSE}; // This corresponds to LogLevel and provides its equivalent for NDK Logging
+            __android_log_write(levelAlog[static_cast<u8>(level)], (std::string("emu-cpp-") + threadName).c_str(), str.c_str());
+        }
+
+        /**
+         * @brief Writes out all queued messages from every ring in the order they were written in
+         * @note The drain mutex must be locked by the caller
+         */
+        void DrainRings(LoggerState &state) {
+            std::vector<std::shared_ptr<ThreadRing>> rings;
+            {
+                std::scoped_lock lock{state.registryMutex};
+                std::erase_if(state.rings, [](const std::shared_ptr<ThreadRing> &ring) { return ring.use_count() == 1 && ring->ring.Size() == 0; });
+                rings = state.rings;
+            }
+
+            struct Message {
+                RecordHeader header;
+                std::string text;
+            };
+            std::vector<Message> messages;
+            std::vector<u8> records;
+            for (auto &ring : rings) {
+                // Records are only ever written to a ring in their entirety, so everything that's visible consists of complete records
+                records.resize(ring->ring.Size());
+                ring->ring.Read(records.size(), [&](span<const u8> data, size_t offset) {
+                    std::memcpy(records.data() + offset, data.data(), data.size());
+                });
+
+                for (size_t offset{}; offset + sizeof(RecordHeader) <= records.size();) {
+                    auto &message{messages.emplace_back()};
+                    std::memcpy(&message.header, records.data() + offset, sizeof(RecordHeader));
+                    offset += sizeof(RecordHeader);
+                    message.text.assign(reinterpret_cast<const char *>(records.data() + offset), message.header.length);
+                    offset += message.header.length;
+                }
+            }
+
+            // Messages from different threads are interleaved by when they were written rather than by which ring they were in
+            std::stable_sort(messages.begin(), messages.end(), [](const Message &a, const Message &b) { return a.header.timestamp < b.header.timestamp; });
+
+            constexpr std::array<char, 5> levelCharacter{'E', 'W', 'I', 'D', 'V'}; // The LogLevel as written out to a file
+            for (const auto &message : messages) {
+                const char *threadName{message.header.threadName.data()};
+                WriteAndroid(message.header.level, threadName, message.text);
+
+                if (auto context{message.header.context})
+                    // We use RS (\036) and GS (\035) as our delimiters
+                    context->Write(fmt::format("\036{}\035{}\035{}\035{}\n", levelCharacter[static_cast<u8>(message.header.level)], (message.header.timestamp / constant::NsInMillisecond) - context->start, threadName, message.text));
+            }
+        }
+
+        void LoggerThread() {
+            if (int result{pthread_setname_np(pthread_self(), "Sky-Logger")})
+                __android_log_print(ANDROID_LOG_WARN, "emu-cpp-Sky-Logger", "Failed to set the thread name: %s", strerror(result));
+
+            auto &state{GetState()};
+            while (true) {
+                {
+                    std::unique_lock lock{state.wakeMutex};
+                    state.wakeCondition.wait_for(lock, LoggerInterval);
+                }
+
+                std::scoped_lock lock{state.drainMutex};
+                DrainRings(state);
+            }
+        }
+    }
+
     void Logger::LoggerContext::Initialize(const std::string &path) {
         start = util::GetTimeNs() / constant::NsInMillisecond;
         logFile.open(path, std::ios::trunc);
     }
 
     void Logger::LoggerContext::Finalize() {
+        Drain();
         std::scoped_lock lock{mutex};
         logFile.close();
     }
 
     void Logger::LoggerContext::TryFlush() {
+        Drain(false);
         std::unique_lock lock(mutex, std::try_to_lock);
         if (lock)
             logFile.flush();
     }
 
     void Logger::LoggerContext::Flush() {
+        Drain();
         std::scoped_lock lock{mutex};
         logFile.flush();
     }
 
-    thread_local static std::string logTag, threadName;
+    thread_local static std::string threadName;
     thread_local static Logger::LoggerContext *context{&Logger::EmulationContext};
 
     void Logger::UpdateTag() {
@@ -36,7 +147,6 @@ namespace skyline {
             threadName = name.data();
         else
             threadName = "unk";
-        logTag = std::string("emu-cpp-") + threadName;
     }
 
     Logger::LoggerContext *Logger::GetContext() {
@@ -47,21 +157,54 @@ namespace skyline {
         context = pContext;
     }
 
-    void Logger::WriteAndroid(LogLevel level, const std::string &str) {
-        constexpr std::array<int, 5> levelAlog{ANDROID_LOG_ERROR, ANDROID_LOG_WARN, ANDROID_LOG_INFO, ANDROID_LOG_DEBUG, ANDROID_LOG_VERBOSE}; // This corresponds to LogLevel and provides its equivalent for NDK Logging
-        if (logTag.empty())
-            UpdateTag();
+    bool Logger::Drain(bool block) {
+        auto &state{GetState()};
+        std::unique_lock lock{state.drainMutex, std::defer_lock};
+        if (block)
+            lock.lock();
+        else if (!lock.try_lock())
+            return false;
 
-        __android_log_write(levelAlog[static_cast<u8>(level)], logTag.c_str(), str.c_str());
+        DrainRings(state);
+        return true;
     }
 
     void Logger::Write(LogLevel level, const std::string &str) {
-        constexpr std::array<char, 5> levelCharacter{'E', 'W', 'I', 'D', 'V'}; // The LogLevel as written out to a file
-        WriteAndroid(level, str);
+        auto &state{GetState()};
+        std::call_once(state.threadFlag, [] { std::thread(LoggerThread).detach(); });
+
+        thread_local std::shared_ptr<ThreadRing> threadRing{[&state] {
+            auto ring{std::make_shared<ThreadRing>()};
+            std::scoped_lock lock{state.registryMutex};
+            state.rings.push_back(ring);
+            return ring;
+        }()};
+
+        if (threadName.empty())
+            UpdateTag();
+
+        RecordHeader header{
+            .level = level,
+            .length = static_cast<u32>(std::min(str.size(), ThreadRingSize - sizeof(RecordHeader))),
+            .timestamp = static_cast<u64>(util::GetTimeNs()),
+            .context = context,
+        };
+        std::strncpy(header.threadName.data(), threadName.c_str(), header.threadName.size() - 1);
+
+        auto &record{threadRing->record};
+        record.resize(sizeof(RecordHeader) + header.length);
+        std::memcpy(record.data(), &header, sizeof(RecordHeader));
+        std::memcpy(record.data() + sizeof(RecordHeader), str.data(), header.length);
+
+        // The record must be written to the ring in a single write so the logger thread never observes a partial record, if there's no space then we wait for it to be drained
+        while (ThreadRingSize - threadRing->ring.Size() < record.size()) {
+            state.wakeCondition.notify_one();
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        threadRing->ring.Write(record);
 
-        if (context)
-            // We use RS (\036) and GS (\035) as our delimiters
-            context->Write(fmt::format("\036{}\035{}\035{}\035{}\n", levelCharacter[static_cast<u8>(level)], (util::GetTimeNs() / constant::NsInMillisecond) - context->start, threadName, str));
+        if (level == LogLevel::Error)
+            state.wakeCondition.notify_one(); // Errors are commonly followed by a crash, so they're written out immediately
     }
 
     void Logger::LoggerContext::Write(const std::string &str) {
@@ -10,6 +10,7 @@
 namespace skyline {
     /**
      * @brief A wrapper around writing logs into a log file and logcat using Android Log APIs
+     * @note Messages are queued into a lock-free ring per thread and written out to logcat and the log file by a dedicated thread, so logging never blocks on I/O or contends on a lock
      */
     class Logger {
       private:
@@ -38,8 +39,14 @@ namespace skyline {
 
             void Initialize(const std::string &path);
 
+            /**
+             * @note All queued messages are written out prior to the log file being closed
+             */
             void Finalize();
 
+            /**
+             * @brief Writes out all queued messages and flushes the log file if neither is currently in use by another thread, this is used in situations where blocking could deadlock such as prior to a crash
+             */
             void TryFlush();
 
             void Flush();
@@ -57,8 +64,16 @@ namespace skyline {
 
         static void SetContext(LoggerContext *context);
 
-        static void WriteAndroid(LogLevel level, const std::string &str);
+        /**
+         * @brief Writes out all queued messages from every thread on the calling thread
+         * @param block If this should wait for the logger thread when it's already writing out messages, otherwise this returns immediately if so
+         * @return If the messages were written out
+         */
+        static bool Drain(bool block = true);
 
+        /**
+         * @brief Queues a message to be written out asynchronously, this only blocks if the ring of the calling thread is full
+         */
         static void Write(LogLevel level, const std::string &str);
 
         /**
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <gpu.h>
+#include <audio.h>
+#include <loader/loader.h>
+#include <vfs/cached_backing.h>
+#include <kernel/types/KProcess.h>
+#include "trace.h"
+#include "memory_report.h"
+
+namespace skyline {
+    namespace {
+        constexpr std::array<const char *, MemoryReport::CategoryCount> CategoryNames{
+            "Guest User",
+            "Guest System Resource",
+            "Vulkan Textures",
+            "Vulkan Buffers",
+            "Vulkan MegaBuffers",
+            "Vulkan Staging",
+            "Vulkan Staging (Idle)",
+            "Vulkan Miscellaneous",
+            "Pipeline Cache Mapping",
+            "RomFS Cache",
+            "Audio",
+        };
+
+        /**
+         * @return The RomFS cache of the loaded title or nullptr if the RomFS isn't cached
+         */
+        std::shared_ptr<vfs::CachedBacking> GetRomFsCache(const DeviceState &state) {
+            return state.loader ? std::dynamic_pointer_cast<vfs::CachedBacking>(state.loader->romFs) : nullptr;
+        }
+    }
+
+    MemoryReport MemoryReport::Collect(const DeviceState &state) {
+        MemoryReport report{};
+        auto set{[&report](Category category, u64 value) {
+            report.bytes[static_cast<size_t>(category)] = value;
+        }};
+
+        if (auto process{state.process}; process && process->mainThreadStack) {
+            set(Category::GuestUser, process->memory.GetUserMemoryUsage());
+            set(Category::GuestSystemResource, process->memory.GetSystemResourceUsage());
+        }
+
+        if (auto gpu{state.gpu}) {
+            using gpu::memory::AllocationCategory;
+            set(Category::VulkanTexture, gpu->memory.GetCategoryUsage(AllocationCategory::Texture));
+            set(Category::VulkanBuffer, gpu->memory.GetCategoryUsage(AllocationCategory::Buffer));
+            set(Category::VulkanMegaBuffer, gpu->memory.GetCategoryUsage(AllocationCategory::MegaBuffer));
+            set(Category::VulkanStaging, gpu->memory.GetCategoryUsage(AllocationCategory::Staging));
+            set(Category::VulkanStagingIdle, gpu->memory.GetIdleStagingSize());
+            set(Category::VulkanMiscellaneous, gpu->memory.GetCategoryUsage(AllocationCategory::Miscellaneous));
+            if (gpu->graphicsPipelineCacheManager)
+                set(Category::PipelineCacheMapping, gpu->graphicsPipelineCacheManager->GetMappedSize());
+        }
+
+        if (auto romFsCache{GetRomFsCache(state)})
+            set(Category::RomFsCache, romFsCache->GetCachedSize());
+
+        if (auto audio{state.audio})
+            set(Category::Audio, audio->GetMemoryUsage());
+
+        return report;
+    }
+
+    void MemoryReport::TraceCounters(const DeviceState &state) {
+        if (!TRACE_EVENT_CATEGORY_ENABLED("memory"))
+            return;
+
+        auto report{Collect(state)};
+        for (size_t index{}; index < CategoryCount; index++)
+            TRACE_COUNTER("memory", perfetto::CounterTrack{CategoryNames[index], "bytes"}, report.bytes[index]);
+    }
+
+    void MemoryReport::Trim(const DeviceState &state) {
+        if (auto gpu{state.gpu})
+            gpu->memory.TrimStagingPool();
+
+        if (auto romFsCache{GetRomFsCache(state)})
+            romFsCache->Trim();
+
+        if (auto audio{state.audio})
+            audio->adpcmCache.Clear();
+    }
+
+    std::string MemoryReport::Format() const {
+        std::string report;
+        for (size_t index{}; index < CategoryCount; index++)
+            report += util::Format("{}: {:.1f} MiB\n", CategoryNames[index], static_cast<double>(bytes[index]) / (1024 * 1024));
+        return report;
+    }
+}
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief A snapshot of the native memory usage of every major subsystem, this is used to attribute memory pressure to the subsystem responsible for it
+     */
+    struct MemoryReport {
+        enum class Category : u8 {
+            GuestUser, //!< Guest heap, code and main thread stack memory
+            GuestSystemResource, //!< Kernel objects accounted to the guest's system resource
+            VulkanTexture, //!< VMA allocations backing textures
+            VulkanBuffer, //!< VMA allocations backing guest buffers
+            VulkanMegaBuffer, //!< VMA allocations backing megabuffer chunks
+            VulkanStaging, //!< VMA allocations backing staging buffers, this includes idle ones
+            VulkanStagingIdle, //!< Idle staging buffers held in the staging pool, these can be trimmed
+            VulkanMiscellaneous, //!< Any other VMA allocations
+            PipelineCacheMapping, //!< The file-backed mapping of the pipeline cache
+            RomFsCache, //!< Decrypted RomFS blocks held in the cache, these can be trimmed
+            Audio, //!< Sample buffers of audio tracks and decoded ADPCM buffers, the latter can be trimmed
+        };
+        static constexpr size_t CategoryCount{11};
+
+        std::array<u64, CategoryCount> bytes{}; //!< The memory usage of every category in bytes
+
+        /**
+         * @brief Samples the memory usage of every subsystem, subsystems that haven't been initialised yet are reported as using no memory
+         */
+        static MemoryReport Collect(const DeviceState &state);
+
+        /**
+         * @brief Samples the memory usage of every subsystem and emits it as perfetto counters, this is a no-op unless the 'memory' category is enabled
+         */
+        static void TraceCounters(const DeviceState &state);
+
+        /**
+         * @brief Releases all memory held by caches which can be repopulated on demand, this is done when the host is running low on memory
+         */
+        static void Trim(const DeviceState &state);
+
+        /**
+         * @return A report of the memory usage of every category
+         */
+        std::string Format() const;
+    };
+}
@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "spin_lock.h"
+#include "utils.h"
+
+namespace skyline {
+    /**
+     * @brief A pool of fixed-size cache-aligned blocks for objects which are allocated and freed at high rates
+     * @details Every thread keeps freed blocks in a thread-local freelist which it allocates from without any synchronization, when a freelist grows beyond its limit a batch of blocks is moved into a shared list from which other threads refill their freelists when they run dry, this allows blocks that are allocated on one thread and freed on another to be reused
+     * @note Blocks are never returned to the system allocator, the pool only grows to the peak amount of simultaneously live objects
+     */
+    template<size_t BlockSize, size_t BlockAlignment>
+    class ObjectPool {
+      private:
+        static constexpr size_t CacheLineSize{64}; //!< Blocks are aligned to cache lines so objects used by different threads never falsely share a line
+        static constexpr size_t Alignment{std::max(BlockAlignment, CacheLineSize)};
+        static constexpr size_t Size{util::AlignUp(BlockSize, Alignment)};
+        static constexpr size_t BatchSize{32}; //!< The amount of blocks moved between a thread-local freelist and the shared list at once
+        static constexpr size_t MaxCachedBlocks{BatchSize * 2}; //!< The maximum amount of blocks in a thread-local freelist before a batch is moved into the shared list
+
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        struct Batch {
+            FreeBlock *head;
+            size_t count;
+        };
+
+        struct SharedState {
+            SpinLock lock;
+            std::vector<Batch> batches;
+        };
+
+        /**
+         * @note The state is intentionally leaked as objects may still be freed during static destruction
+         */
+        static SharedState &GetSharedState() {
+            static auto *state{new SharedState()};
+            return *state;
+        }
+
+        static void PushBatch(Batch batch) {
+            auto &state{GetSharedState()};
+            std::scoped_lock lock{state.lock};
+            state.batches.push_back(batch);
+        }
+
+        struct ThreadCache {
+            FreeBlock *head{};
+            size_t count{};
+            bool exited{}; //!< If the thread is exiting, blocks freed by the destructors of other thread-local objects after this go straight to the shared list
+
+            /**
+             * @brief Hands all cached blocks to the shared list, so they aren't lost with the thread
+             */
+            ~ThreadCache() {
+                if (head)
+                    PushBatch(Batch{head, count});
+                head = nullptr;
+                count = 0;
+                exited = true;
+            }
+        };
+
+        static ThreadCache &GetThreadCache() {
+            thread_local ThreadCache cache;
+            return cache;
+        }
+
+        /**
+         * @brief Refills the thread-local freelist with a batch from the shared list or allocates a new block if there are none
+         * @return A block if a new one had to be allocated or nullptr if the freelist was refilled
+         */
+        static void *Refill(ThreadCache &cache) {
+            {
+                auto &state{GetSharedState()};
+                std::scoped_lock lock{state.lock};
+                if (!state.batches.empty()) {
+                    auto batch{state.batches.back()};
+                    state.batches.pop_back();
+                    cache.head = batch.head;
+                    cache.count = batch.count;
+                    return nullptr;
+                }
+            }
+
+            return ::operator new(Size, std::align_val_t{Alignment});
+        }
+
+        /**
+         * @brief Moves a batch of blocks from the thread-local freelist into the shared list
+         */
+        static void Spill(ThreadCache &cache) {
+            FreeBlock *head{cache.head}, *tail{cache.head};
+            for (size_t index{1}; index < BatchSize; index++)
+                tail = tail->next;
+
+            cache.head = tail->next;
+            cache.count -= BatchSize;
+            tail->next = nullptr;
+            PushBatch(Batch{head, BatchSize});
+        }
+
+      public:
+        static void *Allocate() {
+            auto &cache{GetThreadCache()};
+            if (!cache.head) [[unlikely]]
+                if (auto block{Refill(cache)})
+                    return block;
+
+            auto block{cache.head};
+            cache.head = block->next;
+            cache.count--;
+            return block;
+        }
+
+        static void Deallocate(void *pointer) {
+            auto block{static_cast<FreeBlock *>(pointer)};
+            auto &cache{GetThreadCache()};
+            if (cache.exited) [[unlikely]] {
+                block->next = nullptr;
+                PushBatch(Batch{block, 1});
+                return;
+            }
+
+            block->next = cache.head;
+            cache.head = block;
+            if (++cache.count > MaxCachedBlocks) [[unlikely]]
+                Spill(cache);
+        }
+    };
+
+    /**
+     * @brief An STL allocator which allocates single objects from an ObjectPool for their size and alignment, this is primarily intended to be used with std::allocate_shared so the control block and object share a pooled block
+     * @note Allocations of multiple objects at once aren't pooled and use the system allocator
+     */
+    template<typename Type>
+    struct PoolAllocator {
+        using value_type = Type;
+
+        PoolAllocator() = default;
+
+        template<typename Other>
+        constexpr PoolAllocator(const PoolAllocator<Other> &) noexcept {}
+
+        Type *allocate(size_t count) {
+            if (count == 1) [[likely]]
+                return static_cast<Type *>(ObjectPool<sizeof(Type), alignof(Type)>::Allocate());
+            return std::allocator<Type>{}.allocate(count);
+        }
+
+        void deallocate(Type *pointer, size_t count) noexcept {
+            if (count == 1) [[likely]]
+                ObjectPool<sizeof(Type), alignof(Type)>::Deallocate(pointer);
+            else
+                std::allocator<Type>{}.deallocate(pointer, count);
+        }
+
+        template<typename Other>
+        constexpr bool operator==(const PoolAllocator<Other> &) const noexcept {
+            return true;
+        }
+    };
+
+    /**
+     * @brief A drop-in replacement for std::make_shared which allocates the object from an ObjectPool
+     */
+    template<typename Type, typename... Args>
+    std::shared_ptr<Type> MakePooledShared(Args &&... args) {
+        return std::allocate_shared<Type>(PoolAllocator<Type>{}, std::forward<Args>(args)...);
+    }
+}
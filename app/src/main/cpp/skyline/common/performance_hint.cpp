@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <dlfcn.h>
+#include <unistd.h>
+#include "performance_hint.h"
+
+namespace skyline::host {
+    PerformanceHint::PerformanceHint() {
+        auto libandroid{dlopen("libandroid.so", RTLD_NOW)};
+        if (!libandroid)
+            return;
+
+        auto getManager{reinterpret_cast<GetManagerFunction>(dlsym(libandroid, "APerformanceHint_getManager"))};
+        createSession = reinterpret_cast<CreateSessionFunction>(dlsym(libandroid, "APerformanceHint_createSession"));
+        updateTargetWorkDuration = reinterpret_cast<UpdateTargetWorkDurationFunction>(dlsym(libandroid, "APerformanceHint_updateTargetWorkDuration"));
+        reportActualWorkDuration = reinterpret_cast<ReportActualWorkDurationFunction>(dlsym(libandroid, "APerformanceHint_reportActualWorkDuration"));
+        closeSession = reinterpret_cast<CloseSessionFunction>(dlsym(libandroid, "APerformanceHint_closeSession"));
+        setThreads = reinterpret_cast<SetThreadsFunction>(dlsym(libandroid, "APerformanceHint_setThreads"));
+
+        if (getManager && createSession && updateTargetWorkDuration && reportActualWorkDuration && closeSession)
+            manager = getManager();
+
+        if (!manager)
+            Logger::Info("Performance hint sessions aren't supported on this device");
+    }
+
+    /**
+     * @note The instance is intentionally leaked as threads may still be removed from it during static destruction
+     */
+    PerformanceHint &PerformanceHint::Get() {
+        static auto *performanceHint{new PerformanceHint()};
+        return *performanceHint;
+    }
+
+    PerformanceHint::ScopedThread::ScopedThread() : threadId{gettid()} {
+        auto &performanceHint{Get()};
+        if (!performanceHint.manager)
+            return;
+
+        std::scoped_lock lock{performanceHint.mutex};
+        performanceHint.threads.push_back(threadId);
+        performanceHint.threadsDirty = true;
+    }
+
+    PerformanceHint::ScopedThread::~ScopedThread() {
+        auto &performanceHint{Get()};
+        if (!performanceHint.manager)
+            return;
+
+        std::scoped_lock lock{performanceHint.mutex};
+        std::erase(performanceHint.threads, threadId);
+        performanceHint.threadsDirty = true;
+    }
+
+    void PerformanceHint::UpdateSession() {
+        threadsDirty = false;
+
+        // Sessions can have their threads replaced in-place on Android 14+, older versions require the session to be recreated
+        if (session && setThreads && !threads.empty() && setThreads(session, threads.data(), threads.size()) == 0)
+            return;
+
+        if (session) {
+            closeSession(session);
+            session = nullptr;
+        }
+
+        if (!threads.empty() && targetDurationNs > 0) {
+            session = createSession(manager, threads.data(), threads.size(), targetDurationNs);
+            if (!session)
+                Logger::Warn("Failed to create a performance hint session for {} threads", threads.size());
+        }
+    }
+
+    void PerformanceHint::ReportFrame(i64 pTargetDurationNs, i64 actualDurationNs) {
+        if (!manager || pTargetDurationNs <= 0)
+            return;
+
+        std::scoped_lock lock{mutex};
+        bool targetChanged{pTargetDurationNs != targetDurationNs};
+        targetDurationNs = pTargetDurationNs;
+
+        if (threadsDirty)
+            UpdateSession();
+        if (session && targetChanged)
+            updateTargetWorkDuration(session, targetDurationNs);
+
+        // A work duration of zero is rejected by the API, this'd only happen on frames where none of the threads did any work
+        if (session && actualDurationNs > 0)
+            reportActualWorkDuration(session, actualDurationNs);
+    }
+}
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <sys/types.h>
+#include <common.h>
+
+namespace skyline::host {
+    /**
+     * @brief A wrapper around an Android performance hint (ADPF) session covering the threads on the critical path of every frame, this lets the governor adjust clocks to the frame deadline rather than only reacting to load
+     * @note The API is only available on Android 13+ and is resolved at runtime, everything is a no-op if it isn't available or a session couldn't be created
+     */
+    class PerformanceHint {
+      private:
+        using GetManagerFunction = void *(*)();
+        using CreateSessionFunction = void *(*)(void *manager, const i32 *threadIds, size_t size, i64 initialTargetWorkDurationNanos);
+        using UpdateTargetWorkDurationFunction = int (*)(void *session, i64 targetDurationNanos);
+        using ReportActualWorkDurationFunction = int (*)(void *session, i64 actualDurationNanos);
+        using CloseSessionFunction = void (*)(void *session);
+        using SetThreadsFunction = int (*)(void *session, const i32 *threadIds, size_t size); //!< This is only available on Android 14+
+
+        CreateSessionFunction createSession{};
+        UpdateTargetWorkDurationFunction updateTargetWorkDuration{};
+        ReportActualWorkDurationFunction reportActualWorkDuration{};
+        CloseSessionFunction closeSession{};
+        SetThreadsFunction setThreads{};
+        void *manager{}; //!< The APerformanceHintManager, this is null if the API isn't available
+
+        std::mutex mutex;
+        std::vector<i32> threads; //!< The TIDs of all threads covered by the session
+        bool threadsDirty{}; //!< If the threads have changed since the session was last updated
+        void *session{}; //!< The APerformanceHintSession, this is lazily (re)created on the first report after the threads change
+        i64 targetDurationNs{}; //!< The target work duration the session was last updated with
+
+        PerformanceHint();
+
+        /**
+         * @brief Brings the session up to date with the current set of threads
+         * @note The mutex must be locked by the caller
+         */
+        void UpdateSession();
+
+      public:
+        /**
+         * @brief Adds the calling thread to the session for its lifetime
+         */
+        class ScopedThread {
+          private:
+            i32 threadId;
+
+          public:
+            ScopedThread();
+
+            ~ScopedThread();
+        };
+
+        static PerformanceHint &Get();
+
+        /**
+         * @brief Reports the time the threads in the session spent working on a frame and the duration they had to do it in
+         */
+        void ReportFrame(i64 targetDurationNs, i64 actualDurationNs);
+    };
+}
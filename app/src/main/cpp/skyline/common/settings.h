@@ -4,6 +4,8 @@
 #pragma once
 
 #include "language.h"
+#include "host_topology.h"
+#include "title_profile.h"
 
 namespace skyline {
     /**
@@ -57,6 +59,20 @@ namespace skyline {
             }
         };
 
+        std::mutex titleProfileMutex;
+        std::shared_ptr<const TitleProfile> titleProfile; //!< The profile of the running title, its overrides take precedence over the settings of the user
+
+      protected:
+        /**
+         * @brief Re-applies the overrides of the title profile if there is one
+         * @note This must be called at the end of Update so the overrides aren't replaced by the settings of the user
+         */
+        void ApplyTitleProfile() {
+            std::scoped_lock lock{titleProfileMutex};
+            if (titleProfile)
+                titleProfile->Apply(*this);
+        }
+
       public:
         // System
         Setting<bool> isDocked; //!< If the emulated Switch should be handheld or docked
@@ -64,34 +80,67 @@ namespace skyline {
         Setting<std::string> profilePictureValue; //!< The profile picture path to be supplied to the guest
         Setting<language::SystemLanguage> systemLanguage; //!< The system language
         Setting<region::RegionCode> systemRegion; //!< The system region
+        Setting<bool> pinGuestCores; //!< If guest threads should be pinned to the host cores that correspond to their guest core, the application cores are mapped to performance cores and the system core to efficiency cores
+        Setting<host::AffinityClass> gpfifoAffinity; //!< The class of host cores that GPFIFO threads are restricted to
+        Setting<host::AffinityClass> commandRecordAffinity; //!< The class of host cores that command recording threads are restricted to
+        Setting<host::AffinityClass> pipelineCompileAffinity; //!< The class of host cores that pipeline compilation threads are restricted to for any work the guest isn't blocked on
+        Setting<host::AffinityClass> audioAffinity; //!< The class of host cores that the audio output thread is restricted to
+        Setting<bool> prefaultGuestMemory; //!< If the known working set of guest memory (.bss and heap) should be populated on a background thread rather than being faulted in on first access
+        Setting<bool> warmBootSnapshot; //!< If the decrypted and decompressed segments of executables should be snapshotted to storage on boot and read from there on subsequent boots
+        Setting<u32> romFsCacheSize; //!< The amount of memory in MiB that decrypted RomFS blocks may be cached in, 0 disables the cache
 
         // Display
         Setting<bool> forceTripleBuffering; //!< If the presentation engine should always triple buffer even if the swapchain supports double buffering
         Setting<bool> disableFrameThrottling; //!< Allow the guest to submit frames without any blocking calls
+        Setting<bool> lowLatencyPresentation; //!< If only the newest submitted frame should be presented at the next display refresh, older pending frames are discarded rather than blocking the guest
         Setting<bool> disableShaderCache;  //!< Prevents cached shaders from being loaded and disables caching of new shaders
+        Setting<bool> disableTextureCache; //!< Prevents cached decoded textures from being loaded and disables caching of newly decoded textures
 
         // GPU
         Setting<std::string> gpuDriver; //!< The label of the GPU driver to use
         Setting<std::string> gpuDriverLibraryName; //!< The name of the GPU driver library to use
         Setting<u32> executorSlotCountScale; //!< Number of GPU executor slots that can be used concurrently
         Setting<u32> executorFlushThreshold; //!< Number of commands that need to accumulate before they're flushed to the GPU
-        Setting<bool> useDirectMemoryImport; //!< If buffer emulation should be done by importing guest buffer mappings
+        Setting<bool> useDirectMemoryImport; //!< If buffer and linear texture emulation should be done by importing guest mappings
         Setting<bool> forceMaxGpuClocks; //!< If the GPU should be forced to run at maximum clocks
+        Setting<bool> useGpuTextureDeswizzle; //!< If block-linear textures should be deswizzled on the GPU using a compute shader rather than on the CPU
+        Setting<bool> asyncWriteTracking; //!< If CPU writes to buffers that are streamed to every frame should be tracked through asynchronous userfaultfd write-protection rather than by hashing them, this requires host kernel support
+        Setting<bool> asyncPipelineCreation; //!< If shader translation and pipeline compilation should occur asynchronously, skipping draws until the pipeline is ready
+        Setting<u32> textureMemoryBudget; //!< The amount of memory in MiB that textures may use before unused textures are evicted, 0 uses the budget reported by the driver
+        Setting<u32> resolutionScale; //!< The percentage of the guest resolution that render targets are rendered at, only sub-native scales are supported
 
         // Hacks
         Setting<bool> enableFastGpuReadbackHack; //!< If the CPU texture readback skipping hack should be used
         Setting<bool> disableSubgroupShuffle; //!< If shader subgroup suffle operations should be ignored
+        Setting<bool> hleServiceFastPath; //!< If SDK wrappers around frequently polled service commands should be hooked to respond directly rather than through IPC
 
         // Audio
         Setting<bool> isAudioOutputDisabled; //!< Disables audio output
+        Setting<bool> highQualityAudioResampling; //!< If audio should be resampled with a polyphase filter rather than 4-tap interpolation
+        Setting<bool> audioTimeStretching; //!< If audio should be time-stretched rather than underrunning when the guest can't submit it in real-time
 
         // Debug
         Setting<bool> validationLayer; //!< If the vulkan validation layer is enabled
+        Setting<bool> logUnhandledMacros; //!< If the hashes, sizes and invocation counts of macros without an HLE implementation should be logged
+        Setting<bool> guestProfiler; //!< If guest code should be periodically sampled to find hot functions, the profile is written out when emulation ends
+        Setting<u32> flightRecorderThreshold; //!< The frametime in milliseconds above which the last few seconds of trace events are written to a file, 0 disables the flight recorder
+        Setting<bool> gpfifoCapture; //!< If the GPFIFO streams of all channels and the pushbuffers they reference should be captured to a file
 
         Settings() = default;
 
         virtual ~Settings() = default;
 
+        /**
+         * @brief Sets the profile of the running title and applies its overrides
+         */
+        void SetTitleProfile(std::shared_ptr<const TitleProfile> profile) {
+            {
+                std::scoped_lock lock{titleProfileMutex};
+                titleProfile = std::move(profile);
+            }
+            ApplyTitleProfile();
+        }
+
         /**
          * @brief Updates settings with the given values
          * @note This method is platform-specific and must be overridden
@@ -3,6 +3,9 @@
 
 #include <chrono>
 #include <thread>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
 #include "spin_lock.h"
 
 namespace skyline {
@@ -37,4 +40,33 @@ namespace skyline {
             return try_lock_shared();
         });
     }
+
+    static constexpr size_t AdaptiveSpinRounds{10}; //!< The amount of rounds of spinning prior to parking, the backoff doubles every round so this bounds spinning to roughly 2^rounds yields
+    static constexpr u32 AdaptiveMaxBackoff{1U << 9}; //!< The maximum amount of yields between attempts to acquire the lock
+
+    void __attribute__ ((noinline)) AdaptiveMutex::LockSlow() {
+        statistics.contendedCount.fetch_add(1, std::memory_order_relaxed);
+
+        for (size_t round{}, backoff{1}; round < AdaptiveSpinRounds; round++, backoff = std::min<size_t>(backoff * 2, AdaptiveMaxBackoff)) {
+            for (size_t i{}; i < backoff; i++)
+                asm volatile("YIELD");
+
+            u32 value{state.load(std::memory_order_relaxed)};
+            if (value == StateUnlocked && state.compare_exchange_weak(value, StateLocked, std::memory_order_acquire, std::memory_order_relaxed))
+                return;
+            if (value == StateParked)
+                break; // Other waiters have already given up on spinning, the owner is likely preempted or holding the lock for a long time
+        }
+
+        // The state is set to parked regardless of whether we park as it can't be known if there are other parked waiters, this may result in a spurious wake on unlock
+        while (state.exchange(StateParked, std::memory_order_acquire) != StateUnlocked) {
+            statistics.parkCount.fetch_add(1, std::memory_order_relaxed);
+            // A signal interrupting the wait will cause it to return early, the state is simply rechecked in that case
+            syscall(SYS_futex, reinterpret_cast<u32 *>(&state), FUTEX_WAIT_PRIVATE, StateParked, nullptr, nullptr, 0);
+        }
+    }
+
+    void __attribute__ ((noinline)) AdaptiveMutex::WakeWaiter() {
+        syscall(SYS_futex, reinterpret_cast<u32 *>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
 }
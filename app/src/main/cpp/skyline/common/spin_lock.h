@@ -88,6 +88,53 @@ namespace skyline {
         }
     };
 
+    /**
+     * @brief A mutex that spins with exponential backoff for a bounded amount of time prior to parking the thread on a futex
+     * @details Short critical sections are handed off without the syscall latency of std::mutex while a preempted owner doesn't result in waiters burning cycles indefinitely as they would with SpinLock
+     * @note Contention statistics are only updated on the slow path, so they have no cost for uncontended locking
+     */
+    class AdaptiveMutex {
+      public:
+        struct Statistics {
+            std::atomic<u64> contendedCount{}; //!< The amount of acquisitions which couldn't be satisfied immediately
+            std::atomic<u64> parkCount{}; //!< The amount of times a waiter parked on the futex after spinning didn't acquire the lock
+        };
+
+      private:
+        static constexpr u32 StateUnlocked{0};
+        static constexpr u32 StateLocked{1};
+        static constexpr u32 StateParked{2}; //!< The mutex is locked and there may be threads parked on it, the owner must wake one of them on unlock
+
+        std::atomic<u32> state{StateUnlocked};
+        Statistics statistics;
+
+        void LockSlow();
+
+        void WakeWaiter();
+
+      public:
+        void lock() {
+            if (try_lock()) [[likely]]
+                return;
+
+            LockSlow();
+        }
+
+        bool try_lock() {
+            u32 expected{StateUnlocked};
+            return state.compare_exchange_strong(expected, StateLocked, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        void unlock() {
+            if (state.exchange(StateUnlocked, std::memory_order_release) == StateParked) [[unlikely]]
+                WakeWaiter();
+        }
+
+        const Statistics &GetStatistics() const {
+            return statistics;
+        }
+    };
+
     /**
      * @brief Recursive lock built ontop of `SpinLock`
      * @note This should *ONLY* be used in situations where it is provably better than an std::mutex due to spinlocks having worse perfomance under heavy contention
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <atomic>
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief A lock-free circular buffer with a single producer and a single consumer, neither side can ever block the other which allows it to be consumed from real-time threads
+     * @tparam Type The type of elements stored in the buffer, this must be trivially copyable
+     * @tparam Size The maximum amount of elements in the buffer
+     * @note Writes that don't fit in the buffer are truncated rather than overwriting unread elements as the producer can't move the read position
+     */
+    template<typename Type, size_t Size>
+    class SpscRingBuffer {
+      private:
+        static_assert(std::is_trivially_copyable_v<Type>);
+
+        static constexpr size_t CacheLineSize{64}; //!< The indices are kept on separate cache lines to avoid false sharing between the producer and consumer
+
+        std::array<Type, Size> array{};
+        alignas(CacheLineSize) std::atomic<u64> readIndex{}; //!< The monotonically increasing index of the oldest element, this is only written by the consumer
+        alignas(CacheLineSize) std::atomic<u64> writeIndex{}; //!< The monotonically increasing index past the newest element, this is only written by the producer
+
+      public:
+        /**
+         * @return The amount of elements in the buffer which haven't been consumed yet, this may be outdated by the time it's returned if called by either side about the other
+         */
+        size_t Size() const {
+            return static_cast<size_t>(writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire));
+        }
+
+        /**
+         * @brief Appends as many elements from the supplied buffer as there's space for
+         * @return The amount of elements that were written
+         * @note This must only be called by the producer
+         */
+        size_t Write(span<const Type> buffer) {
+            auto write{writeIndex.load(std::memory_order_relaxed)};
+            size_t size{std::min(buffer.size(), static_cast<size_t>(Size - (write - readIndex.load(std::memory_order_acquire))))};
+
+            size_t offset{static_cast<size_t>(write % Size)}, sizeEnd{std::min(size, Size - offset)};
+            std::memcpy(array.data() + offset, buffer.data(), sizeEnd * sizeof(Type));
+            std::memcpy(array.data(), buffer.data() + sizeEnd, (size - sizeEnd) * sizeof(Type));
+
+            writeIndex.store(write + size, std::memory_order_release);
+            return size;
+        }
+
+        /**
+         * @brief Produces up to the supplied amount of elements in-place, this avoids an intermediate buffer when elements are generated by a conversion
+         * @param produce A function taking a span of elements to fill and the offset of the first of them within the produced elements, it's called with at most two contiguous runs
+         * @return The amount of elements that were produced
+         * @note This must only be called by the producer
+         */
+        template<typename Function>
+        size_t Write(size_t count, Function &&produce) {
+            auto write{writeIndex.load(std::memory_order_relaxed)};
+            size_t size{std::min(count, static_cast<size_t>(Size - (write - readIndex.load(std::memory_order_acquire))))};
+            if (!size)
+                return 0;
+
+            size_t offset{static_cast<size_t>(write % Size)}, sizeEnd{std::min(size, Size - offset)};
+            produce(span<Type>{array.data() + offset, sizeEnd}, 0);
+            if (sizeEnd != size)
+                produce(span<Type>{array.data(), size - sizeEnd}, sizeEnd);
+
+            writeIndex.store(write + size, std::memory_order_release);
+            return size;
+        }
+
+        /**
+         * @brief Consumes up to the supplied amount of elements, they're passed to the supplied function in at most two contiguous runs
+         * @param consume A function taking a span of elements and the offset of the first of them within the consumed elements
+         * @return The amount of elements that were consumed
+         * @note This must only be called by the consumer
+         */
+        template<typename Function>
+        size_t Read(size_t count, Function &&consume) {
+            auto read{readIndex.load(std::memory_order_relaxed)};
+            size_t size{std::min(count, static_cast<size_t>(writeIndex.load(std::memory_order_acquire) - read))};
+            if (!size)
+                return 0;
+
+            size_t offset{static_cast<size_t>(read % Size)}, sizeEnd{std::min(size, Size - offset)};
+            consume(span<const Type>{array.data() + offset, sizeEnd}, 0);
+            if (sizeEnd != size)
+                consume(span<const Type>{array.data(), size - sizeEnd}, sizeEnd);
+
+            readIndex.store(read + size, std::memory_order_release);
+            return size;
+        }
+    };
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <charconv>
+#include <fstream>
+#include "settings.h"
+#include "title_profile.h"
+
+namespace skyline {
+    namespace {
+        /**
+         * @brief Trims leading and trailing whitespace from a string
+         */
+        std::string_view Trim(std::string_view string) {
+            constexpr std::string_view Whitespace{" \t\r"};
+            auto start{string.find_first_not_of(Whitespace)};
+            if (start == std::string_view::npos)
+                return {};
+            return string.substr(start, string.find_last_not_of(Whitespace) - start + 1);
+        }
+
+        template<typename Type>
+        bool ParseValue(std::string_view string, Type &value) {
+            if constexpr (std::is_same_v<Type, bool>) {
+                if (string == "true" || string == "1")
+                    value = true;
+                else if (string == "false" || string == "0")
+                    value = false;
+                else
+                    return false;
+                return true;
+            } else if constexpr (std::is_enum_v<Type>) {
+                std::underlying_type_t<Type> raw;
+                if (!ParseValue(string, raw))
+                    return false;
+                value = static_cast<Type>(raw);
+                return true;
+            } else {
+                auto result{std::from_chars(string.data(), string.data() + string.size(), value)};
+                return result.ec == std::errc{} && result.ptr == string.data() + string.size();
+            }
+        }
+
+        /**
+         * @brief Parses a value from a profile and assigns it to the supplied setting
+         */
+        template<typename Type, typename Setting>
+        bool Override(Setting &setting, std::string_view string) {
+            Type value;
+            if (!ParseValue(string, value))
+                return false;
+            setting = value;
+            return true;
+        }
+
+        using OverrideFunction = bool (*)(Settings &, std::string_view);
+
+        /**
+         * @brief All settings that can be overridden by a profile, these are the settings which affect the performance or compatibility of a title rather than user preferences
+         */
+        const std::unordered_map<std::string_view, OverrideFunction> OverridableSettings{
+            #define SETTING(name, type) {#name, [](Settings &settings, std::string_view value) { return Override<type>(settings.name, value); }}
+            SETTING(pinGuestCores, bool),
+            SETTING(gpfifoAffinity, host::AffinityClass),
+            SETTING(commandRecordAffinity, host::AffinityClass),
+            SETTING(pipelineCompileAffinity, host::AffinityClass),
+            SETTING(audioAffinity, host::AffinityClass),
+            SETTING(prefaultGuestMemory, bool),
+            SETTING(warmBootSnapshot, bool),
+            SETTING(romFsCacheSize, u32),
+            SETTING(forceTripleBuffering, bool),
+            SETTING(disableFrameThrottling, bool),
+            SETTING(lowLatencyPresentation, bool),
+            SETTING(executorSlotCountScale, u32),
+            SETTING(executorFlushThreshold, u32),
+            SETTING(useDirectMemoryImport, bool),
+            SETTING(forceMaxGpuClocks, bool),
+            SETTING(useGpuTextureDeswizzle, bool),
+            SETTING(asyncWriteTracking, bool),
+            SETTING(asyncPipelineCreation, bool),
+            SETTING(textureMemoryBudget, u32),
+            SETTING(resolutionScale, u32),
+            SETTING(enableFastGpuReadbackHack, bool),
+            SETTING(disableSubgroupShuffle, bool),
+            SETTING(hleServiceFastPath, bool),
+            SETTING(highQualityAudioResampling, bool),
+            SETTING(audioTimeStretching, bool),
+            #undef SETTING
+        };
+    }
+
+    TitleProfile::TitleProfile(const std::string &path) {
+        std::ifstream stream{path};
+        std::string line;
+        for (size_t lineNumber{1}; std::getline(stream, line); lineNumber++) {
+            auto trimmed{Trim(line)};
+            if (trimmed.empty() || trimmed.front() == '#')
+                continue;
+
+            auto separator{trimmed.find('=')};
+            if (separator == std::string_view::npos) {
+                Logger::Warn("Ignoring malformed line {} in title profile '{}'", lineNumber, path);
+                continue;
+            }
+
+            auto name{Trim(trimmed.substr(0, separator))}, value{Trim(trimmed.substr(separator + 1))};
+            if (!OverridableSettings.contains(name)) {
+                Logger::Warn("Ignoring unknown setting '{}' in title profile '{}'", name, path);
+                continue;
+            }
+
+            overrides.emplace_back(name, value);
+        }
+    }
+
+    void TitleProfile::Apply(Settings &settings) const {
+        for (const auto &[name, value] : overrides)
+            if (!OverridableSettings.at(name)(settings, value))
+                Logger::Warn("Ignoring invalid value '{}' for setting '{}' in title profile", value, name);
+    }
+
+    std::shared_ptr<const TitleProfile> TitleProfile::Load(const std::string &directory, std::string_view titleId) {
+        auto path{fmt::format("{}{}.txt", directory, titleId)};
+        if (!std::ifstream{path})
+            return nullptr;
+
+        auto profile{std::make_shared<TitleProfile>(path)};
+        if (profile->Empty())
+            return nullptr;
+
+        Logger::Info("Loaded title profile '{}'", path);
+        return profile;
+    }
+}
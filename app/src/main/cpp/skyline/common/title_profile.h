@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline {
+    /**
+     * @brief A set of settings overrides for a specific title, these are applied over the settings of the user so a title runs with its known-good configuration without manual tweaking
+     * @details Profiles are text files with a 'name=value' pair per line where the name is that of the setting, booleans are written as 'true' or 'false' and blank lines or lines starting with '#' are ignored
+     */
+    class TitleProfile {
+      private:
+        std::vector<std::pair<std::string, std::string>> overrides;
+
+      public:
+        /**
+         * @brief Parses the profile at the supplied path
+         */
+        TitleProfile(const std::string &path);
+
+        bool Empty() const {
+            return overrides.empty();
+        }
+
+        /**
+         * @brief Overrides the values of the settings in the profile
+         */
+        void Apply(Settings &settings) const;
+
+        /**
+         * @return The profile for the supplied title from the supplied directory or nullptr if there's none for it
+         */
+        static std::shared_ptr<const TitleProfile> Load(const std::string &directory, std::string_view titleId);
+    };
+}
@@ -16,6 +16,8 @@ PERFETTO_DEFINE_CATEGORIES(
     perfetto::Category("host").SetDescription("Events relating to host code"),
     perfetto::Category("gpu").SetDescription("Events from the emulated GPU"),
     perfetto::Category("service").SetDescription("Events from the HLE sysmodule implementations"),
+    perfetto::Category("audio").SetDescription("Events from the audio pipeline"),
+    perfetto::Category("memory").SetDescription("Memory usage of every subsystem"),
     perfetto::Category("containers").SetDescription("Events from custom container implementations")
 );
 
@@ -25,5 +27,6 @@ namespace skyline::trace {
      */
     enum class TrackIds : u64 {
         Presentation = std::numeric_limits<u64>::max(),
+        Gpu = std::numeric_limits<u64>::max() - 1, //!< The parent track of the GPU timestamp tracks of every queue
     };
 }
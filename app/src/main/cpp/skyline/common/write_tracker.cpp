@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/userfaultfd.h>
+#include "write_tracker.h"
+
+namespace skyline {
+    // The following definitions are from Linux 6.7 and are defined here as they aren't present in the NDK's kernel headers
+    constexpr int UffdUserModeOnly{1}; //!< UFFD_USER_MODE_ONLY, the userfaultfd only handles faults from userspace which doesn't require any additional privileges
+    constexpr u64 UffdFeatureWpHugetlbfsShmem{1ULL << 12}; //!< UFFD_FEATURE_WP_HUGETLBFS_SHMEM, required for write-protecting shared memory such as guest memory
+    constexpr u64 UffdFeatureWpUnpopulated{1ULL << 13}; //!< UFFD_FEATURE_WP_UNPOPULATED, write-protection applies to pages that haven't been faulted in yet
+    constexpr u64 UffdFeatureWpAsync{1ULL << 15}; //!< UFFD_FEATURE_WP_ASYNC, write faults are resolved by the kernel rather than being delivered to the userfaultfd
+    constexpr u64 RequiredUffdFeatures{UffdFeatureWpHugetlbfsShmem | UffdFeatureWpUnpopulated | UffdFeatureWpAsync};
+
+    /**
+     * @brief struct page_region, a run of pages with the same categories returned by PAGEMAP_SCAN
+     */
+    struct PageRegion {
+        u64 start;
+        u64 end;
+        u64 categories;
+    };
+
+    /**
+     * @brief struct pm_scan_arg, the arguments to PAGEMAP_SCAN
+     */
+    struct PagemapScanArguments {
+        u64 size;
+        u64 flags;
+        u64 start;
+        u64 end;
+        u64 walkEnd;
+        u64 vector;
+        u64 vectorLength;
+        u64 maxPages;
+        u64 categoryInverted;
+        u64 categoryMask;
+        u64 categoryAnyofMask;
+        u64 returnMask;
+    };
+
+    constexpr unsigned long PagemapScan{_IOWR('f', 16, PagemapScanArguments)};
+    constexpr u64 PagemapScanWpMatching{1ULL << 0}; //!< PM_SCAN_WP_MATCHING, write-protects all matching pages after they're returned
+    constexpr u64 PagemapScanCheckWpAsync{1ULL << 1}; //!< PM_SCAN_CHECK_WPASYNC, fails the scan if any page isn't registered for asynchronous write-protection
+    constexpr u64 PageIsWritten{1ULL << 1}; //!< PAGE_IS_WRITTEN, the page was written to since it was last write-protected
+
+    WriteTracker::WriteTracker() : userfault{static_cast<int>(syscall(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK | UffdUserModeOnly))}, pagemap{open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC)} {
+        if (userfault == -1)
+            throw exception("Failed to create userfaultfd: {}", strerror(errno));
+        if (pagemap == -1)
+            throw exception("Failed to open pagemap: {}", strerror(errno));
+
+        uffdio_api api{
+            .api = UFFD_API,
+            .features = RequiredUffdFeatures,
+        };
+        if (ioctl(userfault, UFFDIO_API, &api) == -1 || (api.features & RequiredUffdFeatures) != RequiredUffdFeatures)
+            throw exception("Asynchronous userfaultfd write-protection isn't supported: {}", strerror(errno));
+
+        // PAGEMAP_SCAN was added after asynchronous write-protection, so verify that a write to a shared mapping is reported after protecting it and not reported again
+        auto page{reinterpret_cast<u8 *>(mmap(nullptr, constant::PageSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0))};
+        if (page == MAP_FAILED)
+            throw exception("Failed to map write tracking probe page: {}", strerror(errno));
+
+        bool reported{}, reportedTwice{};
+        try {
+            Protect(page, page + constant::PageSize);
+            *reinterpret_cast<volatile u8 *>(page) = 1;
+            bool supported{Scan(page, page + constant::PageSize, [&](u8 *, u8 *) { reported = true; })};
+            supported = supported && Scan(page, page + constant::PageSize, [&](u8 *, u8 *) { reportedTwice = true; });
+            if (!supported)
+                reported = false;
+        } catch (const exception &) {
+            munmap(page, constant::PageSize);
+            throw;
+        }
+        munmap(page, constant::PageSize); // This implicitly unregisters the page from the userfaultfd
+
+        if (!reported || reportedTwice)
+            throw exception("PAGEMAP_SCAN isn't supported by the host kernel");
+    }
+
+    void WriteTracker::Protect(u8 *start, u8 *end) {
+        uffdio_register registration{
+            .range = {reinterpret_cast<u64>(start), static_cast<u64>(end - start)},
+            .mode = UFFDIO_REGISTER_MODE_WP,
+        };
+        if (ioctl(userfault, UFFDIO_REGISTER, &registration) == -1)
+            throw exception("Failed to register 0x{:X}-0x{:X} with userfaultfd: {}", reinterpret_cast<u64>(start), reinterpret_cast<u64>(end), strerror(errno));
+
+        uffdio_writeprotect writeProtect{
+            .range = registration.range,
+            .mode = UFFDIO_WRITEPROTECT_MODE_WP,
+        };
+        if (ioctl(userfault, UFFDIO_WRITEPROTECT, &writeProtect) == -1)
+            throw exception("Failed to write-protect 0x{:X}-0x{:X}: {}", reinterpret_cast<u64>(start), reinterpret_cast<u64>(end), strerror(errno));
+    }
+
+    void WriteTracker::Unprotect(u8 *start, u8 *end) {
+        uffdio_range range{reinterpret_cast<u64>(start), static_cast<u64>(end - start)};
+        if (ioctl(userfault, UFFDIO_UNREGISTER, &range) == -1)
+            Logger::Debug("Failed to unregister 0x{:X}-0x{:X} from userfaultfd: {}", range.start, range.start + range.len, strerror(errno)); // This is expected if the region was unmapped prior to being unregistered
+    }
+
+    bool WriteTracker::Scan(u8 *start, u8 *end, const std::function<void(u8 *, u8 *)> &callback) {
+        constexpr size_t RegionBatchSize{0x20}; //!< The amount of runs of written pages returned by a single scan
+        std::array<PageRegion, RegionBatchSize> regions;
+        PagemapScanArguments arguments{
+            .size = sizeof(PagemapScanArguments),
+            .flags = PagemapScanWpMatching | PagemapScanCheckWpAsync,
+            .start = reinterpret_cast<u64>(start),
+            .end = reinterpret_cast<u64>(end),
+            .vector = reinterpret_cast<u64>(regions.data()),
+            .vectorLength = RegionBatchSize,
+            .categoryMask = PageIsWritten,
+            .returnMask = PageIsWritten,
+        };
+
+        while (arguments.start < arguments.end) {
+            auto count{ioctl(pagemap, PagemapScan, &arguments)};
+            if (count == -1)
+                return false;
+
+            for (long region{}; region < count; region++)
+                callback(reinterpret_cast<u8 *>(regions[region].start), reinterpret_cast<u8 *>(regions[region].end));
+
+            // The walk ends early when the vector is filled, it's continued from where it stopped in that case
+            arguments.start = arguments.walkEnd;
+        }
+        return true;
+    }
+
+    WriteTracker::RangeHandle WriteTracker::Register(span<u8> region) {
+        u8 *alignedStart{util::AlignDown(region.data(), constant::PageSize)};
+        u8 *alignedEnd{util::AlignUp(region.end().base(), constant::PageSize)};
+
+        std::scoped_lock lock{mutex};
+        // Only pages that aren't tracked by any other range need to be protected, they're protected in runs to minimize the amount of ioctls
+        for (u8 *page{alignedStart}; page < alignedEnd; page += constant::PageSize)
+            pages[page].references++;
+
+        try {
+            u8 *runStart{};
+            for (auto it{pages.find(alignedStart)}; it != pages.end() && it->first < alignedEnd; it++) {
+                if (it->second.references == 1) {
+                    if (!runStart)
+                        runStart = it->first;
+                } else if (runStart) {
+                    Protect(runStart, it->first);
+                    runStart = nullptr;
+                }
+            }
+            if (runStart)
+                Protect(runStart, alignedEnd);
+        } catch (const exception &) {
+            Release(alignedStart, alignedEnd);
+            throw;
+        }
+
+        return ranges.emplace(ranges.end(), Range{region});
+    }
+
+    void WriteTracker::Release(u8 *alignedStart, u8 *alignedEnd) {
+        u8 *runStart{};
+        for (auto it{pages.lower_bound(alignedStart)}; it != pages.end() && it->first < alignedEnd;) {
+            if (--it->second.references == 0) {
+                if (!runStart)
+                    runStart = it->first;
+                it = pages.erase(it);
+            } else {
+                if (runStart)
+                    Unprotect(runStart, it->first);
+                runStart = nullptr;
+                it++;
+            }
+        }
+        if (runStart)
+            Unprotect(runStart, alignedEnd);
+    }
+
+    void WriteTracker::Unregister(RangeHandle handle) {
+        std::scoped_lock lock{mutex};
+        Release(util::AlignDown(handle->region.data(), constant::PageSize), util::AlignUp(handle->region.end().base(), constant::PageSize));
+        ranges.erase(handle);
+    }
+
+    bool WriteTracker::Consume(RangeHandle handle) {
+        u8 *alignedStart{util::AlignDown(handle->region.data(), constant::PageSize)};
+        u8 *alignedEnd{util::AlignUp(handle->region.end().base(), constant::PageSize)};
+
+        std::scoped_lock lock{mutex};
+        sequence++;
+
+        // Written pages are recorded rather than consumed directly as the write-protection of pages shared with other ranges is reset by this scan
+        bool tracked{Scan(alignedStart, alignedEnd, [&](u8 *start, u8 *end) {
+            for (auto it{pages.lower_bound(start)}; it != pages.end() && it->first < end; it++)
+                it->second.writeSequence = sequence;
+        })};
+
+        bool dirty{handle->dirty || !tracked};
+        for (auto it{pages.lower_bound(alignedStart)}; !dirty && it != pages.end() && it->first < alignedEnd; it++)
+            dirty = it->second.writeSequence > handle->consumedSequence;
+
+        handle->dirty = false;
+        handle->consumedSequence = sequence;
+        return dirty;
+    }
+}
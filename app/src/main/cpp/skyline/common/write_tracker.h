@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <common.h>
+#include "file_descriptor.h"
+
+namespace skyline {
+    /**
+     * @brief Tracks CPU writes to ranges of memory through asynchronous userfaultfd write-protection, writes are resolved by the kernel without any signal and are collected in batches through PAGEMAP_SCAN at sync points
+     * @note PAGEMAP_SCAN atomically retrieves and write-protects the written pages of a range, so unlike soft-dirty bits no writes can be lost between reading and clearing the dirty state
+     * @url https://docs.kernel.org/admin-guide/mm/userfaultfd.html#write-protect-notifications
+     * @url https://docs.kernel.org/admin-guide/mm/pagemap.html#pagemap-scan-ioctl
+     */
+    class WriteTracker {
+      private:
+        /**
+         * @brief The tracking state of a single page, pages can be shared by multiple ranges
+         */
+        struct Page {
+            u32 references{}; //!< The amount of ranges that span this page, the page is unregistered from the userfaultfd once this reaches zero
+            u64 writeSequence{}; //!< The sequence number at which a write to the page was last collected
+        };
+
+        /**
+         * @brief A registered range of memory
+         */
+        struct Range {
+            span<u8> region;
+            u64 consumedSequence{}; //!< The sequence number at which the range was last consumed
+            bool dirty{true}; //!< Ranges start dirty as any writes prior to registration are unknown
+        };
+
+        FileDescriptor userfault; //!< The userfaultfd which all ranges are registered with in asynchronous write-protect mode
+        FileDescriptor pagemap; //!< /proc/self/pagemap, which PAGEMAP_SCAN is issued on
+        std::mutex mutex; //!< Synchronizes access to all tracking state
+        std::map<u8 *, Page> pages; //!< A map from the address of every tracked page to its state
+        std::list<Range> ranges;
+        u64 sequence{}; //!< A monotonically increasing counter incremented on every consume
+
+        /**
+         * @brief Registers the supplied page-aligned region with the userfaultfd and write-protects it
+         */
+        void Protect(u8 *start, u8 *end);
+
+        /**
+         * @brief Unregisters the supplied page-aligned region from the userfaultfd, this implicitly clears any write-protection
+         */
+        void Unprotect(u8 *start, u8 *end);
+
+        /**
+         * @brief Drops a reference to every page in the supplied page-aligned region, pages that aren't referenced anymore are unprotected
+         */
+        void Release(u8 *alignedStart, u8 *alignedEnd);
+
+        /**
+         * @brief Retrieves all pages written to in the supplied page-aligned region and write-protects them again
+         * @param callback A function called with the start and end of every run of written pages
+         * @return If the scan succeeded, a failure means that the region can't be tracked anymore (e.g. it was remapped)
+         */
+        bool Scan(u8 *start, u8 *end, const std::function<void(u8 *, u8 *)> &callback);
+
+      public:
+        using RangeHandle = std::list<Range>::iterator;
+
+        /**
+         * @note This will throw an exception if asynchronous write-protection or PAGEMAP_SCAN isn't supported by the host kernel
+         */
+        WriteTracker();
+
+        /**
+         * @brief Starts tracking writes to the supplied region, the region is considered dirty till it's first consumed
+         * @note The region must be backed by anonymous or shared memory
+         */
+        RangeHandle Register(span<u8> region);
+
+        void Unregister(RangeHandle handle);
+
+        /**
+         * @return If the range was written to since it was last consumed, this may report false positives when the page-aligned bounds of the range are written but never false negatives
+         * @note Writes that occur during or after this will be reported by the next consume
+         */
+        bool Consume(RangeHandle handle);
+    };
+}
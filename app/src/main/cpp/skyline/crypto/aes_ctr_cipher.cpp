@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#include "aes_ctr_cipher.h"
+
+namespace skyline::crypto {
+    namespace {
+        /**
+         * @brief A 128-bit big-endian counter held in host order so it can be cheaply incremented
+         */
+        struct Counter {
+            u64 high;
+            u64 low;
+
+            Counter(const AesCtrCipher::Block &block) {
+                std::memcpy(&high, block.data(), sizeof(high));
+                std::memcpy(&low, block.data() + sizeof(high), sizeof(low));
+                high = util::SwapEndianness(high);
+                low = util::SwapEndianness(low);
+            }
+
+            /**
+             * @return The current counter as a big-endian block, the counter is then incremented
+             */
+            uint8x16_t Next() {
+                uint8x16_t block{vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(util::SwapEndianness(high)), vcreate_u64(util::SwapEndianness(low))))};
+                if (++low == 0)
+                    high++;
+                return block;
+            }
+        };
+
+        /**
+         * @brief Encrypts several independent blocks with the supplied round keys, their rounds are interleaved so the latency of every AESE/AESMC pair is hidden behind the others
+         */
+        template<size_t Count>
+        __attribute__((always_inline)) inline void EncryptBlocks(std::array<uint8x16_t, Count> &blocks, const uint8x16_t (&keys)[11]) {
+            for (size_t round{}; round < 9; round++)
+                for (auto &block : blocks)
+                    block = vaesmcq_u8(vaeseq_u8(block, keys[round]));
+
+            for (auto &block : blocks)
+                block = veorq_u8(vaeseq_u8(block, keys[9]), keys[10]);
+        }
+    }
+
+    AesCtrCipher::AesCtrCipher(const std::array<u8, 0x10> &key) : hardwareSupported{(getauxval(AT_HWCAP) & HWCAP_AES) != 0} {
+        mbedtls_aes_init(&fallbackContext);
+        if (hardwareSupported)
+            ExpandKey(key);
+        else if (mbedtls_aes_setkey_enc(&fallbackContext, key.data(), static_cast<unsigned int>(key.size() * 8)) != 0)
+            throw exception("Failed to set key for AES-CTR context");
+    }
+
+    AesCtrCipher::~AesCtrCipher() {
+        mbedtls_aes_free(&fallbackContext);
+    }
+
+    void AesCtrCipher::ExpandKey(const std::array<u8, 0x10> &key) {
+        constexpr std::array<u8, RoundKeyCount - 1> RoundConstants{0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36};
+
+        // Words are loaded in little-endian order, so the first byte of a word is in its least significant bits
+        std::array<u32, RoundKeyCount * 4> words;
+        std::memcpy(words.data(), key.data(), key.size());
+        for (size_t index{4}; index < words.size(); index++) {
+            u32 word{words[index - 1]};
+            if (index % 4 == 0) {
+                // SubWord is done with AESE using a zero round key on the word duplicated into every column, every row is uniform so ShiftRows has no effect
+                u32 substituted{vgetq_lane_u32(vreinterpretq_u32_u8(vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(word)), vdupq_n_u8(0))), 0)};
+                word = ((substituted >> 8) | (substituted << 24)) ^ RoundConstants[index / 4 - 1];
+            }
+            words[index] = words[index - 4] ^ word;
+        }
+        std::memcpy(roundKeys.data(), words.data(), sizeof(roundKeys));
+    }
+
+    void AesCtrCipher::DecryptHardware(u8 *data, size_t size, Block counterBlock, size_t blockOffset) const {
+        uint8x16_t keys[RoundKeyCount];
+        for (size_t index{}; index < RoundKeyCount; index++)
+            keys[index] = vld1q_u8(roundKeys[index].data());
+
+        Counter counter{counterBlock};
+        auto applyPartial{[&](size_t offset, size_t length) {
+            std::array<uint8x16_t, 1> keystream{counter.Next()};
+            EncryptBlocks(keystream, keys);
+            Block keystreamBytes;
+            vst1q_u8(keystreamBytes.data(), keystream[0]);
+            for (size_t index{}; index < length; index++)
+                data[index] ^= keystreamBytes[offset + index];
+            data += length;
+            size -= length;
+        }};
+
+        if (blockOffset)
+            applyPartial(blockOffset, std::min(BlockSize - blockOffset, size));
+
+        constexpr size_t ParallelBlocks{4};
+        while (size >= ParallelBlocks * BlockSize) {
+            std::array<uint8x16_t, ParallelBlocks> keystream{counter.Next(), counter.Next(), counter.Next(), counter.Next()};
+            EncryptBlocks(keystream, keys);
+            for (size_t block{}; block < ParallelBlocks; block++)
+                vst1q_u8(data + block * BlockSize, veorq_u8(vld1q_u8(data + block * BlockSize), keystream[block]));
+
+            data += ParallelBlocks * BlockSize;
+            size -= ParallelBlocks * BlockSize;
+        }
+
+        while (size >= BlockSize) {
+            std::array<uint8x16_t, 1> keystream{counter.Next()};
+            EncryptBlocks(keystream, keys);
+            vst1q_u8(data, veorq_u8(vld1q_u8(data), keystream[0]));
+
+            data += BlockSize;
+            size -= BlockSize;
+        }
+
+        if (size)
+            applyPartial(0, size);
+    }
+
+    void AesCtrCipher::DecryptFallback(u8 *data, size_t size, Block counter, size_t blockOffset) const {
+        Block keystream;
+        while (size) {
+            // mbedtls only reads the context during encryption but doesn't take it as const
+            mbedtls_aes_crypt_ecb(const_cast<mbedtls_aes_context *>(&fallbackContext), MBEDTLS_AES_ENCRYPT, counter.data(), keystream.data());
+            for (size_t index{BlockSize}; index-- > 0;)
+                if (++counter[index])
+                    break;
+
+            size_t length{std::min(BlockSize - blockOffset, size)};
+            for (size_t index{}; index < length; index++)
+                data[index] ^= keystream[blockOffset + index];
+
+            data += length;
+            size -= length;
+            blockOffset = 0;
+        }
+    }
+
+    void AesCtrCipher::Decrypt(span<u8> data, const Block &counter, size_t blockOffset) const {
+        if (data.empty())
+            return;
+
+        if (hardwareSupported)
+            DecryptHardware(data.data(), data.size(), counter, blockOffset);
+        else
+            DecryptFallback(data.data(), data.size(), counter, blockOffset);
+    }
+}
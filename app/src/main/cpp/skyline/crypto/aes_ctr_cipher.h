@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <mbedtls/aes.h>
+#include <common.h>
+
+namespace skyline::crypto {
+    /**
+     * @brief A stateless AES-128-CTR cipher which uses the ARMv8 Crypto Extensions when they're supported by the CPU
+     * @note The counter is supplied with every call rather than being part of the cipher's state, so a single instance can be used by any amount of threads concurrently without locking
+     */
+    class AesCtrCipher {
+      public:
+        static constexpr size_t BlockSize{0x10};
+        using Block = std::array<u8, BlockSize>;
+
+      private:
+        static constexpr size_t RoundKeyCount{11}; //!< AES-128 has 10 rounds and an initial key addition
+        alignas(16) std::array<Block, RoundKeyCount> roundKeys{}; //!< The expanded encryption key schedule for the AES instructions
+        mbedtls_aes_context fallbackContext; //!< The mbedtls context used on CPUs without the AES instructions, this is only ever read after construction
+        bool hardwareSupported; //!< If the CPU supports the ARMv8 AES instructions
+
+        /**
+         * @brief Expands the key into the round keys using the AES instructions
+         */
+        void ExpandKey(const std::array<u8, 0x10> &key);
+
+        /**
+         * @brief Decrypts the supplied data using the AES instructions, multiple blocks are processed at once to hide the latency of the instructions
+         */
+        void DecryptHardware(u8 *data, size_t size, Block counter, size_t blockOffset) const;
+
+        void DecryptFallback(u8 *data, size_t size, Block counter, size_t blockOffset) const;
+
+      public:
+        AesCtrCipher(const std::array<u8, 0x10> &key);
+
+        AesCtrCipher(const AesCtrCipher &) = delete;
+
+        AesCtrCipher &operator=(const AesCtrCipher &) = delete;
+
+        ~AesCtrCipher();
+
+        /**
+         * @brief Decrypts the supplied data in-place, as this is CTR mode this is identical to encryption
+         * @param counter The counter of the block containing the first byte of the data, this is incremented as a 128-bit big-endian integer for every subsequent block
+         * @param blockOffset The offset of the first byte of the data into its block, the keystream prior to it is discarded so data doesn't need to be block-aligned
+         */
+        void Decrypt(span<u8> data, const Block &counter, size_t blockOffset = 0) const;
+    };
+}
@@ -6,6 +6,7 @@
 #include <os.h>
 #include <jvm.h>
 #include <common/settings.h>
+#include <soc.h>
 #include "gpu.h"
 
 namespace skyline::gpu {
@@ -222,6 +223,8 @@ namespace skyline::gpu {
     static vk::raii::Device CreateDevice(const vk::raii::Context &context,
                                          const vk::raii::PhysicalDevice &physicalDevice,
                                          decltype(vk::DeviceQueueCreateInfo::queueCount) &vkQueueFamilyIndex,
+                                         u32 &vkQueueCount,
+                                         std::optional<u32> &vkTransferQueueFamilyIndex,
                                          TraitManager &traits,
                                          adrenotools_gpu_mapping *mapping) {
         auto deviceFeatures2{physicalDevice.getFeatures2<
@@ -239,7 +242,13 @@ namespace skyline::gpu {
             vk::PhysicalDeviceTransformFeedbackFeaturesEXT,
             vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
             vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT,
-            vk::PhysicalDeviceRobustness2FeaturesEXT>()};
+            vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT,
+            vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT,
+            vk::PhysicalDeviceRobustness2FeaturesEXT,
+            vk::PhysicalDeviceTimelineSemaphoreFeatures,
+            vk::PhysicalDeviceConditionalRenderingFeaturesEXT,
+            vk::PhysicalDeviceSamplerYcbcrConversionFeatures,
+            vk::PhysicalDeviceMultiDrawFeaturesEXT>()};
         decltype(deviceFeatures2) enabledFeatures2{}; // We only want to enable features we required due to potential overhead from unused features
 
         #define FEAT_REQ(structName, feature)                                            \
@@ -275,7 +284,11 @@ namespace skyline::gpu {
             vk::PhysicalDeviceDriverProperties,
             vk::PhysicalDeviceFloatControlsProperties,
             vk::PhysicalDeviceTransformFeedbackPropertiesEXT,
-            vk::PhysicalDeviceSubgroupProperties>()};
+            vk::PhysicalDeviceSubgroupProperties,
+            vk::PhysicalDeviceExternalMemoryHostPropertiesEXT,
+            vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT,
+            vk::PhysicalDevicePushDescriptorPropertiesKHR,
+            vk::PhysicalDeviceMultiDrawPropertiesEXT>()};
 
         traits = TraitManager{deviceFeatures2, enabledFeatures2, deviceExtensions, enabledExtensions, deviceProperties2, physicalDevice};
         traits.ApplyDriverPatches(context, mapping);
@@ -286,17 +299,21 @@ namespace skyline::gpu {
             pEnabledExtensions.push_back(extension.data());
 
         auto queueFamilies{physicalDevice.getQueueFamilyProperties()};
-        float queuePriority{1.0f}; //!< The priority of the only queue we use, it's set to the maximum of 1.0
+        std::array<float, CommandScheduler::MaxQueueCount> queuePriorities; //!< The priority of all queues we use, it's set to the maximum of 1.0
+        queuePriorities.fill(1.0f);
         vk::StructureChain<vk::DeviceQueueCreateInfo, vk::DeviceQueueGlobalPriorityCreateInfoEXT> queueCreateInfo{
             [&]() -> vk::DeviceQueueCreateInfo {
                 decltype(vk::DeviceQueueCreateInfo::queueFamilyIndex) index{};
                 for (const auto &queueFamily : queueFamilies) {
                     if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics && queueFamily.queueFlags & vk::QueueFlagBits::eCompute) {
                         vkQueueFamilyIndex = index;
+                        traits.timestampValidBits = queueFamily.timestampValidBits;
+                        // Additional queues are only used for submissions from separate channels which are ordered with each other through timeline semaphores
+                        vkQueueCount = traits.supportsTimelineSemaphores ? std::min(queueFamily.queueCount, CommandScheduler::MaxQueueCount) : 1;
                         return vk::DeviceQueueCreateInfo{
                             .queueFamilyIndex = index,
-                            .queueCount = 1,
-                            .pQueuePriorities = &queuePriority,
+                            .queueCount = vkQueueCount,
+                            .pQueuePriorities = queuePriorities.data(),
                         };
                     }
                     index++;
@@ -311,6 +328,24 @@ namespace skyline::gpu {
         if (!traits.supportsGlobalPriority)
             queueCreateInfo.unlink<vk::DeviceQueueGlobalPriorityCreateInfoEXT>();
 
+        boost::container::small_vector<vk::DeviceQueueCreateInfo, 2> queueCreateInfos{queueCreateInfo.get<vk::DeviceQueueCreateInfo>()};
+        if (traits.supportsTimelineSemaphores) {
+            // A queue family with transfer support but no graphics or compute support is generally backed by a dedicated DMA engine which can run concurrently with the graphics queue
+            decltype(vk::DeviceQueueCreateInfo::queueFamilyIndex) index{};
+            for (const auto &queueFamily : queueFamilies) {
+                if (queueFamily.queueFlags & vk::QueueFlagBits::eTransfer && !(queueFamily.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+                    vkTransferQueueFamilyIndex = index;
+                    queueCreateInfos.push_back(vk::DeviceQueueCreateInfo{
+                        .queueFamilyIndex = index,
+                        .queueCount = 1,
+                        .pQueuePriorities = queuePriorities.data(),
+                    });
+                    break;
+                }
+                index++;
+            }
+        }
+
         if (Logger::configLevel >= Logger::LogLevel::Info) {
             std::string extensionString;
             for (const auto &extension : deviceExtensions)
@@ -318,8 +353,10 @@ namespace skyline::gpu {
 
             std::string queueString;
             u32 familyIndex{};
-            for (const auto &queueFamily : queueFamilies)
-                queueString += util::Format("\n* {}x{}{}{}{}{}: TSB{} MIG({}x{}x{}){}", queueFamily.queueCount, queueFamily.queueFlags & vk::QueueFlagBits::eGraphics ? 'G' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eCompute ? 'C' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eTransfer ? 'T' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eSparseBinding ? 'S' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eProtected ? 'P' : '-', queueFamily.timestampValidBits, queueFamily.minImageTransferGranularity.width, queueFamily.minImageTransferGranularity.height, queueFamily.minImageTransferGranularity.depth, familyIndex++ == vkQueueFamilyIndex ? " <--" : "");
+            for (const auto &queueFamily : queueFamilies) {
+                queueString += util::Format("\n* {}x{}{}{}{}{}: TSB{} MIG({}x{}x{}){}", queueFamily.queueCount, queueFamily.queueFlags & vk::QueueFlagBits::eGraphics ? 'G' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eCompute ? 'C' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eTransfer ? 'T' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eSparseBinding ? 'S' : '-', queueFamily.queueFlags & vk::QueueFlagBits::eProtected ? 'P' : '-', queueFamily.timestampValidBits, queueFamily.minImageTransferGranularity.width, queueFamily.minImageTransferGranularity.height, queueFamily.minImageTransferGranularity.depth, familyIndex == vkQueueFamilyIndex ? " <--" : (familyIndex == vkTransferQueueFamilyIndex ? " <-- (Transfer)" : ""));
+                familyIndex++;
+            }
 
             auto properties{deviceProperties2.get<vk::PhysicalDeviceProperties2>().properties};
             Logger::Info("Vulkan Device:\nName: {}\nType: {}\nDriver ID: {}\nVulkan Version: {}.{}.{}\nDriver Version: {}.{}.{}\nQueues:{}\nExtensions:{}\nTraits:{}\nQuirks:{}",
@@ -332,8 +369,8 @@ namespace skyline::gpu {
 
         return vk::raii::Device(physicalDevice, vk::DeviceCreateInfo{
             .pNext = &enabledFeatures2,
-            .queueCreateInfoCount = 1,
-            .pQueueCreateInfos = &queueCreateInfo.get<vk::DeviceQueueCreateInfo>(),
+            .queueCreateInfoCount = static_cast<u32>(queueCreateInfos.size()),
+            .pQueueCreateInfos = queueCreateInfos.data(),
             .enabledExtensionCount = static_cast<uint32_t>(pEnabledExtensions.size()),
             .ppEnabledExtensionNames = pEnabledExtensions.data(),
         });
@@ -391,7 +428,7 @@ namespace skyline::gpu {
           vkInstance(CreateInstance(state, vkContext)),
           vkDebugReportCallback(CreateDebugReportCallback(this, vkInstance)),
           vkPhysicalDevice(CreatePhysicalDevice(vkInstance)),
-          vkDevice(CreateDevice(vkContext, vkPhysicalDevice, vkQueueFamilyIndex, traits, &adrenotoolsImportMapping)),
+          vkDevice(CreateDevice(vkContext, vkPhysicalDevice, vkQueueFamilyIndex, vkQueueCount, vkTransferQueueFamilyIndex, traits, &adrenotoolsImportMapping)),
           vkQueue(vkDevice, vkQueueFamilyIndex, 0),
           memory(*this),
           scheduler(state, *this),
@@ -402,17 +439,70 @@ namespace skyline::gpu {
           descriptor(*this),
           helperShaders(*this, state.os->assetFileSystem),
           renderPassCache(*this),
-          framebufferCache(*this) {}
+          framebufferCache(*this) {
+        if (vkTransferQueueFamilyIndex)
+            transferQueue.emplace(*this, *vkTransferQueueFamilyIndex);
+
+        if (*state.settings->asyncWriteTracking) {
+            try {
+                writeTracker.emplace();
+            } catch (const exception &e) {
+                Logger::Warn("Asynchronous write tracking is unavailable: {}", e.what());
+            }
+        }
+    }
 
     void GPU::Initialise() {
         std::string titleId{state.loader->nacp->GetSaveDataOwnerId()};
-        graphicsPipelineAssembler.emplace(*this, state.os->publicAppFilesPath + "vk_graphics_pipeline_cache/" + titleId);
+        graphicsPipelineAssembler.emplace(*this, state.os->publicAppFilesPath + "vk_graphics_pipeline_cache/" + titleId, *state.settings->pipelineCompileAffinity);
         shader.emplace(state, *this,
                        state.os->publicAppFilesPath + "shader_replacements/" + titleId,
-                       state.os->publicAppFilesPath + "shader_dumps/" + titleId);
+                       state.os->publicAppFilesPath + "shader_dumps/" + titleId,
+                       *state.settings->disableShaderCache ? std::string{} : state.os->publicAppFilesPath + "spirv_cache/" + titleId);
         if (!*state.settings->disableShaderCache)
             graphicsPipelineCacheManager.emplace(state,
                                                  state.os->publicAppFilesPath + "graphics_pipeline_cache/" + titleId);
+        if (!*state.settings->disableTextureCache)
+            textureCacheManager.emplace(state.os->publicAppFilesPath + "texture_cache/" + titleId + "/");
         graphicsPipelineManager.emplace(*this);
+
+        if (*state.settings->useGpuTextureDeswizzle)
+            calibration.Calibrate(*this, state.os->publicAppFilesPath + "driver_calibration.bin");
+    }
+
+    void GPU::TraceCounters() {
+        if (!TRACE_EVENT_CATEGORY_ENABLED("gpu"))
+            return;
+
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Texture Count"}, texture.GetResidentCount());
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Texture Memory", "bytes"}, texture.GetResidentSize());
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Buffer Count"}, buffer.GetBufferCount());
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Buffer Memory", "bytes"}, buffer.GetBufferSize());
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Scheduler In-Flight Cycles"}, scheduler.GetInFlightCycleCount());
+        if (state.soc)
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"GPFIFO Pending Entries"}, state.soc->pendingGpEntryCount.load(std::memory_order_relaxed));
+
+        auto &channelLockStatistics{channelLock.GetStatistics()};
+        CounterSamples samples{
+            .megaBufferAllocatedSize = megaBufferAllocator.GetAllocatedSize(),
+            .descriptorPoolResetCount = descriptor.GetPoolResetCount(),
+            .channelLockContendedCount = channelLockStatistics.contendedCount.load(std::memory_order_relaxed),
+            .channelLockParkCount = channelLockStatistics.parkCount.load(std::memory_order_relaxed),
+        };
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"MegaBuffer Frame Usage", "bytes"}, samples.megaBufferAllocatedSize - lastCounterSamples.megaBufferAllocatedSize);
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Descriptor Pool Resets"}, samples.descriptorPoolResetCount - lastCounterSamples.descriptorPoolResetCount);
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Channel Lock Contended"}, samples.channelLockContendedCount - lastCounterSamples.channelLockContendedCount);
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Channel Lock Parks"}, samples.channelLockParkCount - lastCounterSamples.channelLockParkCount);
+
+        // The per-title caches are only present after initialisation
+        if (graphicsPipelineAssembler)
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"Pipeline Assembler Queued Jobs"}, graphicsPipelineAssembler->GetQueuedJobCount());
+        if (graphicsPipelineManager) {
+            std::tie(samples.pipelineHitCount, samples.pipelineMissCount) = graphicsPipelineManager->GetLookupCounts();
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"Pipeline Cache Hits"}, samples.pipelineHitCount - lastCounterSamples.pipelineHitCount);
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"Pipeline Cache Misses"}, samples.pipelineMissCount - lastCounterSamples.pipelineMissCount);
+        }
+
+        lastCounterSamples = samples;
     }
 }
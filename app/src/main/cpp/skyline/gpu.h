@@ -4,9 +4,12 @@
 #pragma once
 
 #include <adrenotools/driver.h>
+#include <common/write_tracker.h>
 #include "gpu/trait_manager.h"
+#include "gpu/driver_calibration.h"
 #include "gpu/memory_manager.h"
 #include "gpu/command_scheduler.h"
+#include "gpu/transfer_queue.h"
 #include "gpu/presentation_engine.h"
 #include "gpu/texture_manager.h"
 #include "gpu/buffer_manager.h"
@@ -14,6 +17,7 @@
 #include "gpu/descriptor_allocator.h"
 #include "gpu/shader_manager.h"
 #include "gpu/pipeline_cache_manager.h"
+#include "gpu/texture_cache_manager.h"
 #include "gpu/graphics_pipeline_assembler.h"
 #include "gpu/shaders/helper_shaders.h"
 #include "gpu/cache/renderpass_cache.h"
@@ -34,6 +38,18 @@ namespace skyline::gpu {
         friend Buffer;
         friend BufferManager;
 
+        /**
+         * @brief The values of cumulative statistics at the last frame boundary, these are used to trace the per-frame deltas of them
+         */
+        struct CounterSamples {
+            u64 megaBufferAllocatedSize;
+            u64 pipelineHitCount;
+            u64 pipelineMissCount;
+            u32 descriptorPoolResetCount;
+            u64 channelLockContendedCount;
+            u64 channelLockParkCount;
+        } lastCounterSamples{};
+
       public:
         adrenotools_gpu_mapping adrenotoolsImportMapping{}; //!< Persistent struct to store active adrenotools mapping import info
         vk::raii::Context vkContext;
@@ -41,12 +57,17 @@ namespace skyline::gpu {
         vk::raii::DebugReportCallbackEXT vkDebugReportCallback; //!< An RAII Vulkan debug report manager which calls into 'GPU::DebugCallback'
         vk::raii::PhysicalDevice vkPhysicalDevice;
         u32 vkQueueFamilyIndex{};
+        u32 vkQueueCount{}; //!< The amount of queues created from the graphics queue family, queues other than the first are only used by the command scheduler
+        std::optional<u32> vkTransferQueueFamilyIndex; //!< The index of a queue family dedicated to transfers, this is only present if the device has such a family and supports timeline semaphores
         TraitManager traits;
+        DriverCalibration calibration; //!< The results of benchmarking driver-dependent paths, these are only valid after initialisation
         vk::raii::Device vkDevice;
         std::mutex queueMutex; //!< Synchronizes access to the queue as it is externally synchronized
         vk::raii::Queue vkQueue; //!< A Vulkan Queue supporting graphics and compute operations
+        std::optional<TransferQueue> transferQueue; //!< A queue for asynchronous transfers that run concurrently with the graphics queue, this is only present when there's a dedicated transfer queue family
 
         memory::MemoryManager memory;
+        std::optional<WriteTracker> writeTracker; //!< Tracks CPU writes to buffers with suspended write traps, this is only present when enabled and supported by the host kernel
         CommandScheduler scheduler;
         PresentationEngine presentation;
 
@@ -63,8 +84,9 @@ namespace skyline::gpu {
         cache::RenderPassCache renderPassCache;
         cache::FramebufferCache framebufferCache;
 
-        std::mutex channelLock;
+        AdaptiveMutex channelLock; //!< Synchronizes all channels with each other, this guards the buffer and texture managers alongside all other state shared between channels
         std::optional<PipelineCacheManager> graphicsPipelineCacheManager;
+        std::optional<TextureCacheManager> textureCacheManager;
         std::optional<interconnect::maxwell3d::PipelineManager> graphicsPipelineManager;
         interconnect::kepler_compute::PipelineManager computePipelineManager;
 
@@ -74,5 +96,11 @@ namespace skyline::gpu {
          * @brief Should be called after loader population to initialize the per-title caches
          */
         void Initialise();
+
+        /**
+         * @brief Samples the sizes of caches and queues across the GPU stack into perfetto counter tracks, cumulative statistics are traced as their delta since the last call
+         * @note This is cheap enough to be called at every frame boundary and does nothing unless the "gpu" category is being traced, it must only be called from a single thread
+         */
+        void TraceCounters();
     };
 }
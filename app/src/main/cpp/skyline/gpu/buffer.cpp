@@ -62,6 +62,8 @@ namespace skyline::gpu {
             if (!buffer)
                 return true;
 
+            buffer->usageStatistics.trapCount.fetch_add(1, std::memory_order_relaxed);
+
             std::unique_lock stateLock{buffer->stateMutex, std::try_to_lock};
             if (!stateLock)
                 return false;
@@ -85,12 +87,15 @@ namespace skyline::gpu {
             if (!buffer)
                 return true;
 
+            buffer->usageStatistics.trapCount.fetch_add(1, std::memory_order_relaxed);
+
             std::unique_lock stateLock{buffer->stateMutex, std::try_to_lock};
             if (!stateLock)
                 return false;
 
             if (!buffer->AllCpuBackingWritesBlocked() && buffer->dirtyState != DirtyState::GpuDirty) {
                 buffer->dirtyState = DirtyState::CpuDirty;
+                buffer->partiallyCpuDirty = false;
                 return true;
             }
 
@@ -98,6 +103,7 @@ namespace skyline::gpu {
                 // As opposed to skipping readback as we do for textures, with buffers we can still perform the readback but just without syncinc the GPU
                 // While the read data may be invalid it's still better than nothing and works in most cases
                 memcpy(buffer->mirror.data(), buffer->backing->data(), buffer->mirror.size());
+                buffer->usageStatistics.guestSyncBytes.fetch_add(buffer->mirror.size(), std::memory_order_relaxed);
                 buffer->dirtyState = DirtyState::Clean;
                 return true;
             }
@@ -111,9 +117,45 @@ namespace skyline::gpu {
 
             buffer->SynchronizeGuest(true); // We need to assume the buffer is dirty since we don't know what the guest is writing
             buffer->dirtyState = DirtyState::CpuDirty;
+            buffer->partiallyCpuDirty = false;
 
             return true;
-        });
+        }, guest->size() >= PageTrackingMinimumSize ? nce::NCE::PageWriteCallback{[weakThis](u8 *page) {
+            // Only large buffers are tracked at page granularity as the faults from tracking small buffers would cost more than copying them entirely
+            TRACE_EVENT("gpu", "Buffer::PageWriteTrap");
+            using PageWriteResult = nce::NCE::PageWriteResult;
+
+            auto buffer{weakThis.lock()};
+            if (!buffer)
+                return PageWriteResult::Untrapped;
+
+            buffer->usageStatistics.trapCount.fetch_add(1, std::memory_order_relaxed);
+
+            std::unique_lock stateLock{buffer->stateMutex, std::try_to_lock};
+            if (!stateLock)
+                return PageWriteResult::WouldBlock;
+
+            if (buffer->AllCpuBackingWritesBlocked() || buffer->dirtyState == DirtyState::GpuDirty || (buffer->dirtyState == DirtyState::CpuDirty && !buffer->partiallyCpuDirty))
+                return PageWriteResult::Untrapped; // The write callback will handle any synchronization of the entire buffer
+
+            u8 *base{util::AlignDown(buffer->guest->data(), constant::PageSize)};
+            if (buffer->dirtyState == DirtyState::Clean) {
+                buffer->dirtyState = DirtyState::CpuDirty;
+                buffer->partiallyCpuDirty = true;
+                buffer->cpuDirtyPages.assign(util::DivideCeil(static_cast<size_t>((buffer->guest->data() + buffer->guest->size()) - base), constant::PageSize), false);
+            }
+
+            size_t pageIndex{static_cast<size_t>(page - base) / constant::PageSize};
+            if (pageIndex < buffer->cpuDirtyPages.size())
+                buffer->cpuDirtyPages[pageIndex] = true;
+
+            if (static_cast<size_t>(ranges::count(buffer->cpuDirtyPages, true)) * PageTrackingMaximumDirtyDivisor > buffer->cpuDirtyPages.size()) {
+                buffer->partiallyCpuDirty = false; // There's no benefit to tracking individual pages once a large portion of the buffer is dirty
+                return PageWriteResult::Untrapped;
+            }
+
+            return PageWriteResult::Trapped;
+        }} : nce::NCE::PageWriteCallback{});
     }
 
     void Buffer::InsertWriteIntervalDirect(WriteTrackingInterval entry) {
@@ -381,6 +423,8 @@ namespace skyline::gpu {
         if (dirtyState == DirtyState::GpuDirty)
             return;
 
+        ResumeWriteTraps(); // GPU writes must be tracked, the backing also won't match the last suspended checksum after this
+
         gpu.state.nce->TrapRegions(*trapHandle, false); // This has to occur prior to any synchronization as it'll skip trapping
 
         if (dirtyState == DirtyState::CpuDirty)
@@ -404,20 +448,21 @@ namespace skyline::gpu {
         if (isDirect)
             directBacking = gpu.memory.ImportBuffer(mirror);
         else
-            backing = gpu.memory.AllocateBuffer(mirror.size());
+            backing = gpu.memory.AllocateBuffer(mirror.size(), memory::AllocationCategory::Buffer);
 
         megaBufferTable.resize(guest.size() / (1 << megaBufferTableShift));
     }
 
     Buffer::Buffer(LinearAllocatorState<> &delegateAllocator, GPU &gpu, vk::DeviceSize size, size_t id)
         : gpu{gpu},
-          backing{gpu.memory.AllocateBuffer(size)},
+          backing{gpu.memory.AllocateBuffer(size, memory::AllocationCategory::Buffer)},
           delegate{delegateAllocator.EmplaceUntracked<BufferDelegate>(this)},
           id{id} {
         dirtyState = DirtyState::Clean; // Since this is a host-only buffer it's always going to be clean
     }
 
     Buffer::~Buffer() {
+        ResumeWriteTraps();
         if (trapHandle)
             gpu.state.nce->DeleteTrap(*trapHandle);
         SynchronizeGuest(true);
@@ -458,6 +503,7 @@ namespace skyline::gpu {
     }
 
     void Buffer::Invalidate() {
+        ResumeWriteTraps();
         if (trapHandle) {
             gpu.state.nce->DeleteTrap(*trapHandle);
             trapHandle = {};
@@ -467,27 +513,108 @@ namespace skyline::gpu {
         guest = {};
     }
 
+    void Buffer::ResumeWriteTraps() {
+        writeTrapsSuspended = false;
+        writeTrapStreak = 0;
+        if (writeTrackerHandle) {
+            gpu.writeTracker->Unregister(*writeTrackerHandle);
+            writeTrackerHandle.reset();
+        }
+    }
+
     void Buffer::SynchronizeHost(bool skipTrap) {
         if (!guest || isDirect)
             return;
 
         TRACE_EVENT("gpu", "Buffer::SynchronizeHost");
 
+        std::vector<bool> dirtyPages;
         {
             std::scoped_lock lock{stateMutex};
-            if (dirtyState != DirtyState::CpuDirty)
+            if (dirtyState != DirtyState::CpuDirty) {
+                writeTrapStreak = 0; // The CPU didn't write to the buffer since the last sync
                 return;
+            }
 
-            dirtyState = DirtyState::Clean;
+            if (!writeTrapsSuspended && !skipTrap && !partiallyCpuDirty && mirror.size() <= WriteTrapSuspendMaximumSize && ++writeTrapStreak >= WriteTrapSuspendThreshold) {
+                // Retrapping a buffer that the CPU writes to between every sync only results in a fault and two protection changes per sync, it's cheaper to leave it untrapped and compare checksums
+                writeTrapsSuspended = true;
+                suspendedSyncCount = 0;
+                suspendedChecksum.reset();
+
+                if (gpu.writeTracker) {
+                    try {
+                        writeTrackerHandle = gpu.writeTracker->Register(*guest);
+                    } catch (const exception &e) {
+                        Logger::Debug("Falling back to checksums for suspended buffer: {}", e.what()); // This can occur when the host runs out of VMAs as registration splits them
+                    }
+                }
+            }
+
+            if (writeTrapsSuspended && ++suspendedSyncCount > WriteTrapSuspendWindow)
+                ResumeWriteTraps(); // Retrap the buffer below, it'll be suspended again if the CPU keeps on writing to it
+
+            if (writeTrapsSuspended) {
+                // Any CPU writes are untracked by traps while suspended so the buffer stays CPU dirty, writes are detected prior to copying so any writes during the copy will be picked up by the next sync
+                if (writeTrackerHandle) {
+                    if (!gpu.writeTracker->Consume(*writeTrackerHandle))
+                        return;
+                } else {
+                    auto checksum{XXH64(mirror.data(), mirror.size(), 0)};
+                    if (suspendedChecksum == checksum)
+                        return;
+
+                    suspendedChecksum = checksum;
+                }
+            } else {
+                dirtyState = DirtyState::Clean;
+                if (partiallyCpuDirty)
+                    dirtyPages = std::move(cpuDirtyPages);
+            }
+            partiallyCpuDirty = false;
             WaitOnFence();
 
             AdvanceSequence(); // We are modifying GPU backing contents so advance to the next sequence
 
-            if (!skipTrap)
+            if (!skipTrap && !writeTrapsSuspended)
                 gpu.state.nce->TrapRegions(*trapHandle, true); // Trap any future CPU writes to this buffer, must be done before the memcpy so that any modifications during the copy are tracked
         }
 
-        std::memcpy(backing->data(), mirror.data(), mirror.size());
+        if (dirtyPages.empty()) {
+            std::memcpy(backing->data(), mirror.data(), mirror.size());
+            usageStatistics.hostSyncBytes.fetch_add(mirror.size(), std::memory_order_relaxed);
+            return;
+        }
+
+        // Only copy runs of contiguous dirty pages, the offsets of the pages need to be clamped to the guest mapping as it isn't necessarily page-aligned
+        size_t baseOffset{static_cast<size_t>(guest->data() - util::AlignDown(guest->data(), constant::PageSize))};
+        for (size_t page{}; page < dirtyPages.size();) {
+            if (!dirtyPages[page]) {
+                page++;
+                continue;
+            }
+
+            size_t runEnd{page + 1};
+            while (runEnd < dirtyPages.size() && dirtyPages[runEnd])
+                runEnd++;
+
+            size_t offset{(page * constant::PageSize) > baseOffset ? (page * constant::PageSize) - baseOffset : 0};
+            size_t end{std::min((runEnd * constant::PageSize) - baseOffset, mirror.size())};
+            if (offset < end) {
+                std::memcpy(backing->data() + offset, mirror.data() + offset, end - offset);
+                usageStatistics.hostSyncBytes.fetch_add(end - offset, std::memory_order_relaxed);
+            }
+
+            page = runEnd;
+        }
+    }
+
+    bool Buffer::IsGpuDirty() {
+        if (isDirect)
+            return RefreshGpuWritesActiveDirect();
+
+        std::scoped_lock lock{stateMutex};
+        return dirtyState == DirtyState::GpuDirty;
     }
 
     bool Buffer::SynchronizeGuest(bool skipTrap, bool nonBlocking) {
@@ -507,6 +634,7 @@ namespace skyline::gpu {
 
             WaitOnFence();
             std::memcpy(mirror.data(), backing->data(), mirror.size());
+            usageStatistics.guestSyncBytes.fetch_add(mirror.size(), std::memory_order_relaxed);
 
             dirtyState = DirtyState::Clean;
         }
@@ -538,6 +666,7 @@ namespace skyline::gpu {
     bool Buffer::Write(span<u8> data, vk::DeviceSize offset, const std::function<void()> &gpuCopyCallback) {
         AdvanceSequence(); // We are modifying GPU backing contents so advance to the next sequence
         everHadInlineUpdate = true;
+        usageStatistics.sequencedWriteCount.fetch_add(1, std::memory_order_relaxed);
 
         if (isDirect)
             return WriteImplDirect(data, offset, gpuCopyCallback);
@@ -548,6 +677,7 @@ namespace skyline::gpu {
     void Buffer::CopyFrom(vk::DeviceSize dstOffset, Buffer *src, vk::DeviceSize srcOffset, vk::DeviceSize size, const std::function<void()> &gpuCopyCallback) {
         AdvanceSequence(); // We are modifying GPU backing contents so advance to the next sequence
         everHadInlineUpdate = true;
+        usageStatistics.sequencedWriteCount.fetch_add(1, std::memory_order_relaxed);
 
         if (isDirect)
             CopyFromImplDirect(dstOffset, src, srcOffset, size, gpuCopyCallback);
@@ -567,7 +697,7 @@ namespace skyline::gpu {
     }
 
     BufferBinding Buffer::TryMegaBufferView(const std::shared_ptr<FenceCycle> &pCycle, MegaBufferAllocator &allocator, ContextTag executionTag,
-                                            vk::DeviceSize offset, vk::DeviceSize size) {
+                                            vk::DeviceSize offset, vk::DeviceSize size, bool cacheContents) {
         if (!ValidateMegaBufferView(size))
             return {};
 
@@ -582,6 +712,7 @@ namespace skyline::gpu {
             if (!unifiedMegaBuffer) {
                 unifiedMegaBuffer = allocator.Push(pCycle, mirror, true);
                 unifiedMegaBufferEnabled = true;
+                usageStatistics.megaBufferedBytes.fetch_add(mirror.size(), std::memory_order_relaxed);
             }
 
             return BufferBinding{unifiedMegaBuffer.buffer, unifiedMegaBuffer.offset + offset, size};
@@ -605,10 +736,11 @@ namespace skyline::gpu {
         if (!megaBufferTableValidity.test(entryIdx) || allocation.region.size() < (size + entryViewOffset)) {
             // Use max(oldSize, newSize) to avoid redundant reallocations within an execution if a larger allocation comes along later
             auto mirrorAllocationRegion{mirror.subspan(bufferEntryOffset, std::max(entryViewOffset + size, allocation.region.size()))};
-            allocation = allocator.Push(pCycle, mirrorAllocationRegion, true);
+            allocation = cacheContents ? allocator.PushCached(pCycle, mirrorAllocationRegion, true) : allocator.Push(pCycle, mirrorAllocationRegion, true);
             megaBufferTableValidity.set(entryIdx);
             megaBufferViewAccumulatedSize += mirrorAllocationRegion.size();
             megaBufferTableUsed = true;
+            usageStatistics.megaBufferedBytes.fetch_add(mirrorAllocationRegion.size(), std::memory_order_relaxed);
         }
 
         return {allocation.buffer, allocation.offset + entryViewOffset, size};
@@ -706,6 +838,11 @@ namespace skyline::gpu {
         return offset + delegate->GetOffset();
     }
 
+    span<u8> BufferView::GetGuestSpan() const {
+        auto buffer{GetBuffer()};
+        return buffer->guest ? buffer->guest->subspan(GetOffset(), size) : span<u8>{};
+    }
+
     void BufferView::Read(bool isFirstUsage, const std::function<void()> &flushHostCallback, span<u8> data, vk::DeviceSize readOffset) const {
         GetBuffer()->Read(isFirstUsage, flushHostCallback, data, readOffset + GetOffset());
     }
@@ -714,8 +851,8 @@ namespace skyline::gpu {
         return GetBuffer()->Write(data, writeOffset + GetOffset(), gpuCopyCallback);
     }
 
-    BufferBinding BufferView::TryMegaBuffer(const std::shared_ptr<FenceCycle> &pCycle, MegaBufferAllocator &allocator, ContextTag executionTag, size_t sizeOverride) const {
-        return GetBuffer()->TryMegaBufferView(pCycle, allocator, executionTag, GetOffset(), sizeOverride ? sizeOverride : size);
+    BufferBinding BufferView::TryMegaBuffer(const std::shared_ptr<FenceCycle> &pCycle, MegaBufferAllocator &allocator, ContextTag executionTag, size_t sizeOverride, bool cacheContents) const {
+        return GetBuffer()->TryMegaBufferView(pCycle, allocator, executionTag, GetOffset(), sizeOverride ? sizeOverride : size, cacheContents);
     }
 
     span<u8> BufferView::GetReadOnlyBackingSpan(bool isFirstUsage, const std::function<void()> &flushHostCallback) {
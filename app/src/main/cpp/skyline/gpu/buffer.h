@@ -6,6 +6,7 @@
 #include <boost/functional/hash.hpp>
 #include <common/linear_allocator.h>
 #include <common/spin_lock.h>
+#include <common/write_tracker.h>
 #include <nce.h>
 #include <gpu/tag_allocator.h>
 #include "megabuffer.h"
@@ -71,6 +72,8 @@ namespace skyline::gpu {
             CpuDirty, //!< The CPU mappings have been modified but the GPU buffer is not up to date
             GpuDirty, //!< The GPU buffer has been modified but the CPU mappings have not been updated
         } dirtyState{DirtyState::CpuDirty}; //!< (Staged) The state of the CPU mappings with respect to the GPU buffer
+        std::vector<bool> cpuDirtyPages; //!< (Staged) A bitmap of all pages spanned by the guest mapping (starting from its page-aligned base) that have been written to by the CPU, this is only valid when `partiallyCpuDirty` is set
+        bool partiallyCpuDirty{}; //!< (Staged) If the buffer is CPU dirty but only the pages in `cpuDirtyPages` have been modified, the rest of the buffer is in sync with the GPU
         bool directGpuWritesActive{}; //!< (Direct) If the current/next GPU exection is writing to the buffer (basically GPU dirty)
 
         enum class BackingImmutability {
@@ -84,6 +87,18 @@ namespace skyline::gpu {
         static constexpr u32 FrequentlySyncedThreshold{6}; //!< Threshold for the sequence number after which the buffer is considered elegible for megabuffering
         u32 sequenceNumber{InitialSequenceNumber}; //!< Sequence number that is incremented after all modifications to the host side `backing` buffer, used to prevent redundant copies of the buffer being stored in the megabuffer by views
 
+        static constexpr size_t PageTrackingMinimumSize{0x10000}; //!< (Staged) The minimum size of a buffer for CPU writes to be tracked at page granularity, smaller buffers are always entirely resynchronized
+        static constexpr size_t PageTrackingMaximumDirtyDivisor{4}; //!< (Staged) Page tracking is abandoned once more than 1/Nth of a buffer's pages are dirty as the faults would outweigh the cost of a full copy
+
+        static constexpr u32 WriteTrapSuspendThreshold{8}; //!< (Staged) The amount of consecutive host syncs that each had to synchronize CPU writes before write traps on the buffer are suspended
+        static constexpr u32 WriteTrapSuspendWindow{64}; //!< (Staged) The amount of host syncs that write traps remain suspended for, the buffer is retrapped after this to determine if it's still being streamed to
+        static constexpr size_t WriteTrapSuspendMaximumSize{0x100000}; //!< (Staged) The maximum size of a buffer for its write traps to be suspended, as the entire buffer is hashed on every sync while suspended
+        u32 writeTrapStreak{}; //!< (Staged) The amount of consecutive host syncs that had to synchronize CPU writes
+        bool writeTrapsSuspended{}; //!< (Staged) If the buffer is left untrapped as the CPU writes to it between every sync, it remains CPU dirty during this and host syncs only copy it when its checksum changes
+        u32 suspendedSyncCount{}; //!< (Staged) The amount of host syncs since write traps were suspended
+        std::optional<u64> suspendedChecksum; //!< (Staged) The XXH64 hash of the mirror at the last host sync while write traps were suspended
+        std::optional<WriteTracker::RangeHandle> writeTrackerHandle; //!< (Staged) The range of the guest mapping in the GPU's write tracker while write traps are suspended, this replaces comparing checksums when present
+
         constexpr static vk::DeviceSize MegaBufferingDisableThreshold{1024 * 256}; //!< The threshold at which a view is considered to be too large to be megabuffered (256KiB)
 
         static constexpr int MegaBufferTableShiftMin{std::countr_zero(0x100U)}; //!< The minimum shift for megabuffer table entries, giving an alignment of at least 256 bytes
@@ -94,6 +109,20 @@ namespace skyline::gpu {
         bool megaBufferTableUsed{}; //!< If the megabuffer table has been used at all since the last time it was cleared
         bool unifiedMegaBufferEnabled{}; //!< If the unified megabuffer is enabled for this buffer and should be used instead of the table
         bool everHadInlineUpdate{}; //!< Whether the buffer has ever had an inline update since it was created, if this is set then megabuffering will be attempted by views to avoid the cost of inline GPU updates
+        u32 coalesceCount{}; //!< The amount of successive coalesces that have led to this buffer being created, this is used by the buffer manager to detect guest ranges that are repeatedly merged
+
+        /**
+         * @brief Counters of the synchronization and usage activity of a buffer, these are aggregated and reported by the buffer manager to find the buffers responsible for the most overhead
+         * @note These are atomic as the traps update them outside of the buffer lock, relaxed ordering is sufficient as they're only used for reporting
+         */
+        struct UsageStatistics {
+            std::atomic<u64> hostSyncBytes{}; //!< The amount of bytes copied from the mirror into the backing
+            std::atomic<u64> guestSyncBytes{}; //!< The amount of bytes copied from the backing into the mirror
+            std::atomic<u64> megaBufferedBytes{}; //!< The amount of bytes of the buffer that were pushed into the megabuffer
+            std::atomic<u32> trapCount{}; //!< The amount of guest accesses to the buffer that were trapped
+            std::atomic<u32> sequencedWriteCount{}; //!< The amount of sequenced writes and copies into the buffer
+            std::atomic<u32> mergeCount{}; //!< The amount of buffers that were merged to create this buffer, including any buffers merged into those
+        } usageStatistics;
 
         ContextTag lastExecutionTag{}; //!< The execution tag of the last time megabuffer data was updated
 
@@ -126,6 +155,11 @@ namespace skyline::gpu {
 
         void SetupStagedTraps();
 
+        /**
+         * @brief Stops suspending write traps on the buffer, the buffer will be retrapped at the next host sync
+         */
+        void ResumeWriteTraps();
+
         /**
          * @brief Forces future accesses to the given interval to use the shadow copy
          */
@@ -315,6 +349,23 @@ namespace skyline::gpu {
             return SequencedCpuBackingWritesBlocked();
         }
 
+        /**
+         * @return A pair of the unique ID of the buffer and its current sequence number, together these identify the current contents of the backing
+         * @note This is not valid for direct buffers as their backing can be modified by the guest without a sequence change, an empty optional is returned for them
+         * @note The buffer **must** be locked prior to calling this
+         */
+        std::optional<std::pair<size_t, u32>> GetContentVersion() const {
+            if (isDirect)
+                return std::nullopt;
+            return std::make_pair(id, sequenceNumber);
+        }
+
+        /**
+         * @return If the GPU may have written to the buffer without the guest mappings being updated, reading the guest mappings on the CPU would require waiting on the GPU in that case
+         * @note The buffer **must** be locked prior to calling this
+         */
+        bool IsGpuDirty();
+
         /**
          * @return If the buffer is frequently locked by threads using non-ContextLocks
          */
@@ -400,11 +451,12 @@ namespace skyline::gpu {
 
         /*
          * @brief If megabuffering is determined to be beneficial for this buffer, allocates and copies the given view of buffer into the megabuffer (in case of cache miss), returning a binding of the allocated megabuffer region
+         * @param cacheContents If the megabuffer allocation should be looked up by its contents so identical data from prior sequences can be reused, this should only be used for small frequently updated views such as constant buffers
          * @return A binding to the megabuffer allocation for the view, may be invalid if megabuffering is not beneficial
          * @note The buffer **must** be locked prior to calling this
          */
         BufferBinding TryMegaBufferView(const std::shared_ptr<FenceCycle> &pCycle, MegaBufferAllocator &allocator, ContextTag executionTag,
-                                        vk::DeviceSize offset, vk::DeviceSize size);
+                                        vk::DeviceSize offset, vk::DeviceSize size, bool cacheContents = false);
 
         /**
          * @brief Increments the sequence number of the buffer, any futher calls to AcquireCurrentSequence will return this new sequence number. See the comment for `sequenceNumber`
@@ -492,6 +544,12 @@ namespace skyline::gpu {
          */
         vk::DeviceSize GetOffset() const;
 
+        /**
+         * @return The guest memory backing the view, this is empty for views into host-only buffers
+         * @note The view **must** be locked prior to calling this
+         */
+        span<u8> GetGuestSpan() const;
+
         /**
          * @return A binding describing the underlying buffer state at a given moment in time
          * @note The view **must** be locked prior to calling this
@@ -544,7 +602,7 @@ namespace skyline::gpu {
          * @note The view **must** be locked prior to calling this
          * @note See Buffer::TryMegaBufferView
          */
-        BufferBinding TryMegaBuffer(const std::shared_ptr<FenceCycle> &pCycle, MegaBufferAllocator &allocator, ContextTag executionTag, size_t sizeOverride = 0) const;
+        BufferBinding TryMegaBuffer(const std::shared_ptr<FenceCycle> &pCycle, MegaBufferAllocator &allocator, ContextTag executionTag, size_t sizeOverride = 0, bool cacheContents = false) const;
 
         /**
          * @return A span of the backing buffer contents
@@ -563,5 +621,10 @@ namespace skyline::gpu {
         constexpr operator bool() {
             return delegate != nullptr;
         }
+
+        /**
+         * @note Views of the same range are only equal if they're through the same delegate
+         */
+        constexpr bool operator==(const BufferView &other) const = default;
     };
 }
@@ -3,10 +3,11 @@
 
 #include <common/settings.h>
 #include <gpu.h>
+#include <kernel/types/KProcess.h>
 #include "buffer_manager.h"
 
 namespace skyline::gpu {
-    BufferManager::BufferManager(GPU &gpu) : gpu{gpu} {}
+    BufferManager::BufferManager(GPU &gpu) : gpu{gpu}, directMemoryImport{*gpu.state.settings->useDirectMemoryImport && gpu.traits.SupportsDirectMemoryImport()} {}
 
     bool BufferManager::BufferLessThan(const std::shared_ptr<Buffer> &it, u8 *pointer) {
         return it->guest->begin().base() < pointer;
@@ -32,11 +33,28 @@ namespace skyline::gpu {
             return overlaps;
         }
 
-        // If we cannot find the buffer quickly, do a binary search to find all overlapping buffers
-        auto entryIt{std::lower_bound(bufferMappings.begin(), bufferMappings.end(), range.end().base(), BufferLessThan)};
-        while (entryIt != bufferMappings.begin() && (*--entryIt)->guest->begin() <= range.end())
-            if ((*entryIt)->guest->end() > range.begin())
-                overlaps.emplace_back(*entryIt, tag);
+        if (range.size() <= TableWalkMaxSize) {
+            // Small ranges can be resolved by walking the page table, any buffers found can be skipped over entirely as buffers never overlap
+            for (auto address{range.begin().base()}; address < range.end().base();) {
+                if (auto buffer{bufferTable[address]}; buffer != nullptr) {
+                    overlaps.emplace_back(buffer->shared_from_this(), tag);
+                    address = buffer->guest->end().base();
+                } else {
+                    address = util::AlignDown(address, constant::PageSize) + constant::PageSize;
+                }
+            }
+
+            return overlaps;
+        }
+
+        // If the range is too large to walk, do a binary search to find the last overlapping buffer and walk backwards till the first, since buffers never overlap this can stop at the first buffer which ends before the range
+        auto endIt{std::lower_bound(bufferMappings.begin(), bufferMappings.end(), range.end().base(), BufferLessThan)};
+        auto startIt{endIt};
+        while (startIt != bufferMappings.begin() && (*std::prev(startIt))->guest->end() > range.begin())
+            startIt--;
+
+        for (auto entryIt{startIt}; entryIt != endIt; entryIt++)
+            overlaps.emplace_back(*entryIt, tag);
 
         return overlaps;
     }
@@ -44,19 +62,35 @@ namespace skyline::gpu {
     void BufferManager::InsertBuffer(std::shared_ptr<Buffer> buffer) {
         auto bufferStart{buffer->guest->begin().base()}, bufferEnd{buffer->guest->end().base()};
         bufferTable.Set(bufferStart, bufferEnd, buffer.get());
+        bufferCount.fetch_add(1, std::memory_order_relaxed);
+        bufferSize.fetch_add(buffer->guest->size(), std::memory_order_relaxed);
         bufferMappings.insert(std::lower_bound(bufferMappings.begin(), bufferMappings.end(), bufferEnd, BufferLessThan), std::move(buffer));
     }
 
     void BufferManager::DeleteBuffer(const std::shared_ptr<Buffer> &buffer) {
         bufferTable.Set(buffer->guest->begin().base(), buffer->guest->end().base(), nullptr);
+        bufferCount.fetch_sub(1, std::memory_order_relaxed);
+        bufferSize.fetch_sub(buffer->guest->size(), std::memory_order_relaxed);
         bufferMappings.erase(std::find(bufferMappings.begin(), bufferMappings.end(), buffer));
     }
 
+    span<u8> BufferManager::GetPaddedCoalesceRange(span<u8> range) {
+        auto &memory{gpu.state.process->memory};
+        auto startChunk{memory.Get(range.begin().base())}, endChunk{memory.Get(range.end().base() - 1)};
+        if (!startChunk || !endChunk)
+            return range;
+
+        // Padding must never shrink the range, it's only clamped to the chunks so buffers don't extend beyond the guest mapping they were created from
+        auto paddedStart{std::min(std::max(util::AlignDown(range.begin().base(), CoalescePaddingGranularity), startChunk->ptr), range.begin().base())};
+        auto paddedEnd{std::max(std::min(util::AlignUp(range.end().base(), CoalescePaddingGranularity), endChunk->ptr + endChunk->size), range.end().base())};
+        return span<u8>{paddedStart, paddedEnd};
+    }
+
     BufferManager::LockedBuffer BufferManager::CoalesceBuffers(span<u8> range, const LockedBuffers &srcBuffers, ContextTag tag) {
         std::shared_ptr<FenceCycle> newBufferCycle{};
         for (auto &srcBuffer : srcBuffers) {
             // Since new direct buffers will share the underlying backing of source buffers we don't need to wait for the GPU if they're dirty, for non direct buffers we do though as otherwise we won't be able to migrate their contents to the new backing
-            if (!*gpu.state.settings->useDirectMemoryImport && (srcBuffer->dirtyState == Buffer::DirtyState::GpuDirty || srcBuffer->AllCpuBackingWritesBlocked()))
+            if (!directMemoryImport && (srcBuffer->dirtyState == Buffer::DirtyState::GpuDirty || srcBuffer->AllCpuBackingWritesBlocked()))
                 srcBuffer->WaitOnFence();
 
             // We can't chain cycles here as that may also introduce a deadlock since we have no way to determine what order to chain them in right now
@@ -81,7 +115,7 @@ namespace skyline::gpu {
                 highestAddress = mapping.end().base();
         }
 
-        LockedBuffer newBuffer{std::make_shared<Buffer>(delegateAllocatorState, gpu, span<u8>{lowestAddress, highestAddress}, nextBufferId++, *gpu.state.settings->useDirectMemoryImport), tag}; // If we don't lock the buffer prior to trapping it during synchronization, a race could occur with a guest trap acquiring the lock before we do and mutating the buffer prior to it being ready
+        LockedBuffer newBuffer{MakePooledShared<Buffer>(delegateAllocatorState, gpu, span<u8>{lowestAddress, highestAddress}, nextBufferId++, directMemoryImport), tag}; // If we don't lock the buffer prior to trapping it during synchronization, a race could occur with a guest trap acquiring the lock before we do and mutating the buffer prior to it being ready
 
         newBuffer->SetupStagedTraps();
         newBuffer->SynchronizeHost(false); // Overlaps don't necessarily fully cover the buffer so we have to perform a sync here to prevent any gaps
@@ -100,6 +134,16 @@ namespace skyline::gpu {
         }}; //!< Copies between two buffers based off of their mappings in guest memory
 
         for (auto &srcBuffer : srcBuffers) {
+            newBuffer->coalesceCount = std::max(newBuffer->coalesceCount, srcBuffer->coalesceCount + 1);
+
+            auto &srcStatistics{srcBuffer->usageStatistics}, &newStatistics{newBuffer->usageStatistics};
+            newStatistics.hostSyncBytes += srcStatistics.hostSyncBytes;
+            newStatistics.guestSyncBytes += srcStatistics.guestSyncBytes;
+            newStatistics.megaBufferedBytes += srcStatistics.megaBufferedBytes;
+            newStatistics.trapCount += srcStatistics.trapCount;
+            newStatistics.sequencedWriteCount += srcStatistics.sequencedWriteCount;
+            newStatistics.mergeCount += srcStatistics.mergeCount + 1;
+
             // All newly created buffers that have this set are guaranteed to be attached in buffer FindOrCreate, attach will then lock the buffer without resetting this flag, which will only finally be reset when the lock is released
             if (newBuffer->backingImmutability == Buffer::BackingImmutability::None && srcBuffer->backingImmutability != Buffer::BackingImmutability::None)
                 newBuffer->backingImmutability = srcBuffer->backingImmutability;
@@ -108,7 +152,7 @@ namespace skyline::gpu {
 
             newBuffer->everHadInlineUpdate |= srcBuffer->everHadInlineUpdate;
 
-            if (!*gpu.state.settings->useDirectMemoryImport) {
+            if (!directMemoryImport) {
                 if (srcBuffer->dirtyState == Buffer::DirtyState::GpuDirty) {
                     if (srcBuffer.lock.IsFirstUsage() && newBuffer->dirtyState != Buffer::DirtyState::GpuDirty)
                         copyBuffer(*newBuffer->guest, *srcBuffer->guest, newBuffer->mirror.data(), srcBuffer->backing->data());
@@ -160,9 +204,19 @@ namespace skyline::gpu {
                 return firstOverlap->GetView(static_cast<vk::DeviceSize>(guestMapping.begin() - firstOverlap->guest->begin()), guestMapping.size());
         }
 
+        if (ranges::any_of(overlaps, [](const auto &overlap) { return overlap->coalesceCount >= FrequentlyCoalescedThreshold; })) {
+            // Guest ranges that keep getting coalesced are typically streamed into, rather than merging again on every new neighbouring view we can pad the new buffer out so future views fall entirely within it
+            auto paddedGuestMapping{GetPaddedCoalesceRange(alignedGuestMapping)};
+            if (paddedGuestMapping.data() != alignedGuestMapping.data() || paddedGuestMapping.size() != alignedGuestMapping.size()) {
+                overlaps.clear(); // The locks on the overlaps must be released prior to looking them up again as they'll be a subset of the padded overlaps
+                overlaps = Lookup(paddedGuestMapping, tag);
+                alignedGuestMapping = paddedGuestMapping;
+            }
+        }
+
         if (overlaps.empty()) {
             // If we couldn't find any overlapping buffers, create a new buffer without coalescing
-            LockedBuffer buffer{std::make_shared<Buffer>(delegateAllocatorState, gpu, alignedGuestMapping, nextBufferId++, *gpu.state.settings->useDirectMemoryImport), tag};
+            LockedBuffer buffer{MakePooledShared<Buffer>(delegateAllocatorState, gpu, alignedGuestMapping, nextBufferId++, directMemoryImport), tag};
             buffer->SetupStagedTraps();
             InsertBuffer(*buffer);
             return buffer->GetView(static_cast<vk::DeviceSize>(guestMapping.begin() - buffer->guest->begin()), guestMapping.size());
@@ -188,4 +242,60 @@ namespace skyline::gpu {
             return buffer->GetView(static_cast<vk::DeviceSize>(guestMapping.begin() - buffer->guest->begin()), guestMapping.size());
         }
     }
+
+    void BufferManager::ReportStatistics() {
+        bool tracing{TRACE_EVENT_CATEGORY_ENABLED("gpu")}, logging{Logger::configLevel >= Logger::LogLevel::Debug};
+        if (!tracing && !logging)
+            return;
+
+        i64 now{util::GetTimeNs()};
+        bool updateCounters{tracing && now - lastStatisticsCounterTime >= StatisticsCounterInterval};
+        bool dump{logging && now - lastStatisticsDumpTime >= StatisticsDumpInterval};
+        if (!updateCounters && !dump)
+            return;
+
+        u64 hostSyncBytes{}, guestSyncBytes{}, megaBufferedBytes{}, trapCount{}, sequencedWriteCount{}, mergeCount{};
+        for (const auto &buffer : bufferMappings) {
+            auto &statistics{buffer->usageStatistics};
+            hostSyncBytes += statistics.hostSyncBytes.load(std::memory_order_relaxed);
+            guestSyncBytes += statistics.guestSyncBytes.load(std::memory_order_relaxed);
+            megaBufferedBytes += statistics.megaBufferedBytes.load(std::memory_order_relaxed);
+            trapCount += statistics.trapCount.load(std::memory_order_relaxed);
+            sequencedWriteCount += statistics.sequencedWriteCount.load(std::memory_order_relaxed);
+            mergeCount += statistics.mergeCount.load(std::memory_order_relaxed);
+        }
+
+        if (updateCounters) {
+            lastStatisticsCounterTime = now;
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"Buffer Host Sync", "bytes"}, hostSyncBytes);
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"Buffer Guest Sync", "bytes"}, guestSyncBytes);
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"Buffer Megabuffered", "bytes"}, megaBufferedBytes);
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"Buffer Traps"}, trapCount);
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"Buffer Sequenced Writes"}, sequencedWriteCount);
+            TRACE_COUNTER("gpu", perfetto::CounterTrack{"Buffer Merges"}, mergeCount);
+        }
+
+        if (dump) {
+            lastStatisticsDumpTime = now;
+
+            auto syncTraffic{[](const std::shared_ptr<Buffer> &buffer) {
+                return buffer->usageStatistics.hostSyncBytes.load(std::memory_order_relaxed) + buffer->usageStatistics.guestSyncBytes.load(std::memory_order_relaxed);
+            }};
+
+            std::vector<std::shared_ptr<Buffer>> heaviestBuffers;
+            ranges::copy_if(bufferMappings, std::back_inserter(heaviestBuffers), [&](const std::shared_ptr<Buffer> &buffer) { return syncTraffic(buffer) != 0 || buffer->usageStatistics.trapCount.load(std::memory_order_relaxed) != 0; });
+            auto dumpCount{std::min(heaviestBuffers.size(), StatisticsDumpBufferCount)};
+            ranges::partial_sort(heaviestBuffers, heaviestBuffers.begin() + static_cast<ssize_t>(dumpCount), [&](const auto &a, const auto &b) { return syncTraffic(a) > syncTraffic(b); });
+
+            Logger::Debug("Buffer statistics: {} buffers, host sync: 0x{:X} bytes, guest sync: 0x{:X} bytes, megabuffered: 0x{:X} bytes, traps: {}, sequenced writes: {}, merges: {}", bufferMappings.size(), hostSyncBytes, guestSyncBytes, megaBufferedBytes, trapCount, sequencedWriteCount, mergeCount);
+            for (size_t i{}; i < dumpCount; i++) {
+                auto &buffer{heaviestBuffers[i]};
+                auto &statistics{buffer->usageStatistics};
+                Logger::Debug("* Buffer 0x{}-0x{} (0x{:X} bytes{}): host sync: 0x{:X} bytes, guest sync: 0x{:X} bytes, megabuffered: 0x{:X} bytes, traps: {}, sequenced writes: {}, merges: {}",
+                              buffer->guest->begin().base(), buffer->guest->end().base(), buffer->guest->size(), buffer->isDirect ? ", direct" : "",
+                              statistics.hostSyncBytes.load(std::memory_order_relaxed), statistics.guestSyncBytes.load(std::memory_order_relaxed), statistics.megaBufferedBytes.load(std::memory_order_relaxed),
+                              statistics.trapCount.load(std::memory_order_relaxed), statistics.sequencedWriteCount.load(std::memory_order_relaxed), statistics.mergeCount.load(std::memory_order_relaxed));
+            }
+        }
+    }
 }
@@ -16,11 +16,23 @@ namespace skyline::gpu {
       private:
         GPU &gpu;
         std::vector<std::shared_ptr<Buffer>> bufferMappings; //!< A sorted vector of all buffer mappings
+        std::atomic<size_t> bufferCount{}; //!< The amount of buffers in `bufferMappings`, this is atomic so it can be sampled without locking the buffer manager
+        std::atomic<size_t> bufferSize{}; //!< The combined guest size of all buffers in `bufferMappings` in bytes
         LinearAllocatorState<> delegateAllocatorState; //!< Linear allocator used to allocate buffer delegates
         size_t nextBufferId{}; //!< The next unique buffer id to be assigned
 
         static constexpr size_t L2EntryGranularity{19}; //!< The amount of AS (in bytes) a single L2 PTE covers (512 KiB == 1 << 19)
         SegmentTable<Buffer *, constant::AddressSpaceSize, constant::PageSizeBits, L2EntryGranularity> bufferTable; //!< A page table of all buffer mappings for O(1) lookups on full matches
+        static constexpr size_t TableWalkMaxSize{0x100000}; //!< The maximum size of a range that'll be looked up by walking `bufferTable` page-by-page rather than a binary search of `bufferMappings` (1MiB)
+
+        static constexpr u32 FrequentlyCoalescedThreshold{3}; //!< The amount of successive coalesces a buffer needs to have been created from before any further coalesces with it are padded
+        static constexpr size_t CoalescePaddingGranularity{1ULL << L2EntryGranularity}; //!< The granularity that buffers created from frequently coalesced buffers are padded out to, so that neighbouring views will fall within the buffer rather than causing another coalesce
+
+        static constexpr i64 StatisticsCounterInterval{constant::NsInSecond / 4}; //!< The minimum interval between updates of the buffer usage counter tracks
+        static constexpr i64 StatisticsDumpInterval{constant::NsInSecond * 30}; //!< The interval between dumps of the buffers with the most synchronization traffic to the log
+        static constexpr size_t StatisticsDumpBufferCount{8}; //!< The amount of buffers that are included in a dump of the buffer usage statistics
+        i64 lastStatisticsCounterTime{}; //!< The timestamp of the last update of the buffer usage counter tracks
+        i64 lastStatisticsDumpTime{}; //!< The timestamp of the last dump of the buffer usage statistics
 
         /**
          * @brief A wrapper around a Buffer which locks it with the specified ContextTag
@@ -40,7 +52,7 @@ namespace skyline::gpu {
         using LockedBuffers = boost::container::small_vector<LockedBuffer, 4>;
 
         /**
-         * @return A vector of buffers locked with the supplied tag which are contained within the supplied range
+         * @return A vector of buffers locked with the supplied tag which are contained within the supplied range, sorted by their guest address
          */
         LockedBuffers Lookup(span<u8> range, ContextTag tag);
 
@@ -56,6 +68,11 @@ namespace skyline::gpu {
          */
         void DeleteBuffer(const std::shared_ptr<Buffer> &buffer);
 
+        /**
+         * @return The supplied range padded out to `CoalescePaddingGranularity`, the padding is limited to the guest memory chunks that the range starts and ends in
+         */
+        span<u8> GetPaddedCoalesceRange(span<u8> range);
+
         /**
          * @brief Coalesce the supplied buffers into a single buffer encompassing the specified range and locks it with the supplied tag
          * @param range The range of memory that the newly created buffer will cover, this will be extended to cover the entirety of the supplied buffers automatically and can be null
@@ -69,10 +86,19 @@ namespace skyline::gpu {
         static bool BufferLessThan(const std::shared_ptr<Buffer> &it, u8 *pointer);
 
       public:
-        SpinLock recreationMutex;
+        AdaptiveMutex recreationMutex;
+        const bool directMemoryImport; //!< If buffers directly import their guest mappings as their backing rather than staging them in a separate host buffer, this requires the setting to be enabled and the host to support importing memory
 
         BufferManager(GPU &gpu);
 
+        size_t GetBufferCount() const {
+            return bufferCount.load(std::memory_order_relaxed);
+        }
+
+        size_t GetBufferSize() const {
+            return bufferSize.load(std::memory_order_relaxed);
+        }
+
         /**
          * @brief Acquires an exclusive lock on the texture for the calling thread
          * @note Naming is in accordance to the BasicLockable named requirement
@@ -98,6 +124,12 @@ namespace skyline::gpu {
          */
         BufferView FindOrCreateImpl(GuestBuffer guestMapping, ContextTag tag, const std::function<void(std::shared_ptr<Buffer>, ContextLock<Buffer> &&)> &attachBuffer);
 
+        /**
+         * @brief Reports the aggregated usage statistics of all buffers as perfetto counter tracks and periodically dumps the buffers with the most synchronization traffic to the log
+         * @note This is rate-limited internally so it can be called at a high frequency, it **must** be called from the thread that owns the buffer manager
+         */
+        void ReportStatistics();
+
         BufferView FindOrCreate(GuestBuffer guestMapping, ContextTag tag = {}, const std::function<void(std::shared_ptr<Buffer>, ContextLock<Buffer> &&)> &attachBuffer = {}) {
             auto lookupBuffer{bufferTable[guestMapping.begin().base()]};
             if (lookupBuffer != nullptr)
@@ -106,5 +138,16 @@ namespace skyline::gpu {
 
             return FindOrCreateImpl(guestMapping, tag, attachBuffer);
         }
+
+        /**
+         * @return A view into a pre-existing buffer that contains the supplied mapping or an empty view if there's no such buffer
+         * @note Unlike FindOrCreate this never creates or coalesces buffers, so it can be used to check the state of memory without tracking it
+         */
+        BufferView TryFind(GuestBuffer guestMapping) {
+            if (auto lookupBuffer{bufferTable[guestMapping.begin().base()]}; lookupBuffer != nullptr)
+                return lookupBuffer->TryGetView(guestMapping);
+
+            return {};
+        }
     };
 }
@@ -32,39 +32,14 @@ namespace skyline::gpu::cache {
                 imageViews.emplace_back(image);
             attachments.emplace<std::vector<vk::ImageView>>(std::move(imageViews));
         }
+
+        hash = FramebufferHash{}(createInfo);
     }
 
     #define HASH(x) boost::hash_combine(hash, x)
 
     size_t FramebufferCache::FramebufferHash::operator()(const FramebufferCacheKey &key) const {
-        size_t hash{};
-
-        HASH(static_cast<VkFramebufferCreateFlags>(key.flags));
-        HASH(static_cast<VkRenderPass>(key.renderPass));
-        HASH(key.width);
-        HASH(key.height);
-        HASH(key.layers);
-
-        std::visit(VariantVisitor{
-            [&hash](const std::vector<FramebufferImagelessAttachment> &attachments) {
-                HASH(attachments.size());
-                for (const auto &attachment : attachments) {
-                    HASH(static_cast<VkImageCreateFlags>(attachment.flags));
-                    HASH(static_cast<VkImageUsageFlags>(attachment.usage));
-                    HASH(attachment.width);
-                    HASH(attachment.height);
-                    HASH(attachment.layers);
-                    HASH(attachment.format);
-                }
-            },
-            [&hash](const std::vector<vk::ImageView> &attachments) {
-                HASH(attachments.size());
-                for (const auto &attachment : attachments)
-                    HASH(static_cast<VkImageView>(attachment));
-            }
-        }, key.attachments);
-
-        return hash;
+        return key.hash;
     }
 
     size_t FramebufferCache::FramebufferHash::operator()(const FramebufferCreateInfo &key) const {
@@ -80,6 +55,7 @@ namespace skyline::gpu::cache {
 
         if (info.flags & vk::FramebufferCreateFlagBits::eImageless) {
             auto &attachmentInfo{key.get<vk::FramebufferAttachmentsCreateInfo>()};
+            HASH(attachmentInfo.attachmentImageInfoCount);
             for (const vk::FramebufferAttachmentImageInfo &image : span<const vk::FramebufferAttachmentImageInfo>(attachmentInfo.pAttachmentImageInfos, attachmentInfo.attachmentImageInfoCount)) {
                 HASH(static_cast<VkImageCreateFlags>(image.flags));
                 HASH(static_cast<VkImageUsageFlags>(image.usage));
@@ -141,11 +117,15 @@ namespace skyline::gpu::cache {
     }
 
     vk::Framebuffer FramebufferCache::GetFramebuffer(const FramebufferCreateInfo &createInfo) {
-        std::scoped_lock lock{mutex};
-        auto it{framebufferCache.find(createInfo)};
-        if (it != framebufferCache.end())
-            return *it->second;
+        {
+            std::shared_lock lock{mutex};
+            auto it{framebufferCache.find(createInfo)};
+            if (it != framebufferCache.end())
+                return *it->second;
+        }
 
+        // Another thread may have inserted an equivalent framebuffer since the lookup, try_emplace will return it in that case
+        std::unique_lock lock{mutex};
         auto entryIt{framebufferCache.try_emplace(FramebufferCacheKey{createInfo}, gpu.vkDevice, createInfo.get<vk::FramebufferCreateInfo>())};
         return *entryIt.first->second;
     }
@@ -16,7 +16,7 @@ namespace skyline::gpu::cache {
     class FramebufferCache {
       private:
         GPU &gpu;
-        std::mutex mutex; //!< Synchronizes access to the cache
+        std::shared_mutex mutex; //!< Synchronizes access to the cache, lookups lock it in shared mode while insertions lock it exclusively
 
       private:
         /**
@@ -43,6 +43,7 @@ namespace skyline::gpu::cache {
             u32 height;
             u32 layers;
             std::variant<std::vector<vk::ImageView>, std::vector<FramebufferImagelessAttachment>> attachments;
+            size_t hash; //!< The hash of the create info that the key was constructed from, this avoids rehashing the attachments when the map is rehashed
 
             FramebufferCacheKey(const FramebufferCreateInfo &createInfo);
 
@@ -23,55 +23,13 @@ namespace skyline::gpu::cache {
 
     RenderPassCache::RenderPassMetadata::RenderPassMetadata(const vk::RenderPassCreateInfo &createInfo)
         : attachments{createInfo.pAttachments, createInfo.pAttachments + createInfo.attachmentCount},
-          subpasses{createInfo.pSubpasses, createInfo.pSubpasses + createInfo.subpassCount} {}
+          subpasses{createInfo.pSubpasses, createInfo.pSubpasses + createInfo.subpassCount},
+          hash{RenderPassHash{}(createInfo)} {}
 
     #define HASH(x) boost::hash_combine(hash, x)
 
     size_t RenderPassCache::RenderPassHash::operator()(const RenderPassMetadata &key) const {
-        size_t hash{};
-
-        HASH(key.attachments.size());
-        for (const auto &attachment : key.attachments) {
-            HASH(static_cast<VkAttachmentDescriptionFlags>(attachment.flags));
-            HASH(attachment.format);
-            HASH(attachment.samples);
-            HASH(attachment.loadOp);
-            HASH(attachment.storeOp);
-            HASH(attachment.stencilLoadOp);
-            HASH(attachment.stencilStoreOp);
-            HASH(attachment.initialLayout);
-            HASH(attachment.finalLayout);
-        }
-
-        HASH(key.subpasses.size());
-        for (const auto &subpass : key.subpasses) {
-            HASH(static_cast<VkSubpassDescriptionFlags>(subpass.flags));
-            HASH(subpass.pipelineBindPoint);
-
-            auto hashReferences{[&hash](const auto &references) {
-                HASH(references.size());
-                for (const auto &reference : references) {
-                    HASH(reference.attachment);
-                    HASH(reference.layout);
-                }
-            }};
-
-            hashReferences(subpass.inputAttachments);
-            hashReferences(subpass.colorAttachments);
-            hashReferences(subpass.resolveAttachments);
-
-            HASH(subpass.depthStencilAttachment.has_value());
-            if (subpass.depthStencilAttachment) {
-                HASH(subpass.depthStencilAttachment->attachment);
-                HASH(subpass.depthStencilAttachment->layout);
-            }
-
-            HASH(subpass.preserveAttachments.size());
-            for (const auto &index : subpass.preserveAttachments)
-                HASH(index);
-        }
-
-        return hash;
+        return key.hash;
     }
 
     size_t RenderPassCache::RenderPassHash::operator()(const vk::RenderPassCreateInfo &key) const {
@@ -105,8 +63,7 @@ namespace skyline::gpu::cache {
 
             hashReferences(subpass.pInputAttachments, subpass.inputAttachmentCount);
             hashReferences(subpass.pColorAttachments, subpass.colorAttachmentCount);
-            if (subpass.pResolveAttachments)
-                hashReferences(subpass.pResolveAttachments, subpass.colorAttachmentCount);
+            hashReferences(subpass.pResolveAttachments, subpass.pResolveAttachments ? subpass.colorAttachmentCount : 0);
 
             HASH(subpass.pDepthStencilAttachment != nullptr);
             if (subpass.pDepthStencilAttachment) {
@@ -149,7 +106,7 @@ namespace skyline::gpu::cache {
 
             RETF(subpass.depthStencilAttachment.has_value() != (vkSubpass->pDepthStencilAttachment != nullptr))
             if (subpass.depthStencilAttachment)
-                RETF(subpass.depthStencilAttachment->attachment != vkSubpass->pDepthStencilAttachment->attachment &&
+                RETF(subpass.depthStencilAttachment->attachment != vkSubpass->pDepthStencilAttachment->attachment ||
                     subpass.depthStencilAttachment->layout != vkSubpass->pDepthStencilAttachment->layout)
 
             RETARRNEQ(subpass.preserveAttachments, vkSubpass->pPreserveAttachments, vkSubpass->preserveAttachmentCount)
@@ -163,11 +120,15 @@ namespace skyline::gpu::cache {
     }
 
     vk::RenderPass RenderPassCache::GetRenderPass(const vk::RenderPassCreateInfo &createInfo) {
-        std::scoped_lock lock{mutex};
-        auto it{renderPassCache.find(createInfo)};
-        if (it != renderPassCache.end())
-            return *it->second;
+        {
+            std::shared_lock lock{mutex};
+            auto it{renderPassCache.find(createInfo)};
+            if (it != renderPassCache.end())
+                return *it->second;
+        }
 
+        // Another thread may have inserted an equivalent render pass since the lookup, try_emplace will return it in that case
+        std::unique_lock lock{mutex};
         auto entryIt{renderPassCache.try_emplace(RenderPassMetadata{createInfo}, gpu.vkDevice, createInfo)};
         return *entryIt.first->second;
     }
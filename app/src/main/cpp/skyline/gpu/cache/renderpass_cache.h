@@ -13,7 +13,7 @@ namespace skyline::gpu::cache {
     class RenderPassCache {
       private:
         GPU &gpu;
-        std::mutex mutex; //!< Synchronizes access to the cache
+        std::shared_mutex mutex; //!< Synchronizes access to the cache, lookups lock it in shared mode while insertions lock it exclusively
 
         /**
          * @url https://www.khronos.org/registry/vulkan/specs/1.3-extensions/man/html/VkSubpassDescription.html
@@ -38,6 +38,7 @@ namespace skyline::gpu::cache {
         struct RenderPassMetadata {
             std::vector<vk::AttachmentDescription> attachments;
             std::vector<SubpassDescription> subpasses;
+            size_t hash; //!< The hash of the create info that the key was constructed from, this avoids rehashing the subpasses when the map is rehashed
 
             RenderPassMetadata(const vk::RenderPassCreateInfo &createInfo);
 
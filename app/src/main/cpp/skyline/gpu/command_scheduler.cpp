@@ -31,12 +31,12 @@ namespace skyline::gpu {
         }
     }
 
-    CommandScheduler::CommandBufferSlot::CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool)
+    CommandScheduler::CommandBufferSlot::CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool, bool useTimeline)
         : device{device},
           commandBuffer{device, static_cast<VkCommandBuffer>(commandBuffer), static_cast<VkCommandPool>(*pool)},
-          fence{device, vk::FenceCreateInfo{}},
+          fence{useTimeline ? vk::raii::Fence{nullptr} : vk::raii::Fence{device, vk::FenceCreateInfo{}}},
           semaphore{device, vk::SemaphoreCreateInfo{}},
-          cycle{std::make_shared<FenceCycle>(device, *fence, *semaphore)} {}
+          cycle{MakePooledShared<FenceCycle>(device, *fence, *semaphore)} {}
 
     CommandScheduler::CommandScheduler(const DeviceState &state, GPU &pGpu)
         : state{state},
@@ -45,7 +45,15 @@ namespace skyline::gpu {
           pool{std::ref(pGpu.vkDevice), vk::CommandPoolCreateInfo{
               .flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
               .queueFamilyIndex = pGpu.vkQueueFamilyIndex,
-          }} {}
+          }} {
+        queues.emplace_back(*gpu.vkQueue, gpu.queueMutex);
+        for (u32 index{1}; index < gpu.vkQueueCount; index++)
+            queues.emplace_back((*gpu.vkDevice).getQueue(gpu.vkQueueFamilyIndex, index, *gpu.vkDevice.getDispatcher()), secondaryQueueMutex);
+
+        if (gpu.traits.supportsTimelineSemaphores)
+            for (auto &queue : queues)
+                queue.timeline.emplace(gpu.vkDevice);
+    }
 
     CommandScheduler::~CommandScheduler() {
         waiterThread.join();
@@ -56,7 +64,7 @@ namespace skyline::gpu {
             if (!slot.active.test_and_set(std::memory_order_acq_rel)) {
                 if (slot.cycle->Poll()) {
                     slot.commandBuffer.reset();
-                    slot.cycle = std::make_shared<FenceCycle>(*slot.cycle);
+                    slot.cycle = MakePooledShared<FenceCycle>(*slot.cycle);
                     return {slot};
                 } else {
                     slot.active.clear(std::memory_order_release);
@@ -74,25 +82,62 @@ namespace skyline::gpu {
         auto result{(*gpu.vkDevice).allocateCommandBuffers(&commandBufferAllocateInfo, &commandBuffer, *gpu.vkDevice.getDispatcher())};
         if (result != vk::Result::eSuccess)
             vk::throwResultException(result, __builtin_FUNCTION());
-        return {pool->buffers.emplace_back(gpu.vkDevice, commandBuffer, pool->vkCommandPool)};
+        return {pool->buffers.emplace_back(gpu.vkDevice, commandBuffer, pool->vkCommandPool, UsesTimeline())};
     }
 
-    void CommandScheduler::SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores) {
-        boost::container::small_vector<vk::Semaphore, 3> fullWaitSemaphores{waitSemaphores.begin(), waitSemaphores.end()};
-        boost::container::small_vector<vk::PipelineStageFlags, 3> fullWaitStages{waitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands};
+    void CommandScheduler::SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores, span<vk::Semaphore> signalSemaphores, u32 queueIndex) {
+        auto &queue{queues[queueIndex]};
+        auto &timeline{queue.timeline};
+
+        boost::container::small_vector<vk::Semaphore, 4> fullWaitSemaphores{waitSemaphores.begin(), waitSemaphores.end()};
+        boost::container::small_vector<vk::PipelineStageFlags, 4> fullWaitStages{waitSemaphores.size(), vk::PipelineStageFlagBits::eAllCommands};
+        boost::container::small_vector<u64, 4> fullWaitValues(waitSemaphores.size()); // Values are ignored for binary semaphores
+
+        if (queues.size() > 1) {
+            // Submissions to other queues aren't implicitly ordered with this one, chained cycles from them need to be waited on (on GPU) through their queue's timeline
+            std::array<u64, MaxQueueCount> queueWaitValues{};
+            cycle->chainedCycles.Iterate([&](const std::shared_ptr<FenceCycle> &chainedCycle) {
+                if (chainedCycle->Poll())
+                    return;
+
+                chainedCycle->WaitSubmit(); // The timeline value of a cycle is only assigned once it's submitted
+                for (size_t index{}; index < queues.size(); index++)
+                    if (index != queueIndex && chainedCycle->timeline == &*queues[index].timeline)
+                        queueWaitValues[index] = std::max(queueWaitValues[index], chainedCycle->timelineValue);
+            });
+
+            for (size_t index{}; index < queues.size(); index++) {
+                if (queueWaitValues[index]) {
+                    fullWaitSemaphores.push_back(*queues[index].timeline->semaphore);
+                    fullWaitStages.push_back(vk::PipelineStageFlagBits::eAllCommands);
+                    fullWaitValues.push_back(queueWaitValues[index]);
+                }
+            }
+        }
 
         if (cycle->semaphoreSubmitWait) {
             fullWaitSemaphores.push_back(cycle->semaphore);
             // We don't need a full barrier since this is only done to ensure the semaphore is unsignalled
             fullWaitStages.push_back(vk::PipelineStageFlagBits::eTopOfPipe);
+            fullWaitValues.push_back(0);
+        }
+
+        if (cycle->transferWaitValue) {
+            fullWaitSemaphores.push_back(gpu.transferQueue->GetSemaphore());
+            fullWaitStages.push_back(vk::PipelineStageFlagBits::eAllCommands);
+            fullWaitValues.push_back(cycle->transferWaitValue);
         }
 
-        boost::container::small_vector<vk::Semaphore, 2> fullSignalSemaphores{signalSemaphores.begin(), signalSemaphores.end()};
+        boost::container::small_vector<vk::Semaphore, 3> fullSignalSemaphores{signalSemaphores.begin(), signalSemaphores.end()};
         fullSignalSemaphores.push_back(cycle->semaphore);
+        boost::container::small_vector<u64, 3> fullSignalValues(fullSignalSemaphores.size()); // The timeline value is filled in with the queue locked as values must be signalled in submission order
+        if (timeline) {
+            fullSignalSemaphores.push_back(*timeline->semaphore);
+            fullSignalValues.push_back(0);
+        }
 
-        {
-            std::scoped_lock lock{gpu.queueMutex};
-            gpu.vkQueue.submit(vk::SubmitInfo{
+        vk::StructureChain<vk::SubmitInfo, vk::TimelineSemaphoreSubmitInfo> submitInfo{
+            vk::SubmitInfo{
                 .commandBufferCount = 1,
                 .pCommandBuffers = &*commandBuffer,
                 .waitSemaphoreCount = static_cast<u32>(fullWaitSemaphores.size()),
@@ -100,7 +145,28 @@ namespace skyline::gpu {
                 .pWaitDstStageMask = fullWaitStages.data(),
                 .signalSemaphoreCount = static_cast<u32>(fullSignalSemaphores.size()),
                 .pSignalSemaphores = fullSignalSemaphores.data(),
-            }, cycle->fence);
+            },
+            vk::TimelineSemaphoreSubmitInfo{
+                .waitSemaphoreValueCount = static_cast<u32>(fullWaitValues.size()),
+                .pWaitSemaphoreValues = fullWaitValues.data(),
+                .signalSemaphoreValueCount = static_cast<u32>(fullSignalValues.size()),
+                .pSignalSemaphoreValues = fullSignalValues.data(),
+            }
+        };
+
+        // Timeline semaphore values only need to be supplied when a timeline semaphore is used, this also avoids chaining the structure on devices without timeline semaphore support
+        if (!cycle->transferWaitValue && !timeline)
+            submitInfo.unlink<vk::TimelineSemaphoreSubmitInfo>();
+
+        {
+            std::scoped_lock lock{queue.mutex};
+            if (timeline) {
+                fullSignalValues.back() = ++timeline->lastValue;
+                cycle->timeline = &*timeline;
+                cycle->timelineValue = fullSignalValues.back();
+            }
+
+            queue.vkQueue.submit(submitInfo.get<vk::SubmitInfo>(), cycle->fence, *gpu.vkDevice.getDispatcher());
         }
 
         cycle->NotifySubmitted();
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <deque>
 #include <common/thread_local.h>
 #include <common/circular_queue.h>
 #include "fence_cycle.h"
@@ -24,11 +25,28 @@ namespace skyline::gpu {
             vk::raii::Semaphore semaphore; //!< A semaphore used for tracking work status on the GPU
             std::shared_ptr<FenceCycle> cycle; //!< The latest cycle on the fence, all waits must be performed through this
 
-            CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool);
+            /**
+             * @param useTimeline If the slot's cycles are tracked with the queue's timeline, no fence is created in that case
+             */
+            CommandBufferSlot(vk::raii::Device &device, vk::CommandBuffer commandBuffer, vk::raii::CommandPool &pool, bool useTimeline);
+        };
+
+        /**
+         * @brief A queue from the graphics queue family which command buffers can be submitted to
+         */
+        struct Queue {
+            vk::Queue vkQueue;
+            std::mutex &mutex; //!< Synchronizes access to the queue, this is the GPU's queue mutex for the primary queue as presentation also uses it
+            std::optional<QueueTimeline> timeline; //!< The timeline of the queue, this is only present on devices that support timeline semaphores
+
+            Queue(vk::Queue vkQueue, std::mutex &mutex) : vkQueue{vkQueue}, mutex{mutex} {}
         };
 
         const DeviceState &state;
         GPU &gpu;
+        std::mutex secondaryQueueMutex; //!< Synchronizes access to all queues other than the primary one
+        std::deque<Queue> queues; //!< All queues that can be submitted to, the first one is the GPU's primary queue and any others are only present on devices supporting timeline semaphores
+        std::atomic<u32> nextQueue{}; //!< The index of the queue that the next call to AllocateQueue will return, this is used to spread executors across queues
 
         /**
          * @brief A command pool designed to be thread-local to respect external synchronization for all command buffers and the associated pool
@@ -50,6 +68,8 @@ namespace skyline::gpu {
         void WaiterThread();
 
       public:
+        static constexpr u32 MaxQueueCount{2}; //!< The maximum amount of queues from the graphics queue family that are used, every additional queue allows another channel to execute concurrently on the GPU
+
         /**
          * @brief An active command buffer occupies a slot and ensures that its status is updated correctly
          */
@@ -95,7 +115,7 @@ namespace skyline::gpu {
              */
             std::shared_ptr<FenceCycle> Reset() {
                 slot->cycle->Wait();
-                slot->cycle = std::make_shared<FenceCycle>(*slot->cycle);
+                slot->cycle = MakePooledShared<FenceCycle>(*slot->cycle);
                 slot->commandBuffer.reset();
                 return slot->cycle;
             }
@@ -103,6 +123,28 @@ namespace skyline::gpu {
 
         CommandScheduler(const DeviceState &state, GPU &gpu);
 
+        /**
+         * @return If submissions are tracked with a timeline rather than fences, fences supplied with cycles may be null in that case
+         */
+        bool UsesTimeline() {
+            return queues.front().timeline.has_value();
+        }
+
+        /**
+         * @return The amount of submitted cycles which are still waited on by the waiter thread
+         */
+        size_t GetInFlightCycleCount() const {
+            return cycleQueue.Size();
+        }
+
+        /**
+         * @return The index of a queue that an executor should submit all of its command buffers to, these are handed out in a round-robin order
+         * @note Submissions to different queues are only ordered with each other through chained cycles, these are waited on by the GPU during submission
+         */
+        u32 AllocateQueue() {
+            return nextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<u32>(queues.size());
+        }
+
         ~CommandScheduler();
 
         /**
@@ -114,8 +156,9 @@ namespace skyline::gpu {
          * @brief Submits a single command buffer to the GPU queue while queuing it up to be waited on
          * @note The supplied command buffer and cycle **must** be from AllocateCommandBuffer()
          * @note Any cycle submitted via this method does not need to destroy dependencies manually, the waiter thread will handle this
+         * @param queueIndex The index of the queue to submit to, this should be a value returned by AllocateQueue()
          */
-        void SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores = {}, span<vk::Semaphore> signalSemaphore = {});
+        void SubmitCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, std::shared_ptr<FenceCycle> cycle, span<vk::Semaphore> waitSemaphores = {}, span<vk::Semaphore> signalSemaphore = {}, u32 queueIndex = 0);
 
         /**
          * @brief Submits a command buffer recorded with the supplied function synchronously
@@ -125,20 +168,27 @@ namespace skyline::gpu {
         template<typename RecordFunction>
         std::shared_ptr<FenceCycle> Submit(RecordFunction recordFunction, span<vk::Semaphore> waitSemaphores = {}, span<vk::Semaphore> signalSemaphores = {}) {
             auto commandBuffer{AllocateCommandBuffer()};
-            try {
-                commandBuffer->begin(vk::CommandBufferBeginInfo{
-                    .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
-                });
-                recordFunction(*commandBuffer);
-                commandBuffer->end();
-
-                auto cycle{commandBuffer.GetFenceCycle()};
-                SubmitCommandBuffer(*commandBuffer, cycle, waitSemaphores, signalSemaphores);
-                return cycle;
-            } catch (...) {
-                commandBuffer.GetFenceCycle()->Cancel();
-                std::rethrow_exception(std::current_exception());
-            }
+            auto cycle{commandBuffer.GetFenceCycle()};
+
+            // The cycle is cancelled if recording or submission is unwound by an exception, this is done with a guard rather than a try/catch so the recording function can be inlined
+            struct CancelGuard {
+                FenceCycle *cycle;
+
+                ~CancelGuard() {
+                    if (cycle) [[unlikely]]
+                        cycle->Cancel();
+                }
+            } cancelGuard{cycle.get()};
+
+            commandBuffer->begin(vk::CommandBufferBeginInfo{
+                .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+            });
+            recordFunction(*commandBuffer);
+            commandBuffer->end();
+
+            SubmitCommandBuffer(*commandBuffer, cycle, waitSemaphores, signalSemaphores);
+            cancelGuard.cycle = nullptr;
+            return cycle;
         }
     };
 }
@@ -131,6 +131,8 @@ namespace skyline::gpu {
         }
 
         while (true) {
+            poolResetCount.fetch_add(1, std::memory_order_relaxed);
+
             // We attempt to modify the pool based on the last result
             if (lastResult == vk::Result::eErrorOutOfPoolMemory) {
                 if (pool->freeSetCount == 0)
@@ -156,4 +158,15 @@ namespace skyline::gpu {
             }
         }
     }
+
+    bool DescriptorAllocator::CanPushDescriptors(span<const vk::DescriptorSetLayoutBinding> layoutBindings) {
+        if (!gpu.traits.supportsPushDescriptors)
+            return false;
+
+        u32 descriptorCount{};
+        for (const auto &binding : layoutBindings)
+            descriptorCount += binding.descriptorCount;
+
+        return descriptorCount <= gpu.traits.maxPushDescriptors;
+    }
 }
@@ -43,6 +43,7 @@ namespace skyline::gpu {
         };
 
         std::shared_ptr<DescriptorPool> pool; //!< The current pool used by any allocations in the class, replaced when an error is ran into
+        std::atomic<u32> poolResetCount{}; //!< The amount of times the pool has been replaced after running out of space
 
         /**
          * @brief (Re-)Allocates the descriptor pool with the current multiplier applied to the descriptor counts and the current descriptor set count
@@ -86,6 +87,10 @@ namespace skyline::gpu {
 
         DescriptorAllocator(GPU &gpu);
 
+        u32 GetPoolResetCount() const {
+            return poolResetCount.load(std::memory_order_relaxed);
+        }
+
         /**
          * @brief Allocates a descriptor set from the pool with the supplied layout
          * @note The layout object must be reused for equivalent layouts to avoid unnecessary descriptor set creation
@@ -93,5 +98,10 @@ namespace skyline::gpu {
          * @note The supplied ActiveDescriptorSet **must** stay alive until the descriptor set can be freed, it must not be destroyed after being bound but after any associated commands have completed execution
          */
         ActiveDescriptorSet AllocateSet(vk::DescriptorSetLayout layout);
+
+        /**
+         * @return If a set with the supplied bindings is small enough to be pushed rather than allocated from the pool
+         */
+        bool CanPushDescriptors(span<const vk::DescriptorSetLayoutBinding> layoutBindings);
     };
 }
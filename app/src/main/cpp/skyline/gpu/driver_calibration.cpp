@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include <gpu.h>
+#include <gpu/texture/layout.h>
+#include "driver_calibration.h"
+
+namespace skyline::gpu {
+    struct DriverCalibrationFile {
+        static constexpr u32 Magic{util::MakeMagic<u32>("DCAL")}; //!< The magic value used to identify a driver calibration file
+        static constexpr u32 Version{1}; //!< The version of the driver calibration file format, MUST be incremented for any format changes or changes to the benchmarks
+
+        u32 magic{Magic};
+        u32 version{Version};
+        u32 vendorId;
+        u32 deviceId;
+        u32 driverVersion;
+        u64 gpuDeswizzleMinimumSize;
+    };
+
+    std::pair<u64, u64> DriverCalibration::BenchmarkDeswizzle(GPU &gpu, u32 width, u64 submitOverhead) {
+        constexpr u32 Bpb{4}, GobBlockHeight{16};
+        texture::Dimensions dimensions{width, width, 1};
+        size_t blockLinearSize{texture::GetBlockLinearLayerSize(dimensions, 1, 1, Bpb, GobBlockHeight, 1)};
+        size_t linearSize{static_cast<size_t>(width) * width * Bpb};
+        vk::DeviceSize linearOffset{util::AlignUp(static_cast<vk::DeviceSize>(blockLinearSize), gpu.traits.minimumStorageBufferAlignment)};
+
+        std::vector<u8> guest(blockLinearSize);
+        for (size_t i{}; i < guest.size(); i++)
+            guest[i] = static_cast<u8>(i * 0x9D); // The contents don't matter but the pages must be populated prior to timing
+
+        auto stagingBuffer{gpu.memory.AllocateStagingBuffer(linearOffset + linearSize, vk::BufferUsageFlagBits::eStorageBuffer)};
+        BlockLinearDeswizzleShader::Surface surface{
+            .width = width,
+            .height = width,
+            .depth = 1,
+            .formatBlockWidth = 1,
+            .formatBlockHeight = 1,
+            .formatBpb = Bpb,
+            .gobBlockHeight = GobBlockHeight,
+            .gobBlockDepth = 1,
+        };
+
+        u64 cpuTime{std::numeric_limits<u64>::max()}, gpuTime{std::numeric_limits<u64>::max()};
+        for (size_t iteration{}; iteration < IterationCount; iteration++) {
+            auto start{util::GetTimeNs()};
+            texture::CopyBlockLinearToLinear(dimensions, 1, 1, Bpb, GobBlockHeight, 1, guest.data(), stagingBuffer->data() + linearOffset);
+            cpuTime = std::min(cpuTime, static_cast<u64>(util::GetTimeNs() - start));
+
+            start = util::GetTimeNs();
+            std::memcpy(stagingBuffer->data(), guest.data(), blockLinearSize);
+            std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> descriptorSet;
+            auto cycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
+                descriptorSet = gpu.helperShaders.blockLinearDeswizzleShader.Deswizzle(gpu, commandBuffer, vk::DescriptorBufferInfo{
+                    .buffer = stagingBuffer->vkBuffer,
+                    .offset = 0,
+                    .range = blockLinearSize,
+                }, vk::DescriptorBufferInfo{
+                    .buffer = stagingBuffer->vkBuffer,
+                    .offset = linearOffset,
+                    .range = linearSize,
+                }, surface);
+            })};
+            cycle->AttachObject(descriptorSet);
+            cycle->Wait();
+            auto elapsed{static_cast<u64>(util::GetTimeNs() - start)};
+            gpuTime = std::min(gpuTime, elapsed > submitOverhead ? elapsed - submitOverhead : 0);
+        }
+
+        return {cpuTime, gpuTime};
+    }
+
+    void DriverCalibration::Run(GPU &gpu) {
+        TRACE_EVENT("gpu", "DriverCalibration::Run");
+
+        // The round-trip latency of an empty submission is subtracted from the GPU timings as it's amortized across all work in a command buffer during emulation
+        u64 submitOverhead{std::numeric_limits<u64>::max()};
+        for (size_t iteration{}; iteration < IterationCount; iteration++) {
+            auto start{util::GetTimeNs()};
+            gpu.scheduler.Submit([](vk::raii::CommandBuffer &) {})->Wait();
+            submitOverhead = std::min(submitOverhead, static_cast<u64>(util::GetTimeNs() - start));
+        }
+
+        // The threshold is the smallest surface size from which the GPU is faster for all larger sizes, if it's never faster only the largest surfaces are offloaded as that still frees the CPU from their deswizzling
+        constexpr std::array<u32, 5> Widths{128, 256, 512, 1024, 2048};
+        size_t threshold{static_cast<size_t>(Widths.back()) * Widths.back() * 4};
+        for (auto it{Widths.rbegin()}; it != Widths.rend(); it++) {
+            auto [cpuTime, gpuTime]{BenchmarkDeswizzle(gpu, *it, submitOverhead)};
+            Logger::Debug("Deswizzle of {}x{}: CPU {}us, GPU {}us", *it, *it, cpuTime / constant::NsInMicrosecond, gpuTime / constant::NsInMicrosecond);
+            if (gpuTime >= cpuTime)
+                break;
+            threshold = static_cast<size_t>(*it) * *it * 4;
+        }
+        gpuDeswizzleMinimumSize = threshold;
+    }
+
+    void DriverCalibration::Calibrate(GPU &gpu, const std::string &path) {
+        auto &traits{gpu.traits};
+        {
+            std::ifstream stream{path, std::ios::binary};
+            DriverCalibrationFile file{};
+            if (stream.read(reinterpret_cast<char *>(&file), sizeof(DriverCalibrationFile)) && file.magic == DriverCalibrationFile::Magic && file.version == DriverCalibrationFile::Version &&
+                file.vendorId == traits.vendorId && file.deviceId == traits.deviceId && file.driverVersion == traits.driverVersion) {
+                gpuDeswizzleMinimumSize = file.gpuDeswizzleMinimumSize;
+                return;
+            }
+        }
+
+        auto start{util::GetTimeNs()};
+        try {
+            Run(gpu);
+        } catch (const std::exception &e) {
+            Logger::Warn("Failed to calibrate the driver, using defaults: {}", e.what());
+            gpuDeswizzleMinimumSize = DefaultGpuDeswizzleMinimumSize;
+            return;
+        }
+        Logger::Info("Calibrated the driver in {}ms: GPU deswizzle minimum size: 0x{:X}", (util::GetTimeNs() - start) / constant::NsInMillisecond, gpuDeswizzleMinimumSize);
+
+        std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+        DriverCalibrationFile file{
+            .vendorId = traits.vendorId,
+            .deviceId = traits.deviceId,
+            .driverVersion = traits.driverVersion,
+            .gpuDeswizzleMinimumSize = gpuDeswizzleMinimumSize,
+        };
+        if (!stream.write(reinterpret_cast<const char *>(&file), sizeof(DriverCalibrationFile)))
+            Logger::Warn("Failed to write the driver calibration to '{}'", path);
+    }
+}
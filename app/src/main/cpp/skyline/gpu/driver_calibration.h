@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::gpu {
+    class GPU;
+
+    /**
+     * @brief Picks between the CPU and GPU variants of paths whose relative cost depends on the specific driver by timing both on the host, this complements the static decisions made by the TraitManager
+     * @details The results are persisted alongside the identity of the driver they were measured on, so the benchmarks only run again after the GPU or its driver changes
+     */
+    class DriverCalibration {
+      private:
+        static constexpr size_t IterationCount{5}; //!< The amount of times every variant is timed, the fastest iteration is used to reject interference from other threads
+
+        /**
+         * @brief Runs all benchmarks and updates the results with their outcome
+         */
+        void Run(GPU &gpu);
+
+        /**
+         * @return The fastest time to deswizzle a square RGBA8 surface with the supplied width on the CPU and on the GPU in nanoseconds
+         * @note The GPU time includes copying the guest data into the staging buffer but not the fixed submission overhead, as deswizzles are recorded into existing command buffers in practice
+         */
+        std::pair<u64, u64> BenchmarkDeswizzle(GPU &gpu, u32 width, u64 submitOverhead);
+
+      public:
+        static constexpr size_t DefaultGpuDeswizzleMinimumSize{0x40000}; //!< The GPU deswizzle threshold used when calibration hasn't been performed
+
+        size_t gpuDeswizzleMinimumSize{DefaultGpuDeswizzleMinimumSize}; //!< The minimum size of a surface for it to be deswizzled on the GPU, deswizzling smaller surfaces on the CPU is cheaper than the dispatch overhead
+
+        /**
+         * @brief Loads the results for the current driver from the supplied file or runs the benchmarks and writes their results to it if there are none
+         */
+        void Calibrate(GPU &gpu, const std::string &path);
+    };
+}
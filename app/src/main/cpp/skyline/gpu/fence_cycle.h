@@ -7,12 +7,87 @@
 #include <vulkan/vulkan_raii.hpp>
 #include <common.h>
 #include <common/atomic_forward_list.h>
+#include <common/object_pool.h>
 
 namespace skyline::gpu {
     class CommandScheduler;
 
+    /**
+     * @brief A timeline semaphore which is signalled with an incrementing value by every submission to a queue, this allows tracking all submissions with a single counter rather than a fence per submission
+     */
+    struct QueueTimeline {
+        vk::raii::Semaphore semaphore;
+        std::atomic<u64> completedValue{}; //!< A lower bound of the semaphore's counter value, this allows polling values that are known to be complete without a call into the driver
+        u64 lastValue{}; //!< The value that the last submission to the queue signals, this must only be accessed with the queue mutex locked
+
+        static vk::raii::Semaphore CreateSemaphore(const vk::raii::Device &device) {
+            vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> semaphoreCreateInfo{
+                vk::SemaphoreCreateInfo{},
+                vk::SemaphoreTypeCreateInfo{
+                    .semaphoreType = vk::SemaphoreType::eTimeline,
+                    .initialValue = 0,
+                }
+            };
+            return vk::raii::Semaphore{device, semaphoreCreateInfo.get<vk::SemaphoreCreateInfo>()};
+        }
+
+        QueueTimeline(const vk::raii::Device &device) : semaphore{CreateSemaphore(device)} {}
+
+        /**
+         * @brief Raises the completed value to at least the supplied value
+         */
+        void UpdateCompleted(u64 value) {
+            u64 completed{completedValue.load(std::memory_order_relaxed)};
+            while (completed < value && !completedValue.compare_exchange_weak(completed, value, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        /**
+         * @return If the supplied value has been reached by the semaphore
+         * @param quick Skips querying the semaphore's counter, only checking the cached completed value
+         */
+        bool Poll(u64 value, bool quick = false) {
+            if (completedValue.load(std::memory_order_acquire) >= value)
+                return true;
+
+            if (quick)
+                return false;
+
+            u64 counter{semaphore.getCounterValue()};
+            UpdateCompleted(counter);
+            return counter >= value;
+        }
+
+        /**
+         * @brief Blocks till the semaphore has reached the supplied value
+         * @note All submissions up to the current counter value are marked as completed after this, so any subsequent polls or waits on them are satisfied without a call into the driver
+         */
+        void Wait(const vk::raii::Device &device, u64 value) {
+            if (completedValue.load(std::memory_order_acquire) >= value)
+                return;
+
+            vk::SemaphoreWaitInfo waitInfo{
+                .semaphoreCount = 1,
+                .pSemaphores = &*semaphore,
+                .pValues = &value,
+            };
+
+            vk::Result waitResult;
+            while ((waitResult = (*device).waitSemaphores(&waitInfo, std::numeric_limits<u64>::max(), *device.getDispatcher())) != vk::Result::eSuccess) {
+                if (waitResult == vk::Result::eTimeout || waitResult == vk::Result::eErrorInitializationFailed)
+                    // See FenceCycle::Wait for details on why eErrorInitializationFailed is retried
+                    continue;
+
+                throw exception("An error occurred while waiting for timeline semaphore 0x{:X} to reach {}: {}", static_cast<VkSemaphore>(*semaphore), value, vk::to_string(waitResult));
+            }
+
+            // The counter may be past the waited value by now, querying it allows batching the release of all cycles which have completed
+            UpdateCompleted(std::max(value, semaphore.getCounterValue()));
+        }
+    };
+
     /**
      * @brief A wrapper around a Vulkan Fence which only tracks a single reset -> signal cycle with the ability to attach lifetimes of objects to it
+     * @note On devices with timeline semaphores the cycle is tracked with a value on the queue's timeline instead and the fence may be null
      * @note This provides the guarantee that the fence must be signalled prior to destruction when objects are to be destroyed
      * @note All waits to the fence **must** be done through the same instance of this, the state of the fence changing externally will lead to UB
      */
@@ -29,6 +104,9 @@ namespace skyline::gpu {
         bool semaphoreSubmitWait{}; //!< If the semaphore needs to be waited on (on GPU) before the fence's command buffer begins. Used to ensure fences that wouldn't otherwise be unsignalled are unsignalled
         bool nextSemaphoreSubmitWait{true}; //!< If the next fence cycle created from this one after it's signalled should wait on the semaphore to unsignal it
         std::shared_ptr<FenceCycle> semaphoreUnsignalCycle{}; //!< If the semaphore is used on the GPU, the cycle for the submission that uses it, so it can be waited on before the fence is signalled to ensure the semaphore is unsignalled
+        u64 transferWaitValue{}; //!< The value of the transfer queue's timeline semaphore that needs to be waited on (on GPU) before the fence's command buffer begins, 0 if there's no wait
+        QueueTimeline *timeline{}; //!< The timeline of the queue that the cycle was submitted to, if this is set then the cycle is tracked with it rather than with the fence
+        u64 timelineValue{}; //!< The value of the timeline that'll be signalled on completion of the cycle's command buffer
 
         friend CommandScheduler;
 
@@ -46,12 +124,13 @@ namespace skyline::gpu {
 
       public:
         FenceCycle(const vk::raii::Device &device, vk::Fence fence, vk::Semaphore semaphore, bool signalled = false) : signalled{signalled}, device{device}, fence{fence}, semaphore{semaphore}, nextSemaphoreSubmitWait{!signalled} {
-            if (!signalled)
+            if (!signalled && fence)
                 device.resetFences(fence);
         }
 
         explicit FenceCycle(const FenceCycle &cycle) : signalled{false}, device{cycle.device}, fence{cycle.fence}, semaphore{cycle.semaphore}, semaphoreSubmitWait{cycle.nextSemaphoreSubmitWait} {
-            device.resetFences(fence);
+            if (fence)
+                device.resetFences(fence);
         }
 
         ~FenceCycle() {
@@ -66,6 +145,14 @@ namespace skyline::gpu {
             DestroyDependencies();
         }
 
+        /**
+         * @brief Makes the command buffer associated with this cycle wait on the transfer queue's timeline semaphore reaching the supplied value before it begins
+         * @note This must only be called prior to the command buffer being submitted
+         */
+        void AddTransferWait(u64 value) {
+            transferWaitValue = std::max(transferWaitValue, value);
+        }
+
         /**
          * @brief Executes a function with the fence locked to record a usage of its semaphore, if no semaphore can be provided then a CPU-side wait will be performed instead
          */
@@ -141,17 +228,21 @@ namespace skyline::gpu {
                 return;
             }
 
-            vk::Result waitResult;
-            while ((waitResult = (*device).waitForFences(1, &fence, false, std::numeric_limits<u64>::max(), *device.getDispatcher())) != vk::Result::eSuccess) {
-                if (waitResult == vk::Result::eTimeout)
-                    // Retry if the waiting time out
-                    continue;
-
-                if (waitResult == vk::Result::eErrorInitializationFailed)
-                    // eErrorInitializationFailed occurs on Mali GPU drivers due to them using the ppoll() syscall which isn't correctly restarted after a signal, we need to manually retry waiting in that case
-                    continue;
-
-                throw exception("An error occurred while waiting for fence 0x{:X}: {}", static_cast<VkFence>(fence), vk::to_string(waitResult));
+            if (timeline) {
+                timeline->Wait(device, timelineValue);
+            } else {
+                vk::Result waitResult;
+                while ((waitResult = (*device).waitForFences(1, &fence, false, std::numeric_limits<u64>::max(), *device.getDispatcher())) != vk::Result::eSuccess) {
+                    if (waitResult == vk::Result::eTimeout)
+                        // Retry if the waiting time out
+                        continue;
+
+                    if (waitResult == vk::Result::eErrorInitializationFailed)
+                        // eErrorInitializationFailed occurs on Mali GPU drivers due to them using the ppoll() syscall which isn't correctly restarted after a signal, we need to manually retry waiting in that case
+                        continue;
+
+                    throw exception("An error occurred while waiting for fence 0x{:X}: {}", static_cast<VkFence>(fence), vk::to_string(waitResult));
+                }
             }
 
             if (semaphoreUnsignalCycle)
@@ -192,8 +283,7 @@ namespace skyline::gpu {
             if (!submitted)
                 return false;
 
-            auto status{(*device).getFenceStatus(fence, *device.getDispatcher())};
-            if (status == vk::Result::eSuccess) {
+            if (timeline ? timeline->Poll(timelineValue) : (*device).getFenceStatus(fence, *device.getDispatcher()) == vk::Result::eSuccess) {
                 if (semaphoreUnsignalCycle && !semaphoreUnsignalCycle->Poll())
                     return false;
 
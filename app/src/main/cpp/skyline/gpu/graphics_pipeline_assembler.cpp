@@ -1,8 +1,11 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <boost/container/static_vector.hpp>
 #include <boost/functional/hash.hpp>
 #include <filesystem>
+#include <range/v3/algorithm.hpp>
+#include <common/settings.h>
 #include <gpu.h>
 #include "graphics_pipeline_assembler.h"
 #include "trait_manager.h"
@@ -16,12 +19,14 @@ namespace skyline::gpu {
         u32 deviceId; //!< The driver reported device ID
         u32 driverVersion; //!< The driver reported version
         std::array<u8, VK_UUID_SIZE> uuid; //!< The driver reported pipeline cache UUID
+        u64 driverLabelHash; //!< An XXH64 hash of the label of the custom GPU driver in use (or an empty string for the system driver), custom drivers may otherwise report identical properties to the system driver
 
-        PipelineCacheFileNameHeader(const TraitManager &traits)
-            : vendorId{traits.vendorId},
-              deviceId{traits.deviceId},
-              driverVersion{traits.driverVersion},
-              uuid{traits.pipelineCacheUuid} {}
+        PipelineCacheFileNameHeader(GPU &gpu)
+            : vendorId{gpu.traits.vendorId},
+              deviceId{gpu.traits.deviceId},
+              driverVersion{gpu.traits.driverVersion},
+              uuid{gpu.traits.pipelineCacheUuid},
+              driverLabelHash{XXH64((*gpu.state.settings->gpuDriver).data(), (*gpu.state.settings->gpuDriver).size(), 0)} {}
 
         std::string HexDump() {
             return util::HexDump(span<u8>{reinterpret_cast<u8 *>(this), sizeof(PipelineCacheFileNameHeader)});
@@ -38,9 +43,27 @@ namespace skyline::gpu {
     };
     static_assert(sizeof(PipelineCacheFileDataHeader) == 0x10);
 
+    static constexpr u64 MaxPipelineCacheSize{1ULL << 30}; //!< The maximum size of the serialized Vulkan pipeline cache data (1 GiB), this guards against allocating arbitrary amounts of memory for corrupted files
+
+    /**
+     * @return If the supplied data begins with a Vulkan pipeline cache header that matches the current device
+     * @note Some drivers don't robustly validate the initial data supplied to them and may crash on foreign or corrupted data, so this is checked prior to creating the pipeline cache
+     */
+    static bool ValidatePipelineCacheData(GPU &gpu, span<u8> data) {
+        if (data.size() < sizeof(vk::PipelineCacheHeaderVersionOne))
+            return false;
+
+        const auto &header{data.as<vk::PipelineCacheHeaderVersionOne>()};
+        return header.headerSize >= sizeof(vk::PipelineCacheHeaderVersionOne) &&
+               header.headerVersion == vk::PipelineCacheHeaderVersion::eOne &&
+               header.vendorID == gpu.traits.vendorId &&
+               header.deviceID == gpu.traits.deviceId &&
+               ranges::equal(header.pipelineCacheUUID, gpu.traits.pipelineCacheUuid);
+    }
+
     static vk::raii::PipelineCache DeserialisePipelineCache(GPU &gpu, std::string_view pipelineCacheDir) {
         std::filesystem::create_directories(pipelineCacheDir);
-        PipelineCacheFileNameHeader expectedFilenameHeader{gpu.traits};
+        PipelineCacheFileNameHeader expectedFilenameHeader{gpu};
         std::filesystem::path path{std::filesystem::path{pipelineCacheDir} / expectedFilenameHeader.HexDump()};
 
         if (!std::filesystem::exists(path))
@@ -54,15 +77,20 @@ namespace skyline::gpu {
 
         PipelineCacheFileDataHeader header{};
         stream.read(reinterpret_cast<char *>(&header), sizeof(PipelineCacheFileDataHeader));
+        if (stream.fail() || header.size > MaxPipelineCacheSize) {
+            Logger::Warn("Ignoring invalid pipeline cache file!");
+            return {gpu.vkDevice, vk::PipelineCacheCreateInfo{}};
+        }
 
         std::vector<u8> readData(header.size);
         stream.read(reinterpret_cast<char *>(readData.data()), static_cast<std::streamsize>(header.size));
 
-        if (header.hash != XXH64(readData.data(), readData.size(), 0)) {
+        if (stream.fail() || header.hash != XXH64(readData.data(), readData.size(), 0) || !ValidatePipelineCacheData(gpu, readData)) {
             Logger::Warn("Ignoring invalid pipeline cache file!");
             return {gpu.vkDevice, vk::PipelineCacheCreateInfo{}};
         }
 
+        Logger::Info("Loaded Vulkan pipeline cache from {} (size: 0x{:X} bytes)", path.string(), readData.size());
         return {gpu.vkDevice, vk::PipelineCacheCreateInfo{
             .initialDataSize = readData.size(),
             .pInitialData = readData.data(),
@@ -70,31 +98,98 @@ namespace skyline::gpu {
     }
 
     static void SerialisePipelineCache(GPU &gpu, std::string_view pipelineCacheDir, span<u8> data) {
-        PipelineCacheFileNameHeader expectedFilenameHeader{gpu.traits};
+        PipelineCacheFileNameHeader expectedFilenameHeader{gpu};
         std::filesystem::path path{std::filesystem::path{pipelineCacheDir} / expectedFilenameHeader.HexDump()};
 
         PipelineCacheFileDataHeader header{
             .size = data.size(),
             .hash = XXH64(data.data(), data.size(), 0)
         };
-        std::ofstream stream{path, std::ios::binary | std::ios::trunc};
-        if (stream.fail()) {
-            Logger::Warn("Failed to write Vulkan pipeline cache!");
-            return;
+        // The cache is written to a temporary file first and then renamed, so a partially written cache can never be read
+        std::filesystem::path temporaryPath{path.string() + ".tmp"};
+        {
+            std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+            if (stream.fail()) {
+                Logger::Warn("Failed to write Vulkan pipeline cache!");
+                return;
+            }
+
+            stream.write(reinterpret_cast<char *>(&header), sizeof(PipelineCacheFileDataHeader));
+            stream.write(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (stream.fail()) {
+                Logger::Warn("Failed to write Vulkan pipeline cache!");
+                stream.close();
+                std::filesystem::remove(temporaryPath);
+                return;
+            }
         }
 
-        stream.write(reinterpret_cast<char *>(&header), sizeof(PipelineCacheFileDataHeader));
-        stream.write(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error) {
+            Logger::Warn("Failed to commit Vulkan pipeline cache: {}", error.message());
+            return;
+        }
 
         Logger::Info("Wrote Vulkan pipeline cache to {} (size: 0x{:X} bytes)", path.string(), data.size());
     }
 
-    GraphicsPipelineAssembler::GraphicsPipelineAssembler(GPU &gpu, std::string_view pipelineCacheDir)
+    GraphicsPipelineAssembler::CompileCoreConfig GraphicsPipelineAssembler::GetCompileCoreConfig(bool singleThreaded, host::AffinityClass backgroundAffinity) {
+        CompileCoreConfig config{
+            .threadCount = singleThreaded ? 1U : std::max(std::thread::hardware_concurrency(), 1U),
+            .backgroundAffinity = backgroundAffinity,
+        };
+
+        const auto &topology{host::Topology::Get()};
+        if (!topology.IsHeterogeneous() || backgroundAffinity == host::AffinityClass::Any)
+            return config; // Homogeneous CPUs or unknown topologies don't restrict compilation threads
+
+        u32 backgroundCoreCount{topology.GetCoreCount(backgroundAffinity)};
+        config.restricted = true;
+        if (!singleThreaded)
+            config.threadCount = backgroundCoreCount;
+
+        Logger::Info("Restricting background pipeline compilation to {}/{} host cores", backgroundCoreCount, topology.GetCoreCount(host::AffinityClass::Any));
+        return config;
+    }
+
+    GraphicsPipelineAssembler::GraphicsPipelineAssembler(GPU &gpu, std::string_view pipelineCacheDir, host::AffinityClass backgroundAffinity)
         : gpu{gpu},
           vkPipelineCache{DeserialisePipelineCache(gpu, pipelineCacheDir)},
-          pool{gpu.traits.quirks.brokenMultithreadedPipelineCompilation ? 1U : 0U},
+          coreConfig{GetCompileCoreConfig(gpu.traits.quirks.brokenMultithreadedPipelineCompilation, backgroundAffinity)},
+          pool{coreConfig.threadCount},
           pipelineCacheDir{pipelineCacheDir} {}
 
+    void GraphicsPipelineAssembler::RunNextJob() {
+        std::function<void()> job;
+        Priority priority{};
+        {
+            std::scoped_lock lock{jobMutex};
+            for (size_t i{}; i < PriorityCount; i++) {
+                if (!jobQueues[i].empty()) {
+                    job = std::move(jobQueues[i].front());
+                    jobQueues[i].pop_front();
+                    queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+                    priority = static_cast<Priority>(i);
+                    break;
+                }
+            }
+        }
+
+        if (coreConfig.restricted) {
+            // Demand work may use all cores as the guest is waiting on it regardless, the affinity is only changed when it differs from the last job on this thread
+            thread_local std::optional<bool> threadRestricted;
+            bool restrictAffinity{priority != Priority::Demand};
+            if (threadRestricted != restrictAffinity) {
+                host::Topology::Get().SetThreadAffinity(restrictAffinity ? coreConfig.backgroundAffinity : host::AffinityClass::Any);
+                threadRestricted = restrictAffinity;
+            }
+        }
+
+        if (job)
+            job();
+    }
+
     #define VEC_CPY(pointer, size) state.pointer, state.pointer + state.size
 
     GraphicsPipelineAssembler::PipelineDescription::PipelineDescription(const GraphicsPipelineAssembler::PipelineState &state)
@@ -137,7 +232,7 @@ namespace skyline::gpu {
 
     #undef VEC_CPY
 
-    vk::raii::Pipeline GraphicsPipelineAssembler::AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout) {
+    vk::raii::RenderPass GraphicsPipelineAssembler::CreateRenderPass(const PipelineDescription &description) {
         boost::container::small_vector<vk::AttachmentDescription, 8> attachmentDescriptions;
         boost::container::small_vector<vk::AttachmentReference, 8> attachmentReferences;
 
@@ -145,7 +240,7 @@ namespace skyline::gpu {
             if (format != vk::Format::eUndefined) {
                 attachmentDescriptions.push_back(vk::AttachmentDescription{
                     .format = format,
-                    .samples = pipelineDescIt->sampleCount,
+                    .samples = description.sampleCount,
                     .loadOp = vk::AttachmentLoadOp::eLoad,
                     .storeOp = vk::AttachmentStoreOp::eStore,
                     .stencilLoadOp = vk::AttachmentLoadOp::eLoad,
@@ -170,11 +265,11 @@ namespace skyline::gpu {
             .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
         };
 
-        for (auto &colorAttachment : pipelineDescIt->colorFormats)
+        for (auto &colorAttachment : description.colorFormats)
             pushAttachment(colorAttachment);
 
-        if (pipelineDescIt->depthStencilFormat != vk::Format::eUndefined) {
-            pushAttachment(pipelineDescIt->depthStencilFormat);
+        if (description.depthStencilFormat != vk::Format::eUndefined) {
+            pushAttachment(description.depthStencilFormat);
 
             subpassDescription.pColorAttachments = attachmentReferences.data();
             subpassDescription.colorAttachmentCount = static_cast<u32>(attachmentReferences.size() - 1);
@@ -184,12 +279,25 @@ namespace skyline::gpu {
             subpassDescription.colorAttachmentCount = static_cast<u32>(attachmentReferences.size());
         }
 
-        vk::raii::RenderPass renderPass{gpu.vkDevice, vk::RenderPassCreateInfo{
+        return {gpu.vkDevice, vk::RenderPassCreateInfo{
             .attachmentCount = static_cast<u32>(attachmentDescriptions.size()),
             .pAttachments = attachmentDescriptions.data(),
             .subpassCount = 1,
             .pSubpasses = &subpassDescription,
         }};
+    }
+
+    void GraphicsPipelineAssembler::ReleasePipelineDescription(std::list<PipelineDescription>::iterator pipelineDescIt) {
+        if (pipelineDescIt->destroyShaderModules)
+            for (auto &shaderStage : pipelineDescIt->shaderStages)
+                (*gpu.vkDevice).destroyShaderModule(shaderStage.module, nullptr,  *gpu.vkDevice.getDispatcher());
+
+        std::scoped_lock lock{mutex};
+        compilePendingDescs.erase(pipelineDescIt);
+    }
+
+    vk::raii::Pipeline GraphicsPipelineAssembler::AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout) {
+        auto renderPass{CreateRenderPass(*pipelineDescIt)};
 
         auto pipeline{gpu.vkDevice.createGraphicsPipeline(vkPipelineCache, vk::GraphicsPipelineCreateInfo{
             .pStages = pipelineDescIt->shaderStages.data(),
@@ -208,19 +316,179 @@ namespace skyline::gpu {
             .subpass = 0,
         })};
 
-        if (pipelineDescIt->destroyShaderModules)
-            for (auto &shaderStage : pipelineDescIt->shaderStages)
-                (*gpu.vkDevice).destroyShaderModule(shaderStage.module, nullptr,  *gpu.vkDevice.getDispatcher());
+        ReleasePipelineDescription(pipelineDescIt);
+
+        // Pipelines compiled at runtime are periodically written out so they aren't lost if the process is killed
+        if (unsavedPipelineCount.fetch_add(1, std::memory_order_relaxed) + 1 == PipelineCacheSaveThreshold)
+            SavePipelineCache();
 
-        std::scoped_lock lock{mutex};
-        compilePendingDescs.erase(pipelineDescIt);
         return pipeline;
     }
 
+    /**
+     * @brief Appends the raw bytes of a value to a pipeline library key
+     * @note This must only be used with types that have no padding, as padding bytes are indeterminate
+     */
+    template<typename T> requires std::is_trivially_copyable_v<T>
+    static void AppendLibraryKey(std::string &key, const T &value) {
+        key.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    static void AppendLibraryKey(std::string &key, const std::vector<T> &values) {
+        AppendLibraryKey(key, static_cast<u32>(values.size()));
+        key.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+
+    vk::raii::Pipeline GraphicsPipelineAssembler::CreatePipelineLibrary(vk::GraphicsPipelineLibraryFlagsEXT subsets, vk::GraphicsPipelineCreateInfo createInfo) {
+        // Link-time optimization information is retained so that an optimized pipeline can be linked from the libraries later
+        createInfo.flags |= vk::PipelineCreateFlagBits::eLibraryKHR | vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+
+        vk::StructureChain<vk::GraphicsPipelineCreateInfo, vk::GraphicsPipelineLibraryCreateInfoEXT> libraryInfo{
+            createInfo,
+            vk::GraphicsPipelineLibraryCreateInfoEXT{
+                .flags = subsets,
+            }
+        };
 
-    GraphicsPipelineAssembler::CompiledPipeline GraphicsPipelineAssembler::AssemblePipelineAsync(const PipelineState &state, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges, bool noPushDescriptors) {
+        return gpu.vkDevice.createGraphicsPipeline(vkPipelineCache, libraryInfo.get<vk::GraphicsPipelineCreateInfo>());
+    }
+
+    std::shared_ptr<vk::raii::Pipeline> GraphicsPipelineAssembler::GetVertexInputLibrary(const PipelineDescription &description) {
+        std::string key;
+        AppendLibraryKey(key, description.vertexBindings);
+        AppendLibraryKey(key, description.vertexAttributes);
+        AppendLibraryKey(key, description.vertexDivisors);
+        AppendLibraryKey(key, description.inputAssemblyState.topology);
+        AppendLibraryKey(key, description.inputAssemblyState.primitiveRestartEnable);
+        AppendLibraryKey(key, description.dynamicStates);
+
+        std::scoped_lock lock{libraryMutex};
+        auto &library{vertexInputLibraries[key]};
+        if (!library)
+            library = std::make_shared<vk::raii::Pipeline>(CreatePipelineLibrary(vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface, vk::GraphicsPipelineCreateInfo{
+                .pVertexInputState = &description.vertexState.get<vk::PipelineVertexInputStateCreateInfo>(),
+                .pInputAssemblyState = &description.inputAssemblyState,
+                .pDynamicState = &description.dynamicState,
+            }));
+
+        return library;
+    }
+
+    std::shared_ptr<vk::raii::Pipeline> GraphicsPipelineAssembler::GetFragmentOutputLibrary(const PipelineDescription &description, vk::RenderPass renderPass) {
+        std::string key;
+        AppendLibraryKey(key, description.colorFormats);
+        AppendLibraryKey(key, description.depthStencilFormat);
+        AppendLibraryKey(key, description.sampleCount);
+        AppendLibraryKey(key, description.colorBlendAttachments);
+        AppendLibraryKey(key, description.colorBlendState.logicOpEnable);
+        AppendLibraryKey(key, description.colorBlendState.logicOp);
+        AppendLibraryKey(key, description.colorBlendState.blendConstants);
+        AppendLibraryKey(key, description.multisampleState.rasterizationSamples);
+        AppendLibraryKey(key, description.multisampleState.sampleShadingEnable);
+        AppendLibraryKey(key, description.multisampleState.minSampleShading);
+        AppendLibraryKey(key, description.multisampleState.alphaToCoverageEnable);
+        AppendLibraryKey(key, description.multisampleState.alphaToOneEnable);
+        AppendLibraryKey(key, description.dynamicStates);
+
+        std::scoped_lock lock{libraryMutex};
+        auto &library{fragmentOutputLibraries[key]};
+        if (!library)
+            library = std::make_shared<vk::raii::Pipeline>(CreatePipelineLibrary(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface, vk::GraphicsPipelineCreateInfo{
+                .pMultisampleState = &description.multisampleState,
+                .pColorBlendState = &description.colorBlendState,
+                .pDynamicState = &description.dynamicState,
+                .renderPass = renderPass,
+                .subpass = 0,
+            }));
+
+        return library;
+    }
+
+    vk::raii::Pipeline GraphicsPipelineAssembler::LinkPipelineLibraries(const PipelineLibraries &libraries, vk::PipelineLayout pipelineLayout, bool optimize) {
+        auto handles{libraries.GetHandles()};
+        vk::StructureChain<vk::GraphicsPipelineCreateInfo, vk::PipelineLibraryCreateInfoKHR> linkInfo{
+            vk::GraphicsPipelineCreateInfo{
+                .flags = optimize ? vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT : vk::PipelineCreateFlags{},
+                .layout = pipelineLayout,
+            },
+            vk::PipelineLibraryCreateInfoKHR{
+                .libraryCount = static_cast<u32>(handles.size()),
+                .pLibraries = handles.data(),
+            }
+        };
+
+        return gpu.vkDevice.createGraphicsPipeline(vkPipelineCache, linkInfo.get<vk::GraphicsPipelineCreateInfo>());
+    }
+
+    vk::raii::Pipeline GraphicsPipelineAssembler::AssemblePipelineFromLibraries(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout, std::shared_ptr<std::promise<vk::raii::Pipeline>> optimizedPipeline) {
+        try {
+            auto renderPass{CreateRenderPass(*pipelineDescIt)};
+
+            boost::container::static_vector<vk::PipelineShaderStageCreateInfo, 5> preRasterizationStages;
+            boost::container::static_vector<vk::PipelineShaderStageCreateInfo, 1> fragmentStages;
+            for (const auto &stage : pipelineDescIt->shaderStages) {
+                if (stage.stage == vk::ShaderStageFlagBits::eFragment)
+                    fragmentStages.push_back(stage);
+                else
+                    preRasterizationStages.push_back(stage);
+            }
+
+            auto libraries{std::make_shared<PipelineLibraries>(PipelineLibraries{
+                .vertexInput = GetVertexInputLibrary(*pipelineDescIt),
+                .preRasterization = CreatePipelineLibrary(vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders, vk::GraphicsPipelineCreateInfo{
+                    .pStages = preRasterizationStages.data(),
+                    .stageCount = static_cast<u32>(preRasterizationStages.size()),
+                    .pTessellationState = &pipelineDescIt->tessellationState,
+                    .pViewportState = &pipelineDescIt->viewportState,
+                    .pRasterizationState = &pipelineDescIt->rasterizationState.get<vk::PipelineRasterizationStateCreateInfo>(),
+                    .pDynamicState = &pipelineDescIt->dynamicState,
+                    .layout = pipelineLayout,
+                    .renderPass = *renderPass,
+                    .subpass = 0,
+                }),
+                .fragmentShader = CreatePipelineLibrary(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader, vk::GraphicsPipelineCreateInfo{
+                    .pStages = fragmentStages.data(),
+                    .stageCount = static_cast<u32>(fragmentStages.size()),
+                    .pMultisampleState = &pipelineDescIt->multisampleState,
+                    .pDepthStencilState = &pipelineDescIt->depthStencilState,
+                    .pDynamicState = &pipelineDescIt->dynamicState,
+                    .layout = pipelineLayout,
+                    .renderPass = *renderPass,
+                    .subpass = 0,
+                }),
+                .fragmentOutput = GetFragmentOutputLibrary(*pipelineDescIt, *renderPass),
+            })};
+
+            // The shader modules have been consumed by the libraries and aren't required for any subsequent linking
+            ReleasePipelineDescription(pipelineDescIt);
+
+            auto pipeline{LinkPipelineLibraries(*libraries, pipelineLayout, false)};
+
+            std::ignore = QueueTask([this, libraries, pipelineLayout, optimizedPipeline]() {
+                try {
+                    optimizedPipeline->set_value(LinkPipelineLibraries(*libraries, pipelineLayout, true));
+                } catch (const std::exception &e) {
+                    Logger::Warn("Failed to link optimized pipeline: {}", e.what());
+                    optimizedPipeline->set_value(vk::raii::Pipeline{nullptr});
+                }
+
+                // Only optimized pipelines are counted as they're the most expensive to recreate
+                if (unsavedPipelineCount.fetch_add(1, std::memory_order_relaxed) + 1 == PipelineCacheSaveThreshold)
+                    SavePipelineCache();
+            }, Priority::Background);
+
+            return pipeline;
+        } catch (...) {
+            optimizedPipeline->set_value(vk::raii::Pipeline{nullptr});
+            throw;
+        }
+    }
+
+    GraphicsPipelineAssembler::CompiledPipeline GraphicsPipelineAssembler::AssemblePipelineAsync(const PipelineState &state, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges, bool noPushDescriptors, Priority priority) {
+        bool usesPushDescriptors{!noPushDescriptors && gpu.descriptor.CanPushDescriptors(layoutBindings)};
         vk::raii::DescriptorSetLayout descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
-            .flags = vk::DescriptorSetLayoutCreateFlags{(!noPushDescriptors && gpu.traits.supportsPushDescriptors) ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR : vk::DescriptorSetLayoutCreateFlags{}},
+            .flags = vk::DescriptorSetLayoutCreateFlags{usesPushDescriptors ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR : vk::DescriptorSetLayoutCreateFlags{}},
             .pBindings = layoutBindings.data(),
             .bindingCount = static_cast<u32>(layoutBindings.size()),
         }};
@@ -238,8 +506,19 @@ namespace skyline::gpu {
             return std::prev(compilePendingDescs.end());
         }()};
 
-        auto pipelineFuture{pool.submit(&GraphicsPipelineAssembler::AssemblePipeline, this, descIt, *pipelineLayout)};
-        return CompiledPipeline{std::move(descriptorSetLayout), std::move(pipelineLayout), std::move(pipelineFuture)};
+        if (gpu.traits.supportsGraphicsPipelineLibrary) {
+            auto optimizedPipeline{std::make_shared<std::promise<vk::raii::Pipeline>>()};
+            std::shared_future<vk::raii::Pipeline> optimizedPipelineFuture{optimizedPipeline->get_future().share()};
+            auto pipelineFuture{QueueTask([this, descIt, pipelineLayout = *pipelineLayout, optimizedPipeline = std::move(optimizedPipeline)] {
+                return AssemblePipelineFromLibraries(descIt, pipelineLayout, optimizedPipeline);
+            }, priority)};
+            return CompiledPipeline{std::move(descriptorSetLayout), std::move(pipelineLayout), usesPushDescriptors, std::move(pipelineFuture), std::move(optimizedPipelineFuture)};
+        }
+
+        auto pipelineFuture{QueueTask([this, descIt, pipelineLayout = *pipelineLayout] {
+            return AssemblePipeline(descIt, pipelineLayout);
+        }, priority)};
+        return CompiledPipeline{std::move(descriptorSetLayout), std::move(pipelineLayout), usesPushDescriptors, std::move(pipelineFuture)};
     }
 
     void GraphicsPipelineAssembler::WaitIdle() {
@@ -247,9 +526,11 @@ namespace skyline::gpu {
     }
 
     void GraphicsPipelineAssembler::SavePipelineCache() {
-        std::ignore = pool.submit([this] () {
+        std::ignore = QueueTask([this] () {
+            std::scoped_lock lock{pipelineCacheSaveMutex};
+            unsavedPipelineCount.store(0, std::memory_order_relaxed);
             std::vector<u8> rawData{vkPipelineCache.getData()};
             SerialisePipelineCache(gpu, pipelineCacheDir, rawData);
-        });
+        }, Priority::Background);
     }
 }
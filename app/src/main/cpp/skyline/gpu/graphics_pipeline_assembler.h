@@ -4,8 +4,10 @@
 #pragma once
 
 #include <future>
+#include <deque>
 #include <BS_thread_pool.hpp>
 #include <vulkan/vulkan_raii.hpp>
+#include <common/host_topology.h>
 
 namespace skyline::gpu {
     class TextureView;
@@ -54,11 +56,45 @@ namespace skyline::gpu {
             }
         };
 
+        /**
+         * @brief The priority of a compilation task, tasks with a higher priority are always started before any with a lower priority
+         */
+        enum class Priority : u8 {
+            Demand, //!< Work which the guest is blocked on, such as pipelines required for the current draw
+            Normal, //!< Work which is required soon but isn't blocking the guest, such as asynchronously created pipelines
+            Prewarm, //!< Work on populating pipelines from the pipeline cache
+            Background, //!< Work which only improves future performance, such as optimizing pipelines or writing caches
+        };
+
       private:
         GPU &gpu;
         vk::raii::PipelineCache vkPipelineCache; //!< A Vulkan Pipeline Cache which stores all unique graphics pipelines
+
+        /**
+         * @brief The host cores that compilation threads should run on
+         */
+        struct CompileCoreConfig {
+            u32 threadCount; //!< The amount of threads in the compilation thread pool
+            bool restricted; //!< If the affinity of compilation threads is restricted to `backgroundAffinity` for any non-demand work
+            host::AffinityClass backgroundAffinity; //!< The class of cores that non-demand work is restricted to, by default these exclude the fastest cores as they are used by the guest
+        } coreConfig;
+
+        /**
+         * @brief Determines the compilation thread configuration for the host CPU topology
+         * @details On heterogeneous (big.LITTLE) CPUs, non-demand work is restricted to the cores of the supplied class with a thread for each of them
+         * @param singleThreaded If only a single compilation thread should be used
+         */
+        static CompileCoreConfig GetCompileCoreConfig(bool singleThreaded, host::AffinityClass backgroundAffinity);
+
+        static constexpr size_t PriorityCount{static_cast<size_t>(Priority::Background) + 1};
+        std::mutex jobMutex; //!< Protects access to `jobQueues`
+        std::array<std::deque<std::function<void()>>, PriorityCount> jobQueues; //!< Queues of tasks for every priority, every task is paired with a single invocation of RunNextJob() on the thread pool
+        std::atomic<u32> queuedJobCount{}; //!< The combined amount of tasks in all job queues, this can be sampled without locking `jobMutex`
         BS::thread_pool pool;
         std::string pipelineCacheDir;
+        std::mutex pipelineCacheSaveMutex; //!< Serializes writes of the Vulkan pipeline cache to disk
+        std::atomic<u32> unsavedPipelineCount{}; //!< The amount of pipelines compiled since the Vulkan pipeline cache was last written to disk
+        static constexpr u32 PipelineCacheSaveThreshold{128}; //!< The amount of newly compiled pipelines after which the Vulkan pipeline cache is written to disk
 
         /**
          * @brief All unique metadata in a single attachment for a compatible render pass according to Render Pass Compatibility clause in the Vulkan specification
@@ -119,27 +155,102 @@ namespace skyline::gpu {
         std::mutex mutex; //!< Protects access to `compilePendingDescs`
         std::list<PipelineDescription> compilePendingDescs; //!< List of pipeline descriptions that are pending compilation
 
+        /**
+         * @brief Runs the highest priority task in the job queues on the calling thread pool thread
+         * @note As a call to this is queued for every task, a task is always available when this is called
+         */
+        void RunNextJob();
+
+        /**
+         * @brief The graphics pipeline libraries for every state subset of a single pipeline (with VK_EXT_graphics_pipeline_library)
+         */
+        struct PipelineLibraries {
+            std::shared_ptr<vk::raii::Pipeline> vertexInput; //!< Shared between all pipelines with identical vertex input state
+            vk::raii::Pipeline preRasterization;
+            vk::raii::Pipeline fragmentShader;
+            std::shared_ptr<vk::raii::Pipeline> fragmentOutput; //!< Shared between all pipelines with identical fragment output state
+
+            std::array<vk::Pipeline, 4> GetHandles() const {
+                return {**vertexInput, *preRasterization, *fragmentShader, **fragmentOutput};
+            }
+        };
+
+        std::mutex libraryMutex; //!< Protects access to `vertexInputLibraries` and `fragmentOutputLibraries`
+        std::unordered_map<std::string, std::shared_ptr<vk::raii::Pipeline>> vertexInputLibraries; //!< Vertex input libraries keyed by a serialized copy of their state
+        std::unordered_map<std::string, std::shared_ptr<vk::raii::Pipeline>> fragmentOutputLibraries; //!< Fragment output libraries keyed by a serialized copy of their state
+
+        /**
+         * @return The render pass used to compile a pipeline with the given description
+         */
+        vk::raii::RenderPass CreateRenderPass(const PipelineDescription &description);
+
+        /**
+         * @brief Destroys the shader modules of a pipeline description (if requested) and removes it from the pending list
+         */
+        void ReleasePipelineDescription(std::list<PipelineDescription>::iterator pipelineDescIt);
+
         /**
          * @brief Synchronously compiles a pipeline with the state from the given description
          */
         vk::raii::Pipeline AssemblePipeline(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout);
 
+        /**
+         * @brief Creates a single graphics pipeline library of the supplied state subsets
+         */
+        vk::raii::Pipeline CreatePipelineLibrary(vk::GraphicsPipelineLibraryFlagsEXT subsets, vk::GraphicsPipelineCreateInfo createInfo);
+
+        std::shared_ptr<vk::raii::Pipeline> GetVertexInputLibrary(const PipelineDescription &description);
+
+        std::shared_ptr<vk::raii::Pipeline> GetFragmentOutputLibrary(const PipelineDescription &description, vk::RenderPass renderPass);
+
+        /**
+         * @brief Links the supplied libraries into a complete pipeline
+         * @param optimize If the pipeline should be link-time optimized, this is slow and is intended to be done in the background
+         */
+        vk::raii::Pipeline LinkPipelineLibraries(const PipelineLibraries &libraries, vk::PipelineLayout pipelineLayout, bool optimize);
+
+        /**
+         * @brief Synchronously compiles libraries for the state in the given description and fast-links them into a pipeline, an optimized pipeline is then linked in the background
+         * @param optimizedPipeline The promise which is fulfilled with the optimized pipeline or a null pipeline if optimization fails
+         */
+        vk::raii::Pipeline AssemblePipelineFromLibraries(std::list<PipelineDescription>::iterator pipelineDescIt, vk::PipelineLayout pipelineLayout, std::shared_ptr<std::promise<vk::raii::Pipeline>> optimizedPipeline);
+
       public:
-        GraphicsPipelineAssembler(GPU &gpu, std::string_view pipelineCacheDir);
+        /**
+         * @param backgroundAffinity The class of host cores that compilation threads are restricted to for any work the guest isn't blocked on
+         */
+        GraphicsPipelineAssembler(GPU &gpu, std::string_view pipelineCacheDir, host::AffinityClass backgroundAffinity);
 
         struct CompiledPipeline {
             vk::raii::DescriptorSetLayout descriptorSetLayout;
             vk::raii::PipelineLayout pipelineLayout;
             std::shared_future<vk::raii::Pipeline> pipeline;
+            std::shared_future<vk::raii::Pipeline> optimizedPipeline; //!< A link-time optimized version of `pipeline` that should be preferred once ready, this is only valid when pipeline libraries are used and may be a null pipeline if optimization failed
+            bool usesPushDescriptors{}; //!< If the descriptor set layout is a push descriptor layout, otherwise sets must be allocated from the descriptor pool
 
             CompiledPipeline() : descriptorSetLayout{nullptr}, pipelineLayout{nullptr} {};
 
             CompiledPipeline(vk::raii::DescriptorSetLayout descriptorSetLayout,
                              vk::raii::PipelineLayout pipelineLayout,
-                             std::shared_future<vk::raii::Pipeline> pipeline)
+                             bool usesPushDescriptors,
+                             std::shared_future<vk::raii::Pipeline> pipeline,
+                             std::shared_future<vk::raii::Pipeline> optimizedPipeline = {})
                 : descriptorSetLayout{std::move(descriptorSetLayout)},
                   pipelineLayout{std::move(pipelineLayout)},
-                  pipeline{std::move(pipeline)} {};
+                  pipeline{std::move(pipeline)},
+                  optimizedPipeline{std::move(optimizedPipeline)},
+                  usesPushDescriptors{usesPushDescriptors} {};
+
+            /**
+             * @return The optimized pipeline if it's ready, otherwise the regular pipeline which is waited on
+             */
+            vk::Pipeline GetPipeline() const {
+                if (optimizedPipeline.valid() && optimizedPipeline.wait_for(std::chrono::nanoseconds{}) == std::future_status::ready)
+                    if (vk::Pipeline optimized{*optimizedPipeline.get()})
+                        return optimized;
+
+                return *pipeline.get();
+            }
         };
 
         /**
@@ -147,7 +258,33 @@ namespace skyline::gpu {
          * @note Shader specializiation constants are **not** supported and will result in UB
          * @note Input/Resolve attachments are **not** supported and using them with the supplied pipeline will result in UB
          */
-        CompiledPipeline AssemblePipelineAsync(const PipelineState &state, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges = {}, bool noPushDescriptors = false);
+        CompiledPipeline AssemblePipelineAsync(const PipelineState &state, span<const vk::DescriptorSetLayoutBinding> layoutBindings, span<const vk::PushConstantRange> pushConstantRanges = {}, bool noPushDescriptors = false, Priority priority = Priority::Demand);
+
+        /**
+         * @brief Queues a task on the pipeline compilation thread pool, this is used to move the creation of any state a pipeline depends on off the calling thread
+         * @return A future holding the result of the task
+         */
+        template<typename Task>
+        auto QueueTask(Task &&task, Priority priority = Priority::Normal) {
+            using ResultType = std::invoke_result_t<std::decay_t<Task>>;
+            auto packagedTask{std::make_shared<std::packaged_task<ResultType()>>(std::forward<Task>(task))};
+            auto future{packagedTask->get_future()};
+            {
+                std::scoped_lock lock{jobMutex};
+                jobQueues[static_cast<size_t>(priority)].emplace_back([packagedTask] { (*packagedTask)(); });
+                queuedJobCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            std::ignore = pool.submit(&GraphicsPipelineAssembler::RunNextJob, this);
+            return future;
+        }
+
+        /**
+         * @return The amount of tasks waiting on the pipeline compilation thread pool, this excludes tasks that are already being run
+         */
+        u32 GetQueuedJobCount() const {
+            return queuedJobCount.load(std::memory_order_relaxed);
+        }
 
         /**
          * @brief Waits until the pipeline compilation thread pool is idle and all pipelines have been compiled
@@ -6,6 +6,8 @@
 #include <range/v3/view.hpp>
 #include <adrenotools/driver.h>
 #include <common/settings.h>
+#include <common/frame_statistics.h>
+#include <common/performance_hint.h>
 #include <loader/loader.h>
 #include <gpu.h>
 #include <dlfcn.h>
@@ -13,11 +15,41 @@
 #include <nce.h>
 
 namespace skyline::gpu::interconnect {
+    ExecutionTimestamps::ExecutionTimestamps(GPU &gpu)
+        : pool{gpu.vkDevice, vk::QueryPoolCreateInfo{
+            .queryType = vk::QueryType::eTimestamp,
+            .queryCount = MaxRegions * 2,
+        }} {}
+
+    void ExecutionTimestamps::BeginRegion(vk::raii::CommandBuffer &commandBuffer, bool renderPass) {
+        if (regions.size() == MaxRegions)
+            return;
+
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *pool, static_cast<u32>(regions.size() * 2));
+        regions.push_back(Region{renderPass});
+        regionOpen = true;
+    }
+
+    void ExecutionTimestamps::EndRegion(vk::raii::CommandBuffer &commandBuffer) {
+        if (!regionOpen)
+            return;
+
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *pool, static_cast<u32>(regions.size() * 2 - 1));
+        regionOpen = false;
+    }
+
     CommandRecordThread::CommandRecordThread(const DeviceState &state)
         : state{state},
-          incoming{1U << *state.settings->executorSlotCountScale},
-          outgoing{1U << *state.settings->executorSlotCountScale},
-          thread{&CommandRecordThread::Run, this} {}
+          queueIndex{state.gpu->scheduler.AllocateQueue()},
+          outgoing{1U << *state.settings->executorSlotCountScale} {
+        // A worker is only useful if there are enough slots to have several executions in flight at once
+        size_t slotCount{1U << *state.settings->executorSlotCountScale};
+        size_t workerCount{std::clamp<size_t>(std::min<size_t>(std::thread::hardware_concurrency() / 4, slotCount / 4), 1, MaxWorkerCount)};
+        for (size_t i{}; i < workerCount; i++) {
+            auto &worker{workers.emplace_back(slotCount)};
+            worker.thread = std::thread{&CommandRecordThread::Run, this, std::ref(worker), i};
+        }
+    }
 
     CommandRecordThread::Slot::ScopedBegin::ScopedBegin(CommandRecordThread::Slot &slot) : slot{slot} {}
 
@@ -43,9 +75,9 @@ namespace skyline::gpu::interconnect {
                       }
           },
           commandBuffer{AllocateRaiiCommandBuffer(gpu, commandPool)},
-          fence{gpu.vkDevice, vk::FenceCreateInfo{ .flags = vk::FenceCreateFlagBits::eSignaled }},
+          fence{gpu.scheduler.UsesTimeline() ? vk::raii::Fence{nullptr} : vk::raii::Fence{gpu.vkDevice, vk::FenceCreateInfo{ .flags = vk::FenceCreateFlagBits::eSignaled }}},
           semaphore{gpu.vkDevice, vk::SemaphoreCreateInfo{}},
-          cycle{std::make_shared<FenceCycle>(gpu.vkDevice, *fence, *semaphore, true)},
+          cycle{MakePooledShared<FenceCycle>(gpu.vkDevice, *fence, *semaphore, true)},
           nodes{allocator} {
         Begin();
     }
@@ -58,13 +90,14 @@ namespace skyline::gpu::interconnect {
           cycle{std::move(other.cycle)},
           allocator{std::move(other.allocator)},
           nodes{std::move(other.nodes)},
+          timestamps{std::move(other.timestamps)},
           ready{other.ready} {}
 
     std::shared_ptr<FenceCycle> CommandRecordThread::Slot::Reset(GPU &gpu) {
         auto startTime{util::GetTimeNs()};
 
         cycle->Wait();
-        cycle = std::make_shared<FenceCycle>(*cycle);
+        cycle = MakePooledShared<FenceCycle>(*cycle);
         if (util::GetTimeNs() - startTime > GrowThresholdNs)
             didWait = true;
 
@@ -94,13 +127,30 @@ namespace skyline::gpu::interconnect {
         vk::RenderPass lRenderPass;
         u32 subpassIndex;
 
+        // Every render pass is timed individually while all consecutive commands outside of render passes are timed together
+        auto *timestamps{slot->timestamps.get()};
+        bool inRenderPass{};
+        if (timestamps)
+            slot->commandBuffer.resetQueryPool(*timestamps->pool, 0, ExecutionTimestamps::MaxRegions * 2);
+
+        auto recordStart{static_cast<u64>(util::GetTimeNs())};
         using namespace node;
         for (NodeVariant &node : slot->nodes) {
             #define NODE(name) [&](name& node) { node(slot->commandBuffer, slot->cycle, gpu); }
             std::visit(VariantVisitor{
-                NODE(FunctionNode),
+                [&](FunctionNode &node) {
+                    if (timestamps && !inRenderPass && !timestamps->regionOpen)
+                        timestamps->BeginRegion(slot->commandBuffer, false);
+                    node(slot->commandBuffer, slot->cycle, gpu);
+                },
 
                 [&](RenderPassNode &node) {
+                    if (timestamps) {
+                        timestamps->EndRegion(slot->commandBuffer);
+                        timestamps->BeginRegion(slot->commandBuffer, true);
+                    }
+                    inRenderPass = true;
+
                     lRenderPass = node(slot->commandBuffer, slot->cycle, gpu);
                     subpassIndex = 0;
                 },
@@ -112,21 +162,39 @@ namespace skyline::gpu::interconnect {
                 [&](SubpassFunctionNode &node) { node(slot->commandBuffer, slot->cycle, gpu, lRenderPass, subpassIndex); },
                 [&](NextSubpassFunctionNode &node) { node(slot->commandBuffer, slot->cycle, gpu, lRenderPass, ++subpassIndex); },
 
-                NODE(RenderPassEndNode),
+                [&](RenderPassEndNode &node) {
+                    node(slot->commandBuffer, slot->cycle, gpu);
+
+                    inRenderPass = false;
+                    if (timestamps)
+                        timestamps->EndRegion(slot->commandBuffer);
+                },
             }, node);
             #undef NODE
         }
 
+        if (timestamps)
+            timestamps->EndRegion(slot->commandBuffer);
+
         slot->commandBuffer.end();
         slot->ready = false;
+        FrameStatistics::Record(FrameStatistics::Phase::CommandRecording, static_cast<u64>(util::GetTimeNs()) - recordStart);
 
-        gpu.scheduler.SubmitCommandBuffer(slot->commandBuffer, slot->cycle);
+        {
+            // Slots recorded on other workers may have been released earlier and must be submitted first
+            std::unique_lock lock{submitMutex};
+            submitCondition.wait(lock, [&] { return submitSequence == slot->sequence; });
+            gpu.scheduler.SubmitCommandBuffer(slot->commandBuffer, slot->cycle, {}, {}, queueIndex);
+            submitSequence++;
+        }
+        submitCondition.notify_all();
 
         slot->nodes.clear();
         slot->allocator.Reset();
+        slot->timestamps.reset();
     }
 
-    void CommandRecordThread::Run() {
+    void CommandRecordThread::Run(Worker &worker, size_t index) {
         auto &gpu{*state.gpu};
 
         RENDERDOC_API_1_4_2 *renderDocApi{};
@@ -136,16 +204,22 @@ namespace skyline::gpu::interconnect {
                 Logger::Warn("Failed to intialise RenderDoc API: {}", ret);
         }
 
-        outgoing.Push(&slots.emplace_back(gpu));
+        if (index == 0) {
+            std::scoped_lock lock{slotMutex};
+            outgoing.Push(&slots.emplace_back(gpu));
+        }
 
-        if (int result{pthread_setname_np(pthread_self(), "Sky-CmdRecord")})
+        if (int result{pthread_setname_np(pthread_self(), index ? fmt::format("Sky-CmdRecord{}", index).c_str() : "Sky-CmdRecord")})
             Logger::Warn("Failed to set the thread name: {}", strerror(result));
 
+        host::Topology::Get().SetThreadAffinity(*state.settings->commandRecordAffinity);
+        host::PerformanceHint::ScopedThread performanceHintThread;
+
         try {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, signal::ExceptionalSignalHandler);
 
-            incoming.Process([this, renderDocApi, &gpu](Slot *slot) {
-                idle = false;
+            worker.incoming.Process([this, renderDocApi, &gpu](Slot *slot) {
+                busyWorkers++;
                 VkInstance instance{*gpu.vkInstance};
                 if (renderDocApi && slot->capture)
                     renderDocApi->StartFrameCapture(RENDERDOC_DEVICEPOINTER_FROM_VKINSTANCE(instance), nullptr);
@@ -156,14 +230,17 @@ namespace skyline::gpu::interconnect {
                     renderDocApi->EndFrameCapture(RENDERDOC_DEVICEPOINTER_FROM_VKINSTANCE(instance), nullptr);
                 slot->capture = false;
 
-                if (slot->didWait && (slots.size() + 1) < (1U << *state.settings->executorSlotCountScale)) {
-                    outgoing.Push(&slots.emplace_back(gpu));
-                    outgoing.Push(&slots.emplace_back(gpu));
+                if (slot->didWait) {
+                    std::scoped_lock lock{slotMutex};
+                    if ((slots.size() + 1) < (1U << *state.settings->executorSlotCountScale)) {
+                        outgoing.Push(&slots.emplace_back(gpu));
+                        outgoing.Push(&slots.emplace_back(gpu));
+                    }
                     slot->didWait = false;
                 }
 
                 outgoing.Push(slot);
-                idle = true;
+                busyWorkers--;
             }, [] {});
         } catch (const signal::SignalException &e) {
             Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
@@ -181,7 +258,7 @@ namespace skyline::gpu::interconnect {
     }
 
     bool CommandRecordThread::IsIdle() const {
-        return idle;
+        return !busyWorkers;
     }
 
     CommandRecordThread::Slot *CommandRecordThread::AcquireSlot() {
@@ -194,7 +271,37 @@ namespace skyline::gpu::interconnect {
     }
 
     void CommandRecordThread::ReleaseSlot(Slot *slot) {
-        incoming.Push(slot);
+        slot->sequence = releaseSequence++;
+        workers[nextWorker].incoming.Push(slot);
+        nextWorker = (nextWorker + 1) % workers.size();
+    }
+
+    void ExecutionWaiterThread::TraceTimestamps(ExecutionTimestamps &timestamps, u64 signalTimestamp) {
+        if (timestamps.regions.empty())
+            return;
+
+        auto &traits{state.gpu->traits};
+        auto queryCount{static_cast<u32>(timestamps.regions.size() * 2)};
+        auto results{timestamps.pool.getResults<u64>(0, queryCount, queryCount * sizeof(u64), sizeof(u64), vk::QueryResultFlagBits::e64)};
+        if (results.first != vk::Result::eSuccess)
+            return;
+        auto &ticks{results.second};
+
+        // Timestamps are relative to the first one of the execution, masking the difference handles the counter wrapping around within the execution
+        u64 validMask{traits.timestampValidBits >= 64 ? std::numeric_limits<u64>::max() : (1ULL << traits.timestampValidBits) - 1};
+        auto toNs{[&](u64 tick) {
+            return static_cast<u64>(static_cast<double>((tick - ticks.front()) & validMask) * traits.timestampPeriod);
+        }};
+
+        // GPU timestamps are in a different time domain to the trace clock, the end of the last region is assumed to be when the execution signalled which was observed shortly before the signal timestamp
+        u64 executionEnd{toNs(ticks.back())};
+        u64 executionStart{std::max(signalTimestamp - std::min(signalTimestamp, executionEnd), lastTimestampEnd)};
+        for (size_t index{}; index < timestamps.regions.size(); index++) {
+            u64 begin{executionStart + toNs(ticks[index * 2])}, end{std::max(executionStart + toNs(ticks[index * 2 + 1]), begin)};
+            TRACE_EVENT_BEGIN("gpu", perfetto::StaticString{timestamps.regions[index].renderPass ? "Render Pass" : "Outside Render Pass"}, timestampTrack, begin);
+            TRACE_EVENT_END("gpu", timestampTrack, end);
+            lastTimestampEnd = end;
+        }
     }
 
     void ExecutionWaiterThread::Run() {
@@ -204,8 +311,9 @@ namespace skyline::gpu::interconnect {
         if (*state.settings->forceMaxGpuClocks)
             adrenotools_set_turbo(true);
 
+        u64 lastSignalTimestamp{};
         while (true) {
-            std::pair<std::shared_ptr<FenceCycle>, std::function<void()>> item{};
+            PendingSignal item{};
             {
                 std::unique_lock lock{mutex};
                 if (pendingSignalQueue.empty()) {
@@ -226,26 +334,45 @@ namespace skyline::gpu::interconnect {
                 item = std::move(pendingSignalQueue.front());
                 pendingSignalQueue.pop();
             }
-            {
-                TRACE_EVENT("gpu", "GPU");
-                if (item.first)
-                    item.first->Wait();
+            if (item.cycle) {
+                {
+                    TRACE_EVENT("gpu", "GPU");
+                    item.cycle->Wait();
+                }
+
+                if (item.timestamps)
+                    TraceTimestamps(*item.timestamps, perfetto::TrackEvent::GetTraceTimeNs());
+
+                // Executions are completed in order, so the GPU can't have started on this one before the prior one was completed
+                auto signalTimestamp{static_cast<u64>(util::GetTimeNs())};
+                FrameStatistics::Record(FrameStatistics::Phase::GpuExecution, signalTimestamp - std::max(item.queueTimestamp, lastSignalTimestamp));
+                lastSignalTimestamp = signalTimestamp;
             }
 
-            if (item.second)
-                item.second();
+            if (item.callback)
+                item.callback();
+
+            pendingCount.fetch_sub(1, std::memory_order_relaxed);
         }
     }
 
-    ExecutionWaiterThread::ExecutionWaiterThread(const DeviceState &state) : state{state}, thread{&ExecutionWaiterThread::Run, this} {}
+    ExecutionWaiterThread::ExecutionWaiterThread(const DeviceState &state, u32 queueIndex)
+        : state{state},
+          timestampTrack{queueIndex, perfetto::Track{static_cast<u64>(trace::TrackIds::Gpu), perfetto::ProcessTrack::Current()}},
+          thread{&ExecutionWaiterThread::Run, this} {
+        auto desc{timestampTrack.Serialize()};
+        desc.set_name(fmt::format("GPU Queue {}", queueIndex));
+        perfetto::TrackEvent::SetTrackDescriptor(timestampTrack, desc);
+    }
 
     bool ExecutionWaiterThread::IsIdle() const {
         return idle;
     }
 
-    void ExecutionWaiterThread::Queue(std::shared_ptr<FenceCycle> cycle, std::function<void()> &&callback) {
+    void ExecutionWaiterThread::Queue(std::shared_ptr<FenceCycle> cycle, std::function<void()> &&callback, std::shared_ptr<ExecutionTimestamps> timestamps) {
         std::unique_lock lock{mutex};
-        pendingSignalQueue.push({std::move(cycle), std::move(callback)});
+        pendingSignalQueue.push({std::move(cycle), std::move(callback), static_cast<u64>(util::GetTimeNs()), std::move(timestamps)});
+        pendingCount.fetch_add(1, std::memory_order_relaxed);
         condition.notify_all();
     }
 
@@ -253,7 +380,8 @@ namespace skyline::gpu::interconnect {
         : state{state},
           gpu{*state.gpu},
           recordThread{state},
-          waiterThread{state},
+          waiterThread{state, recordThread.GetQueueIndex()},
+          flushThreshold{*state.settings->executorFlushThreshold},
           tag{AllocateTag()} {
         RotateRecordSlot();
     }
@@ -276,6 +404,21 @@ namespace skyline::gpu::interconnect {
     }
 
     bool CommandExecutor::CreateRenderPassWithSubpass(vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, bool noSubpassCreation) {
+        // Pending clears of attachments bound in this subpass are folded into their load ops, the rest are recorded with subpasses of their own before it
+        boost::container::small_vector<PendingClear, 4> foldedClears;
+        if (!pendingClears.empty()) {
+            auto clears{std::move(pendingClears)};
+            pendingClears.clear();
+            for (const auto &clear : clears) {
+                if (CanFoldClear(clear, renderArea, sampledImages, inputAttachments, colorAttachments, depthStencilAttachment))
+                    foldedClears.push_back(clear);
+                else
+                    RecordClearSubpass(clear);
+            }
+        }
+
+        FlushTransferBarrier();
+
         auto addSubpass{[&] {
             renderPass->AddSubpass(inputAttachments, colorAttachments, depthStencilAttachment, gpu);
 
@@ -304,7 +447,21 @@ namespace skyline::gpu::interconnect {
                               ranges::equal(lastSubpassColorAttachments, colorAttachments) &&
                               lastSubpassDepthStencilAttachment == depthStencilAttachment};
 
-        bool splitRenderPass{renderPass == nullptr || renderPass->renderArea != renderArea ||
+        // Subpasses with differing render areas can share a render pass by covering the union of their areas
+        std::optional<vk::Rect2D> mergedRenderArea;
+        if (renderPass && renderPass->renderArea != renderArea) {
+            vk::Extent2D newAttachmentExtent{std::numeric_limits<u32>::max(), std::numeric_limits<u32>::max()};
+            for (auto view : ranges::views::concat(inputAttachments, outputAttachmentViews)) {
+                if (view) {
+                    newAttachmentExtent.width = std::min(newAttachmentExtent.width, view->texture->dimensions.width);
+                    newAttachmentExtent.height = std::min(newAttachmentExtent.height, view->texture->dimensions.height);
+                }
+            }
+
+            mergedRenderArea = renderPass->GetMergedRenderArea(renderArea, newAttachmentExtent);
+        }
+
+        bool splitRenderPass{renderPass == nullptr || (renderPass->renderArea != renderArea && !mergedRenderArea) ||
             ((noSubpassCreation || subpassCount >= gpu.traits.quirks.maxSubpassCount) && !attachmentsMatch) ||
             !ranges::all_of(outputAttachmentViews, [this] (auto view) { return !view || view->texture->ValidateRenderPassUsage(renderPassIndex, texture::RenderPassUsage::RenderTarget); }) ||
             !ranges::all_of(sampledImages, [this] (auto view) { return view->texture->ValidateRenderPassUsage(renderPassIndex, texture::RenderPassUsage::Sampled); })};
@@ -319,11 +476,16 @@ namespace skyline::gpu::interconnect {
             renderPass = &std::get<node::RenderPassNode>(slot->nodes.emplace_back(std::in_place_type_t<node::RenderPassNode>(), renderArea));
             addSubpass();
             subpassCount = 1;
-        } else if (!attachmentsMatch) {
-            // The last subpass had different attachments, so we need to create a new one
-            addSubpass();
-            subpassCount++;
-            gotoNext = true;
+        } else {
+            if (mergedRenderArea)
+                renderPass->renderArea = *mergedRenderArea;
+
+            if (!attachmentsMatch) {
+                // The last subpass had different attachments, so we need to create a new one
+                addSubpass();
+                subpassCount++;
+                gotoNext = true;
+            }
         }
 
         for (auto view : outputAttachmentViews)
@@ -333,6 +495,31 @@ namespace skyline::gpu::interconnect {
         for (auto view : sampledImages)
             view->texture->UpdateRenderPassUsage(renderPassIndex, texture::RenderPassUsage::Sampled);
 
+        for (const auto &clear : foldedClears) {
+            u32 colorAttachment{static_cast<u32>(std::distance(colorAttachments.begin(), ranges::find(colorAttachments, clear.attachment)))};
+            if (clear.depthStencil ? renderPass->ClearDepthStencilAttachment(clear.value.depthStencil, gpu) : renderPass->ClearColorAttachment(colorAttachment, clear.value.color, gpu))
+                continue;
+
+            // The load op couldn't be used, so the attachment is cleared at the start of the subpass instead
+            auto function{[aspect = clear.depthStencil ? clear.attachment->format->vkAspect : vk::ImageAspectFlagBits::eColor, colorAttachment, extent = clear.attachment->texture->dimensions, value = clear.value](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
+                commandBuffer.clearAttachments(vk::ClearAttachment{
+                    .aspectMask = aspect,
+                    .colorAttachment = colorAttachment,
+                    .clearValue = value,
+                }, vk::ClearRect{
+                    .rect.extent = extent,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                });
+            }};
+
+            if (gotoNext)
+                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), slot->allocator, function);
+            else
+                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), slot->allocator, function);
+            gotoNext = false;
+        }
+
         return gotoNext;
     }
 
@@ -425,69 +612,91 @@ namespace skyline::gpu::interconnect {
         cycle->AttachObject(dependency);
     }
 
-    void CommandExecutor::AddSubpass(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, bool noSubpassCreation) {
-        bool gotoNext{CreateRenderPassWithSubpass(renderArea, sampledImages, inputAttachments, colorAttachments, depthStencilAttachment ? &*depthStencilAttachment : nullptr, noSubpassCreation)};
-        if (gotoNext)
-            slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), std::forward<decltype(function)>(function));
-        else
-            slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), std::forward<decltype(function)>(function));
-
-        if (slot->nodes.size() > *state.settings->executorFlushThreshold && !gotoNext)
-            Submit();
+    void CommandExecutor::AddMemoryBarrier(vk::PipelineStageFlags srcStage, vk::PipelineStageFlags dstStage, vk::AccessFlags srcAccess, vk::AccessFlags dstAccess) {
+        slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), slot->allocator, [=](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+            commandBuffer.pipelineBarrier(srcStage, dstStage, {}, vk::MemoryBarrier{
+                .srcAccessMask = srcAccess,
+                .dstAccessMask = dstAccess,
+            }, {}, {});
+        });
     }
 
-    void CommandExecutor::AddOutsideRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function) {
+    void CommandExecutor::PrepareTransferCommand(span<u8> srcRange, span<u8> dstRange) {
+        FlushPendingClears();
         if (renderPass)
             FinishRenderPass();
 
-        slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), std::forward<decltype(function)>(function));
+        auto overlaps{[](const std::vector<span<u8>> &pendingRanges, span<u8> range) {
+            return range.valid() && ranges::any_of(pendingRanges, [range](span<u8> pending) {
+                return pending.begin() < range.end() && range.begin() < pending.end();
+            });
+        }};
+
+        if (nonTransferCommandPending) {
+            // Prior commands may still be accessing the ranges this command will access, this also covers any prior transfer commands
+            AddMemoryBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer,
+                             vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite);
+            nonTransferCommandPending = false;
+            pendingTransferReads.clear();
+            pendingTransferWrites.clear();
+        } else if (overlaps(pendingTransferWrites, srcRange) || overlaps(pendingTransferWrites, dstRange) || overlaps(pendingTransferReads, dstRange)) {
+            // Transfers to disjoint ranges can execute concurrently, only overlapping ones need to be synchronized against each other
+            AddMemoryBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer,
+                             vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite);
+            pendingTransferReads.clear();
+            pendingTransferWrites.clear();
+        }
+
+        if (srcRange.valid())
+            pendingTransferReads.emplace_back(srcRange);
+        pendingTransferWrites.emplace_back(dstRange);
+        transferBarrierPending = true;
     }
 
-    void CommandExecutor::AddFullBarrier() {
-        AddOutsideRpCommand([](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
-            commandBuffer.pipelineBarrier(
-                vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
-                    .srcAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
-                    .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
-                }, {}, {}
-            );
-        });
+    void CommandExecutor::FlushTransferBarrier() {
+        if (transferBarrierPending) {
+            AddMemoryBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands,
+                             vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+            transferBarrierPending = false;
+            pendingTransferReads.clear();
+            pendingTransferWrites.clear();
+        }
+
+        nonTransferCommandPending = true;
     }
 
-    void CommandExecutor::AddClearColorSubpass(TextureView *attachment, const vk::ClearColorValue &value) {
-        bool gotoNext{CreateRenderPassWithSubpass(vk::Rect2D{.extent = attachment->texture->dimensions}, {}, {}, attachment, nullptr)};
-        if (renderPass->ClearColorAttachment(0, value, gpu)) {
-            if (gotoNext)
-                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassNode>());
-        } else {
-            auto function{[scissor = attachment->texture->dimensions, value](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
-                commandBuffer.clearAttachments(vk::ClearAttachment{
-                    .aspectMask = vk::ImageAspectFlagBits::eColor,
-                    .colorAttachment = 0,
-                    .clearValue = value,
-                }, vk::ClearRect{
-                    .rect = vk::Rect2D{.extent = scissor},
-                    .baseArrayLayer = 0,
-                    .layerCount = 1,
-                });
-            }};
+    void CommandExecutor::AddFullBarrier() {
+        FlushPendingClears();
 
-            if (gotoNext)
-                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), function);
-            else
-                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), function);
-        }
+        // The barrier at the start of the command buffer or the last full barrier already covers everything if nothing was recorded since
+        if (slot->nodes.size() == lastFullBarrierNodeCount)
+            return;
+
+        if (renderPass)
+            FinishRenderPass();
+
+        AddMemoryBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands,
+                         vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite, vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+
+        transferBarrierPending = false;
+        nonTransferCommandPending = false;
+        pendingTransferReads.clear();
+        pendingTransferWrites.clear();
+        lastFullBarrierNodeCount = slot->nodes.size();
     }
 
-    void CommandExecutor::AddClearDepthStencilSubpass(TextureView *attachment, const vk::ClearDepthStencilValue &value) {
-        bool gotoNext{CreateRenderPassWithSubpass(vk::Rect2D{.extent = attachment->texture->dimensions}, {}, {}, {}, attachment)};
-        if (renderPass->ClearDepthStencilAttachment(value, gpu)) {
+    void CommandExecutor::RecordClearSubpass(const PendingClear &clear) {
+        auto attachment{clear.attachment};
+        bool gotoNext{clear.depthStencil ? CreateRenderPassWithSubpass(vk::Rect2D{.extent = attachment->texture->dimensions}, {}, {}, {}, attachment)
+                                         : CreateRenderPassWithSubpass(vk::Rect2D{.extent = attachment->texture->dimensions}, {}, {}, attachment, nullptr)};
+        if (clear.depthStencil ? renderPass->ClearDepthStencilAttachment(clear.value.depthStencil, gpu) : renderPass->ClearColorAttachment(0, clear.value.color, gpu)) {
             if (gotoNext)
                 slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassNode>());
         } else {
-            auto function{[aspect = attachment->format->vkAspect, extent = attachment->texture->dimensions, value](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
+            auto function{[aspect = clear.depthStencil ? attachment->format->vkAspect : vk::ImageAspectFlagBits::eColor, extent = attachment->texture->dimensions, value = clear.value](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
                 commandBuffer.clearAttachments(vk::ClearAttachment{
                     .aspectMask = aspect,
+                    .colorAttachment = 0,
                     .clearValue = value,
                 }, vk::ClearRect{
                     .rect.extent = extent,
@@ -497,12 +706,57 @@ namespace skyline::gpu::interconnect {
             }};
 
             if (gotoNext)
-                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), function);
+                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), slot->allocator, function);
             else
-                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), function);
+                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), slot->allocator, function);
         }
     }
 
+    void CommandExecutor::FlushPendingClears() {
+        if (pendingClears.empty())
+            return;
+
+        // The pending clears are moved out prior to recording them as recording the subpasses would otherwise attempt to fold them
+        auto clears{std::move(pendingClears)};
+        pendingClears.clear();
+        for (const auto &clear : clears)
+            RecordClearSubpass(clear);
+    }
+
+    bool CommandExecutor::CanFoldClear(const PendingClear &clear, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment) {
+        auto texture{clear.attachment->texture.get()};
+
+        // A load op clear only applies to the render area, it must cover the entire attachment for the clear to be complete
+        if (renderArea.offset != vk::Offset2D{} || renderArea.extent != vk::Extent2D{texture->dimensions})
+            return false;
+
+        // Any read of the texture in the subpass must observe the clear, which a load op clear can't provide
+        if (ranges::any_of(ranges::views::concat(sampledImages, inputAttachments), [texture](TextureView *view) { return view->texture.get() == texture; }))
+            return false;
+
+        if (clear.depthStencil ? depthStencilAttachment != clear.attachment : ranges::count(colorAttachments, clear.attachment) != 1 || depthStencilAttachment == clear.attachment)
+            return false;
+
+        // The load op of an attachment that's already in the render pass applies prior to any of its earlier subpasses
+        return !renderPass || !renderPass->HasAttachment(clear.attachment);
+    }
+
+    void CommandExecutor::AddClearColorSubpass(TextureView *attachment, const vk::ClearColorValue &value) {
+        PendingClear clear{attachment, value, false};
+        if (auto it{ranges::find(pendingClears, attachment, &PendingClear::attachment)}; it != pendingClears.end())
+            *it = clear; // A clear of the entire attachment supersedes any prior one
+        else
+            pendingClears.push_back(clear);
+    }
+
+    void CommandExecutor::AddClearDepthStencilSubpass(TextureView *attachment, const vk::ClearDepthStencilValue &value) {
+        PendingClear clear{attachment, value, true};
+        if (auto it{ranges::find(pendingClears, attachment, &PendingClear::attachment)}; it != pendingClears.end())
+            *it = clear;
+        else
+            pendingClears.push_back(clear);
+    }
+
     void CommandExecutor::AddFlushCallback(std::function<void()> &&callback) {
         flushCallbacks.emplace_back(std::forward<decltype(callback)>(callback));
     }
@@ -542,6 +796,12 @@ namespace skyline::gpu::interconnect {
 
                 texture->cycle = cycle;
                 texture->UpdateRenderPassUsage(0, texture::RenderPassUsage::None);
+
+                // Textures that the guest frequently reads back are copied out at the end of the execution, so the readback doesn't need to wait on a submission of its own
+                if (texture->PrepareReadbackPrefetch(cycle))
+                    AddOutsideRpCommand([texture = texture.texture.get()](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+                        texture->RecordReadbackPrefetch(commandBuffer);
+                    });
             }
         }
 
@@ -557,12 +817,33 @@ namespace skyline::gpu::interconnect {
         RotateRecordSlot();
     }
 
+    void CommandExecutor::UpdateFlushThreshold() {
+        u32 configuredThreshold{*state.settings->executorFlushThreshold};
+        u32 pendingCount{waiterThread.GetPendingCount()};
+        if (pendingCount == 0)
+            // The GPU has run out of work, smaller executions get work to it sooner
+            flushThreshold = std::max(configuredThreshold / FlushThresholdScale, flushThreshold - flushThreshold / 4);
+        else if (pendingCount >= SaturatedPendingCount)
+            // The GPU is busy with prior executions, larger executions amortize the per-submission overhead without delaying the GPU
+            flushThreshold = std::min(configuredThreshold * FlushThresholdScale, flushThreshold + flushThreshold / 4 + 1);
+
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Executor Flush Threshold"}, flushThreshold);
+        TRACE_COUNTER("gpu", perfetto::CounterTrack{"Executor Pending Executions"}, pendingCount);
+    }
+
     void CommandExecutor::ResetInternal() {
         attachedTextures.clear();
         attachedBuffers.clear();
         allocator->Reset();
         renderPassIndex = 0;
 
+        // The barrier at the start of the next command buffer covers all prior commands
+        transferBarrierPending = false;
+        nonTransferCommandPending = false;
+        pendingTransferReads.clear();
+        pendingTransferWrites.clear();
+        lastFullBarrierNodeCount = 0;
+
         // Periodically clear preserve attachments just in case there are new waiters which would otherwise end up waiting forever
         if ((submissionNumber % (2U << *state.settings->executorSlotCountScale)) == 0) {
             preserveAttachedBuffers.clear();
@@ -574,28 +855,38 @@ namespace skyline::gpu::interconnect {
         for (const auto &flushCallback : flushCallbacks)
             flushCallback();
 
+        FlushPendingClears();
+
         executionTag = AllocateTag();
 
         if (!slot->nodes.empty()) {
             TRACE_EVENT("gpu", "CommandExecutor::Submit");
 
-            if (callback && *state.settings->useDirectMemoryImport)
-                waiterThread.Queue(cycle, std::move(callback));
+            // Timestamps are only written while they're being traced as reading them back has a cost on every execution
+            std::shared_ptr<ExecutionTimestamps> timestamps;
+            if (gpu.traits.timestampValidBits && TRACE_EVENT_CATEGORY_ENABLED("gpu"))
+                timestamps = slot->timestamps = std::make_shared<ExecutionTimestamps>(gpu);
+
+            if (callback && gpu.buffer.directMemoryImport)
+                waiterThread.Queue(cycle, std::move(callback), std::move(timestamps));
             else
-                waiterThread.Queue(cycle, {});
+                waiterThread.Queue(cycle, {}, std::move(timestamps));
 
+            UpdateFlushThreshold();
             SubmitInternal();
             submissionNumber++;
 
         } else {
-            if (callback && *state.settings->useDirectMemoryImport)
+            if (callback && gpu.buffer.directMemoryImport)
                 waiterThread.Queue(nullptr, std::move(callback));
         }
 
-        if (callback && !*state.settings->useDirectMemoryImport)
+        if (callback && !gpu.buffer.directMemoryImport)
             callback();
 
         ResetInternal();
+        gpu.buffer.ReportStatistics();
+        gpu.texture.EvictIdle();
 
         if (wait) {
             std::condition_variable cv;
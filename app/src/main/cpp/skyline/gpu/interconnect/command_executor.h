@@ -3,16 +3,50 @@
 
 #pragma once
 
+#include <deque>
 #include <boost/container/stable_vector.hpp>
+#include <boost/container/small_vector.hpp>
 #include <renderdoc_app.h>
 #include <common/linear_allocator.h>
+#include <common/trace.h>
 #include <gpu/megabuffer.h>
 #include "command_nodes.h"
 #include "common/spin_lock.h"
 
 namespace skyline::gpu::interconnect {
+    /**
+     * @brief Timestamp queries written around the render passes and groups of outside render pass commands of a single execution, these are only used for tracing GPU execution
+     */
+    struct ExecutionTimestamps {
+        static constexpr u32 MaxRegions{256}; //!< The maximum amount of regions that are timed in a single execution, any further regions are left untimed
+
+        /**
+         * @brief A contiguous range of commands which is timed by a pair of consecutive queries
+         */
+        struct Region {
+            bool renderPass; //!< If the region is a render pass rather than a group of commands outside of any render pass
+        };
+
+        vk::raii::QueryPool pool;
+        std::vector<Region> regions; //!< The regions that have been timed, the queries at 2 * index and 2 * index + 1 hold their begin and end timestamps
+        bool regionOpen{}; //!< If the end timestamp of the last region hasn't been written yet
+
+        ExecutionTimestamps(GPU &gpu);
+
+        /**
+         * @brief Writes the begin timestamp of a new region, if the maximum amount of regions hasn't been reached
+         */
+        void BeginRegion(vk::raii::CommandBuffer &commandBuffer, bool renderPass);
+
+        /**
+         * @brief Writes the end timestamp of the open region, if there is one
+         */
+        void EndRegion(vk::raii::CommandBuffer &commandBuffer);
+    };
+
     /*
-     * @brief Thread responsible for recording Vulkan commands from the execution nodes and submitting them
+     * @brief Threads responsible for recording Vulkan commands from the execution nodes and submitting them
+     * @note Slots are recorded on multiple worker threads concurrently but are always submitted in the order they were released in
      */
     class CommandRecordThread {
       public:
@@ -41,9 +75,11 @@ namespace skyline::gpu::interconnect {
             std::mutex beginLock;
             std::condition_variable beginCondition;
             ContextTag executionTag;
+            std::shared_ptr<ExecutionTimestamps> timestamps; //!< The timestamp queries that should be written while recording this slot, this is null when GPU timestamps aren't being traced
             bool ready{}; //!< If this slot's command buffer has had 'beginCommandBuffer' called and is ready to have commands recorded into it
             bool capture{}; //!< If this slot's Vulkan commands should be captured using the renderdoc API
             bool didWait{}; //!< If a wait of time longer than GrowThresholdNs occured when this slot was acquired
+            u64 sequence{}; //!< The position of the slot in the order slots were released in, this is the order they're submitted in
 
             Slot(GPU &gpu);
 
@@ -65,23 +101,46 @@ namespace skyline::gpu::interconnect {
 
       private:
         static constexpr size_t GrowThresholdNs{constant::NsInMillisecond / 50}; //!< The wait time threshold at which the slot count will be increased
+        static constexpr size_t MaxWorkerCount{2}; //!< The maximum amount of threads recording slots concurrently, recording is lightweight enough that more workers would mostly contend with the GPFIFO and compilation threads
+
+        /**
+         * @brief A thread which records slots, these are distributed across workers in round-robin order
+         */
+        struct Worker {
+            CircularQueue<Slot *> incoming; //!< Slots pending recording on this worker
+            std::thread thread;
+
+            Worker(size_t queueSize) : incoming{queueSize} {}
+        };
+
         const DeviceState &state;
-        CircularQueue<Slot *> incoming; //!< Slots pending recording
+        u32 queueIndex; //!< The index of the scheduler queue that all slots are submitted to, executors on separate queues may execute concurrently on the GPU
         CircularQueue<Slot *> outgoing; //!< Slots that have been submitted, may still be active on the GPU
+        std::mutex slotMutex; //!< Synchronizes growing the slot list from multiple workers
         std::list<Slot> slots;
-        std::atomic<bool> idle;
+        std::atomic<u32> busyWorkers{}; //!< The amount of workers currently recording a slot
 
-        std::thread thread;
+        std::mutex submitMutex; //!< Synchronizes submission of slots in release order
+        std::condition_variable submitCondition;
+        u64 submitSequence{}; //!< The sequence of the next slot to be submitted
+        u64 releaseSequence{}; //!< The sequence that'll be assigned to the next released slot, this is only accessed by the releasing thread
+        size_t nextWorker{}; //!< The index of the worker that'll record the next released slot, this is only accessed by the releasing thread
+
+        std::deque<Worker> workers;
 
         void ProcessSlot(Slot *slot);
 
-        void Run();
+        void Run(Worker &worker, size_t index);
 
       public:
         CommandRecordThread(const DeviceState &state);
 
         bool IsIdle() const;
 
+        u32 GetQueueIndex() const {
+            return queueIndex;
+        }
+
         /**
          * @return A free slot, `Reset` needs to be called before accessing it
          */
@@ -99,23 +158,48 @@ namespace skyline::gpu::interconnect {
     class ExecutionWaiterThread {
       private:
         const DeviceState &state;
+        perfetto::Track timestampTrack; //!< Perfetto track used for GPU timestamps of executions, this is shared by all waiters of executors on the same queue as their executions can't overlap
+        u64 lastTimestampEnd{}; //!< The trace time that the last traced region ended at, regions are never traced as starting before it
         std::thread thread;
         SpinLock mutex;
         std::condition_variable_any condition;
-        std::queue<std::pair<std::shared_ptr<FenceCycle>, std::function<void()>>> pendingSignalQueue; //!< Queue of callbacks to be executed when their coressponding fence is signalled
+        struct PendingSignal {
+            std::shared_ptr<FenceCycle> cycle;
+            std::function<void()> callback;
+            u64 queueTimestamp; //!< The time at which the execution was queued in nanoseconds
+            std::shared_ptr<ExecutionTimestamps> timestamps; //!< The timestamp queries written during the execution, these are read back and traced once it completes
+        };
+        std::queue<PendingSignal> pendingSignalQueue; //!< Queue of callbacks to be executed when their coressponding fence is signalled
         std::atomic<bool> idle{};
+        std::atomic<u32> pendingCount{}; //!< The amount of queued items which haven't been completed yet, this is the amount of executions in flight on the GPU
+
+        /**
+         * @brief Reads back the timestamps of a completed execution and traces its regions on the timestamp track
+         * @param signalTimestamp The trace time at which the signal of the execution was observed, the end of the last region is aligned to this
+         */
+        void TraceTimestamps(ExecutionTimestamps &timestamps, u64 signalTimestamp);
 
         void Run();
 
       public:
-        ExecutionWaiterThread(const DeviceState &state);
+        /**
+         * @param queueIndex The index of the scheduler queue that executions waited on by this thread are submitted to
+         */
+        ExecutionWaiterThread(const DeviceState &state, u32 queueIndex);
 
         bool IsIdle() const;
 
+        /**
+         * @return The amount of queued cycles and callbacks which haven't been completed yet
+         */
+        u32 GetPendingCount() const {
+            return pendingCount.load(std::memory_order_relaxed);
+        }
+
         /**
          * @brief Queues `callback` to be executed when `cycle` is signalled, null values are valid for either, will null cycle representing an immediate callback (dep on previously queued cycles) and null callback representing a wait with no callback
          */
-        void Queue(std::shared_ptr<FenceCycle> cycle, std::function<void()> &&callback);
+        void Queue(std::shared_ptr<FenceCycle> cycle, std::function<void()> &&callback, std::shared_ptr<ExecutionTimestamps> timestamps = {});
     };
 
     /**
@@ -133,6 +217,10 @@ namespace skyline::gpu::interconnect {
         size_t subpassCount{}; //!< The number of subpasses in the current render pass
         u32 renderPassIndex{};
         bool preserveLocked{};
+        u32 flushThreshold; //!< The amount of nodes at which the current execution is flushed, this adapts between bounds derived from `executorFlushThreshold` based on GPU utilization
+
+        static constexpr u32 FlushThresholdScale{4}; //!< The factor by which the flush threshold may deviate from the configured threshold in either direction
+        static constexpr u32 SaturatedPendingCount{3}; //!< The amount of executions in flight at which the GPU is considered saturated and executions are batched further
 
         /**
          * @brief A wrapper of a Texture object that has been locked beforehand and must be unlocked afterwards
@@ -180,6 +268,22 @@ namespace skyline::gpu::interconnect {
         span<TextureView *> lastSubpassColorAttachments; //!< The set of color attachments used in the last subpass
         TextureView *lastSubpassDepthStencilAttachment{}; //!< The depth stencil attachment used in the last subpass
 
+        bool transferBarrierPending{}; //!< If transfer commands have been recorded since the last barrier that made their writes visible to all subsequent commands
+        bool nonTransferCommandPending{}; //!< If non-transfer commands have been recorded since the last barrier that ordered them before subsequent transfer commands
+        std::vector<span<u8>> pendingTransferReads; //!< The guest ranges read by transfer commands since the last barrier covering them
+        std::vector<span<u8>> pendingTransferWrites; //!< The guest ranges written by transfer commands since the last barrier covering them
+        size_t lastFullBarrierNodeCount{}; //!< The amount of nodes in the slot after the last full barrier, a full barrier is redundant if no nodes were added since
+
+        /**
+         * @brief A clear of an entire attachment that's deferred till the next subpass, so it can be folded into the load op of the attachment in it rather than requiring a subpass of its own
+         */
+        struct PendingClear {
+            TextureView *attachment;
+            vk::ClearValue value;
+            bool depthStencil; //!< If the attachment is cleared as a depth stencil attachment rather than a color one
+        };
+        boost::container::small_vector<PendingClear, 4> pendingClears; //!< The clears that haven't been recorded yet, these must be recorded prior to any other command as they may access the same attachments
+
         std::vector<std::function<void()>> flushCallbacks; //!< Set of persistent callbacks that will be called at the start of Execute in order to flush data required for recording
         std::vector<std::function<void()>> pipelineChangeCallbacks; //!< Set of persistent callbacks that will be called after any non-Maxwell 3D engine changes the active pipeline
 
@@ -198,6 +302,36 @@ namespace skyline::gpu::interconnect {
          */
         void FinishRenderPass();
 
+        /**
+         * @brief Records a subpass that clears the entirety of the specified attachment, it utilizes VK_ATTACHMENT_LOAD_OP_CLEAR when possible
+         */
+        void RecordClearSubpass(const PendingClear &clear);
+
+        /**
+         * @brief Records all pending clears with subpasses of their own, this must be called prior to recording any command which isn't a subpass
+         */
+        void FlushPendingClears();
+
+        /**
+         * @return If a pending clear can be folded into the load op of its attachment in a subpass with the supplied attachments
+         */
+        bool CanFoldClear(const PendingClear &clear, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment);
+
+        /**
+         * @brief Adds a node with a global memory barrier between the specified stages
+         */
+        void AddMemoryBarrier(vk::PipelineStageFlags srcStage, vk::PipelineStageFlags dstStage, vk::AccessFlags srcAccess, vk::AccessFlags dstAccess);
+
+        /**
+         * @brief Inserts any barriers required prior to a transfer command accessing the supplied ranges and tracks its accesses
+         */
+        void PrepareTransferCommand(span<u8> srcRange, span<u8> dstRange);
+
+        /**
+         * @brief Makes the writes of any prior transfer commands visible to a subsequent non-transfer command
+         */
+        void FlushTransferBarrier();
+
         /**
          * @brief Execute all the nodes and submit the resulting command buffer to the GPU
          * @note It is the responsibility of the caller to handle resetting of command buffers, fence cycle and megabuffers
@@ -211,6 +345,11 @@ namespace skyline::gpu::interconnect {
 
         void AttachBufferBase(std::shared_ptr<Buffer> buffer);
 
+        /**
+         * @brief Adapts the flush threshold to the current GPU utilization, submitting earlier when the GPU is idle and batching more work when it's saturated
+         */
+        void UpdateFlushThreshold();
+
       public:
         std::shared_ptr<FenceCycle> cycle; //!< The fence cycle that this command executor uses to wait for the GPU to finish executing commands
         LinearAllocatorState<> *allocator;
@@ -262,13 +401,33 @@ namespace skyline::gpu::interconnect {
 
         /**
          * @brief Adds a command that needs to be executed inside a subpass configured with certain attachments
+         * @param function A callable with the signature `void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)`, its captures are stored in the slot's linear allocator
          * @param exclusiveSubpass If this subpass should be the only subpass in a render pass
          * @note Any supplied texture should be attached prior and not undergo any persistent layout transitions till execution
          */
-        void AddSubpass(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments = {}, span<TextureView *> colorAttachments = {}, TextureView *depthStencilAttachment = {}, bool noSubpassCreation = false);
+        template<typename Function>
+        void AddSubpass(Function &&function, vk::Rect2D renderArea, span<TextureView *> sampledImages, span<TextureView *> inputAttachments = {}, span<TextureView *> colorAttachments = {}, TextureView *depthStencilAttachment = {}, bool noSubpassCreation = false) {
+            bool gotoNext{CreateRenderPassWithSubpass(renderArea, sampledImages, inputAttachments, colorAttachments, depthStencilAttachment, noSubpassCreation)};
+            if (gotoNext)
+                slot->nodes.emplace_back(std::in_place_type_t<node::NextSubpassFunctionNode>(), slot->allocator, std::forward<Function>(function));
+            else
+                slot->nodes.emplace_back(std::in_place_type_t<node::SubpassFunctionNode>(), slot->allocator, std::forward<Function>(function));
+
+            if (slot->nodes.size() > flushThreshold && !gotoNext)
+                Submit();
+        }
+
+        /**
+         * @return A value identifying the current position in the node stream, it changes whenever a node is added, a clear is deferred or the execution is submitted
+         * @note This can be used to check if the last node is still one that was added earlier, so work can be appended to it rather than adding another node
+         */
+        std::tuple<ContextTag, size_t, size_t> GetNodePosition() const {
+            return {executionTag, slot->nodes.size(), pendingClears.size()};
+        }
 
         /**
          * @brief Adds a subpass that clears the entirety of the specified attachment with a color value, it may utilize VK_ATTACHMENT_LOAD_OP_CLEAR for a more efficient clear when possible
+         * @note The clear is deferred till the next subpass, if the attachment is bound in it then the clear is folded into its load op without a subpass of its own
          * @note Any supplied texture should be attached prior and not undergo any persistent layout transitions till execution
          */
         void AddClearColorSubpass(TextureView *attachment, const vk::ClearColorValue &value);
@@ -281,14 +440,44 @@ namespace skyline::gpu::interconnect {
 
         /**
          * @brief Adds a command that needs to be executed outside the scope of a render pass
+         * @param function A callable with the signature `void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)`, its captures are stored in the slot's linear allocator
          */
-        void AddOutsideRpCommand(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)> &&function);
+        template<typename Function>
+        void AddOutsideRpCommand(Function &&function) {
+            FlushPendingClears();
+            if (renderPass)
+                FinishRenderPass();
+
+            FlushTransferBarrier();
+            slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), slot->allocator, std::forward<Function>(function));
+        }
 
         /**
-         * @brief Adds a full pipeline barrier to the command buffer
+         * @brief Adds a transfer command that needs to be executed outside the scope of a render pass, only the barriers that are required against surrounding commands are inserted
+         * @param srcRange The guest range read by the command, this may be empty if it only reads from host-only buffers
+         * @param dstRange The guest range written by the command
+         * @param function A callable with the signature `void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)`, its captures are stored in the slot's linear allocator
+         * @note Successive transfer commands share a single barrier against prior and subsequent non-transfer commands, transfer commands are only synchronized against each other when their ranges overlap
+         */
+        template<typename Function>
+        void AddTransferCommand(span<u8> srcRange, span<u8> dstRange, Function &&function) {
+            PrepareTransferCommand(srcRange, dstRange);
+            slot->nodes.emplace_back(std::in_place_type_t<node::FunctionNode>(), slot->allocator, std::forward<Function>(function));
+        }
+
+        /**
+         * @brief Adds a full pipeline barrier to the command buffer, this is elided if no commands were added since the last full barrier
          */
         void AddFullBarrier();
 
+        /**
+         * @return The amount of nodes in the current execution, if this and the execution tag are unchanged since a node was added then it's still the last node and can be extended
+         * @note Pending clears are counted as nodes since they're recorded after the last node
+         */
+        size_t GetNodeCount() const {
+            return slot->nodes.size() + pendingClears.size();
+        }
+
         /**
          * @brief Adds a persistent callback that will be called at the start of Execute in order to flush data required for recording
          */
@@ -18,12 +18,28 @@ namespace skyline::gpu::interconnect::node {
         }
     ), renderArea(renderArea) {}
 
+    std::optional<vk::Rect2D> RenderPassNode::GetMergedRenderArea(vk::Rect2D area, vk::Extent2D newAttachmentExtent) const {
+        i32 left{std::min(renderArea.offset.x, area.offset.x)}, top{std::min(renderArea.offset.y, area.offset.y)};
+        i32 right{std::max(renderArea.offset.x + static_cast<i32>(renderArea.extent.width), area.offset.x + static_cast<i32>(area.extent.width))};
+        i32 bottom{std::max(renderArea.offset.y + static_cast<i32>(renderArea.extent.height), area.offset.y + static_cast<i32>(area.extent.height))};
+
+        if (static_cast<u32>(right) > std::min(attachmentExtent.width, newAttachmentExtent.width) || static_cast<u32>(bottom) > std::min(attachmentExtent.height, newAttachmentExtent.height))
+            return std::nullopt;
+
+        return vk::Rect2D{
+            .offset = {left, top},
+            .extent = {static_cast<u32>(right - left), static_cast<u32>(bottom - top)},
+        };
+    }
+
     u32 RenderPassNode::AddAttachment(TextureView *view, GPU &gpu) {
         auto vkView{view->GetView()};
         auto attachment{std::find(attachments.begin(), attachments.end(), vkView)};
         if (attachment == attachments.end()) {
             // If we cannot find any matches for the specified attachment, we add it as a new one
             attachments.push_back(vkView);
+            attachmentExtent.width = std::min(attachmentExtent.width, view->texture->dimensions.width);
+            attachmentExtent.height = std::min(attachmentExtent.height, view->texture->dimensions.height);
 
             if (gpu.traits.supportsImagelessFramebuffers)
                 attachmentInfo.push_back(vk::FramebufferAttachmentImageInfo{
@@ -36,8 +52,12 @@ namespace skyline::gpu::interconnect::node {
                     .pViewFormats = &view->format->vkFormat,
                 });
 
+            // The stencil ops of attachments without a stencil aspect are never used, marking them as don't care avoids any redundant loads or stores on tilers
+            auto stencilOp{view->format->vkAspect & vk::ImageAspectFlagBits::eStencil ? vk::AttachmentLoadOp::eLoad : vk::AttachmentLoadOp::eDontCare};
             attachmentDescriptions.push_back(vk::AttachmentDescription{
                 .format = *view->format,
+                .stencilLoadOp = stencilOp,
+                .stencilStoreOp = stencilOp == vk::AttachmentLoadOp::eLoad ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare,
                 .initialLayout = view->texture->layout,
                 .finalLayout = view->texture->layout,
                 .flags = vk::AttachmentDescriptionFlagBits::eMayAlias
@@ -162,6 +182,10 @@ namespace skyline::gpu::interconnect::node {
         });
     }
 
+    bool RenderPassNode::HasAttachment(TextureView *view) {
+        return std::find(attachments.begin(), attachments.end(), view->GetView()) != attachments.end();
+    }
+
     bool RenderPassNode::ClearColorAttachment(u32 colorAttachment, const vk::ClearColorValue &value, GPU& gpu) {
         auto attachmentReference{RebasePointer(attachmentReferences, subpassDescriptions.back().pColorAttachments) + colorAttachment};
         auto attachmentIndex{attachmentReference->attachment};
@@ -196,6 +220,8 @@ namespace skyline::gpu::interconnect::node {
         auto &attachmentDescription{attachmentDescriptions.at(attachmentIndex)};
         if (attachmentDescription.loadOp == vk::AttachmentLoadOp::eLoad) {
             attachmentDescription.loadOp = vk::AttachmentLoadOp::eClear;
+            if (attachmentDescription.stencilLoadOp == vk::AttachmentLoadOp::eLoad)
+                attachmentDescription.stencilLoadOp = vk::AttachmentLoadOp::eClear; // The stencil aspect is cleared alongside the depth aspect
 
             clearValues.resize(attachmentIndex + 1);
             clearValues[attachmentIndex].depthStencil = value;
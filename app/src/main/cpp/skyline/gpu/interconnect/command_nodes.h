@@ -3,17 +3,65 @@
 
 #pragma once
 
+#include <common/linear_allocator.h>
 #include <gpu.h>
 
 namespace skyline::gpu::interconnect::node {
+    template<typename Signature>
+    class LinearFunction;
+
+    /**
+     * @brief A type-erased callable with its state stored in a linear allocator, this avoids the heap allocation std::function requires for all but the smallest captures
+     * @note The callable is destroyed alongside this object but its storage is only reclaimed when the allocator is reset
+     */
+    template<typename Return, typename... Args>
+    class LinearFunction<Return(Args...)> {
+      private:
+        void *callable;
+        Return (*invoke)(void *, Args...);
+        void (*destroy)(void *);
+
+      public:
+        template<typename Function>
+        LinearFunction(LinearAllocatorState<> &allocator, Function &&function) {
+            using Callable = std::decay_t<Function>;
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "The linear allocator cannot satisfy over-aligned callables");
+
+            callable = allocator.EmplaceUntracked<Callable>(std::forward<Function>(function));
+            invoke = [](void *pCallable, Args... args) -> Return {
+                return (*static_cast<Callable *>(pCallable))(std::forward<Args>(args)...);
+            };
+            destroy = [](void *pCallable) {
+                std::destroy_at(static_cast<Callable *>(pCallable));
+            };
+        }
+
+        LinearFunction(const LinearFunction &) = delete;
+
+        LinearFunction(LinearFunction &&other) : callable{std::exchange(other.callable, nullptr)}, invoke{other.invoke}, destroy{other.destroy} {}
+
+        ~LinearFunction() {
+            if (callable)
+                destroy(callable);
+        }
+
+        Return operator()(Args... args) const {
+            return invoke(callable, std::forward<Args>(args)...);
+        }
+    };
+
     /**
      * @brief A generic node for simply executing a function
      */
     template<typename FunctionSignature = void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &)>
     struct FunctionNodeBase {
-        std::function<FunctionSignature> function;
+        LinearFunction<FunctionSignature> function;
 
-        FunctionNodeBase(std::function<FunctionSignature> &&function) : function(function) {}
+        /**
+         * @param allocator The allocator of the slot that the node is recorded into, the function's captures are stored in it
+         */
+        template<typename Function>
+        FunctionNodeBase(LinearAllocatorState<> &allocator, Function &&function) : function{allocator, std::forward<Function>(function)} {}
 
         template<class... Args>
         void operator()(Args &&... args) {
@@ -36,6 +84,7 @@ namespace skyline::gpu::interconnect::node {
         std::vector<std::vector<u32>> preserveAttachmentReferences; //!< Any attachment that must be preserved to be utilized by a future subpass, these are stored per-subpass to ensure contiguity
 
         constexpr static uintptr_t NoDepthStencil{std::numeric_limits<uintptr_t>::max()}; //!< A sentinel value to denote the lack of a depth stencil attachment in a VkSubpassDescription
+        vk::Extent2D attachmentExtent{std::numeric_limits<u32>::max(), std::numeric_limits<u32>::max()}; //!< The minimum extent across all attachments, the render area must not exceed this
 
         /**
          * @brief Rebases a pointer containing an offset relative to the beginning of a container
@@ -54,6 +103,14 @@ namespace skyline::gpu::interconnect::node {
 
         RenderPassNode(vk::Rect2D renderArea);
 
+        /**
+         * @brief Determines the render area that would allow a subpass with a different render area to be merged into this render pass rather than splitting it, this saves a load and store of every attachment on tilers
+         * @param newAttachmentExtent The minimum extent of the attachments that the new subpass would add
+         * @return The union of both render areas if it's within the bounds of all attachments, std::nullopt otherwise
+         * @note Draws and clears are bound by their own scissors so the render area only needs to cover all subpasses
+         */
+        std::optional<vk::Rect2D> GetMergedRenderArea(vk::Rect2D area, vk::Extent2D newAttachmentExtent) const;
+
         /**
          * @note Any preservation of attachments from previous subpasses is automatically handled by this
          * @return The index of the attachment in the render pass which can be utilized with VkAttachmentReference
@@ -65,6 +122,11 @@ namespace skyline::gpu::interconnect::node {
          */
         void AddSubpass(span<TextureView *> inputAttachments, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment, GPU& gpu);
 
+        /**
+         * @return If the supplied view is already an attachment of any subpass in the render pass
+         */
+        bool HasAttachment(TextureView *view);
+
         /**
          * @brief Clears a color attachment in the current subpass with VK_ATTACHMENT_LOAD_OP_CLEAR
          * @param colorAttachment The index of the attachment in the attachments bound to the current subpass
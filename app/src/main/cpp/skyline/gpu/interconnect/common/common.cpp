@@ -8,10 +8,13 @@
 
 namespace skyline::gpu::interconnect {
     void CachedMappedBufferView::Update(InterconnectContext &ctx, u64 address, u64 size, bool splitMappingWarn) {
-        // Ignore size for the mapping end check here as we don't support buffers split across multiple mappings so only the first one would be used anyway. It's also impossible for the mapping to have been remapped with a larger one since the original lookup because the we force the mapping to be reset after semaphores
-        if (address < blockMappingStartAddr || address >= blockMappingEndAddr) {
+        // Ignore size for the mapping end check here as we don't support buffers split across multiple mappings so only the first one would be used anyway. Any remapping since the original lookup is caught by the mapping sequence changing
+        auto &gmmu{ctx.channelCtx.asCtx->gmmu};
+        if (address < blockMappingStartAddr || address >= blockMappingEndAddr || gmmu.GetMappingSequence() != mappingSequence) {
+            mappingSequence = gmmu.GetMappingSequence();
+
             u64 blockOffset{};
-            std::tie(blockMapping, blockOffset) = ctx.channelCtx.asCtx->gmmu.LookupBlock(address);
+            std::tie(blockMapping, blockOffset) = gmmu.LookupBlock(address);
             if (!blockMapping.valid()) {
                 view = {};
                 blockMappingEndAddr = 0;
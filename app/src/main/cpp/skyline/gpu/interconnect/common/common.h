@@ -42,6 +42,7 @@ namespace skyline::gpu::interconnect {
         span<u8> blockMapping; //!< The underlying mapping that `view` is a part of
         u64 blockMappingStartAddr; //!< The start GPU address of `blockMapping`
         u64 blockMappingEndAddr; //!< The end GPU address of `blockMapping`
+        u32 mappingSequence{}; //!< The GMMU mapping sequence at the time `blockMapping` was looked up, the lookup is redone if the AS has been modified since
 
       public:
         BufferView view; //!< The buffer view created as a result of a call to `Update()`
@@ -93,6 +94,8 @@ namespace skyline::gpu::interconnect {
         span<vk::WriteDescriptorSet> writes;
         span<vk::DescriptorBufferInfo> bufferDescs;
         span<DynamicBufferBinding> bufferDescDynamicBindings;
+        vk::DescriptorUpdateTemplate updateTemplate; //!< A template which performs all writes in a single call with `updateTemplateData`, this is only used for updates without copies and may be null
+        void *updateTemplateData; //!< The start of the descriptor infos that the writes reference, `bufferDescs` is resolved in place within these prior to the update
         vk::PipelineLayout pipelineLayout;
         vk::DescriptorSetLayout descriptorSetLayout;
         vk::PipelineBindPoint bindPoint;
@@ -4,18 +4,18 @@
 #include "file_pipeline_state_accessor.h"
 
 namespace skyline::gpu::interconnect::maxwell3d {
-    FilePipelineStateAccessor::FilePipelineStateAccessor(PipelineStateBundle &bundle) : bundle{bundle} {}
+    FilePipelineStateAccessor::FilePipelineStateAccessor(std::unique_ptr<PipelineStateBundle> bundle) : bundle{std::move(bundle)} {}
 
     Shader::TextureType FilePipelineStateAccessor::GetTextureType(u32 index) const {
-        return bundle.LookupTextureType(index);
+        return bundle->LookupTextureType(index);
     }
 
     u32 FilePipelineStateAccessor::GetConstantBufferValue(u32 shaderStage, u32 index, u32 offset) const {
-        return bundle.LookupConstantBufferValue(shaderStage, index, offset);
+        return bundle->LookupConstantBufferValue(shaderStage, index, offset);
     }
 
     ShaderBinary FilePipelineStateAccessor::GetShaderBinary(u32 pipelineStage) const {
-        return bundle.GetShaderBinary(pipelineStage);
+        return bundle->GetShaderBinary(pipelineStage);
     }
 
     void FilePipelineStateAccessor::MarkComplete() {}
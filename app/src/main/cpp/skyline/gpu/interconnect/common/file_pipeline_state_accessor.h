@@ -12,10 +12,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
      */
     class FilePipelineStateAccessor : public PipelineStateAccessor {
       private:
-        PipelineStateBundle &bundle;
+        std::unique_ptr<PipelineStateBundle> bundle;
 
       public:
-        FilePipelineStateAccessor(PipelineStateBundle &bundle);
+        FilePipelineStateAccessor(std::unique_ptr<PipelineStateBundle> bundle);
 
         Shader::TextureType GetTextureType(u32 index) const override;
 
@@ -104,6 +104,18 @@ namespace skyline::gpu::interconnect {
         u32 binarySize;
     };
 
+    /*  The indexed bundle format is identical to the above aside from the hash and bundle size being omitted (they're stored by the container) and pipeline stages referencing deduplicated binaries:
+        struct PipelineStage {
+            u32 binaryBaseOffset
+            u32 binaryIndex
+        } pipelineStages[pipelineStageCount];
+    */
+
+    struct PipelineBinaryIndexHeader {
+        u32 binaryBaseOffset;
+        u32 binaryIndex;
+    };
+
     bool PipelineStateBundle::Deserialise(std::ifstream &stream) {
         if (stream.peek() == EOF)
             return false;
@@ -198,4 +210,76 @@ namespace skyline::gpu::interconnect {
         stream.write(reinterpret_cast<const char *>(&bundleSize), sizeof(bundleSize));
         stream.write(reinterpret_cast<const char *>(fileBuffer.data()), static_cast<std::streamsize>(bundleSize));
     }
+
+    void PipelineStateBundle::DeserialiseIndexed(span<u8> data, const std::function<void(u32, std::vector<u8> &)> &readBinary) {
+        if (data.size() < sizeof(BundleDataHeader))
+            throw exception("Indexed pipeline state bundle is too small: 0x{:X}", data.size());
+
+        const auto &header{data.as<BundleDataHeader>()};
+        size_t expectedSize{sizeof(BundleDataHeader) +
+                            header.keySize +
+                            header.constantBufferValueCount * sizeof(ConstantBufferValue) +
+                            header.textureTypeCount * sizeof(TextureTypeEntry) +
+                            header.pipelineStageCount * sizeof(PipelineBinaryIndexHeader)};
+        if (data.size() != expectedSize)
+            throw exception("Indexed pipeline state bundle size mismatch: 0x{:X} (expected 0x{:X})", data.size(), expectedSize);
+
+        size_t offset{sizeof(BundleDataHeader)};
+
+        Reset(data.subspan(offset, header.keySize));
+        offset += header.keySize;
+
+        auto readConstantBufferValues{data.subspan(offset, header.constantBufferValueCount * sizeof(ConstantBufferValue)).cast<ConstantBufferValue>()};
+        constantBufferValues.insert(constantBufferValues.end(), readConstantBufferValues.begin(), readConstantBufferValues.end());
+        offset += header.constantBufferValueCount * sizeof(ConstantBufferValue);
+
+        auto readTextureTypes{data.subspan(offset, header.textureTypeCount * sizeof(TextureTypeEntry)).cast<TextureTypeEntry>()};
+        textureTypes.insert(textureTypes.end(), readTextureTypes.begin(), readTextureTypes.end());
+        offset += header.textureTypeCount * sizeof(TextureTypeEntry);
+
+        pipelineStages.resize(header.pipelineStageCount);
+        for (auto &stage : pipelineStages) {
+            const auto &stageHeader{data.subspan(offset).as<PipelineBinaryIndexHeader>()};
+            offset += sizeof(PipelineBinaryIndexHeader);
+
+            stage.binaryBaseOffset = stageHeader.binaryBaseOffset;
+            readBinary(stageHeader.binaryIndex, stage.binary);
+        }
+    }
+
+    span<u8> PipelineStateBundle::SerialiseIndexed(const std::function<u32(span<u8>)> &writeBinary) {
+        fileBuffer.resize(sizeof(BundleDataHeader) +
+                          key.size() +
+                          constantBufferValues.size() * sizeof(ConstantBufferValue) +
+                          textureTypes.size() * sizeof(TextureTypeEntry) +
+                          pipelineStages.size() * sizeof(PipelineBinaryIndexHeader));
+
+        auto data{span(fileBuffer)};
+        auto &header{data.as<BundleDataHeader>()};
+        size_t offset{sizeof(BundleDataHeader)};
+
+        header.keySize = static_cast<u32>(key.size());
+        header.constantBufferValueCount = static_cast<u32>(constantBufferValues.size());
+        header.textureTypeCount = static_cast<u32>(textureTypes.size());
+        header.pipelineStageCount = static_cast<u32>(pipelineStages.size());
+
+        data.subspan(offset, header.keySize).copy_from(key);
+        offset += header.keySize;
+
+        data.subspan(offset, header.constantBufferValueCount * sizeof(ConstantBufferValue)).copy_from(constantBufferValues);
+        offset += header.constantBufferValueCount * sizeof(ConstantBufferValue);
+
+        data.subspan(offset, header.textureTypeCount * sizeof(TextureTypeEntry)).copy_from(textureTypes);
+        offset += header.textureTypeCount * sizeof(TextureTypeEntry);
+
+        for (auto &stage : pipelineStages) {
+            auto &stageHeader{data.subspan(offset).as<PipelineBinaryIndexHeader>()};
+            offset += sizeof(PipelineBinaryIndexHeader);
+
+            stageHeader.binaryBaseOffset = stage.binaryBaseOffset;
+            stageHeader.binaryIndex = writeBinary(span(stage.binary));
+        }
+
+        return data;
+    }
 }
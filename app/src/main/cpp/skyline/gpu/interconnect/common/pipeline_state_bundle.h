@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <shader_compiler/shader_info.h>
 #include "common.h"
 
@@ -108,5 +109,18 @@ namespace skyline::gpu::interconnect {
         bool Deserialise(std::ifstream &stream);
 
         void Serialise(std::ofstream &stream);
+
+        /**
+         * @brief Deserialises the bundle from its indexed representation, where shader binaries are stored separately and referenced by index
+         * @param readBinary A function that reads the binary with the supplied index into the supplied vector
+         */
+        void DeserialiseIndexed(span<u8> data, const std::function<void(u32, std::vector<u8> &)> &readBinary);
+
+        /**
+         * @brief Serialises the bundle into its indexed representation, where shader binaries are stored separately and referenced by index
+         * @param writeBinary A function that stores the supplied binary and returns an index that can be used to read it back
+         * @return A span over the serialised bundle, this is only valid until the bundle is next serialised or deserialised
+         */
+        span<u8> SerialiseIndexed(const std::function<u32(span<u8>)> &writeBinary);
     };
 }
@@ -19,6 +19,7 @@ namespace skyline::gpu::interconnect {
         texSamplers = mapping.first.subspan(mapping.second).cast<TextureSamplerControl>().first(maximumIndex + 1);
 
         didUseTexHeaderBinding = useTexHeaderBinding;
+        generation++;
     }
 
     bool SamplerPoolState::Refresh(InterconnectContext &ctx, bool useTexHeaderBinding) {
@@ -27,6 +28,7 @@ namespace skyline::gpu::interconnect {
 
     void SamplerPoolState::PurgeCaches() {
         texSamplers = span<TextureSamplerControl>{};
+        generation++;
     }
 
     Samplers::Samplers(DirtyManager &manager, const SamplerPoolState::EngineRegisters &engine) : samplerPool{manager, engine} {}
@@ -37,7 +39,6 @@ namespace skyline::gpu::interconnect {
 
     void Samplers::MarkAllDirty() {
         samplerPool.MarkDirty(true);
-        std::fill(texSamplerCache.begin(), texSamplerCache.end(), nullptr);
     }
 
     static vk::Filter ConvertSamplerFilter(TextureSamplerControl::Filter filter) {
@@ -152,14 +153,21 @@ namespace skyline::gpu::interconnect {
         const auto &samplerPoolObj{samplerPool.Get()};
         u32 index{samplerPoolObj.didUseTexHeaderBinding ? textureIndex : samplerIndex};
         auto texSamplers{samplerPoolObj.texSamplers};
-        if (texSamplers.size() != texSamplerCache.size()) {
+        if (texSamplerCache.size() < texSamplers.size())
             texSamplerCache.resize(texSamplers.size());
-            std::fill(texSamplerCache.begin(), texSamplerCache.end(), nullptr);
-        } else if (texSamplerCache[index]) {
-            return texSamplerCache[index];
-        }
 
         TextureSamplerControl &texSampler{texSamplers[index]};
+        auto &cached{texSamplerCache[index]};
+        if (cached.sampler) {
+            if (cached.poolGeneration == samplerPoolObj.generation)
+                return cached.sampler;
+
+            if (cached.tsc == texSampler) {
+                cached.poolGeneration = samplerPoolObj.generation;
+                return cached.sampler;
+            }
+        }
+
         auto &sampler{texSamplerStore[texSampler]};
         if (!sampler) {
             auto convertAddressModeWithCheck{[&](TextureSamplerControl::AddressMode mode) {
@@ -212,7 +220,7 @@ namespace skyline::gpu::interconnect {
             sampler = std::make_unique<vk::raii::Sampler>(ctx.gpu.vkDevice, samplerInfo.get<vk::SamplerCreateInfo>());
         }
 
-        texSamplerCache[index] = sampler.get();
+        cached = {texSampler, sampler.get(), samplerPoolObj.generation};
         return sampler.get();
     }
 
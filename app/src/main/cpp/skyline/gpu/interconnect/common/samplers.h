@@ -23,6 +23,7 @@ namespace skyline::gpu::interconnect {
       public:
         span<TextureSamplerControl> texSamplers;
         bool didUseTexHeaderBinding;
+        u32 generation{}; //!< Incremented whenever the pool is rebound, cached samplers from prior generations must be revalidated against the contents of the pool
 
         SamplerPoolState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine);
 
@@ -38,7 +39,13 @@ namespace skyline::gpu::interconnect {
         dirty::ManualDirtyState<SamplerPoolState> samplerPool;
 
         tsl::robin_map<TextureSamplerControl, std::unique_ptr<vk::raii::Sampler>, util::ObjectHash<TextureSamplerControl>> texSamplerStore;
-        std::vector<vk::raii::Sampler *> texSamplerCache;
+
+        struct CacheEntry {
+            TextureSamplerControl tsc;
+            vk::raii::Sampler *sampler;
+            u32 poolGeneration; //!< The generation of the pool the entry was last validated against
+        };
+        std::vector<CacheEntry> texSamplerCache; //!< A cache of samplers for each index in the pool, entries are retained across pool rebinds as they're validated against the TSC in the pool
 
       public:
         Samplers(DirtyManager &manager, const SamplerPoolState::EngineRegisters &engine);
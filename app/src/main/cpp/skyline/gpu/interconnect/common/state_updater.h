@@ -203,6 +203,51 @@ namespace skyline::gpu::interconnect {
     };
     using SetBaseStencilStateCmd = CmdHolder<SetBaseStencilStateCmdImpl>;
 
+    /**
+     * @brief Pipeline state that is set dynamically through VK_EXT_extended_dynamic_state{,2} rather than being baked into the pipeline
+     */
+    struct ExtendedDynamicState {
+        vk::CullModeFlags cullMode;
+        vk::FrontFace frontFace;
+        bool depthTestEnable;
+        bool depthWriteEnable;
+        vk::CompareOp depthCompareOp;
+        bool depthBoundsTestEnable;
+        bool stencilTestEnable;
+        std::array<vk::StencilOpState, 2> stencilOps; //!< The front and back stencil operations, only the op and compare op fields are used
+        bool dynamicState2; //!< If the fields below should be set, requires VK_EXT_extended_dynamic_state2
+        vk::PrimitiveTopology primitiveTopology;
+        bool depthBiasEnable;
+        bool primitiveRestartEnable;
+        bool rasterizerDiscardEnable;
+    };
+
+    struct SetExtendedDynamicStateCmdImpl {
+        void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
+            commandBuffer.setCullModeEXT(state.cullMode);
+            commandBuffer.setFrontFaceEXT(state.frontFace);
+            commandBuffer.setDepthTestEnableEXT(state.depthTestEnable);
+            commandBuffer.setDepthWriteEnableEXT(state.depthWriteEnable);
+            commandBuffer.setDepthCompareOpEXT(state.depthCompareOp);
+            commandBuffer.setDepthBoundsTestEnableEXT(state.depthBoundsTestEnable);
+            commandBuffer.setStencilTestEnableEXT(state.stencilTestEnable);
+
+            const auto &[front, back]{state.stencilOps};
+            commandBuffer.setStencilOpEXT(vk::StencilFaceFlagBits::eFront, front.failOp, front.passOp, front.depthFailOp, front.compareOp);
+            commandBuffer.setStencilOpEXT(vk::StencilFaceFlagBits::eBack, back.failOp, back.passOp, back.depthFailOp, back.compareOp);
+
+            if (state.dynamicState2) {
+                commandBuffer.setPrimitiveTopologyEXT(state.primitiveTopology);
+                commandBuffer.setDepthBiasEnableEXT(state.depthBiasEnable);
+                commandBuffer.setPrimitiveRestartEnableEXT(state.primitiveRestartEnable);
+                commandBuffer.setRasterizerDiscardEnableEXT(state.rasterizerDiscardEnable);
+            }
+        }
+
+        ExtendedDynamicState state;
+    };
+    using SetExtendedDynamicStateCmd = CmdHolder<SetExtendedDynamicStateCmdImpl>;
+
     template<bool PushDescriptor>
     struct SetDescriptorSetCmdImpl {
         void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
@@ -226,7 +271,13 @@ namespace skyline::gpu::interconnect {
             }
 
             if constexpr (PushDescriptor) {
-                commandBuffer.pushDescriptorSetKHR(updateInfo->bindPoint, updateInfo->pipelineLayout, updateInfo->descriptorSetIndex, updateInfo->writes);
+                if (updateInfo->updateTemplate)
+                    (*commandBuffer).pushDescriptorSetWithTemplateKHR(updateInfo->updateTemplate, updateInfo->pipelineLayout, updateInfo->descriptorSetIndex, updateInfo->updateTemplateData, *gpu.vkDevice.getDispatcher());
+                else
+                    commandBuffer.pushDescriptorSetKHR(updateInfo->bindPoint, updateInfo->pipelineLayout, updateInfo->descriptorSetIndex, updateInfo->writes);
+            } else if (updateInfo->updateTemplate && updateInfo->copies.empty()) {
+                (*gpu.vkDevice).updateDescriptorSetWithTemplate(**dstSet, updateInfo->updateTemplate, updateInfo->updateTemplateData, *gpu.vkDevice.getDispatcher());
+                commandBuffer.bindDescriptorSets(updateInfo->bindPoint, updateInfo->pipelineLayout, updateInfo->descriptorSetIndex, **dstSet, {});
             } else {
                 // Set the destination/(source) descriptor set(s) for all writes/(copies)
                 for (auto &write : updateInfo->writes)
@@ -256,6 +307,16 @@ namespace skyline::gpu::interconnect {
     using SetDescriptorSetWithUpdateCmd = CmdHolder<SetDescriptorSetCmdImpl<false>>;
     using SetDescriptorSetWithPushCmd = CmdHolder<SetDescriptorSetCmdImpl<true>>;
 
+    struct BindDescriptorSetCmdImpl {
+        void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
+            commandBuffer.bindDescriptorSets(updateInfo->bindPoint, updateInfo->pipelineLayout, updateInfo->descriptorSetIndex, **set, {});
+        }
+
+        DescriptorUpdateInfo *updateInfo;
+        DescriptorAllocator::ActiveDescriptorSet *set;
+    };
+    using BindDescriptorSetCmd = CmdHolder<BindDescriptorSetCmdImpl>;
+
     struct SetPipelineCmdImpl {
         void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
             commandBuffer.bindPipeline(bindPoint, pipeline);
@@ -268,11 +329,20 @@ namespace skyline::gpu::interconnect {
 
     struct SetPipelineFutureCmdImpl {
         void Record(GPU &gpu, vk::raii::CommandBuffer &commandBuffer) {
+            // The optimized pipeline is swapped in as soon as it's been linked in the background
+            if (optimizedPipeline.valid() && optimizedPipeline.wait_for(std::chrono::nanoseconds{}) == std::future_status::ready) {
+                if (vk::Pipeline optimized{*optimizedPipeline.get()}) {
+                    commandBuffer.bindPipeline(bindPoint, optimized);
+                    return;
+                }
+            }
+
             commandBuffer.bindPipeline(bindPoint, *pipeline.get());
         }
 
         std::shared_future<vk::raii::Pipeline> pipeline;
         vk::PipelineBindPoint bindPoint;
+        std::shared_future<vk::raii::Pipeline> optimizedPipeline; //!< An optional optimized version of `pipeline` that is used instead once ready
     };
     using SetPipelineFutureCmd = CmdHolder<SetPipelineFutureCmdImpl>;
 
@@ -286,6 +356,13 @@ namespace skyline::gpu::interconnect {
       public:
         StateUpdater(StateUpdateCmdHeader *first) : first{first} {}
 
+        /**
+         * @return If there are no state updates to record
+         */
+        bool Empty() const {
+            return !first;
+        }
+
         /**
          * @brief Records all contained state updates into the given command buffer
          */
@@ -469,6 +546,13 @@ namespace skyline::gpu::interconnect {
                 });
         }
 
+        void SetExtendedDynamicState(const ExtendedDynamicState &state) {
+            AppendCmd<SetExtendedDynamicStateCmd>(
+                {
+                    .state = state,
+                });
+        }
+
         void SetDescriptorSetWithUpdate(DescriptorUpdateInfo *updateInfo, DescriptorAllocator::ActiveDescriptorSet *dstSet, DescriptorAllocator::ActiveDescriptorSet *srcSet) {
             AppendCmd<SetDescriptorSetWithUpdateCmd>(
                 {
@@ -478,6 +562,14 @@ namespace skyline::gpu::interconnect {
                 });
         }
 
+        void BindDescriptorSet(DescriptorUpdateInfo *updateInfo, DescriptorAllocator::ActiveDescriptorSet *set) {
+            AppendCmd<BindDescriptorSetCmd>(
+                {
+                    .updateInfo = updateInfo,
+                    .set = set,
+                });
+        }
+
         void SetPipeline(vk::Pipeline pipeline, vk::PipelineBindPoint bindPoint) {
             AppendCmd<SetPipelineCmd>(
                 {
@@ -486,11 +578,12 @@ namespace skyline::gpu::interconnect {
                 });
         }
 
-        void SetPipeline(const std::shared_future<vk::raii::Pipeline> &pipeline, vk::PipelineBindPoint bindPoint) {
+        void SetPipeline(const std::shared_future<vk::raii::Pipeline> &pipeline, vk::PipelineBindPoint bindPoint, const std::shared_future<vk::raii::Pipeline> &optimizedPipeline = {}) {
             AppendCmd<SetPipelineFutureCmd>(
                 {
                     .pipeline = pipeline,
                     .bindPoint = bindPoint,
+                    .optimizedPipeline = optimizedPipeline,
                 });
         }
 
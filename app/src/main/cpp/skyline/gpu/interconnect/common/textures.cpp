@@ -18,10 +18,12 @@ namespace skyline::gpu::interconnect {
         auto mapping{ctx.channelCtx.asCtx->gmmu.LookupBlock(engine->texHeaderPool.offset)};
 
         textureHeaders = mapping.first.subspan(mapping.second).cast<TextureImageControl>().first(engine->texHeaderPool.maximumIndex + 1);
+        generation++;
     }
 
     void TexturePoolState::PurgeCaches() {
         textureHeaders = span<TextureImageControl>{};
+        generation++;
     }
 
     Textures::Textures(DirtyManager &manager, const TexturePoolState::EngineRegisters &engine) : texturePool{manager, engine} {}
@@ -223,17 +225,20 @@ namespace skyline::gpu::interconnect {
     }
 
     TextureView *Textures::GetTexture(InterconnectContext &ctx, u32 index, Shader::TextureType shaderType) {
-        auto textureHeaders{texturePool.UpdateGet(ctx).textureHeaders};
-        if (textureHeaderCache.size() != textureHeaders.size()) {
+        const auto &pool{texturePool.UpdateGet(ctx)};
+        auto textureHeaders{pool.textureHeaders};
+        if (textureHeaderCache.size() < textureHeaders.size())
             textureHeaderCache.resize(textureHeaders.size());
-            std::fill(textureHeaderCache.begin(), textureHeaderCache.end(), CacheEntry{});
-        } else if (textureHeaders.size() > index && textureHeaderCache[index].view) {
+
+        if (textureHeaders.size() > index && textureHeaderCache[index].view) {
             auto &cached{textureHeaderCache[index]};
-            if (cached.executionTag == ctx.executor.executionTag)
+            if (cached.executionTag == ctx.executor.executionTag && cached.poolGeneration == pool.generation)
                 return cached.view;
 
+            // A rebound pool commonly contains many of the same TICs at the same indices, those entries are revalidated rather than having to be looked up again
             if (cached.tic == textureHeaders[index] && !cached.view->texture->replaced) {
                 cached.executionTag = ctx.executor.executionTag;
+                cached.poolGeneration = pool.generation;
                 return cached.view;
             }
         }
@@ -343,13 +348,20 @@ namespace skyline::gpu::interconnect {
             texture = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag);
         }
 
-        textureHeaderCache[index] = {textureHeader, texture.get(), ctx.executor.executionTag};
+        textureHeaderCache[index] = {textureHeader, texture.get(), ctx.executor.executionTag, pool.generation};
         return texture.get();
     }
 
     Shader::TextureType Textures::GetTextureType(InterconnectContext &ctx, u32 index) {
-        auto textureHeaders{texturePool.UpdateGet(ctx).textureHeaders};
-        switch (textureHeaders[index].textureType) {
+        return ConvertTextureType(GetTextureHeaders(ctx)[index]);
+    }
+
+    span<TextureImageControl> Textures::GetTextureHeaders(InterconnectContext &ctx) {
+        return texturePool.UpdateGet(ctx).textureHeaders;
+    }
+
+    Shader::TextureType Textures::ConvertTextureType(const TextureImageControl &textureHeader) {
+        switch (textureHeader.textureType) {
             case TextureImageControl::TextureType::e1D:
                 return Shader::TextureType::Color1D;
             case TextureImageControl::TextureType::e1DArray:
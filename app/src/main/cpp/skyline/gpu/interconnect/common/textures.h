@@ -23,6 +23,7 @@ namespace skyline::gpu::interconnect {
 
       public:
         span<TextureImageControl> textureHeaders;
+        u32 generation{}; //!< Incremented whenever the pool is rebound, cached headers from prior generations must be revalidated against the contents of the pool
 
         TexturePoolState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine);
 
@@ -42,8 +43,9 @@ namespace skyline::gpu::interconnect {
             TextureImageControl tic;
             TextureView *view;
             ContextTag executionTag;
+            u32 poolGeneration; //!< The generation of the pool the entry was last validated against
         };
-        std::vector<CacheEntry> textureHeaderCache;
+        std::vector<CacheEntry> textureHeaderCache; //!< A cache of views for each index in the pool, entries are retained across pool rebinds as they're validated against the TIC in the pool
 
       public:
         Textures(DirtyManager &manager, const TexturePoolState::EngineRegisters &engine);
@@ -53,5 +55,15 @@ namespace skyline::gpu::interconnect {
         TextureView *GetTexture(InterconnectContext &ctx, u32 index, Shader::TextureType shaderType);
 
         Shader::TextureType GetTextureType(InterconnectContext &ctx, u32 index);
+
+        /**
+         * @return The TICs of the currently bound texture pool, these directly map guest memory
+         */
+        span<TextureImageControl> GetTextureHeaders(InterconnectContext &ctx);
+
+        /**
+         * @return The shader compiler texture type corresponding to the type of the supplied TIC
+         */
+        static Shader::TextureType ConvertTextureType(const TextureImageControl &textureHeader);
     };
 }
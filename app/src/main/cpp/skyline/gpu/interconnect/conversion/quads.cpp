@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <gpu.h>
 #include "quads.h"
 
 namespace skyline::gpu::interconnect::conversion::quads {
@@ -52,4 +53,42 @@ namespace skyline::gpu::interconnect::conversion::quads {
                 break;
         }
     }
+
+    void IndexConversionCache::Evict(vk::DeviceSize requiredSize) {
+        while (!entries.empty() && (entries.size() >= MaxEntryCount || cachedSize + requiredSize > MaxCachedSize)) {
+            auto victim{std::min_element(entries.begin(), entries.end(), [](const auto &a, const auto &b) { return a.second.lastUse < b.second.lastUse; })};
+            if (victim->second.buffer)
+                cachedSize -= victim->second.buffer->size();
+            entries.erase(victim);
+        }
+    }
+
+    IndexConversionCache::LookupResult IndexConversionCache::Lookup(GPU &gpu, const Key &key, u32 sequenceNumber, vk::DeviceSize size) {
+        auto it{entries.find(key)};
+        if (it == entries.end()) {
+            Evict(size);
+            it = entries.emplace(key, Entry{.sequenceNumber = sequenceNumber}).first;
+        } else if (it->second.sequenceNumber != sequenceNumber) {
+            // The prior buffer can't be overwritten as it may still be in use by the GPU, it'll be freed once all cycles it was attached to have been signalled
+            auto &entry{it->second};
+            if (entry.buffer) {
+                cachedSize -= entry.buffer->size();
+                entry.buffer = nullptr;
+            }
+            entry.sequenceNumber = sequenceNumber;
+            entry.updateCount++;
+        }
+
+        auto &entry{it->second};
+        entry.lastUse = ++useCounter;
+        if (entry.buffer)
+            return {entry.buffer, false};
+
+        if (entry.updateCount >= FrequentlyUpdatedThreshold)
+            return {};
+
+        entry.buffer = std::make_shared<memory::Buffer>(gpu.memory.AllocateBuffer(size, memory::AllocationCategory::Miscellaneous));
+        cachedSize += size;
+        return {entry.buffer, true};
+    }
 }
@@ -4,13 +4,23 @@
 #pragma once
 
 #include <common/base.h>
+#include <common/utils.h>
 
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_enums.hpp>
 
+namespace skyline::gpu {
+    class GPU;
+
+    namespace memory {
+        struct Buffer;
+    }
+}
+
 namespace skyline::gpu::interconnect::conversion::quads {
     constexpr u32 EmittedIndexCount{6}; //!< The number of indices needed to draw a quad with two triangles
     constexpr u32 QuadVertexCount{4}; //!< The amount of vertices a quad is composed of
+    constexpr u32 GpuConversionThreshold{0x10000}; //!< The minimum amount of indices in an indexed quad draw for it to be converted on the GPU rather than the CPU
 
     /**
      * @return The amount of indices emitted converting a buffer with the supplied element count
@@ -39,3 +49,58 @@ namespace skyline::gpu::interconnect::conversion::quads {
      */
     void GenerateIndexedQuadConversionBuffer(u8 *dest, u8 *source, u32 indexCount, vk::IndexType type);
 }
+
+namespace skyline::gpu::interconnect::conversion::quads {
+    /**
+     * @brief A cache of converted quad index buffers keyed by the contents version of their source, this allows static quad geometry to only be converted once
+     */
+    class IndexConversionCache {
+      public:
+        struct Key {
+            size_t bufferId; //!< The unique ID of the buffer containing the source indices
+            vk::DeviceSize offset; //!< The offset of the first source index in the buffer
+            u32 elementCount;
+            vk::IndexType type;
+
+            bool operator==(const Key &) const = default;
+        };
+
+        /**
+         * @brief The result of a cache lookup, if the buffer is null then the source is updated too frequently for caching to be beneficial
+         */
+        struct LookupResult {
+            std::shared_ptr<memory::Buffer> buffer;
+            bool needsConversion; //!< If the buffer was newly allocated and the converted indices must be written into it prior to usage
+        };
+
+      private:
+        struct Entry {
+            std::shared_ptr<memory::Buffer> buffer;
+            u32 sequenceNumber; //!< The sequence number of the source buffer at the time of conversion
+            u32 updateCount{}; //!< The amount of times the source contents were changed while the entry was cached
+            u64 lastUse{};
+        };
+
+        static constexpr size_t MaxEntryCount{0x100}; //!< The maximum amount of entries in the cache before the least recently used ones are evicted
+        static constexpr vk::DeviceSize MaxCachedSize{0x2000000}; //!< The maximum combined size of all converted buffers in the cache before the least recently used ones are evicted
+        static constexpr u32 FrequentlyUpdatedThreshold{4}; //!< The amount of source content changes after which an entry is no longer cached
+
+        std::unordered_map<Key, Entry, util::ObjectHash<Key>> entries;
+        vk::DeviceSize cachedSize{};
+        u64 useCounter{};
+
+        /**
+         * @brief Evicts the least recently used entries until there's space for a new entry of the supplied size
+         */
+        void Evict(vk::DeviceSize requiredSize);
+
+      public:
+        /**
+         * @brief Looks up the converted buffer for the supplied key, allocating a new one if the source contents have changed since the last conversion
+         * @param sequenceNumber The current sequence number of the source buffer
+         * @param size The size of the converted index buffer in bytes
+         * @note Any returned buffer must be attached to the cycle of the command buffer it's used in
+         */
+        LookupResult Lookup(GPU &gpu, const Key &key, u32 sequenceNumber, vk::DeviceSize size);
+    };
+}
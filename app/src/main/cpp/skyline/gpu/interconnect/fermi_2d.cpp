@@ -106,6 +106,100 @@ namespace skyline::gpu::interconnect {
         return texture;
     }
 
+    Fermi2D::SurfaceTexture Fermi2D::GetSurfaceTexture(const Surface &surface) {
+        if (auto it{surfaceTextures.find(surface)}; it != surfaceTextures.end() && !it->second.view->texture->replaced)
+            return it->second;
+
+        if (surfaceTextures.size() >= MaxSurfaceTextureCount)
+            surfaceTextures.clear();
+
+        auto guestTexture{GetGuestTexture(surface)};
+        SurfaceTexture surfaceTexture{gpu.texture.FindOrCreate(guestTexture, executor.tag), guestTexture.dimensions};
+        surfaceTextures[surface] = surfaceTexture;
+        return surfaceTexture;
+    }
+
+    bool Fermi2D::SupportsFormatFeatures(vk::Format format, vk::FormatFeatureFlags features) {
+        auto it{formatFeatures.find(format)};
+        if (it == formatFeatures.end())
+            it = formatFeatures.emplace(format, gpu.vkPhysicalDevice.getFormatProperties(format).optimalTilingFeatures).first;
+        return (it->second & features) == features;
+    }
+
+    bool Fermi2D::BlitImage(TextureView *srcView, TextureView *dstView, float srcX, float srcY, float srcWidth, float srcHeight, u32 dstX, u32 dstY, u32 dstWidth, u32 dstHeight, bool linearFilter) {
+        auto isBlittable{[](TextureView *view) {
+            auto &texture{view->texture};
+            // Blits operate on the format of the image rather than that of the view, they also can't target an image which isn't in the layout we expect
+            return view->format == texture->format && texture->tiling == vk::ImageTiling::eOptimal && texture->layout == vk::ImageLayout::eGeneral &&
+                texture->sampleCount == vk::SampleCountFlagBits::e1 && texture->dimensions.depth == 1 && view->range.baseMipLevel == 0;
+        }};
+
+        if (srcView->texture.get() == dstView->texture.get() || !isBlittable(srcView) || !isBlittable(dstView))
+            return false;
+
+        vk::FormatFeatureFlags srcFeatures{vk::FormatFeatureFlagBits::eBlitSrc};
+        if (linearFilter)
+            srcFeatures |= vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+        if (!SupportsFormatFeatures(srcView->texture->format->vkFormat, srcFeatures) || !SupportsFormatFeatures(dstView->texture->format->vkFormat, vk::FormatFeatureFlagBits::eBlitDst))
+            return false;
+
+        // Blit offsets are integral and have to be within the bounds of the host image, any blit with a fractional source rectangle or one that wraps around is left to the helper shader
+        auto scaleOffset{[](float guestOffset, u32 scale, u32 limit, i32 &hostOffset) {
+            float scaledOffset{guestOffset * static_cast<float>(scale) / 100.0f};
+            if (scaledOffset < 0.0f || scaledOffset > static_cast<float>(limit) || scaledOffset != std::floor(scaledOffset))
+                return false;
+
+            hostOffset = static_cast<i32>(scaledOffset);
+            return true;
+        }};
+
+        auto &srcTexture{srcView->texture}, &dstTexture{dstView->texture};
+        std::array<vk::Offset3D, 2> srcOffsets{vk::Offset3D{0, 0, 0}, vk::Offset3D{0, 0, 1}}, dstOffsets{vk::Offset3D{0, 0, 0}, vk::Offset3D{0, 0, 1}};
+        if (!scaleOffset(srcX, srcTexture->resolutionScale, srcTexture->dimensions.width, srcOffsets[0].x) ||
+            !scaleOffset(srcY, srcTexture->resolutionScale, srcTexture->dimensions.height, srcOffsets[0].y) ||
+            !scaleOffset(srcX + srcWidth, srcTexture->resolutionScale, srcTexture->dimensions.width, srcOffsets[1].x) ||
+            !scaleOffset(srcY + srcHeight, srcTexture->resolutionScale, srcTexture->dimensions.height, srcOffsets[1].y) ||
+            !scaleOffset(static_cast<float>(dstX), dstTexture->resolutionScale, dstTexture->dimensions.width, dstOffsets[0].x) ||
+            !scaleOffset(static_cast<float>(dstY), dstTexture->resolutionScale, dstTexture->dimensions.height, dstOffsets[0].y) ||
+            !scaleOffset(static_cast<float>(dstX + dstWidth), dstTexture->resolutionScale, dstTexture->dimensions.width, dstOffsets[1].x) ||
+            !scaleOffset(static_cast<float>(dstY + dstHeight), dstTexture->resolutionScale, dstTexture->dimensions.height, dstOffsets[1].y))
+            return false;
+
+        if (srcOffsets[0].x >= srcOffsets[1].x || srcOffsets[0].y >= srcOffsets[1].y || dstOffsets[0].x >= dstOffsets[1].x || dstOffsets[0].y >= dstOffsets[1].y)
+            return false;
+
+        vk::ImageBlit region{
+            .srcSubresource = {
+                .aspectMask = srcView->range.aspectMask,
+                .baseArrayLayer = srcView->range.baseArrayLayer,
+                .layerCount = 1,
+            },
+            .srcOffsets = srcOffsets,
+            .dstSubresource = {
+                .aspectMask = dstView->range.aspectMask,
+                .baseArrayLayer = dstView->range.baseArrayLayer,
+                .layerCount = 1,
+            },
+            .dstOffsets = dstOffsets,
+        };
+
+        executor.AddOutsideRpCommand([srcView, dstView, region, linearFilter](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite,
+            }, {}, {});
+
+            commandBuffer.blitImage(srcView->texture->GetBacking(), vk::ImageLayout::eGeneral, dstView->texture->GetBacking(), vk::ImageLayout::eGeneral, region, linearFilter ? vk::Filter::eLinear : vk::Filter::eNearest);
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+            }, {}, {});
+        });
+
+        return true;
+    }
+
     Fermi2D::Fermi2D(GPU &gpu, soc::gm20b::ChannelContext &channelCtx)
         : gpu{gpu},
           channelCtx{channelCtx},
@@ -113,14 +207,13 @@ namespace skyline::gpu::interconnect {
 
     void Fermi2D::Blit(const Surface &srcSurface, const Surface &dstSurface, float srcRectX, float srcRectY, u32 dstRectWidth, u32 dstRectHeight, u32 dstRectX, u32 dstRectY, float duDx, float dvDy, SampleModeOrigin sampleOrigin, bool resolve, SampleModeFilter filter) {
         // TODO: When we support MSAA perform a resolve operation rather than blit when the `resolve` flag is set.
-        auto srcGuestTexture{GetGuestTexture(srcSurface)};
-        auto dstGuestTexture{GetGuestTexture(dstSurface)};
-
-        auto srcTextureView{gpu.texture.FindOrCreate(srcGuestTexture, executor.tag)};
+        auto srcSurfaceTexture{GetSurfaceTexture(srcSurface)};
+        auto &srcTextureView{srcSurfaceTexture.view};
         executor.AttachDependency(srcTextureView);
         executor.AttachTexture(srcTextureView.get());
 
-        auto dstTextureView{gpu.texture.FindOrCreate(dstGuestTexture, executor.tag)};
+        auto dstSurfaceTexture{GetSurfaceTexture(dstSurface)};
+        auto &dstTextureView{dstSurfaceTexture.view};
         executor.AttachDependency(dstTextureView);
         executor.AttachTexture(dstTextureView.get());
 
@@ -128,6 +221,9 @@ namespace skyline::gpu::interconnect {
         float centredSrcRectX{sampleOrigin == SampleModeOrigin::Corner ? srcRectX - 0.5f : srcRectX};
         float centredSrcRectY{sampleOrigin == SampleModeOrigin::Corner ? srcRectY - 0.5f : srcRectY};
 
+        if (BlitImage(srcTextureView.get(), dstTextureView.get(), centredSrcRectX, centredSrcRectY, duDx * dstRectWidth, dvDy * dstRectHeight, dstRectX, dstRectY, dstRectWidth, dstRectHeight, filter == SampleModeFilter::Bilinear))
+            return;
+
         gpu.helperShaders.blitHelperShader.Blit(
             gpu,
             {
@@ -142,14 +238,14 @@ namespace skyline::gpu::interconnect {
                 .x = static_cast<float>(dstRectX),
                 .y = static_cast<float>(dstRectY),
             },
-            srcGuestTexture.dimensions, dstGuestTexture.dimensions,
+            srcSurfaceTexture.dimensions, dstSurfaceTexture.dimensions,
             duDx, dvDy,
             filter == SampleModeFilter::Bilinear,
             srcTextureView.get(), dstTextureView.get(),
             [=](auto &&executionCallback) {
                 auto dst{dstTextureView.get()};
                 std::array<TextureView *, 1> sampledImages{srcTextureView.get()};
-                executor.AddSubpass(std::move(executionCallback), {{static_cast<i32>(dstRectX), static_cast<i32>(dstRectY)}, {dstRectWidth, dstRectHeight} }, sampledImages, {}, {dst});
+                executor.AddSubpass(std::move(executionCallback), gpu::texture::ScaleRect({{static_cast<i32>(dstRectX), static_cast<i32>(dstRectY)}, {dstRectWidth, dstRectHeight}}, dst->texture->resolutionScale), sampledImages, {}, {dst});
             }
         );
 
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <tsl/robin_map.h>
 #include <gpu/texture/texture.h>
 #include <soc/gm20b/gmmu.h>
 #include <soc/gm20b/engines/fermi/types.h>
@@ -29,12 +30,41 @@ namespace skyline::gpu::interconnect {
         using SampleModeOrigin = skyline::soc::gm20b::engine::fermi2d::type::SampleModeOrigin;
         using SampleModeFilter = skyline::soc::gm20b::engine::fermi2d::type::SampleModeFilter;
 
+        /**
+         * @brief The texture view of a surface alongside the guest dimensions of the surface, these may be smaller than the dimensions of the underlying texture
+         */
+        struct SurfaceTexture {
+            std::shared_ptr<TextureView> view;
+            texture::Dimensions dimensions;
+        };
+
+        static constexpr size_t MaxSurfaceTextureCount{0x100}; //!< The maximum amount of cached surface textures, the cache is cleared once this is exceeded to avoid holding onto textures that are no longer blitted
+
         GPU &gpu;
         soc::gm20b::ChannelContext &channelCtx;
         gpu::interconnect::CommandExecutor &executor;
+        tsl::robin_map<Surface, SurfaceTexture, util::ObjectHash<Surface>> surfaceTextures; //!< A cache of the textures of surfaces that have been blitted, games generally blit between the same few surfaces repeatedly
+        tsl::robin_map<vk::Format, vk::FormatFeatureFlags> formatFeatures; //!< A cache of the optimal tiling features of formats that have been blitted
 
         gpu::GuestTexture GetGuestTexture(const Surface &surface);
 
+        /**
+         * @return The texture for the supplied surface, this is looked up from the cache when possible
+         */
+        SurfaceTexture GetSurfaceTexture(const Surface &surface);
+
+        /**
+         * @return If the supplied format supports all of the supplied features with optimal tiling
+         */
+        bool SupportsFormatFeatures(vk::Format format, vk::FormatFeatureFlags features);
+
+        /**
+         * @brief Performs the blit with vkCmdBlitImage, this doesn't require any render pass, framebuffer or descriptor set and implicitly handles format conversion and scaling
+         * @return If the blit could be performed, the helper shader must be used otherwise
+         * @note The source rectangle is in terms of texel corners
+         */
+        bool BlitImage(TextureView *srcView, TextureView *dstView, float srcX, float srcY, float srcWidth, float srcHeight, u32 dstX, u32 dstY, u32 dstWidth, u32 dstHeight, bool linearFilter);
+
       public:
         Fermi2D(GPU &gpu, soc::gm20b::ChannelContext &channelCtx);
 
@@ -13,7 +13,9 @@ namespace skyline::gpu::interconnect {
     Inline2Memory::Inline2Memory(GPU &gpu, soc::gm20b::ChannelContext &channelCtx)
         : gpu{gpu},
           channelCtx{channelCtx},
-          executor{channelCtx.executor} {}
+          executor{channelCtx.executor} {
+        executor.AddFlushCallback([this] { FlushBatch(); });
+    }
 
     void Inline2Memory::UploadSingleMapping(span<u8> dst, span<u8> src) {
         auto dstBuf{gpu.buffer.FindOrCreate(dst, executor.tag, [this](std::shared_ptr<Buffer> buffer, ContextLock<Buffer> &&lock) {
@@ -28,7 +30,7 @@ namespace skyline::gpu::interconnect {
             dstBuf.GetBuffer()->BlockAllCpuBackingWrites();
 
             auto srcGpuAllocation{gpu.megaBufferAllocator.Push(executor.cycle, src)};
-            executor.AddOutsideRpCommand([srcGpuAllocation, dstBuf, src](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &pGpu) {
+            executor.AddTransferCommand({}, dst, [srcGpuAllocation, dstBuf, src](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &pGpu) {
                 auto dstBufBinding{dstBuf.GetBinding(pGpu)};
                 vk::BufferCopy copyRegion{
                     .size = src.size_bytes(),
@@ -36,21 +38,53 @@ namespace skyline::gpu::interconnect {
                     .dstOffset = dstBufBinding.offset,
                 };
                 commandBuffer.copyBuffer(srcGpuAllocation.buffer, dstBufBinding.buffer, copyRegion);
-                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
-                    .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
-                    .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite
-                }, {}, {});
             });
         });
     }
 
     void Inline2Memory::Upload(IOVA dst, span<u32> src) {
         auto dstMappings{channelCtx.asCtx->gmmu.TranslateRange(dst, src.size_bytes())};
+        auto srcBytes{src.cast<u8>()};
+
+        if (dstMappings.size() == 1) [[likely]] {
+            auto mapping{dstMappings.front()};
+            // Uploads that directly follow on from the current batch are appended to it, rather than requiring a separate buffer lookup and write for each one
+            if (batchMapping.valid() && batchMapping.end() == mapping.begin() && batchData.size() + srcBytes.size() <= MaxBatchSize) {
+                batchMapping = span<u8>{batchMapping.begin(), mapping.end()};
+                batchData.insert(batchData.end(), srcBytes.begin(), srcBytes.end());
+                return;
+            }
+
+            FlushBatch();
+            if (srcBytes.size() < MaxBatchSize) {
+                if (channelCtx.pendingInline2Memory && channelCtx.pendingInline2Memory != this)
+                    channelCtx.pendingInline2Memory->FlushBatch(); // Batches from other engines must be flushed to retain ordering between them
+
+                batchMapping = mapping;
+                batchData.assign(srcBytes.begin(), srcBytes.end());
+                channelCtx.pendingInline2Memory = this;
+                return;
+            }
+        } else {
+            FlushBatch();
+        }
 
         size_t offset{};
         for (auto mapping : dstMappings) {
-            UploadSingleMapping(mapping, src.cast<u8>().subspan(offset, mapping.size()));
+            UploadSingleMapping(mapping, srcBytes.subspan(offset, mapping.size()));
             offset += mapping.size();
         }
     }
+
+    void Inline2Memory::FlushBatch() {
+        if (!batchMapping.valid())
+            return;
+
+        if (channelCtx.pendingInline2Memory == this)
+            channelCtx.pendingInline2Memory = nullptr;
+
+        auto mapping{std::exchange(batchMapping, span<u8>{})};
+        UploadSingleMapping(mapping, batchData);
+        batchData.clear(); // Capacity is retained to avoid allocations for future batches
+    }
 }
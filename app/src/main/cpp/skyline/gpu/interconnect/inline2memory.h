@@ -28,11 +28,24 @@ namespace skyline::gpu::interconnect {
         soc::gm20b::ChannelContext &channelCtx;
         gpu::interconnect::CommandExecutor &executor;
 
+        static constexpr size_t MaxBatchSize{0x10000}; //!< The maximum size of a batch of contiguous uploads, a batch is flushed upon reaching this size (64KiB)
+        span<u8> batchMapping{}; //!< The destination mapping of the current batch of uploads, this is null when there's no batch
+        std::vector<u8> batchData; //!< The data of all uploads in the current batch
+
         void UploadSingleMapping(span<u8> dst, span<u8> src);
 
       public:
         Inline2Memory(GPU &gpu, soc::gm20b::ChannelContext &channelCtx);
 
+        /**
+         * @brief Uploads the supplied data to the destination, uploads into a single mapping are batched with any prior uploads that they're contiguous with
+         * @note Any batched uploads **must** be flushed with FlushBatch prior to any other operation which could access the destination
+         */
         void Upload(IOVA dst, span<u32> src);
+
+        /**
+         * @brief Performs all uploads in the current batch as a single write
+         */
+        void FlushBatch();
     };
 }
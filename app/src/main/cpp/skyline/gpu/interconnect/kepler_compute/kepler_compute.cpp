@@ -27,10 +27,76 @@ namespace skyline::gpu::interconnect::kepler_compute {
         });
     }
 
-    void KeplerCompute::Dispatch(const QMD &qmd) {
+    /**
+     * @return If two descriptor updates would result in identical descriptor sets
+     * @note The update infos are only valid for comparison within the execution they were created in
+     */
+    static bool DescriptorsEqual(const DescriptorUpdateInfo &lhs, const DescriptorUpdateInfo &rhs) {
+        if (lhs.descriptorSetLayout != rhs.descriptorSetLayout || lhs.writes.size() != rhs.writes.size() || lhs.copies.size() != rhs.copies.size() || lhs.bufferDescDynamicBindings.size() != rhs.bufferDescDynamicBindings.size())
+            return false;
+
+        for (size_t i{}; i < lhs.writes.size(); i++) {
+            const auto &lhsWrite{lhs.writes[i]}, &rhsWrite{rhs.writes[i]};
+            if (lhsWrite.dstBinding != rhsWrite.dstBinding || lhsWrite.dstArrayElement != rhsWrite.dstArrayElement || lhsWrite.descriptorCount != rhsWrite.descriptorCount || lhsWrite.descriptorType != rhsWrite.descriptorType)
+                return false;
+
+            if (lhsWrite.pImageInfo && rhsWrite.pImageInfo) {
+                for (u32 j{}; j < lhsWrite.descriptorCount; j++) {
+                    const auto &lhsImage{lhsWrite.pImageInfo[j]}, &rhsImage{rhsWrite.pImageInfo[j]};
+                    if (lhsImage.sampler != rhsImage.sampler || lhsImage.imageView != rhsImage.imageView || lhsImage.imageLayout != rhsImage.imageLayout)
+                        return false;
+                }
+            } else if (lhsWrite.pImageInfo || rhsWrite.pImageInfo) {
+                return false;
+            }
+        }
+
+        // Buffer descriptors are written from the dynamic bindings during recording, so those need to be compared rather than the descriptors themselves
+        for (size_t i{}; i < lhs.bufferDescDynamicBindings.size(); i++) {
+            const auto &lhsBinding{lhs.bufferDescDynamicBindings[i]}, &rhsBinding{rhs.bufferDescDynamicBindings[i]};
+            if (lhsBinding.index() != rhsBinding.index())
+                return false;
+
+            if (auto lhsBufferBinding{std::get_if<BufferBinding>(&lhsBinding)}) {
+                const auto &rhsBufferBinding{std::get<BufferBinding>(rhsBinding)};
+                if (lhsBufferBinding->buffer != rhsBufferBinding.buffer || lhsBufferBinding->offset != rhsBufferBinding.offset || lhsBufferBinding->size != rhsBufferBinding.size)
+                    return false;
+            } else {
+                const auto &lhsView{std::get<BufferView>(lhsBinding)}, &rhsView{std::get<BufferView>(rhsBinding)};
+                if (lhsView.GetBuffer() != rhsView.GetBuffer() || lhsView.GetOffset() != rhsView.GetOffset() || lhsView.size != rhsView.size)
+                    return false;
+            }
+        }
+
+        return lhs.copies.empty();
+    }
+
+    BufferView KeplerCompute::ReadQmd(soc::gm20b::IOVA qmdAddress, QMD &qmd) {
+        auto &gmmu{ctx.channelCtx.asCtx->gmmu};
+        auto mappings{gmmu.TranslateRange(qmdAddress, sizeof(QMD))};
+        if (mappings.size() == 1 && mappings.front().valid() && mappings.front().size() == sizeof(QMD)) {
+            if (auto view{ctx.gpu.buffer.TryFind(mappings.front())}) {
+                ContextLock lock{ctx.executor.tag, view};
+                if (view.GetBuffer()->IsGpuDirty()) {
+                    // A GPU-written QMD is typically only modified on the GPU to set the grid dimensions for the dispatch, all other fields are written by the CPU beforehand and are current in the backing
+                    std::memcpy(&qmd, view.GetBuffer()->GetBackingSpan().data() + view.GetOffset(), sizeof(QMD));
+                    ctx.executor.AttachLockedBufferView(view, std::move(lock));
+                    return view;
+                }
+            }
+        }
+
+        qmd = gmmu.Read<QMD>(qmdAddress);
+        return {};
+    }
+
+    void KeplerCompute::Dispatch(soc::gm20b::IOVA qmdAddress) {
         if (ctx.gpu.traits.quirks.brokenComputeShaders)
             return;
 
+        QMD qmd;
+        auto qmdView{ReadQmd(qmdAddress, qmd)};
+
         StateUpdateBuilder builder{*ctx.executor.allocator};
 
         constantBuffers.Update(ctx, qmd);
@@ -38,9 +104,17 @@ namespace skyline::gpu::interconnect::kepler_compute {
         auto *pipeline{pipelineState.Update(ctx, builder, textures, constantBuffers.boundConstantBuffers, qmd)};
 
         auto *descUpdateInfo{pipeline->SyncDescriptors(ctx, constantBuffers.boundConstantBuffers, samplers, textures)};
+
+        // If nothing has been recorded since the last dispatch and it used identical state then this dispatch can be appended to its node, avoiding rebinding the pipeline and descriptors
+        if (!qmdView && batch && batch->count < MaxBatchedDispatches && batchPipeline == pipeline && batchExecutionTag == ctx.executor.executionTag &&
+            batchNodeCount == ctx.executor.GetNodeCount() && DescriptorsEqual(*batchDescUpdateInfo, *descUpdateInfo)) {
+            batch->dimensions[batch->count++] = {qmd.ctaRasterWidth, qmd.ctaRasterHeight, qmd.ctaRasterDepth};
+            return;
+        }
+
         builder.SetPipeline(*pipeline->compiledPipeline.pipeline, vk::PipelineBindPoint::eCompute);
 
-        if (ctx.gpu.traits.supportsPushDescriptors) {
+        if (pipeline->compiledPipeline.usesPushDescriptors) {
             builder.SetDescriptorSetWithPush(descUpdateInfo);
         } else {
             auto set{std::make_shared<DescriptorAllocator::ActiveDescriptorSet>(ctx.gpu.descriptor.AllocateSet(descUpdateInfo->descriptorSetLayout))};
@@ -51,20 +125,65 @@ namespace skyline::gpu::interconnect::kepler_compute {
 
         auto stateUpdater{builder.Build()};
 
-        /**
-         * @brief Struct that can be linearly allocated, holding all state for the draw to avoid a dynamic allocation with lambda captures
-         */
-        struct DrawParams {
-            StateUpdater stateUpdater;
-            std::array<u32, 3> dimensions;
-        };
-        auto *drawParams{ctx.executor.allocator->EmplaceUntracked<DrawParams>(DrawParams{stateUpdater, {qmd.ctaRasterWidth, qmd.ctaRasterHeight, qmd.ctaRasterDepth}})};
+        if (qmdView) {
+            // The grid dimensions are packed differently in the QMD than in VkDispatchIndirectCommand, so they're repacked into the megabuffer with GPU copies prior to an indirect dispatch
+            auto allocation{ctx.gpu.megaBufferAllocator.Allocate(ctx.executor.cycle, sizeof(vk::DispatchIndirectCommand) + sizeof(u32) - 1)};
+            vk::DeviceSize alignPadding{util::AlignUp(allocation.offset, sizeof(u32)) - allocation.offset};
+            std::memset(allocation.region.data() + alignPadding, 0, sizeof(vk::DispatchIndirectCommand));
+            qmdView.GetBuffer()->BlockSequencedCpuBackingWrites();
+
+            /**
+             * @brief Struct that can be linearly allocated, holding all state for the indirect dispatch to avoid a dynamic allocation with lambda captures
+             */
+            struct IndirectDispatchParams {
+                StateUpdater stateUpdater;
+                BufferView qmdView;
+                vk::Buffer indirectBuffer;
+                vk::DeviceSize indirectOffset;
+            };
+            auto *dispatchParams{ctx.executor.allocator->EmplaceUntracked<IndirectDispatchParams>(IndirectDispatchParams{stateUpdater, qmdView, allocation.buffer, allocation.offset + alignPadding})};
+
+            ctx.executor.AddOutsideRpCommand([dispatchParams](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
+                auto qmdBinding{dispatchParams->qmdView.GetBinding(gpu)};
+                constexpr vk::DeviceSize GridOffset{offsetof(QMD, ctaRasterWidth)};
+
+                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
+                    .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                    .dstAccessMask = vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite
+                }, {}, {});
+
+                commandBuffer.copyBuffer(qmdBinding.buffer, dispatchParams->indirectBuffer, {
+                    vk::BufferCopy{qmdBinding.offset + GridOffset, dispatchParams->indirectOffset + offsetof(vk::DispatchIndirectCommand, x), sizeof(u32)},
+                    vk::BufferCopy{qmdBinding.offset + GridOffset + sizeof(u32), dispatchParams->indirectOffset + offsetof(vk::DispatchIndirectCommand, y), sizeof(u16)},
+                    vk::BufferCopy{qmdBinding.offset + GridOffset + sizeof(u32) + sizeof(u16), dispatchParams->indirectOffset + offsetof(vk::DispatchIndirectCommand, z), sizeof(u16)},
+                });
 
+                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eDrawIndirect, {}, vk::MemoryBarrier{
+                    .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                    .dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead
+                }, {}, {});
 
-        ctx.executor.AddOutsideRpCommand([drawParams](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
-            drawParams->stateUpdater.RecordAll(gpu, commandBuffer);
+                dispatchParams->stateUpdater.RecordAll(gpu, commandBuffer);
 
-            commandBuffer.dispatch(drawParams->dimensions[0], drawParams->dimensions[1], drawParams->dimensions[2]);
+                commandBuffer.dispatchIndirect(dispatchParams->indirectBuffer, dispatchParams->indirectOffset);
+            });
+
+            batch = nullptr;
+            return;
+        }
+
+        batch = ctx.executor.allocator->EmplaceUntracked<DispatchBatch>(DispatchBatch{stateUpdater, {{{qmd.ctaRasterWidth, qmd.ctaRasterHeight, qmd.ctaRasterDepth}}}, 1});
+
+        ctx.executor.AddOutsideRpCommand([dispatchBatch = batch](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
+            dispatchBatch->stateUpdater.RecordAll(gpu, commandBuffer);
+
+            for (u32 i{}; i < dispatchBatch->count; i++)
+                commandBuffer.dispatch(dispatchBatch->dimensions[i][0], dispatchBatch->dimensions[i][1], dispatchBatch->dimensions[i][2]);
         });
+
+        batchPipeline = pipeline;
+        batchDescUpdateInfo = descUpdateInfo;
+        batchExecutionTag = ctx.executor.executionTag;
+        batchNodeCount = ctx.executor.GetNodeCount();
     }
-}
\ No newline at end of file
+}
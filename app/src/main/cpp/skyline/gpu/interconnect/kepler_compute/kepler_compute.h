@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <soc/gm20b/gmmu.h>
 #include <gpu/descriptor_allocator.h>
+#include <gpu/interconnect/common/state_updater.h>
 #include <gpu/interconnect/common/samplers.h>
 #include <gpu/interconnect/common/textures.h>
 #include "constant_buffers.h"
@@ -25,12 +27,35 @@ namespace skyline::gpu::interconnect::kepler_compute {
         };
 
       private:
+        static constexpr size_t MaxBatchedDispatches{16}; //!< The maximum amount of dispatches that can share a single node
+
+        /**
+         * @brief A node with consecutive dispatches that use the same pipeline and descriptors, these are bound once for all of the dispatches
+         */
+        struct DispatchBatch {
+            StateUpdater stateUpdater;
+            std::array<std::array<u32, 3>, MaxBatchedDispatches> dimensions;
+            u32 count;
+        };
+
         InterconnectContext ctx;
         PipelineState pipelineState;
         ConstantBuffers constantBuffers;
         Samplers samplers;
         Textures textures;
 
+        DispatchBatch *batch{}; //!< The batch of the last direct dispatch, this is allocated from the execution's linear allocator and is only valid while `batchExecutionTag` matches the executor's
+        Pipeline *batchPipeline{};
+        DescriptorUpdateInfo *batchDescUpdateInfo{};
+        ContextTag batchExecutionTag{};
+        size_t batchNodeCount{}; //!< The executor's node count after the batch's node was added, if any other node is added then the batch can't be extended
+
+        /**
+         * @brief Reads the QMD at the supplied address, if its memory has been written by the GPU then it's read from the buffer backing without waiting on the GPU
+         * @return A view of the buffer containing the QMD if it has been written by the GPU, the grid dimensions must be read from it on the GPU in that case
+         */
+        BufferView ReadQmd(soc::gm20b::IOVA qmdAddress, QMD &qmd);
+
       public:
         KeplerCompute(GPU &gpu,
                       soc::gm20b::ChannelContext &channelCtx,
@@ -40,8 +65,9 @@ namespace skyline::gpu::interconnect::kepler_compute {
                       const EngineRegisterBundle &registerBundle);
 
         /**
-         * @brief Performs a compute dispatch using the given QMD
+         * @brief Performs a compute dispatch using the QMD at the supplied address
+         * @note Consecutive dispatches with identical state are batched into a single node and QMDs written by the GPU are dispatched indirectly
          */
-        void Dispatch(const QMD &qmd);
+        void Dispatch(soc::gm20b::IOVA qmdAddress);
     };
 }
@@ -12,20 +12,33 @@ namespace skyline::gpu::interconnect::kepler_compute {
     static Pipeline::ShaderStage MakePipelineShader(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const ShaderBinary &shaderBinary) {
         ctx.gpu.shader->ResetPools();
 
+        // Compute shaders have no runtime info so the key only needs to identify the program
+        u64 programKey{ShaderManager::HashCacheKey(packedState.shaderHash, std::array<u32, 4>{
+            shaderBinary.baseOffset, packedState.bindlessTextureConstantBufferSlotSelect, packedState.localMemorySize, packedState.sharedMemorySize,
+        })};
+        programKey = ShaderManager::HashCacheKey(programKey, packedState.dimensions);
+
+        u64 replacementKey{};
         auto program{ctx.gpu.shader->ParseComputeShader(
             packedState.shaderHash, shaderBinary.binary, shaderBinary.baseOffset,
             packedState.bindlessTextureConstantBufferSlotSelect,
             packedState.localMemorySize, packedState.sharedMemorySize,
             packedState.dimensions,
             [&](u32 index, u32 offset) {
-                return constantBuffers[index].Read<int>(ctx.executor, offset);
+                auto value{constantBuffers[index].Read<int>(ctx.executor, offset)};
+                programKey = ShaderManager::HashCacheKey(programKey, std::array<u32, 3>{index, offset, static_cast<u32>(value)});
+                return value;
             }, [&](u32 index) {
-                return textures.GetTextureType(ctx, BindlessHandle{ .raw = index }.textureIndex);
-            })};
+                auto type{textures.GetTextureType(ctx, BindlessHandle{ .raw = index }.textureIndex)};
+                programKey = ShaderManager::HashCacheKey(programKey, std::array<u32, 2>{index, static_cast<u32>(type)});
+                return type;
+            }, &replacementKey)};
+        if (replacementKey)
+            programKey = ShaderManager::HashCacheKey(programKey, replacementKey);
 
         Shader::Backend::Bindings bindings{};
 
-        return {ctx.gpu.shader->CompileShader({}, program, bindings), program.info};
+        return {ctx.gpu.shader->CompileShader({}, program, bindings, programKey), program.info};
     }
 
     static Pipeline::DescriptorInfo MakePipelineDescriptorInfo(const Pipeline::ShaderStage &stage) {
@@ -68,8 +81,9 @@ namespace skyline::gpu::interconnect::kepler_compute {
                                                                                const PackedPipelineState &packedState,
                                                                                const Pipeline::ShaderStage &shaderStage,
                                                                                span<vk::DescriptorSetLayoutBinding> layoutBindings) {
+        bool usesPushDescriptors{ctx.gpu.descriptor.CanPushDescriptors(layoutBindings)};
         vk::raii::DescriptorSetLayout descriptorSetLayout{ctx.gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
-            .flags = vk::DescriptorSetLayoutCreateFlags{ctx.gpu.traits.supportsPushDescriptors ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR : vk::DescriptorSetLayoutCreateFlags{}},
+            .flags = vk::DescriptorSetLayoutCreateFlags{usesPushDescriptors ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR : vk::DescriptorSetLayoutCreateFlags{}},
             .pBindings = layoutBindings.data(),
             .bindingCount = static_cast<u32>(layoutBindings.size()),
         }};
@@ -100,6 +114,7 @@ namespace skyline::gpu::interconnect::kepler_compute {
             .pipeline = std::move(pipeline),
             .pipelineLayout = std::move(pipelineLayout),
             .descriptorSetLayout = std::move(descriptorSetLayout),
+            .usesPushDescriptors = usesPushDescriptors,
         };
     }
 
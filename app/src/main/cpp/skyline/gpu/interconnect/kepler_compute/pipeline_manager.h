@@ -35,6 +35,7 @@ namespace skyline::gpu::interconnect::kepler_compute {
             vk::raii::DescriptorSetLayout descriptorSetLayout;
             vk::raii::PipelineLayout pipelineLayout;
             vk::raii::Pipeline pipeline;
+            bool usesPushDescriptors; //!< If the descriptor set layout is a push descriptor layout, otherwise sets must be allocated from the descriptor pool
         };
 
       private:
@@ -6,6 +6,7 @@
 #include <range/v3/algorithm.hpp>
 #include <soc/gm20b/channel.h>
 #include <soc/gm20b/gmmu.h>
+#include <gpu.h>
 #include <gpu/buffer_manager.h>
 #include <gpu/interconnect/command_executor.h>
 #include <gpu/interconnect/conversion/quads.h>
@@ -95,17 +96,63 @@ namespace skyline::gpu::interconnect::maxwell3d {
         }
     }
 
-    static BufferBinding GenerateQuadConversionIndexBuffer(InterconnectContext &ctx, engine::IndexBuffer::IndexSize indexType, BufferView &view, u32 firstIndex, u32 elementCount) {
+    static BufferBinding GenerateQuadConversionIndexBuffer(InterconnectContext &ctx, conversion::quads::IndexConversionCache &cache, engine::IndexBuffer::IndexSize indexType, BufferView &view, u32 firstIndex, u32 elementCount) {
+        size_t indexSize{1U << static_cast<u32>(indexType)};
+        vk::DeviceSize indexBufferSize{conversion::quads::GetRequiredBufferSize(elementCount, indexSize)};
+        vk::DeviceSize sourceOffset{GetIndexBufferSize(indexType, firstIndex)};
+        auto type{ConvertIndexType(indexType)};
+
+        // Converted buffers are cached by the contents version of their source, so unchanged quad geometry only needs to be converted once
+        std::shared_ptr<memory::Buffer> cachedBuffer;
+        if (auto version{view.GetBuffer()->GetContentVersion()}) {
+            auto [buffer, needsConversion]{cache.Lookup(ctx.gpu, {version->first, view.GetOffset() + sourceOffset, elementCount, type}, version->second, indexBufferSize)};
+            if (buffer) {
+                ctx.executor.cycle->AttachObject(buffer);
+                if (!needsConversion)
+                    return {buffer->vkBuffer, 0, indexBufferSize};
+                cachedBuffer = std::move(buffer);
+            }
+        }
+
+        // Large draws are converted on the GPU, this avoids reading back the source on the CPU if it's GPU dirty and the conversion cost itself
+        if (cachedBuffer && elementCount >= conversion::quads::GpuConversionThreshold && type != vk::IndexType::eUint8EXT && util::IsAligned(view.GetOffset() + sourceOffset, sizeof(u32))) {
+            view.GetBuffer()->BlockSequencedCpuBackingWrites();
+            ctx.executor.AddOutsideRpCommand([view, cachedBuffer, sourceOffset, indexBufferSize, quadCount = elementCount / conversion::quads::QuadVertexCount, type](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
+                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eComputeShader, {}, vk::MemoryBarrier{
+                    .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                    .dstAccessMask = vk::AccessFlagBits::eShaderRead
+                }, {}, {});
+
+                // Storage buffer descriptors need to be aligned, any misalignment is instead applied to the source offset
+                auto binding{view.GetBinding(gpu)};
+                vk::DeviceSize padding{binding.offset & (gpu.traits.minimumStorageBufferAlignment - 1)};
+                auto descriptorSet{gpu.helperShaders.quadIndexConversionShader.Convert(gpu, commandBuffer, vk::DescriptorBufferInfo{
+                    .buffer = binding.buffer,
+                    .offset = binding.offset - padding,
+                    .range = binding.size + padding,
+                }, vk::DescriptorBufferInfo{
+                    .buffer = cachedBuffer->vkBuffer,
+                    .offset = 0,
+                    .range = indexBufferSize,
+                }, padding + sourceOffset, quadCount, type)};
+                cycle->AttachObject(descriptorSet);
+            });
+
+            return {cachedBuffer->vkBuffer, 0, indexBufferSize};
+        }
+
         auto viewSpan{view.GetReadOnlyBackingSpan(false /* We attach above so always false */, []() {
             // TODO: see Read()
             Logger::Error("Dirty index buffer reads for attached buffers are unimplemented");
         })};
 
-        size_t indexSize{1U << static_cast<u32>(indexType)};
-        vk::DeviceSize indexBufferSize{conversion::quads::GetRequiredBufferSize(elementCount, indexSize)};
-        auto quadConversionAllocation{ctx.gpu.megaBufferAllocator.Allocate(ctx.executor.cycle, indexBufferSize)};
+        if (cachedBuffer) {
+            conversion::quads::GenerateIndexedQuadConversionBuffer(cachedBuffer->data(), viewSpan.subspan(sourceOffset).data(), elementCount, type);
+            return {cachedBuffer->vkBuffer, 0, indexBufferSize};
+        }
 
-        conversion::quads::GenerateIndexedQuadConversionBuffer(quadConversionAllocation.region.data(), viewSpan.subspan(GetIndexBufferSize(indexType, firstIndex)).data(), elementCount, ConvertIndexType(indexType));
+        auto quadConversionAllocation{ctx.gpu.megaBufferAllocator.Allocate(ctx.executor.cycle, indexBufferSize)};
+        conversion::quads::GenerateIndexedQuadConversionBuffer(quadConversionAllocation.region.data(), viewSpan.subspan(sourceOffset).data(), elementCount, type);
 
         return {quadConversionAllocation.buffer, quadConversionAllocation.offset, indexBufferSize};
     }
@@ -134,7 +181,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         indexType = ConvertIndexType(engine->indexBuffer.indexSize);
 
         if (quadConversion)
-            megaBufferBinding = GenerateQuadConversionIndexBuffer(ctx, engine->indexBuffer.indexSize, *view, firstIndex, elementCount);
+            megaBufferBinding = GenerateQuadConversionIndexBuffer(ctx, quadConversionCache, engine->indexBuffer.indexSize, *view, firstIndex, elementCount);
         else
             megaBufferBinding = view->TryMegaBuffer(ctx.executor.cycle, ctx.gpu.megaBufferAllocator, ctx.executor.executionTag);
 
@@ -154,9 +201,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
         if (quadConversion != usedQuadConversion)
             return true;
 
-        // TODO: optimise this to use buffer sequencing to avoid needing to regenerate the quad buffer every time. We can't use as it is rn though because sequences aren't globally unique and may conflict after buffer recreation
         if (usedQuadConversion) {
-            megaBufferBinding = GenerateQuadConversionIndexBuffer(ctx, engine->indexBuffer.indexSize, *view, firstIndex, elementCount);
+            megaBufferBinding = GenerateQuadConversionIndexBuffer(ctx, quadConversionCache, engine->indexBuffer.indexSize, *view, firstIndex, elementCount);
             builder.SetIndexBuffer(megaBufferBinding, indexType);
         } else if (megaBufferBinding) {
             if (auto newMegaBufferBinding{view->TryMegaBuffer(ctx.executor.cycle, ctx.gpu.megaBufferAllocator, ctx.executor.executionTag)};
@@ -186,7 +232,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
     TransformFeedbackBufferState::TransformFeedbackBufferState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine, u32 index) : engine{manager, dirtyHandle, engine}, index{index} {}
 
     void TransformFeedbackBufferState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder) {
-        if (engine->streamOutEnable) {
+        // Binding transform feedback buffers requires VK_EXT_transform_feedback, without it the pipeline never writes to them
+        if (engine->streamOutEnable && ctx.gpu.traits.supportsTransformFeedback) {
             if (engine->streamOutBuffer.size) {
                 view.Update(ctx, engine->streamOutBuffer.address + engine->streamOutBuffer.loadWritePointerStartOffset, engine->streamOutBuffer.size);
 
@@ -260,12 +307,24 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return vkViewport;
     }
 
-    void ViewportState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder) {
+    void ViewportState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder, u32 resolutionScale) {
         if (index != 0 && !ctx.gpu.traits.supportsMultipleViewports)
             return;
 
+        auto setViewport{[&](vk::Viewport viewport) {
+            if (resolutionScale != 100) {
+                float scale{static_cast<float>(resolutionScale) / 100.0f};
+                viewport.x *= scale;
+                viewport.y *= scale;
+                viewport.width *= scale;
+                viewport.height *= scale;
+            }
+
+            builder.SetViewport(index, viewport);
+        }};
+
         if (!engine->viewportScaleOffsetEnable) {
-            builder.SetViewport(index, vk::Viewport{
+            setViewport(vk::Viewport{
                 .x = static_cast<float>(engine->surfaceClip.horizontal.x),
                 .y = static_cast<float>(engine->surfaceClip.vertical.y),
                 .width = engine->surfaceClip.horizontal.width ? static_cast<float>(engine->surfaceClip.horizontal.width) : 1.0f,
@@ -274,9 +333,9 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 .maxDepth = 1.0f,
             });
         } else if (engine->viewport.scaleX == 0.0f || engine->viewport.scaleY == 0.0f) {
-            builder.SetViewport(index, ConvertViewport(engine->viewport0, engine->viewportClip0, engine->windowOrigin, engine->viewportScaleOffsetEnable));
+            setViewport(ConvertViewport(engine->viewport0, engine->viewportClip0, engine->windowOrigin, engine->viewportScaleOffsetEnable));
         } else {
-            builder.SetViewport(index, ConvertViewport(engine->viewport, engine->viewportClip, engine->windowOrigin, engine->viewportScaleOffsetEnable));
+            setViewport(ConvertViewport(engine->viewport, engine->viewportClip, engine->windowOrigin, engine->viewportScaleOffsetEnable));
         }
     }
 
@@ -287,7 +346,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
     ScissorState::ScissorState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine, u32 index) : engine{manager, dirtyHandle, engine}, index{index} {}
 
-    void ScissorState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder) {
+    void ScissorState::Flush(InterconnectContext &ctx, StateUpdateBuilder &builder, u32 resolutionScale) {
         if (index != 0 && !ctx.gpu.traits.supportsMultipleViewports)
             return;
 
@@ -296,7 +355,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 const auto &vertical{engine->scissor.vertical};
                 const auto &horizontal{engine->scissor.horizontal};
 
-                return vk::Rect2D{
+                return gpu::texture::ScaleRect(vk::Rect2D{
                     .offset = {
                         .y = vertical.yMin,
                         .x = horizontal.xMin
@@ -305,7 +364,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
                         .height = static_cast<uint32_t>(vertical.yMax - vertical.yMin),
                         .width = static_cast<uint32_t>(horizontal.xMax - horizontal.xMin)
                     }
-                };
+                }, resolutionScale);
             } else {
                 return vk::Rect2D{
                     .extent.height = std::numeric_limits<i32>::max(),
@@ -416,12 +475,20 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         auto updateFunc{[&](auto &stateElem, auto &&... args) { stateElem.Update(ctx, builder, args...); }};
         pipeline.Update(ctx, textures, constantBuffers, builder);
+
+        // Viewports and scissors are specified in guest coordinates, they need to be reflushed whenever the resolution scale of the render targets changes
+        if (u32 scale{CalculateResolutionScale()}; scale != resolutionScale) {
+            resolutionScale = scale;
+            ranges::for_each(viewports, [](auto &viewport) { viewport.MarkDirty(false); });
+            ranges::for_each(scissors, [](auto &scissor) { scissor.MarkDirty(false); });
+        }
+
         ranges::for_each(vertexBuffers, updateFunc);
         if (indexed)
             updateFunc(indexBuffer, directState.inputAssembly.NeedsQuadConversion(), drawFirstIndex, drawElementCount);
         ranges::for_each(transformFeedbackBuffers, updateFunc);
-        ranges::for_each(viewports, updateFunc);
-        ranges::for_each(scissors, updateFunc);
+        ranges::for_each(viewports, [&](auto &viewport) { updateFunc(viewport, resolutionScale); });
+        ranges::for_each(scissors, [&](auto &scissor) { updateFunc(scissor, resolutionScale); });
         updateFunc(lineWidth);
         updateFunc(depthBias);
         updateFunc(blendConstants);
@@ -429,10 +496,36 @@ namespace skyline::gpu::interconnect::maxwell3d {
         updateFunc(stencilValues);
     }
 
+    u32 ActiveState::CalculateResolutionScale() {
+        auto &pipelineState{pipeline.Get()};
+        std::optional<u32> scale;
+        bool consistent{true};
+        auto visitAttachment{[&](TextureView *attachment) {
+            if (!attachment)
+                return;
+
+            if (scale && *scale != attachment->texture->resolutionScale)
+                consistent = false;
+            scale = attachment->texture->resolutionScale;
+        }};
+
+        ranges::for_each(pipelineState.colorAttachments, visitAttachment);
+        visitAttachment(pipelineState.depthAttachment);
+        return consistent ? scale.value_or(100) : 100;
+    }
+
     Pipeline *ActiveState::GetPipeline() {
         return pipeline.Get().pipeline;
     }
 
+    u32 ActiveState::GetResolutionScale() {
+        return resolutionScale;
+    }
+
+    void ActiveState::MarkIndexBufferDirty() {
+        indexBuffer.MarkDirty(false);
+    }
+
     span<TextureView *> ActiveState::GetColorAttachments() {
         return pipeline.Get().colorAttachments;
     }
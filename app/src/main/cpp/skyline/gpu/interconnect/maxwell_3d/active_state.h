@@ -4,6 +4,7 @@
 #pragma once
 
 #include <gpu/buffer_manager.h>
+#include <gpu/interconnect/conversion/quads.h>
 #include "common.h"
 #include "pipeline_state.h"
 
@@ -50,6 +51,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         u32 usedElementCount{};
         u32 usedFirstIndex{};
         bool usedQuadConversion{};
+        conversion::quads::IndexConversionCache quadConversionCache;
 
       public:
         IndexBufferState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine);
@@ -104,7 +106,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
       public:
         ViewportState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine, u32 index);
 
-        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder);
+        /**
+         * @param resolutionScale The resolution scale in percent of the bound render targets that the guest viewport is transformed by
+         */
+        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder, u32 resolutionScale);
     };
 
     class ScissorState : dirty::ManualDirty {
@@ -122,7 +127,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
       public:
         ScissorState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine, u32 index);
 
-        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder);
+        /**
+         * @param resolutionScale The resolution scale in percent of the bound render targets that the guest scissor is transformed by
+         */
+        void Flush(InterconnectContext &ctx, StateUpdateBuilder &builder, u32 resolutionScale);
     };
 
     struct LineWidthState : dirty::ManualDirty {
@@ -233,6 +241,12 @@ namespace skyline::gpu::interconnect::maxwell3d {
         dirty::ManualDirtyState<BlendConstantsState> blendConstants;
         dirty::ManualDirtyState<DepthBoundsState> depthBounds;
         dirty::ManualDirtyState<StencilValuesState> stencilValues;
+        u32 resolutionScale{100}; //!< The resolution scale in percent of the bound render targets, viewports and scissors are transformed by this
+
+        /**
+         * @return The resolution scale shared by all bound render targets, render targets with differing scales can't be rendered to consistently so they're rendered to unscaled
+         */
+        u32 CalculateResolutionScale();
 
       public:
         struct EngineRegisters {
@@ -262,8 +276,18 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         Pipeline *GetPipeline();
 
+        /**
+         * @return The resolution scale in percent of the render targets bound by the last update, any guest coordinates for them must be transformed by this
+         */
+        u32 GetResolutionScale();
+
         span<TextureView *> GetColorAttachments();
 
+        /**
+         * @brief Marks the index buffer as dirty so the guest index buffer is rebound by the next indexed draw, this is required after a draw binds an index buffer of its own
+         */
+        void MarkIndexBufferDirty();
+
         TextureView *GetDepthAttachment();
 
         std::shared_ptr<TextureView> GetColorRenderTargetForClear(InterconnectContext &ctx, size_t index);
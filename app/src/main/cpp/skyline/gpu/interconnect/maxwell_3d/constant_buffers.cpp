@@ -62,7 +62,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 callbackData.view.GetBuffer()->BlockAllCpuBackingWrites();
 
                 auto srcGpuAllocation{callbackData.ctx.gpu.megaBufferAllocator.Push(callbackData.ctx.executor.cycle, callbackData.srcCpuBuf)};
-                callbackData.ctx.executor.AddOutsideRpCommand([=, srcCpuBuf = callbackData.srcCpuBuf, view = callbackData.view, offset = callbackData.offset](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
+                auto dstRange{callbackData.view.GetGuestSpan().subspan(callbackData.offset, callbackData.srcCpuBuf.size())};
+                callbackData.ctx.executor.AddTransferCommand({}, dstRange, [=, srcCpuBuf = callbackData.srcCpuBuf, view = callbackData.view, offset = callbackData.offset](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
                     auto binding{view.GetBinding(gpu)};
                     vk::BufferCopy copyRegion{
                         .size = srcCpuBuf.size_bytes(),
@@ -70,10 +71,6 @@ namespace skyline::gpu::interconnect::maxwell3d {
                         .dstOffset = binding.offset + offset
                     };
                     commandBuffer.copyBuffer(srcGpuAllocation.buffer, binding.buffer, copyRegion);
-                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
-                        .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
-                        .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite
-                    }, {}, {});
                 });
             });
         }
@@ -84,7 +81,12 @@ namespace skyline::gpu::interconnect::maxwell3d {
         if (!view)
             throw exception("Constant buffer selector is not mapped");
 
-        boundConstantBuffers[static_cast<size_t>(stage)][index] = {view};
+        auto &boundConstantBuffer{boundConstantBuffers[static_cast<size_t>(stage)][index]};
+        // Games commonly rebind every constant buffer prior to each draw even if they're unchanged, the descriptors of the prior draw are still valid for these so they don't use up the quick bind
+        if (boundConstantBuffer.view == view)
+            return;
+
+        boundConstantBuffer = {view};
 
         if (quickBindEnabled && quickBind)
             DisableQuickBind(); // We can only quick bind one buffer per draw
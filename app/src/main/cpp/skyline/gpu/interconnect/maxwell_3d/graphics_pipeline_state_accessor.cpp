@@ -35,4 +35,54 @@ namespace skyline::gpu::interconnect::maxwell3d {
         if (ctx.gpu.graphicsPipelineCacheManager)
             ctx.gpu.graphicsPipelineCacheManager->QueueWrite(std::move(bundle));
     }
+
+    SnapshotGraphicsPipelineStateAccessor::SnapshotGraphicsPipelineStateAccessor(std::unique_ptr<PipelineStateBundle> pBundle,
+                                                                                 InterconnectContext &ctx,
+                                                                                 Textures &textures, ConstantBufferSet &constantBuffers,
+                                                                                 const std::array<ShaderBinary, engine::PipelineCount> &shaderBinaries)
+        : bundle{std::move(pBundle)}, gpu{ctx.gpu}, textureHeaders{textures.GetTextureHeaders(ctx)} {
+        for (u32 i{}; i < engine::PipelineCount; i++) {
+            if (shaderBinaries[i].binary.empty())
+                continue;
+
+            // The guest shader binaries may be overwritten after this point so they are copied into the bundle and accessed from there
+            bundle->SetShaderBinary(i, shaderBinaries[i]);
+
+            u32 shaderStage{i > 0 ? (i - 1) : 0};
+            for (u32 index{}; index < engine::ShaderStageConstantBufferCount; index++) {
+                auto &constantBuffer{constantBuffers[shaderStage][index]};
+                auto &contents{constantBufferContents[shaderStage][index]};
+                if (!constantBuffer.view || !contents.empty())
+                    continue;
+
+                contents.resize(constantBuffer.view.size);
+                constantBuffer.Read(ctx.executor, contents, 0);
+            }
+        }
+    }
+
+    Shader::TextureType SnapshotGraphicsPipelineStateAccessor::GetTextureType(u32 index) const {
+        Shader::TextureType type{Textures::ConvertTextureType(textureHeaders[index])};
+        bundle->AddTextureType(index, type);
+        return type;
+    }
+
+    u32 SnapshotGraphicsPipelineStateAccessor::GetConstantBufferValue(u32 shaderStage, u32 index, u32 offset) const {
+        auto &contents{constantBufferContents[shaderStage][index]};
+        u32 value{};
+        if (offset + sizeof(u32) <= contents.size())
+            std::memcpy(&value, contents.data() + offset, sizeof(u32));
+
+        bundle->AddConstantBufferValue(shaderStage, index, offset, value);
+        return value;
+    }
+
+    ShaderBinary SnapshotGraphicsPipelineStateAccessor::GetShaderBinary(u32 pipelineStage) const {
+        return bundle->GetShaderBinary(pipelineStage);
+    }
+
+    void SnapshotGraphicsPipelineStateAccessor::MarkComplete() {
+        if (gpu.graphicsPipelineCacheManager)
+            gpu.graphicsPipelineCacheManager->QueueWrite(std::move(bundle));
+    }
 }
@@ -35,4 +35,30 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         void MarkComplete() override;
     };
+
+    /**
+     * @brief Implements the PipelineStateAccessor interface for pipelines created asynchronously at emulator runtime, all state that can be accessed during shader translation is captured upon construction so that translation can occur on any thread
+     * @note The TICs are not copied and are instead read from the guest texture pool at the time of translation as the pool is rarely modified while in use
+     */
+    class SnapshotGraphicsPipelineStateAccessor : public PipelineStateAccessor {
+      private:
+        std::unique_ptr<PipelineStateBundle> bundle;
+        GPU &gpu;
+        span<TextureImageControl> textureHeaders;
+        std::array<std::array<std::vector<u8>, engine::ShaderStageConstantBufferCount>, engine::ShaderStageCount> constantBufferContents; //!< The contents of all constant buffers bound to active stages at the time of construction
+
+      public:
+        SnapshotGraphicsPipelineStateAccessor(std::unique_ptr<PipelineStateBundle> bundle,
+                                              InterconnectContext &ctx,
+                                              Textures &textures, ConstantBufferSet &constantBuffers,
+                                              const std::array<ShaderBinary, engine::PipelineCount> &shaderBinaries);
+
+        Shader::TextureType GetTextureType(u32 index) const override;
+
+        u32 GetConstantBufferValue(u32 shaderStage, u32 index, u32 offset) const override;
+
+        ShaderBinary GetShaderBinary(u32 pipelineStage) const override;
+
+        void MarkComplete() override;
+    };
 }
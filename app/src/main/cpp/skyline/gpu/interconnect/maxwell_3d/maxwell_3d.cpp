@@ -24,6 +24,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
           samplers{manager, registerBundle.samplerPoolRegisters},
           samplerBinding{registerBundle.samplerBinding},
           textures{manager, registerBundle.texturePoolRegisters},
+          queries{registerBundle.queriesRegisters},
           directState{activeState.directState} {
         ctx.executor.AddFlushCallback([this] {
             if (attachedDescriptorSets) {
@@ -32,6 +33,9 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 activeDescriptorSet = nullptr;
             }
 
+            // Any resources referenced by cached sets are only guaranteed to be alive for the duration of the execution
+            descriptorSetCache.clear();
+
             activeState.MarkAllDirty();
             constantBuffers.MarkAllDirty();
             samplers.MarkAllDirty();
@@ -51,7 +55,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
         vk::DeviceSize size{conversion::quads::GetRequiredBufferSize(count, sizeof(u32)) + offset};
 
         if (!quadConversionBuffer || quadConversionBuffer->size_bytes() < size) {
-            quadConversionBuffer = std::make_shared<memory::Buffer>(ctx.gpu.memory.AllocateBuffer(util::AlignUp(size, PAGE_SIZE)));
+            quadConversionBuffer = std::make_shared<memory::Buffer>(ctx.gpu.memory.AllocateBuffer(util::AlignUp(size, PAGE_SIZE), memory::AllocationCategory::Miscellaneous));
             conversion::quads::GenerateQuadListConversionBuffer(quadConversionBuffer->cast<u32>().data(), firstVertex + count);
             quadConversionBufferAttached = false;
         }
@@ -64,6 +68,87 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return offset;
     }
 
+    /**
+     * @return A hash of the layout and contents of the descriptor set resulting from the supplied update, if they are entirely known prior to recording
+     */
+    static std::optional<u64> HashDescriptorUpdate(const DescriptorUpdateInfo &updateInfo) {
+        // Copies depend on the contents of the previous set and buffer views are only resolved during recording
+        if (!updateInfo.copies.empty())
+            return std::nullopt;
+
+        u64 hash{XXH64(&updateInfo.descriptorSetLayout, sizeof(updateInfo.descriptorSetLayout), 0)};
+        for (const auto &dynamicBinding : updateInfo.bufferDescDynamicBindings) {
+            auto binding{std::get_if<BufferBinding>(&dynamicBinding)};
+            if (!binding)
+                return std::nullopt;
+
+            hash = XXH64(binding, sizeof(BufferBinding), hash);
+        }
+
+        for (const auto &write : updateInfo.writes) {
+            hash = XXH64(&write.dstBinding, sizeof(write.dstBinding), hash);
+            hash = XXH64(&write.descriptorType, sizeof(write.descriptorType), hash);
+            if (write.pImageInfo) {
+                for (const auto &imageInfo : span<const vk::DescriptorImageInfo>{write.pImageInfo, write.descriptorCount}) {
+                    hash = XXH64(&imageInfo.sampler, sizeof(imageInfo.sampler), hash);
+                    hash = XXH64(&imageInfo.imageView, sizeof(imageInfo.imageView), hash);
+                    hash = XXH64(&imageInfo.imageLayout, sizeof(imageInfo.imageLayout), hash);
+                }
+            }
+        }
+
+        return hash;
+    }
+
+    void Maxwell3D::BindDescriptorSet(StateUpdateBuilder &builder, DescriptorUpdateInfo *updateInfo) {
+        auto hash{HashDescriptorUpdate(*updateInfo)};
+        if (hash) {
+            auto it{descriptorSetCache.find(*hash)};
+            if (it != descriptorSetCache.end()) {
+                activeDescriptorSet = it->second;
+                builder.BindDescriptorSet(updateInfo, activeDescriptorSet);
+                return;
+            }
+        }
+
+        if (!attachedDescriptorSets)
+            attachedDescriptorSets = std::make_shared<boost::container::static_vector<DescriptorAllocator::ActiveDescriptorSet, DescriptorBatchSize>>();
+
+        auto newSet{&attachedDescriptorSets->emplace_back(ctx.gpu.descriptor.AllocateSet(updateInfo->descriptorSetLayout))};
+        auto *oldSet{activeDescriptorSet};
+        activeDescriptorSet = newSet;
+
+        if (hash) {
+            // All descriptors are known ahead of time so the set can be written immediately, it must then never be written to again so that it can be shared
+            for (size_t i{}; i < updateInfo->bufferDescDynamicBindings.size(); i++) {
+                const auto &binding{std::get<BufferBinding>(updateInfo->bufferDescDynamicBindings[i])};
+                updateInfo->bufferDescs[i] = vk::DescriptorBufferInfo{
+                    .buffer = binding.buffer,
+                    .offset = binding.offset,
+                    .range = binding.size
+                };
+            }
+
+            if (updateInfo->updateTemplate) {
+                (*ctx.gpu.vkDevice).updateDescriptorSetWithTemplate(**newSet, updateInfo->updateTemplate, updateInfo->updateTemplateData, *ctx.gpu.vkDevice.getDispatcher());
+            } else {
+                for (auto &write : updateInfo->writes)
+                    write.dstSet = **newSet;
+
+                ctx.gpu.vkDevice.updateDescriptorSets(updateInfo->writes, {});
+            }
+            descriptorSetCache.emplace(*hash, newSet);
+            builder.BindDescriptorSet(updateInfo, newSet);
+        } else {
+            builder.SetDescriptorSetWithUpdate(updateInfo, newSet, oldSet);
+        }
+
+        if (attachedDescriptorSets->size() == DescriptorBatchSize) {
+            ctx.executor.AttachDependency(attachedDescriptorSets);
+            attachedDescriptorSets.reset();
+        }
+    }
+
     vk::Rect2D Maxwell3D::GetClearScissor() {
         const auto &clearSurfaceControl{clearEngineRegisters.clearSurfaceControl};
 
@@ -128,13 +213,17 @@ namespace skyline::gpu::interconnect::maxwell3d {
     }
 
     void Maxwell3D::Clear(engine::ClearSurface &clearSurface) {
+        if (queries.IsRenderDisabled())
+            return;
+
         auto scissor{GetClearScissor()};
         if (scissor.extent.width == 0 || scissor.extent.height == 0)
             return;
 
         auto needsAttachmentClearCmd{[&](auto &view) {
-            return scissor.offset.x != 0 || scissor.offset.y != 0 ||
-                scissor.extent != vk::Extent2D{view->texture->dimensions} ||
+            auto viewScissor{gpu::texture::ScaleRect(scissor, view->texture->resolutionScale)};
+            return viewScissor.offset.x != 0 || viewScissor.offset.y != 0 ||
+                viewScissor.extent != vk::Extent2D{view->texture->dimensions} ||
                 view->range.layerCount != 1 || view->range.baseArrayLayer != 0 || clearSurface.rtArrayIndex != 0;
         }};
 
@@ -142,7 +231,6 @@ namespace skyline::gpu::interconnect::maxwell3d {
         const auto &surfaceClip{clearEngineRegisters.surfaceClip};
         vk::Rect2D renderArea{{surfaceClip.horizontal.x, surfaceClip.vertical.y}, {surfaceClip.horizontal.width, surfaceClip.vertical.height}};
 
-        auto clearRects{util::MakeFilledArray<vk::ClearRect, 2>(vk::ClearRect{.rect = scissor, .baseArrayLayer = clearSurface.rtArrayIndex, .layerCount = 1})};
         boost::container::small_vector<vk::ClearAttachment, 2> clearAttachments;
 
         std::shared_ptr<TextureView> colorView{};
@@ -165,7 +253,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
                                                                   (clearSurface.aEnable ? vk::ColorComponentFlagBits::eA : vk::ColorComponentFlags{}),
                                                                   {clearEngineRegisters.colorClearValue}, &*view, [=](auto &&executionCallback) {
                         auto dst{view.get()};
-                        ctx.executor.AddSubpass(std::move(executionCallback), renderArea, {}, {}, span<TextureView *>{dst}, nullptr);
+                        ctx.executor.AddSubpass(std::move(executionCallback), gpu::texture::ScaleRect(renderArea, dst->texture->resolutionScale), {}, {}, span<TextureView *>{dst}, nullptr);
                     });
                     ctx.executor.NotifyPipelineChange();
                 } else if (needsAttachmentClearCmd(view)) {
@@ -204,19 +292,100 @@ namespace skyline::gpu::interconnect::maxwell3d {
         if (clearAttachments.empty())
             return;
 
+        u32 resolutionScale{colorView ? colorView->texture->resolutionScale : depthStencilView->texture->resolutionScale};
+        auto clearRects{util::MakeFilledArray<vk::ClearRect, 2>(vk::ClearRect{.rect = gpu::texture::ScaleRect(scissor, resolutionScale), .baseArrayLayer = clearSurface.rtArrayIndex, .layerCount = 1})};
+
         std::array<TextureView *, 1> colorAttachments{colorView ? &*colorView : nullptr};
         ctx.executor.AddSubpass([clearAttachments, clearRects](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32) {
             commandBuffer.clearAttachments(clearAttachments, span(clearRects).first(clearAttachments.size()));
-        }, renderArea, {}, {}, colorView ? colorAttachments : span<TextureView *>{}, depthStencilView ? &*depthStencilView : nullptr);
+        }, gpu::texture::ScaleRect(renderArea, resolutionScale), {}, {}, colorView ? colorAttachments : span<TextureView *>{}, depthStencilView ? &*depthStencilView : nullptr);
+    }
+
+    /**
+     * @brief Struct that can be linearly allocated, holding all state for the draw to avoid a dynamic allocation with lambda captures
+     */
+    struct Maxwell3D::DrawParams {
+        StateUpdater stateUpdater;
+        span<vk::MultiDrawIndexedInfoEXT> draws; //!< The parameters of all draws in the batch, this initially only contains `firstDraw` and is reallocated from the linear allocator as draws are batched
+        vk::MultiDrawIndexedInfoEXT firstDraw; //!< The parameters of the first draw, the vertex offset is ignored for non-indexed draws
+        u32 drawCount;
+        u32 instanceCount;
+        u32 firstInstance;
+        bool indexed;
+        bool transformFeedbackEnable;
+        bool skipDraw;
+        Queries::DrawState queryState;
+        BufferView indirectBuffer; //!< The buffer that the parameters of the draws are read from on the GPU, `draws` is ignored if this is set
+        BufferView countBuffer; //!< The buffer that the draw count is read from on the GPU, `drawCount` is the maximum draw count if this is set
+        u32 indirectStride;
+    };
+
+    struct Maxwell3D::IndirectDraw {
+        BufferView buffer;
+        BufferView countBuffer;
+        u32 drawCount;
+        u32 stride;
+    };
+
+    bool Maxwell3D::TryBatchDraw(bool indexed, u32 count, u32 first, u32 instanceCount, u32 vertexOffset, u32 firstInstance, vk::Rect2D scissor, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment) {
+        // Any node added after the batch could depend on its draws having been recorded prior to it
+        if (!drawBatch || ctx.executor.GetNodePosition() != drawBatchPosition)
+            return false;
+
+        if (drawBatch->indexed != indexed || drawBatch->instanceCount != instanceCount || drawBatch->firstInstance != firstInstance)
+            return false;
+
+        if (drawBatchScissor != scissor || drawBatchDepthAttachment != depthStencilAttachment || !ranges::equal(drawBatchColorAttachments, colorAttachments))
+            return false;
+
+        u32 maxDrawCount{ctx.gpu.traits.supportsMultiDraw ? std::min(ctx.gpu.traits.maxMultiDrawCount, MaxBatchedDraws) : MaxBatchedDraws};
+        if (drawBatch->drawCount >= maxDrawCount)
+            return false;
+
+        if (drawBatch->drawCount == drawBatch->draws.size()) {
+            auto draws{ctx.executor.allocator->AllocateUntracked<vk::MultiDrawIndexedInfoEXT>(std::min<size_t>(drawBatch->draws.size() * 4, maxDrawCount))};
+            std::copy(drawBatch->draws.begin(), drawBatch->draws.end(), draws.begin());
+            drawBatch->draws = draws;
+        }
+
+        drawBatch->draws[drawBatch->drawCount++] = vk::MultiDrawIndexedInfoEXT{first, count, static_cast<i32>(vertexOffset)};
+        return true;
     }
 
-    void Maxwell3D::Draw(engine::DrawTopology topology, bool transformFeedbackEnable, bool indexed, u32 count, u32 first, u32 instanceCount, u32 vertexOffset, u32 firstInstance) {
+    void Maxwell3D::Draw(engine::DrawTopology topology, bool transformFeedbackEnable, bool indexed, u32 count, u32 first, u32 instanceCount, u32 vertexOffset, u32 firstInstance, span<u32> inlineIndices, const IndirectDraw *indirect) {
+        // Returning prior to any state updates leaves all dirty state intact for the next draw
+        if (queries.IsRenderDisabled())
+            return;
+
         StateUpdateBuilder builder{*ctx.executor.allocator};
 
-        Pipeline *oldPipeline{activeState.GetPipeline()};
+        // Pipelines using reloaded shader replacements are retired, all state must then be reflushed to look up their recreated versions
+        if (u32 generation{ctx.gpu.shader->GetReplacementGeneration()}; generation != shaderReplacementGeneration) [[unlikely]] {
+            ctx.gpu.graphicsPipelineManager->RetireReloadedPipelines();
+            shaderReplacementGeneration = generation;
+            activeState.MarkAllDirty();
+        }
+
+        Pipeline *oldPipeline{pipelineSkipped ? nullptr : activeState.GetPipeline()};
+        if (oldPipeline && fallbackPipeline)
+            oldPipeline = fallbackPipeline;
+
         samplers.Update(ctx, samplerBinding.value == engine::SamplerBinding::Value::ViaHeaderBinding);
-        activeState.Update(ctx, textures, constantBuffers.boundConstantBuffers, builder, indexed, topology, first, count);
-        if (directState.inputAssembly.NeedsQuadConversion()) {
+        activeState.Update(ctx, textures, constantBuffers.boundConstantBuffers, builder, indexed && inlineIndices.empty(), topology, first, count);
+        if (!inlineIndices.empty()) {
+            // Inline indices are streamed into the megabuffer and bound in place of the guest index buffer
+            if (directState.inputAssembly.NeedsQuadConversion()) {
+                auto allocation{ctx.gpu.megaBufferAllocator.Allocate(ctx.executor.cycle, conversion::quads::GetRequiredBufferSize(count, sizeof(u32)))};
+                conversion::quads::GenerateIndexedQuadConversionBuffer(allocation.region.data(), inlineIndices.cast<u8>().data(), count, vk::IndexType::eUint32);
+                builder.SetIndexBuffer(BufferBinding{allocation.buffer, allocation.offset}, vk::IndexType::eUint32);
+                count = conversion::quads::GetIndexCount(count);
+            } else {
+                auto allocation{ctx.gpu.megaBufferAllocator.Push(ctx.executor.cycle, inlineIndices.cast<u8>())};
+                builder.SetIndexBuffer(BufferBinding{allocation.buffer, allocation.offset}, vk::IndexType::eUint32);
+            }
+            first = 0;
+            activeState.MarkIndexBufferDirty();
+        } else if (directState.inputAssembly.NeedsQuadConversion()) {
             count = conversion::quads::GetIndexCount(count);
             first = 0;
 
@@ -225,14 +394,30 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 vk::DeviceSize offset{UpdateQuadConversionBuffer(count, first)};
                 builder.SetIndexBuffer(BufferBinding{quadConversionBuffer->vkBuffer, offset}, vk::IndexType::eUint32);
                 indexed = true;
+                activeState.MarkIndexBufferDirty(); // The guest index buffer must be rebound by the next indexed draw
             }
         }
 
         Pipeline *pipeline{activeState.GetPipeline()};
-        activeDescriptorSetSampledImages.resize(pipeline->GetTotalSampledImageCount());
+
+        // If the pipeline is still being compiled asynchronously, a ready pipeline using the same shaders is drawn with instead where possible
+        fallbackPipeline = nullptr;
+        if (!pipeline->IsReady()) {
+            if (auto *fallback{ctx.gpu.graphicsPipelineManager->FindFallback(pipeline)}) {
+                fallbackPipeline = fallback;
+                pipeline = fallback;
+            }
+        }
+
+        // Otherwise the draw is skipped, the state updates are still recorded as their dirty state has already been consumed
+        bool skipDraw{!pipeline->IsReady()};
+        pipelineSkipped = skipDraw;
+        activeDescriptorSetSampledImages.resize(skipDraw ? 0 : pipeline->GetTotalSampledImageCount());
 
         auto *descUpdateInfo{[&]() -> DescriptorUpdateInfo * {
-            if (((oldPipeline == pipeline) || (oldPipeline && oldPipeline->CheckBindingMatch(pipeline))) && constantBuffers.quickBindEnabled) {
+            if (skipDraw)
+                return nullptr;
+            else if (((oldPipeline == pipeline) || (oldPipeline && oldPipeline->CheckBindingMatch(pipeline))) && constantBuffers.quickBindEnabled) {
                 // If bindings between the old and new pipelines are the same we can reuse the descriptor sets given that quick bind is enabled (meaning that no buffer updates or calls to non-graphics engines have occurred that could invalidate them)
                 if (constantBuffers.quickBind)
                     // If only a single constant buffer has been rebound between draws we can perform a partial descriptor update
@@ -245,54 +430,26 @@ namespace skyline::gpu::interconnect::maxwell3d {
             }
         }()};
 
-        if (oldPipeline != pipeline)
+        if (oldPipeline != pipeline && !skipDraw)
             // If the pipeline has changed, we need to update the pipeline state
-            builder.SetPipeline(pipeline->compiledPipeline.pipeline, vk::PipelineBindPoint::eGraphics);
+            builder.SetPipeline(pipeline->compiledPipeline.pipeline, vk::PipelineBindPoint::eGraphics, pipeline->compiledPipeline.optimizedPipeline);
 
         if (descUpdateInfo) {
-            if (ctx.gpu.traits.supportsPushDescriptors) {
+            if (pipeline->compiledPipeline.usesPushDescriptors)
                 builder.SetDescriptorSetWithPush(descUpdateInfo);
-            } else {
-                if (!attachedDescriptorSets)
-                    attachedDescriptorSets = std::make_shared<boost::container::static_vector<DescriptorAllocator::ActiveDescriptorSet, DescriptorBatchSize>>();
-
-                auto newSet{&attachedDescriptorSets->emplace_back(ctx.gpu.descriptor.AllocateSet(descUpdateInfo->descriptorSetLayout))};
-                auto *oldSet{activeDescriptorSet};
-                activeDescriptorSet = newSet;
-
-                builder.SetDescriptorSetWithUpdate(descUpdateInfo, activeDescriptorSet, oldSet);
-
-                if (attachedDescriptorSets->size() == DescriptorBatchSize) {
-                    ctx.executor.AttachDependency(attachedDescriptorSets);
-                    attachedDescriptorSets.reset();
-                }
-            }
+            else
+                BindDescriptorSet(builder, descUpdateInfo);
         }
 
         auto stateUpdater{builder.Build()};
-
-        /**
-         * @brief Struct that can be linearly allocated, holding all state for the draw to avoid a dynamic allocation with lambda captures
-         */
-        struct DrawParams {
-            StateUpdater stateUpdater;
-            u32 count;
-            u32 first;
-            u32 instanceCount;
-            u32 vertexOffset;
-            u32 firstInstance;
-            bool indexed;
-            bool transformFeedbackEnable;
-        };
-        auto *drawParams{ctx.executor.allocator->EmplaceUntracked<DrawParams>(DrawParams{stateUpdater,
-                                                                                         count, first, instanceCount, vertexOffset, firstInstance, indexed,
-                                                                                         ctx.gpu.traits.supportsTransformFeedback ? transformFeedbackEnable : false})};
+        auto queryState{queries.GetDrawState(ctx)};
+        bool transformFeedback{ctx.gpu.traits.supportsTransformFeedback ? transformFeedbackEnable : false};
 
         const auto &surfaceClip{clearEngineRegisters.surfaceClip};
-        vk::Rect2D scissor{
+        vk::Rect2D scissor{gpu::texture::ScaleRect({
             {surfaceClip.horizontal.x, surfaceClip.vertical.y},
             {surfaceClip.horizontal.width, surfaceClip.vertical.height}
-        };
+        }, activeState.GetResolutionScale())};
 
         auto colorAttachments{activeState.GetColorAttachments()};
         auto depthStencilAttachment{activeState.GetDepthAttachment()};
@@ -306,20 +463,198 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         constantBuffers.ResetQuickBind();
 
+        // Draws which don't update any state are appended to the subpass of the prior draw rather than adding one of their own
+        bool batchable{!skipDraw && !queryState.queryPool && !queryState.predicateBuffer && !transformFeedback && !indirect};
+        if (batchable && !descUpdateInfo && oldPipeline == pipeline && stateUpdater.Empty())
+            if (TryBatchDraw(indexed, count, first, instanceCount, vertexOffset, firstInstance, scissor, colorAttachments, depthStencilAttachment))
+                return;
+
+        auto *drawParams{ctx.executor.allocator->EmplaceUntracked<DrawParams>(DrawParams{
+            .stateUpdater = stateUpdater,
+            .firstDraw = {first, count, static_cast<i32>(vertexOffset)},
+            .drawCount = 1,
+            .instanceCount = instanceCount,
+            .firstInstance = firstInstance,
+            .indexed = indexed,
+            .transformFeedbackEnable = transformFeedback,
+            .skipDraw = skipDraw,
+            .queryState = queryState,
+        })};
+        drawParams->draws = span<vk::MultiDrawIndexedInfoEXT>{&drawParams->firstDraw, 1};
+
+        if (indirect) {
+            drawParams->indirectBuffer = indirect->buffer;
+            drawParams->countBuffer = indirect->countBuffer;
+            drawParams->drawCount = indirect->drawCount;
+            drawParams->indirectStride = indirect->stride;
+
+            // The parameters are written by prior GPU work which must complete before they're read, this can't be done inside of the render pass
+            if (!skipDraw)
+                ctx.executor.AddOutsideRpCommand([](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+                    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eDrawIndirect, {}, vk::MemoryBarrier{
+                        .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                        .dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead
+                    }, {}, {});
+                });
+        }
+
         ctx.executor.AddSubpass([drawParams](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu, vk::RenderPass, u32) {
             drawParams->stateUpdater.RecordAll(gpu, commandBuffer);
 
-            if (drawParams->transformFeedbackEnable)
-                commandBuffer.beginTransformFeedbackEXT(0, {}, {});
+            // Queries must always be ended even if the draw is skipped, as reports wait on their results becoming available
+            const auto &queryState{drawParams->queryState};
+            if (queryState.queryPool)
+                commandBuffer.beginQuery(queryState.queryPool, queryState.queryIndex, gpu.traits.supportsPreciseOcclusionQueries ? vk::QueryControlFlagBits::ePrecise : vk::QueryControlFlags{});
 
-            if (drawParams->indexed)
-                commandBuffer.drawIndexed(drawParams->count, drawParams->instanceCount, drawParams->first, static_cast<i32>(drawParams->vertexOffset), drawParams->firstInstance);
-            else
-                commandBuffer.draw(drawParams->count, drawParams->instanceCount, drawParams->first, drawParams->firstInstance);
+            if (!drawParams->skipDraw) {
+                if (queryState.predicateBuffer)
+                    commandBuffer.beginConditionalRenderingEXT(vk::ConditionalRenderingBeginInfoEXT{
+                        .buffer = queryState.predicateBuffer,
+                        .offset = queryState.predicateOffset,
+                    });
+
+                if (drawParams->transformFeedbackEnable)
+                    commandBuffer.beginTransformFeedbackEXT(0, {}, {});
+
+                auto draws{drawParams->draws.first(drawParams->indirectBuffer ? 0 : drawParams->drawCount)};
+                if (drawParams->indirectBuffer) {
+                    auto binding{drawParams->indirectBuffer.GetBinding(gpu)};
+                    if (drawParams->countBuffer) {
+                        auto countBinding{drawParams->countBuffer.GetBinding(gpu)};
+                        if (drawParams->indexed)
+                            (*commandBuffer).drawIndexedIndirectCountKHR(binding.buffer, binding.offset, countBinding.buffer, countBinding.offset, drawParams->drawCount, drawParams->indirectStride, *gpu.vkDevice.getDispatcher());
+                        else
+                            (*commandBuffer).drawIndirectCountKHR(binding.buffer, binding.offset, countBinding.buffer, countBinding.offset, drawParams->drawCount, drawParams->indirectStride, *gpu.vkDevice.getDispatcher());
+                    } else if (drawParams->indexed) {
+                        commandBuffer.drawIndexedIndirect(binding.buffer, binding.offset, drawParams->drawCount, drawParams->indirectStride);
+                    } else {
+                        commandBuffer.drawIndirect(binding.buffer, binding.offset, drawParams->drawCount, drawParams->indirectStride);
+                    }
+                } else if (draws.size() > 1 && gpu.traits.supportsMultiDraw) {
+                    // The layout of VkMultiDrawInfoEXT matches the start of VkMultiDrawIndexedInfoEXT, so the same array can be used for non-indexed draws with a larger stride
+                    if (drawParams->indexed)
+                        (*commandBuffer).drawMultiIndexedEXT(static_cast<u32>(draws.size()), draws.data(), drawParams->instanceCount, drawParams->firstInstance, sizeof(vk::MultiDrawIndexedInfoEXT), nullptr, *gpu.vkDevice.getDispatcher());
+                    else
+                        (*commandBuffer).drawMultiEXT(static_cast<u32>(draws.size()), reinterpret_cast<const vk::MultiDrawInfoEXT *>(draws.data()), drawParams->instanceCount, drawParams->firstInstance, sizeof(vk::MultiDrawIndexedInfoEXT), *gpu.vkDevice.getDispatcher());
+                } else {
+                    for (const auto &draw : draws) {
+                        if (drawParams->indexed)
+                            commandBuffer.drawIndexed(draw.indexCount, drawParams->instanceCount, draw.firstIndex, draw.vertexOffset, drawParams->firstInstance);
+                        else
+                            commandBuffer.draw(draw.indexCount, drawParams->instanceCount, draw.firstIndex, drawParams->firstInstance);
+                    }
+                }
+
+                if (drawParams->transformFeedbackEnable)
+                    commandBuffer.endTransformFeedbackEXT(0, {}, {});
 
-            if (drawParams->transformFeedbackEnable)
-                commandBuffer.endTransformFeedbackEXT(0, {}, {});
+                if (queryState.predicateBuffer)
+                    commandBuffer.endConditionalRenderingEXT();
+            }
+
+            if (queryState.queryPool)
+                commandBuffer.endQuery(queryState.queryPool, queryState.queryIndex);
         }, scissor, activeDescriptorSetSampledImages, {}, activeState.GetColorAttachments(), activeState.GetDepthAttachment(), !ctx.gpu.traits.quirks.relaxedRenderPassCompatibility);
 
+        if (batchable) {
+            drawBatch = drawParams;
+            drawBatchPosition = ctx.executor.GetNodePosition();
+            drawBatchScissor = scissor;
+            drawBatchColorAttachments.assign(colorAttachments.begin(), colorAttachments.end());
+            drawBatchDepthAttachment = depthStencilAttachment;
+        } else {
+            drawBatch = nullptr;
+        }
+    }
+
+    bool Maxwell3D::DrawIndirect(engine::DrawTopology topology, bool transformFeedbackEnable, bool indexed, span<u8> indirectBuffer, u32 drawCount, u32 stride, span<u8> countBuffer, u32 count, u32 first) {
+        // Quad lists are converted into triangle lists by rewriting their indices on the CPU, which requires the draw parameters to be known
+        if (topology == engine::DrawTopology::Quads || !drawCount)
+            return false;
+
+        if ((drawCount > 1 && !ctx.gpu.traits.supportsMultiDrawIndirect) || (!countBuffer.empty() && !ctx.gpu.traits.supportsDrawIndirectCount))
+            return false;
+
+        // Vulkan requires the parameters and the count to be word aligned
+        if (!util::IsAligned(reinterpret_cast<uintptr_t>(indirectBuffer.data()), sizeof(u32)) || !util::IsAligned(stride, sizeof(u32)) || (!countBuffer.empty() && !util::IsAligned(reinterpret_cast<uintptr_t>(countBuffer.data()), sizeof(u32))))
+            return false;
+
+        // The values seen by the CPU are only stale if the parameters are in a buffer that's written by GPU work which is yet to execute or hasn't been synchronized back, a direct draw is cheaper otherwise as it can be batched
+        auto view{ctx.gpu.buffer.TryFind(indirectBuffer)};
+        if (!view)
+            return false;
+
+        ContextLock viewLock{ctx.executor.tag, view};
+        if (viewLock.IsFirstUsage() && !view.GetBuffer()->IsGpuDirty())
+            return false;
+
+        auto attachBuffer{[this](std::shared_ptr<Buffer> buffer, ContextLock<Buffer> &&lock) {
+            ctx.executor.AttachLockedBuffer(buffer, std::move(lock));
+        }};
+
+        BufferView countView{};
+        if (!countBuffer.empty()) {
+            countView = ctx.gpu.buffer.FindOrCreate(countBuffer, ctx.executor.tag, attachBuffer);
+            ContextLock countViewLock{ctx.executor.tag, countView};
+            ctx.executor.AttachLockedBufferView(countView, std::move(countViewLock));
+        }
+        ctx.executor.AttachLockedBufferView(view, std::move(viewLock));
+
+        IndirectDraw indirect{
+            .buffer = view,
+            .countBuffer = countView,
+            .drawCount = drawCount,
+            .stride = stride,
+        };
+        Draw(topology, transformFeedbackEnable, indexed, count, first, 1, 0, 0, {}, &indirect);
+        return true;
+    }
+
+    bool Maxwell3D::WriteSemaphore(soc::gm20b::IOVA address, span<u8> data) {
+        auto mappings{ctx.channelCtx.asCtx->gmmu.TranslateRange(address, data.size())};
+        if (mappings.size() != 1 || !mappings.front().valid() || mappings.front().size() != data.size())
+            return false;
+
+        // vkCmdUpdateBuffer requires the destination offset and size to be word aligned
+        auto mapping{mappings.front()};
+        if (!util::IsAligned(reinterpret_cast<uintptr_t>(mapping.data()), sizeof(u32)) || !util::IsAligned(data.size(), sizeof(u32)))
+            return false;
+
+        auto view{ctx.gpu.buffer.FindOrCreate(mapping, ctx.executor.tag, [this](std::shared_ptr<Buffer> buffer, ContextLock<Buffer> &&lock) {
+            ctx.executor.AttachLockedBuffer(buffer, std::move(lock));
+        })};
+        ContextLock viewLock{ctx.executor.tag, view};
+        ctx.executor.AttachLockedBufferView(view, std::move(viewLock));
+
+        view.GetBuffer()->BlockSequencedCpuBackingWrites();
+        view.GetBuffer()->MarkGpuDirty();
+
+        auto payload{ctx.executor.allocator->AllocateUntracked<u8>(data.size())};
+        payload.copy_from(data);
+
+        ctx.executor.AddOutsideRpCommand([view, payload](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
+            auto binding{view.GetBinding(gpu)};
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferWrite
+            }, {}, {});
+
+            commandBuffer.updateBuffer(binding.buffer, binding.offset, payload.size_bytes(), payload.data());
+        });
+
+        return true;
+    }
+
+    void Maxwell3D::ResetSamplesPassed() {
+        queries.ResetCounter();
+    }
+
+    bool Maxwell3D::ReportSamplesPassed(soc::gm20b::IOVA address, bool fourWords, u64 timestamp) {
+        return queries.Report(ctx, address, fourWords, timestamp);
+    }
+
+    void Maxwell3D::SetRenderEnable(soc::gm20b::IOVA address, engine::RenderEnableMode mode) {
+        queries.SetRenderEnable(ctx, address, mode);
     }
-}
\ No newline at end of file
+}
@@ -3,12 +3,14 @@
 
 #pragma once
 
+#include <soc/gm20b/gmmu.h>
 #include <gpu/descriptor_allocator.h>
 #include <gpu/interconnect/common/samplers.h>
 #include <gpu/interconnect/common/textures.h>
 #include "common.h"
 #include "active_state.h"
 #include "constant_buffers.h"
+#include "queries.h"
 
 namespace skyline::gpu::interconnect::maxwell3d {
     /**
@@ -37,6 +39,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             SamplerPoolState::EngineRegisters samplerPoolRegisters;
             const engine::SamplerBinding &samplerBinding;
             TexturePoolState::EngineRegisters texturePoolRegisters;
+            Queries::EngineRegisters queriesRegisters;
         };
 
       private:
@@ -47,18 +50,45 @@ namespace skyline::gpu::interconnect::maxwell3d {
         Samplers samplers;
         const engine::SamplerBinding &samplerBinding;
         Textures textures;
+        Queries queries;
         std::shared_ptr<memory::Buffer> quadConversionBuffer{};
         bool quadConversionBufferAttached{};
 
         static constexpr size_t DescriptorBatchSize{0x100};
         std::shared_ptr<boost::container::static_vector<DescriptorAllocator::ActiveDescriptorSet, DescriptorBatchSize>> attachedDescriptorSets;
         DescriptorAllocator::ActiveDescriptorSet *activeDescriptorSet{};
+        std::unordered_map<u64, DescriptorAllocator::ActiveDescriptorSet *> descriptorSetCache; //!< Descriptor sets from the current execution that are never written to after creation, keyed by a hash of their layout and contents so they can be rebound by draws with identical bindings
         std::vector<TextureView *> activeDescriptorSetSampledImages{};
+        bool pipelineSkipped{}; //!< If the last draw was skipped as its pipeline wasn't ready yet, the next draw must then fully rebind the pipeline and descriptors
+        Pipeline *fallbackPipeline{}; //!< The pipeline used for the last draw in place of the active pipeline as it wasn't ready yet, nullptr if the active pipeline was used
+        u32 shaderReplacementGeneration{}; //!< The shader replacement generation that the pipeline state was last flushed at
+
+        struct DrawParams;
+        struct IndirectDraw;
+
+        static constexpr u32 MaxBatchedDraws{256}; //!< The maximum amount of draws that are batched into a single subpass
+        DrawParams *drawBatch{}; //!< The last draw, consecutive draws which don't change any state are batched into it till another node is added, this is nullptr if the last draw can't be batched into
+        std::tuple<ContextTag, size_t, size_t> drawBatchPosition{}; //!< The position in the node stream after the subpass of `drawBatch` was added
+        vk::Rect2D drawBatchScissor{};
+        boost::container::static_vector<TextureView *, engine::ColorTargetCount> drawBatchColorAttachments;
+        TextureView *drawBatchDepthAttachment{};
 
         size_t UpdateQuadConversionBuffer(u32 count, u32 firstVertex);
 
         vk::Rect2D GetClearScissor();
 
+        /**
+         * @brief Allocates a descriptor set for the supplied update and records binding it, reusing a cached set with identical contents when possible
+         */
+        void BindDescriptorSet(StateUpdateBuilder &builder, DescriptorUpdateInfo *updateInfo);
+
+        /**
+         * @brief Appends a draw to `drawBatch` if nothing aside from the draw parameters differs from the draws in it
+         * @return If the draw was batched, it must not be recorded by the caller then
+         * @note The caller is responsible for ensuring that the draw doesn't update any state
+         */
+        bool TryBatchDraw(bool indexed, u32 count, u32 first, u32 instanceCount, u32 vertexOffset, u32 firstInstance, vk::Rect2D scissor, span<TextureView *> colorAttachments, TextureView *depthStencilAttachment);
+
       public:
         DirectPipelineState &directState;
 
@@ -86,6 +116,40 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         void Clear(engine::ClearSurface &clearSurface);
 
-        void Draw(engine::DrawTopology topology, bool transformFeedbackEnable, bool indexed, u32 count, u32 first, u32 instanceCount, u32 vertexOffset, u32 firstInstance);
+        /**
+         * @param inlineIndices Indices supplied inline in the pushbuffer which are drawn with in place of the bound index buffer, `indexed` must be set and `count` must match their amount if any are supplied
+         */
+        void Draw(engine::DrawTopology topology, bool transformFeedbackEnable, bool indexed, u32 count, u32 first, u32 instanceCount, u32 vertexOffset, u32 firstInstance, span<u32> inlineIndices = {}, const IndirectDraw *indirect = nullptr);
+
+        /**
+         * @brief Performs draws with parameters that are read by the GPU from a guest buffer that it has written to
+         * @param count The vertex or index count of the first draw as seen by the CPU, this is only used to estimate the size of the vertex and index buffers
+         * @return If the draws were performed, they aren't if the parameters aren't in a GPU dirty buffer or the host doesn't support the required indirect draw features
+         * @note See MacroEngineBase::DrawIndirect
+         */
+        bool DrawIndirect(engine::DrawTopology topology, bool transformFeedbackEnable, bool indexed, span<u8> indirectBuffer, u32 drawCount, u32 stride, span<u8> countBuffer, u32 count, u32 first);
+
+        /**
+         * @brief Records a write of the supplied data to guest memory on the GPU, ordered after all prior work in the execution
+         * @note The buffer containing the destination is marked as GPU dirty so the CPU will only wait on the GPU if the guest accesses it
+         * @return If the write was recorded on the GPU, if not the caller is responsible for performing it on the CPU after all prior work has completed
+         */
+        bool WriteSemaphore(soc::gm20b::IOVA address, span<u8> data);
+
+        /**
+         * @brief Resets the samples passed counter used for occlusion queries
+         */
+        void ResetSamplesPassed();
+
+        /**
+         * @brief Records writing a report of the samples passed since the counter was last reset on the GPU
+         * @return If the report was recorded on the GPU, if not the caller is responsible for writing it
+         */
+        bool ReportSamplesPassed(soc::gm20b::IOVA address, bool fourWords, u64 timestamp);
+
+        /**
+         * @brief Sets the condition under which subsequent draws and clears are performed
+         */
+        void SetRenderEnable(soc::gm20b::IOVA address, engine::RenderEnableMode mode);
     };
 }
@@ -479,6 +479,77 @@ namespace skyline::gpu::interconnect::maxwell3d {
     void PackedPipelineState::SetDepthClampEnable(engine::ViewportClipControl::GeometryClip clip) {
         depthClampEnable = (clip != engine::ViewportClipControl::GeometryClip::Passthru) && (clip != engine::ViewportClipControl::GeometryClip::FrustrumXYZClip) && (clip != engine::ViewportClipControl::GeometryClip::FrustrumZClip);
     }
+
+    vk::PrimitiveTopology PackedPipelineState::GetPrimitiveTopology() const {
+        switch (topology) {
+            case engine::DrawTopology::Points:
+                return vk::PrimitiveTopology::ePointList;
+            case engine::DrawTopology::Lines:
+                return vk::PrimitiveTopology::eLineList;
+            case engine::DrawTopology::LineStrip:
+                return vk::PrimitiveTopology::eLineStrip;
+            case engine::DrawTopology::Triangles:
+                return vk::PrimitiveTopology::eTriangleList;
+            case engine::DrawTopology::TriangleStrip:
+                return vk::PrimitiveTopology::eTriangleStrip;
+            case engine::DrawTopology::TriangleFan:
+                return vk::PrimitiveTopology::eTriangleFan;
+            case engine::DrawTopology::Quads:
+                return vk::PrimitiveTopology::eTriangleList; // Uses quad conversion
+            case engine::DrawTopology::LineListAdjcy:
+                return vk::PrimitiveTopology::eLineListWithAdjacency;
+            case engine::DrawTopology::LineStripAdjcy:
+                return vk::PrimitiveTopology::eLineStripWithAdjacency;
+            case engine::DrawTopology::TriangleListAdjcy:
+                return vk::PrimitiveTopology::eTriangleListWithAdjacency;
+            case engine::DrawTopology::TriangleStripAdjcy:
+                return vk::PrimitiveTopology::eTriangleStripWithAdjacency;
+            case engine::DrawTopology::Patch:
+                return vk::PrimitiveTopology::ePatchList;
+            default:
+                Logger::Warn("Unimplemented input assembly topology: {}", static_cast<u8>(topology));
+                return vk::PrimitiveTopology::eTriangleList;
+        }
+    }
+
+    void PackedPipelineState::ClearExtendedDynamicState() {
+        if (!dynamicStateActive)
+            return;
+
+        cullMode = {};
+        frontFaceClockwise = {};
+        depthTestEnable = {};
+        depthWriteEnable = {};
+        depthFunc = {};
+        depthBoundsTestEnable = {};
+        stencilTestEnable = {};
+        stencilFront = {};
+        stencilBack = {};
+
+        if (!dynamicState2Active)
+            return;
+
+        depthBiasEnable = {};
+        primitiveRestartEnabled = {};
+        rasterizerDiscardEnable = {};
+
+        // Lines and line strips are kept apart as they result in different geometry passthrough shader output topologies
+        switch (topology) {
+            case engine::DrawTopology::TriangleStrip:
+            case engine::DrawTopology::TriangleFan:
+            case engine::DrawTopology::Quads:
+                topology = engine::DrawTopology::Triangles;
+                break;
+            case engine::DrawTopology::LineStripAdjcy:
+                topology = engine::DrawTopology::LineListAdjcy;
+                break;
+            case engine::DrawTopology::TriangleStripAdjcy:
+                topology = engine::DrawTopology::TriangleListAdjcy;
+                break;
+            default:
+                break;
+        }
+    }
 }
 
 #pragma clang diagnostic pop
\ No newline at end of file
@@ -62,6 +62,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             bool depthClampEnable : 1; // Use SetDepthClampEnable
             bool dynamicStateActive : 1;
             bool viewportTransformEnable : 1;
+            bool dynamicState2Active : 1; //!< If VK_EXT_extended_dynamic_state2 state is set dynamically, only valid alongside dynamicStateActive
         };
 
         u32 patchSize;
@@ -166,27 +167,43 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         void SetDepthClampEnable(engine::ViewportClipControl::GeometryClip clip);
 
-        bool operator==(const PackedPipelineState &other) const {
-            // Only hash transform feedback state if it's enabled
-            if (other.transformFeedbackEnable && transformFeedbackEnable)
-                return std::memcmp(this, &other, sizeof(PackedPipelineState)) == 0;
+        vk::PrimitiveTopology GetPrimitiveTopology() const;
+
+        /**
+         * @brief Resets all state that is set dynamically at draw time to a fixed value so that pipelines only differing in it share a single key
+         * @note The topology is reduced to the first topology of its class as Vulkan requires the dynamic topology to be in the same class as the pipeline's
+         */
+        void ClearExtendedDynamicState();
+
+        /**
+         * @return The size of the prefix of the state that's significant for pipeline lookups, trailing state which is unused in the current configuration is excluded
+         * @note Transform feedback varyings are only significant if transform feedback is enabled and vertex strides are only significant if they aren't set dynamically
+         */
+        size_t GetKeySize() const {
+            if (transformFeedbackEnable)
+                return sizeof(PackedPipelineState);
             else if (dynamicStateActive)
-                return std::memcmp(this, &other, offsetof(PackedPipelineState, vertexStrides)) == 0;
+                return offsetof(PackedPipelineState, vertexStrides);
             else
-                return std::memcmp(this, &other, offsetof(PackedPipelineState, transformFeedbackVaryings)) == 0;
+                return offsetof(PackedPipelineState, transformFeedbackVaryings);
+        }
+
+        /**
+         * @brief Copies only the significant prefix of the supplied state, any trailing state is left as-is as it's ignored for comparisons and hashing
+         */
+        void CopyKey(const PackedPipelineState &other) {
+            std::memcpy(this, &other, other.GetKeySize());
+        }
+
+        bool operator==(const PackedPipelineState &other) const {
+            // The enable bits are within every prefix, so states that differ in which prefix is significant never compare equal
+            return std::memcmp(this, &other, GetKeySize()) == 0;
         }
     };
 
     struct PackedPipelineStateHash {
         size_t operator()(const PackedPipelineState &state) const noexcept {
-            // Only hash transform feedback state if it's enabled
-            if (state.transformFeedbackEnable)
-                return XXH64(&state, sizeof(PackedPipelineState), 0);
-            else if (state.dynamicStateActive)
-                return XXH64(&state, offsetof(PackedPipelineState, vertexStrides), 0);
-
-
-            return XXH64(&state, offsetof(PackedPipelineState, transformFeedbackVaryings), 0);
+            return XXH64(&state, state.GetKeySize(), 0);
         }
     };
 
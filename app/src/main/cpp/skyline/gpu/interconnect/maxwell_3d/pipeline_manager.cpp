@@ -2,6 +2,7 @@
 // Copyright © 2022 yuzu Team and Contributors (https://github.com/yuzu-emu/)
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <common/settings.h>
 #include <gpu/texture/texture.h>
 #include <gpu/interconnect/command_executor.h>
 #include <gpu/interconnect/common/pipeline.inc>
@@ -9,6 +10,7 @@
 #include <gpu/graphics_pipeline_assembler.h>
 #include <gpu/shader_manager.h>
 #include <gpu.h>
+#include <jvm.h>
 #include <vulkan/vulkan_enums.hpp>
 #include "graphics_pipeline_state_accessor.h"
 #include "pipeline_manager.h"
@@ -194,6 +196,24 @@ namespace skyline::gpu::interconnect::maxwell3d {
         return info;
     }
 
+    /**
+     * @return A key for the SPIR-V cache that identifies the program alongside all runtime info that affects the SPIR-V emitted for it
+     * @param lastProgramKey The key of the previous stage's program, this determines the previous stage's stores
+     */
+    static u64 MakeShaderCacheKey(const Shader::RuntimeInfo &info, u64 programKey, u64 lastProgramKey) {
+        u64 key{ShaderManager::HashCacheKey(programKey, lastProgramKey)};
+        key = ShaderManager::HashCacheKey(key, info.generic_input_types);
+        key = ShaderManager::HashCacheKey(key, std::array<u32, 8>{
+            info.convert_depth_mode, info.force_early_z, info.tess_clockwise, info.y_negate,
+            static_cast<u32>(info.tess_primitive), static_cast<u32>(info.tess_spacing), static_cast<u32>(info.input_topology),
+            info.alpha_test_func ? static_cast<u32>(*info.alpha_test_func) + 1 : 0,
+        });
+        key = ShaderManager::HashCacheKey(key, std::array<float, 3>{
+            info.fixed_state_point_size ? 1.0f : 0.0f, info.fixed_state_point_size.value_or(0.0f), info.alpha_test_reference,
+        });
+        return XXH3_64bits_withSeed(info.xfb_varyings.data(), info.xfb_varyings.size() * sizeof(Shader::TransformFeedbackVarying), key);
+    }
+
     static std::array<ShaderStage, engine::ShaderStageCount> MakePipelineShaders(GPU &gpu, const PipelineStateAccessor &accessor, const PackedPipelineState &packedState) {
         gpu.shader->ResetPools();
 
@@ -202,18 +222,29 @@ namespace skyline::gpu::interconnect::maxwell3d {
         auto stageIdx{[](PipelineStage stage) { return static_cast<u8>(stage); }};
 
         std::array<Shader::IR::Program, engine::PipelineCount> programs;
+        std::array<u64, engine::PipelineCount> programKeys{}; //!< Keys identifying the IR of every program, they're derived from all inputs to parsing including any state read during it
         Shader::IR::Program *layerConversionSourceProgram{};
+        u64 layerConversionSourceKey{};
         bool ignoreVertexCullBeforeFetch{};
 
         for (u32 i{}; i < engine::PipelineCount; i++) {
             if (!packedState.shaderHashes[i]) {
-                if (i == stageIdx(PipelineStage::Geometry) && layerConversionSourceProgram)
-                    programs[i] = gpu.shader->GenerateGeometryPassthroughShader(*layerConversionSourceProgram, ConvertShaderOutputTopology(packedState.topology));
+                if (i == stageIdx(PipelineStage::Geometry) && layerConversionSourceProgram) {
+                    auto topology{ConvertShaderOutputTopology(packedState.topology)};
+                    programs[i] = gpu.shader->GenerateGeometryPassthroughShader(*layerConversionSourceProgram, topology);
+                    programKeys[i] = ShaderManager::HashCacheKey(layerConversionSourceKey, topology);
+                }
 
                 continue;
             }
 
             auto binary{accessor.GetShaderBinary(i)};
+            u64 programKey{ShaderManager::HashCacheKey(packedState.shaderHashes[i], std::array<u32, 4>{
+                i, binary.baseOffset, packedState.bindlessTextureConstantBufferSlotSelect, packedState.viewportTransformEnable,
+            })};
+            programKey = ShaderManager::HashCacheKey(programKey, packedState.postVtgShaderAttributeSkipMask);
+
+            u64 replacementKey{};
             auto program{gpu.shader->ParseGraphicsShader(
                 packedState.postVtgShaderAttributeSkipMask,
                 ConvertCompilerShaderStage(static_cast<PipelineStage>(i)),
@@ -222,24 +253,36 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 packedState.viewportTransformEnable,
                 [&](u32 index, u32 offset) {
                     u32 shaderStage{i > 0 ? (i - 1) : 0};
-                    return accessor.GetConstantBufferValue(shaderStage, index, offset);
+                    u32 value{accessor.GetConstantBufferValue(shaderStage, index, offset)};
+                    programKey = ShaderManager::HashCacheKey(programKey, std::array<u32, 3>{index, offset, value});
+                    return value;
                 }, [&](u32 index) {
-                    return accessor.GetTextureType(BindlessHandle{ .raw = index }.textureIndex);
-                })};
+                    auto type{accessor.GetTextureType(BindlessHandle{ .raw = index }.textureIndex)};
+                    programKey = ShaderManager::HashCacheKey(programKey, std::array<u32, 2>{index, static_cast<u32>(type)});
+                    return type;
+                }, &replacementKey)};
+            if (replacementKey)
+                programKey = ShaderManager::HashCacheKey(programKey, replacementKey); // Replacements can be reloaded at runtime so the emitted SPIR-V must be keyed on their contents
+
             if (i == stageIdx(PipelineStage::Vertex) && packedState.shaderHashes[stageIdx(PipelineStage::VertexCullBeforeFetch)]) {
                 ignoreVertexCullBeforeFetch = true;
                 programs[i] = gpu.shader->CombineVertexShaders(programs[stageIdx(PipelineStage::VertexCullBeforeFetch)], program, binary.binary);
+                programKeys[i] = ShaderManager::HashCacheKey(programKeys[stageIdx(PipelineStage::VertexCullBeforeFetch)], programKey);
             } else {
                 programs[i] = program;
+                programKeys[i] = programKey;
             }
 
-            if (programs[i].info.requires_layer_emulation)
+            if (programs[i].info.requires_layer_emulation) {
                 layerConversionSourceProgram = &programs[i];
+                layerConversionSourceKey = programKeys[i];
+            }
         }
 
         bool hasGeometry{packedState.shaderHashes[stageIdx(PipelineStage::Geometry)] && !programs[stageIdx(PipelineStage::Geometry)].is_geometry_passthrough};
         Shader::Backend::Bindings bindings{};
         Shader::IR::Program *lastProgram{};
+        u64 lastProgramKey{};
 
         std::array<ShaderStage, engine::ShaderStageCount> shaderStages{};
 
@@ -249,10 +292,11 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
             auto runtimeInfo{MakeRuntimeInfo(packedState, programs[i], lastProgram, hasGeometry)};
             shaderStages[i - (i >= 1 ? 1 : 0)] = {ConvertVkShaderStage(pipelineStage(i)),
-                                                  gpu.shader->CompileShader(runtimeInfo, programs[i], bindings, packedState.shaderHashes[i]),
+                                                  gpu.shader->CompileShader(runtimeInfo, programs[i], bindings, MakeShaderCacheKey(runtimeInfo, programKeys[i], lastProgramKey)),
                                                   programs[i].info};
 
             lastProgram = &programs[i];
+            lastProgramKey = programKeys[i];
         }
 
         return shaderStages;
@@ -425,36 +469,47 @@ namespace skyline::gpu::interconnect::maxwell3d {
         #undef FORMAT_NORM_INT_SCALED_FLOAT_CASE
     }
 
-    static vk::PrimitiveTopology ConvertPrimitiveTopology(engine::DrawTopology topology) {
-        switch (topology) {
-            case engine::DrawTopology::Points:
-                return vk::PrimitiveTopology::ePointList;
-            case engine::DrawTopology::Lines:
-                return vk::PrimitiveTopology::eLineList;
-            case engine::DrawTopology::LineStrip:
-                return vk::PrimitiveTopology::eLineStrip;
-            case engine::DrawTopology::Triangles:
-                return vk::PrimitiveTopology::eTriangleList;
-            case engine::DrawTopology::TriangleStrip:
-                return vk::PrimitiveTopology::eTriangleStrip;
-            case engine::DrawTopology::TriangleFan:
-                return vk::PrimitiveTopology::eTriangleFan;
-            case engine::DrawTopology::Quads:
-                return vk::PrimitiveTopology::eTriangleList; // Uses quad conversion
-            case engine::DrawTopology::LineListAdjcy:
-                return vk::PrimitiveTopology::eLineListWithAdjacency;
-            case engine::DrawTopology::LineStripAdjcy:
-                return vk::PrimitiveTopology::eLineStripWithAdjacency;
-            case engine::DrawTopology::TriangleListAdjcy:
-                return vk::PrimitiveTopology::eTriangleListWithAdjacency;
-            case engine::DrawTopology::TriangleStripAdjcy:
-                return vk::PrimitiveTopology::eTriangleStripWithAdjacency;
-            case engine::DrawTopology::Patch:
-                return vk::PrimitiveTopology::ePatchList;
+    /**
+     * @return The supplied vertex format if the host supports it for vertex buffers, otherwise a format with an additional component which the host is more likely to support
+     * @note Three-component formats are commonly unsupported by mobile drivers, the four-component equivalent reads the same first three components and the additional one is ignored by shaders which only load three of them
+     */
+    static vk::Format GetSupportedVertexInputAttributeFormat(GPU &gpu, vk::Format format) {
+        if (gpu.vkPhysicalDevice.getFormatProperties(format).bufferFeatures & vk::FormatFeatureFlagBits::eVertexBuffer) [[likely]]
+            return format;
+
+        #define WIDEN_CASE(vkFormat, bits, vkType) \
+            case vk::Format::vkFormat ## vkType: \
+                fallback = vk::Format::vkFormat ## A ## bits ## vkType; \
+                break
+
+        #define WIDEN_NORM_INT_SCALED_CASE(vkFormat, bits) \
+            WIDEN_CASE(vkFormat, bits, Unorm); \
+            WIDEN_CASE(vkFormat, bits, Snorm); \
+            WIDEN_CASE(vkFormat, bits, Uscaled); \
+            WIDEN_CASE(vkFormat, bits, Sscaled); \
+            WIDEN_CASE(vkFormat, bits, Uint); \
+            WIDEN_CASE(vkFormat, bits, Sint)
+
+        vk::Format fallback{};
+        switch (format) {
+            WIDEN_NORM_INT_SCALED_CASE(eR8G8B8, 8);
+            WIDEN_NORM_INT_SCALED_CASE(eR16G16B16, 16);
+            WIDEN_CASE(eR16G16B16, 16, Sfloat);
+            WIDEN_CASE(eR32G32B32, 32, Uint);
+            WIDEN_CASE(eR32G32B32, 32, Sint);
+            WIDEN_CASE(eR32G32B32, 32, Sfloat);
+
             default:
-                Logger::Warn("Unimplemented input assembly topology: {}", static_cast<u8>(topology));
-                return vk::PrimitiveTopology::eTriangleList;
+                Logger::Warn("Vertex attribute format is unsupported by the host: {}", vk::to_string(format));
+                return format;
         }
+
+        #undef WIDEN_CASE
+        #undef WIDEN_NORM_INT_SCALED_CASE
+
+        if (!(gpu.vkPhysicalDevice.getFormatProperties(fallback).bufferFeatures & vk::FormatFeatureFlagBits::eVertexBuffer))
+            Logger::Warn("Neither vertex attribute format {} nor its fallback {} are supported by the host", vk::to_string(format), vk::to_string(fallback));
+        return fallback;
     }
 
     static vk::ProvokingVertexModeEXT ConvertProvokingVertex(engine::ProvokingVertex::Value provokingVertex) {
@@ -469,7 +524,8 @@ namespace skyline::gpu::interconnect::maxwell3d {
     static GraphicsPipelineAssembler::CompiledPipeline MakeCompiledPipeline(GPU &gpu,
                                                                                  const PackedPipelineState &packedState,
                                                                                  const std::array<ShaderStage, engine::ShaderStageCount> &shaderStages,
-                                                                                 span<vk::DescriptorSetLayoutBinding> layoutBindings) {
+                                                                                 span<vk::DescriptorSetLayoutBinding> layoutBindings,
+                                                                                 GraphicsPipelineAssembler::Priority priority) {
         boost::container::static_vector<vk::PipelineShaderStageCreateInfo, engine::ShaderStageCount> shaderStageInfos;
         for (const auto &stage : shaderStages)
             if (stage.module)
@@ -512,7 +568,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
                 attributeDescs.push_back({
                                              .location = i,
                                              .binding = attribute.stream,
-                                             .format = ConvertVertexInputAttributeFormat(attribute.componentBitWidths, attribute.numericalType),
+                                             .format = GetSupportedVertexInputAttributeFormat(gpu, ConvertVertexInputAttributeFormat(attribute.componentBitWidths, attribute.numericalType)),
                                              .offset = attribute.offset,
                                          });
         }
@@ -534,7 +590,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             vertexInputState.unlink<vk::PipelineVertexInputDivisorStateCreateInfoEXT>();
 
         vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState{
-            .topology = ConvertPrimitiveTopology(packedState.topology),
+            .topology = packedState.GetPrimitiveTopology(),
             .primitiveRestartEnable = packedState.primitiveRestartEnabled,
         };
 
@@ -590,10 +646,9 @@ namespace skyline::gpu::interconnect::maxwell3d {
         };
 
 
-        static constexpr u32 BaseDynamicStateCount{9};
-        static constexpr u32 ExtendedDynamicStateCount{BaseDynamicStateCount + 1};
+        static constexpr size_t MaxDynamicStateCount{22};
 
-        constexpr std::array<vk::DynamicState, ExtendedDynamicStateCount> dynamicStates{
+        boost::container::static_vector<vk::DynamicState, MaxDynamicStateCount> dynamicStates{
             vk::DynamicState::eViewport,
             vk::DynamicState::eScissor,
             vk::DynamicState::eLineWidth,
@@ -603,12 +658,31 @@ namespace skyline::gpu::interconnect::maxwell3d {
             vk::DynamicState::eStencilCompareMask,
             vk::DynamicState::eStencilWriteMask,
             vk::DynamicState::eStencilReference,
-            // VK_EXT_dynamic_state starts here
-            vk::DynamicState::eVertexInputBindingStrideEXT
         };
 
+        if (packedState.dynamicStateActive)
+            dynamicStates.insert(dynamicStates.end(), {
+                vk::DynamicState::eVertexInputBindingStrideEXT,
+                vk::DynamicState::eCullModeEXT,
+                vk::DynamicState::eFrontFaceEXT,
+                vk::DynamicState::eDepthTestEnableEXT,
+                vk::DynamicState::eDepthWriteEnableEXT,
+                vk::DynamicState::eDepthCompareOpEXT,
+                vk::DynamicState::eDepthBoundsTestEnableEXT,
+                vk::DynamicState::eStencilTestEnableEXT,
+                vk::DynamicState::eStencilOpEXT,
+            });
+
+        if (packedState.dynamicState2Active)
+            dynamicStates.insert(dynamicStates.end(), {
+                vk::DynamicState::ePrimitiveTopologyEXT,
+                vk::DynamicState::eDepthBiasEnableEXT,
+                vk::DynamicState::ePrimitiveRestartEnableEXT,
+                vk::DynamicState::eRasterizerDiscardEnableEXT,
+            });
+
         vk::PipelineDynamicStateCreateInfo dynamicState{
-            .dynamicStateCount = gpu.traits.supportsExtendedDynamicState ? ExtendedDynamicStateCount : BaseDynamicStateCount,
+            .dynamicStateCount = static_cast<u32>(dynamicStates.size()),
             .pDynamicStates = dynamicStates.data()
         };
 
@@ -623,7 +697,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
             .pScissors = emptyScissors.data(),
         };
 
+        // The depth RT is emulated with a different format on hosts that don't support the guest format, the pipeline must use the same format as the attachment views
         texture::Format depthStencilFormat{packedState.GetDepthRenderTargetFormat()};
+        if (depthStencilFormat)
+            depthStencilFormat = ConvertHostCompatibleFormat(depthStencilFormat, gpu.traits);
 
         return gpu.graphicsPipelineAssembler->AssemblePipelineAsync(GraphicsPipelineAssembler::PipelineState{
             .shaderStages = shaderStageInfos,
@@ -640,14 +717,13 @@ namespace skyline::gpu::interconnect::maxwell3d {
             .depthStencilFormat = depthStencilFormat ? depthStencilFormat->vkFormat : vk::Format::eUndefined,
             .sampleCount = vk::SampleCountFlagBits::e1, //TODO: fix after MSAA support
             .destroyShaderModules = true
-        }, layoutBindings);
+        }, layoutBindings, {}, false, priority);
     }
 
-    Pipeline::Pipeline(GPU &gpu, PipelineStateAccessor &accessor, const PackedPipelineState &packedState)
-        : sourcePackedState{packedState} {
+    void Pipeline::Build(GPU &gpu, PipelineStateAccessor &accessor, GraphicsPipelineAssembler::Priority priority) {
         auto shaderStages{MakePipelineShaders(gpu, accessor, sourcePackedState)};
         descriptorInfo = MakePipelineDescriptorInfo(shaderStages, gpu.traits.quirks.needsIndividualTextureBindingWrites);
-        compiledPipeline = MakeCompiledPipeline(gpu, sourcePackedState, shaderStages, descriptorInfo.descriptorSetLayoutBindings);
+        compiledPipeline = MakeCompiledPipeline(gpu, sourcePackedState, shaderStages, descriptorInfo.descriptorSetLayoutBindings, priority);
 
         for (u32 i{}; i < engine::ShaderStageCount; i++)
             if (shaderStages[i].stage != vk::ShaderStageFlagBits{})
@@ -657,6 +733,42 @@ namespace skyline::gpu::interconnect::maxwell3d {
         accessor.MarkComplete();
     }
 
+    Pipeline::Pipeline(GPU &gpu, PipelineStateAccessor &accessor, const PackedPipelineState &packedState)
+        : sourcePackedState{packedState}, ready{true} {
+        Build(gpu, accessor, GraphicsPipelineAssembler::Priority::Demand);
+    }
+
+    Pipeline::Pipeline(GPU &gpu, std::unique_ptr<PipelineStateAccessor> pAccessor, const PackedPipelineState &packedState, GraphicsPipelineAssembler::Priority priority)
+        : sourcePackedState{packedState} {
+        built = gpu.graphicsPipelineAssembler->QueueTask([this, &gpu, accessor = std::shared_ptr<PipelineStateAccessor>{std::move(pAccessor)}, priority] {
+            TRACE_EVENT("gpu", "Pipeline::Build");
+            try {
+                Build(gpu, *accessor, priority);
+                return true;
+            } catch (const std::exception &e) {
+                Logger::Error("Failed to create pipeline asynchronously, draws using it will be skipped: {}", e.what());
+                return false;
+            }
+        }, priority);
+    }
+
+    bool Pipeline::IsReady() {
+        if (!ready) [[unlikely]]
+            ready = built.wait_for(std::chrono::nanoseconds{}) == std::future_status::ready && built.get() && compiledPipeline.pipeline.wait_for(std::chrono::nanoseconds{}) == std::future_status::ready;
+
+        return ready;
+    }
+
+    void Pipeline::WaitReady() {
+        if (ready)
+            return;
+
+        if (built.get())
+            compiledPipeline.pipeline.wait();
+
+        IsReady();
+    }
+
     void Pipeline::SyncCachedStorageBufferViews(ContextTag executionTag) {
         if (lastExecutionTag != executionTag) {
             for (auto &view : storageBufferViews)
@@ -666,6 +778,33 @@ namespace skyline::gpu::interconnect::maxwell3d {
         }
     }
 
+    void Pipeline::CreateDescriptorUpdateTemplate(GPU &gpu, span<const vk::WriteDescriptorSet> writes, const u8 *data) {
+        std::vector<vk::DescriptorUpdateTemplateEntry> entries;
+        entries.reserve(writes.size());
+        for (const auto &write : writes) {
+            bool isImage{write.pImageInfo != nullptr};
+            auto info{isImage ? reinterpret_cast<const u8 *>(write.pImageInfo) : reinterpret_cast<const u8 *>(write.pBufferInfo)};
+            entries.push_back(vk::DescriptorUpdateTemplateEntry{
+                .dstBinding = write.dstBinding,
+                .dstArrayElement = write.dstArrayElement,
+                .descriptorCount = write.descriptorCount,
+                .descriptorType = write.descriptorType,
+                .offset = static_cast<size_t>(info - data),
+                .stride = isImage ? sizeof(vk::DescriptorImageInfo) : sizeof(vk::DescriptorBufferInfo),
+            });
+        }
+
+        descriptorUpdateTemplate = vk::raii::DescriptorUpdateTemplate{gpu.vkDevice, vk::DescriptorUpdateTemplateCreateInfo{
+            .descriptorUpdateEntryCount = static_cast<u32>(entries.size()),
+            .pDescriptorUpdateEntries = entries.data(),
+            .templateType = compiledPipeline.usesPushDescriptors ? vk::DescriptorUpdateTemplateType::ePushDescriptorsKHR : vk::DescriptorUpdateTemplateType::eDescriptorSet,
+            .descriptorSetLayout = *compiledPipeline.descriptorSetLayout,
+            .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
+            .pipelineLayout = *compiledPipeline.pipelineLayout,
+            .set = 0,
+        }};
+    }
+
     Pipeline *Pipeline::LookupNext(const PackedPipelineState &packedState) {
         if (packedState == sourcePackedState)
             return this;
@@ -718,11 +857,16 @@ namespace skyline::gpu::interconnect::maxwell3d {
         u32 writeIdx{};
         auto writes{ctx.executor.allocator->AllocateUntracked<vk::WriteDescriptorSet>(descriptorInfo.totalWriteDescCount)};
 
+        // All descriptor infos are packed into a single allocation so that they can be written with a descriptor update template
+        static_assert(alignof(vk::DescriptorBufferInfo) == alignof(vk::DescriptorImageInfo) && sizeof(vk::DescriptorBufferInfo) % alignof(vk::DescriptorImageInfo) == 0);
+        size_t bufferDescsSize{descriptorInfo.totalBufferDescCount * sizeof(vk::DescriptorBufferInfo)};
+        auto descPayload{ctx.executor.allocator->AllocateUntracked<u8>(bufferDescsSize + descriptorInfo.totalImageDescCount * sizeof(vk::DescriptorImageInfo))};
+
         u32 bufferIdx{};
-        auto bufferDescs{ctx.executor.allocator->AllocateUntracked<vk::DescriptorBufferInfo>(descriptorInfo.totalBufferDescCount)};
+        span<vk::DescriptorBufferInfo> bufferDescs{reinterpret_cast<vk::DescriptorBufferInfo *>(descPayload.data()), descriptorInfo.totalBufferDescCount};
         auto bufferDescDynamicBindings{ctx.executor.allocator->AllocateUntracked<DynamicBufferBinding>(descriptorInfo.totalBufferDescCount)};
         u32 imageIdx{};
-        auto imageDescs{ctx.executor.allocator->AllocateUntracked<vk::DescriptorImageInfo>(descriptorInfo.totalImageDescCount)};
+        span<vk::DescriptorImageInfo> imageDescs{reinterpret_cast<vk::DescriptorImageInfo *>(descPayload.data() + bufferDescsSize), descriptorInfo.totalImageDescCount};
 
         u32 storageBufferIdx{}; // Need to keep track of this to index into the cached view array
         u32 combinedImageSamplerIdx{}; // Need to keep track of this to index into the sampled image array
@@ -814,10 +958,16 @@ namespace skyline::gpu::interconnect::maxwell3d {
         if (!writeIdx)
             return nullptr;
 
+        // The writes of a full sync are always laid out identically for a pipeline, so a template created from the first sync applies to all later ones
+        if (!*descriptorUpdateTemplate)
+            CreateDescriptorUpdateTemplate(ctx.gpu, writes.first(writeIdx), descPayload.data());
+
         return ctx.executor.allocator->EmplaceUntracked<DescriptorUpdateInfo>(DescriptorUpdateInfo{
             .writes = writes.first(writeIdx),
             .bufferDescs = bufferDescs.first(bufferIdx),
             .bufferDescDynamicBindings = bufferDescDynamicBindings.first(bufferIdx),
+            .updateTemplate = *descriptorUpdateTemplate,
+            .updateTemplateData = descPayload.data(),
             .pipelineLayout = *compiledPipeline.pipelineLayout,
             .descriptorSetLayout = *compiledPipeline.descriptorSetLayout,
             .bindPoint = vk::PipelineBindPoint::eGraphics,
@@ -911,63 +1061,124 @@ namespace skyline::gpu::interconnect::maxwell3d {
         });
     }
 
-    PipelineManager::PipelineManager(GPU &gpu) {
+    PipelineManager::PipelineManager(GPU &gpu) : gpu{gpu}, asyncPipelineCreation{std::make_shared<std::atomic<bool>>(*gpu.state.settings->asyncPipelineCreation)} {
+        // The settings may outlive us, so the callback only holds a weak reference
+        gpu.state.settings->asyncPipelineCreation.AddCallback([weakAsyncPipelineCreation{std::weak_ptr{asyncPipelineCreation}}](bool value) {
+            if (auto sharedAsyncPipelineCreation{weakAsyncPipelineCreation.lock()})
+                sharedAsyncPipelineCreation->store(value, std::memory_order_relaxed);
+        });
+
         if (!gpu.graphicsPipelineCacheManager)
             return;
 
-        std::ifstream stream{gpu.graphicsPipelineCacheManager->OpenReadStream()};
-        i64 lastKnownGoodOffset{stream.tellg()};
-        try {
-            auto startTime{util::GetTimeNs()};
-            PipelineStateBundle bundle;
-
-            while (bundle.Deserialise(stream)) {
-                lastKnownGoodOffset = stream.tellg();
-                auto accessor{FilePipelineStateAccessor{bundle}};
-                auto *pipeline{map.emplace(bundle.GetKey<PackedPipelineState>(), std::make_unique<Pipeline>(gpu, accessor, bundle.GetKey<PackedPipelineState>())).first.value().get()};
-                #ifdef PIPELINE_STATS
-                auto sharedIt{sharedPipelines.find(pipeline->sourcePackedState.shaderHashes)};
-                if (sharedIt == sharedPipelines.end())
-                    sharedPipelines.emplace(pipeline->sourcePackedState.shaderHashes, std::list<Pipeline *>{pipeline});
-                else
-                    sharedIt->second.push_back(pipeline);
-                #else
-                (void)pipeline;
-                #endif
+        auto startTime{util::GetTimeNs()};
+        std::vector<std::shared_future<bool>> prewarmPipelines;
+
+        // Only the bundles are read on this thread, shader translation and pipeline compilation are fanned out across the assembler's thread pool
+        auto &cacheManager{*gpu.graphicsPipelineCacheManager};
+        u32 entryCount{cacheManager.GetEntryCount()};
+        for (u32 index{}; index < entryCount; index++) {
+            auto bundle{std::make_unique<PipelineStateBundle>()};
+            try {
+                if (!cacheManager.ReadEntry(index, *bundle))
+                    continue; // The entry was previously invalidated
+            } catch (const exception &e) {
+                Logger::Warn("Pipeline cache entry {} is corrupted, error: {}", index, e.what());
+                cacheManager.InvalidateEntry(index);
+                continue;
             }
 
-            gpu.graphicsPipelineAssembler->WaitIdle();
-            Logger::Info("Loaded {} graphics pipelines in {}ms", map.size(), (util::GetTimeNs() - startTime) / constant::NsInMillisecond);
-
-            gpu.graphicsPipelineAssembler->SavePipelineCache();
+            auto packedState{bundle->GetKey<PackedPipelineState>()};
+            // Pipelines recorded on a device with different dynamic state support could never be looked up with this device's keys
+            if (packedState.dynamicStateActive != gpu.traits.supportsExtendedDynamicState || packedState.dynamicState2Active != (gpu.traits.supportsExtendedDynamicState && gpu.traits.supportsExtendedDynamicState2))
+                continue;
 
+            auto *pipeline{map.emplace(packedState, std::make_unique<Pipeline>(gpu, std::make_unique<FilePipelineStateAccessor>(std::move(bundle)), packedState, GraphicsPipelineAssembler::Priority::Prewarm)).first.value().get()};
+            prewarmPipelines.push_back(pipeline->built);
+            shaderSetPipelines[packedState.shaderHashes].push_back(pipeline);
             #ifdef PIPELINE_STATS
-            for (auto &[key, list] : sharedPipelines) {
-                sortedSharedPipelines.push_back(&list);
-            }
-            std::sort(sortedSharedPipelines.begin(), sortedSharedPipelines.end(), [](const auto &a, const auto &b) {
-                return a->size() > b->size();
-            });
-
-            raise(SIGTRAP);
+            auto sharedIt{sharedPipelines.find(pipeline->sourcePackedState.shaderHashes)};
+            if (sharedIt == sharedPipelines.end())
+                sharedPipelines.emplace(pipeline->sourcePackedState.shaderHashes, std::list<Pipeline *>{pipeline});
+            else
+                sharedIt->second.push_back(pipeline);
+            #else
+            (void)pipeline;
             #endif
+        }
 
-        } catch (const exception &e) {
-            Logger::Warn("Pipeline cache corrupted at: 0x{:X}, error: {}", lastKnownGoodOffset, e.what());
-            gpu.graphicsPipelineCacheManager->InvalidateAllAfter(static_cast<u64>(lastKnownGoodOffset));
-            return;
+        #ifdef PIPELINE_STATS
+        for (auto &[key, list] : sharedPipelines) {
+            sortedSharedPipelines.push_back(&list);
         }
+        std::sort(sortedSharedPipelines.begin(), sortedSharedPipelines.end(), [](const auto &a, const auto &b) {
+            return a->size() > b->size();
+        });
+
+        raise(SIGTRAP);
+        #endif
+
+        if (prewarmPipelines.empty())
+            return;
+
+        // The guest is allowed to start before all pipelines have been built, any draws using a pipeline that's still being built will wait on it or be skipped
+        prewarmThread = std::thread([this, startTime, prewarmPipelines = std::move(prewarmPipelines)]() {
+            if (int result{pthread_setname_np(pthread_self(), "Sky-PipePrewarm")})
+                Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+            auto total{static_cast<jint>(prewarmPipelines.size())};
+            i64 lastReportTime{};
+            for (jint progress{}; progress < total; progress++) {
+                prewarmPipelines[static_cast<size_t>(progress)].wait();
+
+                if (i64 now{util::GetTimeNs()}; now - lastReportTime >= PrewarmProgressReportInterval) {
+                    gpu.state.jvm->UpdatePipelineCacheProgress(progress, total);
+                    lastReportTime = now;
+                }
+            }
+
+            gpu.graphicsPipelineAssembler->WaitIdle();
+            gpu.state.jvm->UpdatePipelineCacheProgress(total, total);
+            Logger::Info("Loaded {} graphics pipelines in {}ms", total, (util::GetTimeNs() - startTime) / constant::NsInMillisecond);
+
+            gpu.graphicsPipelineAssembler->SavePipelineCache();
+        });
+    }
+
+    PipelineManager::~PipelineManager() {
+        if (prewarmThread.joinable())
+            prewarmThread.join();
+
+        // Asynchronously created pipelines are referenced by tasks on the assembler's thread pool
+        gpu.graphicsPipelineAssembler->WaitIdle();
     }
 
     Pipeline *PipelineManager::FindOrCreate(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const std::array<ShaderBinary, engine::PipelineCount> &shaderBinaries) {
         auto it{map.find(packedState)};
-        if (it != map.end())
+        if (it != map.end()) {
+            hitCount.fetch_add(1, std::memory_order_relaxed);
+
+            // Pipelines from the pipeline cache may still be getting built, they're waited on unless draws can be skipped until they're ready
+            if (!asyncPipelineCreation->load(std::memory_order_relaxed))
+                it->second->WaitReady();
+
             return it->second.get();
+        }
 
+        missCount.fetch_add(1, std::memory_order_relaxed);
         auto bundle{std::make_unique<PipelineStateBundle>()};
         bundle->Reset(packedState);
-        auto accessor{RuntimeGraphicsPipelineStateAccessor{std::move(bundle), ctx, textures, constantBuffers, shaderBinaries}};
-        auto *pipeline{map.emplace(packedState, std::make_unique<Pipeline>(ctx.gpu, accessor, packedState)).first->second.get()};
+
+        Pipeline *pipeline;
+        if (asyncPipelineCreation->load(std::memory_order_relaxed)) {
+            auto accessor{std::make_unique<SnapshotGraphicsPipelineStateAccessor>(std::move(bundle), ctx, textures, constantBuffers, shaderBinaries)};
+            pipeline = map.emplace(packedState, std::make_unique<Pipeline>(ctx.gpu, std::move(accessor), packedState, GraphicsPipelineAssembler::Priority::Normal)).first->second.get();
+        } else {
+            auto accessor{RuntimeGraphicsPipelineStateAccessor{std::move(bundle), ctx, textures, constantBuffers, shaderBinaries}};
+            pipeline = map.emplace(packedState, std::make_unique<Pipeline>(ctx.gpu, accessor, packedState)).first->second.get();
+        }
+
+        shaderSetPipelines[packedState.shaderHashes].push_back(pipeline);
 
         #ifdef PIPELINE_STATS
         auto sharedIt{sharedPipelines.find(pipeline->sourcePackedState.shaderHashes)};
@@ -979,5 +1190,77 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         return pipeline;
     }
-}
 
+    /**
+     * @return If a pipeline with the state in `fallback` can be used for draws expecting a pipeline with the state in `state`
+     * @note The attachments must match for render pass compatibility and the topology class must match as the topology may be set dynamically
+     */
+    static bool IsFallbackCompatible(const PackedPipelineState &state, const PackedPipelineState &fallback) {
+        if (state.topology != fallback.topology || state.transformFeedbackEnable != fallback.transformFeedbackEnable || state.GetDepthRenderTargetFormat() != fallback.GetDepthRenderTargetFormat())
+            return false;
+
+        size_t colorRenderTargetCount{state.GetColorRenderTargetCount()};
+        if (colorRenderTargetCount != fallback.GetColorRenderTargetCount())
+            return false;
+
+        for (size_t i{}; i < colorRenderTargetCount; i++)
+            if (state.GetColorRenderTargetFormat(state.ctSelect[i]) != fallback.GetColorRenderTargetFormat(fallback.ctSelect[i]))
+                return false;
+
+        return true;
+    }
+
+    Pipeline *PipelineManager::FindFallback(Pipeline *pipeline) {
+        auto it{shaderSetPipelines.find(pipeline->sourcePackedState.shaderHashes)};
+        if (it == shaderSetPipelines.end())
+            return nullptr;
+
+        for (auto *candidate : it->second)
+            if (candidate != pipeline && IsFallbackCompatible(pipeline->sourcePackedState, candidate->sourcePackedState) && candidate->IsReady())
+                return candidate;
+
+        return nullptr;
+    }
+
+    void PipelineManager::RetireReloadedPipelines() {
+        u32 generation{gpu.shader->GetReplacementGeneration()};
+        if (generation == replacementGeneration)
+            return;
+
+        auto reloadedHashes{gpu.shader->GetReloadedReplacements(replacementGeneration)};
+        replacementGeneration = generation;
+
+        auto usesReloadedShader{[&](const std::array<u64, engine::PipelineCount> &shaderHashes) {
+            return ranges::any_of(shaderHashes, [&](u64 hash) {
+                return hash && ranges::find(reloadedHashes, hash) != reloadedHashes.end();
+            });
+        }};
+
+        size_t previousRetiredCount{retiredPipelines.size()};
+        for (auto it{map.begin()}; it != map.end();) {
+            if (usesReloadedShader(it->second->sourcePackedState.shaderHashes)) {
+                retiredPipelines.push_back(std::move(it.value()));
+                it = map.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        std::erase_if(shaderSetPipelines, [&](const auto &entry) {
+            return usesReloadedShader(entry.first);
+        });
+
+        // Transitions and binding matches may reference retired pipelines, these caches are rebuilt as pipelines are looked up again
+        auto clearCaches{[](Pipeline &pipeline) {
+            pipeline.transitionCache = {};
+            pipeline.transitionCacheNextIdx = 0;
+            pipeline.bindingMatchCache.clear();
+        }};
+        for (auto &[state, pipeline] : map)
+            clearCaches(*pipeline);
+        for (auto &pipeline : retiredPipelines)
+            clearCaches(*pipeline);
+
+        Logger::Info("Retired {} pipelines using reloaded shader replacements", retiredPipelines.size() - previousRetiredCount);
+    }
+}
@@ -223,13 +223,49 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
         tsl::robin_map<Pipeline *, bool> bindingMatchCache; //!< Cache of which pipelines have bindings that match this pipeline
 
+        vk::raii::DescriptorUpdateTemplate descriptorUpdateTemplate{nullptr}; //!< A template for the full descriptor update performed by SyncDescriptors, this is created on the first sync as the layout of the writes is only known then
+
+        std::shared_future<bool> built; //!< (Async) Signalled once the shaders of the pipeline have been translated and all state other than the Vulkan pipeline itself is valid, holds false if building the pipeline failed
+        bool ready{}; //!< If the pipeline can be used for draws, this caches the result of IsReady() once it's true
+
+        friend class PipelineManager;
+
+        /**
+         * @brief Translates all shaders of the pipeline and queues the compilation of the Vulkan pipeline
+         */
+        void Build(GPU &gpu, PipelineStateAccessor &accessor, GraphicsPipelineAssembler::Priority priority);
+
         void SyncCachedStorageBufferViews(ContextTag executionTag);
 
+        /**
+         * @brief Creates a descriptor update template matching the supplied writes, the offsets of the template entries are those of the descriptor infos relative to `data`
+         */
+        void CreateDescriptorUpdateTemplate(GPU &gpu, span<const vk::WriteDescriptorSet> writes, const u8 *data);
+
       public:
         GraphicsPipelineAssembler::CompiledPipeline compiledPipeline;
 
         Pipeline(GPU &gpu, PipelineStateAccessor &accessor, const PackedPipelineState &packedState);
 
+        /**
+         * @brief Creates a pipeline asynchronously, shader translation and pipeline compilation both occur on the pipeline assembler's thread pool
+         * @param accessor An accessor which can be used from any thread
+         * @param priority The priority of translating the shaders and compiling the pipeline relative to other work on the thread pool
+         * @note Only IsReady(), LookupNext() and AddTransition() may be used until IsReady() returns true
+         */
+        Pipeline(GPU &gpu, std::unique_ptr<PipelineStateAccessor> accessor, const PackedPipelineState &packedState, GraphicsPipelineAssembler::Priority priority);
+
+        /**
+         * @return If the pipeline has finished compiling and can be used for draws, this is always true for pipelines that weren't created asynchronously
+         */
+        bool IsReady();
+
+        /**
+         * @brief Blocks until an asynchronously created pipeline has finished building
+         * @note IsReady() will still return false after this if building the pipeline failed
+         */
+        void WaitReady();
+
         /**
          * @brief Returns the pipeline in the transition cache (if present) that matches the given state
          */
@@ -262,16 +298,47 @@ namespace skyline::gpu::interconnect::maxwell3d {
      */
     class PipelineManager {
       private:
+        GPU &gpu;
+        std::shared_ptr<std::atomic<bool>> asyncPipelineCreation; //!< If pipelines created at runtime should be translated and compiled asynchronously, draws with pipelines that aren't ready yet will be skipped, this is shared with a settings callback as it may change at runtime
         tsl::robin_map<PackedPipelineState, std::unique_ptr<Pipeline>, PackedPipelineStateHash> map;
+        std::unordered_map<std::array<u64, engine::PipelineCount>, std::vector<Pipeline *>, util::ObjectHash<std::array<u64, engine::PipelineCount>>> shaderSetPipelines; //!< Maps a shader set to all pipelines using it, these are the candidates for fallback pipelines
 
         #ifdef PIPELINE_STATS
         std::unordered_map<std::array<u64, engine::PipelineCount>, std::list<Pipeline*>, util::ObjectHash<std::array<u64, engine::PipelineCount>>> sharedPipelines; //!< Maps a shader set to all pipelines sharing that same set
         std::vector<std::list<Pipeline*>*> sortedSharedPipelines; //!< Sorted list of shared pipelines
         #endif
 
+        static constexpr i64 PrewarmProgressReportInterval{constant::NsInSecond / 10}; //!< The minimum interval between reports of the pipeline cache prewarming progress to the frontend
+        std::thread prewarmThread; //!< A thread which waits on the pipelines loaded from the pipeline cache to be built, reporting progress to the frontend and saving the Vulkan pipeline cache once done
+        std::vector<std::unique_ptr<Pipeline>> retiredPipelines; //!< Pipelines using shader replacements which were reloaded, they're kept alive as they may still be referenced by recorded draws or in-flight builds
+        u32 replacementGeneration{}; //!< The shader replacement generation that pipelines were last retired at
+        std::atomic<u64> hitCount{}; //!< The amount of lookups which found an existing pipeline
+        std::atomic<u64> missCount{}; //!< The amount of lookups which required a new pipeline to be created
+
       public:
         PipelineManager(GPU &gpu);
 
+        /**
+         * @return The amount of lookups since creation which hit and missed the pipeline cache respectively
+         */
+        std::pair<u64, u64> GetLookupCounts() const {
+            return {hitCount.load(std::memory_order_relaxed), missCount.load(std::memory_order_relaxed)};
+        }
+
+        ~PipelineManager();
+
         Pipeline *FindOrCreate(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, const PackedPipelineState &packedState, const std::array<ShaderBinary, engine::PipelineCount> &shaderBinaries);
+
+        /**
+         * @brief Finds a ready pipeline that can be drawn with in place of a pipeline that is still being compiled, this results in approximate rendering rather than a skipped draw
+         * @return A pipeline with the same shaders, attachment formats and topology class as the supplied pipeline but differing in other fixed-function state, or nullptr if there's none that's ready
+         */
+        Pipeline *FindFallback(Pipeline *pipeline);
+
+        /**
+         * @brief Retires all pipelines using shaders with replacements that were reloaded since the last call, they'll be recreated from the reloaded replacements on their next lookup
+         * @note The pipeline state of all engines must be marked dirty after this as retired pipelines are no longer returned by lookups
+         */
+        void RetireReloadedPipelines();
     };
 }
@@ -77,7 +77,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             if (guest.tileConfig.mode == gpu::texture::TileMode::Block)
                 DetermineRenderTargetDimensions(guest, engine->surfaceClip);
 
-            view = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag);
+            view = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag, true);
         } else {
             format = engine::ColorTarget::Format::Disabled;
             packedState.SetColorRenderTargetFormat(index, engine::ColorTarget::Format::Disabled);
@@ -130,7 +130,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
             if (guest.tileConfig.mode == gpu::texture::TileMode::Block)
                 DetermineRenderTargetDimensions(guest, engine->surfaceClip);
 
-            view = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag);
+            view = ctx.gpu.texture.FindOrCreate(guest, ctx.executor.tag, true);
         } else {
             packedState.SetDepthRenderTargetFormat(engine->ztFormat, false);
             view = {};
@@ -325,11 +325,21 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
     TransformFeedbackState::TransformFeedbackState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine) : engine{manager, dirtyHandle, engine} {}
 
-    void TransformFeedbackState::Flush(PackedPipelineState &packedState) {
-        packedState.transformFeedbackEnable = engine->streamOutputEnable;
+    void TransformFeedbackState::Flush(InterconnectContext &ctx, PackedPipelineState &packedState) {
+        bool enable{engine->streamOutputEnable != 0};
+        if (enable && !ctx.gpu.traits.supportsTransformFeedback) {
+            static bool warned{};
+            if (!warned) {
+                Logger::Warn("Transform feedback is used by the guest but isn't supported by the host, its output will be discarded");
+                warned = true;
+            }
+            enable = false;
+        }
+
+        packedState.transformFeedbackEnable = enable;
         packedState.transformFeedbackVaryings = {};
 
-        if (engine->streamOutputEnable)
+        if (enable)
             for (size_t i{}; i < engine::StreamOutBufferCount; i++)
                 packedState.SetTransformFeedbackVaryings(engine->streamOutControls[i], engine->streamOutLayoutSelect[i], i);
     }
@@ -383,6 +393,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
     void PipelineState::Flush(InterconnectContext &ctx, Textures &textures, ConstantBufferSet &constantBuffers, StateUpdateBuilder &builder) {
         packedState.dynamicStateActive = ctx.gpu.traits.supportsExtendedDynamicState;
+        packedState.dynamicState2Active = ctx.gpu.traits.supportsExtendedDynamicState && ctx.gpu.traits.supportsExtendedDynamicState2;
         packedState.ctSelect = ctSelect;
 
         std::array<ShaderBinary, engine::PipelineCount> shaderBinaries;
@@ -418,17 +429,39 @@ namespace skyline::gpu::interconnect::maxwell3d {
         rasterization.Update(packedState);
         depthStencil.Update(packedState);
         colorBlend.Update(packedState);
-        transformFeedback.Update(packedState);
+        transformFeedback.Update(ctx, packedState);
         globalShaderConfig.Update(packedState);
 
+        pipelineKey.CopyKey(packedState); // The transform feedback varyings make up most of the state, they aren't copied unless they're used
+        if (packedState.dynamicStateActive) {
+            auto stencilOps{packedState.GetStencilOpsState()};
+            builder.SetExtendedDynamicState({
+                .cullMode = vk::CullModeFlags{packedState.cullMode},
+                .frontFace = packedState.frontFaceClockwise ? vk::FrontFace::eClockwise : vk::FrontFace::eCounterClockwise,
+                .depthTestEnable = packedState.depthTestEnable,
+                .depthWriteEnable = packedState.depthWriteEnable,
+                .depthCompareOp = packedState.GetDepthFunc(),
+                .depthBoundsTestEnable = packedState.depthBoundsTestEnable,
+                .stencilTestEnable = packedState.stencilTestEnable,
+                .stencilOps = stencilOps,
+                .dynamicState2 = packedState.dynamicState2Active,
+                .primitiveTopology = packedState.GetPrimitiveTopology(),
+                .depthBiasEnable = packedState.depthBiasEnable,
+                .primitiveRestartEnable = packedState.primitiveRestartEnabled,
+                .rasterizerDiscardEnable = packedState.rasterizerDiscardEnable,
+            });
+
+            pipelineKey.ClearExtendedDynamicState();
+        }
+
         if (pipeline) {
-            if (auto newPipeline{pipeline->LookupNext(packedState)}) {
+            if (auto newPipeline{pipeline->LookupNext(pipelineKey)}) {
                 pipeline = newPipeline;
                 return;
             }
         }
 
-        auto newPipeline{ctx.gpu.graphicsPipelineManager->FindOrCreate(ctx, textures, constantBuffers, packedState, shaderBinaries)};
+        auto newPipeline{ctx.gpu.graphicsPipelineManager->FindOrCreate(ctx, textures, constantBuffers, pipelineKey, shaderBinaries)};
         if (pipeline)
             pipeline->AddTransition(newPipeline);
         pipeline = newPipeline;
@@ -255,7 +255,10 @@ namespace skyline::gpu::interconnect::maxwell3d {
       public:
         TransformFeedbackState(dirty::Handle dirtyHandle, DirtyManager &manager, const EngineRegisters &engine);
 
-        void Flush(PackedPipelineState &packedState);
+        /**
+         * @note Transform feedback is treated as disabled on hosts without VK_EXT_transform_feedback, so no XFB decorations are emitted into shaders that the host can't consume
+         */
+        void Flush(InterconnectContext &ctx, PackedPipelineState &packedState);
     };
 
     class GlobalShaderConfigState {
@@ -302,6 +305,7 @@ namespace skyline::gpu::interconnect::maxwell3d {
 
       private:
         PackedPipelineState packedState{};
+        PackedPipelineState pipelineKey{}; //!< A copy of packedState with all dynamically set state cleared, used for pipeline lookups
 
         dirty::BoundSubresource<EngineRegisters> engine;
 
@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <gpu/interconnect/command_executor.h>
+#include <gpu/shaders/helper_shaders.h>
+#include <soc/gm20b/channel.h>
+#include <gpu.h>
+#include "queries.h"
+
+namespace skyline::gpu::interconnect::maxwell3d {
+    /**
+     * @brief Looks up the buffer backing a word-aligned guest region that's contained in a single mapping and attaches it to the current execution
+     * @return A view of the region or an empty view if it can't be used on the GPU
+     */
+    static BufferView FindQueryBuffer(InterconnectContext &ctx, soc::gm20b::IOVA address, size_t size) {
+        auto mappings{ctx.channelCtx.asCtx->gmmu.TranslateRange(address, size)};
+        if (mappings.size() != 1 || !mappings.front().valid() || mappings.front().size() != size)
+            return {};
+
+        auto mapping{mappings.front()};
+        if (!util::IsAligned(reinterpret_cast<uintptr_t>(mapping.data()), sizeof(u32)))
+            return {};
+
+        auto view{ctx.gpu.buffer.FindOrCreate(mapping, ctx.executor.tag, [&ctx](std::shared_ptr<Buffer> buffer, ContextLock<Buffer> &&lock) {
+            ctx.executor.AttachLockedBuffer(buffer, std::move(lock));
+        })};
+        ContextLock viewLock{ctx.executor.tag, view};
+        ctx.executor.AttachLockedBufferView(view, std::move(viewLock));
+        view.GetBuffer()->BlockSequencedCpuBackingWrites();
+        return view;
+    }
+
+    /**
+     * @brief Creates an aligned storage buffer descriptor for a binding, any misalignment is returned in the padding and must be applied to the offset of the data by the shader
+     */
+    static vk::DescriptorBufferInfo GetStorageDescriptor(GPU &gpu, const BufferBinding &binding, vk::DeviceSize &padding) {
+        padding = binding.offset & (gpu.traits.minimumStorageBufferAlignment - 1);
+        return vk::DescriptorBufferInfo{
+            .buffer = binding.buffer,
+            .offset = binding.offset - padding,
+            .range = binding.size + padding,
+        };
+    }
+
+    Queries::Queries(const EngineRegisters &engine) : engine{engine} {}
+
+    std::pair<vk::QueryPool, u32> Queries::AllocateQuery(InterconnectContext &ctx) {
+        if (!pool || poolExecutionTag != ctx.executor.executionTag || poolUsedCount == QueryPoolSize) {
+            pool = std::make_shared<vk::raii::QueryPool>(ctx.gpu.vkDevice, vk::QueryPoolCreateInfo{
+                .queryType = vk::QueryType::eOcclusion,
+                .queryCount = QueryPoolSize,
+            });
+            poolExecutionTag = ctx.executor.executionTag;
+            poolUsedCount = 0;
+            ctx.executor.AttachDependency(pool);
+
+            // Queries must be reset prior to their first use which can only be done outside of a render pass, batching this for the whole pool avoids splitting render passes for every draw
+            ctx.executor.AddOutsideRpCommand([vkPool = **pool](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+                commandBuffer.resetQueryPool(vkPool, 0, QueryPoolSize);
+            });
+        }
+
+        u32 index{poolUsedCount++};
+        if (!counterRanges.empty() && counterRanges.back().pool == pool && counterRanges.back().first + counterRanges.back().count == index)
+            counterRanges.back().count++;
+        else
+            counterRanges.push_back({pool, index, 1});
+
+        if (++counterQueryCount > MaxCounterQueryCount) {
+            auto &oldest{counterRanges.front()};
+            oldest.first++;
+            if (--oldest.count == 0)
+                counterRanges.pop_front();
+            counterQueryCount--;
+        }
+
+        return {**pool, index};
+    }
+
+    void Queries::EvaluatePredicate(InterconnectContext &ctx) {
+        predicate = {};
+        predicateExecutionTag = ctx.executor.executionTag;
+
+        // Without conditional rendering support draws are unconditional which matches the behaviour prior to render enable emulation
+        if (!ctx.gpu.traits.supportsConditionalRendering)
+            return;
+
+        auto view{FindQueryBuffer(ctx, renderEnableAddress, RenderEnableConditionSize)};
+        if (!view)
+            return;
+
+        // Conditional rendering requires a word-aligned predicate offset
+        auto allocation{ctx.gpu.megaBufferAllocator.Allocate(ctx.executor.cycle, sizeof(u32) * 2)};
+        vk::DeviceSize offset{util::AlignUp(allocation.offset, sizeof(u32))};
+        predicate = BufferBinding{allocation.buffer, offset, sizeof(u32)};
+
+        ctx.executor.AddOutsideRpCommand([view, predicate = predicate, mode = renderEnableMode](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eComputeShader, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eShaderRead
+            }, {}, {});
+
+            vk::DeviceSize sourcePadding, destinationPadding;
+            auto source{GetStorageDescriptor(gpu, view.GetBinding(gpu), sourcePadding)};
+            auto destination{GetStorageDescriptor(gpu, predicate, destinationPadding)};
+
+            cycle->AttachObject(gpu.helperShaders.queryResolveShader.Resolve(gpu, commandBuffer, source, destination, sourcePadding, destinationPadding,
+                                                                             QueryResolveShader::Operation::Predicate, static_cast<u32>(mode)));
+        });
+    }
+
+    void Queries::ResetCounter() {
+        counterRanges.clear();
+        counterQueryCount = 0;
+    }
+
+    bool Queries::Report(InterconnectContext &ctx, soc::gm20b::IOVA address, bool fourWords, u64 timestamp) {
+        auto view{FindQueryBuffer(ctx, address, fourWords ? sizeof(u64) * 2 : sizeof(u32))};
+        if (!view)
+            return false;
+
+        view.GetBuffer()->MarkGpuDirty();
+
+        /**
+         * @brief A range of queries to copy the results of, this is linearly allocated as the pools are kept alive by being attached to the execution
+         */
+        struct CopyRange {
+            vk::QueryPool pool;
+            u32 first;
+            u32 count;
+        };
+        auto copyRanges{ctx.executor.allocator->AllocateUntracked<CopyRange>(counterRanges.size())};
+        for (size_t i{}; i < counterRanges.size(); i++) {
+            const auto &range{counterRanges[i]};
+            if (range.pool != pool)
+                ctx.executor.AttachDependency(range.pool);
+            copyRanges[i] = {**range.pool, range.first, range.count};
+        }
+
+        // The results are copied contiguously into the megabuffer as 64-bit values, which must be aligned to their size
+        auto allocation{ctx.gpu.megaBufferAllocator.Allocate(ctx.executor.cycle, std::max<size_t>(counterQueryCount, 1) * sizeof(u64) + sizeof(u64) - 1)};
+        BufferBinding results{allocation.buffer, util::AlignUp(allocation.offset, sizeof(u64)), std::max<size_t>(counterQueryCount, 1) * sizeof(u64)};
+
+        ctx.executor.AddOutsideRpCommand([view, copyRanges, results, resultCount = static_cast<u32>(counterQueryCount), fourWords, timestamp](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferWrite | vk::AccessFlagBits::eShaderWrite
+            }, {}, {});
+
+            // The copies wait for the queries to become available on the GPU, the CPU is never involved
+            vk::DeviceSize resultOffset{results.offset};
+            for (const auto &range : copyRanges) {
+                commandBuffer.copyQueryPoolResults(range.pool, range.first, range.count, results.buffer, resultOffset, sizeof(u64), vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+                resultOffset += range.count * sizeof(u64);
+            }
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eShaderRead
+            }, {}, {});
+
+            vk::DeviceSize sourcePadding, destinationPadding;
+            auto source{GetStorageDescriptor(gpu, results, sourcePadding)};
+            auto destination{GetStorageDescriptor(gpu, view.GetBinding(gpu), destinationPadding)};
+
+            cycle->AttachObject(gpu.helperShaders.queryResolveShader.Resolve(gpu, commandBuffer, source, destination, sourcePadding, destinationPadding,
+                                                                             fourWords ? QueryResolveShader::Operation::ReportFourWords : QueryResolveShader::Operation::ReportOneWord,
+                                                                             resultCount, timestamp));
+        });
+
+        return true;
+    }
+
+    void Queries::SetRenderEnable(InterconnectContext &ctx, soc::gm20b::IOVA address, engine::RenderEnableMode mode) {
+        renderEnableAddress = address;
+        renderEnableMode = mode;
+
+        if (mode == engine::RenderEnableMode::True || mode == engine::RenderEnableMode::False) {
+            predicate = {};
+            return;
+        }
+
+        // The condition is evaluated at the point it's set as the reports it depends on are typically written directly beforehand
+        EvaluatePredicate(ctx);
+    }
+
+    Queries::DrawState Queries::GetDrawState(InterconnectContext &ctx) {
+        DrawState state{};
+        if (engine.sampleCounterEnable)
+            std::tie(state.queryPool, state.queryIndex) = AllocateQuery(ctx);
+
+        if (renderEnableMode != engine::RenderEnableMode::True && renderEnableMode != engine::RenderEnableMode::False) {
+            if (predicateExecutionTag != ctx.executor.executionTag)
+                EvaluatePredicate(ctx);
+
+            state.predicateBuffer = predicate.buffer;
+            state.predicateOffset = predicate.offset;
+        }
+
+        return state;
+    }
+}
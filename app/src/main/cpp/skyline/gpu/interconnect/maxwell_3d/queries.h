@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <soc/gm20b/gmmu.h>
+#include <gpu/buffer.h>
+#include "common.h"
+
+namespace skyline::gpu::interconnect::maxwell3d {
+    /**
+     * @brief Emulates Maxwell occlusion queries and render enable conditions using Vulkan occlusion queries and conditional rendering
+     * @note All results are resolved on the GPU, the CPU only waits on them if the guest reads a report back
+     */
+    class Queries {
+      public:
+        struct EngineRegisters {
+            const u32 &sampleCounterEnable;
+        };
+
+        /**
+         * @brief The query and conditional rendering state that a single draw should be recorded with
+         */
+        struct DrawState {
+            vk::QueryPool queryPool; //!< The pool containing the occlusion query for the draw, this is null if samples aren't being counted
+            u32 queryIndex;
+            vk::Buffer predicateBuffer; //!< The buffer containing the conditional rendering predicate for the draw, this is null if the draw is unconditional
+            vk::DeviceSize predicateOffset;
+        };
+
+      private:
+        static constexpr u32 QueryPoolSize{0x400}; //!< The amount of queries in a single pool, pools are never shared between executions
+        static constexpr size_t MaxCounterQueryCount{0x2000}; //!< The maximum amount of queries that are accumulated into a report, the oldest are dropped beyond this if the guest never resets the counter
+        static constexpr size_t RenderEnableConditionSize{0x18}; //!< The size of the region read for render enable conditions, this covers the payloads of both reports
+
+        /**
+         * @brief A contiguous range of queries in a pool that all count towards the samples passed counter
+         */
+        struct QueryRange {
+            std::shared_ptr<vk::raii::QueryPool> pool;
+            u32 first;
+            u32 count;
+        };
+
+        EngineRegisters engine;
+
+        std::shared_ptr<vk::raii::QueryPool> pool; //!< The pool draw queries are allocated from, this is only valid for the execution it was created in
+        ContextTag poolExecutionTag{};
+        u32 poolUsedCount{}; //!< The amount of queries allocated from the current pool
+        std::deque<QueryRange> counterRanges; //!< The queries of all draws since the samples passed counter was last reset
+        size_t counterQueryCount{}; //!< The total amount of queries in `counterRanges`
+
+        soc::gm20b::IOVA renderEnableAddress{0};
+        engine::RenderEnableMode renderEnableMode{engine::RenderEnableMode::True};
+        BufferBinding predicate{}; //!< The megabuffer allocation containing the predicate for the current render enable condition, if it couldn't be evaluated on the GPU then this is empty and draws are unconditional
+        ContextTag predicateExecutionTag{}; //!< The execution that the predicate was evaluated in, it must be reevaluated in any other execution as the megabuffer allocation is only valid for a single one
+
+        /**
+         * @brief Allocates a query for a draw from the current pool, creating and resetting a new pool if necessary
+         */
+        std::pair<vk::QueryPool, u32> AllocateQuery(InterconnectContext &ctx);
+
+        /**
+         * @brief Records evaluating the current render enable condition into a predicate on the GPU
+         */
+        void EvaluatePredicate(InterconnectContext &ctx);
+
+      public:
+        Queries(const EngineRegisters &engine);
+
+        /**
+         * @brief Resets the samples passed counter to zero, subsequent reports will only include draws after this point
+         */
+        void ResetCounter();
+
+        /**
+         * @brief Records writing a report of the samples passed counter to guest memory on the GPU
+         * @return If the report was recorded, if not the caller is responsible for writing it
+         */
+        bool Report(InterconnectContext &ctx, soc::gm20b::IOVA address, bool fourWords, u64 timestamp);
+
+        /**
+         * @brief Sets the condition under which draws are performed, conditional modes are evaluated on the GPU
+         */
+        void SetRenderEnable(InterconnectContext &ctx, soc::gm20b::IOVA address, engine::RenderEnableMode mode);
+
+        /**
+         * @return If rendering is unconditionally disabled, draws should be skipped entirely in that case
+         */
+        bool IsRenderDisabled() const {
+            return renderEnableMode == engine::RenderEnableMode::False;
+        }
+
+        /**
+         * @brief Allocates any query and retrieves the predicate required for the next draw
+         * @note This must be called directly prior to the draw's subpass being added to the executor, the query must be begun and ended by the draw even if it's skipped
+         */
+        DrawState GetDrawState(InterconnectContext &ctx);
+    };
+}
@@ -3,6 +3,7 @@
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <gpu/buffer_manager.h>
+#include <gpu.h>
 #include <soc/gm20b/gmmu.h>
 #include <soc/gm20b/channel.h>
 #include "maxwell_dma.h"
@@ -40,11 +41,7 @@ namespace skyline::gpu::interconnect {
             srcBuf.GetBuffer()->BlockAllCpuBackingWrites();
             dstBuf.GetBuffer()->BlockAllCpuBackingWrites();
 
-            executor.AddOutsideRpCommand([srcBuf, dstBuf](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
-                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
-                    .srcAccessMask = vk::AccessFlagBits::eMemoryRead,
-                    .dstAccessMask = vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite
-                }, {}, {});
+            executor.AddTransferCommand(srcBuf.GetGuestSpan(), dstBuf.GetGuestSpan(), [srcBuf, dstBuf](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &gpu) {
                 auto srcBufBinding{srcBuf.GetBinding(gpu)};
                 auto dstBufBinding{dstBuf.GetBinding(gpu)};
                 vk::BufferCopy copyRegion{
@@ -53,11 +50,80 @@ namespace skyline::gpu::interconnect {
                     .dstOffset = dstBufBinding.offset
                 };
                 commandBuffer.copyBuffer(srcBufBinding.buffer, dstBufBinding.buffer, copyRegion);
-                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
-                    .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
-                    .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
-                }, {}, {});
             });
         });
     }
+
+    bool MaxwellDma::CopySwizzled(span<u8> blockLinearMapping, span<u8> pitchMapping, texture::Dimensions dimensions, size_t bytesPerPixel, size_t blockHeight, size_t blockDepth, bool blockLinearToPitch) {
+        if (!BlockLinearDeswizzleShader::IsLineSizeSupported(dimensions.width * bytesPerPixel))
+            return false;
+
+        // The shader operates on entire words so both surfaces need to start on a word boundary
+        if (!util::IsAligned(reinterpret_cast<uintptr_t>(blockLinearMapping.data()), sizeof(u32)) || !util::IsAligned(reinterpret_cast<uintptr_t>(pitchMapping.data()), sizeof(u32)))
+            return false;
+
+        // Only the lines that are present in the pitch surface are copied, since the surfaces are single-layered this doesn't affect the block-linear layout
+        dimensions.height = std::min<u32>(dimensions.height, static_cast<u32>(pitchMapping.size() / (dimensions.width * bytesPerPixel)));
+
+        auto blockLinearBuf{gpu.buffer.FindOrCreate(blockLinearMapping, executor.tag, [this](std::shared_ptr<Buffer> buffer, ContextLock<Buffer> &&lock) {
+            executor.AttachLockedBuffer(buffer, std::move(lock));
+        })};
+        ContextLock blockLinearBufLock{executor.tag, blockLinearBuf};
+        executor.AttachLockedBufferView(blockLinearBuf, std::move(blockLinearBufLock));
+
+        auto pitchBuf{gpu.buffer.FindOrCreate(pitchMapping, executor.tag, [this](std::shared_ptr<Buffer> buffer, ContextLock<Buffer> &&lock) {
+            executor.AttachLockedBuffer(buffer, std::move(lock));
+        })};
+        ContextLock pitchBufLock{executor.tag, pitchBuf};
+        executor.AttachLockedBufferView(pitchBuf, std::move(pitchBufLock));
+
+        auto &srcBuf{blockLinearToPitch ? blockLinearBuf : pitchBuf};
+        auto &dstBuf{blockLinearToPitch ? pitchBuf : blockLinearBuf};
+        srcBuf.GetBuffer()->BlockSequencedCpuBackingWrites();
+        dstBuf.GetBuffer()->BlockSequencedCpuBackingWrites();
+        dstBuf.GetBuffer()->MarkGpuDirty();
+
+        executor.AddOutsideRpCommand([blockLinearBuf, pitchBuf, dimensions, bytesPerPixel, blockHeight, blockDepth, blockLinearToPitch](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu) {
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eComputeShader, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+                .dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite
+            }, {}, {});
+
+            // Storage buffer descriptors need to be aligned, any misalignment is instead applied to the surface offsets
+            auto getDescriptor{[&gpu](const BufferView &view, vk::DeviceSize &surfaceOffset) {
+                auto binding{view.GetBinding(gpu)};
+                surfaceOffset = binding.offset & (gpu.traits.minimumStorageBufferAlignment - 1);
+                return vk::DescriptorBufferInfo{
+                    .buffer = binding.buffer,
+                    .offset = binding.offset - surfaceOffset,
+                    .range = binding.size + surfaceOffset,
+                };
+            }};
+
+            BlockLinearDeswizzleShader::Surface surface{
+                .width = dimensions.width,
+                .height = dimensions.height,
+                .depth = 1,
+                .formatBlockWidth = 1,
+                .formatBlockHeight = 1,
+                .formatBpb = static_cast<u32>(bytesPerPixel),
+                .gobBlockHeight = static_cast<u32>(blockHeight),
+                .gobBlockDepth = static_cast<u32>(blockDepth),
+            };
+            auto blockLinearDescriptor{getDescriptor(blockLinearBuf, surface.blockLinearOffset)};
+            auto pitchDescriptor{getDescriptor(pitchBuf, surface.linearOffset)};
+
+            auto &shader{gpu.helperShaders.blockLinearDeswizzleShader};
+            auto descriptorSet{blockLinearToPitch ? shader.Deswizzle(gpu, commandBuffer, blockLinearDescriptor, pitchDescriptor, surface)
+                                                  : shader.Swizzle(gpu, commandBuffer, blockLinearDescriptor, pitchDescriptor, surface)};
+            cycle->AttachObject(descriptorSet);
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+                .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+            }, {}, {});
+        });
+
+        return true;
+    }
 }
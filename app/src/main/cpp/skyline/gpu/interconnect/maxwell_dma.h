@@ -5,6 +5,7 @@
 #pragma once
 
 #include <soc/gm20b/gmmu.h>
+#include <gpu/texture/texture.h>
 
 namespace skyline::gpu {
     class GPU;
@@ -32,5 +33,13 @@ namespace skyline::gpu::interconnect {
         MaxwellDma(GPU &gpu, soc::gm20b::ChannelContext &channelCtx);
 
         void Copy(IOVA dst, IOVA src, size_t size);
+
+        /**
+         * @brief Records a swizzle or deswizzle between a pitch-linear and a block-linear surface using the block-linear deswizzle compute shader
+         * @param dimensions The dimensions of the surface in pixels, the pitch-linear surface must be tightly packed
+         * @param blockLinearToPitch If the copy is from the block-linear mapping into the pitch mapping rather than the other way around
+         * @return If the copy was recorded on the GPU, if not the caller is responsible for performing it on the CPU
+         */
+        bool CopySwizzled(span<u8> blockLinearMapping, span<u8> pitchMapping, texture::Dimensions dimensions, size_t bytesPerPixel, size_t blockHeight, size_t blockDepth, bool blockLinearToPitch);
     };
 }
@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <gpu.h>
+#include <gpu/texture_manager.h>
+#include "vic.h"
+
+namespace skyline::gpu::interconnect {
+    Vic::ImportedFrame::ImportedFrame(AHardwareBuffer *hardwareBuffer, vk::raii::Image image, vk::raii::DeviceMemory memory, vk::raii::ImageView view, Conversion &conversion)
+        : hardwareBuffer{hardwareBuffer},
+          image{std::move(image)},
+          memory{std::move(memory)},
+          view{std::move(view)},
+          conversion{conversion} {
+        AHardwareBuffer_acquire(hardwareBuffer);
+    }
+
+    Vic::ImportedFrame::~ImportedFrame() {
+        AHardwareBuffer_release(hardwareBuffer);
+    }
+
+    Vic::Conversion &Vic::GetConversion(u64 externalFormat, const vk::AndroidHardwareBufferFormatPropertiesANDROID &formatProperties) {
+        if (auto it{conversions.find(externalFormat)}; it != conversions.end())
+            return it->second;
+
+        // Chroma can only be linearly filtered when explicitly supported by the format, the sampler filters must match the chroma filter unless reconstruction can be controlled separately
+        vk::Filter filter{formatProperties.formatFeatures & vk::FormatFeatureFlagBits::eSampledImageYcbcrConversionLinearFilter ? vk::Filter::eLinear : vk::Filter::eNearest};
+
+        vk::StructureChain<vk::SamplerYcbcrConversionCreateInfo, vk::ExternalFormatANDROID> conversionCreateInfo{
+            vk::SamplerYcbcrConversionCreateInfo{
+                .format = vk::Format::eUndefined,
+                .ycbcrModel = formatProperties.suggestedYcbcrModel,
+                .ycbcrRange = formatProperties.suggestedYcbcrRange,
+                .components = formatProperties.samplerYcbcrConversionComponents,
+                .xChromaOffset = formatProperties.suggestedXChromaOffset,
+                .yChromaOffset = formatProperties.suggestedYChromaOffset,
+                .chromaFilter = filter,
+                .forceExplicitReconstruction = false,
+            },
+            vk::ExternalFormatANDROID{
+                .externalFormat = externalFormat,
+            }
+        };
+        vk::raii::SamplerYcbcrConversion conversion{gpu.vkDevice, conversionCreateInfo.get<vk::SamplerYcbcrConversionCreateInfo>()};
+
+        vk::StructureChain<vk::SamplerCreateInfo, vk::SamplerYcbcrConversionInfo> samplerCreateInfo{
+            vk::SamplerCreateInfo{
+                .magFilter = filter,
+                .minFilter = filter,
+                .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+                .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+                .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+                .anisotropyEnable = false,
+                .compareEnable = false,
+                .unnormalizedCoordinates = false,
+            },
+            vk::SamplerYcbcrConversionInfo{
+                .conversion = *conversion,
+            }
+        };
+        vk::raii::Sampler sampler{gpu.vkDevice, samplerCreateInfo.get<vk::SamplerCreateInfo>()};
+
+        return conversions.emplace(externalFormat, Conversion{std::move(conversion), std::move(sampler)}).first->second;
+    }
+
+    std::shared_ptr<Vic::ImportedFrame> Vic::ImportFrame(AHardwareBuffer *hardwareBuffer) {
+        if (auto it{importedFrames.find(hardwareBuffer)}; it != importedFrames.end())
+            return it->second;
+
+        if (importedFrames.size() >= MaxImportedFrameCount)
+            importedFrames.clear();
+
+        auto properties{gpu.vkDevice.getAndroidHardwareBufferPropertiesANDROID<vk::AndroidHardwareBufferPropertiesANDROID, vk::AndroidHardwareBufferFormatPropertiesANDROID>(*hardwareBuffer)};
+        auto &bufferProperties{properties.get<vk::AndroidHardwareBufferPropertiesANDROID>()};
+        auto &formatProperties{properties.get<vk::AndroidHardwareBufferFormatPropertiesANDROID>()};
+        if (!formatProperties.externalFormat)
+            throw exception("Decoded frame doesn't have an external format");
+
+        auto &conversion{GetConversion(formatProperties.externalFormat, formatProperties)};
+
+        AHardwareBuffer_Desc description{};
+        AHardwareBuffer_describe(hardwareBuffer, &description);
+
+        vk::StructureChain<vk::ImageCreateInfo, vk::ExternalMemoryImageCreateInfo, vk::ExternalFormatANDROID> imageCreateInfo{
+            vk::ImageCreateInfo{
+                .imageType = vk::ImageType::e2D,
+                .format = vk::Format::eUndefined,
+                .extent = vk::Extent3D{description.width, description.height, 1},
+                .mipLevels = 1,
+                .arrayLayers = description.layers,
+                .samples = vk::SampleCountFlagBits::e1,
+                .tiling = vk::ImageTiling::eOptimal,
+                .usage = vk::ImageUsageFlagBits::eSampled,
+                .sharingMode = vk::SharingMode::eExclusive,
+                .initialLayout = vk::ImageLayout::eUndefined,
+            },
+            vk::ExternalMemoryImageCreateInfo{
+                .handleTypes = vk::ExternalMemoryHandleTypeFlagBits::eAndroidHardwareBufferANDROID,
+            },
+            vk::ExternalFormatANDROID{
+                .externalFormat = formatProperties.externalFormat,
+            }
+        };
+        vk::raii::Image image{gpu.vkDevice, imageCreateInfo.get<vk::ImageCreateInfo>()};
+
+        // Imports of hardware buffers are required to be dedicated allocations
+        vk::StructureChain<vk::MemoryAllocateInfo, vk::ImportAndroidHardwareBufferInfoANDROID, vk::MemoryDedicatedAllocateInfo> allocateInfo{
+            vk::MemoryAllocateInfo{
+                .allocationSize = bufferProperties.allocationSize,
+                .memoryTypeIndex = static_cast<u32>(std::countr_zero(bufferProperties.memoryTypeBits)),
+            },
+            vk::ImportAndroidHardwareBufferInfoANDROID{
+                .buffer = hardwareBuffer,
+            },
+            vk::MemoryDedicatedAllocateInfo{
+                .image = *image,
+            }
+        };
+        vk::raii::DeviceMemory memory{gpu.vkDevice, allocateInfo.get<vk::MemoryAllocateInfo>()};
+
+        gpu.vkDevice.bindImageMemory2({vk::BindImageMemoryInfo{
+            .image = *image,
+            .memory = *memory,
+            .memoryOffset = 0,
+        }});
+
+        vk::StructureChain<vk::ImageViewCreateInfo, vk::SamplerYcbcrConversionInfo> viewCreateInfo{
+            vk::ImageViewCreateInfo{
+                .image = *image,
+                .viewType = vk::ImageViewType::e2D,
+                .format = vk::Format::eUndefined,
+                .subresourceRange = {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .levelCount = 1,
+                    .layerCount = 1,
+                },
+            },
+            vk::SamplerYcbcrConversionInfo{
+                .conversion = *conversion.conversion,
+            }
+        };
+        vk::raii::ImageView view{gpu.vkDevice, viewCreateInfo.get<vk::ImageViewCreateInfo>()};
+
+        auto frame{std::make_shared<ImportedFrame>(hardwareBuffer, std::move(image), std::move(memory), std::move(view), conversion)};
+        importedFrames.emplace(hardwareBuffer, frame);
+        return frame;
+    }
+
+    Vic::Vic(const DeviceState &state) : gpu{*state.gpu}, executor{state} {}
+
+    void Vic::Composite(const std::shared_ptr<soc::host1x::DecodedFrame> &frame, const GuestTexture &dstTexture) {
+        auto srcFrame{ImportFrame(frame->hardwareBuffer)};
+
+        std::scoped_lock lock{gpu.channelLock};
+        executor.LockPreserve();
+
+        auto dstView{gpu.texture.FindOrCreate(dstTexture, executor.tag, true)};
+
+        // The frame must not be returned to the decoder while the GPU is still sampling from it
+        executor.AttachDependency(frame);
+        executor.AttachDependency(srcFrame);
+        executor.AttachDependency(dstView);
+        executor.AttachTexture(dstView.get());
+
+        auto ownershipBarrier{[srcImage = *srcFrame->image, queueFamilyIndex = gpu.vkQueueFamilyIndex](bool acquire) {
+            return vk::ImageMemoryBarrier{
+                .srcAccessMask = acquire ? vk::AccessFlags{} : vk::AccessFlagBits::eShaderRead,
+                .dstAccessMask = acquire ? vk::AccessFlagBits::eShaderRead : vk::AccessFlags{},
+                .oldLayout = acquire ? vk::ImageLayout::eGeneral : vk::ImageLayout::eShaderReadOnlyOptimal,
+                .newLayout = acquire ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = acquire ? VK_QUEUE_FAMILY_FOREIGN_EXT : queueFamilyIndex,
+                .dstQueueFamilyIndex = acquire ? queueFamilyIndex : VK_QUEUE_FAMILY_FOREIGN_EXT,
+                .image = srcImage,
+                .subresourceRange = {
+                    .aspectMask = vk::ImageAspectFlagBits::eColor,
+                    .levelCount = 1,
+                    .layerCount = 1,
+                },
+            };
+        }};
+
+        // The decoder writes to the buffer outside of Vulkan, so ownership has to be acquired from the foreign queue family before sampling and released back to it afterwards
+        executor.AddOutsideRpCommand([barrier = ownershipBarrier(true)](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {}, barrier);
+        });
+
+        float frameWidth{static_cast<float>(frame->width)}, frameHeight{static_cast<float>(frame->height)};
+        auto &crop{frame->cropRect};
+        gpu.helperShaders.videoCompositorShader.Composite(
+            gpu,
+            *srcFrame->view, *srcFrame->conversion.sampler,
+            {static_cast<float>(crop.left) / frameWidth, static_cast<float>(crop.top) / frameHeight},
+            {static_cast<float>(crop.right - crop.left) / frameWidth, static_cast<float>(crop.bottom - crop.top) / frameHeight},
+            dstView.get(),
+            [&](auto &&executionCallback) {
+                auto dst{dstView.get()};
+                executor.AddSubpass(std::move(executionCallback), gpu::texture::ScaleRect({{0, 0}, {dstTexture.dimensions.width, dstTexture.dimensions.height}}, dst->texture->resolutionScale), {}, {}, {dst});
+            }
+        );
+
+        executor.AddOutsideRpCommand([barrier = ownershipBarrier(false)](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &, GPU &) {
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eFragmentShader, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, barrier);
+        });
+
+        executor.Submit();
+        executor.UnlockPreserve();
+    }
+
+    void Vic::Signal(std::function<void()> &&callback) {
+        std::scoped_lock lock{gpu.channelLock};
+        executor.LockPreserve();
+        executor.Submit(std::move(callback));
+        executor.UnlockPreserve();
+    }
+}
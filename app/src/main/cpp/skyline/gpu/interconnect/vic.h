@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <android/hardware_buffer.h>
+#include <gpu/texture/texture.h>
+#include <soc/host1x/frame_cache.h>
+#include "command_executor.h"
+
+namespace skyline::gpu::interconnect {
+    /**
+     * @brief Handles translating VIC surface composition to Vulkan, decoded frames are imported from their AHardwareBuffers directly and converted to RGB through a YCbCr conversion while being scaled into the output surface
+     */
+    class Vic {
+      private:
+        /**
+         * @brief A YCbCr conversion alongside a sampler using it for a single implementation-defined format
+         */
+        struct Conversion {
+            vk::raii::SamplerYcbcrConversion conversion;
+            vk::raii::Sampler sampler;
+        };
+
+        /**
+         * @brief An AHardwareBuffer that has been imported into Vulkan, the buffer is retained until this is destroyed
+         */
+        struct ImportedFrame {
+            AHardwareBuffer *hardwareBuffer;
+            vk::raii::Image image;
+            vk::raii::DeviceMemory memory;
+            vk::raii::ImageView view;
+            Conversion &conversion;
+
+            ImportedFrame(AHardwareBuffer *hardwareBuffer, vk::raii::Image image, vk::raii::DeviceMemory memory, vk::raii::ImageView view, Conversion &conversion);
+
+            ImportedFrame(const ImportedFrame &) = delete;
+
+            ImportedFrame &operator=(const ImportedFrame &) = delete;
+
+            ~ImportedFrame();
+        };
+
+        static constexpr size_t MaxImportedFrameCount{0x20}; //!< The maximum amount of cached imports, the cache is cleared once this is exceeded to avoid holding onto buffers from decoders that have been destroyed
+
+        GPU &gpu;
+        CommandExecutor executor; //!< VIC work isn't tied to any GPU channel, so it has its own executor which is submitted after every composition
+        std::unordered_map<u64, Conversion> conversions; //!< A map from external formats to their conversions, these are never destroyed as pipelines are created with their samplers
+        std::unordered_map<AHardwareBuffer *, std::shared_ptr<ImportedFrame>> importedFrames; //!< Decoders recycle a small set of buffers so imports are cached to avoid recreating the image for every frame
+
+        Conversion &GetConversion(u64 externalFormat, const vk::AndroidHardwareBufferFormatPropertiesANDROID &formatProperties);
+
+        /**
+         * @return An import of the supplied buffer, this is looked up from the cache when possible
+         */
+        std::shared_ptr<ImportedFrame> ImportFrame(AHardwareBuffer *hardwareBuffer);
+
+      public:
+        Vic(const DeviceState &state);
+
+        /**
+         * @brief Scales the cropped region of the supplied frame to cover the entirety of the destination surface
+         */
+        void Composite(const std::shared_ptr<soc::host1x::DecodedFrame> &frame, const GuestTexture &dstTexture);
+
+        /**
+         * @brief Calls the supplied callback once the GPU has completed all prior compositions, this doesn't block the calling thread
+         */
+        void Signal(std::function<void()> &&callback);
+    };
+}
@@ -5,12 +5,18 @@
 #include "megabuffer.h"
 
 namespace skyline::gpu {
-    MegaBufferChunk::MegaBufferChunk(GPU &gpu) : backing{gpu.memory.AllocateBuffer(MegaBufferChunkSize)}, freeRegion{backing.subspan(PAGE_SIZE)} {}
+    MegaBufferChunk::MegaBufferChunk(GPU &gpu) : backing{gpu.memory.AllocateBuffer(MegaBufferChunkSize, memory::AllocationCategory::MegaBuffer)}, freeRegion{backing.subspan(PAGE_SIZE)} {}
+
+    MegaBufferChunk::~MegaBufferChunk() {
+        if (cycle)
+            cycle->AttachObject(std::make_shared<memory::Buffer>(std::move(backing)));
+    }
 
     bool MegaBufferChunk::TryReset() {
         if (cycle && cycle->Poll(true)) {
             freeRegion = backing.subspan(PAGE_SIZE);
             cycle = nullptr;
+            generation++;
             return true;
         }
 
@@ -21,6 +27,13 @@ namespace skyline::gpu {
         return backing.vkBuffer;
     }
 
+    void MegaBufferChunk::Retain(const std::shared_ptr<FenceCycle> &newCycle) {
+        if (cycle != newCycle) {
+            newCycle->ChainCycle(cycle);
+            cycle = newCycle;
+        }
+    }
+
     std::pair<vk::DeviceSize, span<u8>> MegaBufferChunk::Allocate(const std::shared_ptr<FenceCycle> &newCycle, vk::DeviceSize size, bool pageAlign) {
         if (pageAlign) {
             // If page aligned data was requested then align the free
@@ -31,10 +44,7 @@ namespace skyline::gpu {
         if (size > freeRegion.size())
             return {0, {}};
 
-        if (cycle != newCycle) {
-            newCycle->ChainCycle(cycle);
-            cycle = newCycle;
-        }
+        Retain(newCycle);
 
         // Allocate space for data from the free region
         auto resultSpan{freeRegion.subspan(0, size)};
@@ -45,18 +55,28 @@ namespace skyline::gpu {
         return {static_cast<vk::DeviceSize>(resultSpan.data() - backing.data()), resultSpan};
     }
 
-    MegaBufferAllocator::MegaBufferAllocator(GPU &gpu) : gpu{gpu}, activeChunk{chunks.emplace(chunks.end(), gpu)} {}
+    MegaBufferAllocator::ChunkRing::ChunkRing(GPU &gpu) : gpu{gpu}, activeChunk{chunks.emplace(chunks.end(), gpu)} {}
+
+    void MegaBufferAllocator::ChunkRing::Advance() {
+        auto oldestChunk{std::next(activeChunk) == chunks.end() ? chunks.begin() : std::next(activeChunk)};
+        if (oldestChunk->TryReset())
+            activeChunk = oldestChunk;
+        else // If the least recently used chunk is still in use then all other chunks will be too, so a new one needs to be allocated
+            activeChunk = chunks.emplace(std::next(activeChunk), gpu);
+    }
+
+    MegaBufferAllocator::MegaBufferAllocator(GPU &gpu) : rings{std::ref(gpu)} {}
 
     MegaBufferAllocator::Allocation MegaBufferAllocator::Allocate(const std::shared_ptr<FenceCycle> &cycle, vk::DeviceSize size, bool pageAlign) {
-        if (auto allocation{activeChunk->Allocate(cycle, size, pageAlign)}; allocation.first)
-            return {activeChunk->GetBacking(), allocation.first, allocation.second};
+        auto &ring{*rings};
+        allocatedSize.fetch_add(size, std::memory_order_relaxed);
+        if (auto allocation{ring.activeChunk->Allocate(cycle, size, pageAlign)}; allocation.first)
+            return {ring.activeChunk->GetBacking(), allocation.first, allocation.second};
 
-        activeChunk = ranges::find_if(chunks, [&](auto &chunk) { return chunk.TryReset(); });
-        if (activeChunk == chunks.end()) // If there are no chunks available, allocate a new one
-            activeChunk = chunks.emplace(chunks.end(), gpu);
+        ring.Advance();
 
-        if (auto allocation{activeChunk->Allocate(cycle, size, pageAlign)}; allocation.first)
-            return {activeChunk->GetBacking(), allocation.first, allocation.second};
+        if (auto allocation{ring.activeChunk->Allocate(cycle, size, pageAlign)}; allocation.first)
+            return {ring.activeChunk->GetBacking(), allocation.first, allocation.second};
         else
             throw exception("Failed to to allocate megabuffer space for size: 0x{:X}", size);
     }
@@ -66,4 +86,27 @@ namespace skyline::gpu {
         allocation.region.copy_from(data);
         return allocation;
     }
+
+    MegaBufferAllocator::Allocation MegaBufferAllocator::PushCached(const std::shared_ptr<FenceCycle> &cycle, span<u8> data, bool pageAlign) {
+        if (data.size() > MegaBufferCacheMaxSize)
+            return Push(cycle, data, pageAlign);
+
+        auto &ring{*rings};
+        u64 hash{XXH64(data.data(), data.size(), 0)};
+        if (auto it{ring.cache.find(hash)}; it != ring.cache.end()) {
+            auto &cached{it->second};
+            // The contents are compared in addition to the hash to rule out any collisions, the allocation is only valid if its chunk hasn't been reset since it was made
+            if (cached.chunk->GetGeneration() == cached.generation && (cached.pageAligned || !pageAlign) && cached.allocation.region.size() == data.size() && std::memcmp(cached.allocation.region.data(), data.data(), data.size()) == 0) {
+                cached.chunk->Retain(cycle);
+                return cached.allocation;
+            }
+        }
+
+        auto allocation{Push(cycle, data, pageAlign)};
+        if (ring.cache.size() >= ChunkRing::MaxCachedAllocations)
+            ring.cache.clear();
+
+        ring.cache.insert_or_assign(hash, ChunkRing::CachedAllocation{ring.activeChunk, ring.activeChunk->GetGeneration(), pageAlign, allocation});
+        return allocation;
+    }
 }
@@ -3,24 +3,36 @@
 
 #pragma once
 
+#include <common/thread_local.h>
 #include "memory_manager.h"
 
 namespace skyline::gpu {
     constexpr static vk::DeviceSize MegaBufferChunkSize{25 * 1024 * 1024}; //!< Size in bytes of a single megabuffer chunk (25MiB)
+    constexpr static vk::DeviceSize MegaBufferCacheMaxSize{0x10000}; //!< The maximum size of data that'll be looked up in the content cache when pushed, this is the maximum size of a constant buffer (64KiB)
 
     /**
       * @brief A simple linearly allocated GPU-side buffer used to temporarily store buffer modifications allowing them to be replayed in-sequence on the GPU
-      * @note This class is **not** thread-safe and any calls must be externally synchronized
+      * @note This class is **not** thread-safe and any calls must be externally synchronized, this is done by only ever using a chunk from the thread which owns it
       */
     class MegaBufferChunk {
       private:
         std::shared_ptr<FenceCycle> cycle; //!< Latest cycle this chunk has had allocations in
         memory::Buffer backing; //!< The GPU buffer as the backing storage for the chunk
         span<u8> freeRegion; //!< The unallocated space in the chunk
+        u32 generation{}; //!< Incremented every time the chunk is reset, allocations from a previous generation are no longer valid
 
       public:
         MegaBufferChunk(GPU &gpu);
 
+        MegaBufferChunk(const MegaBufferChunk &) = delete;
+
+        MegaBufferChunk &operator=(const MegaBufferChunk &) = delete;
+
+        /**
+         * @note If the chunk is still in use by the GPU, the destruction of its backing is deferred until its cycle is signalled
+         */
+        ~MegaBufferChunk();
+
         /**
          * @brief If the chunk's cycle is is signalled, resets the free region of the megabuffer to its initial state, if it's not signalled the chunk must not be used
          * @returns True if the chunk can be reused, false otherwise
@@ -32,19 +44,23 @@ namespace skyline::gpu {
          */
         vk::Buffer GetBacking() const;
 
+        u32 GetGeneration() const {
+            return generation;
+        }
+
+        /**
+         * @brief Extends the lifetime of all allocations in the chunk to cover the supplied cycle, this allows an existing allocation to be reused by it
+         */
+        void Retain(const std::shared_ptr<FenceCycle> &newCycle);
+
         std::pair<vk::DeviceSize, span<u8>> Allocate(const std::shared_ptr<FenceCycle> &newCycle, vk::DeviceSize size, bool pageAlign = false);
     };
 
     /**
      * @brief Allocator for megabuffer chunks that takes the usage of resources on the GPU into account
-     * @note This class is not thread-safe and any calls must be externally synchronized
+     * @note Every thread allocates from its own ring of chunks, so calls don't need to be externally synchronized but any allocation must only be written to by the thread it was allocated on
      */
     class MegaBufferAllocator {
-      private:
-        GPU &gpu;
-        std::list<MegaBufferChunk> chunks; //!< A pool of all allocated megabuffer chunks, these are dynamically utilized
-        decltype(chunks)::iterator activeChunk; //!< Currently active chunk of the megabuffer which is being allocated into
-
       public:
         /**
          * @brief A megabuffer chunk allocation
@@ -59,20 +75,65 @@ namespace skyline::gpu {
             }
         };
 
+      private:
+        /**
+         * @brief A thread-local ring of megabuffer chunks, the chunks are in the order they were last allocated from so the chunk after the active one is always the least recently used
+         */
+        struct ChunkRing {
+            GPU &gpu;
+            std::list<MegaBufferChunk> chunks; //!< All megabuffer chunks in the ring, a new chunk is only inserted when the least recently used chunk is still in use by the GPU
+            decltype(chunks)::iterator activeChunk; //!< Currently active chunk of the ring which is being allocated into
+
+            ChunkRing(GPU &gpu);
+
+            /**
+             * @brief Makes the least recently used chunk the active chunk if it's no longer in use by the GPU, otherwise a new chunk is inserted into the ring after the active chunk
+             */
+            void Advance();
+
+            /**
+             * @brief An allocation that was pushed with contents that can be reused by any later push of identical data
+             */
+            struct CachedAllocation {
+                decltype(chunks)::iterator chunk; //!< The chunk the allocation was made in
+                u32 generation; //!< The generation of the chunk during which the allocation was made
+                bool pageAligned;
+                Allocation allocation;
+            };
+
+            static constexpr size_t MaxCachedAllocations{0x400}; //!< The maximum amount of entries in `cache`, it'll be cleared upon reaching this
+            std::unordered_map<u64, CachedAllocation> cache; //!< A map from the hash of pushed data to the allocation containing it
+        };
+
+        ThreadLocal<ChunkRing> rings; //!< The chunk ring of every thread that has allocated from this allocator
+        std::atomic<u64> allocatedSize{}; //!< The combined size of all allocations made from this allocator in bytes
+
+      public:
         MegaBufferAllocator(GPU &gpu);
 
+        /**
+         * @return The combined size of all allocations made so far in bytes, the usage over a period is the difference between two samples of this
+         */
+        u64 GetAllocatedSize() const {
+            return allocatedSize.load(std::memory_order_relaxed);
+        }
+
         /**
           * @brief Allocates data in a megabuffer chunk and returns an structure describing the allocation
           * @param pageAlign Whether the pushed data should be page aligned in the megabuffer
-          * @note The allocator *MUST* be locked before calling this function
           */
         Allocation Allocate(const std::shared_ptr<FenceCycle> &cycle, vk::DeviceSize size, bool pageAlign = false);
 
         /**
          * @brief Pushes data to a megabuffer chunk and returns an structure describing the allocation
          * @param pageAlign Whether the pushed data should be page aligned in the megabuffer
-         * @note The allocator *MUST* be locked before calling this function
          */
         Allocation Push(const std::shared_ptr<FenceCycle> &cycle, span<u8> data, bool pageAlign = false);
+
+        /**
+         * @brief Pushes data to a megabuffer chunk unless identical data has previously been pushed by the calling thread and is still resident, in which case that allocation is reused
+         * @note The returned allocation **must not** be written to as it may be shared with other users
+         */
+        Allocation PushCached(const std::shared_ptr<FenceCycle> &cycle, span<u8> data, bool pageAlign = false);
     };
 }
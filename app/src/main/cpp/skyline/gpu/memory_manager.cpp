@@ -13,13 +13,26 @@ namespace skyline::gpu::memory {
             vk::throwResultException(vk::Result(result), function);
     }
 
+    /**
+     * @brief Removes an allocation from the usage of the category it was accounted to, the user data of the allocation is the usage counter of its category
+     */
+    static void ReleaseAccounting(VmaAllocator vmaAllocator, VmaAllocation vmaAllocation) {
+        VmaAllocationInfo allocationInfo;
+        vmaGetAllocationInfo(vmaAllocator, vmaAllocation, &allocationInfo);
+        if (auto usage{static_cast<std::atomic<vk::DeviceSize> *>(allocationInfo.pUserData)})
+            usage->fetch_sub(allocationInfo.size, std::memory_order_relaxed);
+    }
+
     Buffer::~Buffer() {
-        if (vmaAllocator && vmaAllocation && vkBuffer)
+        if (vmaAllocator && vmaAllocation && vkBuffer) {
+            ReleaseAccounting(vmaAllocator, vmaAllocation);
             vmaDestroyBuffer(vmaAllocator, vkBuffer, vmaAllocation);
+        }
     }
 
     Image::~Image() {
         if (vmaAllocator && vmaAllocation && vkImage) {
+            ReleaseAccounting(vmaAllocator, vmaAllocation);
             if (pointer)
                 vmaUnmapMemory(vmaAllocator, vmaAllocation);
             vmaDestroyImage(vmaAllocator, vkImage, vmaAllocation);
@@ -61,6 +74,7 @@ namespace skyline::gpu::memory {
             .vkGetPhysicalDeviceMemoryProperties2KHR = instanceDispatcher->vkGetPhysicalDeviceMemoryProperties2,
         };
         VmaAllocatorCreateInfo allocatorCreateInfo{
+            .flags = gpu.traits.supportsMemoryBudget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : VmaAllocatorCreateFlags{},
             .physicalDevice = *gpu.vkPhysicalDevice,
             .device = *gpu.vkDevice,
             .instance = *gpu.vkInstance,
@@ -71,89 +85,232 @@ namespace skyline::gpu::memory {
     }
 
     MemoryManager::~MemoryManager() {
+        for (auto &pool : stagingPool)
+            pool.clear();
         vmaDestroyAllocator(vmaAllocator);
     }
 
-    std::shared_ptr<StagingBuffer> MemoryManager::AllocateStagingBuffer(vk::DeviceSize size) {
+    MemoryManager::Budget MemoryManager::GetDeviceLocalBudget() {
+        const VkPhysicalDeviceMemoryProperties *memoryProperties{};
+        vmaGetMemoryProperties(vmaAllocator, &memoryProperties);
+
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> heapBudgets{};
+        vmaGetHeapBudgets(vmaAllocator, heapBudgets.data());
+
+        Budget budget{};
+        for (u32 heap{}; heap < memoryProperties->memoryHeapCount; heap++) {
+            if (memoryProperties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+                budget.usage += heapBudgets[heap].usage;
+                budget.budget += heapBudgets[heap].budget;
+            }
+        }
+        return budget;
+    }
+
+    std::unique_ptr<StagingBuffer> MemoryManager::CreateStagingBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage) {
         vk::BufferCreateInfo bufferCreateInfo{
             .size = size,
-            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | usage,
             .sharingMode = vk::SharingMode::eExclusive,
             .queueFamilyIndexCount = 1,
             .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
         };
+        auto &usage{categoryUsage[static_cast<size_t>(AllocationCategory::Staging)]};
         VmaAllocationCreateInfo allocationCreateInfo{
             .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
             .usage = VMA_MEMORY_USAGE_CPU_ONLY,
+            .pUserData = &usage,
         };
 
         VkBuffer buffer;
         VmaAllocation allocation;
         VmaAllocationInfo allocationInfo;
         ThrowOnFail(vmaCreateBuffer(vmaAllocator, &static_cast<const VkBufferCreateInfo &>(bufferCreateInfo), &allocationCreateInfo, &buffer, &allocation, &allocationInfo));
+        usage.fetch_add(allocationInfo.size, std::memory_order_relaxed);
 
-        return std::make_shared<memory::StagingBuffer>(reinterpret_cast<u8 *>(allocationInfo.pMappedData), size, vmaAllocator, buffer, allocation);
+        return std::make_unique<memory::StagingBuffer>(reinterpret_cast<u8 *>(allocationInfo.pMappedData), size, vmaAllocator, buffer, allocation);
     }
 
-    Buffer MemoryManager::AllocateBuffer(vk::DeviceSize size) {
+    void MemoryManager::RecycleStagingBuffer(StagingBuffer *buffer, size_t sizeClass) {
+        std::unique_ptr<StagingBuffer> owned{buffer};
+        vk::DeviceSize classSize{MinStagingSizeClass << sizeClass};
+
+        std::scoped_lock lock{stagingMutex};
+        if (idleStagingSize + classSize > MaxIdleStagingSize)
+            return;
+
+        idleStagingSize += classSize;
+        stagingPool[sizeClass].push_back(std::move(owned));
+    }
+
+    vk::DeviceSize MemoryManager::GetIdleStagingSize() {
+        std::scoped_lock lock{stagingMutex};
+        return idleStagingSize;
+    }
+
+    void MemoryManager::TrimStagingPool() {
+        // The buffers are moved out of the pool so they're freed without the lock being held
+        decltype(stagingPool) idlePool;
+        {
+            std::scoped_lock lock{stagingMutex};
+            std::swap(idlePool, stagingPool);
+            idleStagingSize = 0;
+        }
+    }
+
+    std::shared_ptr<StagingBuffer> MemoryManager::AllocateStagingBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage) {
+        if ((usage & ~PooledStagingUsage) || size > (MinStagingSizeClass << (StagingSizeClassCount - 1)))
+            return CreateStagingBuffer(size, usage);
+
+        size_t sizeClass{static_cast<size_t>(std::bit_width(std::max(size, MinStagingSizeClass) - 1) - std::countr_zero(MinStagingSizeClass))};
+        std::unique_ptr<StagingBuffer> buffer;
+        {
+            std::scoped_lock lock{stagingMutex};
+            auto &pool{stagingPool[sizeClass]};
+            if (!pool.empty()) {
+                buffer = std::move(pool.back());
+                pool.pop_back();
+                idleStagingSize -= MinStagingSizeClass << sizeClass;
+            }
+        }
+
+        if (!buffer)
+            buffer = CreateStagingBuffer(MinStagingSizeClass << sizeClass, PooledStagingUsage);
+
+        // The buffer is handed out with the requested size rather than that of its class, so barriers and copies over its entirety don't cover more than what was requested
+        static_cast<span<u8> &>(*buffer) = span<u8>{buffer->data(), size};
+        return std::shared_ptr<StagingBuffer>{buffer.release(), [this, sizeClass](StagingBuffer *released) {
+            RecycleStagingBuffer(released, sizeClass);
+        }};
+    }
+
+    Buffer MemoryManager::AllocateBuffer(vk::DeviceSize size, AllocationCategory category) {
         vk::BufferCreateInfo bufferCreateInfo{
             .size = size,
-            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT | vk::BufferUsageFlagBits::eConditionalRenderingEXT,
             .sharingMode = vk::SharingMode::eExclusive,
             .queueFamilyIndexCount = 1,
             .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
         };
+        auto &usage{categoryUsage[static_cast<size_t>(category)]};
         VmaAllocationCreateInfo allocationCreateInfo{
             .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT,
             .usage = VMA_MEMORY_USAGE_UNKNOWN,
             .requiredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eDeviceLocal),
+            .pUserData = &usage,
         };
 
         VkBuffer buffer;
         VmaAllocation allocation;
         VmaAllocationInfo allocationInfo;
         ThrowOnFail(vmaCreateBuffer(vmaAllocator, &static_cast<const VkBufferCreateInfo &>(bufferCreateInfo), &allocationCreateInfo, &buffer, &allocation, &allocationInfo));
+        usage.fetch_add(allocationInfo.size, std::memory_order_relaxed);
 
         return Buffer(reinterpret_cast<u8 *>(allocationInfo.pMappedData), size, vmaAllocator, buffer, allocation);
     }
 
     Image MemoryManager::AllocateImage(const vk::ImageCreateInfo &createInfo) {
+        auto &usage{categoryUsage[static_cast<size_t>(AllocationCategory::Texture)]};
         VmaAllocationCreateInfo allocationCreateInfo{
             .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+            .pUserData = &usage,
         };
 
         VkImage image;
         VmaAllocation allocation;
         VmaAllocationInfo allocationInfo;
         ThrowOnFail(vmaCreateImage(vmaAllocator, &static_cast<const VkImageCreateInfo &>(createInfo), &allocationCreateInfo, &image, &allocation, &allocationInfo));
+        usage.fetch_add(allocationInfo.size, std::memory_order_relaxed);
 
         return Image(vmaAllocator, image, allocation);
     }
 
     Image MemoryManager::AllocateMappedImage(const vk::ImageCreateInfo &createInfo) {
+        auto &usage{categoryUsage[static_cast<size_t>(AllocationCategory::Texture)]};
         VmaAllocationCreateInfo allocationCreateInfo{
             .usage = VMA_MEMORY_USAGE_UNKNOWN,
             .requiredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eDeviceLocal),
+            .pUserData = &usage,
         };
 
         VkImage image;
         VmaAllocation allocation;
         VmaAllocationInfo allocationInfo;
         ThrowOnFail(vmaCreateImage(vmaAllocator, &static_cast<const VkImageCreateInfo &>(createInfo), &allocationCreateInfo, &image, &allocation, &allocationInfo));
+        usage.fetch_add(allocationInfo.size, std::memory_order_relaxed);
 
         return Image(vmaAllocator, image, allocation);
     }
 
+    /**
+     * @brief Imports the CPU mapped region into a new buffer using VK_EXT_external_memory_host, the memory is directly shared with the CPU so there's no separate copy of the contents
+     */
+    static ImportedBuffer ImportHostPointerBuffer(GPU &gpu, span<u8> cpuMapping) {
+        if (!util::IsAligned(cpuMapping.data(), gpu.traits.minImportedHostPointerAlignment) || !util::IsAligned(cpuMapping.size(), gpu.traits.minImportedHostPointerAlignment))
+            throw exception("Host buffer import region isn't aligned to 0x{:X}: 0x{:X} (0x{:X} bytes)", gpu.traits.minImportedHostPointerAlignment, cpuMapping.data(), cpuMapping.size());
+
+        constexpr auto HandleType{vk::ExternalMemoryHandleTypeFlagBits::eHostAllocationEXT};
+        vk::StructureChain<vk::BufferCreateInfo, vk::ExternalMemoryBufferCreateInfo> bufferCreateInfo{
+            vk::BufferCreateInfo{
+                .size = cpuMapping.size(),
+                .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT | vk::BufferUsageFlagBits::eConditionalRenderingEXT,
+                .sharingMode = vk::SharingMode::eExclusive
+            },
+            vk::ExternalMemoryBufferCreateInfo{
+                .handleTypes = HandleType
+            }
+        };
+        vk::raii::Buffer buffer{gpu.vkDevice, bufferCreateInfo.get<vk::BufferCreateInfo>()};
+
+        auto pointerProperties{gpu.vkDevice.getMemoryHostPointerPropertiesEXT(HandleType, cpuMapping.data())};
+        auto memoryTypeBits{pointerProperties.memoryTypeBits & buffer.getMemoryRequirements().memoryTypeBits};
+        if (!memoryTypeBits)
+            throw exception("No memory type is compatible with the imported host buffer");
+
+        // Device-local memory types are preferred as they're the fastest for the GPU to access, on UMA devices all host-visible types usually are
+        auto memoryProperties{gpu.vkPhysicalDevice.getMemoryProperties()};
+        u32 memoryTypeIndex{static_cast<u32>(std::countr_zero(memoryTypeBits))};
+        for (u32 i{memoryTypeIndex}; i < memoryProperties.memoryTypeCount; i++) {
+            if ((memoryTypeBits & (1U << i)) && (memoryProperties.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eDeviceLocal)) {
+                memoryTypeIndex = i;
+                break;
+            }
+        }
+
+        vk::StructureChain<vk::MemoryAllocateInfo, vk::ImportMemoryHostPointerInfoEXT> allocateInfo{
+            vk::MemoryAllocateInfo{
+                .allocationSize = cpuMapping.size(),
+                .memoryTypeIndex = memoryTypeIndex,
+            },
+            vk::ImportMemoryHostPointerInfoEXT{
+                .handleType = HandleType,
+                .pHostPointer = cpuMapping.data(),
+            }
+        };
+        vk::raii::DeviceMemory memory{gpu.vkDevice, allocateInfo.get<vk::MemoryAllocateInfo>()};
+
+        gpu.vkDevice.bindBufferMemory2({vk::BindBufferMemoryInfo{
+            .buffer = *buffer,
+            .memory = *memory,
+            .memoryOffset = 0
+        }});
+
+        return ImportedBuffer{cpuMapping, std::move(buffer), std::move(memory)};
+    }
+
     ImportedBuffer MemoryManager::ImportBuffer(span<u8> cpuMapping) {
-        if (!gpu.traits.supportsAdrenoDirectMemoryImport)
-            throw exception("Cannot import host buffers without adrenotools import support!");
+        if (!gpu.traits.supportsAdrenoDirectMemoryImport) {
+            if (gpu.traits.supportsExternalMemoryHost)
+                return ImportHostPointerBuffer(gpu, cpuMapping);
+            throw exception("Cannot import host buffers without adrenotools import support or VK_EXT_external_memory_host!");
+        }
 
         if (!adrenotools_import_user_mem(&gpu.adrenotoolsImportMapping, cpuMapping.data(), cpuMapping.size()))
             throw exception("Failed to import user memory");
 
         auto buffer{gpu.vkDevice.createBuffer(vk::BufferCreateInfo{
             .size = cpuMapping.size(),
-            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT,
+            .usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eUniformTexelBuffer | vk::BufferUsageFlagBits::eStorageTexelBuffer | vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransformFeedbackBufferEXT | vk::BufferUsageFlagBits::eConditionalRenderingEXT,
             .sharingMode = vk::SharingMode::eExclusive
         })};
 
@@ -173,4 +330,45 @@ namespace skyline::gpu::memory {
 
         return ImportedBuffer{cpuMapping, std::move(buffer), std::move(memory)};
     }
+
+    std::optional<ImportedImage> MemoryManager::ImportImage(span<u8> cpuMapping, vk::DeviceSize offset, const vk::ImageCreateInfo &createInfo, vk::DeviceSize rowPitch) {
+        if (!gpu.traits.supportsAdrenoDirectMemoryImport)
+            throw exception("Cannot import host images without adrenotools import support!");
+
+        try {
+            std::ignore = gpu.vkPhysicalDevice.getImageFormatProperties(createInfo.format, createInfo.imageType, vk::ImageTiling::eLinear, createInfo.usage, createInfo.flags);
+        } catch (const vk::FormatNotSupportedError &) {
+            return std::nullopt; // Linear tiling is a lot more restricted than optimal tiling, the format may not support it with the required usage
+        }
+
+        vk::raii::Image image{gpu.vkDevice, createInfo};
+
+        // The image can only alias the CPU mapping if the host layout of the image exactly matches the layout of the data in it
+        auto subresourceLayout{image.getSubresourceLayout(vk::ImageSubresource{.aspectMask = vk::ImageAspectFlagBits::eColor})};
+        if (subresourceLayout.offset != 0 || subresourceLayout.rowPitch != rowPitch)
+            return std::nullopt;
+
+        auto requirements{image.getMemoryRequirements()};
+        if (!(requirements.memoryTypeBits & (1U << gpu.traits.hostVisibleCoherentCachedMemoryType)) || !util::IsAligned(offset, requirements.alignment) || offset + requirements.size > cpuMapping.size())
+            return std::nullopt;
+
+        if (!adrenotools_import_user_mem(&gpu.adrenotoolsImportMapping, cpuMapping.data(), cpuMapping.size()))
+            throw exception("Failed to import user memory");
+
+        auto memory{gpu.vkDevice.allocateMemory(vk::MemoryAllocateInfo{
+            .allocationSize = cpuMapping.size(),
+            .memoryTypeIndex = gpu.traits.hostVisibleCoherentCachedMemoryType,
+        })};
+
+        if (!adrenotools_validate_gpu_mapping(&gpu.adrenotoolsImportMapping))
+            throw exception("Failed to validate GPU mapping");
+
+        gpu.vkDevice.bindImageMemory2({vk::BindImageMemoryInfo{
+            .image = *image,
+            .memory = *memory,
+            .memoryOffset = offset,
+        }});
+
+        return ImportedImage{std::move(image), std::move(memory)};
+    }
 }
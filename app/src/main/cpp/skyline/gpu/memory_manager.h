@@ -7,6 +7,18 @@
 #include "fence_cycle.h"
 
 namespace skyline::gpu::memory {
+    /**
+     * @brief The subsystem that a VMA allocation is made for, the memory usage of every category is tracked separately so memory pressure can be attributed
+     */
+    enum class AllocationCategory : u8 {
+        Staging, //!< Staging buffers, this includes idle buffers in the staging pool
+        Texture, //!< Images backing textures
+        Buffer, //!< Host backings of guest buffers
+        MegaBuffer, //!< Megabuffer chunks
+        Miscellaneous, //!< Any other allocations such as index conversion buffers
+    };
+    constexpr size_t AllocationCategoryCount{5};
+
     /**
      * @brief A view into a CPU mapping of a Vulkan buffer
      * @note The mapping **should not** be used after the lifetime of the object has ended
@@ -68,6 +80,14 @@ namespace skyline::gpu::memory {
         ImportedBuffer &operator=(ImportedBuffer &&) = default;
     };
 
+    /**
+     * @brief A Vulkan image with linear tiling that is backed by an imported CPU mapping, writes from either side are visible to the other without any copies
+     */
+    struct ImportedImage {
+        vk::raii::Image vkImage;
+        vk::raii::DeviceMemory vkMemory;
+    };
+
     /**
      * @brief A Vulkan image which VMA allocates and manages the backing memory for
      * @note Any images created with VMA_ALLOCATION_CREATE_MAPPED_BIT must not be utilized with this since it'll unconditionally unmap when a pointer is present which is illegal when an image was created with that flag as unmapping will be automatically performed on image deletion
@@ -121,34 +141,93 @@ namespace skyline::gpu::memory {
         GPU &gpu;
         VmaAllocator vmaAllocator{VK_NULL_HANDLE};
 
+        static constexpr vk::DeviceSize MinStagingSizeClass{0x10000}; //!< The size of the smallest staging buffer size class (64 KiB), every class is double the size of the one before it
+        static constexpr size_t StagingSizeClassCount{11}; //!< The amount of staging buffer size classes, the largest is 64 MiB and any larger staging buffers aren't pooled
+        static constexpr vk::DeviceSize MaxIdleStagingSize{0x8000000}; //!< The maximum combined size of idle staging buffers in the pool (128 MiB), any buffers released beyond this are freed
+        static constexpr vk::BufferUsageFlags PooledStagingUsage{vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eStorageBuffer}; //!< The usage of all pooled staging buffers, staging buffers requiring any other usage aren't pooled
+
+        std::mutex stagingMutex; //!< Synchronizes access to the staging buffer pool
+        std::array<std::vector<std::unique_ptr<StagingBuffer>>, StagingSizeClassCount> stagingPool; //!< Idle staging buffers for each size class, these are released into the pool once the last fence cycle using them has been signalled
+        vk::DeviceSize idleStagingSize{}; //!< The combined size of all idle staging buffers in the pool
+        std::array<std::atomic<vk::DeviceSize>, AllocationCategoryCount> categoryUsage{}; //!< The combined size of all live allocations in every category, a pointer to the counter is stored as the user data of every allocation so it can be decremented when it's freed
+
+        std::unique_ptr<StagingBuffer> CreateStagingBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage);
+
+        /**
+         * @brief Returns a staging buffer into the pool for its size class or frees it if too much memory is already idle in the pool
+         */
+        void RecycleStagingBuffer(StagingBuffer *buffer, size_t sizeClass);
+
       public:
         MemoryManager(GPU &gpu);
 
         ~MemoryManager();
 
+        /**
+         * @brief The memory usage and budget of a set of memory heaps
+         */
+        struct Budget {
+            vk::DeviceSize usage; //!< The amount of memory in bytes that is currently used by the process
+            vk::DeviceSize budget; //!< The amount of memory in bytes that the process can use before allocations may fail or cause performance degradation
+        };
+
+        /**
+         * @return The combined usage and budget of all device-local heaps, this is an estimate based on the heap size and our own allocations if VK_EXT_memory_budget isn't supported
+         */
+        Budget GetDeviceLocalBudget();
+
+        /**
+         * @return The combined size of all live allocations in the supplied category in bytes
+         */
+        vk::DeviceSize GetCategoryUsage(AllocationCategory category) const {
+            return categoryUsage[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @return The combined size of all idle staging buffers in the staging pool in bytes
+         */
+        vk::DeviceSize GetIdleStagingSize();
+
+        /**
+         * @brief Frees all idle staging buffers in the staging pool, this is used to release memory when the host is running low on it
+         */
+        void TrimStagingPool();
+
         /**
          * @brief Creates a buffer which is optimized for staging (Transfer Source)
+         * @param usage Any additional usage flags for the buffer beyond transfer source/destination
+         * @note Staging buffers are pooled in power-of-two size classes, they're reused once the last reference to them is dropped which happens when the fence cycle they're attached to is signalled
          */
-        std::shared_ptr<StagingBuffer> AllocateStagingBuffer(vk::DeviceSize size);
+        std::shared_ptr<StagingBuffer> AllocateStagingBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage = {});
 
         /**
          * @brief Creates a buffer with a CPU mapping and all usage flags
          */
-        Buffer AllocateBuffer(vk::DeviceSize size);
+        Buffer AllocateBuffer(vk::DeviceSize size, AllocationCategory category);
 
         /**
          * @brief Creates an image which is allocated and deallocated using RAII
+         * @note The image is accounted as a texture
          */
         Image AllocateImage(const vk::ImageCreateInfo &createInfo);
 
         /**
          * @brief Creates an image which is allocated and deallocated using RAII and is optimal for being mapped on the CPU
+         * @note The image is accounted as a texture
          */
         Image AllocateMappedImage(const vk::ImageCreateInfo &createInfo);
 
         /**
          * @brief Maps the input CPU mapped region into a new buffer
+         * @note The adrenotools import patch is used when available, otherwise VK_EXT_external_memory_host is used which requires the region to be aligned to `minImportedHostPointerAlignment`
          */
         ImportedBuffer ImportBuffer(span<u8> cpuMapping);
+
+        /**
+         * @brief Creates an image with linear tiling that aliases the supplied CPU mapped region at the supplied offset
+         * @param rowPitch The pitch of rows in the CPU mapping, the host layout of the image must match it exactly
+         * @return The imported image or std::nullopt if the host layout of the image doesn't match the CPU mapping or the image can't be created with linear tiling
+         */
+        std::optional<ImportedImage> ImportImage(span<u8> cpuMapping, vk::DeviceSize offset, const vk::ImageCreateInfo &createInfo, vk::DeviceSize rowPitch);
     };
 }
@@ -36,6 +36,12 @@ constexpr int AndroidNativeWindowMagic{ANDROID_NATIVE_WINDOW_MAGIC};
  */
 constexpr int64_t NativeWindowTimestampAuto{-9223372036854775807LL - 1};
 
+/**
+ * @url https://cs.android.com/android/platform/superproject/+/android11-release:frameworks/native/libs/nativewindow/include/system/window.h;l=333-334;drc=401cda638e7d17f6697b5a65c9a5ad79d056202d
+ */
+constexpr int64_t NativeWindowTimestampInvalid{-1};
+constexpr int64_t NativeWindowTimestampPending{-2};
+
 /**
  * @url https://cs.android.com/android/platform/superproject/+/android11-release:frameworks/native/libs/nativewindow/include/system/window.h;l=198-259;drc=401cda638e7d17f6697b5a65c9a5ad79d056202d
  */
@@ -1,26 +1,57 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <ostream>
+#include <lz4.h>
+#include <range/v3/algorithm.hpp>
+#include <tsl/robin_map.h>
+#include <common/file_descriptor.h>
 #include <os.h>
 #include "pipeline_cache_manager.h"
 
 namespace skyline::gpu {
+    /*  Main file format pseudocode:
+        PipelineCacheFileHeader header;
+        u8 blobs[]; // LZ4-compressed indexed bundles and shader binaries, in any order
+        BlobEntry entries[header.entryCount]; // At header.entryTableOffset
+        BinaryEntry binaries[header.binaryCount]; // At header.binaryTableOffset
+    */
+
     struct PipelineCacheFileHeader {
         static constexpr u32 Magic{util::MakeMagic<u32>("PCHE")}; //!< The magic value used to identify a pipeline cache file
-        static constexpr u32 Version{2}; //!< The version of the pipeline cache file format, MUST be incremented for any format changes
+        static constexpr u32 Version{4}; //!< The version of the pipeline cache file format, MUST be incremented for any format changes
+
+        u32 magic{Magic};
+        u32 version{Version};
+        u32 entryCount{};
+        u32 binaryCount{};
+        u64 entryTableOffset{sizeof(PipelineCacheFileHeader)}; //!< The offset of the table of compressed bundles from the start of the file
+        u64 binaryTableOffset{sizeof(PipelineCacheFileHeader)}; //!< The offset of the table of compressed shader binaries from the start of the file
+    };
+
+    /**
+     * @brief The header of the staging file, this is followed by a flat stream of serialised bundles
+     */
+    struct PipelineCacheStagingFileHeader {
+        static constexpr u32 Magic{util::MakeMagic<u32>("PCST")}; //!< The magic value used to identify a pipeline cache staging file
+        static constexpr u32 Version{2}; //!< The version of the pipeline cache staging file format, MUST be incremented for any format changes
 
         u32 magic{Magic};
         u32 version{Version};
 
-        auto operator<=>(const PipelineCacheFileHeader &) const = default;
+        auto operator<=>(const PipelineCacheStagingFileHeader &) const = default;
     };
 
-    static constexpr PipelineCacheFileHeader ValidPipelineCacheFileHeader{};
+    static constexpr PipelineCacheStagingFileHeader ValidPipelineCacheStagingFileHeader{};
+
+    static constexpr u32 MaxBlobSize{1 << 24}; //!< The maximum decompressed size of a blob (16 MiB), this guards against allocating arbitrary amounts of memory for corrupted entries
 
     void PipelineCacheManager::Run() {
         std::ofstream stream{stagingPath, std::ios::binary | std::ios::trunc};
-        stream.write(reinterpret_cast<const char *>(&ValidPipelineCacheFileHeader), sizeof(PipelineCacheFileHeader));
+        stream.write(reinterpret_cast<const char *>(&ValidPipelineCacheStagingFileHeader), sizeof(PipelineCacheStagingFileHeader));
 
         while (true) {
             std::unique_lock lock(writeMutex);
@@ -35,13 +66,68 @@ namespace skyline::gpu {
         }
     }
 
-    bool PipelineCacheManager::ValidateHeader(std::ifstream &stream) {
+    bool PipelineCacheManager::ValidateStagingHeader(std::ifstream &stream) {
         if (stream.fail())
             return false;
 
-        PipelineCacheFileHeader header{};
+        PipelineCacheStagingFileHeader header{};
         stream.read(reinterpret_cast<char *>(&header), sizeof(header));
-        return header == ValidPipelineCacheFileHeader;
+        return header == ValidPipelineCacheStagingFileHeader;
+    }
+
+    bool PipelineCacheManager::MapMainFile() {
+        FileDescriptor fd{open(mainPath.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (fd == -1)
+            return false;
+
+        struct stat stats{};
+        if (fstat(fd, &stats) == -1 || static_cast<size_t>(stats.st_size) < sizeof(PipelineCacheFileHeader))
+            return false;
+
+        auto pointer{static_cast<u8 *>(mmap(nullptr, static_cast<size_t>(stats.st_size), PROT_READ, MAP_SHARED, fd, 0))};
+        if (pointer == MAP_FAILED)
+            return false;
+        mapping = span<u8>{pointer, static_cast<size_t>(stats.st_size)};
+
+        // Only the header and index tables are validated here, the contents of entries are validated against their checksums when they're read
+        const auto &header{mapping.as<PipelineCacheFileHeader>()};
+        auto tableFits{[this](u64 offset, u64 count, size_t entrySize) {
+            return offset <= mapping.size() && offset % alignof(BlobEntry) == 0 && count <= (mapping.size() - offset) / entrySize;
+        }};
+        if (header.magic != PipelineCacheFileHeader::Magic || header.version != PipelineCacheFileHeader::Version ||
+            !tableFits(header.entryTableOffset, header.entryCount, sizeof(BlobEntry)) || !tableFits(header.binaryTableOffset, header.binaryCount, sizeof(BinaryEntry))) {
+            UnmapMainFile();
+            return false;
+        }
+
+        entries = mapping.subspan(header.entryTableOffset, header.entryCount * sizeof(BlobEntry)).cast<BlobEntry>();
+        binaries = mapping.subspan(header.binaryTableOffset, header.binaryCount * sizeof(BinaryEntry)).cast<BinaryEntry>();
+
+        auto blobFits{[this](const BlobEntry &blob) {
+            return blob.offset <= mapping.size() && blob.compressedSize <= mapping.size() - blob.offset && blob.size <= MaxBlobSize;
+        }};
+        if (!ranges::all_of(entries, blobFits) || !ranges::all_of(binaries, [&](const BinaryEntry &binary) { return blobFits(binary.blob); })) {
+            UnmapMainFile();
+            return false;
+        }
+
+        return true;
+    }
+
+    void PipelineCacheManager::UnmapMainFile() {
+        if (mapping.valid())
+            munmap(mapping.data(), mapping.size());
+
+        mapping = {};
+        entries = {};
+        binaries = {};
+    }
+
+    void PipelineCacheManager::CreateMainFile() {
+        std::filesystem::create_directories(std::filesystem::path{mainPath}.parent_path());
+        std::ofstream stream{mainPath, std::ios::binary | std::ios::trunc};
+        PipelineCacheFileHeader header{};
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(PipelineCacheFileHeader));
     }
 
     void PipelineCacheManager::MergeStaging() {
@@ -49,31 +135,141 @@ namespace skyline::gpu {
         if (stagingStream.fail())
             return; // If the staging file doesn't exist then there's nothing to merge
 
-        if (!ValidateHeader(stagingStream)) {
+        if (!ValidateStagingHeader(stagingStream)) {
             Logger::Warn("Discarding invalid pipeline cache staging file");
             return;
         }
 
-        std::ofstream mainStream{mainPath, std::ios::binary | std::ios::app};
-        mainStream << stagingStream.rdbuf();
+        bool hasInvalidatedEntries{ranges::any_of(entries, [](const BlobEntry &entry) { return entry.size == 0; })};
+        if (stagingStream.peek() == EOF && !hasInvalidatedEntries)
+            return; // The main file doesn't need to be rebuilt if there's nothing staged and nothing to drop
+
+        // The main file is rebuilt into a temporary file which is then renamed over it, so a partially written main file can never be read
+        auto temporaryPath{mainPath + ".tmp"};
+        std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+        PipelineCacheFileHeader header{};
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(PipelineCacheFileHeader));
+
+        std::vector<BlobEntry> newEntries;
+        std::vector<BinaryEntry> newBinaries;
+        tsl::robin_map<u64, u32> binaryIndices; //!< A map from the lower half of the hash of a binary to its index in newBinaries
+
+        // Existing blobs are already compressed so they're copied over verbatim, binaries retain their indices as entries reference them
+        auto copyBlob{[&](BlobEntry blob) {
+            auto data{mapping.subspan(blob.offset, blob.compressedSize)};
+            blob.offset = static_cast<u64>(stream.tellp());
+            stream.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+            return blob;
+        }};
+
+        for (const auto &binary : binaries) {
+            binaryIndices.try_emplace(binary.hashLow, static_cast<u32>(newBinaries.size()));
+            newBinaries.push_back(BinaryEntry{copyBlob(binary.blob), binary.hashLow, binary.hashHigh});
+        }
+
+        for (const auto &entry : entries)
+            if (entry.size)
+                newEntries.push_back(copyBlob(entry));
+
+        std::vector<u8> compressionBuffer;
+        auto writeBlob{[&](span<u8> data) {
+            compressionBuffer.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(data.size()))));
+            int compressedSize{LZ4_compress_default(reinterpret_cast<const char *>(data.data()), reinterpret_cast<char *>(compressionBuffer.data()), static_cast<int>(data.size()), static_cast<int>(compressionBuffer.size()))};
+            if (compressedSize <= 0)
+                throw exception("Failed to compress pipeline cache blob of size 0x{:X}", data.size());
+
+            BlobEntry blob{
+                .offset = static_cast<u64>(stream.tellp()),
+                .compressedSize = static_cast<u32>(compressedSize),
+                .size = static_cast<u32>(data.size()),
+                .checksum = XXH64(compressionBuffer.data(), static_cast<size_t>(compressedSize), 0),
+            };
+            stream.write(reinterpret_cast<const char *>(compressionBuffer.data()), compressedSize);
+            return blob;
+        }};
+
+        size_t stagedCount{};
+        try {
+            interconnect::PipelineStateBundle bundle;
+            while (bundle.Deserialise(stagingStream)) {
+                auto data{bundle.SerialiseIndexed([&](span<u8> binary) {
+                    auto hash{XXH3_128bits(binary.data(), binary.size())};
+                    auto it{binaryIndices.find(hash.low64)};
+                    if (it != binaryIndices.end()) {
+                        const auto &existing{newBinaries[it->second]};
+                        if (existing.hashHigh == hash.high64 && existing.blob.size == binary.size())
+                            return it->second;
+                    }
+
+                    auto index{static_cast<u32>(newBinaries.size())};
+                    newBinaries.push_back(BinaryEntry{writeBlob(binary), hash.low64, hash.high64});
+                    binaryIndices.try_emplace(hash.low64, index);
+                    return index;
+                })};
+
+                newEntries.push_back(writeBlob(data));
+                stagedCount++;
+            }
+        } catch (const exception &e) {
+            Logger::Warn("Discarding pipeline cache staging file contents after {} bundles: {}", stagedCount, e.what());
+        }
+
+        auto writeTable{[&](const auto &table) {
+            while (static_cast<u64>(stream.tellp()) % alignof(BlobEntry))
+                stream.put(0);
+
+            auto offset{static_cast<u64>(stream.tellp())};
+            stream.write(reinterpret_cast<const char *>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(typename std::decay_t<decltype(table)>::value_type)));
+            return offset;
+        }};
+
+        header.entryCount = static_cast<u32>(newEntries.size());
+        header.binaryCount = static_cast<u32>(newBinaries.size());
+        header.entryTableOffset = writeTable(newEntries);
+        header.binaryTableOffset = writeTable(newBinaries);
+        stream.seekp(0);
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(PipelineCacheFileHeader));
+
+        if (stream.fail()) {
+            Logger::Warn("Failed to write the merged pipeline cache file");
+            stream.close();
+            std::filesystem::remove(temporaryPath);
+            return;
+        }
+        stream.close();
+
+        UnmapMainFile();
+        std::filesystem::rename(temporaryPath, mainPath);
+        if (!MapMainFile())
+            throw exception("Merged pipeline cache main file is invalid");
+
+        Logger::Info("Merged {} staged pipelines into the pipeline cache, it contains {} pipelines with {} unique shader binaries", stagedCount, newEntries.size(), newBinaries.size());
+    }
+
+    void PipelineCacheManager::ReadBlob(const BlobEntry &blob, std::vector<u8> &output) {
+        auto data{mapping.subspan(blob.offset, blob.compressedSize)};
+        if (XXH64(data.data(), data.size(), 0) != blob.checksum)
+            throw exception("Pipeline cache blob checksum mismatch at 0x{:X}", blob.offset);
+
+        output.resize(blob.size);
+        if (!blob.size)
+            return;
+
+        if (LZ4_decompress_safe(reinterpret_cast<const char *>(data.data()), reinterpret_cast<char *>(output.data()), static_cast<int>(data.size()), static_cast<int>(output.size())) != static_cast<int>(blob.size))
+            throw exception("Failed to decompress pipeline cache blob at 0x{:X}", blob.offset);
     }
 
     PipelineCacheManager::PipelineCacheManager(const DeviceState &state, const std::string &path)
         : stagingPath{path + ".staging"}, mainPath{path} {
-        bool didExist{std::filesystem::exists(mainPath)};
-        if (didExist) { // If the main file exists then we need to validate it
-            std::ifstream mainStream{mainPath, std::ios::binary};
-            if (!ValidateHeader(mainStream)) { // Force a recreation of the file if it's invalid
-                Logger::Warn("Discarding invalid pipeline cache main file");
-                std::filesystem::remove(mainPath);
-                didExist = false;
-            }
+        if (std::filesystem::exists(mainPath) && !MapMainFile()) { // Force a recreation of the file if it's invalid
+            Logger::Warn("Discarding invalid pipeline cache main file");
+            std::filesystem::remove(mainPath);
         }
 
-        if (!didExist) { // If the main file didn't exist we need to write the header
-            std::filesystem::create_directories(std::filesystem::path{mainPath}.parent_path());
-            std::ofstream mainStream{mainPath, std::ios::binary | std::ios::app};
-            mainStream.write(reinterpret_cast<const char *>(&ValidPipelineCacheFileHeader), sizeof(PipelineCacheFileHeader));
+        if (!mapping.valid()) {
+            CreateMainFile();
+            if (!MapMainFile())
+                throw exception("Failed to create the pipeline cache main file");
         }
 
         // Merge any staging changes into the main file before starting the writer thread
@@ -81,21 +277,42 @@ namespace skyline::gpu {
         writerThread = std::thread(&PipelineCacheManager::Run, this);
     }
 
+    PipelineCacheManager::~PipelineCacheManager() {
+        UnmapMainFile();
+    }
+
     void PipelineCacheManager::QueueWrite(std::unique_ptr<interconnect::PipelineStateBundle> bundle) {
         std::scoped_lock lock{writeMutex};
         writeQueue.emplace(std::move(bundle));
         writeCondition.notify_one();
     }
 
-    std::ifstream PipelineCacheManager::OpenReadStream() {
-        auto mainStream{std::ifstream{mainPath, std::ios::binary}};
-        if (!ValidateHeader(mainStream))
-            throw exception("Pipeline cache main file corrupted at runtime!");
+    u32 PipelineCacheManager::GetEntryCount() {
+        return static_cast<u32>(entries.size());
+    }
+
+    bool PipelineCacheManager::ReadEntry(u32 index, interconnect::PipelineStateBundle &bundle) {
+        const auto &entry{entries[index]};
+        if (!entry.size)
+            return false;
+
+        std::vector<u8> data;
+        ReadBlob(entry, data);
+        bundle.DeserialiseIndexed(span(data), [this](u32 binaryIndex, std::vector<u8> &output) {
+            if (binaryIndex >= binaries.size())
+                throw exception("Pipeline cache binary index out of range: {}", binaryIndex);
 
-        return mainStream;
+            ReadBlob(binaries[binaryIndex].blob, output);
+        });
+        return true;
     }
 
-    void PipelineCacheManager::InvalidateAllAfter(u64 offset) {
-        std::filesystem::resize_file(mainPath, offset);
+    void PipelineCacheManager::InvalidateEntry(u32 index) {
+        // The entry's size is zeroed in the file directly, the shared mapping will reflect this immediately
+        u32 size{};
+        auto offset{static_cast<off_t>(reinterpret_cast<u8 *>(&entries[index].size) - mapping.data())};
+        FileDescriptor fd{open(mainPath.c_str(), O_WRONLY | O_CLOEXEC)};
+        if (fd == -1 || pwrite(fd, &size, sizeof(size), offset) != sizeof(size))
+            Logger::Warn("Failed to invalidate pipeline cache entry {}: {}", index, strerror(errno));
     }
 }
@@ -10,9 +10,34 @@
 namespace skyline::gpu {
     /**
      * @brief Manages access and validation of the underlying pipeline cache files
+     * @note The main file is an indexed container of LZ4-compressed bundles with deduplicated shader binaries, it's memory-mapped and entries are only decompressed when they're read
+     * @note Bundles are appended to an uncompressed staging file at runtime which is merged into the main file on the next boot
      */
     class PipelineCacheManager {
       private:
+        /**
+         * @brief An LZ4-compressed blob of data in the main file
+         * @note This struct *MUST* not be modified without a pipeline cache version bump
+         */
+        struct BlobEntry {
+            u64 offset; //!< The offset of the compressed data from the start of the file
+            u32 compressedSize;
+            u32 size; //!< The size of the decompressed data, a size of 0 denotes an invalidated entry
+            u64 checksum; //!< An XXH64 hash of the compressed data
+        };
+        static_assert(sizeof(BlobEntry) == 0x18);
+
+        /**
+         * @brief A shader binary in the main file which can be shared by any amount of bundles
+         * @note This struct *MUST* not be modified without a pipeline cache version bump
+         */
+        struct BinaryEntry {
+            BlobEntry blob;
+            u64 hashLow; //!< The lower half of an XXH3-128 hash of the decompressed binary, this is used for deduplication
+            u64 hashHigh; //!< The upper half of an XXH3-128 hash of the decompressed binary
+        };
+        static_assert(sizeof(BinaryEntry) == 0x28);
+
         std::thread writerThread;
         std::queue<std::unique_ptr<interconnect::PipelineStateBundle>> writeQueue; //!< The queue of pipeline state bundles to be written to the cache
         std::mutex writeMutex; //!< Protects access to the write queue
@@ -20,25 +45,69 @@ namespace skyline::gpu {
         std::string stagingPath; //!< The path to the staging pipeline cache file, which will be actively written to at runtime
         std::string mainPath; //!< The path to the main pipeline cache file
 
+        span<u8> mapping; //!< A read-only mapping of the entire main file
+        span<BlobEntry> entries; //!< The index of all bundles in the main file, this is a view into the mapping
+        span<BinaryEntry> binaries; //!< The index of all shader binaries in the main file, this is a view into the mapping
+
         void Run();
 
-        bool ValidateHeader(std::ifstream &stream);
+        bool ValidateStagingHeader(std::ifstream &stream);
+
+        /**
+         * @brief Maps the main file and validates its header and index tables
+         * @return If the main file was valid, it'll be unmapped if it wasn't
+         */
+        bool MapMainFile();
+
+        void UnmapMainFile();
+
+        /**
+         * @brief Writes an empty main file containing no entries
+         */
+        void CreateMainFile();
 
+        /**
+         * @brief Rebuilds the main file with all valid entries from the current main file and the staging file
+         */
         void MergeStaging();
 
+        /**
+         * @brief Validates and decompresses a blob from the main file into the supplied vector
+         */
+        void ReadBlob(const BlobEntry &blob, std::vector<u8> &output);
+
       public:
         PipelineCacheManager(const DeviceState &state, const std::string &path);
 
+        ~PipelineCacheManager();
+
         /**
          * @brief Queues a pipeline state bundle to be written to the cache
          */
         void QueueWrite(std::unique_ptr<interconnect::PipelineStateBundle> bundle);
 
-        std::ifstream OpenReadStream();
+        /**
+         * @return The amount of entries in the main file, including invalidated ones
+         */
+        u32 GetEntryCount();
+
+        /**
+         * @return The size of the mapping of the main file in bytes, this is file-backed so it can be reclaimed by the host without being written out
+         */
+        size_t GetMappedSize() {
+            return mapping.size();
+        }
+
+        /**
+         * @brief Decompresses the entry at the supplied index into the bundle
+         * @return If the entry was read, this will be false for invalidated entries
+         * @note An exception will be thrown if the entry is corrupted, it should be invalidated with InvalidateEntry in that case
+         */
+        bool ReadEntry(u32 index, interconnect::PipelineStateBundle &bundle);
 
         /**
-         * @brief Shrinks the pipeline cache file to `offset` bytes, removing any (potentially invalid) data after that point
+         * @brief Marks the entry at the supplied index as invalid in the main file, it'll be skipped on reads and dropped during the next merge
          */
-        void InvalidateAllAfter(u64 offset);
+        void InvalidateEntry(u32 index);
     };
 }
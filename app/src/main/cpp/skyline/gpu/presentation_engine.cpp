@@ -5,6 +5,9 @@
 #include <android/choreographer.h>
 #include <common/settings.h>
 #include <common/signal.h>
+#include <common/frame_statistics.h>
+#include <common/memory_report.h>
+#include <common/performance_hint.h>
 #include <jvm.h>
 #include <gpu.h>
 #include <soc.h>
@@ -17,6 +20,8 @@
 extern jint Fps;
 extern jfloat AverageFrametimeMs;
 extern jfloat AverageFrametimeDeviationMs;
+extern jfloat AveragePresentLatencyMs;
+extern jint DroppedFrames;
 
 namespace skyline::gpu {
     using namespace service::hosbinder;
@@ -27,7 +32,11 @@ namespace skyline::gpu {
           presentSemaphores{util::MakeFilledArray<vk::raii::Semaphore, MaxSwapchainImageCount>(gpu.vkDevice, vk::SemaphoreCreateInfo{})},
           acquireSemaphores{util::MakeFilledArray<vk::raii::Semaphore, MaxSwapchainImageCount>(gpu.vkDevice, vk::SemaphoreCreateInfo{})},
           presentationTrack{static_cast<u64>(trace::TrackIds::Presentation), perfetto::ProcessTrack::Current()},
+          thermalGovernor{*state.settings},
+          flightRecorder{FlightRecorder::Create(state)},
+          benchmark{Benchmark::Create(state)},
           vsyncEvent{std::make_shared<kernel::type::KEvent>(state, true)},
+          lowLatency{*state.settings->lowLatencyPresentation},
           choreographerThread{&PresentationEngine::ChoreographerThread, this},
           presentationThread{&PresentationEngine::PresentationThread, this} {
         auto desc{presentationTrack.Serialize()};
@@ -92,17 +101,65 @@ namespace skyline::gpu {
         }
     }
 
+    void PresentationEngine::UpdatePresentTiming() {
+        while (pendingFrameTimingCount) {
+            auto &timing{pendingFrameTimings[pendingFrameTimingStart]};
+
+            i64 displayPresentTime{};
+            int result{window->perform(window, NATIVE_WINDOW_GET_FRAME_TIMESTAMPS, timing.frameId, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &displayPresentTime, nullptr, nullptr)};
+            if (!result && displayPresentTime == NativeWindowTimestampPending)
+                return; // Frames are displayed in order so any subsequent frames will also be pending
+
+            pendingFrameTimingStart = (pendingFrameTimingStart + 1) % MaxPendingFrameTimings;
+            pendingFrameTimingCount--;
+
+            if (result || displayPresentTime == NativeWindowTimestampInvalid)
+                continue; // The frame was either dropped by the compositor or its timestamps have been evicted
+
+            auto weightedAverage{[](auto weight, auto previousAverage, auto current) {
+                return (((weight - 1) * previousAverage) + current) / weight;
+            }};
+
+            averagePresentLatencyNs = weightedAverage(Fps ? Fps : 1, averagePresentLatencyNs, displayPresentTime - timing.queueTime);
+            AveragePresentLatencyMs = static_cast<jfloat>(averagePresentLatencyNs) / constant::NsInMillisecond;
+
+            // A frame is considered to be dropped when it was displayed on a refresh later than the one it was scheduled for
+            i64 halfRefreshCycle{refreshCycleDuration / 2};
+            if (timing.requestedTime ? (displayPresentTime > timing.requestedTime + refreshCycleDuration + halfRefreshCycle)
+                                     : (lastDisplayPresentTime && timing.expectedInterval && displayPresentTime - lastDisplayPresentTime > timing.expectedInterval + halfRefreshCycle)) {
+                DroppedFrames = static_cast<jint>(++droppedFrameCount);
+                TRACE_EVENT_INSTANT("gpu", "Dropped Frame", presentationTrack, "FrameId", timing.frameId, "LatenessNs", displayPresentTime - std::max(timing.requestedTime, lastDisplayPresentTime + timing.expectedInterval));
+            }
+
+            lastDisplayPresentTime = displayPresentTime;
+        }
+    }
+
+    i64 PresentationEngine::PredictRefreshTime(i64 timestamp) {
+        // Actual display timestamps are the most accurate source for the refresh phase, the choreographer's timestamps are used prior to any being available
+        i64 phase{lastDisplayPresentTime ? lastDisplayPresentTime : lastChoreographerTime};
+        if (!refreshCycleDuration || timestamp <= phase)
+            return phase;
+
+        return phase + util::AlignUpNpot(timestamp - phase, refreshCycleDuration);
+    }
+
     void PresentationEngine::PresentFrame(const PresentableFrame &frame) {
         std::unique_lock lock(mutex);
         surfaceCondition.wait(lock, [this]() { return vkSurface.has_value(); });
 
+        auto waitStart{static_cast<u64>(util::GetTimeNs())};
         frame.fence.Wait(state.soc->host1x);
+        FrameStatistics::Record(FrameStatistics::Phase::PresentWait, static_cast<u64>(util::GetTimeNs()) - waitStart);
 
         std::scoped_lock textureLock(*frame.textureView);
 
         auto texture{frame.textureView->texture};
-        if (frame.textureView->format != swapchainFormat || texture->dimensions != swapchainExtent)
-            UpdateSwapchain(frame.textureView->format, texture->dimensions);
+
+        // Textures rendered at a scaled resolution are upscaled to the guest resolution when copied into the swapchain image, the crop is also specified in guest coordinates
+        texture::Dimensions extent{texture->guest ? texture->guest->dimensions : texture->dimensions};
+        if (frame.textureView->format != swapchainFormat || extent != swapchainExtent)
+            UpdateSwapchain(frame.textureView->format, extent);
 
         int result;
         if (frame.crop && frame.crop != windowCrop) {
@@ -123,6 +180,7 @@ namespace skyline::gpu {
 
         auto &acquireSemaphore{acquireSemaphores[frameIndex]};
         auto &frameFence{frameFences[frameIndex]};
+        waitStart = static_cast<u64>(util::GetTimeNs());
         if (frameFence)
             frameFence->Wait();
 
@@ -135,16 +193,18 @@ namespace skyline::gpu {
             else
                 throw exception("vkAcquireNextImageKHR returned an unhandled result '{}'", vk::to_string(nextImage.first));
         }
+        FrameStatistics::Record(FrameStatistics::Phase::PresentWait, static_cast<u64>(util::GetTimeNs()) - waitStart);
 
         auto &nextImageTexture{images.at(nextImage.second)};
         auto &presentSemaphore{presentSemaphores[nextImage.second]};
 
         texture->SynchronizeHost();
+        // The swapchain is always recreated to match the extent of the frame, so the copy overwrites the entire image and its prior contents never need to be retained
         nextImageTexture->CopyFrom(texture, *acquireSemaphore, *presentSemaphore, swapchainFormat, vk::ImageSubresourceRange{
             .aspectMask = vk::ImageAspectFlagBits::eColor,
             .levelCount = 1,
             .layerCount = 1,
-        });
+        }, true);
 
         frameFence = nextImageTexture->cycle;
 
@@ -155,7 +215,8 @@ namespace skyline::gpu {
             return (time.tv_sec * constant::NsInSecond) + time.tv_nsec;
         }};
 
-        i64 timestamp{frame.timestamp};
+        // Frames are presented as soon as possible in low-latency mode as any pacing would delay the newest frame
+        i64 timestamp{lowLatency ? 0 : frame.timestamp};
         if (timestamp) {
             // If the timestamp is specified, we need to convert it from the util::GetTimeNs base to the CLOCK_MONOTONIC one
             // We do so by getting an offset from the current time in nanoseconds and then adding it to the current time in CLOCK_MONOTONIC
@@ -168,9 +229,11 @@ namespace skyline::gpu {
             }
         }
 
-        if (frame.swapInterval) {
+        UpdatePresentTiming();
+
+        if (frame.swapInterval && !lowLatency) {
             // If we have a swap interval, we have to adjust the timestamp to emulate the swap interval
-            i64 lastFramePresentTime{util::AlignUpNpot(windowLastTimestamp, refreshCycleDuration)};
+            i64 lastFramePresentTime{PredictRefreshTime(windowLastTimestamp)};
             if (lastFramePresentTime > lastChoreographerTime)
                 // If the last frame was presented after the last choreographer callback, calculate the new frame's timestamp relative to it
                 timestamp = std::max(timestamp, lastFramePresentTime + (refreshCycleDuration * frame.swapInterval));
@@ -179,6 +242,10 @@ namespace skyline::gpu {
                 timestamp = std::max(timestamp, lastChoreographerTime + (2 * refreshCycleDuration * frame.swapInterval));
         }
 
+        if (timestamp > 0 && refreshCycleDuration)
+            // Timestamps close to a refresh can flip between it and the next one with slight timing variations which results in judder, targeting the middle of the prior refresh cycle avoids this
+            timestamp = PredictRefreshTime(timestamp) - (refreshCycleDuration / 2);
+
         i64 lastTimestamp{std::exchange(windowLastTimestamp, timestamp)};
         if (!timestamp && lastTimestamp)
             // We need to nullify the timestamp if it transitioned from being specified (non-zero) to unspecified (zero)
@@ -202,6 +269,18 @@ namespace skyline::gpu {
             }); // We don't care about suboptimal images as they are caused by not respecting the transform hint, we handle transformations externally
         }
 
+        if (pendingFrameTimingCount == MaxPendingFrameTimings) {
+            // Discard the oldest frame's timing if the compositor hasn't caught up with us
+            pendingFrameTimingStart = (pendingFrameTimingStart + 1) % MaxPendingFrameTimings;
+            pendingFrameTimingCount--;
+        }
+        pendingFrameTimings[(pendingFrameTimingStart + pendingFrameTimingCount++) % MaxPendingFrameTimings] = PendingFrameTiming{
+            .frameId = frameId,
+            .queueTime = getMonotonicNsNow(),
+            .requestedTime = timestamp > 0 ? timestamp : 0,
+            .expectedInterval = refreshCycleDuration * frame.swapInterval,
+        };
+
         timestamp = (timestamp && !*state.settings->disableFrameThrottling) ? timestamp : getMonotonicNsNow(); // We tie FPS to the submission time rather than presentation timestamp, if we don't have the presentation timestamp available or if frame throttling is disabled as we want the maximum measured FPS to not be restricted to the refresh rate
         if (frameTimestamp) {
             i64 sampleWeight{Fps ? Fps : 1}; //!< The weight of each sample in calculating the average, we want to roughly average the past second
@@ -226,6 +305,24 @@ namespace skyline::gpu {
         } else {
             frameTimestamp = timestamp;
         }
+
+        auto frameRecord{FrameStatistics::EndFrame(static_cast<u64>(util::GetTimeNs()))};
+
+        // The threads in the performance hint session are pipelined with each other, so the work duration of the frame is that of the busiest phase
+        // Guest CPU time is summed across all guest threads so it's clamped to the frametime to avoid overstating the work
+        const auto &phaseNs{frameRecord.phaseNs};
+        u64 workNs{std::max({phaseNs[static_cast<size_t>(FrameStatistics::Phase::GuestCpu)], phaseNs[static_cast<size_t>(FrameStatistics::Phase::GpfifoDecode)], phaseNs[static_cast<size_t>(FrameStatistics::Phase::CommandRecording)]})};
+        i64 targetFrametimeNs{refreshCycleDuration * std::max<i64>(frame.swapInterval, 1)};
+        host::PerformanceHint::Get().ReportFrame(targetFrametimeNs, static_cast<i64>(std::min(workNs, frameRecord.frametimeNs)));
+        thermalGovernor.OnFrame(frameRecord.timestamp, frameRecord.frametimeNs, static_cast<u64>(std::max<i64>(targetFrametimeNs, 0)));
+        if (flightRecorder)
+            flightRecorder->OnFrame(frameRecord.timestamp, frameRecord.frametimeNs);
+        if (benchmark)
+            benchmark->OnFrame(frameRecord);
+        gpu.TraceCounters();
+        MemoryReport::TraceCounters(state);
+        if (auto &capture{state.soc->gpfifoCapture}) [[unlikely]]
+            capture->WriteFrameEnd(frameRecord);
     }
 
     void PresentationEngine::PresentationThread() {
@@ -235,12 +332,28 @@ namespace skyline::gpu {
         try {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, signal::ExceptionalSignalHandler);
 
-            presentQueue.Process([this](const PresentableFrame &frame) {
+            auto presentFrame{[this](const PresentableFrame &frame) {
                 PresentFrame(frame);
                 frame.presentCallback(); // We're calling the callback here as it's outside of all the locks in PresentFrame
                 skipSignal = true;
                 vsyncEvent->Signal();
-            }, [] {});
+            }};
+
+            if (lowLatency) {
+                while (true) {
+                    PresentableFrame frame{[this] {
+                        std::unique_lock lock{mailboxMutex};
+                        mailboxCondition.wait(lock, [this] { return mailboxFrame.has_value(); });
+                        PresentableFrame newestFrame{std::move(*mailboxFrame)};
+                        mailboxFrame.reset();
+                        return newestFrame;
+                    }()};
+
+                    presentFrame(frame);
+                }
+            } else {
+                presentQueue.Process(presentFrame, [] {});
+            }
         } catch (const signal::SignalException &e) {
             Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
             if (state.process)
@@ -304,10 +417,15 @@ namespace skyline::gpu {
         if ((capabilities.supportedUsageFlags & presentUsage) != presentUsage)
             throw exception("Swapchain doesn't support image usage '{}': {}", vk::to_string(presentUsage), vk::to_string(capabilities.supportedUsageFlags));
 
-        auto requestedMode{*state.settings->disableFrameThrottling ? vk::PresentModeKHR::eMailbox : vk::PresentModeKHR::eFifo};
+        auto requestedMode{(*state.settings->disableFrameThrottling || lowLatency) ? vk::PresentModeKHR::eMailbox : vk::PresentModeKHR::eFifo};
         auto modes{gpu.vkPhysicalDevice.getSurfacePresentModesKHR(**vkSurface)};
-        if (std::find(modes.begin(), modes.end(), requestedMode) == modes.end())
-            throw exception("Swapchain doesn't support present mode: {}", vk::to_string(requestedMode));
+        if (std::find(modes.begin(), modes.end(), requestedMode) == modes.end()) {
+            if (lowLatency && !*state.settings->disableFrameThrottling)
+                // FIFO is always supported, frames will still be presented at the next refresh as there's only ever a single pending frame
+                requestedMode = vk::PresentModeKHR::eFifo;
+            else
+                throw exception("Swapchain doesn't support present mode: {}", vk::to_string(requestedMode));
+        }
 
         vkSwapchain.emplace(gpu.vkDevice, vk::SwapchainCreateInfoKHR{
             .surface = **vkSurface,
@@ -354,6 +472,10 @@ namespace skyline::gpu {
 
         vkSwapchain.reset();
 
+        // Frame IDs are specific to a window so any timings that are pending can't be read back anymore
+        pendingFrameTimingCount = 0;
+        lastDisplayPresentTime = 0;
+
         if (jSurface) {
             window = ANativeWindow_fromSurface(env, jSurface);
             vkSurface.emplace(gpu.vkInstance, vk::AndroidSurfaceCreateInfoKHR{
@@ -398,7 +520,7 @@ namespace skyline::gpu {
             surfaceCondition.wait(lock, [this] { return vkSurface.has_value(); });
         }
 
-        presentQueue.Push(PresentableFrame{
+        PresentableFrame frame{
             texture,
             fence,
             timestamp,
@@ -408,7 +530,24 @@ namespace skyline::gpu {
             crop,
             scalingMode,
             transform
-        });
+        };
+
+        if (lowLatency) {
+            std::optional<PresentableFrame> replacedFrame;
+            {
+                std::scoped_lock lock{mailboxMutex};
+                replacedFrame = std::exchange(mailboxFrame, std::move(frame));
+            }
+            mailboxCondition.notify_one();
+
+            if (replacedFrame) {
+                // The replaced frame will never be presented, its buffer is returned to the guest immediately so it never has to wait on presentation
+                TRACE_EVENT_INSTANT("gpu", "Replaced Frame", presentationTrack, "FrameId", replacedFrame->id);
+                replacedFrame->presentCallback();
+            }
+        } else {
+            presentQueue.Push(std::move(frame));
+        }
 
         return nextFrameId++;
     }
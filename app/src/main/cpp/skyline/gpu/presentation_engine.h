@@ -7,9 +7,12 @@
 #include <android/looper.h>
 #include <common/trace.h>
 #include <common/circular_queue.h>
+#include <common/flight_recorder.h>
+#include <common/benchmark.h>
 #include <kernel/types/KEvent.h>
 #include <services/hosbinder/GraphicBufferProducer.h>
 #include "texture/texture.h"
+#include "thermal_governor.h"
 
 struct ANativeWindow;
 
@@ -49,7 +52,28 @@ namespace skyline::gpu {
         i64 frameTimestamp{}; //!< The timestamp of the last frame being shown in nanoseconds
         i64 averageFrametimeNs{}; //!< The average time between frames in nanoseconds
         i64 averageFrametimeDeviationNs{}; //!< The average deviation of frametimes in nanoseconds
+        i64 averagePresentLatencyNs{}; //!< The average time between a frame being queued to the window and it being displayed in nanoseconds
+        u32 droppedFrameCount{}; //!< The amount of frames that were displayed later than the refresh they were scheduled for
+        i64 lastDisplayPresentTime{}; //!< The CLOCK_MONOTONIC timestamp at which the last presented frame was actually displayed, this is aligned to the display's refresh cycle
+
+        /**
+         * @brief The timing information of a frame that has been queued to the window but has yet to have its display timestamp read back
+         */
+        struct PendingFrameTiming {
+            u64 frameId; //!< The ID of the frame in the window, this isn't the same as PresentableFrame::id
+            i64 queueTime; //!< The CLOCK_MONOTONIC timestamp at which the frame was queued
+            i64 requestedTime; //!< The CLOCK_MONOTONIC timestamp that the frame was requested to be displayed at, 0 if unspecified
+            i64 expectedInterval; //!< The expected interval between the prior displayed frame and this one, 0 if unspecified
+        };
+
+        static constexpr size_t MaxPendingFrameTimings{8}; //!< The maximum amount of frames that can be awaiting timing feedback, older ones are discarded
+        std::array<PendingFrameTiming, MaxPendingFrameTimings> pendingFrameTimings{};
+        size_t pendingFrameTimingStart{}; //!< The index of the oldest entry in `pendingFrameTimings`
+        size_t pendingFrameTimingCount{};
         perfetto::Track presentationTrack; //!< Perfetto track used for presentation events
+        ThermalGovernor thermalGovernor; //!< Adjusts settings based on the thermal status and frametimes of presented frames
+        std::unique_ptr<FlightRecorder> flightRecorder; //!< Captures the trace events leading up to frametime spikes, this is null unless it's enabled
+        std::unique_ptr<Benchmark> benchmark; //!< Records the performance of every frame and stops emulation after a fixed amount of them, this is null unless a benchmark was configured
 
       public:
         std::atomic<bool> skipSignal; //!< If true, the next signal will be skipped by the choreographer thread
@@ -78,6 +102,11 @@ namespace skyline::gpu {
         std::thread presentationThread; //!< A thread for asynchronously presenting queued frames after their corresponded fences are signalled
         static constexpr size_t PresentQueueFrameCount{5}; //!< The amount of frames the presentation queue can hold
         CircularQueue<PresentableFrame> presentQueue{PresentQueueFrameCount}; //!< A circular queue containing all the frames that we can present
+
+        bool lowLatency; //!< If frames are presented through `mailboxFrame` rather than `presentQueue`, this is fixed for the lifetime of the engine
+        std::mutex mailboxMutex; //!< Synchronizes access to `mailboxFrame`
+        std::condition_variable mailboxCondition; //!< Signalled when a frame is placed into `mailboxFrame`
+        std::optional<PresentableFrame> mailboxFrame; //!< The newest frame that has yet to be presented in low-latency mode, it is replaced by any newer frames
         size_t nextFrameId{1}; //!< The frame ID to use for the next frame
 
         /**
@@ -90,6 +119,17 @@ namespace skyline::gpu {
          */
         void ChoreographerThread();
 
+        /**
+         * @brief Reads back the display timestamps of previously queued frames to update the present latency and dropped frame statistics
+         * @note 'PresentationEngine::mutex' **must** be locked prior to calling this
+         */
+        void UpdatePresentTiming();
+
+        /**
+         * @return The CLOCK_MONOTONIC timestamp of the first display refresh at or after the supplied timestamp, predicted from the phase of the last observed refresh
+         */
+        i64 PredictRefreshTime(i64 timestamp);
+
         /**
          * @brief Submits a single frame to the host API for presentation with the appropriate waits and copies
          */
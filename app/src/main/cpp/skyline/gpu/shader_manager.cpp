@@ -1,10 +1,15 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <charconv>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
 #include <range/v3/algorithm.hpp>
 #include <boost/functional/hash.hpp>
 #include <gpu.h>
 #include <common/settings.h>
+#include <common/frame_statistics.h>
 #include <shader_compiler/common/settings.h>
 #include <shader_compiler/common/log.h>
 #include <shader_compiler/frontend/maxwell/translate_program.h>
@@ -29,30 +34,124 @@ namespace Shader::Log {
 }
 
 namespace skyline::gpu {
+    bool ShaderManager::LoadShaderReplacement(const std::filesystem::path &path, bool reload) {
+        // Parse hash from filename, any files which aren't named by a hash such as temporary files from editors are ignored
+        u64 hash;
+        auto filename{path.filename().string()};
+        auto result{std::from_chars(filename.data(), filename.data() + filename.size(), hash, 16)};
+        if (result.ec != std::errc{} || result.ptr != filename.data() + filename.size())
+            return false;
+
+        ReplacementBinary replacement;
+        if (std::filesystem::is_regular_file(path)) {
+            // Read file into a new binary, the previous binary may still be in use by a translation
+            std::ifstream file{path, std::ios::binary | std::ios::ate};
+            std::vector<u8> binary(static_cast<size_t>(file.tellg()));
+            file.seekg(0, std::ios::beg);
+            file.read(reinterpret_cast<char *>(binary.data()), static_cast<std::streamsize>(binary.size()));
+            replacement = std::make_shared<const std::vector<u8>>(std::move(binary));
+        }
+
+        std::unique_lock lock{replacementMutex};
+        if (replacement)
+            shaderReplacements[hash] = std::move(replacement);
+        else if (!shaderReplacements.erase(hash))
+            return true;
+
+        if (reload) {
+            u32 generation{replacementGeneration.load(std::memory_order_relaxed) + 1};
+            replacementReloads.emplace_back(generation, hash);
+            replacementGeneration.store(generation, std::memory_order_release);
+            Logger::Info("Reloaded shader replacement for hash: 0x{:X}", hash);
+        }
+
+        return true;
+    }
+
     void ShaderManager::LoadShaderReplacements(std::string_view replacementDir) {
-        std::filesystem::path replacementDirPath{replacementDir};
-        if (std::filesystem::exists(replacementDirPath)) {
-            for (const auto &entry : std::filesystem::directory_iterator{replacementDirPath}) {
-                if (entry.is_regular_file()) {
-                    // Parse hash from filename
-                    u64 hash{std::stoull(entry.path().filename().string(), nullptr, 16)};
-                    auto it{shaderReplacements.insert({hash, {}})};
-
-                    // Read file into map entry
-                    std::ifstream file{entry.path(), std::ios::binary | std::ios::ate};
-                    it.first->second.resize(static_cast<size_t>(file.tellg()));
-                    file.seekg(0, std::ios::beg);
-                    file.read(reinterpret_cast<char *>(it.first->second.data()), static_cast<std::streamsize>(it.first->second.size()));
-                }
+        replacementPath = replacementDir;
+        if (std::filesystem::exists(replacementPath)) {
+            for (const auto &entry : std::filesystem::directory_iterator{replacementPath})
+                if (entry.is_regular_file())
+                    LoadShaderReplacement(entry.path(), false);
+
+            // Watch the directory for any changes so replacements can be iterated on without restarting the application
+            replacementWatchFd = inotify_init1(IN_CLOEXEC);
+            if (replacementWatchFd < 0 || inotify_add_watch(replacementWatchFd, replacementPath.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0) {
+                Logger::Warn("Failed to watch the shader replacement directory: {}", strerror(errno));
+                if (replacementWatchFd >= 0)
+                    close(replacementWatchFd);
+                replacementWatchFd = -1;
+                return;
             }
+
+            replacementStopFd = eventfd(0, EFD_CLOEXEC);
+            replacementWatcher = std::thread{&ShaderManager::ReplacementWatcherThread, this};
         }
     }
 
-    span<u8> ShaderManager::ProcessShaderBinary(u64 hash, span<u8> binary) {
-        auto it{shaderReplacements.find(hash)};
-        if (it != shaderReplacements.end()) {
+    void ShaderManager::ReplacementWatcherThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-ShaderWatch")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        std::array<pollfd, 2> fds{
+            pollfd{.fd = replacementWatchFd, .events = POLLIN},
+            pollfd{.fd = replacementStopFd, .events = POLLIN},
+        };
+        alignas(inotify_event) std::array<u8, 4096> buffer;
+        while (true) {
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                Logger::Warn("Failed to poll the shader replacement directory: {}", strerror(errno));
+                return;
+            }
+
+            if (fds[1].revents)
+                return;
+
+            auto length{read(replacementWatchFd, buffer.data(), buffer.size())};
+            if (length <= 0)
+                continue;
+
+            for (u8 *it{buffer.data()}; it < buffer.data() + length;) {
+                auto &event{*reinterpret_cast<inotify_event *>(it)};
+                if (event.len && !(event.mask & IN_ISDIR))
+                    LoadShaderReplacement(replacementPath / event.name, true);
+                it += sizeof(inotify_event) + event.len;
+            }
+        }
+    }
+
+    std::vector<u64> ShaderManager::GetReloadedReplacements(u32 generation) {
+        std::shared_lock lock{replacementMutex};
+        std::vector<u64> hashes;
+        for (const auto &[reloadGeneration, hash] : replacementReloads)
+            if (reloadGeneration > generation)
+                hashes.push_back(hash);
+        return hashes;
+    }
+
+    ShaderManager::ObjectPools &ShaderManager::GetThreadPools() {
+        thread_local ObjectPools pools;
+        return pools;
+    }
+
+    span<u8> ShaderManager::ProcessShaderBinary(u64 hash, span<u8> binary, ReplacementBinary &replacement, u64 *replacementKey) {
+        {
+            std::shared_lock lock{replacementMutex};
+            auto it{shaderReplacements.find(hash)};
+            if (it != shaderReplacements.end())
+                replacement = it->second;
+        }
+
+        if (replacementKey)
+            *replacementKey = replacement ? XXH3_64bits(replacement->data(), replacement->size()) : 0;
+
+        if (replacement) {
             Logger::Info("Replacing shader with hash: 0x{:X}", hash);
-            return it->second;
+            // The binary is only read by the shader compiler, the span is non-const to match the guest binary interface
+            return span<u8>{const_cast<u8 *>(replacement->data()), replacement->size()};
         }
 
         if (DumpShaders) {
@@ -68,7 +167,79 @@ namespace skyline::gpu {
         return binary;
     }
 
-    ShaderManager::ShaderManager(const DeviceState &state, GPU &gpu, std::string_view replacementDir, std::string_view dumpDir) : gpu{gpu}, dumpPath{dumpDir} {
+    struct SpirvCacheFileHeader {
+        static constexpr u32 Magic{util::MakeMagic<u32>("SPVC")}; //!< The magic value used to identify a SPIR-V cache file
+        static constexpr u32 Version{1}; //!< The version of the SPIR-V cache file format, MUST be incremented for any format changes or changes to the emitted SPIR-V
+
+        u32 magic{Magic};
+        u32 version{Version};
+        u64 hostKey; //!< A hash of all host state that affects the emitted SPIR-V, the cache is discarded if this doesn't match
+    };
+
+    /**
+     * @brief The header of an entry in the SPIR-V cache file, this is followed by the SPIR-V words
+     */
+    struct SpirvCacheEntryHeader {
+        u64 key;
+        u64 checksum; //!< An XXH64 hash of the bindings and SPIR-V
+        u32 spirvWordCount;
+        Shader::Backend::Bindings bindings;
+    };
+    static_assert(std::has_unique_object_representations_v<Shader::Backend::Bindings>);
+
+    static constexpr u32 MaxSpirvWordCount{1 << 22}; //!< The maximum size of a single cached SPIR-V module (16 MiB), this guards against allocating arbitrary amounts of memory for corrupted entries
+
+    void ShaderManager::LoadSpirvCache(const DeviceState &state, const std::string &path) {
+        // The emitted SPIR-V depends on the profile which is derived from the device, driver and settings
+        u64 hostKey{HashCacheKey(0, std::array<u32, 3>{gpu.traits.vendorId, gpu.traits.deviceId, gpu.traits.driverVersion})};
+        hostKey = HashCacheKey(hostKey, gpu.traits.pipelineCacheUuid);
+        hostKey = XXH3_64bits_withSeed((*state.settings->gpuDriver).data(), (*state.settings->gpuDriver).size(), hostKey);
+        hostKey = HashCacheKey(hostKey, *state.settings->disableSubgroupShuffle);
+        SpirvCacheFileHeader expectedHeader{.hostKey = hostKey};
+
+        i64 lastKnownGoodOffset{};
+        if (std::ifstream stream{path, std::ios::binary}; stream.good()) {
+            SpirvCacheFileHeader header{};
+            stream.read(reinterpret_cast<char *>(&header), sizeof(SpirvCacheFileHeader));
+            if (!stream.fail() && header.magic == expectedHeader.magic && header.version == expectedHeader.version && header.hostKey == expectedHeader.hostKey) {
+                lastKnownGoodOffset = stream.tellg();
+
+                SpirvCacheEntryHeader entryHeader{};
+                while (stream.read(reinterpret_cast<char *>(&entryHeader), sizeof(SpirvCacheEntryHeader))) {
+                    if (entryHeader.spirvWordCount > MaxSpirvWordCount)
+                        break;
+
+                    SpirvCacheEntry entry{std::vector<u32>(entryHeader.spirvWordCount), entryHeader.bindings};
+                    if (!stream.read(reinterpret_cast<char *>(entry.spirv.data()), static_cast<std::streamsize>(entry.spirv.size() * sizeof(u32))))
+                        break;
+
+                    if (XXH64(entry.spirv.data(), entry.spirv.size() * sizeof(u32), XXH64(&entry.bindings, sizeof(entry.bindings), 0)) != entryHeader.checksum)
+                        break;
+
+                    spirvCache.insert_or_assign(entryHeader.key, std::move(entry));
+                    lastKnownGoodOffset = stream.tellg();
+                }
+            } else {
+                Logger::Warn("Discarding outdated or invalid SPIR-V cache file");
+            }
+        }
+
+        if (lastKnownGoodOffset) {
+            // Drop any partially written or corrupted entries at the end of the file before appending to it
+            std::filesystem::resize_file(path, static_cast<u64>(lastKnownGoodOffset));
+            spirvCacheStream.open(path, std::ios::binary | std::ios::app);
+            Logger::Info("Loaded {} SPIR-V modules from the SPIR-V cache", spirvCache.size());
+        } else {
+            std::filesystem::create_directories(std::filesystem::path{path}.parent_path());
+            spirvCacheStream.open(path, std::ios::binary | std::ios::trunc);
+            spirvCacheStream.write(reinterpret_cast<const char *>(&expectedHeader), sizeof(SpirvCacheFileHeader));
+        }
+
+        if (spirvCacheStream.fail())
+            Logger::Warn("Failed to open the SPIR-V cache file for writing: {}", path);
+    }
+
+    ShaderManager::ShaderManager(const DeviceState &state, GPU &gpu, std::string_view replacementDir, std::string_view dumpDir, const std::string &spirvCachePath) : gpu{gpu}, dumpPath{dumpDir} {
         LoadShaderReplacements(replacementDir);
 
         if constexpr (DumpShaders) {
@@ -138,6 +309,21 @@ namespace skyline::gpu {
                 .active = false,
             },
         };
+
+        if (!spirvCachePath.empty())
+            LoadSpirvCache(state, spirvCachePath);
+    }
+
+    ShaderManager::~ShaderManager() {
+        if (replacementWatcher.joinable()) {
+            eventfd_write(replacementStopFd, 1);
+            replacementWatcher.join();
+        }
+
+        if (replacementStopFd >= 0)
+            close(replacementStopFd);
+        if (replacementWatchFd >= 0)
+            close(replacementWatchFd);
     }
 
     /**
@@ -367,64 +553,98 @@ namespace skyline::gpu {
                                                            u64 hash, span<u8> binary, u32 baseOffset,
                                                            u32 textureConstantBufferIndex,
                                                            bool viewportTransformEnabled,
-                                                           const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType) {
-        binary = ProcessShaderBinary(hash, binary);
-
-        std::scoped_lock lock{poolMutex};
+                                                           const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType,
+                                                           u64 *replacementKey) {
+        ReplacementBinary replacement;
+        binary = ProcessShaderBinary(hash, binary, replacement, replacementKey);
 
         GraphicsEnvironment environment{postVtgShaderAttributeSkipMask, stage, binary, baseOffset, textureConstantBufferIndex, viewportTransformEnabled, constantBufferRead, getTextureType};
-        Shader::Maxwell::Flow::CFG cfg{environment, flowBlockPool, Shader::Maxwell::Location{static_cast<u32>(baseOffset + sizeof(Shader::ProgramHeader))}};
-        return  Shader::Maxwell::TranslateProgram(instructionPool, blockPool, environment, cfg, hostTranslateInfo);
+        auto &pools{GetThreadPools()};
+        Shader::Maxwell::Flow::CFG cfg{environment, pools.flowBlockPool, Shader::Maxwell::Location{static_cast<u32>(baseOffset + sizeof(Shader::ProgramHeader))}};
+        return  Shader::Maxwell::TranslateProgram(pools.instructionPool, pools.blockPool, environment, cfg, hostTranslateInfo);
     }
 
     Shader::IR::Program ShaderManager::CombineVertexShaders(Shader::IR::Program &vertexA, Shader::IR::Program &vertexB, span<u8> vertexBBinary) {
-        std::scoped_lock lock{poolMutex};
-
         VertexBEnvironment env{vertexBBinary};
         return Shader::Maxwell::MergeDualVertexPrograms(vertexA, vertexB, env);
     }
 
     Shader::IR::Program ShaderManager::GenerateGeometryPassthroughShader(Shader::IR::Program &layerSource, Shader::OutputTopology topology) {
-        std::scoped_lock lock{poolMutex};
-
-        return Shader::Maxwell::GenerateGeometryPassthrough(instructionPool, blockPool, hostTranslateInfo, layerSource, topology);
+        auto &pools{GetThreadPools()};
+        return Shader::Maxwell::GenerateGeometryPassthrough(pools.instructionPool, pools.blockPool, hostTranslateInfo, layerSource, topology);
     }
 
     Shader::IR::Program ShaderManager::ParseComputeShader(u64 hash, span<u8> binary, u32 baseOffset,
                                                           u32 textureConstantBufferIndex,
                                                           u32 localMemorySize, u32 sharedMemorySize,
                                                           std::array<u32, 3> workgroupDimensions,
-                                                          const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType) {
-        binary = ProcessShaderBinary(hash, binary);
-
-        std::scoped_lock lock{poolMutex};
+                                                          const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType,
+                                                          u64 *replacementKey) {
+        ReplacementBinary replacement;
+        binary = ProcessShaderBinary(hash, binary, replacement, replacementKey);
 
         ComputeEnvironment environment{binary, baseOffset, textureConstantBufferIndex, localMemorySize, sharedMemorySize, workgroupDimensions, constantBufferRead, getTextureType};
-        Shader::Maxwell::Flow::CFG cfg{environment, flowBlockPool, Shader::Maxwell::Location{static_cast<u32>(baseOffset)}};
-        return  Shader::Maxwell::TranslateProgram(instructionPool, blockPool, environment, cfg, hostTranslateInfo);
+        auto &pools{GetThreadPools()};
+        Shader::Maxwell::Flow::CFG cfg{environment, pools.flowBlockPool, Shader::Maxwell::Location{static_cast<u32>(baseOffset)}};
+        return  Shader::Maxwell::TranslateProgram(pools.instructionPool, pools.blockPool, environment, cfg, hostTranslateInfo);
     }
 
-    vk::ShaderModule ShaderManager::CompileShader(const Shader::RuntimeInfo &runtimeInfo, Shader::IR::Program &program, Shader::Backend::Bindings &bindings, u64 hash) {
-        std::scoped_lock lock{poolMutex};
-
+    vk::ShaderModule ShaderManager::CompileShader(const Shader::RuntimeInfo &runtimeInfo, Shader::IR::Program &program, Shader::Backend::Bindings &bindings, u64 cacheKey) {
+        // This is done regardless of whether the SPIR-V is cached as it modifies the program info which the caller relies on
         if (program.info.loads.Legacy() || program.info.stores.Legacy())
             Shader::Maxwell::ConvertLegacyToGeneric(program, runtimeInfo);
 
-        auto spirv{Shader::Backend::SPIRV::EmitSPIRV(profile, runtimeInfo, program, bindings)};
+        auto createShaderModule{[this](span<u32> spirv) {
+            vk::ShaderModuleCreateInfo createInfo{
+                .pCode = spirv.data(),
+                .codeSize = spirv.size_bytes(),
+            };
+
+            return (*gpu.vkDevice).createShaderModule(createInfo, nullptr, *gpu.vkDevice.getDispatcher());
+        }};
+
+        if (!cacheKey) {
+            FrameStatistics::RecordShaderCompile();
+            auto spirv{Shader::Backend::SPIRV::EmitSPIRV(profile, runtimeInfo, program, bindings)};
+            return createShaderModule(spirv);
+        }
+
+        // The bindings are an input to SPIR-V emission as they determine the first binding of every descriptor type
+        u64 key{HashCacheKey(cacheKey, bindings)};
+        {
+            std::shared_lock lock{spirvCacheMutex};
+            auto it{spirvCache.find(key)};
+            if (it != spirvCache.end()) {
+                bindings = it->second.bindings;
+                return createShaderModule(it->second.spirv);
+            }
+        }
 
-        vk::ShaderModuleCreateInfo createInfo{
-            .pCode = spirv.data(),
-            .codeSize = spirv.size() * sizeof(u32),
-        };
+        FrameStatistics::RecordShaderCompile();
+        SpirvCacheEntry entry{Shader::Backend::SPIRV::EmitSPIRV(profile, runtimeInfo, program, bindings), bindings};
+        auto module{createShaderModule(entry.spirv)};
 
-        return (*gpu.vkDevice).createShaderModule(createInfo, nullptr, *gpu.vkDevice.getDispatcher());
+        std::unique_lock lock{spirvCacheMutex};
+        if (spirvCacheStream.is_open()) {
+            SpirvCacheEntryHeader entryHeader{
+                .key = key,
+                .checksum = XXH64(entry.spirv.data(), entry.spirv.size() * sizeof(u32), XXH64(&entry.bindings, sizeof(entry.bindings), 0)),
+                .spirvWordCount = static_cast<u32>(entry.spirv.size()),
+                .bindings = entry.bindings,
+            };
+            spirvCacheStream.write(reinterpret_cast<const char *>(&entryHeader), sizeof(SpirvCacheEntryHeader));
+            spirvCacheStream.write(reinterpret_cast<const char *>(entry.spirv.data()), static_cast<std::streamsize>(entry.spirv.size() * sizeof(u32)));
+            spirvCacheStream.flush();
+        }
+        spirvCache.try_emplace(key, std::move(entry));
+
+        return module;
     }
 
     void ShaderManager::ResetPools() {
-        std::scoped_lock lock{poolMutex};
-
-        instructionPool.ReleaseContents();
-        blockPool.ReleaseContents();
-        flowBlockPool.ReleaseContents();
+        auto &pools{GetThreadPools()};
+        pools.instructionPool.ReleaseContents();
+        pools.blockPool.ReleaseContents();
+        pools.flowBlockPool.ReleaseContents();
     }
 }
@@ -4,6 +4,9 @@
 #pragma once
 
 #include <unordered_map>
+#include <shared_mutex>
+#include <fstream>
+#include <thread>
 #include <vulkan/vulkan.hpp>
 #include <shader_compiler/object_pool.h>
 #include <shader_compiler/frontend/maxwell/control_flow.h>
@@ -19,41 +22,119 @@
 namespace skyline::gpu {
     /**
      * @brief The Shader Manager is responsible for caching and looking up shaders alongside handling compilation of shaders when not found in any cache
+     * @note Shaders can be translated on multiple threads concurrently as every thread has its own object pools, the programs returned are backed by the pools of the calling thread until its next ResetPools() call
      */
     class ShaderManager {
       private:
         GPU &gpu;
         Shader::HostTranslateInfo hostTranslateInfo;
         Shader::Profile profile;
-        Shader::ObjectPool<Shader::Maxwell::Flow::Block> flowBlockPool;
-        Shader::ObjectPool<Shader::IR::Inst> instructionPool;
-        Shader::ObjectPool<Shader::IR::Block> blockPool;
-        std::unordered_map<u64, std::vector<u8>> shaderReplacements; //!< Map of shader hash -> replacement shader binary, populated at init time and must not be modified after
-        std::mutex poolMutex;
+
+        /**
+         * @brief The object pools backing the IR of translated programs
+         */
+        struct ObjectPools {
+            Shader::ObjectPool<Shader::Maxwell::Flow::Block> flowBlockPool;
+            Shader::ObjectPool<Shader::IR::Inst> instructionPool;
+            Shader::ObjectPool<Shader::IR::Block> blockPool;
+        };
+
+        using ReplacementBinary = std::shared_ptr<const std::vector<u8>>; //!< A replacement binary is shared so a translation can keep using it while it's being reloaded
+
+        std::unordered_map<u64, ReplacementBinary> shaderReplacements; //!< Map of shader hash -> replacement shader binary, populated at init time and updated by the replacement watcher
+        std::shared_mutex replacementMutex; //!< Protects access to the shader replacements map and the reload log
+        std::filesystem::path replacementPath;
+        std::vector<std::pair<u32, u64>> replacementReloads; //!< A log of (generation, shader hash) for every replacement that was reloaded at runtime
+        std::atomic<u32> replacementGeneration{}; //!< Incremented whenever a replacement is reloaded, this allows consumers to cheaply check for reloads
+        int replacementWatchFd{-1}; //!< An inotify FD watching the replacement directory, this is -1 if the directory doesn't exist
+        int replacementStopFd{-1}; //!< An eventfd signalled to stop the replacement watcher thread
+        std::thread replacementWatcher;
         std::filesystem::path dumpPath;
         std::mutex dumpMutex;
 
+        /**
+         * @brief The SPIR-V emitted for a program alongside the state of the bindings after it was emitted
+         */
+        struct SpirvCacheEntry {
+            std::vector<u32> spirv;
+            Shader::Backend::Bindings bindings;
+        };
+
+        std::unordered_map<u64, SpirvCacheEntry> spirvCache; //!< Map of SPIR-V cache key -> emitted SPIR-V, this allows programs shared across pipelines to only be emitted once
+        std::shared_mutex spirvCacheMutex; //!< Protects access to the SPIR-V cache and its stream
+        std::ofstream spirvCacheStream; //!< An append-only stream to the on-disk SPIR-V cache, this isn't open when the on-disk cache is disabled
+
+        /**
+         * @brief Called at init time to populate the SPIR-V cache from the on-disk cache and open it for appending new entries
+         */
+        void LoadSpirvCache(const DeviceState &state, const std::string &path);
+
+        /**
+         * @return The object pools of the calling thread
+         */
+        static ObjectPools &GetThreadPools();
+
         /**
          * @brief Called at init time to populate the shader replacements map from the input directory
          */
         void LoadShaderReplacements(std::string_view replacementDir);
 
+        /**
+         * @brief Loads the replacement from the supplied path into the map, erasing any existing replacement if the file doesn't exist
+         * @return If the filename was a valid shader hash
+         */
+        bool LoadShaderReplacement(const std::filesystem::path &path, bool reload);
+
+        /**
+         * @brief A thread which watches the replacement directory and reloads replacements as they are modified
+         */
+        void ReplacementWatcherThread();
+
         /**
          * @brief Returns the raw binary of shader replacement for the given hash, if no replacement is found the input binary is returned
+         * @param replacement The replacement binary which backs the returned span, this must be kept alive while the span is in use
+         * @param replacementKey If non-null, this is set to a hash of the replacement binary or 0 if the shader wasn't replaced
          * @note This will also dump the binary to disk if dumping is enabled
          */
-        span<u8> ProcessShaderBinary(u64 hash, span<u8> binary);
+        span<u8> ProcessShaderBinary(u64 hash, span<u8> binary, ReplacementBinary &replacement, u64 *replacementKey);
 
       public:
         using ConstantBufferRead = std::function<u32(u32 index, u32 offset)>; //!< A function which reads a constant buffer at the specified offset and returns the value
         using GetTextureType = std::function<Shader::TextureType(u32 handle)>; //!< A function which determines the type of a texture from its handle by checking the corresponding TIC
 
-        ShaderManager(const DeviceState &state, GPU &gpu, std::string_view replacementDir, std::string_view dumpDir);
+        /**
+         * @param spirvCachePath The path to the on-disk SPIR-V cache file, an empty path disables the on-disk cache
+         */
+        ShaderManager(const DeviceState &state, GPU &gpu, std::string_view replacementDir, std::string_view dumpDir, const std::string &spirvCachePath);
+
+        ~ShaderManager();
+
+        /**
+         * @brief Folds a value into a SPIR-V cache key, this is stable across runs so keys can be used for the on-disk cache
+         * @note The value must not contain any padding as its object representation is hashed
+         */
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        static u64 HashCacheKey(u64 key, const T &value) {
+            return XXH3_64bits_withSeed(&value, sizeof(T), key);
+        }
+
+        /**
+         * @return The current generation of shader replacements, this changes whenever a replacement is reloaded at runtime
+         */
+        u32 GetReplacementGeneration() {
+            return replacementGeneration.load(std::memory_order_acquire);
+        }
 
         /**
+         * @return The hashes of all shaders which had their replacements reloaded after the supplied generation
+         */
+        std::vector<u64> GetReloadedReplacements(u32 generation);
+
+        /**
+         * @param replacementKey If non-null, this is set to a hash of the replacement binary used for the shader or 0 if it wasn't replaced, this should be folded into any cache keys for the program
          * @return A shader program that corresponds to all the supplied state including the current state of the constant buffers
          */
-        Shader::IR::Program ParseGraphicsShader(const std::array<u32, 8> &postVtgShaderAttributeSkipMask, Shader::Stage stage, u64 hash, span<u8> binary, u32 baseOffset, u32 textureConstantBufferIndex, bool viewportTransformEnabled, const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType);
+        Shader::IR::Program ParseGraphicsShader(const std::array<u32, 8> &postVtgShaderAttributeSkipMask, Shader::Stage stage, u64 hash, span<u8> binary, u32 baseOffset, u32 textureConstantBufferIndex, bool viewportTransformEnabled, const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType, u64 *replacementKey = nullptr);
 
         /**
          * @brief Combines the VertexA and VertexB shader programs into a single program
@@ -66,10 +147,19 @@ namespace skyline::gpu {
          */
         Shader::IR::Program GenerateGeometryPassthroughShader(Shader::IR::Program &layerSource, Shader::OutputTopology topology);
 
-        Shader::IR::Program ParseComputeShader(u64 hash, span<u8> binary, u32 baseOffset, u32 textureConstantBufferIndex, u32 localMemorySize, u32 sharedMemorySize, std::array<u32, 3> workgroupDimensions, const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType);
+        /**
+         * @param replacementKey If non-null, this is set to a hash of the replacement binary used for the shader or 0 if it wasn't replaced
+         */
+        Shader::IR::Program ParseComputeShader(u64 hash, span<u8> binary, u32 baseOffset, u32 textureConstantBufferIndex, u32 localMemorySize, u32 sharedMemorySize, std::array<u32, 3> workgroupDimensions, const ConstantBufferRead &constantBufferRead, const GetTextureType &getTextureType, u64 *replacementKey = nullptr);
 
-        vk::ShaderModule CompileShader(const Shader::RuntimeInfo &runtimeInfo, Shader::IR::Program &program, Shader::Backend::Bindings &bindings, u64 hash = 0);
+        /**
+         * @param cacheKey A key which uniquely identifies the program and runtime info, this is combined with the input bindings to look up previously emitted SPIR-V, a key of 0 disables caching
+         */
+        vk::ShaderModule CompileShader(const Shader::RuntimeInfo &runtimeInfo, Shader::IR::Program &program, Shader::Backend::Bindings &bindings, u64 cacheKey = 0);
 
+        /**
+         * @brief Releases all IR allocated by the calling thread, this invalidates all programs previously returned on it
+         */
         void ResetPools();
     };
 }
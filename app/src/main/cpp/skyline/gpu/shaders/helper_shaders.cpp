@@ -262,7 +262,7 @@ namespace skyline::gpu {
                          VkColorComponentFlags{vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA},
                          false, false},
                         {blit::SamplerLayoutBinding}, blit::PushConstantRanges),
-            dstImageDimensions
+            dstImageView->texture->dimensions // The clip space coordinates are relative to the guest dimensions, so the viewport covering the entire host image accounts for any resolution scaling
         )};
 
         vk::DescriptorImageInfo imageInfo{
@@ -299,7 +299,7 @@ namespace skyline::gpu {
 
             commandBuffer.setScissor(0, {scissor});
             commandBuffer.setViewport(0, {viewport});
-            commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *drawState->pipeline.pipeline.get());
+            commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, drawState->pipeline.GetPipeline());
             commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *drawState->pipeline.pipelineLayout, 0, *drawState->descriptorSet, nullptr);
             commandBuffer.pushConstants(*drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0,
                                         vk::ArrayProxy<const blit::VertexPushConstantLayout>{drawState->vertexPushConstants});
@@ -384,15 +384,693 @@ namespace skyline::gpu {
 
             commandBuffer.setScissor(0, {scissor});
             commandBuffer.setViewport(0, {viewport});
-            commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *drawState->pipeline.pipeline.get());
+            commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, drawState->pipeline.GetPipeline());
             commandBuffer.pushConstants(*drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eFragment, 0,
                                         vk::ArrayProxy<const clear::FragmentPushConstantLayout>{drawState->fragmentPushConstants});
             commandBuffer.draw(6, 1, 0, 0);
         });
     }
 
+    namespace composite {
+        struct FragmentPushConstantLayout {
+            glsl::Vec2 srcOriginUV;
+            glsl::Vec2 srcScaleUV;
+        };
+
+        constexpr static std::array<vk::PushConstantRange, 2> PushConstantRanges{
+            vk::PushConstantRange{
+                .stageFlags = vk::ShaderStageFlagBits::eVertex,
+                .size = sizeof(blit::VertexPushConstantLayout),
+                .offset = 0
+            }, vk::PushConstantRange{
+                .stageFlags = vk::ShaderStageFlagBits::eFragment,
+                .size = sizeof(FragmentPushConstantLayout),
+                .offset = sizeof(blit::VertexPushConstantLayout)
+            }
+        };
+    }
+
+    VideoCompositorShader::VideoCompositorShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : SimpleSingleRtShader{gpu, shaderFileSystem->OpenFile("shaders/blit.vert.spv"), shaderFileSystem->OpenFile("shaders/video_composite.frag.spv")} {}
+
+    void VideoCompositorShader::Composite(GPU &gpu, vk::ImageView srcView, vk::Sampler immutableSampler,
+                                          std::array<float, 2> srcOriginUV, std::array<float, 2> srcScaleUV,
+                                          TextureView *dstImageView,
+                                          std::function<void(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&)> &&recordCb) {
+        struct DrawState {
+            composite::FragmentPushConstantLayout fragmentPushConstants;
+            DescriptorAllocator::ActiveDescriptorSet descriptorSet;
+            const GraphicsPipelineAssembler::CompiledPipeline &pipeline;
+            vk::Extent2D imageDimensions;
+
+            DrawState(GPU &gpu,
+                      composite::FragmentPushConstantLayout fragmentPushConstants,
+                      const GraphicsPipelineAssembler::CompiledPipeline &pipeline,
+                      vk::Extent2D imageDimensions)
+                : fragmentPushConstants{fragmentPushConstants},
+                  descriptorSet{gpu.descriptor.AllocateSet(*pipeline.descriptorSetLayout)},
+                  pipeline{pipeline},
+                  imageDimensions{imageDimensions} {}
+        };
+
+        // The sampler is baked into the descriptor set layout, YCbCr conversions are only supported with immutable samplers
+        vk::DescriptorSetLayoutBinding samplerLayoutBinding{
+            .binding = 0,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eFragment,
+            .pImmutableSamplers = &immutableSampler
+        };
+
+        auto drawState{std::make_shared<DrawState>(
+            gpu,
+            composite::FragmentPushConstantLayout{
+                .srcOriginUV = {srcOriginUV[0], srcOriginUV[1]},
+                .srcScaleUV = {srcScaleUV[0], srcScaleUV[1]}
+            },
+            GetPipeline(gpu,
+                        {dstImageView->format->vkFormat,
+                         vk::Format::eUndefined, 0,
+                         VkColorComponentFlags{vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA},
+                         false, false, immutableSampler},
+                        {samplerLayoutBinding}, composite::PushConstantRanges),
+            dstImageView->texture->dimensions
+        )};
+
+        vk::DescriptorImageInfo imageInfo{
+            .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+            .imageView = srcView
+        };
+
+        std::array<vk::WriteDescriptorSet, 1> writes{vk::WriteDescriptorSet{
+            .dstBinding = 0,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+            .descriptorCount = 1,
+            .dstSet = *drawState->descriptorSet,
+            .pImageInfo = &imageInfo
+        }};
+
+        gpu.vkDevice.updateDescriptorSets(writes, nullptr);
+
+        recordCb([drawState = std::move(drawState)](vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, GPU &gpu, vk::RenderPass, u32) {
+            cycle->AttachObject(drawState);
+
+            vk::Viewport viewport{
+                .height = static_cast<float>(drawState->imageDimensions.height),
+                .width = static_cast<float>(drawState->imageDimensions.width),
+                .x = 0.0f,
+                .y = 0.0f,
+                .minDepth = 0.0f,
+                .maxDepth = 1.0f
+            };
+
+            vk::Rect2D scissor{
+                .extent = drawState->imageDimensions
+            };
+
+            // The destination is always covered entirely, this corresponds to the clip space rectangle from (-1, -1) to (1, 1)
+            constexpr blit::VertexPushConstantLayout vertexPushConstants{
+                .dstOriginClipSpace = {-1.0f, -1.0f},
+                .dstDimensionsClipSpace = {2.0f, 2.0f}
+            };
+
+            commandBuffer.setScissor(0, {scissor});
+            commandBuffer.setViewport(0, {viewport});
+            commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, drawState->pipeline.GetPipeline());
+            commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *drawState->pipeline.pipelineLayout, 0, *drawState->descriptorSet, nullptr);
+            commandBuffer.pushConstants(*drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0,
+                                        vk::ArrayProxy<const blit::VertexPushConstantLayout>{vertexPushConstants});
+            commandBuffer.pushConstants(*drawState->pipeline.pipelineLayout, vk::ShaderStageFlagBits::eFragment, sizeof(blit::VertexPushConstantLayout),
+                                        vk::ArrayProxy<const composite::FragmentPushConstantLayout>{drawState->fragmentPushConstants});
+            commandBuffer.draw(6, 1, 0, 0);
+        });
+    }
+
+    namespace deswizzle {
+        struct PushConstantLayout {
+            u32 blockLinearOffset;
+            u32 linearOffset;
+            u32 lineWords;
+            u32 height;
+            u32 depth;
+            u32 blockHeight;
+            u32 blockDepth;
+            u32 robWidthBlocks;
+            u32 surfaceHeightRobs;
+            u32 swizzle;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr static std::array<vk::DescriptorSetLayoutBinding, 2> LayoutBindings{
+            vk::DescriptorSetLayoutBinding{
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }, vk::DescriptorSetLayoutBinding{
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }
+        };
+
+        constexpr u32 WorkgroupWidth{16}; //!< The X local size of the shader, in words
+        constexpr u32 WorkgroupHeight{8}; //!< The Y local size of the shader, in lines
+        constexpr u32 GobWidth{64}; //!< The width of a GOB in bytes
+        constexpr u32 GobHeight{8}; //!< The height of a GOB in lines
+    }
+
+    BlockLinearDeswizzleShader::BlockLinearDeswizzleShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/block_linear_deswizzle.comp.spv"))},
+          descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = deswizzle::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(deswizzle::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &deswizzle::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          pipeline{gpu.vkDevice, nullptr, vk::ComputePipelineCreateInfo{
+              .stage = vk::PipelineShaderStageCreateInfo{
+                  .stage = vk::ShaderStageFlagBits::eCompute,
+                  .pName = "main",
+                  .module = *shaderModule
+              },
+              .layout = *pipelineLayout,
+          }} {}
+
+    std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> BlockLinearDeswizzleShader::Deswizzle(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                                                    vk::DescriptorBufferInfo blockLinear, vk::DescriptorBufferInfo linear,
+                                                                                                    span<const Surface> surfaces) {
+        return Dispatch(gpu, commandBuffer, blockLinear, linear, surfaces, false);
+    }
+
+    std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> BlockLinearDeswizzleShader::Swizzle(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                                                  vk::DescriptorBufferInfo blockLinear, vk::DescriptorBufferInfo linear,
+                                                                                                  span<const Surface> surfaces) {
+        return Dispatch(gpu, commandBuffer, blockLinear, linear, surfaces, true);
+    }
+
+    std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> BlockLinearDeswizzleShader::Dispatch(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                                                   vk::DescriptorBufferInfo blockLinear, vk::DescriptorBufferInfo linear,
+                                                                                                   span<const Surface> surfaces, bool swizzle) {
+        auto descriptorSet{std::make_shared<DescriptorAllocator::ActiveDescriptorSet>(gpu.descriptor.AllocateSet(*descriptorSetLayout))};
+
+        std::array<vk::WriteDescriptorSet, 2> writes{
+            vk::WriteDescriptorSet{
+                .dstBinding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &blockLinear
+            }, vk::WriteDescriptorSet{
+                .dstBinding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &linear
+            }
+        };
+
+        gpu.vkDevice.updateDescriptorSets(writes, nullptr);
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, **descriptorSet, nullptr);
+
+        for (const auto &surface : surfaces) {
+            u32 lineBytes{util::DivideCeil(surface.width, surface.formatBlockWidth) * surface.formatBpb};
+            u32 lines{util::DivideCeil(surface.height, surface.formatBlockHeight)};
+
+            deswizzle::PushConstantLayout pushConstants{
+                .blockLinearOffset = static_cast<u32>(surface.blockLinearOffset / sizeof(u32)),
+                .linearOffset = static_cast<u32>(surface.linearOffset / sizeof(u32)),
+                .lineWords = lineBytes / static_cast<u32>(sizeof(u32)),
+                .height = lines,
+                .depth = surface.depth,
+                .blockHeight = surface.gobBlockHeight,
+                .blockDepth = surface.gobBlockDepth,
+                .robWidthBlocks = util::DivideCeil(lineBytes, deswizzle::GobWidth),
+                .surfaceHeightRobs = util::DivideCeil(util::DivideCeil(lines, deswizzle::GobHeight), surface.gobBlockHeight),
+                .swizzle = swizzle,
+            };
+
+            commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const deswizzle::PushConstantLayout>{pushConstants});
+            commandBuffer.dispatch(util::DivideCeil(pushConstants.lineWords, deswizzle::WorkgroupWidth), util::DivideCeil(lines, deswizzle::WorkgroupHeight), surface.depth);
+        }
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+        }, {}, {});
+
+        return descriptorSet;
+    }
+
+    namespace astc {
+        struct PushConstantLayout {
+            u32 inputOffset;
+            u32 outputOffset;
+            u32 width;
+            u32 height;
+            u32 depth;
+            u32 blockWidth;
+            u32 blockHeight;
+            u32 srgb;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr static std::array<vk::DescriptorSetLayoutBinding, 2> LayoutBindings{
+            vk::DescriptorSetLayoutBinding{
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }, vk::DescriptorSetLayoutBinding{
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }
+        };
+
+        constexpr u32 WorkgroupWidth{8}; //!< The X local size of the shader, in blocks
+        constexpr u32 WorkgroupHeight{8}; //!< The Y local size of the shader, in blocks
+        constexpr u32 BlockSize{16}; //!< The size of an ASTC block in bytes
+    }
+
+    AstcDecoderShader::AstcDecoderShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/astc_decoder.comp.spv"))},
+          descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = astc::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(astc::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &astc::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          pipeline{gpu.vkDevice, nullptr, vk::ComputePipelineCreateInfo{
+              .stage = vk::PipelineShaderStageCreateInfo{
+                  .stage = vk::ShaderStageFlagBits::eCompute,
+                  .pName = "main",
+                  .module = *shaderModule
+              },
+              .layout = *pipelineLayout,
+          }} {}
+
+    std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> AstcDecoderShader::Decode(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                                         vk::DescriptorBufferInfo astcBuffer, vk::DescriptorBufferInfo rgbaBuffer,
+                                                                                         span<const Surface> surfaces, bool srgb) {
+        auto descriptorSet{std::make_shared<DescriptorAllocator::ActiveDescriptorSet>(gpu.descriptor.AllocateSet(*descriptorSetLayout))};
+
+        std::array<vk::WriteDescriptorSet, 2> writes{
+            vk::WriteDescriptorSet{
+                .dstBinding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &astcBuffer
+            }, vk::WriteDescriptorSet{
+                .dstBinding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &rgbaBuffer
+            }
+        };
+
+        gpu.vkDevice.updateDescriptorSets(writes, nullptr);
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, **descriptorSet, nullptr);
+
+        for (const auto &surface : surfaces) {
+            astc::PushConstantLayout pushConstants{
+                .inputOffset = static_cast<u32>(surface.astcOffset / astc::BlockSize),
+                .outputOffset = static_cast<u32>(surface.rgbaOffset / sizeof(u32)),
+                .width = surface.width,
+                .height = surface.height,
+                .depth = surface.depth,
+                .blockWidth = surface.formatBlockWidth,
+                .blockHeight = surface.formatBlockHeight,
+                .srgb = srgb,
+            };
+
+            commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const astc::PushConstantLayout>{pushConstants});
+            commandBuffer.dispatch(util::DivideCeil(util::DivideCeil(surface.width, surface.formatBlockWidth), astc::WorkgroupWidth), util::DivideCeil(util::DivideCeil(surface.height, surface.formatBlockHeight), astc::WorkgroupHeight), surface.depth);
+        }
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+        }, {}, {});
+
+        return descriptorSet;
+    }
+
+    namespace depthstencil {
+        struct PushConstantLayout {
+            u32 packedOffset;
+            u32 depthOffset;
+            u32 stencilOffset;
+            u32 texelCount;
+            u32 depthInHighBits;
+            u32 hasStencil;
+            u32 pack;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr static std::array<vk::DescriptorSetLayoutBinding, 2> LayoutBindings{
+            vk::DescriptorSetLayoutBinding{
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }, vk::DescriptorSetLayoutBinding{
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }
+        };
+
+        constexpr u32 WorkgroupWidth{64}; //!< The X local size of the shader, in groups of texels
+        constexpr u32 TexelsPerInvocation{4}; //!< The amount of texels converted by each invocation, this corresponds to a single word of the stencil plane
+    }
+
+    DepthStencilConversionShader::DepthStencilConversionShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/depth_stencil_conversion.comp.spv"))},
+          descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = depthstencil::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(depthstencil::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &depthstencil::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          pipeline{gpu.vkDevice, nullptr, vk::ComputePipelineCreateInfo{
+              .stage = vk::PipelineShaderStageCreateInfo{
+                  .stage = vk::ShaderStageFlagBits::eCompute,
+                  .pName = "main",
+                  .module = *shaderModule
+              },
+              .layout = *pipelineLayout,
+          }} {}
+
+    std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> DepthStencilConversionShader::Unpack(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                                                   vk::DescriptorBufferInfo packed, vk::DescriptorBufferInfo split,
+                                                                                                   span<const Surface> surfaces, bool depthInHighBits, bool hasStencil) {
+        return Dispatch(gpu, commandBuffer, packed, split, surfaces, depthInHighBits, hasStencil, false);
+    }
+
+    std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> DepthStencilConversionShader::Pack(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                                                 vk::DescriptorBufferInfo packed, vk::DescriptorBufferInfo split,
+                                                                                                 span<const Surface> surfaces, bool depthInHighBits, bool hasStencil) {
+        return Dispatch(gpu, commandBuffer, packed, split, surfaces, depthInHighBits, hasStencil, true);
+    }
+
+    std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> DepthStencilConversionShader::Dispatch(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                                                     vk::DescriptorBufferInfo packed, vk::DescriptorBufferInfo split,
+                                                                                                     span<const Surface> surfaces, bool depthInHighBits, bool hasStencil, bool pack) {
+        auto descriptorSet{std::make_shared<DescriptorAllocator::ActiveDescriptorSet>(gpu.descriptor.AllocateSet(*descriptorSetLayout))};
+
+        std::array<vk::WriteDescriptorSet, 2> writes{
+            vk::WriteDescriptorSet{
+                .dstBinding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &packed
+            }, vk::WriteDescriptorSet{
+                .dstBinding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &split
+            }
+        };
+
+        gpu.vkDevice.updateDescriptorSets(writes, nullptr);
+
+        // When packing, the split planes were written by image to buffer copies which must be visible to the shader
+        if (pack)
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eShaderRead,
+            }, {}, {});
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, **descriptorSet, nullptr);
+
+        for (const auto &surface : surfaces) {
+            depthstencil::PushConstantLayout pushConstants{
+                .packedOffset = static_cast<u32>(surface.packedOffset / sizeof(u32)),
+                .depthOffset = static_cast<u32>(surface.depthOffset / sizeof(u32)),
+                .stencilOffset = static_cast<u32>(surface.stencilOffset / sizeof(u32)),
+                .texelCount = surface.texelCount,
+                .depthInHighBits = depthInHighBits,
+                .hasStencil = hasStencil,
+                .pack = pack,
+            };
+
+            commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const depthstencil::PushConstantLayout>{pushConstants});
+            commandBuffer.dispatch(util::DivideCeil(util::DivideCeil(surface.texelCount, depthstencil::TexelsPerInvocation), depthstencil::WorkgroupWidth), 1, 1);
+        }
+
+        if (pack)
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eHost, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+                .dstAccessMask = vk::AccessFlagBits::eHostRead,
+            }, {}, {});
+        else
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eTransfer, {}, vk::MemoryBarrier{
+                .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            }, {}, {});
+
+        return descriptorSet;
+    }
+
+    namespace quads {
+        struct PushConstantLayout {
+            u32 sourceOffset;
+            u32 quadCount;
+            u32 wideIndices;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr static std::array<vk::DescriptorSetLayoutBinding, 2> LayoutBindings{
+            vk::DescriptorSetLayoutBinding{
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }, vk::DescriptorSetLayoutBinding{
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }
+        };
+
+        constexpr u32 WorkgroupWidth{64}; //!< The X local size of the shader, in quads
+    }
+
+    QuadIndexConversionShader::QuadIndexConversionShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/quad_index_conversion.comp.spv"))},
+          descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = quads::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(quads::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &quads::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          pipeline{gpu.vkDevice, nullptr, vk::ComputePipelineCreateInfo{
+              .stage = vk::PipelineShaderStageCreateInfo{
+                  .stage = vk::ShaderStageFlagBits::eCompute,
+                  .pName = "main",
+                  .module = *shaderModule
+              },
+              .layout = *pipelineLayout,
+          }} {}
+
+    std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> QuadIndexConversionShader::Convert(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                                                  vk::DescriptorBufferInfo source, vk::DescriptorBufferInfo destination,
+                                                                                                  vk::DeviceSize sourceOffset, u32 quadCount, vk::IndexType type) {
+        auto descriptorSet{std::make_shared<DescriptorAllocator::ActiveDescriptorSet>(gpu.descriptor.AllocateSet(*descriptorSetLayout))};
+
+        std::array<vk::WriteDescriptorSet, 2> writes{
+            vk::WriteDescriptorSet{
+                .dstBinding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &source
+            }, vk::WriteDescriptorSet{
+                .dstBinding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &destination
+            }
+        };
+
+        gpu.vkDevice.updateDescriptorSets(writes, nullptr);
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, **descriptorSet, nullptr);
+
+        quads::PushConstantLayout pushConstants{
+            .sourceOffset = static_cast<u32>(sourceOffset / sizeof(u32)),
+            .quadCount = quadCount,
+            .wideIndices = type == vk::IndexType::eUint32,
+        };
+
+        commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const quads::PushConstantLayout>{pushConstants});
+        commandBuffer.dispatch(util::DivideCeil(quadCount, quads::WorkgroupWidth), 1, 1);
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eVertexInput, {}, vk::MemoryBarrier{
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eIndexRead,
+        }, {}, {});
+
+        return descriptorSet;
+    }
+
+    namespace query {
+        struct PushConstantLayout {
+            u32 sourceOffset;
+            u32 destinationOffset;
+            QueryResolveShader::Operation operation;
+            u32 parameter;
+            u64 timestamp;
+        };
+
+        constexpr static vk::PushConstantRange PushConstantRange{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .size = sizeof(PushConstantLayout),
+            .offset = 0
+        };
+
+        constexpr static std::array<vk::DescriptorSetLayoutBinding, 2> LayoutBindings{
+            vk::DescriptorSetLayoutBinding{
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }, vk::DescriptorSetLayoutBinding{
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute
+            }
+        };
+    }
+
+    QueryResolveShader::QueryResolveShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
+        : shaderModule{CreateShaderModule(gpu, *shaderFileSystem->OpenFile("shaders/query_resolve.comp.spv"))},
+          descriptorSetLayout{gpu.vkDevice, vk::DescriptorSetLayoutCreateInfo{
+              .pBindings = query::LayoutBindings.data(),
+              .bindingCount = static_cast<u32>(query::LayoutBindings.size()),
+          }},
+          pipelineLayout{gpu.vkDevice, vk::PipelineLayoutCreateInfo{
+              .pSetLayouts = &*descriptorSetLayout,
+              .setLayoutCount = 1,
+              .pPushConstantRanges = &query::PushConstantRange,
+              .pushConstantRangeCount = 1,
+          }},
+          pipeline{gpu.vkDevice, nullptr, vk::ComputePipelineCreateInfo{
+              .stage = vk::PipelineShaderStageCreateInfo{
+                  .stage = vk::ShaderStageFlagBits::eCompute,
+                  .pName = "main",
+                  .module = *shaderModule
+              },
+              .layout = *pipelineLayout,
+          }} {}
+
+    std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> QueryResolveShader::Resolve(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                                          vk::DescriptorBufferInfo source, vk::DescriptorBufferInfo destination,
+                                                                                          vk::DeviceSize sourceOffset, vk::DeviceSize destinationOffset,
+                                                                                          Operation operation, u32 parameter, u64 timestamp) {
+        auto descriptorSet{std::make_shared<DescriptorAllocator::ActiveDescriptorSet>(gpu.descriptor.AllocateSet(*descriptorSetLayout))};
+
+        std::array<vk::WriteDescriptorSet, 2> writes{
+            vk::WriteDescriptorSet{
+                .dstBinding = 0,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &source
+            }, vk::WriteDescriptorSet{
+                .dstBinding = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .descriptorCount = 1,
+                .dstSet = **descriptorSet,
+                .pBufferInfo = &destination
+            }
+        };
+
+        gpu.vkDevice.updateDescriptorSets(writes, nullptr);
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, **descriptorSet, nullptr);
+
+        query::PushConstantLayout pushConstants{
+            .sourceOffset = static_cast<u32>(sourceOffset / sizeof(u32)),
+            .destinationOffset = static_cast<u32>(destinationOffset / sizeof(u32)),
+            .operation = operation,
+            .parameter = parameter,
+            .timestamp = timestamp,
+        };
+
+        commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, vk::ArrayProxy<const query::PushConstantLayout>{pushConstants});
+        commandBuffer.dispatch(1, 1, 1);
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eAllCommands, {}, vk::MemoryBarrier{
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eMemoryRead,
+        }, {}, {});
+
+        return descriptorSet;
+    }
+
     HelperShaders::HelperShaders(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem)
         : blitHelperShader(gpu, shaderFileSystem),
-          clearHelperShader(gpu, shaderFileSystem) {}
+          clearHelperShader(gpu, shaderFileSystem),
+          videoCompositorShader(gpu, shaderFileSystem),
+          blockLinearDeswizzleShader(gpu, shaderFileSystem),
+          astcDecoderShader(gpu, shaderFileSystem),
+          depthStencilConversionShader(gpu, shaderFileSystem),
+          quadIndexConversionShader(gpu, shaderFileSystem),
+          queryResolveShader(gpu, shaderFileSystem) {}
 
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ namespace skyline::gpu {
             VkColorComponentFlags colorWriteMask;
             bool depthWrite;
             bool stencilWrite;
+            vk::Sampler immutableSampler{}; //!< An immutable sampler that's baked into the descriptor set layout, this is required for sampling with a YCbCr conversion
 
             bool operator==(const PipelineState &input) const {
                 return std::memcmp(this, &input, sizeof(PipelineState)) == 0;
@@ -90,6 +91,27 @@ namespace skyline::gpu {
                       std::function<void(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&)> &&recordCb);
     };
 
+    /**
+     * @brief Helper shader for compositing a decoded video frame into a rendertarget, the frame is sampled through a YCbCr conversion which converts it to RGB
+     */
+    class VideoCompositorShader : SimpleSingleRtShader {
+      public:
+        VideoCompositorShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @brief Records a sequenced GPU composite operation which scales the source region to cover the entire destination
+         * @param srcView A view of the source image in the shader read-only layout, it must have been created with the YCbCr conversion of the supplied sampler
+         * @param immutableSampler The sampler with a YCbCr conversion that's used for sampling the source
+         * @param srcOriginUV The normalized coordinates of the top-left corner of the source region
+         * @param srcScaleUV The normalized size of the source region
+         * @param recordCb Callback used to record the composite commands for sequenced execution on the GPU
+         */
+        void Composite(GPU &gpu, vk::ImageView srcView, vk::Sampler immutableSampler,
+                       std::array<float, 2> srcOriginUV, std::array<float, 2> srcScaleUV,
+                       TextureView *dstImageView,
+                       std::function<void(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&)> &&recordCb);
+    };
+
     /**
      * @brief Simple helper shader for clearing a texture to a given color
      */
@@ -108,12 +130,214 @@ namespace skyline::gpu {
                   std::function<void(std::function<void(vk::raii::CommandBuffer &, const std::shared_ptr<FenceCycle> &, GPU &, vk::RenderPass, u32)> &&)> &&recordCb);
     };
 
+    /**
+     * @brief Compute helper shader for deswizzling block-linear surfaces from one buffer into another on the GPU, it can also swizzle linear surfaces into block-linear ones
+     */
+    class BlockLinearDeswizzleShader {
+      private:
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::DescriptorSetLayout descriptorSetLayout;
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::Pipeline pipeline;
+
+      public:
+        /**
+         * @brief A single block-linear surface (EG: A mip level of a layer) to deswizzle
+         */
+        struct Surface {
+            vk::DeviceSize blockLinearOffset; //!< The offset of the surface into the block-linear buffer region in bytes, it must be word-aligned
+            vk::DeviceSize linearOffset; //!< The offset of the surface into the linear buffer region in bytes, it must be word-aligned
+            u32 width, height, depth; //!< The dimensions of the surface in pixels
+            u32 formatBlockWidth, formatBlockHeight, formatBpb;
+            u32 gobBlockHeight, gobBlockDepth;
+        };
+
+        BlockLinearDeswizzleShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @return If a surface with lines of the supplied size in bytes can be deswizzled by the shader, it operates on entire words
+         */
+        static constexpr bool IsLineSizeSupported(size_t lineBytes) {
+            return (lineBytes % sizeof(u32)) == 0;
+        }
+
+        /**
+         * @brief Records the commands to deswizzle the supplied surfaces from the block-linear buffer region into the linear buffer region
+         * @note A barrier is recorded after the dispatches to make the linear region available for transfer reads
+         * @return The descriptor set used by the dispatches, it must be kept alive until the commands have completed execution
+         */
+        std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> Deswizzle(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                            vk::DescriptorBufferInfo blockLinear, vk::DescriptorBufferInfo linear,
+                                                                            span<const Surface> surfaces);
+
+        /**
+         * @brief Records the commands to swizzle the supplied surfaces from the linear buffer region into the block-linear buffer region
+         * @note A barrier is recorded after the dispatches to make the block-linear region available for transfer reads, any other usages require a barrier to be recorded by the caller
+         * @return The descriptor set used by the dispatches, it must be kept alive until the commands have completed execution
+         */
+        std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> Swizzle(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                          vk::DescriptorBufferInfo blockLinear, vk::DescriptorBufferInfo linear,
+                                                                          span<const Surface> surfaces);
+
+      private:
+        std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> Dispatch(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                           vk::DescriptorBufferInfo blockLinear, vk::DescriptorBufferInfo linear,
+                                                                           span<const Surface> surfaces, bool swizzle);
+    };
+
+    /**
+     * @brief Compute helper shader for decoding linear ASTC LDR surfaces from one buffer into RGBA8 texels in another on the GPU, this is used when the host doesn't natively support an ASTC format
+     */
+    class AstcDecoderShader {
+      private:
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::DescriptorSetLayout descriptorSetLayout;
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::Pipeline pipeline;
+
+      public:
+        /**
+         * @brief A single linear ASTC surface (EG: All layers of a mip level) to decode
+         */
+        struct Surface {
+            vk::DeviceSize astcOffset; //!< The offset of the surface into the ASTC buffer region in bytes, it must be aligned to the size of a block
+            vk::DeviceSize rgbaOffset; //!< The offset of the surface into the RGBA buffer region in bytes, it must be word-aligned
+            u32 width, height, depth; //!< The dimensions of the surface in pixels, the depth may span multiple layers as long as they're contiguous
+            u32 formatBlockWidth, formatBlockHeight;
+        };
+
+        AstcDecoderShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @brief Records the commands to decode the supplied surfaces from the ASTC buffer region into the RGBA buffer region
+         * @param srgb If the surfaces are sRGB-encoded, this affects the precision of endpoint interpolation
+         * @note A barrier is recorded after the dispatches to make the RGBA region available for transfer reads
+         * @return The descriptor set used by the dispatches, it must be kept alive until the commands have completed execution
+         */
+        std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> Decode(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                         vk::DescriptorBufferInfo astcBuffer, vk::DescriptorBufferInfo rgbaBuffer,
+                                                                         span<const Surface> surfaces, bool srgb);
+    };
+
+    /**
+     * @brief Compute helper shader for converting between packed 24-bit depth/stencil texels and separate 32-bit float depth and 8-bit stencil planes on the GPU, this is used to emulate packed 24-bit depth formats when the host doesn't support them
+     */
+    class DepthStencilConversionShader {
+      private:
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::DescriptorSetLayout descriptorSetLayout;
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::Pipeline pipeline;
+
+      public:
+        /**
+         * @brief A single linear surface (EG: All layers of a mip level) to convert
+         */
+        struct Surface {
+            vk::DeviceSize packedOffset; //!< The offset of the surface into the packed buffer region in bytes, it must be word-aligned
+            vk::DeviceSize depthOffset; //!< The offset of the depth plane into the split buffer region in bytes, it must be word-aligned
+            vk::DeviceSize stencilOffset; //!< The offset of the stencil plane into the split buffer region in bytes, it must be word-aligned and is ignored for surfaces without stencil
+            u32 texelCount; //!< The amount of texels in the surface, the stencil plane must be padded to a multiple of 4 texels
+        };
+
+        DepthStencilConversionShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @brief Records the commands to split the supplied surfaces from the packed buffer region into depth and stencil planes in the split buffer region
+         * @param depthInHighBits If the depth is in the high 24 bits of packed texels (S8Z24) rather than the low 24 bits (Z24S8)
+         * @param hasStencil If the stencil plane should be written, the stencil bits of packed texels are ignored otherwise
+         * @note A barrier is recorded after the dispatches to make the split region available for transfer reads
+         * @return The descriptor set used by the dispatches, it must be kept alive until the commands have completed execution
+         */
+        std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> Unpack(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                         vk::DescriptorBufferInfo packed, vk::DescriptorBufferInfo split,
+                                                                         span<const Surface> surfaces, bool depthInHighBits, bool hasStencil);
+
+        /**
+         * @brief Records the commands to pack the depth and stencil planes of the supplied surfaces in the split buffer region into the packed buffer region
+         * @note Barriers are recorded before the dispatches to make transfer writes to the split region visible and after them to make the packed region available for host reads
+         * @return The descriptor set used by the dispatches, it must be kept alive until the commands have completed execution
+         */
+        std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> Pack(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                       vk::DescriptorBufferInfo packed, vk::DescriptorBufferInfo split,
+                                                                       span<const Surface> surfaces, bool depthInHighBits, bool hasStencil);
+
+      private:
+        std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> Dispatch(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                           vk::DescriptorBufferInfo packed, vk::DescriptorBufferInfo split,
+                                                                           span<const Surface> surfaces, bool depthInHighBits, bool hasStencil, bool pack);
+    };
+
+    /**
+     * @brief Compute helper shader for converting quad list index buffers into triangle list index buffers on the GPU, only 16-bit and 32-bit indices are supported
+     */
+    class QuadIndexConversionShader {
+      private:
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::DescriptorSetLayout descriptorSetLayout;
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::Pipeline pipeline;
+
+      public:
+        QuadIndexConversionShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @brief Records the commands to convert the quads in the source buffer region into triangles in the destination buffer region
+         * @param sourceOffset The offset of the first quad in the source buffer region in bytes, it must be word-aligned
+         * @param quadCount The amount of quads to convert, the destination region must be large enough to hold the indices of two triangles for each
+         * @note A barrier is recorded after the dispatch to make the destination region available for index reads
+         * @return The descriptor set used by the dispatch, it must be kept alive until the commands have completed execution
+         */
+        std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> Convert(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                          vk::DescriptorBufferInfo source, vk::DescriptorBufferInfo destination,
+                                                                          vk::DeviceSize sourceOffset, u32 quadCount, vk::IndexType type);
+    };
+
+    /**
+     * @brief Compute helper shader for resolving Maxwell queries on the GPU, this writes reports from Vulkan occlusion query results and evaluates render enable conditions
+     */
+    class QueryResolveShader {
+      private:
+        vk::raii::ShaderModule shaderModule;
+        vk::raii::DescriptorSetLayout descriptorSetLayout;
+        vk::raii::PipelineLayout pipelineLayout;
+        vk::raii::Pipeline pipeline;
+
+      public:
+        enum class Operation : u32 {
+            ReportOneWord = 0, //!< Writes the low word of the sum of the 64-bit query results in the source
+            ReportFourWords = 1, //!< Writes the 64-bit sum of the query results in the source followed by the timestamp
+            Predicate = 2, //!< Writes a conditional rendering predicate from evaluating the render enable condition in the source
+        };
+
+        QueryResolveShader(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
+
+        /**
+         * @brief Records the commands to resolve a query from the source buffer region into the destination buffer region
+         * @param sourceOffset The offset of the source data in the source buffer region in bytes, it must be word-aligned
+         * @param destinationOffset The offset of the output in the destination buffer region in bytes, it must be word-aligned
+         * @param parameter The amount of query results in the source for reports or the render enable mode for predicates
+         * @note A barrier is recorded after the dispatch to make the destination region available for any subsequent reads, including conditional rendering
+         * @return The descriptor set used by the dispatch, it must be kept alive until the commands have completed execution
+         */
+        std::shared_ptr<DescriptorAllocator::ActiveDescriptorSet> Resolve(GPU &gpu, const vk::raii::CommandBuffer &commandBuffer,
+                                                                          vk::DescriptorBufferInfo source, vk::DescriptorBufferInfo destination,
+                                                                          vk::DeviceSize sourceOffset, vk::DeviceSize destinationOffset,
+                                                                          Operation operation, u32 parameter, u64 timestamp = 0);
+    };
+
     /**
      * @brief Holds all helper shaders to avoid redundantly recreating them on each usage
      */
     struct HelperShaders {
         BlitHelperShader blitHelperShader;
         ClearHelperShader clearHelperShader;
+        VideoCompositorShader videoCompositorShader;
+        BlockLinearDeswizzleShader blockLinearDeswizzleShader;
+        AstcDecoderShader astcDecoderShader;
+        DepthStencilConversionShader depthStencilConversionShader;
+        QuadIndexConversionShader quadIndexConversionShader;
+        QueryResolveShader queryResolveShader;
 
         HelperShaders(GPU &gpu, std::shared_ptr<vfs::FileSystem> shaderFileSystem);
     };
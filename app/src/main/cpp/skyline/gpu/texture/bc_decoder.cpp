@@ -9,6 +9,10 @@
 #include <fmt/printf.h>
 #include <common.h>
 
+#ifdef __aarch64__
+#include <arm_neon.h>
+#endif
+
 #ifdef NDEBUG
 #define ASSERT(condition)
 #define ASSERT_MSG(condition, message, ...)
@@ -28,28 +32,35 @@ namespace {
 
     struct BC_color {
         void decode(uint8_t *dst, size_t x, size_t y, size_t dstW, size_t dstH, size_t dstPitch, size_t dstBpp, bool hasAlphaChannel, bool hasSeparateAlpha) const {
-            Color c[4];
-            c[0].extract565(c0);
-            c[1].extract565(c1);
-            if (hasSeparateAlpha || (c0 > c1)) {
-                c[2] = ((c[0] * 2) + c[1]) / 3;
-                c[3] = ((c[1] * 2) + c[0]) / 3;
-            } else {
-                c[2] = (c[0] + c[1]) >> 1;
-                if (hasAlphaChannel) {
-                    c[3].clearAlpha();
-                }
-            }
+            unsigned int c[4];
+            palette(c, hasAlphaChannel, hasSeparateAlpha);
 
             for (int j = 0; j < BlockHeight && (y + j) < dstH; j++) {
                 size_t dstOffset = j * dstPitch;
                 size_t idxOffset = j * BlockHeight;
                 for (size_t i = 0; i < BlockWidth && (x + i) < dstW; i++, idxOffset++, dstOffset += dstBpp) {
-                    *reinterpret_cast<unsigned int *>(dst + dstOffset) = c[getIdx(idxOffset)].pack8888();
+                    *reinterpret_cast<unsigned int *>(dst + dstOffset) = c[getIdx(idxOffset)];
                 }
             }
         }
 
+#ifdef __aarch64__
+        // Decodes an entire block to R8G8B8A8 with a vector per row of the block, the palette is looked up with a single TBL per row
+        void decodeBlock(uint8x16_t rows[BlockHeight], bool hasAlphaChannel, bool hasSeparateAlpha) const {
+            unsigned int c[4];
+            palette(c, hasAlphaChannel, hasSeparateAlpha);
+            uint8x16_t table = vreinterpretq_u8_u32(vld1q_u32(c));
+
+            const int32x4_t shifts = {0, -2, -4, -6};
+            uint32x4_t indices = vdupq_n_u32(idx);
+            for (int j = 0; j < BlockHeight; j++) {
+                uint32x4_t pixelIdx = vandq_u32(vshlq_u32(indices, vaddq_s32(shifts, vdupq_n_s32(-8 * j))), vdupq_n_u32(0x3));
+                uint8x16_t byteIdx = vreinterpretq_u8_u32(vmlaq_u32(vdupq_n_u32(0x03020100), pixelIdx, vdupq_n_u32(0x04040404)));
+                rows[j] = vqtbl1q_u8(table, byteIdx);
+            }
+        }
+#endif
+
       private:
         struct Color {
             Color() {
@@ -107,6 +118,25 @@ namespace {
             int c[4];
         };
 
+        void palette(unsigned int out[4], bool hasAlphaChannel, bool hasSeparateAlpha) const {
+            Color c[4];
+            c[0].extract565(c0);
+            c[1].extract565(c1);
+            if (hasSeparateAlpha || (c0 > c1)) {
+                c[2] = ((c[0] * 2) + c[1]) / 3;
+                c[3] = ((c[1] * 2) + c[0]) / 3;
+            } else {
+                c[2] = (c[0] + c[1]) >> 1;
+                if (hasAlphaChannel) {
+                    c[3].clearAlpha();
+                }
+            }
+
+            for (int i = 0; i < 4; ++i) {
+                out[i] = c[i].pack8888();
+            }
+        }
+
         size_t getIdx(int i) const {
             size_t offset = i << 1;  // 2 bytes per index
             return (idx & (0x3 << offset)) >> offset;
@@ -121,7 +151,37 @@ namespace {
     struct BC_channel {
         void decode(uint8_t *dst, size_t x, size_t y, size_t dstW, size_t dstH, size_t dstPitch, size_t dstBpp, size_t channel, bool isSigned) const {
             int c[8] = {0};
+            palette(c, isSigned);
+
+            for (size_t j = 0; j < BlockHeight && (y + j) < dstH; j++) {
+                for (size_t i = 0; i < BlockWidth && (x + i) < dstW; i++) {
+                    dst[channel + (i * dstBpp) + (j * dstPitch)] = static_cast<uint8_t>(c[getIdx((j * BlockHeight) + i)]);
+                }
+            }
+        }
+
+#ifdef __aarch64__
+        // Decodes an entire block into a vector of all 16 channel values in row-major order, the 3-bit indices are extracted in parallel and the palette is looked up with a single TBL
+        uint8x16_t decodeBlock(bool isSigned) const {
+            int c[8] = {0};
+            palette(c, isSigned);
+            uint8_t table[16] = {};
+            for (size_t i = 0; i < 8; ++i) {
+                table[i] = static_cast<uint8_t>(c[i]);
+            }
+
+            uint64_t bits = data >> 16;
+            uint32x4_t low = vdupq_n_u32(bits & 0xFFFFFF), high = vdupq_n_u32(bits >> 24);
+            const int32x4_t shiftsLow = {0, -3, -6, -9}, shiftsHigh = {-12, -15, -18, -21};
+            const uint32x4_t mask = vdupq_n_u32(0x7);
+            uint16x8_t idxLow = vcombine_u16(vmovn_u32(vandq_u32(vshlq_u32(low, shiftsLow), mask)), vmovn_u32(vandq_u32(vshlq_u32(low, shiftsHigh), mask)));
+            uint16x8_t idxHigh = vcombine_u16(vmovn_u32(vandq_u32(vshlq_u32(high, shiftsLow), mask)), vmovn_u32(vandq_u32(vshlq_u32(high, shiftsHigh), mask)));
+            return vqtbl1q_u8(vld1q_u8(table), vcombine_u8(vmovn_u16(idxLow), vmovn_u16(idxHigh)));
+        }
+#endif
 
+      private:
+        void palette(int c[8], bool isSigned) const {
             if (isSigned) {
                 c[0] = static_cast<signed char>(data & 0xFF);
                 c[1] = static_cast<signed char>((data & 0xFF00) >> 8);
@@ -141,15 +201,8 @@ namespace {
                 c[6] = isSigned ? -128 : 0;
                 c[7] = isSigned ? 127 : 255;
             }
-
-            for (size_t j = 0; j < BlockHeight && (y + j) < dstH; j++) {
-                for (size_t i = 0; i < BlockWidth && (x + i) < dstW; i++) {
-                    dst[channel + (i * dstBpp) + (j * dstPitch)] = static_cast<uint8_t>(c[getIdx((j * BlockHeight) + i)]);
-                }
-            }
         }
 
-      private:
         uint8_t getIdx(int i) const {
             int offset = i * 3 + 16;
             return static_cast<uint8_t>((data & (0x7ull << offset)) >> offset);
@@ -1497,13 +1550,40 @@ namespace bcn {
     constexpr size_t R8g8b8a8Bpp{4}; //!< The amount of bytes per pixel in R8G8B8A8
     constexpr size_t R16g16b16a16Bpp{8}; //!< The amount of bytes per pixel in R16G16B16
 
+#ifdef __aarch64__
+    /**
+     * @return If the block at the supplied position is entirely inside the image, only such blocks can be decoded with the NEON paths as they write out entire rows
+     */
+    constexpr bool IsFullBlock(size_t x, size_t y, size_t width, size_t height) {
+        return (x + BlockWidth) <= width && (y + BlockHeight) <= height;
+    }
+
+    /**
+     * @brief Stores the rows of a decoded R8G8B8A8 block into the destination image
+     */
+    void StoreRgbaBlock(uint8_t *dst, size_t pitch, const uint8x16_t rows[BlockHeight]) {
+        for (size_t j{}; j < BlockHeight; j++, dst += pitch)
+            vst1q_u8(dst, rows[j]);
+    }
+#endif
+
     void DecodeBc1(const uint8_t *src, uint8_t *dst, size_t width, size_t height, bool hasAlphaChannel) {
         const auto *color{reinterpret_cast<const BC_color *>(src)};
         size_t pitch{R8g8b8a8Bpp * width};
         for (size_t y{}; y < height; y += BlockHeight, dst += BlockHeight * pitch) {
             uint8_t *dstRow{dst};
-            for (size_t x{}; x < width; x += BlockWidth, ++color, dstRow += BlockWidth * R8g8b8a8Bpp)
+            for (size_t x{}; x < width; x += BlockWidth, ++color, dstRow += BlockWidth * R8g8b8a8Bpp) {
+                #ifdef __aarch64__
+                if (IsFullBlock(x, y, width, height)) {
+                    uint8x16_t rows[BlockHeight];
+                    color->decodeBlock(rows, hasAlphaChannel, false);
+                    StoreRgbaBlock(dstRow, pitch, rows);
+                    continue;
+                }
+                #endif
+
                 [[clang::always_inline]] color->decode(dstRow, x, y, width, height, pitch, R8g8b8a8Bpp, hasAlphaChannel, false);
+            }
         }
     }
 
@@ -1514,6 +1594,16 @@ namespace bcn {
         for (size_t y{}; y < height; y += BlockHeight, dst += BlockHeight * pitch) {
             uint8_t *dstRow{dst};
             for (size_t x{}; x < width; x += BlockWidth, alpha += 2, color += 2, dstRow += BlockWidth * R8g8b8a8Bpp) {
+                #ifdef __aarch64__
+                if (IsFullBlock(x, y, width, height)) {
+                    uint8x16_t rows[BlockHeight];
+                    color->decodeBlock(rows, false, true);
+                    StoreRgbaBlock(dstRow, pitch, rows);
+                    [[clang::always_inline]] alpha->decode(dstRow, x, y, width, height, pitch, R8g8b8a8Bpp);
+                    continue;
+                }
+                #endif
+
                 [[clang::always_inline]] color->decode(dstRow, x, y, width, height, pitch, R8g8b8a8Bpp, false, true);
                 [[clang::always_inline]] alpha->decode(dstRow, x, y, width, height, pitch, R8g8b8a8Bpp);
             }
@@ -1527,6 +1617,24 @@ namespace bcn {
         for (size_t y{}; y < height; y += BlockHeight, dst += BlockHeight * pitch) {
             uint8_t *dstRow{dst};
             for (size_t x{}; x < width; x += BlockWidth, alpha += 2, color += 2, dstRow += BlockWidth * R8g8b8a8Bpp) {
+                #ifdef __aarch64__
+                if (IsFullBlock(x, y, width, height)) {
+                    uint8x16_t rows[BlockHeight];
+                    color->decodeBlock(rows, false, true);
+
+                    // The alpha values are moved into the upper byte of every pixel and selected over the opaque alpha from the color block
+                    // Note: The out-of-range indices for the color bytes are chosen such that they stay out-of-range after the row offset is added
+                    uint8x16_t alphaValues{alpha->decodeBlock(false)};
+                    const uint8x16_t alphaMask{vreinterpretq_u8_u32(vdupq_n_u32(0xFF000000))};
+                    const uint8x16_t alphaIdx{0x80, 0x80, 0x80, 0, 0x80, 0x80, 0x80, 1, 0x80, 0x80, 0x80, 2, 0x80, 0x80, 0x80, 3};
+                    for (size_t j{}; j < BlockHeight; j++)
+                        rows[j] = vbslq_u8(alphaMask, vqtbl1q_u8(alphaValues, vaddq_u8(alphaIdx, vdupq_n_u8(static_cast<uint8_t>(j * BlockWidth)))), rows[j]);
+
+                    StoreRgbaBlock(dstRow, pitch, rows);
+                    continue;
+                }
+                #endif
+
                 [[clang::always_inline]] color->decode(dstRow, x, y, width, height, pitch, R8g8b8a8Bpp, false, true);
                 [[clang::always_inline]] alpha->decode(dstRow, x, y, width, height, pitch, R8g8b8a8Bpp, 3, false);
             }
@@ -1538,8 +1646,19 @@ namespace bcn {
         size_t pitch{R8Bpp * width};
         for (size_t y{}; y < height; y += BlockHeight, dst += BlockHeight * pitch) {
             uint8_t *dstRow{dst};
-            for (size_t x{}; x < width; x += BlockWidth, ++red, dstRow += BlockWidth * R8Bpp)
+            for (size_t x{}; x < width; x += BlockWidth, ++red, dstRow += BlockWidth * R8Bpp) {
+                #ifdef __aarch64__
+                if (IsFullBlock(x, y, width, height)) {
+                    uint8_t values[BlockWidth * BlockHeight];
+                    vst1q_u8(values, red->decodeBlock(isSigned));
+                    for (size_t j{}; j < BlockHeight; j++)
+                        std::memcpy(dstRow + (j * pitch), values + (j * BlockWidth), BlockWidth * R8Bpp);
+                    continue;
+                }
+                #endif
+
                 [[clang::always_inline]] red->decode(dstRow, x, y, width, height, pitch, R8Bpp, 0, isSigned);
+            }
         }
     }
 
@@ -1550,6 +1669,19 @@ namespace bcn {
         for (size_t y{}; y < height; y += BlockHeight, dst += BlockHeight * pitch) {
             uint8_t *dstRow{dst};
             for (size_t x{}; x < width; x += BlockWidth, red += 2, green += 2, dstRow += BlockWidth * R8g8Bpp) {
+                #ifdef __aarch64__
+                if (IsFullBlock(x, y, width, height)) {
+                    // Interleaving the red and green values yields two rows of R8G8 pixels per vector
+                    uint8x16_t redValues{red->decodeBlock(isSigned)}, greenValues{green->decodeBlock(isSigned)};
+                    uint8x16_t upperRows{vzip1q_u8(redValues, greenValues)}, lowerRows{vzip2q_u8(redValues, greenValues)};
+                    vst1_u8(dstRow, vget_low_u8(upperRows));
+                    vst1_u8(dstRow + pitch, vget_high_u8(upperRows));
+                    vst1_u8(dstRow + (2 * pitch), vget_low_u8(lowerRows));
+                    vst1_u8(dstRow + (3 * pitch), vget_high_u8(lowerRows));
+                    continue;
+                }
+                #endif
+
                 [[clang::always_inline]] red->decode(dstRow, x, y, width, height, pitch, R8g8Bpp, 0, isSigned);
                 [[clang::always_inline]] green->decode(dstRow, x, y, width, height, pitch, R8g8Bpp, 1, isSigned);
             }
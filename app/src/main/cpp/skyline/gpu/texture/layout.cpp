@@ -1,6 +1,9 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#ifdef __aarch64__
+#include <arm_neon.h>
+#endif
 #include "layout.h"
 
 namespace skyline::gpu::texture {
@@ -88,15 +91,64 @@ namespace skyline::gpu::texture {
         return mipLevels;
     }
 
+    /**
+     * @brief Copies a single GOB between its swizzled and linear representations
+     * @param lineStride The stride between lines in the linear surface in bytes
+     * @note The GOB must lie entirely within the bounds of the surface as no clipping is performed
+     */
+    template<bool BlockLinearToLinear>
+    __attribute__((always_inline)) inline void CopyGob(u8 *gob, u8 *linearGob, size_t lineStride) {
+        #ifdef __aarch64__
+        // Every 4 sequential sectors of a GOB form a 32x2 region, they're ordered as (X: 0, Y: 0), (X: 0, Y: 1), (X: 16, Y: 0), (X: 16, Y: 1)
+        #pragma clang loop unroll(full)
+        for (size_t index{}; index < SectorLinesInGob; index += 4) {
+            size_t xT{((index << 1) & 0b100000)}; // Morton-Swizzle on the X-axis, bit 1 of the index is always 0 here
+            size_t yT{((index >> 1) & 0b110)}; // Morton-Swizzle on the Y-axis, bit 0 of the index is always 0 here
+
+            u8 *linearLine{linearGob + (yT * lineStride) + xT};
+            if constexpr (BlockLinearToLinear) {
+                uint8x16x4_t sectors{vld1q_u8_x4(gob)};
+                vst1q_u8_x2(linearLine, uint8x16x2_t{{sectors.val[0], sectors.val[2]}});
+                vst1q_u8_x2(linearLine + lineStride, uint8x16x2_t{{sectors.val[1], sectors.val[3]}});
+            } else {
+                uint8x16x2_t firstLine{vld1q_u8_x2(linearLine)}, secondLine{vld1q_u8_x2(linearLine + lineStride)};
+                vst1q_u8_x4(gob, uint8x16x4_t{{firstLine.val[0], secondLine.val[0], firstLine.val[1], secondLine.val[1]}});
+            }
+
+            gob += SectorWidth * 4;
+        }
+        #else
+        #pragma clang loop unroll_count(SectorLinesInGob)
+        for (size_t index{}; index < SectorLinesInGob; index++) {
+            size_t xT{((index << 3) & 0b10000) | ((index << 1) & 0b100000)}; // Morton-Swizzle on the X-axis
+            size_t yT{((index >> 1) & 0b110) | (index & 0b1)}; // Morton-Swizzle on the Y-axis
+
+            if constexpr (BlockLinearToLinear)
+                std::memcpy(linearGob + (yT * lineStride) + xT, gob, SectorWidth);
+            else
+                std::memcpy(gob, linearGob + (yT * lineStride) + xT, SectorWidth);
+            gob += SectorWidth;
+        }
+        #endif
+    }
+
     /**
      * @brief Copies pixel data between a linear and blocklinear texture
      * @tparam BlockLinearToLinear Whether to copy from a blocklinear texture to a linear texture or a linear texture to a blocklinear texture
+     * @tparam BlockHeight A compile-time value for the height of a block in GOBs, 0 if it should be determined at runtime from the arguments
+     * @tparam FormatBpb A compile-time value for the bytes per block of the format, 0 if it should be determined at runtime from the arguments
      */
-    template<bool BlockLinearToLinear>
+    template<bool BlockLinearToLinear, size_t BlockHeight = 0, size_t FormatBpb = 0>
     void CopyBlockLinearInternal(Dimensions dimensions,
                                  size_t formatBlockWidth, size_t formatBlockHeight, size_t formatBpb,
                                  size_t gobBlockHeight, size_t gobBlockDepth,
                                  u8 *blockLinear, u8 *linear) {
+        // Replace any specialized arguments with their compile-time counterparts, so they can be folded into the loops below
+        if constexpr (BlockHeight != 0)
+            gobBlockHeight = BlockHeight;
+        if constexpr (FormatBpb != 0)
+            formatBpb = FormatBpb;
+
         size_t robWidthUnalignedBytes{util::DivideCeil<size_t>(dimensions.width, formatBlockWidth) * formatBpb};
         size_t robWidthBytes{util::AlignUp(robWidthUnalignedBytes, GobWidth)};
         size_t robWidthBlocks{robWidthUnalignedBytes / GobWidth};
@@ -119,22 +171,28 @@ namespace skyline::gpu::texture {
         u8 *sector{blockLinear};
 
         auto deswizzleRob{[&](u8 *linearRob, auto isLastRob, size_t blockPaddingY = 0, size_t blockExtentY = 0) {
-            auto deswizzleBlock{[&](u8 *linearBlock, auto copySector) __attribute__((always_inline)) {
+            auto deswizzleBlock{[&](u8 *linearBlock, auto isFullBlock, auto copySector) __attribute__((always_inline)) {
                 for (size_t gobZ{}; gobZ < blockDepth; gobZ++) { // Every Block contains `blockDepth` Z-axis GOBs (Slices)
                     u8 *linearGob{linearBlock};
-                    for (size_t gobY{}; gobY < blockHeight; gobY++) { // Every Block contains `blockHeight` Y-axis GOBs
-                        #pragma clang loop unroll_count(SectorLinesInGob)
-                        for (size_t index{}; index < SectorLinesInGob; index++) {
-                            size_t xT{((index << 3) & 0b10000) | ((index << 1) & 0b100000)}; // Morton-Swizzle on the X-axis
-                            size_t yT{((index >> 1) & 0b110) | (index & 0b1)}; // Morton-Swizzle on the Y-axis
-
-                            if constexpr (!isLastRob) {
-                                copySector(linearGob + (yT * robWidthUnalignedBytes) + xT, xT);
-                            } else {
-                                if (gobY != blockHeight - 1 || yT < blockExtentY)
+                    for (size_t gobY{}; gobY < (isLastRob ? blockHeight : gobBlockHeight); gobY++) { // Every Block contains `blockHeight` Y-axis GOBs
+                        if constexpr (isFullBlock && !isLastRob) {
+                            // A full block in a full ROB is entirely within the surface, so we can copy entire GOBs without any bounds checks
+                            CopyGob<BlockLinearToLinear>(sector, linearGob, robWidthUnalignedBytes);
+                            sector += GobWidth * GobHeight;
+                        } else {
+                            #pragma clang loop unroll_count(SectorLinesInGob)
+                            for (size_t index{}; index < SectorLinesInGob; index++) {
+                                size_t xT{((index << 3) & 0b10000) | ((index << 1) & 0b100000)}; // Morton-Swizzle on the X-axis
+                                size_t yT{((index >> 1) & 0b110) | (index & 0b1)}; // Morton-Swizzle on the Y-axis
+
+                                if constexpr (!isLastRob) {
                                     copySector(linearGob + (yT * robWidthUnalignedBytes) + xT, xT);
-                                else
-                                    sector += SectorWidth;
+                                } else {
+                                    if (gobY != blockHeight - 1 || yT < blockExtentY)
+                                        copySector(linearGob + (yT * robWidthUnalignedBytes) + xT, xT);
+                                    else
+                                        sector += SectorWidth;
+                                }
                             }
                         }
 
@@ -148,7 +206,7 @@ namespace skyline::gpu::texture {
             }};
 
             for (size_t block{}; block < robWidthBlocks; block++) { // Every ROB contains `surfaceWidthBlocks` blocks (excl. padding block)
-                deswizzleBlock(linearRob, [&](u8 *linearSector, size_t) __attribute__((always_inline)) {
+                deswizzleBlock(linearRob, std::true_type{}, [&](u8 *linearSector, size_t) __attribute__((always_inline)) {
                     if constexpr (BlockLinearToLinear)
                         std::memcpy(linearSector, sector, SectorWidth);
                     else
@@ -162,7 +220,7 @@ namespace skyline::gpu::texture {
             }
 
             if (hasPaddingBlock)
-                deswizzleBlock(linearRob, [&](u8 *linearSector, size_t xT) __attribute__((always_inline)) {
+                deswizzleBlock(linearRob, std::false_type{}, [&](u8 *linearSector, size_t xT) __attribute__((always_inline)) {
                     #pragma clang loop unroll_count(4)
                     for (size_t pixelOffset{}; pixelOffset < SectorWidth; pixelOffset += formatBpb) {
                         if (xT < blockPaddingOffset)
@@ -196,8 +254,62 @@ namespace skyline::gpu::texture {
         }
     }
 
+    /**
+     * @brief Selects a specialization of CopyBlockLinearInternal for the supplied format bytes per block
+     */
+    template<bool BlockLinearToLinear, size_t BlockHeight>
+    void CopyBlockLinearSpecializedBpb(Dimensions dimensions,
+                                       size_t formatBlockWidth, size_t formatBlockHeight, size_t formatBpb,
+                                       size_t gobBlockHeight, size_t gobBlockDepth,
+                                       u8 *blockLinear, u8 *linear) {
+        #define BPB_CASE(bpb) \
+            case bpb: \
+                return CopyBlockLinearInternal<BlockLinearToLinear, BlockHeight, bpb>(dimensions, formatBlockWidth, formatBlockHeight, formatBpb, gobBlockHeight, gobBlockDepth, blockLinear, linear)
+
+        switch (formatBpb) {
+            BPB_CASE(1);
+            BPB_CASE(2);
+            BPB_CASE(4);
+            BPB_CASE(8);
+            BPB_CASE(16);
+
+            default:
+                return CopyBlockLinearInternal<BlockLinearToLinear, BlockHeight>(dimensions, formatBlockWidth, formatBlockHeight, formatBpb, gobBlockHeight, gobBlockDepth, blockLinear, linear);
+        }
+
+        #undef BPB_CASE
+    }
+
+    /**
+     * @brief Selects a specialization of CopyBlockLinearInternal for the supplied block height and format bytes per block at runtime
+     * @note The specializations allow the compiler to fully unroll the GOB loops and use fixed-size copies for the padding block
+     */
+    template<bool BlockLinearToLinear>
+    void CopyBlockLinearSpecialized(Dimensions dimensions,
+                                    size_t formatBlockWidth, size_t formatBlockHeight, size_t formatBpb,
+                                    size_t gobBlockHeight, size_t gobBlockDepth,
+                                    u8 *blockLinear, u8 *linear) {
+        #define BLOCK_HEIGHT_CASE(height) \
+            case height: \
+                return CopyBlockLinearSpecializedBpb<BlockLinearToLinear, height>(dimensions, formatBlockWidth, formatBlockHeight, formatBpb, gobBlockHeight, gobBlockDepth, blockLinear, linear)
+
+        switch (gobBlockHeight) {
+            BLOCK_HEIGHT_CASE(1);
+            BLOCK_HEIGHT_CASE(2);
+            BLOCK_HEIGHT_CASE(4);
+            BLOCK_HEIGHT_CASE(8);
+            BLOCK_HEIGHT_CASE(16);
+            BLOCK_HEIGHT_CASE(32);
+
+            default:
+                return CopyBlockLinearSpecializedBpb<BlockLinearToLinear, 0>(dimensions, formatBlockWidth, formatBlockHeight, formatBpb, gobBlockHeight, gobBlockDepth, blockLinear, linear);
+        }
+
+        #undef BLOCK_HEIGHT_CASE
+    }
+
     void CopyBlockLinearToLinear(Dimensions dimensions, size_t formatBlockWidth, size_t formatBlockHeight, size_t formatBpb, size_t gobBlockHeight, size_t gobBlockDepth, u8 *blockLinear, u8 *linear) {
-        CopyBlockLinearInternal<true>(
+        CopyBlockLinearSpecialized<true>(
             dimensions,
             formatBlockWidth, formatBlockHeight, formatBpb,
             gobBlockHeight, gobBlockDepth,
@@ -206,7 +318,7 @@ namespace skyline::gpu::texture {
     }
 
     void CopyBlockLinearToLinear(const GuestTexture &guest, u8 *blockLinear, u8 *linear) {
-        CopyBlockLinearInternal<true>(
+        CopyBlockLinearSpecialized<true>(
             guest.dimensions,
             guest.format->blockWidth, guest.format->blockHeight, guest.format->bpb,
             guest.tileConfig.blockHeight, guest.tileConfig.blockDepth,
@@ -215,7 +327,7 @@ namespace skyline::gpu::texture {
     }
 
     void CopyLinearToBlockLinear(Dimensions dimensions, size_t formatBlockWidth, size_t formatBlockHeight, size_t formatBpb, size_t gobBlockHeight, size_t gobBlockDepth, u8 *linear, u8 *blockLinear) {
-        CopyBlockLinearInternal<false>(
+        CopyBlockLinearSpecialized<false>(
             dimensions,
             formatBlockWidth, formatBlockHeight, formatBpb,
             gobBlockHeight, gobBlockDepth,
@@ -224,7 +336,7 @@ namespace skyline::gpu::texture {
     }
 
     void CopyLinearToBlockLinear(const GuestTexture &guest, u8 *linear, u8 *blockLinear) {
-        CopyBlockLinearInternal<false>(
+        CopyBlockLinearSpecialized<false>(
             guest.dimensions,
             guest.format->blockWidth, guest.format->blockHeight, guest.format->bpb,
             guest.tileConfig.blockHeight, guest.tileConfig.blockDepth,
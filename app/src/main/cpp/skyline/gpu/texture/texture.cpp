@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <boost/functional/hash.hpp>
 #include <gpu.h>
 #include <kernel/memory.h>
 #include <kernel/types/KProcess.h>
@@ -78,16 +79,25 @@ namespace skyline::gpu {
 
     TextureView::TextureView(std::shared_ptr<Texture> texture, vk::ImageViewType type, vk::ImageSubresourceRange range, texture::Format format, vk::ComponentMapping mapping) : texture(std::move(texture)), type(type), format(format), mapping(mapping), range(range) {}
 
-    Texture::TextureViewStorage::TextureViewStorage(vk::ImageViewType type, texture::Format format, vk::ComponentMapping mapping, vk::ImageSubresourceRange range, vk::raii::ImageView &&vkView) : type(type), format(format), mapping(mapping), range(range), vkView(std::move(vkView)) {}
+    size_t Texture::ViewKeyHash::operator()(const ViewKey &key) const {
+        size_t hash{};
+        boost::hash_combine(hash, static_cast<u32>(key.type));
+        boost::hash_combine(hash, key.format ? static_cast<u32>(key.format->vkFormat) : 0); // Formats are compared by value, so they must be hashed by value too
+        boost::hash_combine(hash, static_cast<u32>(key.mapping.r) | (static_cast<u32>(key.mapping.g) << 8) | (static_cast<u32>(key.mapping.b) << 16) | (static_cast<u32>(key.mapping.a) << 24));
+        boost::hash_combine(hash, static_cast<u32>(key.range.aspectMask));
+        boost::hash_combine(hash, key.range.baseMipLevel);
+        boost::hash_combine(hash, key.range.levelCount);
+        boost::hash_combine(hash, key.range.baseArrayLayer);
+        boost::hash_combine(hash, key.range.layerCount);
+        return hash;
+    }
 
     vk::ImageView TextureView::GetView() {
         if (vkView)
             return vkView;
 
-        auto it{std::find_if(texture->views.begin(), texture->views.end(), [this](const Texture::TextureViewStorage &view) {
-            return view.type == type && view.format == format && view.mapping == mapping && view.range == range;
-        })};
-        if (it == texture->views.end()) {
+        auto &cachedView{texture->views[Texture::ViewKey{type, format, mapping, range}]};
+        if (!cachedView.vkView) {
             vk::ImageViewCreateInfo createInfo{
                 .image = texture->GetBacking(),
                 .viewType = type,
@@ -96,10 +106,10 @@ namespace skyline::gpu {
                 .subresourceRange = range,
             };
 
-            it = texture->views.emplace(texture->views.end(), type, format, mapping, range, vk::raii::ImageView{texture->gpu.vkDevice, createInfo});
+            cachedView.vkView.emplace(texture->gpu.vkDevice, createInfo);
         }
 
-        return vkView = *it->vkView;
+        return vkView = **cachedView.vkView;
     }
 
     void TextureView::lock() {
@@ -124,37 +134,77 @@ namespace skyline::gpu {
 
     void Texture::SetupGuestMappings() {
         auto &mappings{guest->mappings};
-        if (mappings.size() == 1) {
-            auto mapping{mappings.front()};
-            u8 *alignedData{util::AlignDown(mapping.data(), constant::PageSize)};
-            size_t alignedSize{static_cast<size_t>(util::AlignUp(mapping.data() + mapping.size(), constant::PageSize) - alignedData)};
 
-            alignedMirror = gpu.state.process->memory.CreateMirror(span<u8>{alignedData, alignedSize});
-            mirror = alignedMirror.subspan(static_cast<size_t>(mapping.data() - alignedData), mapping.size());
-        } else {
-            std::vector<span<u8>> alignedMappings;
+        // The mirror is only created once as a direct texture requires it to be set up prior to the backing being created
+        if (!alignedMirror.valid()) {
+            if (mappings.size() == 1) {
+                auto mapping{mappings.front()};
+                u8 *alignedData{util::AlignDown(mapping.data(), constant::PageSize)};
+                size_t alignedSize{static_cast<size_t>(util::AlignUp(mapping.data() + mapping.size(), constant::PageSize) - alignedData)};
 
-            const auto &frontMapping{mappings.front()};
-            u8 *alignedData{util::AlignDown(frontMapping.data(), constant::PageSize)};
-            alignedMappings.emplace_back(alignedData, (frontMapping.data() + frontMapping.size()) - alignedData);
+                alignedMirror = gpu.state.process->memory.CreateMirror(span<u8>{alignedData, alignedSize});
+                mirror = alignedMirror.subspan(static_cast<size_t>(mapping.data() - alignedData), mapping.size());
+            } else {
+                std::vector<span<u8>> alignedMappings;
 
-            size_t totalSize{frontMapping.size()};
-            for (auto it{std::next(mappings.begin())}; it != std::prev(mappings.end()); ++it) {
-                auto mappingSize{it->size()};
-                alignedMappings.emplace_back(it->data(), mappingSize);
-                totalSize += mappingSize;
-            }
+                const auto &frontMapping{mappings.front()};
+                u8 *alignedData{util::AlignDown(frontMapping.data(), constant::PageSize)};
+                alignedMappings.emplace_back(alignedData, (frontMapping.data() + frontMapping.size()) - alignedData);
 
-            const auto &backMapping{mappings.back()};
-            totalSize += backMapping.size();
-            alignedMappings.emplace_back(backMapping.data(), util::AlignUp(backMapping.size(), constant::PageSize));
+                size_t totalSize{frontMapping.size()};
+                for (auto it{std::next(mappings.begin())}; it != std::prev(mappings.end()); ++it) {
+                    auto mappingSize{it->size()};
+                    alignedMappings.emplace_back(it->data(), mappingSize);
+                    totalSize += mappingSize;
+                }
+
+                const auto &backMapping{mappings.back()};
+                totalSize += backMapping.size();
+                alignedMappings.emplace_back(backMapping.data(), util::AlignUp(backMapping.size(), constant::PageSize));
 
-            alignedMirror = gpu.state.process->memory.CreateMirrors(alignedMappings);
-            mirror = alignedMirror.subspan(static_cast<size_t>(frontMapping.data() - alignedData), totalSize);
+                alignedMirror = gpu.state.process->memory.CreateMirrors(alignedMappings);
+                mirror = alignedMirror.subspan(static_cast<size_t>(frontMapping.data() - alignedData), totalSize);
+            }
         }
 
+        if (isDirect)
+            return; // Direct textures alias the guest mappings, so there is no need to trap them for synchronization
+
         // We can't just capture `this` in the lambda since the lambda could exceed the lifetime of the buffer
         std::weak_ptr<Texture> weakThis{weak_from_this()};
+        auto writeCallback{[weakThis] {
+            TRACE_EVENT("gpu", "Texture::WriteTrap");
+
+            auto texture{weakThis.lock()};
+            if (!texture)
+                return true;
+
+            std::unique_lock stateLock{texture->stateMutex, std::try_to_lock};
+            if (!stateLock)
+                return false;
+
+            if (texture->dirtyState != DirtyState::GpuDirty) {
+                texture->dirtyState = DirtyState::CpuDirty;
+                texture->partiallyCpuDirty = false;
+                return true; // If the texture is already CPU dirty or we can transition it to being CPU dirty then we don't need to do anything
+            }
+
+            if (texture->accumulatedGuestWaitTime > SkipReadbackHackWaitTimeThreshold && *texture->gpu.state.settings->enableFastGpuReadbackHack) {
+                texture->dirtyState = DirtyState::Clean;
+                return true;
+            }
+
+            std::unique_lock lock{*texture, std::try_to_lock};
+            if (!lock)
+                return false;
+
+            if (texture->cycle)
+                return false;
+
+            texture->SynchronizeGuest(true, true); // We need to assume the texture is dirty since we don't know what the guest is writing
+            return true;
+        }};
+
         trapHandle = gpu.state.nce->CreateTrap(mappings, [weakThis] {
             auto texture{weakThis.lock()};
             if (!texture)
@@ -209,47 +259,265 @@ namespace skyline::gpu {
 
             texture->SynchronizeGuest(false, true); // We can skip trapping since the caller will do it
             return true;
-        }, [weakThis] {
-            TRACE_EVENT("gpu", "Texture::WriteTrap");
+        }, writeCallback, layerCount * levelCount > 1 ? nce::NCE::PageWriteCallback{[weakThis](u8 *page) {
+            // Writes are only tracked at page granularity for textures with multiple subresources as single subresource textures would be entirely resynchronized regardless
+            TRACE_EVENT("gpu", "Texture::PageWriteTrap");
+            using PageWriteResult = nce::NCE::PageWriteResult;
 
             auto texture{weakThis.lock()};
             if (!texture)
-                return true;
+                return PageWriteResult::Untrapped;
 
             std::unique_lock stateLock{texture->stateMutex, std::try_to_lock};
             if (!stateLock)
-                return false;
+                return PageWriteResult::WouldBlock;
 
-            if (texture->dirtyState != DirtyState::GpuDirty) {
+            if (texture->dirtyState == DirtyState::GpuDirty || (texture->dirtyState == DirtyState::CpuDirty && !texture->partiallyCpuDirty))
+                return PageWriteResult::Untrapped; // The write callback will handle any synchronization of the entire texture
+
+            if (texture->dirtyState == DirtyState::Clean) {
                 texture->dirtyState = DirtyState::CpuDirty;
-                return true; // If the texture is already CPU dirty or we can transition it to being CPU dirty then we don't need to do anything
+                texture->partiallyCpuDirty = true;
+                texture->cpuDirtySubresources.assign(static_cast<size_t>(texture->layerCount) * texture->levelCount, false);
             }
 
-            if (texture->accumulatedGuestWaitTime > SkipReadbackHackWaitTimeThreshold && *texture->gpu.state.settings->enableFastGpuReadbackHack) {
-                texture->dirtyState = DirtyState::Clean;
-                return true;
+            texture->MarkPageCpuDirty(page);
+            if (ranges::all_of(texture->cpuDirtySubresources, [](bool dirty) { return dirty; }))
+                return PageWriteResult::Untrapped; // There's no benefit to tracking individual pages once every subresource is dirty
+
+            return PageWriteResult::Trapped;
+        }} : nce::NCE::PageWriteCallback{});
+    }
+
+    /**
+     * @brief Splits the range [0, count) into `chunkCount` contiguous chunks, the first of which is run on the calling thread while all subsequent ones are run on the supplied pool
+     * @param function A function taking the start and the size of a chunk
+     * @note This only returns once all chunks have finished as they commonly write into shared buffers, the exception of any failed chunk is rethrown then
+     */
+    template<typename Function>
+    void RunChunksParallel(BS::thread_pool &pool, size_t count, size_t chunkCount, Function function) {
+        if (chunkCount <= 1) {
+            function(size_t{}, count);
+            return;
+        }
+
+        size_t chunkSize{util::DivideCeil(count, chunkCount)};
+        std::vector<std::future<void>> chunks;
+        for (size_t start{chunkSize}; start < count; start += chunkSize)
+            chunks.emplace_back(pool.submit(function, start, std::min(chunkSize, count - start)));
+
+        std::exception_ptr exception;
+        try {
+            function(size_t{}, chunkSize);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        for (auto &chunk : chunks) {
+            try {
+                chunk.get();
+            } catch (...) {
+                exception = std::current_exception();
             }
+        }
 
-            std::unique_lock lock{*texture, std::try_to_lock};
-            if (!lock)
-                return false;
+        if (exception)
+            std::rethrow_exception(exception);
+    }
 
-            if (texture->cycle)
-                return false;
+    /**
+     * @brief Decodes a BCn image by splitting it into chunks of block rows which are decoded in parallel on the supplied pool
+     * @param blockSize The size of a single encoded block in bytes
+     * @param dstBpp The size of a single decoded pixel in bytes
+     * @param decode A BCn decoding function from bc_decoder.h, any trailing arguments are supplied as `args`
+     */
+    template<typename DecodeFunction, typename... Args>
+    void DecodeBcnParallel(BS::thread_pool &pool, const u8 *src, u8 *dst, size_t width, size_t height, size_t blockSize, size_t dstBpp, DecodeFunction decode, Args... args) {
+        constexpr size_t BcnBlockDimensions{4}; //!< The width and height of a BCn block in pixels
+        constexpr size_t MinimumChunkSize{0x10000}; //!< The minimum amount of decoded bytes in a chunk, splitting up smaller images isn't worth the overhead
+
+        size_t blockRows{util::DivideCeil(height, BcnBlockDimensions)};
+        size_t blockRowSrcSize{util::DivideCeil(width, BcnBlockDimensions) * blockSize}, blockRowDstSize{BcnBlockDimensions * width * dstBpp};
+        size_t chunkCount{std::min<size_t>({pool.get_thread_count() + 1, blockRows, (blockRows * blockRowDstSize) / MinimumChunkSize})};
+        RunChunksParallel(pool, blockRows, chunkCount, [=](size_t blockRow, size_t chunkBlockRows) {
+            size_t chunkHeight{std::min((blockRow + chunkBlockRows) * BcnBlockDimensions, height) - (blockRow * BcnBlockDimensions)};
+            decode(src + (blockRow * blockRowSrcSize), dst + (blockRow * blockRowDstSize), width, chunkHeight, args...);
+        });
+    }
 
-            texture->SynchronizeGuest(true, true); // We need to assume the texture is dirty since we don't know what the guest is writing
-            return true;
+    /**
+     * @brief The layout of the separate depth and stencil planes that a texture emulating a packed 24-bit depth format is converted to and from in a staging buffer, the depth planes of all levels are followed by the stencil planes of all levels
+     */
+    struct DepthStencilSplitLayout {
+        boost::container::small_vector<vk::BufferImageCopy, 10> copies; //!< The copies of every aspect of every level between the planes and the image, these are relative to the start of the planes
+        boost::container::small_vector<DepthStencilConversionShader::Surface, 16> surfaces; //!< The surfaces to convert for every level, the packed offsets are relative to the start of the linear guest data
+        vk::DeviceSize size{}; //!< The total size of all planes in bytes
+    };
+
+    DepthStencilSplitLayout GetDepthStencilSplitLayout(const std::vector<texture::MipLevelLayout> &mipLayouts, u32 layerCount, bool hasStencil) {
+        DepthStencilSplitLayout layout;
+        vk::DeviceSize packedOffset{};
+        for (const auto &level : mipLayouts) {
+            // The depth plane of every level has the same size as the packed texels as both have 32-bit texels
+            auto texelCount{static_cast<u32>(level.dimensions.width * level.dimensions.height * level.dimensions.depth * layerCount)};
+            layout.surfaces.push_back(DepthStencilConversionShader::Surface{
+                .packedOffset = packedOffset,
+                .depthOffset = layout.size,
+                .texelCount = texelCount,
+            });
+
+            packedOffset += level.linearSize * layerCount;
+            layout.size += texelCount * sizeof(u32);
+        }
+
+        if (hasStencil) {
+            // Each stencil plane is padded to an entire word as the shader writes four texels at a time, this also satisfies the alignment requirement of copies of depth/stencil aspects
+            for (auto &surface : layout.surfaces) {
+                surface.stencilOffset = layout.size;
+                layout.size += util::AlignUp(surface.texelCount, sizeof(u32));
+            }
+        }
+
+        auto pushCopiesWithAspect{[&](vk::ImageAspectFlagBits aspect) {
+            u32 mipLevel{};
+            for (const auto &level : mipLayouts) {
+                auto &surface{layout.surfaces[mipLevel]};
+                layout.copies.emplace_back(vk::BufferImageCopy{
+                    .bufferOffset = aspect == vk::ImageAspectFlagBits::eDepth ? surface.depthOffset : surface.stencilOffset,
+                    .imageSubresource = {
+                        .aspectMask = aspect,
+                        .mipLevel = mipLevel++,
+                        .layerCount = layerCount,
+                    },
+                    .imageExtent = level.dimensions,
+                });
+            }
+        }};
+
+        pushCopiesWithAspect(vk::ImageAspectFlagBits::eDepth);
+        if (hasStencil)
+            pushCopiesWithAspect(vk::ImageAspectFlagBits::eStencil);
+
+        return layout;
+    }
+
+    bool Texture::RequiresDepthStencilConversion() {
+        return guest && guest->format != format && (guest->format->vkFormat == vk::Format::eD24UnormS8Uint || guest->format->vkFormat == vk::Format::eX8D24UnormPack32);
+    }
+
+    void Texture::AllocateDownloadStagingBuffer() {
+        if (downloadStagingBuffer)
+            return;
+
+        if (RequiresDepthStencilConversion()) {
+            // The packed guest texels are at the start of the buffer from where they're copied to the guest, the planes copied from the image follow them
+            auto splitLayout{GetDepthStencilSplitLayout(mipLayouts, layerCount, static_cast<bool>(format->vkAspect & vk::ImageAspectFlagBits::eStencil))};
+            downloadStagingBuffer = gpu.memory.AllocateStagingBuffer(util::AlignUp(static_cast<vk::DeviceSize>(deswizzledSurfaceSize), GpuDeswizzleOffsetAlignment) + splitLayout.size, vk::BufferUsageFlagBits::eStorageBuffer);
+        } else {
+            downloadStagingBuffer = gpu.memory.AllocateStagingBuffer(surfaceSize);
+        }
+    }
+
+    bool Texture::CanDeswizzleOnGpu() {
+        if (!*gpu.state.settings->useGpuTextureDeswizzle || guest->tileConfig.mode != texture::TileMode::Block || guest->format != format)
+            return false; // Only block-linear textures which don't require any format conversion can be deswizzled on the GPU
+
+        if (surfaceSize < gpu.calibration.gpuDeswizzleMinimumSize || surfaceSize > GpuDeswizzleMaximumSize || guest->GetSize() > GpuDeswizzleMaximumSize)
+            return false;
+
+        return ranges::all_of(mipLayouts, [&](const texture::MipLevelLayout &level) {
+            return BlockLinearDeswizzleShader::IsLineSizeSupported(guest->format->GetSize(level.dimensions.width, 1));
         });
     }
 
-    std::shared_ptr<memory::StagingBuffer> Texture::SynchronizeHostImpl() {
-        if (guest->dimensions != dimensions)
+    void Texture::DeswizzleGuest(u8 *guestInput, u8 *linearOutput) {
+        auto guestLayerStride{guest->GetLayerStride()};
+        if (levelCount > 1 && guest->tileConfig.mode != texture::TileMode::Block)
+            throw exception("Mipmapped textures with tiling mode '{}' aren't supported", static_cast<int>(tiling));
+        else if (levelCount == 0)
+            return;
+
+        // Every layer is deswizzled into a disjoint region of the output, so textures with many layers (such as cubemaps and array textures) have their layers split across the decode pool
+        constexpr size_t MinimumChunkSize{0x40000}; //!< The minimum amount of deswizzled bytes in a chunk, splitting up smaller textures isn't worth the overhead
+        auto &pool{gpu.texture.decodePool};
+        size_t chunkCount{std::min<size_t>({pool.get_thread_count() + 1, layerCount, deswizzledSurfaceSize / MinimumChunkSize})};
+
+        RunChunksParallel(pool, layerCount, chunkCount, [&](size_t firstLayer, size_t chunkLayerCount) {
+            if (levelCount == 1) {
+                auto inputLayer{guestInput + firstLayer * guestLayerStride};
+                auto outputLayer{linearOutput + firstLayer * deswizzledLayerStride};
+                for (size_t layer{firstLayer}; layer < firstLayer + chunkLayerCount; layer++) {
+                    if (guest->tileConfig.mode == texture::TileMode::Block)
+                        texture::CopyBlockLinearToLinear(*guest, inputLayer, outputLayer);
+                    else if (guest->tileConfig.mode == texture::TileMode::Pitch)
+                        texture::CopyPitchLinearToLinear(*guest, inputLayer, outputLayer);
+                    else if (guest->tileConfig.mode == texture::TileMode::Linear)
+                        std::memcpy(outputLayer, inputLayer, deswizzledLayerStride);
+                    inputLayer += guestLayerStride;
+                    outputLayer += deswizzledLayerStride;
+                }
+            } else {
+                // We need to generate a buffer that has all layers for a given mip level while Tegra X1 layout holds all mip levels for a given layer
+                for (size_t layer{firstLayer}; layer < firstLayer + chunkLayerCount; layer++) {
+                    auto inputLevel{guestInput + layer * guestLayerStride}; // The guest layer stride can differ from the sum of the level sizes due to layer end padding or guest RT layer stride
+                    auto outputLevel{linearOutput};
+                    for (const auto &level : mipLayouts) {
+                        texture::CopyBlockLinearToLinear(
+                            level.dimensions,
+                            guest->format->blockWidth, guest->format->blockHeight, guest->format->bpb,
+                            level.blockHeight, level.blockDepth,
+                            inputLevel, outputLevel + (layer * level.linearSize) // Offset into the current layer relative to the start of the current mip level
+                        );
+
+                        inputLevel += level.blockLinearSize; // Skip over the current mip level as we've deswizzled it
+                        outputLevel += layerCount * level.linearSize; // We need to offset the output buffer by the size of the previous mip level
+                    }
+                }
+            }
+        });
+    }
+
+    Texture::StagingUpload Texture::SynchronizeHostImpl() {
+        if (texture::ScaleDimensions(guest->dimensions, resolutionScale) != dimensions)
             throw exception("Guest and host dimensions being different is not supported currently");
 
         auto pointer{mirror.data()};
 
         WaitOnBacking();
 
+        auto guestLayerStride{guest->GetLayerStride()};
+        if ((tiling == vk::ImageTiling::eOptimal || !std::holds_alternative<memory::Image>(backing)) && CanDeswizzleOnGpu()) {
+            // The block-linear guest data is copied as-is into the staging buffer and deswizzled into the linear region following it on the GPU
+            vk::DeviceSize blockLinearSize{static_cast<vk::DeviceSize>(guestLayerStride) * layerCount};
+            vk::DeviceSize linearOffset{util::AlignUp(blockLinearSize, GpuDeswizzleOffsetAlignment)};
+
+            auto stagingBuffer{gpu.memory.AllocateStagingBuffer(linearOffset + surfaceSize, vk::BufferUsageFlagBits::eStorageBuffer)};
+            std::memcpy(stagingBuffer->data(), pointer, std::min<size_t>(blockLinearSize, mirror.size()));
+
+            return {std::move(stagingBuffer), linearOffset, true};
+        }
+
+        if (guest->format != format && guest->format->IsAstc()) {
+            // ASTC formats that the host doesn't support are deswizzled on the CPU into the compressed region at the start of the staging buffer and decoded into the RGBA region following it on the GPU
+            vk::DeviceSize decodedOffset{util::AlignUp(static_cast<vk::DeviceSize>(deswizzledSurfaceSize), GpuDeswizzleOffsetAlignment)};
+
+            auto stagingBuffer{gpu.memory.AllocateStagingBuffer(decodedOffset + surfaceSize, vk::BufferUsageFlagBits::eStorageBuffer)};
+            DeswizzleGuest(pointer, stagingBuffer->data());
+
+            return {std::move(stagingBuffer), decodedOffset, false, true};
+        }
+
+        if (RequiresDepthStencilConversion()) {
+            // Packed 24-bit depth formats that the host doesn't support are deswizzled on the CPU into the packed region at the start of the staging buffer and split into the depth and stencil planes of the host format following it on the GPU
+            vk::DeviceSize splitOffset{util::AlignUp(static_cast<vk::DeviceSize>(deswizzledSurfaceSize), GpuDeswizzleOffsetAlignment)};
+            auto splitLayout{GetDepthStencilSplitLayout(mipLayouts, layerCount, static_cast<bool>(format->vkAspect & vk::ImageAspectFlagBits::eStencil))};
+
+            auto stagingBuffer{gpu.memory.AllocateStagingBuffer(splitOffset + splitLayout.size, vk::BufferUsageFlagBits::eStorageBuffer)};
+            DeswizzleGuest(pointer, stagingBuffer->data());
+
+            return {std::move(stagingBuffer), splitOffset, false, false, true, std::move(splitLayout.copies)};
+        }
+
         u8 *bufferData;
         auto stagingBuffer{[&]() -> std::shared_ptr<memory::StagingBuffer> {
             if (tiling == vk::ImageTiling::eOptimal || !std::holds_alternative<memory::Image>(backing)) {
@@ -269,6 +537,14 @@ namespace skyline::gpu {
             }
         }()};
 
+        std::optional<TextureCacheManager::Key> cacheKey;
+        if (guest->format != format && gpu.textureCacheManager) {
+            // Decoding the texture on the CPU is expensive, so we first check if the decoded data is present in the texture cache
+            cacheKey = TextureCacheManager::GetKey(span<u8>{pointer, std::min<size_t>(static_cast<size_t>(guestLayerStride) * layerCount, mirror.size())}, guest->format->vkFormat, format->vkFormat, guest->tileConfig, dimensions, levelCount, layerCount, surfaceSize);
+            if (gpu.textureCacheManager->Read(*cacheKey, span<u8>{bufferData, surfaceSize}))
+                return {std::move(stagingBuffer)};
+        }
+
         std::vector<u8> deswizzleBuffer;
         u8 *deswizzleOutput;
         if (guest->format != format) {
@@ -278,84 +554,55 @@ namespace skyline::gpu {
             deswizzleOutput = bufferData;
         }
 
-        auto guestLayerStride{guest->GetLayerStride()};
-        if (levelCount == 1) {
-            auto outputLayer{deswizzleOutput};
-            for (size_t layer{}; layer < layerCount; layer++) {
-                if (guest->tileConfig.mode == texture::TileMode::Block)
-                    texture::CopyBlockLinearToLinear(*guest, pointer, outputLayer);
-                else if (guest->tileConfig.mode == texture::TileMode::Pitch)
-                    texture::CopyPitchLinearToLinear(*guest, pointer, outputLayer);
-                else if (guest->tileConfig.mode == texture::TileMode::Linear)
-                    std::memcpy(outputLayer, pointer, surfaceSize);
-                pointer += guestLayerStride;
-                outputLayer += deswizzledLayerStride;
-            }
-        } else if (levelCount > 1 && guest->tileConfig.mode == texture::TileMode::Block) {
-            // We need to generate a buffer that has all layers for a given mip level while Tegra X1 layout holds all mip levels for a given layer
-            for (size_t layer{}; layer < layerCount; layer++) {
-                auto inputLevel{pointer}, outputLevel{deswizzleOutput};
-                for (const auto &level : mipLayouts) {
-                    texture::CopyBlockLinearToLinear(
-                        level.dimensions,
-                        guest->format->blockWidth, guest->format->blockHeight, guest->format->bpb,
-                        level.blockHeight, level.blockDepth,
-                        inputLevel, outputLevel + (layer * level.linearSize) // Offset into the current layer relative to the start of the current mip level
-                    );
-
-                    inputLevel += level.blockLinearSize; // Skip over the current mip level as we've deswizzled it
-                    outputLevel += layerCount * level.linearSize; // We need to offset the output buffer by the size of the previous mip level
-                }
-
-                pointer += guestLayerStride; // We need to offset the input buffer by the size of the previous guest layer, this can differ from inputLevel's value due to layer end padding or guest RT layer stride
-            }
-        } else if (levelCount != 0) {
-            throw exception("Mipmapped textures with tiling mode '{}' aren't supported", static_cast<int>(tiling));
-        }
+        DeswizzleGuest(pointer, deswizzleOutput);
 
         if (!deswizzleBuffer.empty()) {
             for (const auto &level : mipLayouts) {
                 size_t levelHeight{level.dimensions.height * layerCount}; //!< The height of an image representing all layers in the entire level
+                auto decodeLevel{[&](auto decode, auto... args) {
+                    DecodeBcnParallel(gpu.texture.decodePool, deswizzleOutput, bufferData, level.dimensions.width, levelHeight, guest->format->bpb, format->bpb, decode, args...);
+                }};
+
                 switch (guest->format->vkFormat) {
                     case vk::Format::eBc1RgbaUnormBlock:
                     case vk::Format::eBc1RgbaSrgbBlock:
-                        bcn::DecodeBc1(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, true);
+                        decodeLevel(bcn::DecodeBc1, true);
                         break;
 
                     case vk::Format::eBc2UnormBlock:
                     case vk::Format::eBc2SrgbBlock:
-                        bcn::DecodeBc2(deswizzleOutput, bufferData, level.dimensions.width, levelHeight);
+                        decodeLevel(bcn::DecodeBc2);
                         break;
 
                     case vk::Format::eBc3UnormBlock:
                     case vk::Format::eBc3SrgbBlock:
-                        bcn::DecodeBc3(deswizzleOutput, bufferData, level.dimensions.width, levelHeight);
+                        decodeLevel(bcn::DecodeBc3);
                         break;
 
                     case vk::Format::eBc4UnormBlock:
-                        bcn::DecodeBc4(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, false);
+                        decodeLevel(bcn::DecodeBc4, false);
                         break;
                     case vk::Format::eBc4SnormBlock:
-                        bcn::DecodeBc4(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, true);
+                        decodeLevel(bcn::DecodeBc4, true);
                         break;
 
                     case vk::Format::eBc5UnormBlock:
-                        bcn::DecodeBc5(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, false);
+                        decodeLevel(bcn::DecodeBc5, false);
                         break;
                     case vk::Format::eBc5SnormBlock:
-                        bcn::DecodeBc5(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, true);
+                        decodeLevel(bcn::DecodeBc5, true);
                         break;
 
                     case vk::Format::eBc6HUfloatBlock:
-                        bcn::DecodeBc6(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, false);
+                        decodeLevel(bcn::DecodeBc6, false);
                         break;
                     case vk::Format::eBc6HSfloatBlock:
-                        bcn::DecodeBc6(deswizzleOutput, bufferData, level.dimensions.width, levelHeight, true);
+                        decodeLevel(bcn::DecodeBc6, true);
                         break;
 
                     case vk::Format::eBc7UnormBlock:
                     case vk::Format::eBc7SrgbBlock:
-                        bcn::DecodeBc7(deswizzleOutput, bufferData, level.dimensions.width, levelHeight);
+                        decodeLevel(bcn::DecodeBc7);
                         break;
 
                     default:
@@ -365,9 +612,108 @@ namespace skyline::gpu {
                 deswizzleOutput += level.linearSize * layerCount;
                 bufferData += level.targetLinearSize * layerCount;
             }
+
+            if (cacheKey)
+                gpu.textureCacheManager->QueueWrite(*cacheKey, span<u8>{bufferData - surfaceSize, surfaceSize});
         }
 
-        return stagingBuffer;
+        return {std::move(stagingBuffer)};
+    }
+
+    void Texture::MarkPageCpuDirty(u8 *page) {
+        u8 *pageEnd{page + constant::PageSize};
+        size_t guestLayerStride{guest->GetLayerStride()};
+        size_t mappingOffset{}; //!< The offset of the current mapping in the guest texture
+        for (const auto &mapping : guest->mappings) {
+            u8 *start{std::max(mapping.data(), page)}, *end{std::min(mapping.data() + mapping.size(), pageEnd)};
+            if (start < end) {
+                // Mark all subresources overlapping with the written range of the texture, the Tegra X1 layout holds all mip levels of a layer contiguously
+                size_t startOffset{mappingOffset + static_cast<size_t>(start - mapping.data())}, endOffset{mappingOffset + static_cast<size_t>(end - mapping.data())};
+                for (size_t layer{startOffset / guestLayerStride}; layer < layerCount && layer * guestLayerStride < endOffset; layer++) {
+                    size_t levelOffset{layer * guestLayerStride};
+                    for (size_t level{}; level < levelCount; level++) {
+                        size_t levelEnd{levelOffset + (guest->tileConfig.mode == texture::TileMode::Block ? mipLayouts[level].blockLinearSize : guestLayerStride)};
+                        if (levelOffset < endOffset && levelEnd > startOffset)
+                            cpuDirtySubresources[layer * levelCount + level] = true;
+                        levelOffset = levelEnd;
+                    }
+                }
+            }
+
+            mappingOffset += mapping.size();
+        }
+    }
+
+    bool Texture::CanSynchronizeHostPartially() {
+        if (guest->format != format || layout == vk::ImageLayout::eUndefined || (tiling != vk::ImageTiling::eOptimal && std::holds_alternative<memory::Image>(backing)) || resolutionScale != 100)
+            return false; // Only unscaled textures which don't require any format conversion and already have defined contents can be partially synchronized through a staging buffer
+
+        // If all subresources are dirty then a regular synchronization is cheaper as it can be done in bulk or on the GPU
+        return !ranges::all_of(cpuDirtySubresources, [](bool dirty) { return dirty; });
+    }
+
+    Texture::StagingUpload Texture::SynchronizeHostPartialImpl(const std::vector<bool> &dirtySubresources) {
+        if (guest->dimensions != dimensions)
+            throw exception("Guest and host dimensions being different is not supported currently");
+
+        WaitOnBacking();
+
+        vk::DeviceSize stagingSize{};
+        for (size_t layer{}; layer < layerCount; layer++)
+            for (size_t level{}; level < levelCount; level++)
+                if (dirtySubresources[layer * levelCount + level])
+                    stagingSize += mipLayouts[level].linearSize;
+
+        auto stagingBuffer{gpu.memory.AllocateStagingBuffer(stagingSize)};
+        StagingUpload upload{stagingBuffer};
+
+        u8 *output{stagingBuffer->data()};
+        auto guestLayerStride{guest->GetLayerStride()};
+        for (u32 layer{}; layer < layerCount; layer++) {
+            u8 *inputLevel{mirror.data() + static_cast<size_t>(layer) * guestLayerStride};
+            for (u32 level{}; level < levelCount; level++) {
+                const auto &mipLayout{mipLayouts[level]};
+                if (dirtySubresources[static_cast<size_t>(layer) * levelCount + level]) {
+                    if (guest->tileConfig.mode == texture::TileMode::Block)
+                        texture::CopyBlockLinearToLinear(
+                            mipLayout.dimensions,
+                            guest->format->blockWidth, guest->format->blockHeight, guest->format->bpb,
+                            mipLayout.blockHeight, mipLayout.blockDepth,
+                            inputLevel, output
+                        );
+                    else if (guest->tileConfig.mode == texture::TileMode::Pitch)
+                        texture::CopyPitchLinearToLinear(*guest, inputLevel, output);
+                    else if (guest->tileConfig.mode == texture::TileMode::Linear)
+                        std::memcpy(output, inputLevel, mipLayout.linearSize);
+
+                    auto pushCopyWithAspect{[&](vk::ImageAspectFlagBits aspect) {
+                        upload.subresourceCopies.emplace_back(vk::BufferImageCopy{
+                            .bufferOffset = static_cast<vk::DeviceSize>(output - stagingBuffer->data()),
+                            .imageSubresource = {
+                                .aspectMask = aspect,
+                                .mipLevel = level,
+                                .baseArrayLayer = layer,
+                                .layerCount = 1,
+                            },
+                            .imageExtent = mipLayout.dimensions,
+                        });
+                    }};
+
+                    if (format->vkAspect & vk::ImageAspectFlagBits::eColor)
+                        pushCopyWithAspect(vk::ImageAspectFlagBits::eColor);
+                    if (format->vkAspect & vk::ImageAspectFlagBits::eDepth)
+                        pushCopyWithAspect(vk::ImageAspectFlagBits::eDepth);
+                    if (format->vkAspect & vk::ImageAspectFlagBits::eStencil)
+                        pushCopyWithAspect(vk::ImageAspectFlagBits::eStencil);
+
+                    output += mipLayout.linearSize;
+                }
+
+                inputLevel += mipLayout.blockLinearSize;
+            }
+        }
+
+        return upload;
     }
 
     boost::container::small_vector<vk::BufferImageCopy, 10> Texture::GetBufferImageCopies() {
@@ -402,7 +748,201 @@ namespace skyline::gpu {
         return bufferImageCopies;
     }
 
-    void Texture::CopyFromStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer) {
+    bool Texture::CanScaleResolution(vk::ImageType imageType) {
+        // Only the simplest render targets are scaled as every other texture attribute would require more complex synchronization with the guest
+        if (imageType != vk::ImageType::e2D || levelCount != 1 || layerCount != 1 || format != guest->format || format->IsCompressed() || guest->tileConfig.mode != texture::TileMode::Block)
+            return false;
+
+        if (dimensions.width < ResolutionScaleMinimumDimension || dimensions.height < ResolutionScaleMinimumDimension)
+            return false;
+
+        constexpr vk::FormatFeatureFlags BlitFeatures{vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst};
+        return (gpu.vkPhysicalDevice.getFormatProperties(*format).optimalTilingFeatures & BlitFeatures) == BlitFeatures;
+    }
+
+    vk::Image Texture::AcquireNativeImage(const vk::raii::CommandBuffer &commandBuffer) {
+        if (!nativeImage)
+            nativeImage.emplace(gpu.memory.AllocateImage(vk::ImageCreateInfo{
+                .imageType = vk::ImageType::e2D,
+                .format = *format,
+                .extent = guest->dimensions,
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = vk::SampleCountFlagBits::e1,
+                .tiling = vk::ImageTiling::eOptimal,
+                .usage = vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst,
+                .sharingMode = vk::SharingMode::eExclusive,
+                .queueFamilyIndexCount = 1,
+                .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
+                .initialLayout = vk::ImageLayout::eUndefined,
+            }));
+
+        // The intermediate image is always entirely overwritten, so any prior contents can be discarded with a transition from the undefined layout
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
+            .image = nativeImage->vkImage,
+            .srcAccessMask = vk::AccessFlagBits::eTransferRead,
+            .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .oldLayout = vk::ImageLayout::eUndefined,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .subresourceRange = {
+                .aspectMask = format->vkAspect,
+                .levelCount = 1,
+                .layerCount = 1,
+            },
+        });
+
+        return nativeImage->vkImage;
+    }
+
+    void Texture::BlitNativeImage(const vk::raii::CommandBuffer &commandBuffer, bool toNative) {
+        auto image{GetBacking()};
+        vk::ImageSubresourceRange subresourceRange{
+            .aspectMask = format->vkAspect,
+            .levelCount = 1,
+            .layerCount = 1,
+        };
+
+        if (!toNative)
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, {
+                vk::ImageMemoryBarrier{
+                    .image = nativeImage->vkImage,
+                    .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                    .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+                    .oldLayout = vk::ImageLayout::eGeneral,
+                    .newLayout = vk::ImageLayout::eGeneral,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .subresourceRange = subresourceRange,
+                }, vk::ImageMemoryBarrier{
+                    .image = image,
+                    .srcAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+                    .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+                    .oldLayout = layout,
+                    .newLayout = layout,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .subresourceRange = subresourceRange,
+                }
+            });
+
+        vk::ImageSubresourceLayers subresourceLayers{
+            .aspectMask = format->vkAspect,
+            .layerCount = 1,
+        };
+        std::array<vk::Offset3D, 2> nativeOffsets{vk::Offset3D{0, 0, 0}, vk::Offset3D{static_cast<i32>(guest->dimensions.width), static_cast<i32>(guest->dimensions.height), 1}};
+        std::array<vk::Offset3D, 2> scaledOffsets{vk::Offset3D{0, 0, 0}, vk::Offset3D{static_cast<i32>(dimensions.width), static_cast<i32>(dimensions.height), 1}};
+
+        // Depth, stencil and integer formats can't be filtered, they're resampled with the nearest texel instead
+        bool linearFilter{format->vkAspect == vk::ImageAspectFlagBits::eColor && (gpu.vkPhysicalDevice.getFormatProperties(*format).optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)};
+        if (toNative)
+            commandBuffer.blitImage(image, layout, nativeImage->vkImage, vk::ImageLayout::eGeneral, vk::ImageBlit{
+                .srcSubresource = subresourceLayers,
+                .srcOffsets = scaledOffsets,
+                .dstSubresource = subresourceLayers,
+                .dstOffsets = nativeOffsets,
+            }, linearFilter ? vk::Filter::eLinear : vk::Filter::eNearest);
+        else
+            commandBuffer.blitImage(nativeImage->vkImage, vk::ImageLayout::eGeneral, image, layout, vk::ImageBlit{
+                .srcSubresource = subresourceLayers,
+                .srcOffsets = nativeOffsets,
+                .dstSubresource = subresourceLayers,
+                .dstOffsets = scaledOffsets,
+            }, linearFilter ? vk::Filter::eLinear : vk::Filter::eNearest);
+
+        if (toNative)
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
+                .image = nativeImage->vkImage,
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+                .oldLayout = vk::ImageLayout::eGeneral,
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .subresourceRange = subresourceRange,
+            });
+    }
+
+    std::shared_ptr<void> Texture::CopyFromStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const StagingUpload &upload) {
+        std::shared_ptr<void> deswizzleDescriptorSet;
+        if (upload.deswizzleOnGpu) {
+            // We need to deswizzle every mip level of every layer from the Tegra X1 layout into a buffer that has all layers for a given mip level
+            // Note: See SynchronizeHostImpl for the CPU equivalent of this
+            boost::container::small_vector<BlockLinearDeswizzleShader::Surface, 16> surfaces;
+            auto guestLayerStride{guest->GetLayerStride()};
+            for (u32 layer{}; layer < layerCount; layer++) {
+                vk::DeviceSize inputLevel{layer * static_cast<vk::DeviceSize>(guestLayerStride)}, outputLevel{};
+                for (const auto &level : mipLayouts) {
+                    surfaces.push_back(BlockLinearDeswizzleShader::Surface{
+                        .blockLinearOffset = inputLevel,
+                        .linearOffset = outputLevel + (layer * level.linearSize),
+                        .width = level.dimensions.width,
+                        .height = level.dimensions.height,
+                        .depth = level.dimensions.depth,
+                        .formatBlockWidth = guest->format->blockWidth,
+                        .formatBlockHeight = guest->format->blockHeight,
+                        .formatBpb = guest->format->bpb,
+                        .gobBlockHeight = static_cast<u32>(level.blockHeight),
+                        .gobBlockDepth = static_cast<u32>(level.blockDepth),
+                    });
+
+                    inputLevel += level.blockLinearSize;
+                    outputLevel += layerCount * level.linearSize;
+                }
+            }
+
+            deswizzleDescriptorSet = gpu.helperShaders.blockLinearDeswizzleShader.Deswizzle(gpu, commandBuffer, vk::DescriptorBufferInfo{
+                .buffer = upload.buffer->vkBuffer,
+                .offset = 0,
+                .range = upload.linearOffset,
+            }, vk::DescriptorBufferInfo{
+                .buffer = upload.buffer->vkBuffer,
+                .offset = upload.linearOffset,
+                .range = surfaceSize,
+            }, surfaces);
+        } else if (upload.decodeAstcOnGpu) {
+            // Every mip level has all of its layers laid out contiguously in both regions, so a level can be decoded as a single surface
+            boost::container::small_vector<AstcDecoderShader::Surface, 16> surfaces;
+            vk::DeviceSize astcOffset{}, rgbaOffset{};
+            for (const auto &level : mipLayouts) {
+                surfaces.push_back(AstcDecoderShader::Surface{
+                    .astcOffset = astcOffset,
+                    .rgbaOffset = rgbaOffset,
+                    .width = level.dimensions.width,
+                    .height = level.dimensions.height,
+                    .depth = level.dimensions.depth * layerCount,
+                    .formatBlockWidth = guest->format->blockWidth,
+                    .formatBlockHeight = guest->format->blockHeight,
+                });
+
+                astcOffset += level.linearSize * layerCount;
+                rgbaOffset += level.targetLinearSize * layerCount;
+            }
+
+            deswizzleDescriptorSet = gpu.helperShaders.astcDecoderShader.Decode(gpu, commandBuffer, vk::DescriptorBufferInfo{
+                .buffer = upload.buffer->vkBuffer,
+                .offset = 0,
+                .range = upload.linearOffset,
+            }, vk::DescriptorBufferInfo{
+                .buffer = upload.buffer->vkBuffer,
+                .offset = upload.linearOffset,
+                .range = surfaceSize,
+            }, surfaces, format->vkFormat == vk::Format::eR8G8B8A8Srgb);
+        } else if (upload.convertDepthStencilOnGpu) {
+            auto hasStencil{static_cast<bool>(format->vkAspect & vk::ImageAspectFlagBits::eStencil)};
+            auto splitLayout{GetDepthStencilSplitLayout(mipLayouts, layerCount, hasStencil)};
+            deswizzleDescriptorSet = gpu.helperShaders.depthStencilConversionShader.Unpack(gpu, commandBuffer, vk::DescriptorBufferInfo{
+                .buffer = upload.buffer->vkBuffer,
+                .offset = 0,
+                .range = upload.linearOffset,
+            }, vk::DescriptorBufferInfo{
+                .buffer = upload.buffer->vkBuffer,
+                .offset = upload.linearOffset,
+                .range = splitLayout.size,
+            }, splitLayout.surfaces, guest->format == format::D24UnormS8Uint, hasStencil);
+        }
+
         auto image{GetBacking()};
         if (layout == vk::ImageLayout::eUndefined)
             commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eHost, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
@@ -420,11 +960,82 @@ namespace skyline::gpu {
                 },
             });
 
+        auto bufferImageCopies{upload.subresourceCopies.empty() ? GetBufferImageCopies() : upload.subresourceCopies};
+        for (auto &bufferImageCopy : bufferImageCopies)
+            bufferImageCopy.bufferOffset += upload.linearOffset;
+
+        if (resolutionScale != 100) {
+            // The guest data is at the guest resolution, so it's copied into an intermediate image which is then blitted into the scaled backing
+            commandBuffer.copyBufferToImage(upload.buffer->vkBuffer, AcquireNativeImage(commandBuffer), vk::ImageLayout::eGeneral, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+            BlitNativeImage(commandBuffer, false);
+        } else {
+            commandBuffer.copyBufferToImage(upload.buffer->vkBuffer, image, layout, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+        }
+
+        return deswizzleDescriptorSet;
+    }
+
+    bool Texture::CanCopyFromStagingBufferAsync(const StagingUpload &upload) {
+        return gpu.transferQueue && !upload.deswizzleOnGpu && !upload.decodeAstcOnGpu && !upload.convertDepthStencilOnGpu && layout == vk::ImageLayout::eUndefined && resolutionScale == 100;
+    }
+
+    void Texture::CopyFromStagingBufferAsync(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const StagingUpload &upload) {
+        auto image{GetBacking()};
+        vk::ImageSubresourceRange subresourceRange{
+            .aspectMask = format->vkAspect,
+            .levelCount = levelCount,
+            .layerCount = layerCount,
+        };
+
         auto bufferImageCopies{GetBufferImageCopies()};
-        commandBuffer.copyBufferToImage(stagingBuffer->vkBuffer, image, layout, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+        for (auto &bufferImageCopy : bufferImageCopies)
+            bufferImageCopy.bufferOffset += upload.linearOffset;
+
+        auto &transferQueue{*gpu.transferQueue};
+        u64 transferValue{transferQueue.Submit([&](vk::raii::CommandBuffer &transferCommandBuffer) {
+            transferCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
+                .image = image,
+                .srcAccessMask = {},
+                .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .oldLayout = vk::ImageLayout::eUndefined,
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .subresourceRange = subresourceRange,
+            });
+
+            transferCommandBuffer.copyBufferToImage(upload.buffer->vkBuffer, image, vk::ImageLayout::eGeneral, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+
+            // Release ownership of the image to the graphics queue family, this must be matched by an acquire on the graphics queue
+            transferCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, {}, vk::ImageMemoryBarrier{
+                .image = image,
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = {},
+                .oldLayout = vk::ImageLayout::eGeneral,
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = transferQueue.familyIndex,
+                .dstQueueFamilyIndex = gpu.vkQueueFamilyIndex,
+                .subresourceRange = subresourceRange,
+            });
+        })};
+
+        layout = vk::ImageLayout::eGeneral;
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eAllCommands, {}, {}, {}, vk::ImageMemoryBarrier{
+            .image = image,
+            .srcAccessMask = {},
+            .dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite,
+            .oldLayout = vk::ImageLayout::eGeneral,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .srcQueueFamilyIndex = transferQueue.familyIndex,
+            .dstQueueFamilyIndex = gpu.vkQueueFamilyIndex,
+            .subresourceRange = subresourceRange,
+        });
+
+        // The command buffer must only begin executing once the copy and the ownership release have completed on the transfer queue
+        cycle->AddTransferWait(transferValue);
     }
 
-    void Texture::CopyIntoStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer) {
+    std::shared_ptr<void> Texture::CopyIntoStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer) {
         auto image{GetBacking()};
         commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eBottomOfPipe, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, vk::ImageMemoryBarrier{
             .image = image,
@@ -441,8 +1052,37 @@ namespace skyline::gpu {
             },
         });
 
+        if (RequiresDepthStencilConversion()) {
+            // The depth and stencil planes of the host format are copied after the packed region and packed into the guest format on the GPU
+            // Note: See AllocateDownloadStagingBuffer for the layout of the staging buffer
+            auto hasStencil{static_cast<bool>(format->vkAspect & vk::ImageAspectFlagBits::eStencil)};
+            auto splitLayout{GetDepthStencilSplitLayout(mipLayouts, layerCount, hasStencil)};
+            vk::DeviceSize splitOffset{util::AlignUp(static_cast<vk::DeviceSize>(deswizzledSurfaceSize), GpuDeswizzleOffsetAlignment)};
+            for (auto &bufferImageCopy : splitLayout.copies)
+                bufferImageCopy.bufferOffset += splitOffset;
+
+            commandBuffer.copyImageToBuffer(image, layout, stagingBuffer->vkBuffer, vk::ArrayProxy(static_cast<u32>(splitLayout.copies.size()), splitLayout.copies.data()));
+
+            return gpu.helperShaders.depthStencilConversionShader.Pack(gpu, commandBuffer, vk::DescriptorBufferInfo{
+                .buffer = stagingBuffer->vkBuffer,
+                .offset = 0,
+                .range = splitOffset,
+            }, vk::DescriptorBufferInfo{
+                .buffer = stagingBuffer->vkBuffer,
+                .offset = splitOffset,
+                .range = splitLayout.size,
+            }, splitLayout.surfaces, guest->format == format::D24UnormS8Uint, hasStencil);
+        }
+
         auto bufferImageCopies{GetBufferImageCopies()};
-        commandBuffer.copyImageToBuffer(image, layout, stagingBuffer->vkBuffer, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+        if (resolutionScale != 100) {
+            // The guest expects data at the guest resolution, so the scaled backing is blitted into an intermediate image which is then copied from
+            auto nativeImage{AcquireNativeImage(commandBuffer)};
+            BlitNativeImage(commandBuffer, true);
+            commandBuffer.copyImageToBuffer(nativeImage, vk::ImageLayout::eGeneral, stagingBuffer->vkBuffer, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+        } else {
+            commandBuffer.copyImageToBuffer(image, layout, stagingBuffer->vkBuffer, vk::ArrayProxy(static_cast<u32>(bufferImageCopies.size()), bufferImageCopies.data()));
+        }
 
         commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, {}, vk::BufferMemoryBarrier{
             .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
@@ -453,6 +1093,16 @@ namespace skyline::gpu {
             .offset = 0,
             .size = stagingBuffer->size(),
         }, {});
+
+        return nullptr;
+    }
+
+    void Texture::InvalidateReadbackPrefetch() {
+        if (readbackPrefetchCycle) {
+            readbackPrefetchCycle = nullptr;
+            if (readbackScore)
+                readbackScore--;
+        }
     }
 
     void Texture::CopyToGuest(u8 *hostBuffer) {
@@ -494,6 +1144,44 @@ namespace skyline::gpu {
         }
     }
 
+    bool Texture::TryImportGuestMappings(const vk::ImageCreateInfo &createInfo) {
+        auto importCreateInfo{createInfo};
+        importCreateInfo.tiling = vk::ImageTiling::eLinear;
+        importCreateInfo.initialLayout = vk::ImageLayout::ePreinitialized; // The guest mappings already contain the texture data, it must be preserved by the initial layout transition
+
+        vk::DeviceSize rowPitch{guest->tileConfig.mode == texture::TileMode::Pitch ? guest->tileConfig.pitch : guest->format->GetSize(dimensions.width, 1)};
+        auto image{gpu.memory.ImportImage(alignedMirror, static_cast<vk::DeviceSize>(mirror.data() - alignedMirror.data()), importCreateInfo, rowPitch)};
+        if (!image)
+            return false;
+
+        backing = std::move(*image);
+        tiling = vk::ImageTiling::eLinear;
+        layout = vk::ImageLayout::ePreinitialized;
+        dirtyState = DirtyState::Clean;
+        isDirect = true;
+        return true;
+    }
+
+    /**
+     * @return All uncompressed color formats which share the component layout of the supplied format, these are the formats that a view of a texture with it may be created with
+     */
+    static std::vector<vk::Format> GetViewFormatList(vk::Format format) {
+        std::vector<vk::Format> formats;
+        auto componentCount{vk::componentCount(format)};
+        for (auto candidate{static_cast<u32>(vk::Format::eR4G4UnormPack8)}; candidate <= static_cast<u32>(vk::Format::eE5B9G9R9UfloatPack32); candidate++) {
+            auto candidateFormat{static_cast<vk::Format>(candidate)};
+            if (vk::componentCount(candidateFormat) != componentCount || vk::blockSize(candidateFormat) != vk::blockSize(format))
+                continue;
+
+            bool matches{true};
+            for (u8 component{}; component < componentCount; component++)
+                matches &= vk::componentBits(candidateFormat, component) == vk::componentBits(format, component);
+            if (matches)
+                formats.push_back(candidateFormat);
+        }
+        return formats;
+    }
+
     Texture::Texture(GPU &gpu, BackingType &&backing, texture::Dimensions dimensions, texture::Format format, vk::ImageLayout layout, vk::ImageTiling tiling, vk::ImageCreateFlags flags, vk::ImageUsageFlags usage, u32 levelCount, u32 layerCount, vk::SampleCountFlagBits sampleCount)
         : gpu(gpu),
           backing(std::move(backing)),
@@ -509,10 +1197,17 @@ namespace skyline::gpu {
 
     texture::Format ConvertHostCompatibleFormat(texture::Format format, const TraitManager &traits) {
         auto bcnSupport{traits.bcnSupport};
-        if (bcnSupport.all())
+        auto astcSupport{traits.astcSupport};
+        if (bcnSupport.all() && astcSupport.all() && traits.supportsD24UnormS8Uint && traits.supportsX8D24UnormPack32)
             return format;
 
         switch (format->vkFormat) {
+            // Both Z24S8 and S8Z24 guest formats map to the same host format, their component order is handled during conversion
+            case vk::Format::eD24UnormS8Uint:
+                return traits.supportsD24UnormS8Uint ? format : format::D32FloatS8Uint;
+            case vk::Format::eX8D24UnormPack32:
+                return traits.supportsX8D24UnormPack32 ? format : format::D32Float;
+
             case vk::Format::eBc1RgbaUnormBlock:
                 return bcnSupport[0] ? format : format::R8G8B8A8Unorm;
             case vk::Format::eBc1RgbaSrgbBlock:
@@ -547,6 +1242,46 @@ namespace skyline::gpu {
             case vk::Format::eBc7SrgbBlock:
                 return bcnSupport[6] ? format : format::R8G8B8A8Srgb;
 
+            case vk::Format::eAstc4x4UnormBlock:
+                return astcSupport[0] ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eAstc4x4SrgbBlock:
+                return astcSupport[0] ? format : format::R8G8B8A8Srgb;
+
+            case vk::Format::eAstc5x5UnormBlock:
+                return astcSupport[1] ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eAstc5x5SrgbBlock:
+                return astcSupport[1] ? format : format::R8G8B8A8Srgb;
+
+            case vk::Format::eAstc6x6UnormBlock:
+                return astcSupport[2] ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eAstc6x6SrgbBlock:
+                return astcSupport[2] ? format : format::R8G8B8A8Srgb;
+
+            case vk::Format::eAstc8x6UnormBlock:
+                return astcSupport[3] ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eAstc8x6SrgbBlock:
+                return astcSupport[3] ? format : format::R8G8B8A8Srgb;
+
+            case vk::Format::eAstc8x8UnormBlock:
+                return astcSupport[4] ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eAstc8x8SrgbBlock:
+                return astcSupport[4] ? format : format::R8G8B8A8Srgb;
+
+            case vk::Format::eAstc10x8UnormBlock:
+                return astcSupport[5] ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eAstc10x8SrgbBlock:
+                return astcSupport[5] ? format : format::R8G8B8A8Srgb;
+
+            case vk::Format::eAstc10x10UnormBlock:
+                return astcSupport[6] ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eAstc10x10SrgbBlock:
+                return astcSupport[6] ? format : format::R8G8B8A8Srgb;
+
+            case vk::Format::eAstc12x12UnormBlock:
+                return astcSupport[7] ? format : format::R8G8B8A8Unorm;
+            case vk::Format::eAstc12x12SrgbBlock:
+                return astcSupport[7] ? format : format::R8G8B8A8Srgb;
+
             default:
                 return format;
         }
@@ -566,7 +1301,7 @@ namespace skyline::gpu {
         return surfaceSize;
     }
 
-    Texture::Texture(GPU &pGpu, GuestTexture pGuest)
+    Texture::Texture(GPU &pGpu, GuestTexture pGuest, u32 pResolutionScale)
         : gpu(pGpu),
           guest(std::move(pGuest)),
           dimensions(guest->dimensions),
@@ -597,12 +1332,33 @@ namespace skyline::gpu {
             usage |= vk::ImageUsageFlagBits::eDepthStencilAttachment;
 
         auto imageType{guest->GetImageType()};
+        if (pResolutionScale != 100 && CanScaleResolution(imageType)) {
+            resolutionScale = pResolutionScale;
+            dimensions = texture::ScaleDimensions(dimensions, resolutionScale);
+        }
+
         if (imageType == vk::ImageType::e2D && dimensions.width == dimensions.height && layerCount >= 6)
             flags |= vk::ImageCreateFlagBits::eCubeCompatible;
         else if (imageType == vk::ImageType::e3D)
             flags |= vk::ImageCreateFlagBits::e2DArrayCompatible;
 
+        // Supplying the exact set of formats that views of a color texture can have allows drivers to retain framebuffer compression for mutable images, so aliased render targets can be viewed in-place rather than copied
+        // On drivers where mutable images are costly, we only opt into it when a format in the list can't already be aliased through relaxed aliasing
+        std::vector<vk::Format> viewFormats;
+        vk::ImageFormatListCreateInfo formatListCreateInfo{};
+        if (gpu.traits.supportsImageFormatList && format->vkAspect == vk::ImageAspectFlagBits::eColor && !format->IsCompressed()) {
+            viewFormats = GetViewFormatList(*format);
+            bool needsMutable{!gpu.traits.quirks.vkImageMutableFormatCostly || !gpu.traits.quirks.adrenoRelaxedFormatAliasing ||
+                ranges::any_of(viewFormats, [&](vk::Format viewFormat) { return viewFormat != format->vkFormat && !texture::IsAdrenoAliasCompatible(viewFormat, format->vkFormat); })};
+            if (viewFormats.size() > 1 && needsMutable) {
+                flags |= vk::ImageCreateFlagBits::eMutableFormat;
+                formatListCreateInfo.viewFormatCount = static_cast<u32>(viewFormats.size());
+                formatListCreateInfo.pViewFormats = viewFormats.data();
+            }
+        }
+
         vk::ImageCreateInfo imageCreateInfo{
+            .pNext = formatListCreateInfo.viewFormatCount ? &formatListCreateInfo : nullptr,
             .flags = flags,
             .imageType = imageType,
             .format = *format,
@@ -617,7 +1373,17 @@ namespace skyline::gpu {
             .pQueueFamilyIndices = &gpu.vkQueueFamilyIndex,
             .initialLayout = layout,
         };
-        backing = tiling != vk::ImageTiling::eLinear ? gpu.memory.AllocateImage(imageCreateInfo) : gpu.memory.AllocateMappedImage(imageCreateInfo);
+
+        // Pitch and linear textures that don't require any conversion can alias the guest mappings directly, avoiding all copies for textures that are frequently written by the CPU
+        if (*gpu.state.settings->useDirectMemoryImport && gpu.traits.supportsAdrenoDirectMemoryImport &&
+            guest->tileConfig.mode != texture::TileMode::Block && format == guest->format && format->vkAspect == vk::ImageAspectFlagBits::eColor && !format->IsCompressed() &&
+            imageType == vk::ImageType::e2D && levelCount == 1 && layerCount == 1) {
+            SetupGuestMappings();
+            TryImportGuestMappings(imageCreateInfo);
+        }
+
+        if (!isDirect)
+            backing = tiling != vk::ImageTiling::eLinear ? gpu.memory.AllocateImage(imageCreateInfo) : gpu.memory.AllocateMappedImage(imageCreateInfo);
 
         SetupGuestMappings();
     }
@@ -626,6 +1392,8 @@ namespace skyline::gpu {
         SynchronizeGuest(true);
         if (trapHandle)
             gpu.state.nce->DeleteTrap(*trapHandle);
+        if (isDirect)
+            backing = vk::Image{}; // The imported memory must be freed prior to the mirror it aliases being unmapped
         if (alignedMirror.valid())
             munmap(alignedMirror.data(), alignedMirror.size());
     }
@@ -718,10 +1486,11 @@ namespace skyline::gpu {
     }
 
     void Texture::SynchronizeHost(bool gpuDirty) {
-        if (!guest)
+        if (!guest || isDirect)
             return;
 
         TRACE_EVENT("gpu", "Texture::SynchronizeHost");
+        std::vector<bool> dirtySubresources; //!< The subresources to synchronize if only a part of the texture is CPU dirty, this is empty if the entire texture is synchronized
         {
             std::scoped_lock lock{stateMutex};
             if (gpuDirty && dirtyState == DirtyState::Clean) {
@@ -734,20 +1503,26 @@ namespace skyline::gpu {
                 return; // If the texture has not been modified on the CPU, there is no need to synchronize it
             }
 
+            if (partiallyCpuDirty && CanSynchronizeHostPartially())
+                dirtySubresources = std::move(cpuDirtySubresources);
+            partiallyCpuDirty = false;
+
             dirtyState = gpuDirty ? DirtyState::GpuDirty : DirtyState::Clean;
             gpu.state.nce->TrapRegions(*trapHandle, !gpuDirty); // Trap any future CPU reads (optionally) + writes to this texture
         }
 
         // From this point on Clean -> CPU dirty state transitions can occur, GPU dirty -> * transitions will always require the full lock to be held and thus won't occur
 
-        auto stagingBuffer{SynchronizeHostImpl()};
-        if (stagingBuffer) {
+        auto upload{dirtySubresources.empty() ? SynchronizeHostImpl() : SynchronizeHostPartialImpl(dirtySubresources)};
+        if (upload.buffer) {
             if (cycle)
                 cycle->WaitSubmit();
+            InvalidateReadbackPrefetch();
+            std::shared_ptr<void> uploadDependency;
             auto lCycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
-                CopyFromStagingBuffer(commandBuffer, stagingBuffer);
+                uploadDependency = CopyFromStagingBuffer(commandBuffer, upload);
             })};
-            lCycle->AttachObjects(stagingBuffer, shared_from_this());
+            lCycle->AttachObjects(std::move(upload.buffer), std::move(uploadDependency), shared_from_this());
             lCycle->ChainCycle(cycle);
             cycle = lCycle;
         }
@@ -761,11 +1536,12 @@ namespace skyline::gpu {
     }
 
     void Texture::SynchronizeHostInline(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &pCycle, bool gpuDirty) {
-        if (!guest)
+        if (!guest || isDirect)
             return;
 
         TRACE_EVENT("gpu", "Texture::SynchronizeHostInline");
 
+        std::vector<bool> dirtySubresources;
         {
             std::scoped_lock lock{stateMutex};
             if (gpuDirty && dirtyState == DirtyState::Clean) {
@@ -777,14 +1553,22 @@ namespace skyline::gpu {
                 return;
             }
 
+            if (partiallyCpuDirty && CanSynchronizeHostPartially())
+                dirtySubresources = std::move(cpuDirtySubresources);
+            partiallyCpuDirty = false;
+
             dirtyState = gpuDirty ? DirtyState::GpuDirty : DirtyState::Clean;
             gpu.state.nce->TrapRegions(*trapHandle, !gpuDirty); // Trap any future CPU reads (optionally) + writes to this texture
         }
 
-        auto stagingBuffer{SynchronizeHostImpl()};
-        if (stagingBuffer) {
-            CopyFromStagingBuffer(commandBuffer, stagingBuffer);
-            pCycle->AttachObjects(stagingBuffer, shared_from_this());
+        auto upload{dirtySubresources.empty() ? SynchronizeHostImpl() : SynchronizeHostPartialImpl(dirtySubresources)};
+        if (upload.buffer) {
+            std::shared_ptr<void> uploadDependency;
+            if (CanCopyFromStagingBufferAsync(upload))
+                CopyFromStagingBufferAsync(commandBuffer, pCycle, upload); // Initial uploads are done on the transfer queue to avoid serializing them with any rendering
+            else
+                uploadDependency = CopyFromStagingBuffer(commandBuffer, upload);
+            pCycle->AttachObjects(std::move(upload.buffer), std::move(uploadDependency), shared_from_this());
             pCycle->ChainCycle(cycle);
             cycle = pCycle;
         }
@@ -798,7 +1582,7 @@ namespace skyline::gpu {
     }
 
     void Texture::SynchronizeGuest(bool cpuDirty, bool skipTrap) {
-        if (!guest)
+        if (!guest || isDirect)
             return;
 
         TRACE_EVENT("gpu", "Texture::SynchronizeGuest");
@@ -807,6 +1591,7 @@ namespace skyline::gpu {
             std::scoped_lock lock{stateMutex};
             if (cpuDirty && dirtyState == DirtyState::Clean) {
                 dirtyState = DirtyState::CpuDirty;
+                partiallyCpuDirty = false;
                 if (!skipTrap)
                     gpu.state.nce->DeleteTrap(*trapHandle);
                 return;
@@ -815,24 +1600,33 @@ namespace skyline::gpu {
             }
 
             dirtyState = cpuDirty ? DirtyState::CpuDirty : DirtyState::Clean;
+            partiallyCpuDirty = false;
         }
 
-        if (layout == vk::ImageLayout::eUndefined || format != guest->format)
+        if (layout == vk::ImageLayout::eUndefined || (format != guest->format && !RequiresDepthStencilConversion()))
             // If the state of the host texture is undefined then so can the guest
-            // If the texture has differing formats on the guest and host, we don't support converting back in that case as it may involve recompression of a decompressed texture
+            // If the texture has differing formats on the guest and host, we don't support converting back in that case as it may involve recompression of a decompressed texture, emulated depth formats are the exception as they're losslessly converted back on the GPU
             return;
 
         WaitOnBacking();
 
         if (tiling == vk::ImageTiling::eOptimal || !std::holds_alternative<memory::Image>(backing)) {
-            if (!downloadStagingBuffer)
-                downloadStagingBuffer = gpu.memory.AllocateStagingBuffer(surfaceSize);
+            if (readbackPrefetchCycle) {
+                // The last execution that wrote to the texture already copied it into the staging buffer, so we only need to wait for it to complete
+                readbackPrefetchCycle->Wait();
+                readbackPrefetchCycle = nullptr;
+                readbackScore = std::min(readbackScore + 1, MaxReadbackScore);
+            } else {
+                AllocateDownloadStagingBuffer();
 
-            WaitOnFence();
-            auto lCycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
-                CopyIntoStagingBuffer(commandBuffer, downloadStagingBuffer);
-            })};
-            lCycle->Wait(); // We block till the copy is complete
+                WaitOnFence();
+                std::shared_ptr<void> downloadDependency;
+                auto lCycle{gpu.scheduler.Submit([&](vk::raii::CommandBuffer &commandBuffer) {
+                    downloadDependency = CopyIntoStagingBuffer(commandBuffer, downloadStagingBuffer);
+                })};
+                lCycle->Wait(); // We block till the copy is complete
+                readbackScore = std::min(readbackScore + 1, MaxReadbackScore);
+            }
 
             CopyToGuest(downloadStagingBuffer->data());
         } else if (tiling == vk::ImageTiling::eLinear) {
@@ -850,12 +1644,32 @@ namespace skyline::gpu {
                 gpu.state.nce->TrapRegions(*trapHandle, true); // Trap any future CPU writes to this texture
     }
 
+    bool Texture::PrepareReadbackPrefetch(const std::shared_ptr<FenceCycle> &pCycle) {
+        InvalidateReadbackPrefetch(); // Any prior prefetch is overwritten by this execution without the guest having read it
+
+        if (readbackScore < ReadbackPrefetchThreshold || !guest || isDirect)
+            return false;
+
+        if (layout == vk::ImageLayout::eUndefined || (format != guest->format && !RequiresDepthStencilConversion()) || (tiling != vk::ImageTiling::eOptimal && std::holds_alternative<memory::Image>(backing)))
+            return false; // These textures are either never read back or are read back without a staging buffer
+
+        AllocateDownloadStagingBuffer();
+
+        readbackPrefetchCycle = pCycle;
+        return true;
+    }
+
+    void Texture::RecordReadbackPrefetch(const vk::raii::CommandBuffer &commandBuffer) {
+        if (auto downloadDependency{CopyIntoStagingBuffer(commandBuffer, downloadStagingBuffer)})
+            readbackPrefetchCycle->AttachObject(std::move(downloadDependency));
+    }
+
     std::shared_ptr<TextureView> Texture::GetView(vk::ImageViewType type, vk::ImageSubresourceRange range, texture::Format pFormat, vk::ComponentMapping mapping) {
         if (!pFormat || pFormat == guest->format)
             pFormat = format; // We want to use the texture's format if it isn't supplied or if the requested format matches the guest format then we want to use the host format just in case it is host incompatible and the host format differs from the guest format
 
         auto viewFormat{pFormat->vkFormat}, textureFormat{format->vkFormat};
-        if (gpu.traits.quirks.vkImageMutableFormatCostly && viewFormat != textureFormat && (!gpu.traits.quirks.adrenoRelaxedFormatAliasing || !texture::IsAdrenoAliasCompatible(viewFormat, textureFormat)))
+        if (!(flags & vk::ImageCreateFlagBits::eMutableFormat) && viewFormat != textureFormat && (!gpu.traits.quirks.adrenoRelaxedFormatAliasing || !texture::IsAdrenoAliasCompatible(viewFormat, textureFormat)))
             Logger::Warn("Creating a view of a texture with a different format without mutable format: {} - {}", vk::to_string(viewFormat), vk::to_string(textureFormat));
 
         if ((pFormat->vkAspect & format->vkAspect) == vk::ImageAspectFlagBits{}) {
@@ -870,10 +1684,17 @@ namespace skyline::gpu {
             mapping = vk::ComponentMapping{};
         }
 
-        return std::make_shared<TextureView>(shared_from_this(), type, range, pFormat, mapping);
+        // Identical views are shared while any of them are alive, so their handles remain stable for caches keyed on them such as the framebuffer cache and no redundant objects are created
+        auto &cachedView{views[ViewKey{type, pFormat, mapping, range}]};
+        if (auto view{cachedView.view.lock()})
+            return view;
+
+        auto view{std::make_shared<TextureView>(shared_from_this(), type, range, pFormat, mapping)};
+        cachedView.view = view;
+        return view;
     }
 
-    void Texture::CopyFrom(std::shared_ptr<Texture> source, vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore, texture::Format srcFormat, const vk::ImageSubresourceRange &subresource) {
+    void Texture::CopyFrom(std::shared_ptr<Texture> source, vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore, texture::Format srcFormat, const vk::ImageSubresourceRange &subresource, bool discardContents) {
         if (cycle)
             cycle->WaitSubmit();
         if (source->cycle)
@@ -885,8 +1706,8 @@ namespace skyline::gpu {
 
         if (source->layout == vk::ImageLayout::eUndefined)
             throw exception("Cannot copy from image with undefined layout");
-        else if (source->dimensions != dimensions)
-            throw exception("Cannot copy from image with different dimensions");
+        else if (source->dimensions.depth != dimensions.depth)
+            throw exception("Cannot copy from image with a different depth");
 
         TRACE_EVENT("gpu", "Texture::CopyFrom");
 
@@ -919,7 +1740,7 @@ namespace skyline::gpu {
                         .image = destinationBacking,
                         .srcAccessMask = vk::AccessFlagBits::eMemoryRead,
                         .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
-                        .oldLayout = layout,
+                        .oldLayout = discardContents ? vk::ImageLayout::eUndefined : layout,
                         .newLayout = vk::ImageLayout::eTransferDstOptimal,
                         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                         .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
@@ -937,13 +1758,14 @@ namespace skyline::gpu {
                     .layerCount = subresource.layerCount == VK_REMAINING_ARRAY_LAYERS ? layerCount - subresource.baseArrayLayer : subresource.layerCount,
                     };
                 for (; subresourceLayers.mipLevel < (subresource.levelCount == VK_REMAINING_MIP_LEVELS ? levelCount - subresource.baseMipLevel : subresource.levelCount); subresourceLayers.mipLevel++) {
-                    if (srcFormat != format) {
+                    if (srcFormat != format || source->dimensions != dimensions) {
+                        // Sources with differing dimensions (EG: Render targets rendered at a scaled resolution) are resampled with bilinear filtering
                         commandBuffer.blitImage(sourceBacking, vk::ImageLayout::eTransferSrcOptimal, destinationBacking, vk::ImageLayout::eTransferDstOptimal, vk::ImageBlit{
                                 .srcSubresource = subresourceLayers,
                                 .srcOffsets = std::array<vk::Offset3D, 2>{
                                     vk::Offset3D{0, 0, 0},
-                                    vk::Offset3D{static_cast<i32>(dimensions.width),
-                                                 static_cast<i32>(dimensions.height),
+                                    vk::Offset3D{static_cast<i32>(source->dimensions.width),
+                                                 static_cast<i32>(source->dimensions.height),
                                                  static_cast<i32>(subresourceLayers.layerCount)}
                                 },
                                 .dstSubresource = subresourceLayers,
@@ -997,6 +1819,7 @@ namespace skyline::gpu {
         }()};
         newCycle->AttachObjects(std::move(source), shared_from_this());
         cycle = newCycle;
+        InvalidateReadbackPrefetch();
     }
 
     bool Texture::ValidateRenderPassUsage(u32 renderPassIndex, texture::RenderPassUsage renderPassUsage) {
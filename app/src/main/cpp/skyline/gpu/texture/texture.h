@@ -61,6 +61,35 @@ namespace skyline::gpu {
             }
         };
 
+        /**
+         * @param scale The resolution scale in percent
+         * @return The dimensions of a texture with the supplied guest dimensions that's rendered at the supplied resolution scale, only the width and height are scaled
+         */
+        constexpr Dimensions ScaleDimensions(Dimensions dimensions, u32 scale) {
+            return Dimensions{
+                std::max(util::DivideCeil<u32>(dimensions.width * scale, 100), 1U),
+                std::max(util::DivideCeil<u32>(dimensions.height * scale, 100), 1U),
+                dimensions.depth
+            };
+        }
+
+        /**
+         * @param scale The resolution scale in percent
+         * @return The supplied rectangle in guest coordinates transformed into the coordinates of a texture rendered at the supplied resolution scale, any partially covered pixels are included
+         */
+        constexpr vk::Rect2D ScaleRect(vk::Rect2D rect, u32 scale) {
+            if (scale == 100)
+                return rect;
+
+            i64 left{(static_cast<i64>(rect.offset.x) * scale) / 100}, top{(static_cast<i64>(rect.offset.y) * scale) / 100};
+            i64 right{util::DivideCeil<i64>((static_cast<i64>(rect.offset.x) + rect.extent.width) * scale, 100)};
+            i64 bottom{util::DivideCeil<i64>((static_cast<i64>(rect.offset.y) + rect.extent.height) * scale, 100)};
+            return vk::Rect2D{
+                .offset = {static_cast<i32>(left), static_cast<i32>(top)},
+                .extent = {static_cast<u32>(std::min<i64>(right - left, std::numeric_limits<i32>::max())), static_cast<u32>(std::min<i64>(bottom - top, std::numeric_limits<i32>::max()))},
+            };
+        }
+
         /**
          * @note Blocks refers to the atomic unit of a compressed format (IE: The minimum amount of data that can be decompressed)
          */
@@ -82,6 +111,13 @@ namespace skyline::gpu {
                 return (blockHeight != 1) || (blockWidth != 1);
             }
 
+            /**
+             * @return If this is an ASTC LDR format, all of which are contiguous in the enumeration
+             */
+            constexpr bool IsAstc() const {
+                return vkFormat >= vk::Format::eAstc4x4UnormBlock && vkFormat <= vk::Format::eAstc12x12SrgbBlock;
+            }
+
             /**
              * @param width The width of the texture in pixels
              * @param height The height of the texture in pixels
@@ -231,6 +267,7 @@ namespace skyline::gpu {
 
     class Texture;
     class PresentationEngine; //!< A forward declaration of PresentationEngine as we require it to be able to create a Texture object
+    class TraitManager;
 
     /**
      * @brief A descriptor for a texture present in guest memory, it can be used to create a corresponding Texture object for usage on the host
@@ -378,35 +415,55 @@ namespace skyline::gpu {
         RecursiveSpinLock mutex; //!< Synchronizes any mutations to the texture or its backing
         std::atomic<ContextTag> tag{}; //!< The tag associated with the last lock call
         std::condition_variable_any backingCondition; //!< Signalled when a valid backing has been swapped in
-        using BackingType = std::variant<vk::Image, vk::raii::Image, memory::Image>;
+        using BackingType = std::variant<vk::Image, vk::raii::Image, memory::Image, memory::ImportedImage>;
         BackingType backing; //!< The Vulkan image that backs this texture, it is nullable
 
         span<u8> mirror{}; //!< A contiguous mirror of all the guest mappings to allow linear access on the CPU
         span<u8> alignedMirror{}; //!< The mirror mapping aligned to page size to reflect the full mapping
         std::optional<nce::NCE::TrapHandle> trapHandle{}; //!< The handle of the traps for the guest mappings
+        bool isDirect{}; //!< If the texture's backing directly aliases the guest mappings, no synchronization between the guest and host is required for such textures
         enum class DirtyState {
             Clean, //!< The CPU mappings are in sync with the GPU texture
             CpuDirty, //!< The CPU mappings have been modified but the GPU texture is not up to date
             GpuDirty, //!< The GPU texture has been modified but the CPU mappings have not been updated
         } dirtyState{DirtyState::CpuDirty}; //!< The state of the CPU mappings with respect to the GPU texture
+        std::vector<bool> cpuDirtySubresources; //!< A bitmap of all subresources indexed by `layer * levelCount + level` that have been written to by the CPU, this is only valid when `partiallyCpuDirty` is set
+        bool partiallyCpuDirty{}; //!< If the texture is CPU dirty but only the subresources in `cpuDirtySubresources` have been modified, the rest of the texture is in sync with the GPU
         std::recursive_mutex stateMutex; //!< Synchronizes access to the dirty state
 
         /**
-         * @brief Storage for all metadata about a specific view into the buffer, used to prevent redundant view creation and duplication of VkBufferView(s)
+         * @brief All metadata about a specific view into the texture, this identifies views so identical ones can be shared
          */
-        struct TextureViewStorage {
+        struct ViewKey {
             vk::ImageViewType type;
             texture::Format format;
             vk::ComponentMapping mapping;
             vk::ImageSubresourceRange range;
-            vk::raii::ImageView vkView;
 
-            TextureViewStorage(vk::ImageViewType type, texture::Format format, vk::ComponentMapping mapping, vk::ImageSubresourceRange range, vk::raii::ImageView &&vkView);
+            bool operator==(const ViewKey &) const = default;
+        };
+
+        struct ViewKeyHash {
+            size_t operator()(const ViewKey &key) const;
+        };
+
+        /**
+         * @brief A cached view into the texture, used to prevent redundant view creation and duplication of VkImageView(s)
+         */
+        struct CachedView {
+            std::optional<vk::raii::ImageView> vkView; //!< The Vulkan view, this is created lazily on the first use of the view and lives as long as the texture as it may be referenced by recorded commands or framebuffers
+            std::weak_ptr<TextureView> view; //!< The last TextureView created for the key, it's returned for identical requests as long as it's alive so they share a single object
         };
 
-        std::vector<TextureViewStorage> views;
+        std::unordered_map<ViewKey, CachedView, ViewKeyHash> views;
 
         std::shared_ptr<memory::StagingBuffer> downloadStagingBuffer{};
+        std::shared_ptr<FenceCycle> readbackPrefetchCycle; //!< The cycle of the execution which copied the texture into `downloadStagingBuffer` after writing to it, this is null if the staging buffer doesn't hold the latest contents of the texture
+
+        static constexpr u32 ReadbackPrefetchThreshold{3}; //!< The readback score at which the texture is copied into its staging buffer at the end of every execution it's used in
+        static constexpr u32 MaxReadbackScore{8}; //!< The maximum readback score, this bounds how many unused prefetches are done after the guest stops reading the texture back
+        u32 readbackScore{}; //!< A score for how often the guest reads the texture back after the GPU writes to it, this rises with every readback and falls with every prefetch that goes unused
+        std::optional<memory::Image> nativeImage{}; //!< An image at the guest resolution which is used as an intermediate for synchronizing a texture rendered at a scaled resolution, it's allocated on the first synchronization
 
         u32 lastRenderPassIndex{}; //!< The index of the last render pass that used this texture
         texture::RenderPassUsage lastRenderPassUsage{texture::RenderPassUsage::None}; //!< The type of usage in the last render pass
@@ -414,27 +471,105 @@ namespace skyline::gpu {
         friend TextureManager;
         friend TextureView;
 
+        std::list<Texture *>::iterator residencyIterator; //!< An iterator to this texture in the residency list of the TextureManager, this is only valid for textures created by it
+        u64 lastUseEpoch{}; //!< The idle epoch of the TextureManager during which this texture was last looked up
+
         /**
          * @brief Sets up mirror mappings for the guest mappings, this must be called after construction for the mirror to be valid
          */
         void SetupGuestMappings();
 
+        /**
+         * @brief Attempts to create a backing that directly aliases the guest mappings, this requires the guest texture to be in a layout that the host can use as-is
+         * @return If the backing was created, the texture is direct if so
+         * @note The guest mirror must be set up prior to calling this
+         */
+        bool TryImportGuestMappings(const vk::ImageCreateInfo &createInfo);
+
+        static constexpr size_t GpuDeswizzleMaximumSize{1ULL << 27}; //!< The maximum size of a surface for it to be deswizzled on the GPU, this is the minimum guaranteed value of maxStorageBufferRange
+        static constexpr vk::DeviceSize GpuDeswizzleOffsetAlignment{0x100}; //!< The alignment of the linear region in a GPU deswizzle staging buffer, this is the maximum permitted value of minStorageBufferOffsetAlignment
+        static constexpr u32 ResolutionScaleMinimumDimension{64}; //!< The minimum width and height of a render target for it to be rendered at a scaled resolution, smaller ones are generally intermediate buffers (EG: Luminance reduction) where scaling saves little and can break effects
+
+        /**
+         * @brief Guest texture data that has been staged for being copied into the host texture
+         */
+        struct StagingUpload {
+            std::shared_ptr<memory::StagingBuffer> buffer; //!< The staging buffer containing the texture data, this is null if a staging buffer wasn't required
+            vk::DeviceSize linearOffset{}; //!< The offset of the linear texture data in the staging buffer
+            bool deswizzleOnGpu{}; //!< If the staging buffer contains raw block-linear guest data prior to `linearOffset` which must be deswizzled on the GPU before the copy
+            bool decodeAstcOnGpu{}; //!< If the staging buffer contains linear ASTC guest data prior to `linearOffset` which must be decoded on the GPU before the copy
+            bool convertDepthStencilOnGpu{}; //!< If the staging buffer contains linear packed 24-bit depth guest data prior to `linearOffset` which must be split into the planes of the host format on the GPU before the copy
+            boost::container::small_vector<vk::BufferImageCopy, 10> subresourceCopies; //!< The copies for a partial upload of only certain subresources, the entire texture is copied if this is empty
+        };
+
+        /**
+         * @brief Marks all subresources that overlap with the supplied guest page as CPU dirty
+         * @note The state mutex must be locked when calling this
+         */
+        void MarkPageCpuDirty(u8 *page);
+
+        /**
+         * @return If only the CPU dirty subresources can be synchronized rather than the entire texture
+         * @note The state mutex must be locked when calling this
+         */
+        bool CanSynchronizeHostPartially();
+
+        /**
+         * @brief An implementation function for guest -> host synchronization of only the supplied subresources, these are always deswizzled on the CPU into a staging buffer
+         * @param dirtySubresources A bitmap of the subresources to synchronize in the same format as `cpuDirtySubresources`
+         */
+        StagingUpload SynchronizeHostPartialImpl(const std::vector<bool> &dirtySubresources);
+
+        /**
+         * @return If the guest texture data can be uploaded as-is and deswizzled on the GPU rather than on the CPU
+         */
+        bool CanDeswizzleOnGpu();
+
+        /**
+         * @return If the texture emulates a packed 24-bit depth guest format that the host doesn't support with a 32-bit floating point depth format, the texels are converted between the formats on the GPU during uploads and readbacks
+         */
+        bool RequiresDepthStencilConversion();
+
+        /**
+         * @brief Allocates the download staging buffer if it hasn't been allocated already, textures that require depth/stencil conversion have the planes of the host format following the packed guest texels in it
+         */
+        void AllocateDownloadStagingBuffer();
+
+        /**
+         * @brief Deswizzles all layers and mip levels of the guest texture into a linear buffer that has all layers for a given mip level
+         */
+        void DeswizzleGuest(u8 *guestInput, u8 *linearOutput);
+
         /**
          * @brief An implementation function for guest -> host texture synchronization, it allocates and copies data into a staging buffer or directly into a linear host texture
          * @return If a staging buffer was required for the texture sync, it's returned filled with guest texture data and must be copied to the host texture by the callee
          */
-        std::shared_ptr<memory::StagingBuffer> SynchronizeHostImpl();
+        StagingUpload SynchronizeHostImpl();
 
         /**
          * @brief Records commands for copying data from a staging buffer to the texture's backing into the supplied command buffer
+         * @return An object that must be attached to the fence cycle of the command buffer alongside the staging buffer, this is nullable
+         */
+        std::shared_ptr<void> CopyFromStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const StagingUpload &upload);
+
+        /**
+         * @return If the staging upload can be copied into the texture's backing on the asynchronous transfer queue
+         * @note Only initial uploads of CPU-deswizzled data into textures without any GPU contents are supported as other uploads would require synchronizing with the graphics queue
+         */
+        bool CanCopyFromStagingBufferAsync(const StagingUpload &upload);
+
+        /**
+         * @brief Copies data from a staging buffer to the texture's backing on the transfer queue, the supplied command buffer will acquire ownership of the texture once the copy has completed
+         * @note The staging buffer must be attached to the supplied cycle as it'll only be signalled after the copy has completed
          */
-        void CopyFromStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer);
+        void CopyFromStagingBufferAsync(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<FenceCycle> &cycle, const StagingUpload &upload);
 
         /**
          * @brief Records commands for copying data from the texture's backing to a staging buffer into the supplied command buffer
          * @note Any caller **must** ensure that the layout is not `eUndefined`
+         * @return An object that must be attached to the fence cycle of the command buffer, this is nullable
          */
-        void CopyIntoStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer);
+        std::shared_ptr<void> CopyIntoStagingBuffer(const vk::raii::CommandBuffer &commandBuffer, const std::shared_ptr<memory::StagingBuffer> &stagingBuffer);
 
         /**
          * @brief Copies data from the supplied host buffer into the guest texture
@@ -447,6 +582,30 @@ namespace skyline::gpu {
          */
         boost::container::small_vector<vk::BufferImageCopy, 10> GetBufferImageCopies();
 
+        /**
+         * @return If a texture with the supplied attributes can be rendered at a scaled resolution, this requires it to be synchronizable with the guest by blitting to and from a guest resolution image
+         */
+        bool CanScaleResolution(vk::ImageType imageType);
+
+        /**
+         * @brief Records a transition of the guest resolution intermediate image for transfer writes into the supplied command buffer, allocating it if necessary
+         * @return The intermediate image in the general layout, its prior contents are discarded
+         */
+        vk::Image AcquireNativeImage(const vk::raii::CommandBuffer &commandBuffer);
+
+        /**
+         * @brief Records a blit between the guest resolution intermediate image and the scaled backing into the supplied command buffer
+         * @param toNative If the backing is blitted into the intermediate image for a readback rather than the other way around for an upload
+         * @note The intermediate image must have been acquired with AcquireNativeImage() prior to this in the same command buffer
+         * @note A barrier is recorded after a blit into the intermediate image to make it available for transfer reads
+         */
+        void BlitNativeImage(const vk::raii::CommandBuffer &commandBuffer, bool toNative);
+
+        /**
+         * @brief Drops any prefetched readback as the contents of the texture are being modified outside of the execution that prefetched them
+         */
+        void InvalidateReadbackPrefetch();
+
         static constexpr size_t FrequentlyLockedThreshold{2}; //!< Threshold for the number of times a texture can be locked (not from context locks, only normal) before it should be considered frequently locked
         size_t accumulatedCpuLockCounter{};
 
@@ -472,6 +631,7 @@ namespace skyline::gpu {
         size_t deswizzledSurfaceSize{}; //!< The size of the guest surface with linear tiling, calculated with the guest format which may differ from the host format
         size_t surfaceSize{}; //!< The size of the entire surface given linear tiling, this contains all mip levels and layers
         vk::SampleCountFlagBits sampleCount;
+        u32 resolutionScale{100}; //!< The percentage of the guest dimensions that the host image is rendered at, this is only not 100 for render targets rendered at a scaled resolution
         bool replaced{};
 
         /**
@@ -482,9 +642,10 @@ namespace skyline::gpu {
 
         /**
          * @brief Creates a texture object wrapping the guest texture with a backing that can represent the guest texture data
+         * @param resolutionScale The percentage of the guest dimensions to create the backing at, this is ignored for textures that can't be scaled
          * @note The guest mappings will not be setup until SetupGuestMappings() is called
          */
-        Texture(GPU &gpu, GuestTexture guest);
+        Texture(GPU &gpu, GuestTexture guest, u32 resolutionScale = 100);
 
         ~Texture();
 
@@ -496,6 +657,7 @@ namespace skyline::gpu {
                 [](vk::Image image) { return image; },
                 [](const vk::raii::Image &image) { return *image; },
                 [](const memory::Image &image) { return image.vkImage; },
+                [](const memory::ImportedImage &image) { return *image.vkImage; },
             }, backing);
         }
 
@@ -575,6 +737,20 @@ namespace skyline::gpu {
          */
         void SynchronizeGuest(bool cpuDirty = false, bool skipTrap = false);
 
+        /**
+         * @brief Prepares for the texture to be copied into its download staging buffer at the end of an execution if the guest frequently reads it back after the GPU writes to it, a later SynchronizeGuest() then only needs to wait on the execution rather than submit a copy of its own
+         * @param pCycle The cycle of the execution that is writing to the texture
+         * @return If the texture should be prefetched, RecordReadbackPrefetch() must then be called after all other commands in the execution have been recorded
+         * @note The texture **must** be locked prior to calling this
+         */
+        bool PrepareReadbackPrefetch(const std::shared_ptr<FenceCycle> &pCycle);
+
+        /**
+         * @brief Records commands for copying the texture into its download staging buffer into the supplied command buffer
+         * @note PrepareReadbackPrefetch() must have returned true for the execution the command buffer is from
+         */
+        void RecordReadbackPrefetch(const vk::raii::CommandBuffer &commandBuffer);
+
         /**
          * @return A cached or newly created view into this texture with the supplied attributes
          */
@@ -582,12 +758,13 @@ namespace skyline::gpu {
 
         /**
          * @brief Copies the contents of the supplied source texture into the current texture
+         * @param discardContents If the prior contents of the subresource should be discarded rather than preserved for the copy, this avoids the driver having to retain (and potentially decompress) them when they're entirely overwritten
          */
         void CopyFrom(std::shared_ptr<Texture> source, vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore, texture::Format srcFormat, const vk::ImageSubresourceRange &subresource = vk::ImageSubresourceRange{
             .aspectMask = vk::ImageAspectFlagBits::eColor,
             .levelCount = VK_REMAINING_MIP_LEVELS,
             .layerCount = VK_REMAINING_ARRAY_LAYERS,
-        });
+        }, bool discardContents = false);
 
         /**
          * @return If the texture is frequently locked by threads using non-ContextLocks
@@ -607,4 +784,9 @@ namespace skyline::gpu {
          */
         void UpdateRenderPassUsage(u32 renderPassIndex, texture::RenderPassUsage renderPassUsage);
     };
+
+    /**
+     * @return The format that a host texture for a guest texture of the supplied format is created with, this differs from the guest format when the host doesn't support it and the texture is emulated with another format
+     */
+    texture::Format ConvertHostCompatibleFormat(texture::Format format, const TraitManager &traits);
 }
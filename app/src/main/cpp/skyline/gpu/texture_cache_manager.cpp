@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <xxhash.h>
+#include <common/file_descriptor.h>
+#include "texture_cache_manager.h"
+
+namespace skyline::gpu {
+    struct TextureCacheFileHeader {
+        static constexpr u32 Magic{util::MakeMagic<u32>("TCHE")}; //!< The magic value used to identify a texture cache file
+        static constexpr u32 Version{1}; //!< The version of the texture cache file format, MUST be incremented for any format changes or changes to the decoded output
+
+        u32 magic{Magic};
+        u32 version{Version};
+        TextureCacheManager::Key key;
+    };
+
+    void TextureCacheManager::Run() {
+        while (true) {
+            std::unique_lock lock(writeMutex);
+            writeCondition.wait(lock, [this] { return !writeQueue.empty() || exitWriter; });
+            if (writeQueue.empty())
+                return;
+
+            auto entry{std::move(writeQueue.front())};
+            writeQueue.pop();
+            lock.unlock();
+
+            // Entries are written to a temporary file first and then renamed, so a partially written entry can never be read
+            auto entryPath{GetEntryPath(entry.key)};
+            auto temporaryPath{entryPath + ".tmp"};
+            {
+                std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+                TextureCacheFileHeader header{.key = entry.key};
+                stream.write(reinterpret_cast<const char *>(&header), sizeof(TextureCacheFileHeader));
+                stream.write(reinterpret_cast<const char *>(entry.data.data()), static_cast<std::streamsize>(entry.data.size()));
+                if (stream.fail()) {
+                    Logger::Warn("Failed to write texture cache entry: {}", entryPath);
+                    stream.close();
+                    std::filesystem::remove(temporaryPath);
+                    continue;
+                }
+            }
+
+            std::error_code error;
+            std::filesystem::rename(temporaryPath, entryPath, error);
+            if (error)
+                Logger::Warn("Failed to commit texture cache entry: {} ({})", entryPath, error.message());
+        }
+    }
+
+    std::string TextureCacheManager::GetEntryPath(const Key &key) {
+        return fmt::format("{}{:016X}_{}", path, key.guestHash, static_cast<u32>(key.hostFormat));
+    }
+
+    TextureCacheManager::TextureCacheManager(const std::string &path) : path{path} {
+        std::filesystem::create_directories(path);
+
+        // Remove any temporary files that were left behind by writes that were interrupted
+        std::error_code error;
+        for (const auto &file : std::filesystem::directory_iterator{path, error})
+            if (file.path().extension() == ".tmp")
+                std::filesystem::remove(file.path(), error);
+
+        writerThread = std::thread(&TextureCacheManager::Run, this);
+    }
+
+    TextureCacheManager::~TextureCacheManager() {
+        {
+            std::scoped_lock lock{writeMutex};
+            exitWriter = true;
+        }
+        writeCondition.notify_one();
+        writerThread.join();
+    }
+
+    TextureCacheManager::Key TextureCacheManager::GetKey(span<u8> guest, vk::Format guestFormat, vk::Format hostFormat, texture::TileConfig tileConfig, texture::Dimensions dimensions, u32 levelCount, u32 layerCount, size_t size) {
+        return Key{
+            .guestHash = XXH3_64bits(guest.data(), guest.size()),
+            .guestFormat = guestFormat,
+            .hostFormat = hostFormat,
+            .tileConfig = tileConfig,
+            .dimensions = dimensions,
+            .levelCount = levelCount,
+            .layerCount = layerCount,
+            .size = size,
+        };
+    }
+
+    bool TextureCacheManager::Read(const Key &key, span<u8> output) {
+        FileDescriptor fd{open(GetEntryPath(key).c_str(), O_RDONLY | O_CLOEXEC)};
+        if (fd == -1)
+            return false;
+
+        struct stat stats{};
+        if (fstat(fd, &stats) == -1 || static_cast<size_t>(stats.st_size) != sizeof(TextureCacheFileHeader) + output.size())
+            return false;
+
+        auto mapping{static_cast<u8 *>(mmap(nullptr, static_cast<size_t>(stats.st_size), PROT_READ, MAP_PRIVATE, fd, 0))};
+        if (mapping == MAP_FAILED)
+            return false;
+
+        const auto &header{*reinterpret_cast<const TextureCacheFileHeader *>(mapping)};
+        bool valid{header.magic == TextureCacheFileHeader::Magic && header.version == TextureCacheFileHeader::Version && header.key == key};
+        if (valid)
+            output.copy_from(span<u8>{mapping + sizeof(TextureCacheFileHeader), output.size()});
+
+        munmap(mapping, static_cast<size_t>(stats.st_size));
+        return valid;
+    }
+
+    void TextureCacheManager::QueueWrite(const Key &key, span<u8> data) {
+        std::scoped_lock lock{writeMutex};
+        writeQueue.emplace(Entry{key, std::vector<u8>(data.begin(), data.end())});
+        writeCondition.notify_one();
+    }
+}
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <queue>
+#include <common.h>
+#include "texture/texture.h"
+
+namespace skyline::gpu {
+    /**
+     * @brief Manages a persistent on-disk cache of texture data that has been decoded into a host format on the CPU, this avoids redoing expensive decodes of the same textures on every boot
+     * @note Every entry is stored in a separate file named after its guest data hash and host format, entries are memory-mapped when they're read
+     */
+    class TextureCacheManager {
+      public:
+        /**
+         * @brief The key identifying decoded texture data, this contains everything that affects the result of decoding guest texture data
+         */
+        struct Key {
+            u64 guestHash; //!< An XXH3 hash of the guest texture data
+            vk::Format guestFormat;
+            vk::Format hostFormat;
+            texture::TileConfig tileConfig;
+            texture::Dimensions dimensions;
+            u32 levelCount;
+            u32 layerCount;
+            u64 size; //!< The size of the decoded texture data in bytes
+
+            bool operator==(const Key &) const = default;
+        };
+
+      private:
+        /**
+         * @brief A pending write of decoded texture data to the cache
+         */
+        struct Entry {
+            Key key;
+            std::vector<u8> data;
+        };
+
+        std::thread writerThread;
+        std::queue<Entry> writeQueue; //!< The queue of entries to be written to the cache
+        std::mutex writeMutex; //!< Protects access to the write queue
+        std::condition_variable writeCondition; //!< Notifies the writer thread when the write queue is not empty or it should exit
+        bool exitWriter{}; //!< If the writer thread should exit after writing out all pending entries
+        std::string path; //!< The path to the directory containing all cache entries
+
+        void Run();
+
+        /**
+         * @return The path to the file containing the entry for the supplied key
+         */
+        std::string GetEntryPath(const Key &key);
+
+      public:
+        TextureCacheManager(const std::string &path);
+
+        ~TextureCacheManager();
+
+        /**
+         * @return A key for the supplied guest data with the supplied host decoding attributes
+         */
+        static Key GetKey(span<u8> guest, vk::Format guestFormat, vk::Format hostFormat, texture::TileConfig tileConfig, texture::Dimensions dimensions, u32 levelCount, u32 layerCount, size_t size);
+
+        /**
+         * @brief Reads the decoded texture data corresponding to the key into the supplied buffer
+         * @return If a valid entry for the key was found and read, the buffer's contents are undefined otherwise
+         */
+        bool Read(const Key &key, span<u8> output);
+
+        /**
+         * @brief Queues the decoded texture data to be written to the cache, a copy of the data is made so the buffer may be reused immediately
+         */
+        void QueueWrite(const Key &key, span<u8> data);
+    };
+}
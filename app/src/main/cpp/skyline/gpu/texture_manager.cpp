@@ -1,14 +1,132 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <gpu.h>
+#include <common/settings.h>
 #include "texture_manager.h"
 
 namespace skyline::gpu {
     TextureManager::TextureManager(GPU &gpu) : gpu(gpu) {}
 
-    std::shared_ptr<TextureView> TextureManager::FindOrCreate(const GuestTexture &guestTexture, ContextTag tag) {
+    bool TextureManager::IsFullMatch(const Texture &texture, const GuestTexture &guestTexture) {
+        auto &matchGuestTexture{*texture.guest};
+        return matchGuestTexture.format->IsCompatible(*guestTexture.format) &&
+            ((((matchGuestTexture.dimensions.width == guestTexture.dimensions.width &&
+                matchGuestTexture.dimensions.height == guestTexture.dimensions.height) || matchGuestTexture.CalculateLayerSize() == guestTexture.CalculateLayerSize()) &&
+                matchGuestTexture.GetViewDepth() <= guestTexture.GetViewDepth())
+                || matchGuestTexture.viewMipBase > 0)
+            && matchGuestTexture.tileConfig == guestTexture.tileConfig;
+    }
+
+    void TextureManager::SetLookasideEntry(span<u8> guestMapping, Texture *texture) {
+        auto pageStart{util::AlignDown(guestMapping.data(), constant::PageSize)};
+        textureTable.Set(pageStart, pageStart + constant::PageSize, texture);
+    }
+
+    void TextureManager::MarkUsed(Texture &texture) {
+        residencyList.splice(residencyList.end(), residencyList, texture.residencyIterator);
+        texture.lastUseEpoch = idleEpoch;
+    }
+
+    bool TextureManager::TryEvict(Texture &texture) {
+        // Any references to the texture aside from the ones held by its mappings mean that it's still in use (by views, pending fence cycles or otherwise), so it can't be evicted
+        if (static_cast<size_t>(texture.weak_from_this().use_count()) != texture.guest->mappings.size())
+            return false;
+
+        {
+            std::unique_lock lock{texture.mutex, std::try_to_lock};
+            if (!lock)
+                return false;
+
+            if (texture.dirtyState == Texture::DirtyState::GpuDirty && texture.format != texture.guest->format)
+                return false; // Textures with a host format that differs from the guest format can't be synchronized back to the guest, evicting them would lose their contents
+
+            texture.SynchronizeGuest();
+        }
+
+        for (const auto &mapping : texture.guest->mappings)
+            textureTable.Set(util::AlignDown(mapping.data(), constant::PageSize), util::AlignUp(mapping.data() + mapping.size(), constant::PageSize), nullptr);
+
+        residencyList.erase(texture.residencyIterator);
+        residentSize -= texture.surfaceSize;
+        residentCount--;
+
+        // Erasing the last mapping will destroy the texture
+        std::erase_if(textures, [&texture](const TextureMapping &mapping) {
+            return mapping.texture.get() == &texture;
+        });
+        return true;
+    }
+
+    void TextureManager::EnforceBudget(size_t requiredSize) {
+        size_t usage, budget;
+        if (u32 budgetMib{*gpu.state.settings->textureMemoryBudget}; budgetMib) {
+            usage = residentSize;
+            budget = static_cast<size_t>(budgetMib) << 20;
+        } else {
+            auto deviceBudget{gpu.memory.GetDeviceLocalBudget()};
+            usage = deviceBudget.usage;
+            budget = (deviceBudget.budget / 10) * 9; // We leave some headroom in the budget for any allocations that aren't textures
+        }
+
+        for (auto it{residencyList.begin()}; usage + requiredSize > budget && it != residencyList.end();) {
+            auto &texture{**it++}; // The iterator must be incremented prior to eviction as it'll be invalidated by it
+            size_t textureSize{texture.surfaceSize};
+            if (TryEvict(texture))
+                usage -= std::min(usage, textureSize);
+        }
+    }
+
+    void TextureManager::EvictIdle() {
+        i64 now{util::GetTimeNs()};
+        if (now - lastIdleEpochTime < IdleEpochDuration)
+            return;
+        lastIdleEpochTime = now;
+        idleEpoch++;
+
+        size_t evictedCount{}, evictedSize{};
+        for (auto it{residencyList.begin()}; it != residencyList.end();) {
+            auto &texture{**it++}; // The iterator must be incremented prior to eviction as it'll be invalidated by it
+            if (idleEpoch - texture.lastUseEpoch < IdleEvictionEpochs)
+                break; // The list is ordered by last use, so all following textures have been used more recently
+
+            size_t textureSize{texture.surfaceSize};
+            if (TryEvict(texture)) {
+                evictedCount++;
+                evictedSize += textureSize;
+            }
+        }
+
+        if (evictedCount)
+            Logger::Debug("Evicted {} idle textures ({} KiB)", evictedCount, evictedSize / 1024);
+    }
+
+    std::shared_ptr<TextureView> TextureManager::FindOrCreate(const GuestTexture &guestTexture, ContextTag tag, bool renderTarget) {
         auto guestMapping{guestTexture.mappings.front()};
 
+        auto getView{[&](const std::shared_ptr<Texture> &texture, u32 levelOffset, u32 layerOffset) {
+            return texture->GetView(guestTexture.viewType, vk::ImageSubresourceRange{
+                .aspectMask = guestTexture.aspect,
+                .baseMipLevel = guestTexture.viewMipBase + levelOffset,
+                .levelCount = guestTexture.viewMipCount,
+                .baseArrayLayer = guestTexture.baseArrayLayer + layerOffset,
+                .layerCount = guestTexture.GetViewLayerCount(),
+            }, guestTexture.format, guestTexture.swizzle);
+        }};
+
+        // Try to do a fast lookup in the page table, this only handles perfect 1:1 matches of all mappings
+        if (auto lookupTexture{textureTable[guestMapping.data()]}; lookupTexture && !lookupTexture->replaced) {
+            auto &lookupMappings{lookupTexture->guest->mappings};
+            if (std::equal(lookupMappings.begin(), lookupMappings.end(), guestTexture.mappings.begin(), guestTexture.mappings.end(), [](const span<u8> &lhs, const span<u8> &rhs) {
+                return lhs.data() == rhs.data() && lhs.size() == rhs.size();
+            }) && IsFullMatch(*lookupTexture, guestTexture)) {
+                auto texture{lookupTexture->shared_from_this()};
+                MarkUsed(*texture);
+                ContextLock textureLock{tag, *texture};
+                return getView(texture, 0, 0);
+            }
+        }
+
         /*
          * Iterate over all textures that overlap with the first mapping of the guest texture and compare the mappings:
          * 1) All mappings match up perfectly, we check that the rest of the supplied mappings correspond to mappings in the texture
@@ -54,13 +172,7 @@ namespace skyline::gpu {
 
             if (firstHostMapping == hostMappings.begin() && firstHostMapping->begin() == guestMapping.begin() && mappingMatch && lastHostMapping == hostMappings.end() && lastGuestMapping.end() == std::prev(lastHostMapping)->end()) {
                 // We've gotten a perfect 1:1 match for *all* mappings from the start to end, we just need to check for compatibility aside from this
-                auto &matchGuestTexture{*hostMapping->texture->guest};
-                if (matchGuestTexture.format->IsCompatible(*guestTexture.format) &&
-                    ((((matchGuestTexture.dimensions.width == guestTexture.dimensions.width &&
-                        matchGuestTexture.dimensions.height == guestTexture.dimensions.height) || matchGuestTexture.CalculateLayerSize() == guestTexture.CalculateLayerSize()) &&
-                        matchGuestTexture.GetViewDepth() <= guestTexture.GetViewDepth())
-                        || matchGuestTexture.viewMipBase > 0)
-                    && matchGuestTexture.tileConfig == guestTexture.tileConfig) {
+                if (IsFullMatch(*hostMapping->texture, guestTexture)) {
                     fullMatch = hostMapping->texture;
                 } else {
                     matches.push_back(hostMapping->texture);
@@ -108,47 +220,44 @@ namespace skyline::gpu {
          }
 
         if (layerMipMatch) {
+            MarkUsed(*layerMipMatch);
             ContextLock textureLock{tag, *layerMipMatch};
-            return layerMipMatch->GetView(guestTexture.viewType, vk::ImageSubresourceRange{
-                .aspectMask = guestTexture.aspect,
-                .baseMipLevel = guestTexture.viewMipBase + matchLevel,
-                .levelCount = guestTexture.viewMipCount,
-                .baseArrayLayer = guestTexture.baseArrayLayer + matchLayer,
-                .layerCount = guestTexture.GetViewLayerCount(),
-            }, guestTexture.format, guestTexture.swizzle);
+            return getView(layerMipMatch, matchLevel, matchLayer);
         } else if (fullMatch) {
+            SetLookasideEntry(guestMapping, fullMatch.get());
+            MarkUsed(*fullMatch);
             ContextLock textureLock{tag, *fullMatch};
-            return fullMatch->GetView(guestTexture.viewType, vk::ImageSubresourceRange{
-                .aspectMask = guestTexture.aspect,
-                .baseMipLevel = guestTexture.viewMipBase,
-                .levelCount = guestTexture.viewMipCount,
-                .baseArrayLayer = guestTexture.baseArrayLayer,
-                .layerCount = guestTexture.GetViewLayerCount(),
-            }, guestTexture.format, guestTexture.swizzle);
+            return getView(fullMatch, 0, 0);
         }
 
         for (auto &texture : matches)
             texture->SynchronizeGuest(false, true);
 
         // Create a texture as we cannot find one that matches
-        auto texture{std::make_shared<Texture>(gpu, guestTexture)};
+        // Only render targets are scaled as textures uploaded by the guest would only lose detail from being scaled
+        auto texture{std::make_shared<Texture>(gpu, guestTexture, renderTarget ? std::clamp(*gpu.state.settings->resolutionScale, 1U, 100U) : 100U)};
         texture->SetupGuestMappings();
         texture->TransitionLayout(vk::ImageLayout::eGeneral);
+
+        // The texture isn't in the residency list yet, so it can't be evicted by this
+        EnforceBudget(texture->surfaceSize);
+        texture->residencyIterator = residencyList.insert(residencyList.end(), texture.get());
+        texture->lastUseEpoch = idleEpoch;
+        residentSize += texture->surfaceSize;
+        residentCount++;
         auto it{texture->guest->mappings.begin()};
         textures.emplace(mappingEnd, TextureMapping{texture, it, guestMapping});
         while ((++it) != texture->guest->mappings.end()) {
-            guestMapping = *it;
-            auto mapping{std::upper_bound(textures.begin(), textures.end(), guestMapping)};
+            auto mapping{std::upper_bound(textures.begin(), textures.end(), *it)};
             // TODO: Delete overlapping textures that aren't in texture pool
-            textures.emplace(mapping, TextureMapping{texture, it, guestMapping});
+            textures.emplace(mapping, TextureMapping{texture, it, *it});
         }
 
-        return texture->GetView(guestTexture.viewType, vk::ImageSubresourceRange{
-            .aspectMask = guestTexture.aspect,
-            .baseMipLevel = guestTexture.viewMipBase,
-            .levelCount = guestTexture.viewMipCount,
-            .baseArrayLayer = guestTexture.baseArrayLayer,
-            .layerCount = guestTexture.GetViewLayerCount(),
-        }, guestTexture.format, guestTexture.swizzle);
+        // Any lookaside entries inside the new texture are invalidated as a lookup of them could now match a layer or mip of the new texture instead
+        for (const auto &mapping : texture->guest->mappings)
+            textureTable.Set(util::AlignDown(mapping.data(), constant::PageSize), util::AlignUp(mapping.data() + mapping.size(), constant::PageSize), nullptr);
+        SetLookasideEntry(guestMapping, texture.get());
+
+        return getView(texture, 0, 0);
     }
 }
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <BS_thread_pool.hpp>
+#include <common/segment_table.h>
 #include "texture/texture.h"
 
 namespace skyline::gpu {
@@ -28,13 +30,70 @@ namespace skyline::gpu {
         GPU &gpu;
         std::vector<TextureMapping> textures; //!< A sorted vector of all texture mappings
 
+        static constexpr size_t L2EntryGranularity{19}; //!< The amount of AS (in bytes) a single L2 PTE covers (512 KiB == 1 << 19)
+        SegmentTable<Texture *, constant::AddressSpaceSize, constant::PageSizeBits, L2EntryGranularity> textureTable; //!< A page table of the last fully matched texture starting in each page for O(1) lookups on full matches, this is a lookaside cache and any entry must be verified before use
+
+        /**
+         * @return If the texture is a perfect 1:1 match for all mappings of the guest texture and is compatible with it, so a view of it can be returned directly
+         */
+        static bool IsFullMatch(const Texture &texture, const GuestTexture &guestTexture);
+
+        /**
+         * @brief Sets the supplied texture as the lookaside entry for the page the guest mapping starts in
+         */
+        void SetLookasideEntry(span<u8> guestMapping, Texture *texture);
+
+        std::list<Texture *> residencyList; //!< A list of all textures ordered by when they were last looked up, the least recently used texture is at the front
+        std::atomic<size_t> residentSize{}; //!< The combined size of all textures in the residency list in bytes, this is atomic so it can be sampled without locking the texture manager
+        std::atomic<size_t> residentCount{}; //!< The amount of textures in the residency list
+
+        static constexpr i64 IdleEpochDuration{constant::NsInSecond}; //!< The duration of an idle epoch, the last use of textures is tracked at this granularity so lookups don't need to query the time
+        static constexpr u64 IdleEvictionEpochs{120}; //!< The amount of epochs a texture must go without being looked up for it to be evicted regardless of the memory budget
+        u64 idleEpoch{}; //!< The current idle epoch, this is incremented by EvictIdle
+        i64 lastIdleEpochTime{}; //!< The time at which the current idle epoch started
+
+        /**
+         * @brief Marks the texture as the most recently used texture in the residency list
+         */
+        void MarkUsed(Texture &texture);
+
+        /**
+         * @brief Evicts the texture if it isn't referenced by anything aside from its mappings, any GPU-dirty contents are synchronized back to the guest prior to it being destroyed
+         * @return If the texture was evicted, it's destroyed and must not be accessed anymore if so
+         * @note An evicted texture is restored on demand by a future lookup recreating it from the guest data
+         */
+        bool TryEvict(Texture &texture);
+
+        /**
+         * @brief Evicts unused textures in least recently used order till the supplied amount of memory fits into the texture memory budget or no more textures can be evicted
+         */
+        void EnforceBudget(size_t requiredSize);
+
       public:
+        BS::thread_pool decodePool; //!< A thread pool for decoding texture formats that are unsupported by the host GPU on the CPU, decoding of large images is split across it
+
         TextureManager(GPU &gpu);
 
+        size_t GetResidentCount() const {
+            return residentCount.load(std::memory_order_relaxed);
+        }
+
+        size_t GetResidentSize() const {
+            return residentSize.load(std::memory_order_relaxed);
+        }
+
         /**
+         * @param renderTarget If the texture is looked up to be rendered to, a newly created texture will be rendered at the configured resolution scale if so
          * @return A pre-existing or newly created Texture object which matches the specified criteria
          * @note The texture manager **must** be locked prior to calling this
          */
-        std::shared_ptr<TextureView> FindOrCreate(const GuestTexture &guestTexture, ContextTag tag = {});
+        std::shared_ptr<TextureView> FindOrCreate(const GuestTexture &guestTexture, ContextTag tag = {}, bool renderTarget = false);
+
+        /**
+         * @brief Evicts textures that haven't been looked up for a long time, so the host memory of textures that a title has stopped using is released before memory pressure builds up
+         * @note This is cheap enough to call after every submission as it only scans the residency list once per idle epoch
+         * @note The texture manager **must** be locked prior to calling this
+         */
+        void EvictIdle();
     };
 }
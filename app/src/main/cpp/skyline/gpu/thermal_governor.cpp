@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <dlfcn.h>
+#include <common/settings.h>
+#include "thermal_governor.h"
+
+namespace skyline::gpu {
+    namespace {
+        /**
+         * @url https://developer.android.com/ndk/reference/group/thermal#athermalstatus
+         */
+        enum class ThermalStatus : int {
+            None = 0,
+            Light = 1,
+            Moderate = 2,
+            Severe = 3,
+        };
+
+        constexpr u32 MissedFramePercentage{10}; //!< The percentage of frames in an evaluation window that need to miss their deadline for the framerate to be considered unstable
+        constexpr u64 MissedFrameTolerance{10}; //!< The percentage by which a frame may exceed its deadline without being considered missed
+    }
+
+    ThermalGovernor::ThermalGovernor(Settings &settings)
+        : settings{settings},
+          baselineFlushThreshold{*settings.executorFlushThreshold},
+          appliedFlushThreshold{*settings.executorFlushThreshold},
+          baselineAsyncPipelineCreation{*settings.asyncPipelineCreation},
+          appliedAsyncPipelineCreation{*settings.asyncPipelineCreation} {
+        if (auto libandroid{dlopen("libandroid.so", RTLD_NOW)}) {
+            using AcquireManagerFunction = void *(*)();
+            auto acquireManager{reinterpret_cast<AcquireManagerFunction>(dlsym(libandroid, "AThermal_acquireManager"))};
+            getCurrentThermalStatus = reinterpret_cast<GetCurrentThermalStatusFunction>(dlsym(libandroid, "AThermal_getCurrentThermalStatus"));
+            if (acquireManager && getCurrentThermalStatus)
+                thermalManager = acquireManager();
+        }
+
+        if (!thermalManager)
+            Logger::Info("Thermal status isn't available on this device, only frame deadlines will be used for quality adjustments");
+    }
+
+    ThermalGovernor::~ThermalGovernor() {
+        if (thermalManager) {
+            using ReleaseManagerFunction = void (*)(void *manager);
+            if (auto releaseManager{reinterpret_cast<ReleaseManagerFunction>(dlsym(RTLD_DEFAULT, "AThermal_releaseManager"))})
+                releaseManager(thermalManager);
+        }
+    }
+
+    bool ThermalGovernor::UpdateBaseline() {
+        // Any value that differs from what we last wrote was written by the user
+        bool changed{};
+        if (u32 flushThreshold{*settings.executorFlushThreshold}; flushThreshold != appliedFlushThreshold) {
+            baselineFlushThreshold = flushThreshold;
+            changed = true;
+        }
+        if (bool asyncPipelineCreation{*settings.asyncPipelineCreation}; asyncPipelineCreation != appliedAsyncPipelineCreation) {
+            baselineAsyncPipelineCreation = asyncPipelineCreation;
+            changed = true;
+        }
+        return changed;
+    }
+
+    u32 ThermalGovernor::GetWarrantedPressureLevel() {
+        auto status{thermalManager ? static_cast<ThermalStatus>(getCurrentThermalStatus(thermalManager)) : ThermalStatus::None};
+        if (status >= ThermalStatus::Severe)
+            return MaxPressureLevel;
+
+        // Frames missing their deadline are only attributed to throttling if the device reports being under any thermal pressure, otherwise they're just the performance of the device
+        bool unstable{windowFrameCount && windowMissedFrameCount * 100 >= windowFrameCount * MissedFramePercentage};
+        if (status >= ThermalStatus::Moderate)
+            return unstable ? MaxPressureLevel : 1;
+        if (status >= ThermalStatus::Light && unstable)
+            return 1;
+
+        return 0;
+    }
+
+    void ThermalGovernor::ApplyPressureLevel() {
+        // Larger executions reduce the CPU overhead of submission at the cost of GPU latency
+        u32 flushThreshold{baselineFlushThreshold << pressureLevel};
+        appliedFlushThreshold = flushThreshold;
+        settings.executorFlushThreshold = flushThreshold;
+
+        // Draws with pipelines that aren't ready yet are skipped rather than stalling on their compilation
+        bool asyncPipelineCreation{baselineAsyncPipelineCreation || pressureLevel >= MaxPressureLevel};
+        appliedAsyncPipelineCreation = asyncPipelineCreation;
+        settings.asyncPipelineCreation = asyncPipelineCreation;
+    }
+
+    void ThermalGovernor::OnFrame(u64 timestamp, u64 frametimeNs, u64 targetFrametimeNs) {
+        if (!windowStart)
+            windowStart = timestamp;
+
+        if (frametimeNs && targetFrametimeNs) {
+            windowFrameCount++;
+            if (frametimeNs * 100 > targetFrametimeNs * (100 + MissedFrameTolerance))
+                windowMissedFrameCount++;
+        }
+
+        if (timestamp - windowStart < EvaluationInterval)
+            return;
+
+        u32 warrantedLevel{GetWarrantedPressureLevel()};
+        u32 previousLevel{pressureLevel};
+        if (warrantedLevel > pressureLevel) {
+            pressureLevel = warrantedLevel;
+            relaxStart = 0;
+        } else if (warrantedLevel < pressureLevel) {
+            if (!relaxStart) {
+                relaxStart = timestamp;
+            } else if (timestamp - relaxStart >= RelaxDelay) {
+                pressureLevel--; // We only drop a single level at a time, so the framerate can be re-evaluated at every level
+                relaxStart = 0;
+            }
+        } else {
+            relaxStart = 0;
+        }
+
+        if (pressureLevel != previousLevel)
+            Logger::Info("Thermal pressure level changed from {} to {}", previousLevel, pressureLevel);
+
+        if (UpdateBaseline() || pressureLevel != previousLevel)
+            ApplyPressureLevel();
+
+        windowStart = timestamp;
+        windowFrameCount = 0;
+        windowMissedFrameCount = 0;
+    }
+}
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::gpu {
+    /**
+     * @brief Trades quality for a stable framerate while the device is thermally throttled, it derives a pressure level from the Android thermal status and whether frames are meeting their deadline and adjusts settings accordingly
+     * @details The pressure level rises as soon as it's warranted but only drops after it's been unwarranted for a while, this avoids oscillating between levels as the device heats up and cools down under a steady load
+     * @note The AThermal API is only available on Android 11+ and is resolved at runtime, the thermal status is assumed to be nominal if it isn't available
+     * @note Settings changed by the user while the governor is active become the new baseline that the governor adjusts from
+     */
+    class ThermalGovernor {
+      private:
+        static constexpr u64 EvaluationInterval{constant::NsInSecond}; //!< The interval at which the pressure level is re-evaluated in nanoseconds
+        static constexpr u64 RelaxDelay{30 * constant::NsInSecond}; //!< The duration for which a lower pressure level must be warranted before the level is dropped in nanoseconds
+        static constexpr u32 MaxPressureLevel{2};
+
+        using GetCurrentThermalStatusFunction = int (*)(void *manager);
+
+        Settings &settings;
+        void *thermalManager{}; //!< The AThermalManager or null if the API isn't available
+        GetCurrentThermalStatusFunction getCurrentThermalStatus{};
+
+        u32 pressureLevel{}; //!< The level of quality reduction that's currently applied, 0 corresponds to the baseline settings
+        u64 windowStart{}; //!< The timestamp at which the current evaluation window started
+        u64 windowFrameCount{}; //!< The amount of frames presented in the current evaluation window
+        u64 windowMissedFrameCount{}; //!< The amount of frames in the current evaluation window which took longer than their deadline
+        u64 relaxStart{}; //!< The timestamp since which a lower pressure level has been warranted or 0 if it isn't
+
+        u32 baselineFlushThreshold; //!< The executor flush threshold that was configured by the user
+        u32 appliedFlushThreshold; //!< The executor flush threshold that was last written by the governor
+        bool baselineAsyncPipelineCreation; //!< If asynchronous pipeline creation was configured by the user
+        bool appliedAsyncPipelineCreation;
+
+        /**
+         * @brief Picks up any changes the user made to the settings since they were last applied as the new baseline
+         * @return If the baseline changed
+         */
+        bool UpdateBaseline();
+
+        /**
+         * @return The pressure level warranted by the current thermal status and the frames in the current evaluation window
+         */
+        u32 GetWarrantedPressureLevel();
+
+        /**
+         * @brief Writes the settings corresponding to the current pressure level
+         */
+        void ApplyPressureLevel();
+
+      public:
+        ThermalGovernor(Settings &settings);
+
+        ~ThermalGovernor();
+
+        ThermalGovernor(const ThermalGovernor &) = delete;
+
+        ThermalGovernor &operator=(const ThermalGovernor &) = delete;
+
+        /**
+         * @brief Accounts a presented frame and re-evaluates the pressure level if the evaluation interval has elapsed
+         * @param timestamp The time at which the frame was presented in nanoseconds
+         * @param frametimeNs The time between the presentation of the prior frame and this one
+         * @param targetFrametimeNs The frametime that the guest is targeting
+         * @note This must only be called by the presentation thread
+         */
+        void OnFrame(u64 timestamp, u64 frametimeNs, u64 targetFrametimeNs);
+    };
+}
@@ -6,7 +6,7 @@
 
 namespace skyline::gpu {
     TraitManager::TraitManager(const DeviceFeatures2 &deviceFeatures2, DeviceFeatures2 &enabledFeatures2, const std::vector<vk::ExtensionProperties> &deviceExtensions, std::vector<std::array<char, VK_MAX_EXTENSION_NAME_SIZE>> &enabledExtensions, const DeviceProperties2 &deviceProperties2, const vk::raii::PhysicalDevice &physicalDevice) : quirks(deviceProperties2.get<vk::PhysicalDeviceProperties2>().properties, deviceProperties2.get<vk::PhysicalDeviceDriverProperties>()) {
-        bool hasCustomBorderColorExt{}, hasShaderAtomicInt64Ext{}, hasShaderFloat16Int8Ext{}, hasShaderDemoteToHelperExt{}, hasVertexAttributeDivisorExt{}, hasProvokingVertexExt{}, hasPrimitiveTopologyListRestartExt{}, hasImagelessFramebuffersExt{}, hasTransformFeedbackExt{}, hasUint8IndicesExt{}, hasExtendedDynamicStateExt{}, hasRobustness2Ext{};
+        bool hasCustomBorderColorExt{}, hasShaderAtomicInt64Ext{}, hasShaderFloat16Int8Ext{}, hasShaderDemoteToHelperExt{}, hasVertexAttributeDivisorExt{}, hasProvokingVertexExt{}, hasPrimitiveTopologyListRestartExt{}, hasImagelessFramebuffersExt{}, hasTransformFeedbackExt{}, hasUint8IndicesExt{}, hasExtendedDynamicStateExt{}, hasExtendedDynamicState2Ext{}, hasPipelineLibraryExt{}, hasGraphicsPipelineLibraryExt{}, hasRobustness2Ext{}, hasTimelineSemaphoreExt{}, hasConditionalRenderingExt{}, hasQueueFamilyForeignExt{}, hasAndroidHardwareBufferExt{}, hasMultiDrawExt{};
         bool supportsUniformBufferStandardLayout{}; // We require VK_KHR_uniform_buffer_standard_layout but assume it is implicitly supported even when not present
 
         for (auto &extension : deviceExtensions) {
@@ -59,7 +59,18 @@ namespace skyline::gpu {
                 EXT_SET("VK_EXT_primitive_topology_list_restart", hasPrimitiveTopologyListRestartExt);
                 EXT_SET("VK_EXT_transform_feedback", hasTransformFeedbackExt);
                 EXT_SET("VK_EXT_extended_dynamic_state", hasExtendedDynamicStateExt);
+                EXT_SET("VK_EXT_extended_dynamic_state2", hasExtendedDynamicState2Ext);
+                EXT_SET("VK_KHR_pipeline_library", hasPipelineLibraryExt);
+                EXT_SET("VK_EXT_graphics_pipeline_library", hasGraphicsPipelineLibraryExt);
                 EXT_SET("VK_EXT_robustness2", hasRobustness2Ext);
+                EXT_SET("VK_EXT_memory_budget", supportsMemoryBudget);
+                EXT_SET("VK_KHR_timeline_semaphore", hasTimelineSemaphoreExt);
+                EXT_SET("VK_EXT_external_memory_host", supportsExternalMemoryHost);
+                EXT_SET("VK_EXT_conditional_rendering", hasConditionalRenderingExt);
+                EXT_SET("VK_EXT_queue_family_foreign", hasQueueFamilyForeignExt);
+                EXT_SET("VK_ANDROID_external_memory_android_hardware_buffer", hasAndroidHardwareBufferExt);
+                EXT_SET("VK_EXT_multi_draw", hasMultiDrawExt);
+                EXT_SET("VK_KHR_draw_indirect_count", supportsDrawIndirectCount);
             }
 
             #undef EXT_SET_COND
@@ -81,6 +92,8 @@ namespace skyline::gpu {
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderInt16, supportsInt16)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderInt64, supportsInt64)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderStorageImageReadWithoutFormat, supportsImageReadWithoutFormat)
+        FEAT_SET(vk::PhysicalDeviceFeatures2, features.occlusionQueryPrecise, supportsPreciseOcclusionQueries)
+        FEAT_SET(vk::PhysicalDeviceFeatures2, features.multiDrawIndirect, supportsMultiDrawIndirect)
 
         if (hasUint8IndicesExt)
             FEAT_SET(vk::PhysicalDeviceIndexTypeUint8FeaturesEXT, indexTypeUint8, supportsUint8Indices)
@@ -92,6 +105,16 @@ namespace skyline::gpu {
         else
             enabledFeatures2.unlink<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
 
+        if (hasExtendedDynamicState2Ext)
+            FEAT_SET(vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT, extendedDynamicState2, supportsExtendedDynamicState2)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT>();
+
+        if (hasGraphicsPipelineLibraryExt && hasPipelineLibraryExt)
+            FEAT_SET(vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT, graphicsPipelineLibrary, supportsGraphicsPipelineLibrary)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+
         if (hasRobustness2Ext) {
             FEAT_SET(vk::PhysicalDeviceRobustness2FeaturesEXT, nullDescriptor, supportsNullDescriptor)
             FEAT_SET(vk::PhysicalDeviceFeatures2, features.robustBufferAccess, std::ignore)
@@ -174,12 +197,34 @@ namespace skyline::gpu {
             enabledFeatures2.unlink<vk::PhysicalDeviceTransformFeedbackFeaturesEXT>();
         }
 
+        if (hasTimelineSemaphoreExt)
+            FEAT_SET(vk::PhysicalDeviceTimelineSemaphoreFeatures, timelineSemaphore, supportsTimelineSemaphores)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceTimelineSemaphoreFeatures>();
+
+        if (hasConditionalRenderingExt)
+            FEAT_SET(vk::PhysicalDeviceConditionalRenderingFeaturesEXT, conditionalRendering, supportsConditionalRendering)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceConditionalRenderingFeaturesEXT>();
+
+        if (hasAndroidHardwareBufferExt && hasQueueFamilyForeignExt)
+            // Decoded video frames are in implementation-defined YUV formats which can only be sampled through a YCbCr conversion
+            FEAT_SET(vk::PhysicalDeviceSamplerYcbcrConversionFeatures, samplerYcbcrConversion, supportsAndroidHardwareBufferImport)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceSamplerYcbcrConversionFeatures>();
+
+        if (hasMultiDrawExt)
+            FEAT_SET(vk::PhysicalDeviceMultiDrawFeaturesEXT, multiDraw, supportsMultiDraw)
+        else
+            enabledFeatures2.unlink<vk::PhysicalDeviceMultiDrawFeaturesEXT>();
+
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.geometryShader, supportsGeometryShaders)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.vertexPipelineStoresAndAtomics, supportsVertexPipelineStoresAndAtomics)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.fragmentStoresAndAtomics, supportsFragmentStoresAndAtomics)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.shaderStorageImageWriteWithoutFormat, supportsShaderStorageImageWriteWithoutFormat)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.wideLines, supportsWideLines)
         FEAT_SET(vk::PhysicalDeviceFeatures2, features.depthClamp, supportsDepthClamp)
+        FEAT_SET(vk::PhysicalDeviceFeatures2, features.textureCompressionASTC_LDR, supportsAstcLdr)
 
         #undef FEAT_SET
 
@@ -206,6 +251,30 @@ namespace skyline::gpu {
         bcnSupport[5] = isFormatSupported(vk::Format::eBc6HSfloatBlock) && isFormatSupported(vk::Format::eBc6HUfloatBlock);
         bcnSupport[6] = isFormatSupported(vk::Format::eBc7UnormBlock) && isFormatSupported(vk::Format::eBc7SrgbBlock);
 
+        // Notably, Mali GPUs don't support any packed 24-bit depth formats, all guest textures in those formats are emulated with their 32-bit floating point equivalents
+        auto isDepthStencilFormatSupported{[&physicalDevice](vk::Format format) {
+            return static_cast<bool>(physicalDevice.getFormatProperties(format).optimalTilingFeatures & vk::FormatFeatureFlagBits::eDepthStencilAttachment);
+        }};
+
+        supportsD24UnormS8Uint = isDepthStencilFormatSupported(vk::Format::eD24UnormS8Uint);
+        supportsX8D24UnormPack32 = isDepthStencilFormatSupported(vk::Format::eX8D24UnormPack32);
+
+        if (supportsAstcLdr) {
+            // The feature guarantees support for all LDR formats but certain drivers don't support sampling every block size in practice, so each one is checked individually
+            auto isAstcFormatSupported{[&physicalDevice](vk::Format format) {
+                return static_cast<bool>(physicalDevice.getFormatProperties(format).optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage);
+            }};
+
+            astcSupport[0] = isAstcFormatSupported(vk::Format::eAstc4x4UnormBlock) && isAstcFormatSupported(vk::Format::eAstc4x4SrgbBlock);
+            astcSupport[1] = isAstcFormatSupported(vk::Format::eAstc5x5UnormBlock) && isAstcFormatSupported(vk::Format::eAstc5x5SrgbBlock);
+            astcSupport[2] = isAstcFormatSupported(vk::Format::eAstc6x6UnormBlock) && isAstcFormatSupported(vk::Format::eAstc6x6SrgbBlock);
+            astcSupport[3] = isAstcFormatSupported(vk::Format::eAstc8x6UnormBlock) && isAstcFormatSupported(vk::Format::eAstc8x6SrgbBlock);
+            astcSupport[4] = isAstcFormatSupported(vk::Format::eAstc8x8UnormBlock) && isAstcFormatSupported(vk::Format::eAstc8x8SrgbBlock);
+            astcSupport[5] = isAstcFormatSupported(vk::Format::eAstc10x8UnormBlock) && isAstcFormatSupported(vk::Format::eAstc10x8SrgbBlock);
+            astcSupport[6] = isAstcFormatSupported(vk::Format::eAstc10x10UnormBlock) && isAstcFormatSupported(vk::Format::eAstc10x10SrgbBlock);
+            astcSupport[7] = isAstcFormatSupported(vk::Format::eAstc12x12UnormBlock) && isAstcFormatSupported(vk::Format::eAstc12x12SrgbBlock);
+        }
+
         auto memoryProps{physicalDevice.getMemoryProperties2()};
         constexpr auto ReqMemFlags{vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostCached};
         for (u32 i{}; i < memoryProps.memoryProperties.memoryTypeCount; i++)
@@ -214,6 +283,20 @@ namespace skyline::gpu {
 
 
         minimumStorageBufferAlignment = static_cast<u32>(deviceProperties2.get().properties.limits.minStorageBufferOffsetAlignment);
+        timestampPeriod = deviceProperties2.get().properties.limits.timestampPeriod;
+
+        if (supportsPushDescriptors)
+            maxPushDescriptors = deviceProperties2.get<vk::PhysicalDevicePushDescriptorPropertiesKHR>().maxPushDescriptors;
+
+        if (supportsExternalMemoryHost)
+            minImportedHostPointerAlignment = deviceProperties2.get<vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>().minImportedHostPointerAlignment;
+
+        // Linking libraries is only worthwhile if it's fast enough to be done on first use of a pipeline
+        if (supportsGraphicsPipelineLibrary)
+            supportsGraphicsPipelineLibrary = deviceProperties2.get<vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>().graphicsPipelineLibraryFastLinking;
+
+        if (supportsMultiDraw)
+            maxMultiDrawCount = deviceProperties2.get<vk::PhysicalDeviceMultiDrawPropertiesEXT>().maxMultiDrawCount;
 
         vendorId = deviceProperties2.get().properties.vendorID;
         deviceId = deviceProperties2.get().properties.deviceID;
@@ -223,8 +306,8 @@ namespace skyline::gpu {
 
     std::string TraitManager::Summary() {
         return fmt::format(
-            "\n* Supports U8 Indices: {}\n* Supports Sampler Mirror Clamp To Edge: {}\n* Supports Sampler Reduction Mode: {}\n* Supports Custom Border Color (Without Format): {}\n* Supports Anisotropic Filtering: {}\n* Supports Last Provoking Vertex: {}\n* Supports Logical Operations: {}\n* Supports Vertex Attribute Divisor: {}\n* Supports Vertex Attribute Zero Divisor: {}\n* Supports Push Descriptors: {}\n* Supports Imageless Framebuffers: {}\n* Supports Global Priority: {}\n* Supports Multiple Viewports: {}\n* Supports Shader Viewport Index: {}\n* Supports SPIR-V 1.4: {}\n* Supports Shader Invocation Demotion: {}\n* Supports 16-bit FP: {}\n* Supports 8-bit Integers: {}\n* Supports 16-bit Integers: {}\n* Supports 64-bit Integers: {}\n* Supports Atomic 64-bit Integers: {}\n* Supports Floating Point Behavior Control: {}\n* Supports Image Read Without Format: {}\n* Supports List Primitive Topology Restart: {}\n* Supports Patch List Primitive Topology Restart: {}\n* Supports Transform Feedback: {}\n* Supports Geometry Shaders: {}\n*  Supports Vertex Pipeline Stores and Atomics: {}\n* Supports Fragment Stores and Atomics: {}\n* Supports Shader Storage Image Write Without Format: {}\n*Supports Subgroup Vote: {}\n* Subgroup Size: {}\n* BCn Support: {}",
-            supportsUint8Indices, supportsSamplerMirrorClampToEdge, supportsSamplerReductionMode, supportsCustomBorderColor, supportsAnisotropicFiltering, supportsLastProvokingVertex, supportsLogicOp, supportsVertexAttributeDivisor, supportsVertexAttributeZeroDivisor, supportsPushDescriptors, supportsImagelessFramebuffers, supportsGlobalPriority, supportsMultipleViewports, supportsShaderViewportIndexLayer, supportsSpirv14, supportsShaderDemoteToHelper, supportsFloat16, supportsInt8, supportsInt16, supportsInt64, supportsAtomicInt64, supportsFloatControls, supportsImageReadWithoutFormat, supportsTopologyListRestart, supportsTopologyPatchListRestart, supportsTransformFeedback, supportsGeometryShaders, supportsVertexPipelineStoresAndAtomics, supportsFragmentStoresAndAtomics, supportsShaderStorageImageWriteWithoutFormat, supportsSubgroupVote, subgroupSize, bcnSupport.to_string()
+            "\n* Supports U8 Indices: {}\n* Supports Sampler Mirror Clamp To Edge: {}\n* Supports Sampler Reduction Mode: {}\n* Supports Custom Border Color (Without Format): {}\n* Supports Anisotropic Filtering: {}\n* Supports Last Provoking Vertex: {}\n* Supports Logical Operations: {}\n* Supports Vertex Attribute Divisor: {}\n* Supports Vertex Attribute Zero Divisor: {}\n* Supports Push Descriptors: {}\n* Supports Imageless Framebuffers: {}\n* Supports Global Priority: {}\n* Supports Multiple Viewports: {}\n* Supports Shader Viewport Index: {}\n* Supports SPIR-V 1.4: {}\n* Supports Shader Invocation Demotion: {}\n* Supports 16-bit FP: {}\n* Supports 8-bit Integers: {}\n* Supports 16-bit Integers: {}\n* Supports 64-bit Integers: {}\n* Supports Atomic 64-bit Integers: {}\n* Supports Floating Point Behavior Control: {}\n* Supports Image Read Without Format: {}\n* Supports List Primitive Topology Restart: {}\n* Supports Patch List Primitive Topology Restart: {}\n* Supports Transform Feedback: {}\n* Supports Geometry Shaders: {}\n*  Supports Vertex Pipeline Stores and Atomics: {}\n* Supports Fragment Stores and Atomics: {}\n* Supports Shader Storage Image Write Without Format: {}\n*Supports Subgroup Vote: {}\n* Supports Memory Budget: {}\n* Supports Timeline Semaphores: {}\n* Supports Extended Dynamic State: {}\n* Supports Extended Dynamic State 2: {}\n* Supports Graphics Pipeline Library: {}\n* Supports External Host Memory: {}\n* Supports Conditional Rendering: {}\n* Supports Precise Occlusion Queries: {}\n* Supports AHardwareBuffer Import: {}\n* Supports Multi-Draw: {}\n* Supports Multi-Draw Indirect: {}\n* Supports Draw Indirect Count: {}\n* Subgroup Size: {}\n* BCn Support: {}\n* ASTC LDR Support: {}\n* Supports D24S8: {}\n* Supports X8D24: {}",
+            supportsUint8Indices, supportsSamplerMirrorClampToEdge, supportsSamplerReductionMode, supportsCustomBorderColor, supportsAnisotropicFiltering, supportsLastProvokingVertex, supportsLogicOp, supportsVertexAttributeDivisor, supportsVertexAttributeZeroDivisor, supportsPushDescriptors, supportsImagelessFramebuffers, supportsGlobalPriority, supportsMultipleViewports, supportsShaderViewportIndexLayer, supportsSpirv14, supportsShaderDemoteToHelper, supportsFloat16, supportsInt8, supportsInt16, supportsInt64, supportsAtomicInt64, supportsFloatControls, supportsImageReadWithoutFormat, supportsTopologyListRestart, supportsTopologyPatchListRestart, supportsTransformFeedback, supportsGeometryShaders, supportsVertexPipelineStoresAndAtomics, supportsFragmentStoresAndAtomics, supportsShaderStorageImageWriteWithoutFormat, supportsSubgroupVote, supportsMemoryBudget, supportsTimelineSemaphores, supportsExtendedDynamicState, supportsExtendedDynamicState2, supportsGraphicsPipelineLibrary, supportsExternalMemoryHost, supportsConditionalRendering, supportsPreciseOcclusionQueries, supportsAndroidHardwareBufferImport, supportsMultiDraw, supportsMultiDrawIndirect, supportsDrawIndirectCount, subgroupSize, bcnSupport.to_string(), astcSupport.to_string(), supportsD24UnormS8Uint, supportsX8D24UnormPack32
         );
     }
 
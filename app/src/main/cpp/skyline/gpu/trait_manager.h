@@ -23,6 +23,7 @@ namespace skyline::gpu {
         bool supportsVertexAttributeDivisor{}; //!< If the device supports a divisor for instance-rate vertex attributes (with VK_EXT_vertex_attribute_divisor)
         bool supportsVertexAttributeZeroDivisor{}; //!< If the device supports a zero divisor for instance-rate vertex attributes (with VK_EXT_vertex_attribute_divisor)
         bool supportsPushDescriptors{}; //!< If the device supports push descriptors (with VK_KHR_push_descriptor)
+        u32 maxPushDescriptors{}; //!< The maximum amount of descriptors in a push descriptor set layout
         bool supportsImageFormatList{}; //!< If the device supports providing a list of formats that can be used with an image (with VK_KHR_image_format_list)
         bool supportsImagelessFramebuffers{}; //!< If the device supports imageless framebuffers (with VK_KHR_imageless_framebuffer)
         bool supportsGlobalPriority{}; //!< If the device supports global priorities for queues (with VK_EXT_global_priority)
@@ -49,10 +50,24 @@ namespace skyline::gpu {
         bool supportsWideLines{}; //!< If the device supports the 'wideLines' Vulkan feature
         bool supportsDepthClamp{}; //!< If the device supports the 'depthClamp' Vulkan feature
         bool supportsExtendedDynamicState{}; //!< If the device supports the 'VK_EXT_extended_dynamic_state' Vulkan extension
+        bool supportsExtendedDynamicState2{}; //!< If the device supports the 'VK_EXT_extended_dynamic_state2' Vulkan extension
+        bool supportsGraphicsPipelineLibrary{}; //!< If the device supports the 'VK_EXT_graphics_pipeline_library' Vulkan extension with fast linking of libraries
         bool supportsNullDescriptor{}; //!< If the device supports the null descriptor feature in the 'VK_EXT_robustness2' Vulkan extension
+        bool supportsMemoryBudget{}; //!< If the device supports querying the budget of memory heaps (with VK_EXT_memory_budget)
+        bool supportsTimelineSemaphores{}; //!< If the device supports timeline semaphores (with VK_KHR_timeline_semaphore)
+        bool supportsConditionalRendering{}; //!< If the device supports predicating draws on a value in a buffer (with VK_EXT_conditional_rendering)
+        bool supportsPreciseOcclusionQueries{}; //!< If the device supports the 'occlusionQueryPrecise' Vulkan feature
+        bool supportsMultiDraw{}; //!< If the device supports recording multiple draws with a single command (with VK_EXT_multi_draw)
+        u32 maxMultiDrawCount{}; //!< The maximum amount of draws in a single multi-draw command, this is zero if multi-draw isn't supported
+        bool supportsMultiDrawIndirect{}; //!< If the device supports the 'multiDrawIndirect' Vulkan feature
+        bool supportsDrawIndirectCount{}; //!< If the device supports sourcing the draw count of an indirect draw from a buffer (with VK_KHR_draw_indirect_count)
+        bool supportsAstcLdr{}; //!< If the device supports the 'textureCompressionASTC_LDR' Vulkan feature
+        bool supportsAndroidHardwareBufferImport{}; //!< If the device supports sampling from imported AHardwareBuffers with implementation-defined formats (with VK_ANDROID_external_memory_android_hardware_buffer and 'samplerYcbcrConversion')
         u32 subgroupSize{}; //!< Size of a subgroup on the host GPU
         u32 hostVisibleCoherentCachedMemoryType{std::numeric_limits<u32>::max()};
         u32 minimumStorageBufferAlignment{}; //!< Minimum alignment for storage buffers passed to shaders
+        u32 timestampValidBits{}; //!< The amount of valid bits in timestamps written on the queue family used for emulation, timestamps aren't supported if this is zero
+        float timestampPeriod{}; //!< The amount of nanoseconds it takes for a timestamp to be incremented by one
 
         u32 vendorId{}; //!< The `vendorID` Vulkan property
         u32 deviceId{}; //!< The `deviceID` Vulkan property
@@ -60,7 +75,12 @@ namespace skyline::gpu {
         std::array<u8, VK_UUID_SIZE> pipelineCacheUuid{}; //!< The `pipelineCacheUUID` Vulkan property
 
         std::bitset<7> bcnSupport{}; //!< Bitmask of BCn texture formats supported, it is ordered as BC1, BC2, BC3, BC4, BC5, BC6H and BC7
+        std::bitset<8> astcSupport{}; //!< Bitmask of ASTC LDR texture block sizes supported in both UNORM and SRGB variants, it is ordered as 4x4, 5x5, 6x6, 8x6, 8x8, 10x8, 10x10 and 12x12
+        bool supportsD24UnormS8Uint{}; //!< If the device supports D24_UNORM_S8_UINT depth/stencil attachments, it's emulated with D32_SFLOAT_S8_UINT otherwise
+        bool supportsX8D24UnormPack32{}; //!< If the device supports X8_D24_UNORM_PACK32 depth attachments, it's emulated with D32_SFLOAT otherwise
         bool supportsAdrenoDirectMemoryImport{};
+        bool supportsExternalMemoryHost{}; //!< If the device supports importing host memory as device memory (with VK_EXT_external_memory_host), this is used for direct memory import when the adrenotools import patch isn't available
+        vk::DeviceSize minImportedHostPointerAlignment{}; //!< The alignment that both the address and size of imported host memory must have
 
         /**
          * @brief Manages a list of any vendor/device-specific errata in the host GPU
@@ -99,7 +119,11 @@ namespace skyline::gpu {
             vk::PhysicalDeviceDriverProperties,
             vk::PhysicalDeviceFloatControlsProperties,
             vk::PhysicalDeviceTransformFeedbackPropertiesEXT,
-            vk::PhysicalDeviceSubgroupProperties>;
+            vk::PhysicalDeviceSubgroupProperties,
+            vk::PhysicalDeviceExternalMemoryHostPropertiesEXT,
+            vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT,
+            vk::PhysicalDevicePushDescriptorPropertiesKHR,
+            vk::PhysicalDeviceMultiDrawPropertiesEXT>;
 
         using DeviceFeatures2 = vk::StructureChain<
             vk::PhysicalDeviceFeatures2,
@@ -116,7 +140,13 @@ namespace skyline::gpu {
             vk::PhysicalDeviceTransformFeedbackFeaturesEXT,
             vk::PhysicalDeviceIndexTypeUint8FeaturesEXT,
             vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT,
-            vk::PhysicalDeviceRobustness2FeaturesEXT>;
+            vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT,
+            vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT,
+            vk::PhysicalDeviceRobustness2FeaturesEXT,
+            vk::PhysicalDeviceTimelineSemaphoreFeatures,
+            vk::PhysicalDeviceConditionalRenderingFeaturesEXT,
+            vk::PhysicalDeviceSamplerYcbcrConversionFeatures,
+            vk::PhysicalDeviceMultiDrawFeaturesEXT>;
 
         TraitManager(const DeviceFeatures2 &deviceFeatures2, DeviceFeatures2 &enabledFeatures2, const std::vector<vk::ExtensionProperties> &deviceExtensions, std::vector<std::array<char, VK_MAX_EXTENSION_NAME_SIZE>> &enabledExtensions, const DeviceProperties2 &deviceProperties2, const vk::raii::PhysicalDevice &physicalDevice);
 
@@ -125,6 +155,13 @@ namespace skyline::gpu {
          */
         void ApplyDriverPatches(const vk::raii::Context &context, adrenotools_gpu_mapping *mapping);
 
+        /**
+         * @return If guest memory can be imported directly as the backing of buffers, either with the adrenotools import patch or VK_EXT_external_memory_host
+         */
+        bool SupportsDirectMemoryImport() const {
+            return supportsAdrenoDirectMemoryImport || supportsExternalMemoryHost;
+        }
+
         /**
          * @return A summary of all the GPU traits as a human-readable string
          */
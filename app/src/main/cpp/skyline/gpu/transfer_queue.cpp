@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <gpu.h>
+#include "transfer_queue.h"
+
+namespace skyline::gpu {
+    static vk::raii::Semaphore CreateTimelineSemaphore(const vk::raii::Device &device) {
+        vk::StructureChain<vk::SemaphoreCreateInfo, vk::SemaphoreTypeCreateInfo> semaphoreCreateInfo{
+            vk::SemaphoreCreateInfo{},
+            vk::SemaphoreTypeCreateInfo{
+                .semaphoreType = vk::SemaphoreType::eTimeline,
+                .initialValue = 0,
+            }
+        };
+        return vk::raii::Semaphore{device, semaphoreCreateInfo.get<vk::SemaphoreCreateInfo>()};
+    }
+
+    TransferQueue::TransferQueue(GPU &gpu, u32 familyIndex)
+        : gpu{gpu},
+          queue{gpu.vkDevice, familyIndex, 0},
+          commandPool{gpu.vkDevice, vk::CommandPoolCreateInfo{
+              .flags = vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+              .queueFamilyIndex = familyIndex,
+          }},
+          semaphore{CreateTimelineSemaphore(gpu.vkDevice)},
+          familyIndex{familyIndex} {}
+
+    vk::raii::CommandBuffer TransferQueue::AcquireCommandBuffer() {
+        if (!submissions.empty() && submissions.front().value <= semaphore.getCounterValue()) {
+            auto commandBuffer{std::move(submissions.front().commandBuffer)};
+            submissions.pop_front();
+            commandBuffer.reset();
+            return commandBuffer;
+        }
+
+        return std::move(vk::raii::CommandBuffers{gpu.vkDevice, vk::CommandBufferAllocateInfo{
+            .commandPool = *commandPool,
+            .level = vk::CommandBufferLevel::ePrimary,
+            .commandBufferCount = 1,
+        }}.front());
+    }
+
+    u64 TransferQueue::SubmitCommandBuffer(vk::raii::CommandBuffer &&commandBuffer) {
+        u64 value{++lastValue};
+        vk::StructureChain<vk::SubmitInfo, vk::TimelineSemaphoreSubmitInfo> submitInfo{
+            vk::SubmitInfo{
+                .commandBufferCount = 1,
+                .pCommandBuffers = &*commandBuffer,
+                .signalSemaphoreCount = 1,
+                .pSignalSemaphores = &*semaphore,
+            },
+            vk::TimelineSemaphoreSubmitInfo{
+                .signalSemaphoreValueCount = 1,
+                .pSignalSemaphoreValues = &value,
+            }
+        };
+        queue.submit(submitInfo.get<vk::SubmitInfo>());
+
+        submissions.push_back(Submission{std::move(commandBuffer), value});
+        return value;
+    }
+}
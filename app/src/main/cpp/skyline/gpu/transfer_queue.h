@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <deque>
+#include <vulkan/vulkan_raii.hpp>
+#include <common.h>
+
+namespace skyline::gpu {
+    class GPU;
+
+    /**
+     * @brief Submits work to a dedicated transfer queue asynchronously from the graphics queue, completion of submissions is tracked with a timeline semaphore
+     * @note Any resources used by a submission must be kept alive by the graphics queue submission that waits on its completion
+     */
+    class TransferQueue {
+      private:
+        /**
+         * @brief A command buffer that was submitted to the queue alongside the timeline value that'll be signalled on its completion
+         */
+        struct Submission {
+            vk::raii::CommandBuffer commandBuffer;
+            u64 value; //!< The value of the timeline semaphore that is signalled once the command buffer has completed execution
+        };
+
+        GPU &gpu;
+        std::mutex mutex; //!< Synchronizes access to the queue, the command pool and all submissions as they're externally synchronized
+        vk::raii::Queue queue;
+        vk::raii::CommandPool commandPool;
+        vk::raii::Semaphore semaphore; //!< A timeline semaphore that is signalled with the value of every submission on its completion
+        u64 lastValue{}; //!< The timeline value of the last submission
+        std::deque<Submission> submissions; //!< All submissions in the order they were submitted in, the command buffers of completed submissions are reused
+
+        /**
+         * @return A command buffer that is ready to be recorded into, this is either a command buffer from a completed submission or a newly allocated one
+         * @note The mutex must be locked when calling this
+         */
+        vk::raii::CommandBuffer AcquireCommandBuffer();
+
+        /**
+         * @brief Submits the command buffer to the queue with a timeline semaphore signal
+         * @return The value of the timeline semaphore that'll be signalled on completion
+         * @note The mutex must be locked when calling this
+         */
+        u64 SubmitCommandBuffer(vk::raii::CommandBuffer &&commandBuffer);
+
+      public:
+        const u32 familyIndex; //!< The index of the queue family the queue is from
+
+        TransferQueue(GPU &gpu, u32 familyIndex);
+
+        /**
+         * @return The timeline semaphore which is signalled with the value of every submission once it's completed
+         */
+        vk::Semaphore GetSemaphore() {
+            return *semaphore;
+        }
+
+        /**
+         * @brief Records a command buffer using the supplied function and submits it to the transfer queue
+         * @return The value of the timeline semaphore that'll be signalled once the commands have completed execution
+         */
+        template<typename RecordFunction>
+        u64 Submit(RecordFunction recordFunction) {
+            std::scoped_lock lock{mutex};
+            auto commandBuffer{AcquireCommandBuffer()};
+            commandBuffer.begin(vk::CommandBufferBeginInfo{
+                .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+            });
+            recordFunction(commandBuffer);
+            commandBuffer.end();
+            return SubmitCommandBuffer(std::move(commandBuffer));
+        }
+    };
+}
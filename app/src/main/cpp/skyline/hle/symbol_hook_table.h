@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <common/settings.h>
+#include <nce/guest.h>
 #include "symbol_hooks.h"
 
 namespace skyline::hle {
@@ -14,4 +16,19 @@ namespace skyline::hle {
     };
 
     static std::array<HookTableEntry, 0> HookedSymbols{};
+
+    /**
+     * @brief Overrides for SDK wrappers around service commands which are polled frequently and whose responses are derived entirely from emulator state, these write the result directly without going through the SVC and IPC round trip
+     * @note These are only applied when the 'hleServiceFastPath' setting is enabled as they bypass any service-side state
+     */
+    static std::array<HookTableEntry, 2> ServiceFastPathSymbols{
+        // nn::oe::GetOperationMode() -> am::ICommonStateGetter::GetOperationMode
+        HookTableEntry{"_ZN2nn2oe16GetOperationModeEv", OverrideHook{[](const DeviceState &state, const HookedSymbol &) {
+            state.ctx->gpr.w0 = *state.settings->isDocked ? 1U : 0U; // OperationMode_Console : OperationMode_Handheld
+        }}},
+        // nn::oe::GetPerformanceMode() -> am::ICommonStateGetter::GetPerformanceMode
+        HookTableEntry{"_ZN2nn2oe18GetPerformanceModeEv", OverrideHook{[](const DeviceState &state, const HookedSymbol &) {
+            state.ctx->gpr.w0 = *state.settings->isDocked ? 1U : 0U; // PerformanceMode_Boost : PerformanceMode_Normal
+        }}},
+    };
 }
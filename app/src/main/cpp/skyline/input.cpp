@@ -15,6 +15,49 @@ namespace skyline::input {
           touch{state, hid},
           updateThread{&Input::UpdateThread, this} {}
 
+    void Input::QueueButtonState(size_t controllerIndex, NpadButton mask, bool pressed) {
+        events.Append(Event{ButtonEvent{controllerIndex, mask, pressed}});
+    }
+
+    void Input::QueueAxisValue(size_t controllerIndex, NpadAxisId axis, i32 value) {
+        events.Append(Event{AxisEvent{controllerIndex, axis, value}});
+    }
+
+    void Input::QueueMotionValue(size_t controllerIndex, MotionId sensor, const MotionSensorState &value) {
+        events.Append(Event{MotionEvent{controllerIndex, sensor, value}});
+    }
+
+    void Input::QueueTouchState(span<TouchScreenPoint> points) {
+        TouchEvent event{.pointCount = std::min(points.size(), TouchEvent{}.points.size())};
+        std::copy_n(points.begin(), event.pointCount, event.points.begin());
+        events.Append(Event{event});
+    }
+
+    void Input::ApplyEvents() {
+        // The NPad mutex is only locked once for all events rather than for each one, it guards the controller to device mappings
+        std::scoped_lock lock{npad.mutex};
+        events.Drain([&](Event &event) {
+            std::visit(VariantVisitor{
+                [&](ButtonEvent &button) {
+                    if (auto device{npad.controllers[button.controllerIndex].device})
+                        device->SetButtonState(button.mask, button.pressed);
+                },
+                [&](AxisEvent &axis) {
+                    if (auto device{npad.controllers[axis.controllerIndex].device})
+                        device->SetAxisValue(axis.axis, axis.value);
+                },
+                [&](MotionEvent &motion) {
+                    // Every motion event is applied as the rotation is integrated from all of them, but only the latest state is written on the next update
+                    if (auto device{npad.controllers[motion.controllerIndex].device})
+                        device->SetMotionValue(motion.sensor, &motion.value);
+                },
+                [&](TouchEvent &touchEvent) {
+                    touch.SetState(span(touchEvent.points).first(touchEvent.pointCount));
+                },
+            }, event);
+        });
+    }
+
     void Input::UpdateThread() {
         if (int result{pthread_setname_np(pthread_self(), "Sky-Input")})
             Logger::Warn("Failed to set the thread name: {}", strerror(result));
@@ -50,6 +93,8 @@ namespace skyline::input {
             };
 
             while (true) {
+                ApplyEvents();
+
                 auto now{std::chrono::steady_clock::now()}, next{updateCallbacks[0].next};
                 for (auto &callback : updateCallbacks) {
                     if (now >= callback.next)
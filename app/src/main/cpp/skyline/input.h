@@ -4,6 +4,7 @@
 #pragma once
 
 #include "common.h"
+#include "common/atomic_forward_list.h"
 #include "kernel/types/KSharedMemory.h"
 #include "input/shared_mem.h"
 #include "input/npad.h"
@@ -17,6 +18,32 @@ namespace skyline::input {
       private:
         const DeviceState &state;
 
+        struct ButtonEvent {
+            size_t controllerIndex;
+            NpadButton mask;
+            bool pressed;
+        };
+
+        struct AxisEvent {
+            size_t controllerIndex;
+            NpadAxisId axis;
+            i32 value;
+        };
+
+        struct MotionEvent {
+            size_t controllerIndex;
+            MotionId sensor;
+            MotionSensorState value;
+        };
+
+        struct TouchEvent {
+            std::array<TouchScreenPoint, std::tuple_size_v<decltype(TouchScreenState::data)>> points; //!< Points past the maximum amount on the touch screen are dropped
+            size_t pointCount;
+        };
+
+        using Event = std::variant<ButtonEvent, AxisEvent, MotionEvent, TouchEvent>;
+        AtomicForwardList<Event> events; //!< Host input events which haven't been applied yet, these are queued lock-free from any thread and applied by the update thread once per period so sensor-rate input never contends with it
+
       public:
         std::shared_ptr<kernel::type::KSharedMemory> kHid; //!< The kernel shared memory object for HID Shared Memory
         HidSharedMemory *hid; //!< A pointer to HID Shared Memory on the host
@@ -26,9 +53,27 @@ namespace skyline::input {
 
         Input(const DeviceState &state);
 
+        /**
+         * @brief Queues a change in the state of the buttons of a guest controller
+         * @note The following functions can be called from any thread, the events are applied in the order they were queued in prior to the next shared memory update
+         */
+        void QueueButtonState(size_t controllerIndex, NpadButton mask, bool pressed);
+
+        void QueueAxisValue(size_t controllerIndex, NpadAxisId axis, i32 value);
+
+        void QueueMotionValue(size_t controllerIndex, MotionId sensor, const MotionSensorState &value);
+
+        void QueueTouchState(span<TouchScreenPoint> points);
+
       private:
         std::thread updateThread; //!< A thread that handles delivering HID shared memory updates at a fixed rate
 
+        /**
+         * @brief Applies all queued events to the shared memory managers
+         * @note This must only be called from the update thread
+         */
+        void ApplyEvents();
+
         /**
          * @brief The entry point for the update thread, this handles timing and delegation to the shared memory managers
          */
@@ -182,6 +182,12 @@ namespace skyline {
          */
         i32 GetVersionCode();
 
+        /**
+         * @brief A call to EmulationActivity.updatePipelineCacheProgress in Kotlin
+         * @note This can be called from any thread
+         */
+        void UpdatePipelineCacheProgress(jint progress, jint total);
+
       private:
         jmethodID initializeControllersId;
         jmethodID vibrateDeviceId;
@@ -191,6 +197,7 @@ namespace skyline {
         jmethodID closeKeyboardId;
         jmethodID showValidationResultId;
         jmethodID getVersionCodeId;
+        jmethodID updatePipelineCacheProgressId;
 
         jmethodID getIntegerValueId;
     };
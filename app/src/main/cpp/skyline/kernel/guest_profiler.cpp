@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <cxxabi.h>
+#include <filesystem>
+#include <fstream>
+#include <nce/guest.h>
+#include <loader/loader.h>
+#include <os.h>
+#include "types/KProcess.h"
+#include "guest_profiler.h"
+
+namespace skyline::kernel {
+    GuestProfiler::GuestProfiler(const DeviceState &state) : state{state}, thread{&GuestProfiler::Run, this} {}
+
+    GuestProfiler::~GuestProfiler() {
+        {
+            std::scoped_lock lock{mutex};
+            stopped = true;
+        }
+        stopCondition.notify_all();
+        if (thread.joinable())
+            thread.join();
+    }
+
+    void GuestProfiler::SignalHandler(int, siginfo *, ucontext *ctx, void **tls) {
+        if (*tls) {
+            const auto &state{*reinterpret_cast<nce::ThreadContext *>(*tls)->state};
+            if (auto &ring{state.thread->profilerSamples}) {
+                Sample sample{ctx->uc_mcontext.pc, ctx->uc_mcontext.regs[30]};
+                ring->Write(span<const Sample>{&sample, 1});
+            }
+        } else {
+            hostSamples.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void GuestProfiler::Run() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-Profiler")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        std::unique_lock lock{mutex};
+        while (!stopCondition.wait_for(lock, SampleInterval, [this] { return stopped; })) {
+            lock.unlock();
+            for (const auto &scheduledThread : state.scheduler->GetScheduledThreads())
+                scheduledThread->TrySendSignal(SampleSignal);
+            lock.lock();
+
+            Drain();
+        }
+    }
+
+    void GuestProfiler::Drain() {
+        auto &process{state.process};
+        if (!process)
+            return;
+
+        std::vector<std::shared_ptr<type::KThread>> threads;
+        {
+            std::scoped_lock lock{process->threadMutex};
+            threads = process->threads;
+        }
+
+        for (const auto &processThread : threads) {
+            if (!processThread || !processThread->profilerSamples)
+                continue;
+
+            auto &ring{*processThread->profilerSamples};
+            ring.Read(ring.Size(), [this](span<const Sample> samples, size_t) {
+                for (const auto &sample : samples)
+                    histogram[{sample.pc, sample.lr}]++;
+            });
+        }
+    }
+
+    std::string GuestProfiler::Dump() {
+        std::map<std::pair<u64, u64>, u64> samples;
+        {
+            std::scoped_lock lock{mutex};
+            Drain();
+            samples = histogram;
+        }
+
+        std::unordered_map<u64, std::string> symbols; //!< A cache of the symbolized names of addresses as many samples share the same ones
+        auto symbolize{[&](u64 address) -> const std::string & {
+            auto it{symbols.find(address)};
+            if (it != symbols.end())
+                return it->second;
+
+            std::string name;
+            auto symbol{state.loader ? state.loader->ResolveSymbol(reinterpret_cast<void *>(address)) : loader::Loader::SymbolInfo{}};
+            if (symbol.name) {
+                int status{};
+                std::unique_ptr<char, decltype(&std::free)> demangled{abi::__cxa_demangle(symbol.name, nullptr, nullptr, &status), std::free};
+                name = (status == 0) ? demangled.get() : symbol.name;
+            } else if (!symbol.executableName.empty()) {
+                name = fmt::format("[{}]", symbol.executableName); // Addresses without a symbol are attributed to their executable as a whole
+            } else {
+                name = "[unknown]";
+            }
+            std::replace(name.begin(), name.end(), ';', ':'); // Semicolons delimit frames in the collapsed stack format
+            return symbols.emplace(address, std::move(name)).first->second;
+        }};
+
+        // Samples of different addresses in the same functions are merged as flame graphs are per-function
+        std::map<std::string, u64> stacks;
+        for (const auto &[context, count] : samples) {
+            const auto &callee{symbolize(context.first)};
+            const auto &caller{symbolize(context.second - sizeof(u32))}; // The LR points to the instruction after the call, we want the call itself
+            if (context.second && caller != callee)
+                stacks[fmt::format("{};{}", caller, callee)] += count;
+            else
+                stacks[callee] += count;
+        }
+
+        std::string output;
+        for (const auto &[stack, count] : stacks)
+            output += fmt::format("{} {}\n", stack, count);
+        if (auto count{hostSamples.load(std::memory_order_relaxed)})
+            output += fmt::format("[host] {}\n", count);
+        return output;
+    }
+
+    void GuestProfiler::Stop() {
+        {
+            std::scoped_lock lock{mutex};
+            stopped = true;
+        }
+        stopCondition.notify_all();
+        if (thread.joinable())
+            thread.join();
+
+        std::string directory{state.os->publicAppFilesPath + "guest_profiles/"};
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            Logger::Warn("Failed to create the guest profile directory '{}': {}", directory, error.message());
+            return;
+        }
+
+        auto path{fmt::format("{}{}.folded", directory, std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count())};
+        std::ofstream file{path, std::ios::trunc};
+        if (!file) {
+            Logger::Warn("Failed to open the guest profile file '{}'", path);
+            return;
+        }
+        file << Dump();
+        Logger::Info("Wrote the guest profile to '{}'", path);
+    }
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+#include <common/spsc_ring_buffer.h>
+
+namespace skyline::kernel {
+    /**
+     * @brief A sampling profiler for guest code, it periodically signals every thread that's scheduled on a core and records the guest PC and LR it interrupted
+     * @details Samples are written by the signal handler into a lock-free ring owned by each thread and are drained into a histogram by the sampler thread, the histogram is symbolized using the symbol tables of the loaded executables when it's dumped
+     * @note Only the PC and LR are sampled as walking the guest stack from a signal handler could fault, the LR is only meaningful as the caller while the function hasn't clobbered it yet
+     */
+    class GuestProfiler {
+      public:
+        inline static int SampleSignal{SIGRTMIN + 2}; //!< The signal used to sample the context of running threads
+
+        /**
+         * @brief A single sample of the guest context of a thread
+         */
+        struct Sample {
+            u64 pc;
+            u64 lr;
+        };
+
+        using SampleRing = SpscRingBuffer<Sample, 0x400>; //!< The ring of samples of a single thread, samples are dropped when it's full
+
+      private:
+        static constexpr std::chrono::milliseconds SampleInterval{2}; //!< The interval at which running threads are sampled
+
+        const DeviceState &state;
+        std::thread thread; //!< The thread which periodically signals running threads and drains their samples
+        std::mutex mutex; //!< Synchronizes access to the histogram and the stop flag
+        std::condition_variable stopCondition;
+        bool stopped{};
+        std::map<std::pair<u64, u64>, u64> histogram; //!< A map from the PC and LR of a sample to the amount of times it was sampled
+        inline static std::atomic<u64> hostSamples{}; //!< The amount of samples that interrupted host code rather than guest code, this is generally time spent in SVCs and HLE
+
+        void Run();
+
+        /**
+         * @brief Moves the samples of all threads in the process into the histogram
+         * @note The mutex must be locked by the caller
+         */
+        void Drain();
+
+      public:
+        GuestProfiler(const DeviceState &state);
+
+        ~GuestProfiler();
+
+        /**
+         * @brief Records a sample of the guest context that was interrupted into the ring of the current thread
+         */
+        static void SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls);
+
+        /**
+         * @return All samples so far in the collapsed stack format used by flame graph tools, every line has the symbolized caller and callee of a sample followed by the amount of times it was sampled
+         */
+        std::string Dump();
+
+        /**
+         * @brief Stops sampling and writes the collected samples out to a file in the public app files directory
+         */
+        void Stop();
+    };
+}
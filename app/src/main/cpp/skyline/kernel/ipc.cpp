@@ -142,7 +142,7 @@ namespace skyline::kernel::ipc {
         memset(tls, 0, constant::TlsIpcSize);
 
         auto header{reinterpret_cast<CommandHeader *>(pointer)};
-        size_t sizeBytes{isTipc ? (payload.size() + sizeof(Result)) : (sizeof(PayloadHeader) + constant::IpcPaddingSum + payload.size() + (domainObjects.size() * sizeof(KHandle)) + (isDomain ? sizeof(DomainHeaderRequest) : 0))};
+        size_t sizeBytes{isTipc ? (payloadSize + sizeof(Result)) : (sizeof(PayloadHeader) + constant::IpcPaddingSum + payloadSize + (domainObjects.size() * sizeof(KHandle)) + (isDomain ? sizeof(DomainHeaderRequest) : 0))};
         header->rawSize = static_cast<u32>(util::DivideCeil(sizeBytes, sizeof(u32))); // Size is in 32-bit units because Nintendo
         header->handleDesc = (!copyHandles.empty() || !moveHandles.empty());
         pointer += sizeof(CommandHeader);
@@ -167,7 +167,7 @@ namespace skyline::kernel::ipc {
         if (isTipc) {
             *reinterpret_cast<Result *>(pointer) = errorCode;
             pointer += sizeof(Result);
-            std::memcpy(pointer, payload.data(), payload.size());
+            std::memcpy(pointer, payload.data(), payloadSize);
         } else {
             size_t offset{static_cast<size_t>(pointer - tls)}; // We calculate the relative offset as the absolute one might differ
             auto padding{util::AlignUp(offset, constant::IpcPaddingSum) - offset}; // Calculate the amount of padding at the front
@@ -185,9 +185,8 @@ namespace skyline::kernel::ipc {
             payloadHeader->value = errorCode;
             pointer += sizeof(PayloadHeader);
 
-            if (!payload.empty())
-                std::memcpy(pointer, payload.data(), payload.size());
-            pointer += payload.size();
+            std::memcpy(pointer, payload.data(), payloadSize);
+            pointer += payloadSize;
 
             if (isDomain) {
                 for (auto &domainObject : domainObjects) {
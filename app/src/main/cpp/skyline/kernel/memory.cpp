@@ -3,6 +3,7 @@
 
 #include <asm-generic/unistd.h>
 #include <fcntl.h>
+#include <common/settings.h>
 #include "memory.h"
 #include "types/KProcess.h"
 
@@ -10,6 +11,15 @@ namespace skyline::kernel {
     MemoryManager::MemoryManager(const DeviceState &state) : state(state) {}
 
     MemoryManager::~MemoryManager() {
+        if (prefaultThread.joinable()) {
+            {
+                std::scoped_lock lock{prefaultMutex};
+                prefaultExit = true;
+            }
+            prefaultCondition.notify_all();
+            prefaultThread.join();
+        }
+
         if (base.valid() && !base.empty())
             munmap(reinterpret_cast<void *>(base.data()), base.size());
     }
@@ -83,7 +93,7 @@ namespace skyline::kernel {
         if (type != memory::AddressSpaceType::AddressSpace36Bit) {
             base = AllocateMappedRange(baseSize, RegionAlignment, KgslReservedRegionSize, addressSpace.size(), false);
 
-            chunks = {
+            for (const auto &chunk : std::initializer_list<ChunkDescriptor>{
                 ChunkDescriptor{
                     .ptr = addressSpace.data(),
                     .size = static_cast<size_t>(base.data() - addressSpace.data()),
@@ -98,7 +108,8 @@ namespace skyline::kernel {
                     .ptr = base.end().base(),
                     .size = addressSpace.size() - reinterpret_cast<u64>(base.end().base()),
                     .state = memory::states::Reserved,
-                }};
+                }})
+                chunks.emplace(chunk.ptr, chunk);
 
             code = base;
 
@@ -106,7 +117,7 @@ namespace skyline::kernel {
             base = AllocateMappedRange(baseSize, 1ULL << 36, KgslReservedRegionSize, addressSpace.size(), false);
             codeBase36Bit = AllocateMappedRange(0x32000000, RegionAlignment, 0xC000000, 0x78000000ULL + reinterpret_cast<size_t>(addressSpace.data()), true);
 
-            chunks = {
+            for (const auto &chunk : std::initializer_list<ChunkDescriptor>{
                 ChunkDescriptor{
                     .ptr = addressSpace.data(),
                     .size = static_cast<size_t>(codeBase36Bit.data() - addressSpace.data()),
@@ -131,7 +142,8 @@ namespace skyline::kernel {
                     .ptr = base.end().base(),
                     .size = addressSpace.size() - reinterpret_cast<u64>(base.end().base()),
                     .state = memory::states::Reserved,
-                }};
+                }})
+                chunks.emplace(chunk.ptr, chunk);
             code = codeBase36Bit;
         }
     }
@@ -173,6 +185,9 @@ namespace skyline::kernel {
         if (codeRegion.size() > code.size())
             throw exception("Code region ({}) is smaller than mapped code size ({})", code.size(), codeRegion.size());
 
+        AdviseHugePages(code);
+        AdviseHugePages(heap);
+
         Logger::Debug("Region Map:\nVMM Base: 0x{:X}\nCode Region: 0x{:X} - 0x{:X} (Size: 0x{:X})\nAlias Region: 0x{:X} - 0x{:X} (Size: 0x{:X})\nHeap Region: 0x{:X} - 0x{:X} (Size: 0x{:X})\nStack Region: 0x{:X} - 0x{:X} (Size: 0x{:X})\nTLS/IO Region: 0x{:X} - 0x{:X} (Size: 0x{:X})", base.data(), code.data(), code.end().base(), code.size(), alias.data(), alias.end().base(), alias.size(), heap.data(), heap.end().base(), heap.size(), stack.data(), stack.end().base(), stack.size(), tlsIo.data(), tlsIo.end().base(), tlsIo.size());
     }
 
@@ -235,55 +250,94 @@ namespace skyline::kernel {
                 throw exception("Failed to free memory: {}", strerror(errno))   ;
     }
 
-    void MemoryManager::InsertChunk(const ChunkDescriptor &chunk) {
-        std::unique_lock lock(mutex);
+    void MemoryManager::AdviseHugePages(span<u8> region) {
+        // This is purely a hint, hosts without THP support for shared memory will reject it which is harmless
+        if (madvise(region.data(), region.size(), MADV_HUGEPAGE) == -1)
+            Logger::Debug("Failed to advise huge pages for 0x{:X} - 0x{:X}: {}", region.data(), region.end().base(), strerror(errno));
+    }
+
+    void MemoryManager::Prefault(span<u8> region) {
+        if (!*state.settings->prefaultGuestMemory)
+            return;
 
-        auto upper{std::upper_bound(chunks.begin(), chunks.end(), chunk.ptr, [](const u8 *ptr, const ChunkDescriptor &chunk) -> bool { return ptr < chunk.ptr; })};
-        if (upper == chunks.begin())
-            throw exception("InsertChunk: Chunk inserted outside address space: 0x{:X} - 0x{:X} and 0x{:X} - 0x{:X}", upper->ptr, upper->ptr + upper->size, chunk.ptr, chunk.ptr + chunk.size);
+        u8 *alignedStart{util::AlignDown(region.data(), constant::PageSize)};
+        u8 *alignedEnd{util::AlignUp(region.end().base(), constant::PageSize)};
+        if (alignedStart >= alignedEnd)
+            return;
 
-        upper = chunks.erase(upper, std::upper_bound(upper, chunks.end(), chunk.ptr + chunk.size, [](const u8 *ptr, const ChunkDescriptor &chunk) -> bool { return ptr < chunk.ptr + chunk.size; }));
-        if (upper != chunks.end() && upper->ptr < chunk.ptr + chunk.size) {
-            auto end{upper->ptr + upper->size};
-            upper->ptr = chunk.ptr + chunk.size;
-            upper->size = static_cast<size_t>(end - upper->ptr);
+        {
+            std::scoped_lock lock{prefaultMutex};
+            prefaultQueue.emplace_back(alignedStart, static_cast<size_t>(alignedEnd - alignedStart));
+            if (!prefaultThread.joinable())
+                prefaultThread = std::thread(&MemoryManager::RunPrefaultThread, this);
         }
+        prefaultCondition.notify_one();
+    }
 
-        auto lower{std::prev(upper)};
-        if (lower->ptr == chunk.ptr && lower->size == chunk.size) {
-            lower->state = chunk.state;
-            lower->permission = chunk.permission;
-            lower->attributes = chunk.attributes;
-            lower->memory = chunk.memory;
-        } else if (lower->ptr + lower->size > chunk.ptr + chunk.size) {
-            auto lowerExtension{*lower};
-            lowerExtension.ptr = chunk.ptr + chunk.size;
-            lowerExtension.size = static_cast<size_t>((lower->ptr + lower->size) - lowerExtension.ptr);
-
-            lower->size = static_cast<size_t>(chunk.ptr - lower->ptr);
-            if (lower->size) {
-                upper = chunks.insert(upper, lowerExtension);
-                chunks.insert(upper, chunk);
-            } else {
-                auto lower2{std::prev(lower)};
-                if (chunk.IsCompatible(*lower2) && lower2->ptr + lower2->size >= chunk.ptr) {
-                    lower2->size = static_cast<size_t>(chunk.ptr + chunk.size - lower2->ptr);
-                    upper = chunks.erase(lower);
-                } else {
-                    *lower = chunk;
+    void MemoryManager::RunPrefaultThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-Prefault")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        constexpr int MadvisePopulateWrite{23}; //!< MADV_POPULATE_WRITE (Linux 5.14+), this isn't defined by older NDK headers
+        std::unique_lock lock{prefaultMutex};
+        while (true) {
+            prefaultCondition.wait(lock, [this] { return !prefaultQueue.empty() || prefaultExit; });
+            if (prefaultExit)
+                return;
+
+            auto region{prefaultQueue.back()};
+            prefaultQueue.pop_back();
+            lock.unlock();
+
+            // The pages are populated through the kernel rather than by touching them as the region may be concurrently unmapped or reprotected, which the syscall safely fails on
+            if (madvise(region.data(), region.size(), MadvisePopulateWrite) == -1) {
+                Logger::Debug("Failed to pre-fault 0x{:X} - 0x{:X}: {}", region.data(), region.end().base(), strerror(errno));
+                if (errno == EINVAL) {
+                    Logger::Info("Host kernel doesn't support pre-faulting guest memory");
+                    return; // The host kernel is too old to support populating pages
                 }
-                upper = chunks.insert(upper, lowerExtension);
             }
-        } else if (chunk.IsCompatible(*lower) && lower->ptr + lower->size >= chunk.ptr) {
-            lower->size = static_cast<size_t>(chunk.ptr + chunk.size - lower->ptr);
-        } else {
-            if (lower->ptr + lower->size > chunk.ptr)
-                lower->size = static_cast<size_t>(chunk.ptr - lower->ptr);
-            if (upper != chunks.end() && chunk.IsCompatible(*upper) && chunk.ptr + chunk.size >= upper->ptr) {
-                upper->ptr = chunk.ptr;
-                upper->size = chunk.size + upper->size;
-            } else {
-                chunks.insert(upper, chunk);
+
+            lock.lock();
+        }
+    }
+
+    void MemoryManager::InsertChunk(const ChunkDescriptor &chunk) {
+        std::unique_lock lock(mutex);
+
+        if (chunks.empty() || chunk.ptr < chunks.begin()->first)
+            throw exception("InsertChunk: Chunk inserted outside address space: 0x{:X} - 0x{:X}", chunk.ptr, chunk.ptr + chunk.size);
+
+        // Splits any chunk straddling the supplied address so a chunk boundary lies on it
+        auto splitAt{[this](u8 *ptr) {
+            auto upper{chunks.upper_bound(ptr)};
+            auto &containing{std::prev(upper)->second};
+            if (containing.ptr < ptr && containing.ptr + containing.size > ptr) {
+                auto tail{containing};
+                tail.ptr = ptr;
+                tail.size = static_cast<size_t>((containing.ptr + containing.size) - ptr);
+                containing.size = static_cast<size_t>(ptr - containing.ptr);
+                chunks.emplace_hint(upper, ptr, tail);
+            }
+        }};
+
+        u8 *chunkEnd{chunk.ptr + chunk.size};
+        splitAt(chunk.ptr);
+        splitAt(chunkEnd);
+
+        auto it{chunks.erase(chunks.lower_bound(chunk.ptr), chunks.lower_bound(chunkEnd))};
+        it = chunks.emplace_hint(it, chunk.ptr, chunk);
+
+        if (auto next{std::next(it)}; next != chunks.end() && chunk.IsCompatible(next->second) && chunkEnd == next->first) {
+            it->second.size += next->second.size;
+            chunks.erase(next);
+        }
+
+        if (it != chunks.begin()) {
+            auto &previous{std::prev(it)->second};
+            if (chunk.IsCompatible(previous) && previous.ptr + previous.size == chunk.ptr) {
+                previous.size += it->second.size;
+                chunks.erase(it);
             }
         }
     }
@@ -291,10 +345,10 @@ namespace skyline::kernel {
     std::optional<ChunkDescriptor> MemoryManager::Get(void *ptr) {
         std::shared_lock lock(mutex);
 
-        auto chunk{std::upper_bound(chunks.begin(), chunks.end(), reinterpret_cast<u8 *>(ptr), [](const u8 *ptr, const ChunkDescriptor &chunk) -> bool { return ptr < chunk.ptr; })};
+        auto chunk{chunks.upper_bound(reinterpret_cast<u8 *>(ptr))};
         if (chunk-- != chunks.begin())
-            if ((chunk->ptr + chunk->size) > ptr)
-                return std::make_optional(*chunk);
+            if ((chunk->second.ptr + chunk->second.size) > ptr)
+                return std::make_optional(chunk->second);
 
         return std::nullopt;
     }
@@ -302,7 +356,7 @@ namespace skyline::kernel {
     size_t MemoryManager::GetUserMemoryUsage() {
         std::shared_lock lock(mutex);
         size_t size{};
-        for (const auto &chunk : chunks)
+        for (const auto &[ptr, chunk] : chunks)
             if (chunk.state == memory::states::Heap)
                 size += chunk.size;
         return size + code.size() + state.process->mainThreadStack->guest.size();
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <sys/mman.h>
+#include <map>
 #include <common.h>
 #include <common/file_descriptor.h>
 
@@ -212,7 +213,20 @@ namespace skyline {
         class MemoryManager {
           private:
             const DeviceState &state;
-            std::vector<ChunkDescriptor> chunks;
+            std::map<u8 *, ChunkDescriptor> chunks; //!< A map from the base address of chunks to their descriptors, the chunks are contiguous and cover the entire address space
+
+            std::thread prefaultThread; //!< A thread which populates the pages of regions queued by Prefault, it's started on the first call to Prefault
+            std::mutex prefaultMutex; //!< Synchronizes access to the prefault queue
+            std::condition_variable prefaultCondition; //!< Signalled when a region is queued or the thread should exit
+            std::vector<span<u8>> prefaultQueue; //!< Regions which should be pre-faulted by the prefault thread
+            bool prefaultExit{}; //!< If the prefault thread should exit
+
+            void RunPrefaultThread();
+
+            /**
+             * @brief Requests that the supplied region be backed by transparent huge pages where the host supports it, this reduces TLB misses on large regions
+             */
+            static void AdviseHugePages(span<u8> region);
 
           public:
             memory::AddressSpaceType addressSpaceType{};
@@ -260,8 +274,21 @@ namespace skyline {
              */
             void FreeMemory(span<u8> memory);
 
+            /**
+             * @brief Populates the host pages backing the supplied region on a background thread, so the guest doesn't take a page fault on its first access to every page
+             * @note This is a no-op unless the 'prefaultGuestMemory' setting is enabled, pages are populated without modifying their contents
+             */
+            void Prefault(span<u8> region);
+
+            /**
+             * @brief Inserts a chunk into the chunk map, overwriting any chunks it overlaps with and merging it with its neighbours if they're compatible
+             * @note This is O(log n) in the amount of chunks alongside the amount of chunks that are overwritten
+             */
             void InsertChunk(const ChunkDescriptor &chunk);
 
+            /**
+             * @return The chunk containing the supplied address, if any
+             */
             std::optional<ChunkDescriptor> Get(void *ptr);
 
             /**
@@ -2,15 +2,198 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
 #include <common/signal.h>
 #include <common/trace.h>
+#include <common/settings.h>
 #include "types/KThread.h"
 #include "scheduler.h"
 
 namespace skyline::kernel {
+    static constexpr size_t WakeSpinIterations{0x200}; //!< The amount of iterations a thread will spin for waiting to be woken prior to sleeping on its futex, handoffs between cooperatively yielding threads are usually completed within this
+
+    void Scheduler::WakeThread(type::KThread *thread) {
+        // The sequence is advanced in steps of two to keep the lowest bit free as a flag denoting if the thread is sleeping on its futex
+        u32 value{thread->scheduleFutex.load(std::memory_order_relaxed)};
+        while (!thread->scheduleFutex.compare_exchange_weak(value, (value + 2) & ~1U, std::memory_order_release, std::memory_order_relaxed));
+
+        if (value & 1)
+            syscall(SYS_futex, reinterpret_cast<u32 *>(&thread->scheduleFutex), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+    template<typename Lock, typename Predicate>
+    bool Scheduler::WaitForWake(type::KThread *thread, Lock &lock, std::chrono::nanoseconds timeout, Predicate &&predicate) {
+        auto &futex{thread->scheduleFutex};
+        bool timed{timeout != std::chrono::nanoseconds::max()};
+        auto deadline{timed ? std::chrono::steady_clock::now() + timeout : std::chrono::steady_clock::time_point{}};
+
+        while (true) {
+            // The value must be read prior to evaluating the predicate with the lock held so any wakes after the predicate are observed
+            u32 value{futex.load(std::memory_order_acquire) & ~1U};
+            if (predicate())
+                return true;
+            lock.unlock();
+
+            bool woken{};
+            for (size_t i{}; i < WakeSpinIterations; i++) {
+                if ((futex.load(std::memory_order_acquire) & ~1U) != value) {
+                    woken = true;
+                    break;
+                }
+                asm volatile("YIELD");
+            }
+
+            // The sleeping flag is set unless a wake occurred since reading the value, it may already be set from a prior interrupted wait
+            u32 expected{value};
+            if (!woken && (futex.compare_exchange_strong(expected, value | 1, std::memory_order_relaxed) || expected == (value | 1))) {
+                // A signal interrupting the wait will cause it to return early, this is intended as the predicate needs to be rechecked
+                if (timed) {
+                    auto remaining{std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()), std::chrono::nanoseconds{})};
+                    timespec spec{
+                        .tv_sec = static_cast<time_t>(remaining.count() / constant::NsInSecond),
+                        .tv_nsec = static_cast<long>(remaining.count() % constant::NsInSecond),
+                    };
+                    syscall(SYS_futex, reinterpret_cast<u32 *>(&futex), FUTEX_WAIT_PRIVATE, value | 1, &spec, nullptr, 0);
+                } else {
+                    syscall(SYS_futex, reinterpret_cast<u32 *>(&futex), FUTEX_WAIT_PRIVATE, value | 1, nullptr, nullptr, 0);
+                }
+            }
+
+            lock.lock();
+            if (timed && std::chrono::steady_clock::now() >= deadline)
+                return predicate();
+        }
+    }
+
+    void Scheduler::PinToHostCores(u8 coreId) {
+        // A host thread only runs a single guest thread at a time so the current pinning can be tracked per host thread, this avoids a syscall on every schedule
+        thread_local host::AffinityClass pinnedAffinity{host::AffinityClass::Any};
+        auto affinity{*state.settings->pinGuestCores ? CoreAffinity[coreId] : host::AffinityClass::Any};
+        if (affinity != pinnedAffinity) {
+            host::Topology::Get().SetThreadAffinity(affinity);
+            pinnedAffinity = affinity;
+        }
+    }
+
     Scheduler::CoreContext::CoreContext(u8 id, i8 preemptionPriority) : id(id), preemptionPriority(preemptionPriority) {}
 
-    Scheduler::Scheduler(const DeviceState &state) : state(state) {}
+    type::KThread *Scheduler::CoreContext::Front() const {
+        u64 mask{occupancy.load(std::memory_order_relaxed)};
+        return mask ? queues[static_cast<size_t>(std::countr_zero(mask))].front : nullptr;
+    }
+
+    void Scheduler::CoreContext::PushBack(type::KThread *thread, i8 priority) {
+        auto &queue{queues.at(static_cast<size_t>(priority))};
+        thread->schedulerPriority = priority;
+        thread->schedulerPrev = queue.back;
+        thread->schedulerNext = nullptr;
+        if (queue.back)
+            queue.back->schedulerNext = thread;
+        else
+            queue.front = thread;
+        queue.back = thread;
+        thread->isQueued = true;
+        occupancy.fetch_or(1ULL << priority, std::memory_order_relaxed);
+
+        thread->schedulerLoad = thread->averageTimeslice ? thread->averageTimeslice : 1;
+        load.fetch_add(thread->schedulerLoad, std::memory_order_relaxed);
+        threadCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Scheduler::CoreContext::PushFront(type::KThread *thread, i8 priority) {
+        auto &queue{queues.at(static_cast<size_t>(priority))};
+        thread->schedulerPriority = priority;
+        thread->schedulerPrev = nullptr;
+        thread->schedulerNext = queue.front;
+        if (queue.front)
+            queue.front->schedulerPrev = thread;
+        else
+            queue.back = thread;
+        queue.front = thread;
+        thread->isQueued = true;
+        occupancy.fetch_or(1ULL << priority, std::memory_order_relaxed);
+
+        thread->schedulerLoad = thread->averageTimeslice ? thread->averageTimeslice : 1;
+        load.fetch_add(thread->schedulerLoad, std::memory_order_relaxed);
+        threadCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Scheduler::CoreContext::Erase(type::KThread *thread) {
+        auto &queue{queues[static_cast<size_t>(thread->schedulerPriority)]};
+        (thread->schedulerPrev ? thread->schedulerPrev->schedulerNext : queue.front) = thread->schedulerNext;
+        (thread->schedulerNext ? thread->schedulerNext->schedulerPrev : queue.back) = thread->schedulerPrev;
+        thread->schedulerPrev = thread->schedulerNext = nullptr;
+        thread->isQueued = false;
+        if (!queue.front)
+            occupancy.fetch_and(~(1ULL << thread->schedulerPriority), std::memory_order_relaxed);
+
+        load.fetch_sub(thread->schedulerLoad, std::memory_order_relaxed);
+        threadCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    Scheduler::Scheduler(const DeviceState &state) : state(state), preemptionThread(&Scheduler::RunPreemptionThread, this) {}
+
+    Scheduler::~Scheduler() {
+        {
+            std::scoped_lock lock{preemptionMutex};
+            preemptionExit = true;
+        }
+        preemptionCondition.notify_all();
+        preemptionThread.join();
+    }
+
+    void Scheduler::ArmContendedPreemption(CoreContext &core) {
+        auto front{core.Front()};
+        if (!front || front->isPreempted || front->schedulerPriority != core.preemptionPriority || !front->schedulerNext)
+            return;
+
+        {
+            std::scoped_lock lock{preemptionMutex};
+            core.preemptionTarget = front;
+            core.preemptionDeadline = util::GetTimeNs() + std::chrono::duration_cast<std::chrono::nanoseconds>(PreemptiveTimeslice).count();
+            front->isPreempted = true;
+        }
+        preemptionCondition.notify_one();
+    }
+
+    void Scheduler::DisarmPreemption(type::KThread *thread) {
+        if (!thread->isPreempted)
+            return;
+
+        // The deadline is left in place as the preemption thread will just recalculate its wait once it wakes up, this avoids waking it for every disarm
+        std::scoped_lock lock{preemptionMutex};
+        for (auto &core : cores)
+            if (core.preemptionTarget == thread)
+                core.preemptionTarget = nullptr;
+        thread->isPreempted = false;
+    }
+
+    void Scheduler::RunPreemptionThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-Preempt")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        std::unique_lock lock{preemptionMutex};
+        while (!preemptionExit) {
+            i64 now{util::GetTimeNs()}, nextDeadline{std::numeric_limits<i64>::max()};
+            for (auto &core : cores) {
+                if (!core.preemptionTarget)
+                    continue;
+
+                if (core.preemptionDeadline <= now) {
+                    core.preemptionTarget->SendSignal(PreemptionSignal);
+                    core.preemptionTarget = nullptr;
+                } else {
+                    nextDeadline = std::min(nextDeadline, core.preemptionDeadline);
+                }
+            }
+
+            if (nextDeadline == std::numeric_limits<i64>::max())
+                preemptionCondition.wait(lock);
+            else
+                preemptionCondition.wait_for(lock, std::chrono::nanoseconds{nextDeadline - now});
+        }
+    }
 
     void Scheduler::SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls) {
         if (*tls) {
@@ -33,36 +216,21 @@ namespace skyline::kernel {
     Scheduler::CoreContext &Scheduler::GetOptimalCoreForThread(const std::shared_ptr<type::KThread> &thread) {
         auto *currentCore{&cores.at(thread->coreId)};
 
-        if (!currentCore->queue.empty() && thread->affinityMask.count() != 1) {
-            // Select core where the current thread will be scheduled the earliest based off average timeslice durations for resident threads
+        if (currentCore->threadCount.load(std::memory_order_relaxed) && thread->affinityMask.count() != 1) {
+            // Select core where the current thread will be scheduled the earliest based off the load of resident threads, this is tracked in atomics so no cores need to be locked
             // There's a preference for the current core as migration isn't free
-            size_t minTimeslice{};
+            u64 minTimeslice{};
             CoreContext *optimalCore{};
             for (auto &candidateCore : cores) {
                 if (thread->affinityMask.test(candidateCore.id)) {
                     u64 timeslice{};
 
-                    if (!candidateCore.queue.empty()) {
-                        std::scoped_lock coreLock{candidateCore.mutex};
-
-                        auto threadIterator{candidateCore.queue.cbegin()};
-                        if (threadIterator != candidateCore.queue.cend()) {
-                            const auto &runningThread{*threadIterator};
-                            timeslice += [&]() {
-                                if (runningThread->averageTimeslice)
-                                    return std::min(runningThread->averageTimeslice - (util::GetTimeTicks() - runningThread->timesliceStart), 1UL);
-                                else if (runningThread->timesliceStart)
-                                    return util::GetTimeTicks() - runningThread->timesliceStart;
-                                else
-                                    return 1UL;
-                            }();
-
-                            while (++threadIterator != candidateCore.queue.cend()) {
-                                const auto &residentThread{*threadIterator};
-                                if (residentThread->priority <= thread->priority)
-                                    timeslice += residentThread->averageTimeslice ? residentThread->averageTimeslice : 1UL;
-                            }
-                        }
+                    // A core which only has threads of a lower priority would schedule the thread immediately
+                    u64 occupancy{candidateCore.occupancy.load(std::memory_order_relaxed)};
+                    if (occupancy && std::countr_zero(occupancy) <= thread->priority) {
+                        timeslice = candidateCore.load.load(std::memory_order_relaxed);
+                        if (&candidateCore == currentCore && thread->isQueued)
+                            timeslice -= std::min(timeslice, thread->schedulerLoad); // The thread's own timeslice shouldn't count against its current core
                     }
 
                     if (!optimalCore || timeslice < minTimeslice || (timeslice == minTimeslice && &candidateCore == currentCore)) {
@@ -85,8 +253,86 @@ namespace skyline::kernel {
         return *currentCore;
     }
 
-    void Scheduler::YieldThread(const std::shared_ptr<type::KThread> &thread) {
-        if (state.thread != thread) {
+    std::unique_lock<AdaptiveMutex> Scheduler::LockResidentCore(type::KThread *thread, CoreContext *&core) {
+        while (true) {
+            core = &cores.at(thread->coreId);
+            std::unique_lock lock{core->mutex};
+            if (thread->coreId == core->id)
+                return lock;
+        }
+    }
+
+    void Scheduler::FollowResidentCore(type::KThread *thread, CoreContext *&core, std::unique_lock<AdaptiveMutex> &lock) {
+        while (thread->coreId != core->id && thread->coreId != constant::ParkedCoreId) [[unlikely]] {
+            lock.unlock();
+            core = &cores.at(thread->coreId);
+            lock = std::unique_lock{core->mutex};
+        }
+    }
+
+    void Scheduler::StealThread(CoreContext &idleCore) {
+        // Cores are tried from the busiest to the least busy, only cores with any threads waiting behind the running one have anything to steal
+        std::array<CoreContext *, constant::CoreCount> victims{};
+        size_t victimCount{};
+        for (auto &core : cores)
+            if (&core != &idleCore && core.threadCount.load(std::memory_order_relaxed) > 1)
+                victims[victimCount++] = &core;
+        std::sort(victims.begin(), victims.begin() + victimCount, [](CoreContext *a, CoreContext *b) {
+            return a->load.load(std::memory_order_relaxed) > b->load.load(std::memory_order_relaxed);
+        });
+
+        for (size_t i{}; i < victimCount; i++) {
+            auto &victimCore{*victims[i]};
+            std::unique_lock victimLock{victimCore.mutex};
+
+            // The highest priority waiting thread which can run on the idle core is stolen, its migration mutex is only tried as it's normally locked prior to the core mutex
+            type::KThread *stolenThread{};
+            auto front{victimCore.Front()};
+            for (u64 mask{victimCore.occupancy.load(std::memory_order_relaxed)}; mask && !stolenThread; mask &= mask - 1) {
+                for (auto candidate{victimCore.queues[static_cast<size_t>(std::countr_zero(mask))].front}; candidate; candidate = candidate->schedulerNext) {
+                    if (candidate == front || candidate->forceYield || !candidate->affinityMask.test(idleCore.id))
+                        continue; // Running threads including ones which have been forcefully yielded but haven't acted on it yet are ineligible
+
+                    if (candidate->coreMigrationMutex.try_lock()) {
+                        if (candidate->affinityMask.test(idleCore.id)) {
+                            stolenThread = candidate;
+                            break;
+                        }
+                        candidate->coreMigrationMutex.unlock();
+                    }
+                }
+            }
+
+            if (!stolenThread)
+                continue;
+
+            victimCore.Erase(stolenThread);
+            stolenThread->coreId = idleCore.id;
+            victimLock.unlock();
+
+            i8 priority{stolenThread->priority};
+            {
+                std::scoped_lock idleLock{idleCore.mutex};
+                auto idleFront{idleCore.Front()};
+                if (idleFront && priority < idleFront->schedulerPriority) {
+                    PreemptFront(idleCore, stolenThread, priority);
+                } else {
+                    idleCore.PushBack(stolenThread, priority);
+                    ArmContendedPreemption(idleCore);
+                }
+
+                // The thread is woken regardless of being at the front so it switches over to waiting on the idle core
+                WakeThread(stolenThread);
+            }
+
+            Logger::Debug("Load Balancing T{}: C{} -> C{} (Stolen)", stolenThread->id, victimCore.id, idleCore.id);
+            stolenThread->coreMigrationMutex.unlock();
+            return;
+        }
+    }
+
+    void Scheduler::YieldThread(type::KThread *thread) {
+        if (state.thread.get() != thread) {
             // If another thread is being yielded, we need to send it an OS signal to yield
             if (!thread->pendingYield) {
                 // We only want to yield the thread if it hasn't already been sent a signal to yield in the past
@@ -112,47 +358,51 @@ namespace skyline::kernel {
             return;
         }
 
-        #ifndef NDEBUG
-        // Scan the queue for the same thread to prevent double insertion
-        for (auto &residentThread : core.queue) {
-            if (residentThread == thread) {
-                Logger::Error("T{} already exists in C{}", thread->id, core.id);
-                Logger::EmulationContext.Flush();
-            }
+        // Inserting the same thread twice would corrupt the intrusive queues
+        if (thread->isQueued) [[unlikely]] {
+            Logger::Error("T{} already exists in C{}", thread->id, core.id);
+            Logger::EmulationContext.Flush();
+            return;
         }
-        #endif
-
-        auto nextThread{std::upper_bound(core.queue.begin(), core.queue.end(), thread->priority.load(), type::KThread::IsHigherPriority)};
-        if (nextThread == core.queue.begin()) {
-            if (nextThread != core.queue.end()) {
-                // If the inserted thread has a higher priority than the currently running thread (and the queue isn't empty)
-                // We can yield the thread which is currently scheduled on the core by sending it a signal
-                // It is optimized to avoid waiting for the thread to yield on receiving the signal which serializes the entire pipeline
-                auto front{core.queue.front()};
-                front->forceYield = true;
-                core.queue.splice(std::upper_bound(core.queue.begin(), core.queue.end(), front->priority.load(), type::KThread::IsHigherPriority), core.queue, core.queue.begin());
-                core.queue.push_front(thread);
-
-                YieldThread(front);
-            } else {
-                core.queue.push_front(thread);
-            }
+
+        i8 priority{thread->priority};
+        auto front{core.Front()};
+        if (!front || priority < front->schedulerPriority) {
+            if (front)
+                PreemptFront(core, thread.get(), priority);
+            else
+                core.PushBack(thread.get(), priority);
+
             if (thread != state.thread)
-                thread->scheduleCondition.notify_one(); // We only want to trigger the conditional variable if the current thread isn't inserting itself
+                WakeThread(thread.get()); // We only want to wake the thread if the current thread isn't inserting itself
         } else {
-            core.queue.insert(nextThread, thread);
+            core.PushBack(thread.get(), priority);
+            ArmContendedPreemption(core); // The running thread may now be contended by the inserted thread
         }
     }
 
-    void Scheduler::MigrateToCore(const std::shared_ptr<type::KThread> &thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<std::mutex> &lock) {
+    void Scheduler::PreemptFront(CoreContext &core, type::KThread *thread, i8 priority) {
+        // If the inserted thread has a higher priority than the currently running thread, we can yield the running thread by sending it a signal
+        // It is optimized to avoid waiting for the thread to yield on receiving the signal which serializes the entire pipeline
+        // The running thread is moved behind all other threads of its priority as it would've been on rotation, as it has been forcefully yielded it won't rotate itself
+        auto front{core.Front()};
+        front->forceYield = true;
+        core.Erase(front);
+        core.PushBack(front, front->schedulerPriority);
+        core.PushFront(thread, priority);
+
+        YieldThread(front);
+    }
+
+    void Scheduler::MigrateToCore(const std::shared_ptr<type::KThread> &thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<AdaptiveMutex> &lock) {
         // We need to check if the thread was in its resident core's queue
         // If it was, we need to remove it from the queue
-        auto it{std::find(currentCore->queue.begin(), currentCore->queue.end(), thread)};
-        bool wasInserted{it != currentCore->queue.end()};
+        bool wasInserted{thread->isQueued};
         if (wasInserted) {
-            it = currentCore->queue.erase(it);
-            if (it == currentCore->queue.begin() && it != currentCore->queue.end())
-                (*it)->scheduleCondition.notify_one();
+            bool wasFront{currentCore->Front() == thread.get()};
+            currentCore->Erase(thread.get());
+            if (auto front{currentCore->Front()}; wasFront && front)
+                WakeThread(front);
         }
         lock.unlock();
 
@@ -171,6 +421,7 @@ namespace skyline::kernel {
         std::unique_lock lock(core->mutex);
 
         auto wakeFunction{[&]() {
+            FollowResidentCore(thread.get(), core, lock);
             if (!thread->affinityMask.test(thread->coreId)) [[unlikely]] {
                 lock.unlock(); // If the core migration mutex is locked by a thread seeking the core mutex, it'll result in a deadlock
                 std::scoped_lock migrationLock{thread->coreMigrationMutex};
@@ -178,13 +429,13 @@ namespace skyline::kernel {
                 if (!thread->affinityMask.test(thread->coreId)) // We need to retest in case the thread was migrated while the core was unlocked
                     MigrateToCore(thread, core, &cores.at(thread->idealCore), lock);
             }
-            return !core->queue.empty() && core->queue.front() == thread;
+            return core->Front() == thread.get();
         }};
 
         TRACE_EVENT("scheduler", "WaitSchedule");
         if (loadBalance) {
             std::chrono::milliseconds loadBalanceThreshold{PreemptiveTimeslice * 2}; //!< The amount of time that needs to pass unscheduled for a thread to attempt load balancing
-            while (!thread->scheduleCondition.wait_for(lock, loadBalanceThreshold, wakeFunction)) {
+            while (!WaitForWake(thread.get(), lock, loadBalanceThreshold, wakeFunction)) {
                 lock.unlock(); // We cannot call GetOptimalCoreForThread without relinquishing the core mutex
                 std::scoped_lock migrationLock{thread->coreMigrationMutex};
                 auto newCore{&GetOptimalCoreForThread(state.thread)};
@@ -195,13 +446,13 @@ namespace skyline::kernel {
                 loadBalanceThreshold *= 2; // We double the duration required for future load balancing for this invocation to minimize pointless load balancing
             }
         } else {
-            thread->scheduleCondition.wait(lock, wakeFunction);
+            WaitForWake(thread.get(), lock, std::chrono::nanoseconds::max(), wakeFunction);
         }
 
-        if (thread->priority == core->preemptionPriority)
-            // If the thread needs to be preempted then arm its preemption timer
-            thread->ArmPreemptionTimer(PreemptiveTimeslice);
+        // If the thread needs to be preempted then start timing its timeslice
+        ArmContendedPreemption(*core);
 
+        PinToHostCores(core->id);
         thread->timesliceStart = util::GetTimeTicks();
     }
 
@@ -211,16 +462,17 @@ namespace skyline::kernel {
 
         TRACE_EVENT("scheduler", "TimedWaitSchedule");
         std::unique_lock lock(core->mutex);
-        if (thread->scheduleCondition.wait_for(lock, timeout, [&]() {
+        if (WaitForWake(thread.get(), lock, timeout, [&]() {
+            FollowResidentCore(thread.get(), core, lock);
             if (!thread->affinityMask.test(thread->coreId)) [[unlikely]] {
                 std::scoped_lock migrationLock{thread->coreMigrationMutex};
                 MigrateToCore(thread, core, &cores.at(thread->idealCore), lock);
             }
-            return !core->queue.empty() && core->queue.front() == thread;
+            return core->Front() == thread.get();
         })) {
-            if (thread->priority == core->preemptionPriority)
-                thread->ArmPreemptionTimer(PreemptiveTimeslice);
+            ArmContendedPreemption(*core);
 
+            PinToHostCores(core->id);
             thread->timesliceStart = util::GetTimeTicks();
 
             return true;
@@ -231,47 +483,60 @@ namespace skyline::kernel {
 
     void Scheduler::Rotate(bool cooperative) {
         auto &thread{state.thread};
-        auto &core{cores.at(thread->coreId)};
-
-        std::unique_lock lock(core.mutex);
+        CoreContext *core;
+        auto lock{LockResidentCore(thread.get(), core)};
 
-        if (core.queue.front() == thread) {
+        if (core->Front() == thread.get()) {
             // If this thread is at the front of the thread queue then we need to rotate the thread
             // In the case where this thread was forcefully yielded, we don't need to do this as it's done by the thread which yielded to this thread
-            // Splice the linked element from the beginning of the queue to where its priority is present
-            core.queue.splice(std::upper_bound(core.queue.begin(), core.queue.end(), thread->priority.load(), type::KThread::IsHigherPriority), core.queue, core.queue.begin());
+            // Move the thread to the back of the queue for its priority, which is scheduled after all other threads of an equal priority
+            core->Erase(thread.get());
+            core->PushBack(thread.get(), thread->priority);
 
-            auto &front{core.queue.front()};
-            if (front != thread)
-                front->scheduleCondition.notify_one(); // If we aren't at the front of the queue, only then should we wake the thread at the front up
+            auto front{core->Front()};
+            if (front != thread.get())
+                WakeThread(front); // If we aren't at the front of the queue, only then should we wake the thread at the front up
         } else if (!thread->forceYield) {
             throw exception("T{} called Rotate while not being in C{}'s queue", thread->id, thread->coreId);
         }
 
         thread->averageTimeslice = (thread->averageTimeslice / 4) + (3 * (util::GetTimeTicks() - thread->timesliceStart / 4));
 
-        thread->DisarmPreemptionTimer(); // If a preemptive thread did a cooperative yield then we need to disarm the preemptive timer
+        DisarmPreemption(thread.get()); // If a preemptive thread did a cooperative yield then we need to stop timing its timeslice
         thread->pendingYield = false;
         thread->forceYield = false;
     }
 
+    std::vector<std::shared_ptr<type::KThread>> Scheduler::GetScheduledThreads() {
+        std::vector<std::shared_ptr<type::KThread>> threads;
+        for (auto &core : cores) {
+            std::scoped_lock lock{core.mutex};
+            if (auto front{core.Front()})
+                threads.push_back(front->shared_from_this());
+        }
+        return threads;
+    }
+
     void Scheduler::RemoveThread() {
         auto &thread{state.thread};
+        CoreContext *core;
+        bool idle{};
         {
-            auto &core{cores.at(thread->coreId)};
-            std::unique_lock lock(core.mutex);
+            auto lock{LockResidentCore(thread.get(), core)};
 
             if (!thread->isPaused) {
-                auto it{std::find(core.queue.begin(), core.queue.end(), thread)};
-                if (it != core.queue.end()) {
-                    it = core.queue.erase(it);
-                    if (it == core.queue.begin()) {
+                if (thread->isQueued) {
+                    bool wasFront{core->Front() == thread.get()};
+                    core->Erase(thread.get());
+                    if (wasFront) {
                         // We need to update the averageTimeslice accordingly, if we've been unscheduled by this
                         if (thread->timesliceStart)
                             thread->averageTimeslice = (thread->averageTimeslice / 4) + (3 * (util::GetTimeTicks() - thread->timesliceStart / 4));
 
-                        if (it != core.queue.end())
-                            (*it)->scheduleCondition.notify_one(); // We need to wake the thread at the front of the queue, if we were at the front previously
+                        if (auto front{core->Front()})
+                            WakeThread(front); // We need to wake the thread at the front of the queue, if we were at the front previously
+                        else
+                            idle = true;
                     }
                 } else {
                     Logger::Warn("T{} was not in C{}'s queue", thread->id, thread->coreId);
@@ -279,12 +544,16 @@ namespace skyline::kernel {
             } else {
                 thread->insertThreadOnResume = false;
             }
+
+            DisarmPreemption(thread.get());
         }
 
-        thread->DisarmPreemptionTimer();
         thread->pendingYield = false;
         thread->forceYield = false;
         YieldPending = false;
+
+        if (idle)
+            StealThread(*core); // The core would otherwise be left idle while threads could be waiting on other cores
     }
 
     void Scheduler::UpdatePriority(const std::shared_ptr<type::KThread> &thread) {
@@ -292,30 +561,40 @@ namespace skyline::kernel {
         auto *core{&cores.at(thread->coreId)};
         std::unique_lock coreLock(core->mutex);
 
-        auto currentIt{std::find(core->queue.begin(), core->queue.end(), thread)}, nextIt{std::next(currentIt)};
-        if (currentIt == core->queue.end()) {
+        if (!thread->isQueued)
             return;
-        } else if (currentIt == core->queue.begin()) {
-            // Alternatively, if it's currently running then we'd just want to yield if there's a higher priority thread to run instead
-            if (nextIt != core->queue.end() && (*nextIt)->priority < thread->priority) {
-                YieldThread(thread);
-            } else if (!thread->isPreempted && thread->priority == core->preemptionPriority) {
-                // If the thread needs to be preempted due to its new priority then arm its preemption timer
-                thread->ArmPreemptionTimer(PreemptiveTimeslice);
-            } else if (thread->isPreempted && thread->priority != core->preemptionPriority) {
-                // If the thread no longer needs to be preempted due to its new priority then disarm its preemption timer
-                thread->DisarmPreemptionTimer();
+
+        i8 priority{thread->priority};
+        auto front{core->Front()};
+        if (front == thread.get()) {
+            // If it's currently running then it should remain at the front of the queue unless there's a higher priority thread to run instead
+            core->Erase(thread.get());
+            auto nextThread{core->Front()};
+            if (nextThread && nextThread->schedulerPriority < priority) {
+                // The higher priority thread can be scheduled immediately, the thread is forcefully yielded and moved behind threads of its new priority as it would've been on rotation
+                core->PushBack(thread.get(), priority);
+                thread->forceYield = true;
+                YieldThread(thread.get());
+                WakeThread(nextThread);
+                return;
             }
-        } else if (thread->priority < (*std::prev(currentIt))->priority || (nextIt != core->queue.end() && thread->priority > (*nextIt)->priority)) {
-            // If the thread is in the queue and it's position is affected by the priority change then need to remove and re-insert the thread
-            core->queue.erase(currentIt);
-
-            auto targetIt{std::upper_bound(core->queue.begin(), core->queue.end(), thread->priority.load(), type::KThread::IsHigherPriority)};
-            if (targetIt == core->queue.begin() && targetIt != core->queue.end()) {
-                core->queue.insert(std::next(core->queue.begin()), thread);
-                YieldThread(core->queue.front());
+
+            core->PushFront(thread.get(), priority);
+            if (priority != core->preemptionPriority)
+                // If the thread no longer needs to be preempted due to its new priority then stop timing its timeslice
+                DisarmPreemption(thread.get());
+            else
+                // If the thread needs to be preempted due to its new priority then start timing its timeslice
+                ArmContendedPreemption(*core);
+        } else if (thread->schedulerPriority != priority) {
+            // If the thread is in the queue and its priority has changed then it needs to be moved into the queue for its new priority
+            core->Erase(thread.get());
+            if (priority < front->schedulerPriority) {
+                PreemptFront(*core, thread.get(), priority);
+                WakeThread(thread.get());
             } else {
-                core->queue.insert(targetIt, thread);
+                core->PushBack(thread.get(), priority);
+                ArmContendedPreemption(*core);
             }
         }
     }
@@ -323,10 +602,10 @@ namespace skyline::kernel {
     void Scheduler::UpdateCore(const std::shared_ptr<type::KThread> &thread) {
         auto *core{&cores.at(thread->coreId)};
         std::scoped_lock coreLock{core->mutex};
-        if (core->queue.front() == thread)
+        if (core->Front() == thread.get())
             thread->SendSignal(YieldSignal);
         else
-            thread->scheduleCondition.notify_one();
+            WakeThread(thread.get());
     }
 
     void Scheduler::ParkThread() {
@@ -336,14 +615,17 @@ namespace skyline::kernel {
 
         auto originalCoreId{thread->coreId};
         thread->coreId = constant::ParkedCoreId;
-        for (auto &core : cores)
-            if (originalCoreId != core.id && thread->affinityMask.test(core.id) && (core.queue.empty() || core.queue.front()->priority > thread->priority))
+        for (auto &core : cores) {
+            // The highest occupied priority of a core is the priority of the thread running on it, this avoids locking the core
+            u64 occupancy{core.occupancy.load(std::memory_order_relaxed)};
+            if (originalCoreId != core.id && thread->affinityMask.test(core.id) && (!occupancy || std::countr_zero(occupancy) > thread->priority))
                 thread->coreId = core.id;
+        }
 
         if (thread->coreId == constant::ParkedCoreId) {
             std::unique_lock lock(parkedMutex);
             parkedQueue.insert(std::upper_bound(parkedQueue.begin(), parkedQueue.end(), thread->priority.load(), type::KThread::IsHigherPriority), thread);
-            thread->scheduleCondition.wait(lock, [&]() { return parkedQueue.front() == thread && thread->coreId != constant::ParkedCoreId; });
+            WaitForWake(thread.get(), lock, std::chrono::nanoseconds::max(), [&]() { return parkedQueue.front() == thread && thread->coreId != constant::ParkedCoreId; });
         }
 
         InsertThread(thread);
@@ -355,8 +637,9 @@ namespace skyline::kernel {
             auto &thread{state.thread};
             auto &core{cores.at(thread->coreId)};
             std::unique_lock coreLock(core.mutex);
-            auto nextThread{core.queue.size() > 1 ? *std::next(core.queue.begin()) : nullptr};
-            nextThread = nextThread->priority == thread->priority ? nextThread : nullptr; // If the next thread doesn't have the same priority then it won't be scheduled next
+            auto front{core.Front()};
+            auto nextThread{front ? front->schedulerNext : nullptr};
+            nextThread = nextThread && nextThread->schedulerPriority == thread->priority ? nextThread : nullptr; // If the next thread doesn't have the same priority then it won't be scheduled next
             auto parkedThread{parkedQueue.front()};
 
             // We need to be conservative about waking up a parked thread, it should only be done if its priority is higher than the current thread
@@ -364,7 +647,7 @@ namespace skyline::kernel {
             if (parkedThread->priority < thread->priority || (parkedThread->priority == thread->priority && (!nextThread || parkedThread->timesliceStart < nextThread->timesliceStart))) {
                 parkedThread->coreId = thread->coreId;
                 parkedLock.unlock();
-                parkedThread->scheduleCondition.notify_one();
+                WakeThread(parkedThread.get());
             }
         }
     }
@@ -375,18 +658,19 @@ namespace skyline::kernel {
 
         thread->isPaused = true;
 
-        auto it{std::find(core->queue.begin(), core->queue.end(), thread)};
-        if (it != core->queue.end()) {
+        if (thread->isQueued) {
             thread->insertThreadOnResume = true; // If we're handling removing the thread then we need to be responsible for inserting it back inside ResumeThread
 
-            it = core->queue.erase(it);
-            if (it == core->queue.begin() && it != core->queue.end())
-                (*it)->scheduleCondition.notify_one();
+            bool wasFront{core->Front() == thread.get()};
+            core->Erase(thread.get());
+            if (wasFront) {
+                if (auto front{core->Front()})
+                    WakeThread(front);
 
-            if (it == core->queue.begin()) {
                 // We need to send a yield signal to the thread if it's currently running
-                YieldThread(thread);
+                YieldThread(thread.get());
                 thread->forceYield = true;
+                DisarmPreemption(thread.get());
             }
         } else {
             // If removal of the thread was performed by a lock/sleep/etc then we don't need to handle inserting it back ourselves inside ResumeThread
@@ -402,6 +686,6 @@ namespace skyline::kernel {
             InsertThread(thread);
         else
             // If we're not inserting the thread back into the queue ourselves then we need to notify the thread inserting it about the updated pause state
-            thread->scheduleCondition.notify_one();
+            WakeThread(thread.get());
     }
 }
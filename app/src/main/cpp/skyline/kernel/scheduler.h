@@ -5,6 +5,8 @@
 
 #include <common.h>
 #include <condition_variable>
+#include <common/host_topology.h>
+#include <common/spin_lock.h>
 
 namespace skyline {
     namespace constant {
@@ -43,18 +45,63 @@ namespace skyline {
           private:
             const DeviceState &state;
 
+            /**
+             * @brief An intrusive queue of threads with the same priority, these are linked through KThread::schedulerPrev/schedulerNext
+             */
+            struct ThreadQueue {
+                type::KThread *front{};
+                type::KThread *back{};
+            };
+
+            /**
+             * @note The threads resident on a core are held in a queue per priority alongside a bitmap of which of these are occupied, this allows for determining the thread which should run next along with insertion and removal in constant time
+             * @note The thread at the front of the highest priority occupied queue is the one which is currently running on the core
+             */
             struct CoreContext {
+                static constexpr size_t PriorityCount{std::numeric_limits<u64>::digits}; //!< The amount of distinct priorities, this corresponds to the bits in Priority::Mask
+
                 u8 id;
                 i8 preemptionPriority; //!< The priority at which this core becomes preemptive as opposed to cooperative
-                std::mutex mutex; //!< Synchronizes all operations on the queue
-                std::list<std::shared_ptr<type::KThread>> queue; //!< A queue of threads which are running or to be run on this core
+                AdaptiveMutex mutex; //!< Synchronizes all operations on the queues
+                std::array<ThreadQueue, PriorityCount> queues{}; //!< Queues of threads which are running or to be run on this core for every priority
+                std::atomic<u64> occupancy{}; //!< A bitmask of which priorities have threads in their queue, this is only modified with the core mutex held but may be read without it
+                std::atomic<u64> load{}; //!< The sum of the estimated timeslices of all threads resident on this core in host ticks, this is used for load balancing without locking the core
+                std::atomic<u32> threadCount{}; //!< The amount of threads resident on this core
+                type::KThread *preemptionTarget{}; //!< The preemptive thread whose timeslice is being timed on this core, this is synchronized by Scheduler::preemptionMutex
+                i64 preemptionDeadline{}; //!< The time in nanoseconds (See util::GetTimeNs) at which the timeslice of the target expires
 
                 CoreContext(u8 id, i8 preemptionPriority);
+
+                /**
+                 * @return The thread which is running or should be run on this core, this is nullptr if there are no threads resident on the core
+                 */
+                type::KThread *Front() const;
+
+                /**
+                 * @brief Inserts the thread at the back of the queue for the supplied priority, it'll only be scheduled after all other threads with an equal or higher priority
+                 */
+                void PushBack(type::KThread *thread, i8 priority);
+
+                /**
+                 * @brief Inserts the thread at the front of the queue for the supplied priority
+                 */
+                void PushFront(type::KThread *thread, i8 priority);
+
+                /**
+                 * @brief Removes the thread from the queue of its priority, the thread must be in one of this core's queues
+                 */
+                void Erase(type::KThread *thread);
             };
 
             std::array<CoreContext, constant::CoreCount> cores{CoreContext(0, 59), CoreContext(1, 59), CoreContext(2, 59), CoreContext(3, 63)};
+            static constexpr std::array<host::AffinityClass, constant::CoreCount> CoreAffinity{host::AffinityClass::Performance, host::AffinityClass::Performance, host::AffinityClass::Performance, host::AffinityClass::Efficiency}; //!< The class of host cores that threads resident on each guest core are pinned to, the application cores are mapped to the fastest host cores while the system core is mapped to the slowest ones
+
+            std::mutex preemptionMutex; //!< Synchronizes the preemption state of all cores
+            std::condition_variable preemptionCondition; //!< Signalled when the preemption state of a core changes or the preemption thread should exit
+            bool preemptionExit{}; //!< If the preemption thread should exit
+            std::thread preemptionThread; //!< A single thread which times the timeslices of preemptive threads on all cores and preempts them on expiry, it only wakes up for armed deadlines
 
-            std::mutex parkedMutex; //!< Synchronizes all operations on the queue of parked threads
+            AdaptiveMutex parkedMutex; //!< Synchronizes all operations on the queue of parked threads
             std::list<std::shared_ptr<type::KThread>> parkedQueue; //!< A queue of threads which are parked and waiting on core migration
 
             /**
@@ -62,12 +109,73 @@ namespace skyline {
              * @note 'KThread::coreMigrationMutex' **must** be locked by the calling thread prior to calling this
              * @note This is used to handle non-cooperative core affinity mask changes where the resident core is not in its new affinity mask
              */
-            void MigrateToCore(const std::shared_ptr<type::KThread> &thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<std::mutex> &lock);
+            void MigrateToCore(const std::shared_ptr<type::KThread> &thread, CoreContext *&currentCore, CoreContext *targetCore, std::unique_lock<AdaptiveMutex> &lock);
 
             /**
              * @brief Trigger a thread to yield via a signal or on SVC exit if it is the current thread
              */
-            void YieldThread(const std::shared_ptr<type::KThread> &thread);
+            void YieldThread(type::KThread *thread);
+
+            /**
+             * @brief Inserts the supplied thread at the front of the core's queues and forcefully yields the thread which was running prior to it
+             * @note The supplied thread must have a higher priority than the thread at the front of the core's queues and the core mutex must be held
+             */
+            void PreemptFront(CoreContext &core, type::KThread *thread, i8 priority);
+
+            /**
+             * @brief Wakes the supplied thread if it's waiting on its schedule futex, this should be called after modifying any state its wait predicate depends on
+             * @note This directly hands off to the woken thread without going through a condition variable, a syscall is only made if the thread is sleeping rather than spinning
+             */
+            static void WakeThread(type::KThread *thread);
+
+            /**
+             * @brief Pins the calling thread to the host cores corresponding to the guest core it's being scheduled on, this is only done if its pinning has changed
+             */
+            void PinToHostCores(u8 coreId);
+
+            /**
+             * @brief Starts timing the timeslice of the thread running on the core if it's preemptive and another thread of the same priority contends with it, this is a no-op if it's already being timed
+             * @note A preemptive thread without any contending threads would be rescheduled immediately after being preempted, so no timer is armed for it
+             * @note The core mutex must be held by the calling thread
+             */
+            void ArmContendedPreemption(CoreContext &core);
+
+            /**
+             * @brief Stops timing the timeslice of the supplied thread, this is a no-op if it isn't being timed
+             * @note The mutex of the core the thread is resident on must be held by the calling thread
+             */
+            void DisarmPreemption(type::KThread *thread);
+
+            /**
+             * @brief The entry point of the preemption thread, this sleeps till the earliest armed deadline and signals the corresponding thread once it has expired
+             */
+            void RunPreemptionThread();
+
+            /**
+             * @brief Locks the mutex of the supplied thread's resident core, this accounts for the resident core being concurrently changed by another core stealing the thread
+             * @param core The resident core of the thread, this is set prior to returning
+             */
+            std::unique_lock<AdaptiveMutex> LockResidentCore(type::KThread *thread, CoreContext *&core);
+
+            /**
+             * @brief Switches the supplied core and lock over to the thread's resident core if it was changed by another core stealing the thread
+             * @note This must be called with the lock held, it'll still be held on returning
+             */
+            void FollowResidentCore(type::KThread *thread, CoreContext *&core, std::unique_lock<AdaptiveMutex> &lock);
+
+            /**
+             * @brief Steals a thread waiting to be scheduled from the busiest core onto the supplied idle core, cores are tried in order of their load till an eligible thread is found
+             * @note Only threads which aren't running and have the idle core in their affinity mask are eligible, no core mutexes should be held by the calling thread
+             */
+            void StealThread(CoreContext &idleCore);
+
+            /**
+             * @brief Waits on the calling thread's schedule futex till the predicate is satisfied or the timeout expires, this is analogous to std::condition_variable::wait_for
+             * @param lock The lock protecting the state the predicate depends on, it's held while the predicate is evaluated and may be swapped out by it
+             * @return The result of the predicate, this will only be false if the timeout expired
+             */
+            template<typename Lock, typename Predicate>
+            static bool WaitForWake(type::KThread *thread, Lock &lock, std::chrono::nanoseconds timeout, Predicate &&predicate);
 
           public:
             static constexpr std::chrono::milliseconds PreemptiveTimeslice{10}; //!< The duration of time a preemptive thread can run before yielding
@@ -77,13 +185,15 @@ namespace skyline {
 
             Scheduler(const DeviceState &state);
 
+            ~Scheduler();
+
             /**
              * @brief A signal handler designed to cause a non-cooperative yield for preemption and higher priority threads being inserted
              */
             static void SignalHandler(int signal, siginfo *info, ucontext *ctx, void **tls);
 
             /**
-             * @brief Checks all cores and determines the core where the supplied thread should be scheduled the earliest
+             * @brief Checks the load of all cores and determines the core where the supplied thread should be scheduled the earliest
              * @note 'KThread::coreMigrationMutex' **must** be locked by the calling thread prior to calling this
              * @note No core mutexes should be held by the calling thread, that will cause a recursive lock and lead to a deadlock
              * @return A reference to the CoreContext of the optimal core
@@ -121,6 +231,12 @@ namespace skyline {
              */
             void RemoveThread();
 
+            /**
+             * @return The threads which are running or will run next on every core
+             * @note This is only a snapshot, threads may have been rescheduled by the time it's returned
+             */
+            std::vector<std::shared_ptr<type::KThread>> GetScheduledThreads();
+
             /**
              * @brief Updates the placement of the supplied thread in its resident core's queue according to its current priority
              */
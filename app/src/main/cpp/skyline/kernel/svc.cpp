@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <sys/prctl.h>
+#include <boost/container/static_vector.hpp>
 #include <os.h>
 #include <nce.h>
 #include <kernel/types/KProcess.h>
@@ -22,7 +24,10 @@ namespace skyline::kernel::svc {
         }
 
         auto &heap{state.process->heap};
+        auto oldSize{heap->guest.size()};
         heap->Resize(size);
+        if (size > oldSize)
+            state.process->memory.Prefault(heap->guest.subspan(oldSize));
 
         state.ctx->gpr.w0 = Result{};
         state.ctx->gpr.x1 = reinterpret_cast<u64>(heap->guest.data());
@@ -265,15 +270,16 @@ namespace skyline::kernel::svc {
 
     void StartThread(const DeviceState &state) {
         KHandle handle{state.ctx->gpr.w0};
-        try {
-            auto thread{state.process->GetHandle<type::KThread>(handle)};
-            Logger::Debug("Starting thread #{}: 0x{:X}", thread->id, handle);
-            thread->Start();
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
+        auto thread{state.process->TryGetHandle<type::KThread>(handle)};
+        if (!thread) [[unlikely]] {
             Logger::Warn("'handle' invalid: 0x{:X}", handle);
             state.ctx->gpr.w0 = result::InvalidHandle;
+            return;
         }
+
+        Logger::Debug("Starting thread #{}: 0x{:X}", thread->id, handle);
+        thread->Start();
+        state.ctx->gpr.w0 = Result{};
     }
 
     void ExitThread(const DeviceState &state) {
@@ -281,6 +287,41 @@ namespace skyline::kernel::svc {
         throw nce::NCE::ExitException(false);
     }
 
+    namespace {
+        constexpr i64 SleepSpinDuration{30000}; //!< The duration prior to the deadline of a sleep in nanoseconds that's spun for rather than slept through, this covers the latency of the host waking the thread up
+
+        i64 GetMonotonicTimeNs() {
+            struct timespec spec;
+            clock_gettime(CLOCK_MONOTONIC, &spec);
+            return static_cast<i64>(spec.tv_sec) * constant::NsInSecond + spec.tv_nsec;
+        }
+
+        /**
+         * @brief Sleeps till the supplied CLOCK_MONOTONIC deadline as precisely as possible
+         * @details The timer slack of the thread is minimized so the kernel doesn't coalesce the wakeup with other timers, the sleep targets an absolute deadline so it's resumed correctly after being interrupted by a signal and the final stretch is spun for to hide the wakeup latency
+         */
+        void PreciseSleepUntil(i64 deadline) {
+            [[maybe_unused]] thread_local bool timerSlackSet{[] {
+                // Android defaults to a timer slack of 50us for all threads, which is later than most precise sleeps can tolerate
+                if (prctl(PR_SET_TIMERSLACK, 1))
+                    Logger::Warn("Failed to set the timer slack: {}", strerror(errno));
+                return true;
+            }()};
+
+            i64 sleepDeadline{deadline - SleepSpinDuration};
+            if (sleepDeadline > GetMonotonicTimeNs()) {
+                struct timespec spec{
+                    .tv_sec = static_cast<time_t>(sleepDeadline / constant::NsInSecond),
+                    .tv_nsec = static_cast<long>(sleepDeadline % constant::NsInSecond),
+                };
+                while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &spec, nullptr) == EINTR);
+            }
+
+            while (GetMonotonicTimeNs() < deadline)
+                asm volatile("yield");
+        }
+    }
+
     void SleepThread(const DeviceState &state) {
         constexpr i64 yieldWithoutCoreMigration{0};
         constexpr i64 yieldWithCoreMigration{-1};
@@ -291,13 +332,12 @@ namespace skyline::kernel::svc {
             Logger::Debug("Sleeping for {}ns", in);
             TRACE_EVENT("kernel", "SleepThread", "duration", in);
 
-            struct timespec spec{
-                .tv_sec = static_cast<time_t>(in / 1000000000),
-                .tv_nsec = static_cast<long>(in % 1000000000),
-            };
+            // The deadline is calculated prior to releasing the core so the time spent rescheduling doesn't extend the sleep
+            i64 now{GetMonotonicTimeNs()};
+            i64 deadline{in < std::numeric_limits<i64>::max() - now ? now + in : std::numeric_limits<i64>::max()};
 
             SchedulerScopedLock schedulerLock(state);
-            nanosleep(&spec, nullptr);
+            PreciseSleepUntil(deadline);
         } else {
             switch (in) {
                 case yieldWithCoreMigration: {
@@ -331,123 +371,120 @@ namespace skyline::kernel::svc {
         }
     }
 
-    void GetThreadPriority(const DeviceState &state) {
-        KHandle handle{state.ctx->gpr.w1};
-        try {
-            auto thread{state.process->GetHandle<type::KThread>(handle)};
-            i8 priority{thread->priority};
-            Logger::Debug("Retrieving thread #{}'s priority: {}", thread->id, priority);
-
-            state.ctx->gpr.w1 = static_cast<u32>(priority);
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
+    Result GetThreadPriority(const DeviceState &state, u32 &outPriority, KHandle handle) {
+        auto thread{state.process->TryGetHandle<type::KThread>(handle)};
+        if (!thread) [[unlikely]] {
             Logger::Warn("'handle' invalid: 0x{:X}", handle);
-            state.ctx->gpr.w0 = result::InvalidHandle;
+            return result::InvalidHandle;
         }
+
+        i8 priority{thread->priority};
+        Logger::Debug("Retrieving thread #{}'s priority: {}", thread->id, priority);
+
+        outPriority = static_cast<u32>(priority);
+        return {};
     }
 
-    void SetThreadPriority(const DeviceState &state) {
-        KHandle handle{state.ctx->gpr.w0};
-        i8 priority{static_cast<i8>(state.ctx->gpr.w1)};
+    Result SetThreadPriority(const DeviceState &state, KHandle handle, i8 priority) {
         if (!state.process->npdm.threadInfo.priority.Valid(priority)) {
             Logger::Warn("'priority' invalid: 0x{:X}", priority);
-            state.ctx->gpr.w0 = result::InvalidPriority;
-            return;
+            return result::InvalidPriority;
         }
-        try {
-            auto thread{state.process->GetHandle<type::KThread>(handle)};
-            Logger::Debug("Setting thread #{}'s priority to {}", thread->id, priority);
-            if (thread->priority != priority) {
-                thread->basePriority = priority;
-                i8 newPriority{};
-                do {
-                    // Try to CAS the priority of the thread with its new base priority
-                    // If the new priority is equivalent to the current priority then we don't need to CAS
-                    newPriority = thread->priority.load();
-                    newPriority = std::min(newPriority, priority);
-                } while (newPriority != priority && !thread->priority.compare_exchange_strong(newPriority, priority));
-                state.scheduler->UpdatePriority(thread);
-                thread->UpdatePriorityInheritance();
-            }
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
+        auto thread{state.process->TryGetHandle<type::KThread>(handle)};
+        if (!thread) [[unlikely]] {
             Logger::Warn("'handle' invalid: 0x{:X}", handle);
-            state.ctx->gpr.w0 = result::InvalidHandle;
-        }
+            return result::InvalidHandle;
+        }
+
+        Logger::Debug("Setting thread #{}'s priority to {}", thread->id, priority);
+        if (thread->priority != priority) {
+            thread->basePriority = priority;
+            i8 newPriority{};
+            do {
+                // Try to CAS the priority of the thread with its new base priority
+                // If the new priority is equivalent to the current priority then we don't need to CAS
+                newPriority = thread->priority.load();
+                newPriority = std::min(newPriority, priority);
+            } while (newPriority != priority && !thread->priority.compare_exchange_strong(newPriority, priority));
+            state.scheduler->UpdatePriority(thread);
+            thread->UpdatePriorityInheritance();
+        }
+        return {};
     }
 
     void GetThreadCoreMask(const DeviceState &state) {
         KHandle handle{state.ctx->gpr.w2};
-        try {
-            auto thread{state.process->GetHandle<type::KThread>(handle)};
-            auto idealCore{thread->idealCore};
-            auto affinityMask{thread->affinityMask};
-            Logger::Debug("Getting thread #{}'s Ideal Core ({}) + Affinity Mask ({})", thread->id, idealCore, affinityMask);
-
-            state.ctx->gpr.x2 = affinityMask.to_ullong();
-            state.ctx->gpr.w1 = static_cast<u32>(idealCore);
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
+        auto thread{state.process->TryGetHandle<type::KThread>(handle)};
+        if (!thread) [[unlikely]] {
             Logger::Warn("'handle' invalid: 0x{:X}", handle);
             state.ctx->gpr.w0 = result::InvalidHandle;
+            return;
         }
+
+        auto idealCore{thread->idealCore};
+        auto affinityMask{thread->affinityMask};
+        Logger::Debug("Getting thread #{}'s Ideal Core ({}) + Affinity Mask ({})", thread->id, idealCore, affinityMask);
+
+        state.ctx->gpr.x2 = affinityMask.to_ullong();
+        state.ctx->gpr.w1 = static_cast<u32>(idealCore);
+        state.ctx->gpr.w0 = Result{};
     }
 
     void SetThreadCoreMask(const DeviceState &state) {
         KHandle handle{state.ctx->gpr.w0};
         i32 idealCore{static_cast<i32>(state.ctx->gpr.w1)};
         CoreMask affinityMask{state.ctx->gpr.x2};
-        try {
-            auto thread{state.process->GetHandle<type::KThread>(handle)};
-
-            if (idealCore == IdealCoreUseProcessValue) {
-                idealCore = state.process->npdm.meta.idealCore;
-                affinityMask.reset().set(static_cast<size_t>(idealCore));
-            } else if (idealCore == IdealCoreNoUpdate) {
-                idealCore = thread->idealCore;
-            } else if (idealCore == IdealCoreDontCare) {
-                idealCore = std::countr_zero(affinityMask.to_ullong()); // The first enabled core in the affinity mask
-            }
+        auto thread{state.process->TryGetHandle<type::KThread>(handle)};
+        if (!thread) [[unlikely]] {
+            Logger::Warn("'handle' invalid: 0x{:X}", handle);
+            state.ctx->gpr.w0 = result::InvalidHandle;
+            return;
+        }
 
-            auto processMask{state.process->npdm.threadInfo.coreMask};
-            if ((processMask | affinityMask) != processMask) {
-                Logger::Warn("'affinityMask' invalid: {} (Process Mask: {})", affinityMask, processMask);
-                state.ctx->gpr.w0 = result::InvalidCoreId;
-                return;
-            }
+        if (idealCore == IdealCoreUseProcessValue) {
+            idealCore = state.process->npdm.meta.idealCore;
+            affinityMask.reset().set(static_cast<size_t>(idealCore));
+        } else if (idealCore == IdealCoreNoUpdate) {
+            idealCore = thread->idealCore;
+        } else if (idealCore == IdealCoreDontCare) {
+            idealCore = std::countr_zero(affinityMask.to_ullong()); // The first enabled core in the affinity mask
+        }
 
-            if (affinityMask.none() || !affinityMask.test(static_cast<size_t>(idealCore))) {
-                Logger::Warn("'affinityMask' invalid: {} (Ideal Core: {})", affinityMask, idealCore);
-                state.ctx->gpr.w0 = result::InvalidCombination;
-                return;
-            }
+        auto processMask{state.process->npdm.threadInfo.coreMask};
+        if ((processMask | affinityMask) != processMask) {
+            Logger::Warn("'affinityMask' invalid: {} (Process Mask: {})", affinityMask, processMask);
+            state.ctx->gpr.w0 = result::InvalidCoreId;
+            return;
+        }
 
-            Logger::Debug("Setting thread #{}'s Ideal Core ({}) + Affinity Mask ({})", thread->id, idealCore, affinityMask);
+        if (affinityMask.none() || !affinityMask.test(static_cast<size_t>(idealCore))) {
+            Logger::Warn("'affinityMask' invalid: {} (Ideal Core: {})", affinityMask, idealCore);
+            state.ctx->gpr.w0 = result::InvalidCombination;
+            return;
+        }
 
-            std::scoped_lock guard{thread->coreMigrationMutex};
-            thread->idealCore = static_cast<u8>(idealCore);
-            thread->affinityMask = affinityMask;
+        Logger::Debug("Setting thread #{}'s Ideal Core ({}) + Affinity Mask ({})", thread->id, idealCore, affinityMask);
 
-            if (!affinityMask.test(static_cast<size_t>(thread->coreId)) && thread->coreId != constant::ParkedCoreId) {
-                Logger::Debug("Migrating thread #{} to Ideal Core C{} -> C{}", thread->id, thread->coreId, idealCore);
+        std::scoped_lock guard{thread->coreMigrationMutex};
+        thread->idealCore = static_cast<u8>(idealCore);
+        thread->affinityMask = affinityMask;
 
-                if (thread == state.thread) {
-                    state.scheduler->RemoveThread();
-                    thread->coreId = static_cast<u8>(idealCore);
-                    state.scheduler->InsertThread(state.thread);
-                    state.scheduler->WaitSchedule();
-                } else if (!thread->running) {
-                    thread->coreId = static_cast<u8>(idealCore);
-                } else {
-                    state.scheduler->UpdateCore(thread);
-                }
-            }
+        if (!affinityMask.test(static_cast<size_t>(thread->coreId)) && thread->coreId != constant::ParkedCoreId) {
+            Logger::Debug("Migrating thread #{} to Ideal Core C{} -> C{}", thread->id, thread->coreId, idealCore);
 
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
-            Logger::Warn("'handle' invalid: 0x{:X}", handle);
-            state.ctx->gpr.w0 = result::InvalidHandle;
+            if (thread == state.thread) {
+                state.scheduler->RemoveThread();
+                thread->coreId = static_cast<u8>(idealCore);
+                state.scheduler->InsertThread(state.thread);
+                state.scheduler->WaitSchedule();
+            } else if (!thread->running) {
+                thread->coreId = static_cast<u8>(idealCore);
+            } else {
+                state.scheduler->UpdateCore(thread);
+            }
         }
+
+        state.ctx->gpr.w0 = Result{};
     }
 
     void GetCurrentProcessorNumber(const DeviceState &state) {
@@ -457,85 +494,84 @@ namespace skyline::kernel::svc {
         state.ctx->gpr.w0 = coreId;
     }
 
-    void ClearEvent(const DeviceState &state) {
-        KHandle handle{state.ctx->gpr.w0};
+    Result ClearEvent(const DeviceState &state, KHandle handle) {
         TRACE_EVENT_FMT("kernel", "ClearEvent 0x{:X}", handle);
-        try {
-            std::static_pointer_cast<type::KEvent>(state.process->GetHandle(handle))->ResetSignal();
-            Logger::Debug("Clearing 0x{:X}", handle);
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
+        auto event{state.process->TryGetHandle<type::KEvent>(handle)};
+        if (!event) [[unlikely]] {
             Logger::Warn("'handle' invalid: 0x{:X}", handle);
-            state.ctx->gpr.w0 = result::InvalidHandle;
-            return;
+            return result::InvalidHandle;
         }
+
+        event->ResetSignal();
+        Logger::Debug("Clearing 0x{:X}", handle);
+        return {};
     }
 
     void MapSharedMemory(const DeviceState &state) {
-        try {
-            KHandle handle{state.ctx->gpr.w0};
-            auto object{state.process->GetHandle<type::KSharedMemory>(handle)};
-            auto pointer{reinterpret_cast<u8 *>(state.ctx->gpr.x1)};
-
-            if (!util::IsPageAligned(pointer)) {
-                state.ctx->gpr.w0 = result::InvalidAddress;
-                Logger::Warn("'pointer' not page aligned: 0x{:X}", pointer);
-                return;
-            }
+        KHandle handle{state.ctx->gpr.w0};
+        auto object{state.process->TryGetHandle<type::KSharedMemory>(handle)};
+        if (!object) [[unlikely]] {
+            Logger::Warn("'handle' invalid: 0x{:X}", handle);
+            state.ctx->gpr.w0 = result::InvalidHandle;
+            return;
+        }
+        auto pointer{reinterpret_cast<u8 *>(state.ctx->gpr.x1)};
 
-            size_t size{state.ctx->gpr.x2};
-            if (!util::IsPageAligned(size)) {
-                state.ctx->gpr.w0 = result::InvalidSize;
-                Logger::Warn("'size' {}: 0x{:X}", size ? "not page aligned" : "is zero", size);
-                return;
-            }
+        if (!util::IsPageAligned(pointer)) {
+            state.ctx->gpr.w0 = result::InvalidAddress;
+            Logger::Warn("'pointer' not page aligned: 0x{:X}", pointer);
+            return;
+        }
 
-            memory::Permission permission(static_cast<u8>(state.ctx->gpr.w3));
-            if ((permission.w && !permission.r) || (permission.x && !permission.r)) {
-                Logger::Warn("'permission' invalid: {}{}{}", permission.r ? 'R' : '-', permission.w ? 'W' : '-', permission.x ? 'X' : '-');
-                state.ctx->gpr.w0 = result::InvalidNewMemoryPermission;
-                return;
-            }
+        size_t size{state.ctx->gpr.x2};
+        if (!util::IsPageAligned(size)) {
+            state.ctx->gpr.w0 = result::InvalidSize;
+            Logger::Warn("'size' {}: 0x{:X}", size ? "not page aligned" : "is zero", size);
+            return;
+        }
 
-            Logger::Debug("Mapping shared memory (0x{:X}) at 0x{:X} - 0x{:X} (0x{:X} bytes) ({}{}{})", handle, pointer, pointer + size, size, permission.r ? 'R' : '-', permission.w ? 'W' : '-', permission.x ? 'X' : '-');
+        memory::Permission permission(static_cast<u8>(state.ctx->gpr.w3));
+        if ((permission.w && !permission.r) || (permission.x && !permission.r)) {
+            Logger::Warn("'permission' invalid: {}{}{}", permission.r ? 'R' : '-', permission.w ? 'W' : '-', permission.x ? 'X' : '-');
+            state.ctx->gpr.w0 = result::InvalidNewMemoryPermission;
+            return;
+        }
 
-            object->Map(span<u8>{pointer, size}, permission);
+        Logger::Debug("Mapping shared memory (0x{:X}) at 0x{:X} - 0x{:X} (0x{:X} bytes) ({}{}{})", handle, pointer, pointer + size, size, permission.r ? 'R' : '-', permission.w ? 'W' : '-', permission.x ? 'X' : '-');
 
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
-            Logger::Warn("'handle' invalid: 0x{:X}", static_cast<u32>(state.ctx->gpr.w0));
-            state.ctx->gpr.w0 = result::InvalidHandle;
-        }
+        object->Map(span<u8>{pointer, size}, permission);
+
+        state.ctx->gpr.w0 = Result{};
     }
 
     void UnmapSharedMemory(const DeviceState &state) {
-        try {
-            KHandle handle{state.ctx->gpr.w0};
-            auto object{state.process->GetHandle<type::KSharedMemory>(handle)};
-            auto pointer{reinterpret_cast<u8 *>(state.ctx->gpr.x1)};
-
-            if (!util::IsPageAligned(pointer)) {
-                state.ctx->gpr.w0 = result::InvalidAddress;
-                Logger::Warn("'pointer' not page aligned: 0x{:X}", pointer);
-                return;
-            }
+        KHandle handle{state.ctx->gpr.w0};
+        auto object{state.process->TryGetHandle<type::KSharedMemory>(handle)};
+        if (!object) [[unlikely]] {
+            Logger::Warn("'handle' invalid: 0x{:X}", handle);
+            state.ctx->gpr.w0 = result::InvalidHandle;
+            return;
+        }
+        auto pointer{reinterpret_cast<u8 *>(state.ctx->gpr.x1)};
 
-            size_t size{state.ctx->gpr.x2};
-            if (!util::IsPageAligned(size)) {
-                state.ctx->gpr.w0 = result::InvalidSize;
-                Logger::Warn("'size' {}: 0x{:X}", size ? "not page aligned" : "is zero", size);
-                return;
-            }
+        if (!util::IsPageAligned(pointer)) {
+            state.ctx->gpr.w0 = result::InvalidAddress;
+            Logger::Warn("'pointer' not page aligned: 0x{:X}", pointer);
+            return;
+        }
+
+        size_t size{state.ctx->gpr.x2};
+        if (!util::IsPageAligned(size)) {
+            state.ctx->gpr.w0 = result::InvalidSize;
+            Logger::Warn("'size' {}: 0x{:X}", size ? "not page aligned" : "is zero", size);
+            return;
+        }
 
-            Logger::Debug("Unmapping shared memory (0x{:X}) at 0x{:X} - 0x{:X} (0x{:X} bytes)", handle, pointer, pointer + size, size);
+        Logger::Debug("Unmapping shared memory (0x{:X}) at 0x{:X} - 0x{:X} (0x{:X} bytes)", handle, pointer, pointer + size, size);
 
-            object->Unmap(span<u8>{pointer, size});
+        object->Unmap(span<u8>{pointer, size});
 
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
-            Logger::Warn("'handle' invalid: 0x{:X}", static_cast<u32>(state.ctx->gpr.w0));
-            state.ctx->gpr.w0 = result::InvalidHandle;
-        }
+        state.ctx->gpr.w0 = Result{};
     }
 
     void CreateTransferMemory(const DeviceState &state) {
@@ -567,60 +603,55 @@ namespace skyline::kernel::svc {
         state.ctx->gpr.w1 = tmem.handle;
     }
 
-    void CloseHandle(const DeviceState &state) {
-        KHandle handle{static_cast<KHandle>(state.ctx->gpr.w0)};
-        try {
-            state.process->CloseHandle(handle);
-            Logger::Debug("Closing 0x{:X}", handle);
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
+    Result CloseHandle(const DeviceState &state, KHandle handle) {
+        if (!state.process->CloseHandle(handle)) [[unlikely]] {
             Logger::Warn("'handle' invalid: 0x{:X}", handle);
-            state.ctx->gpr.w0 = result::InvalidHandle;
+            return result::InvalidHandle;
         }
+
+        Logger::Debug("Closing 0x{:X}", handle);
+        return {};
     }
 
-    void ResetSignal(const DeviceState &state) {
-        KHandle handle{state.ctx->gpr.w0};
+    Result ResetSignal(const DeviceState &state, KHandle handle) {
         TRACE_EVENT_FMT("kernel", "ResetSignal 0x{:X}", handle);
-        try {
-            auto object{state.process->GetHandle(handle)};
-            switch (object->objectType) {
-                case type::KType::KEvent:
-                case type::KType::KProcess:
-                    state.ctx->gpr.w0 = std::static_pointer_cast<type::KSyncObject>(object)->ResetSignal() ? Result{} : result::InvalidState;
-                    break;
-
-                default: {
-                    Logger::Warn("'handle' type invalid: 0x{:X} ({})", handle, object->objectType);
-                    state.ctx->gpr.w0 = result::InvalidHandle;
-                    return;
-                }
-            }
-
-            Logger::Debug("Resetting 0x{:X}", handle);
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
+        auto object{state.process->TryGetHandle(handle)};
+        if (!object) [[unlikely]] {
             Logger::Warn("'handle' invalid: 0x{:X}", handle);
-            state.ctx->gpr.w0 = result::InvalidHandle;
-            return;
+            return result::InvalidHandle;
         }
-    }
 
-    void WaitSynchronization(const DeviceState &state) {
-        constexpr u8 MaxSyncHandles{0x40}; // The total amount of handles that can be passed to WaitSynchronization
+        switch (object->objectType) {
+            case type::KType::KEvent:
+            case type::KType::KProcess:
+                if (!std::static_pointer_cast<type::KSyncObject>(object)->ResetSignal())
+                    return result::InvalidState;
+                break;
 
-        u32 numHandles{state.ctx->gpr.w2};
-        if (numHandles > MaxSyncHandles) {
-            state.ctx->gpr.w0 = result::OutOfRange;
-            return;
+            default: {
+                Logger::Warn("'handle' type invalid: 0x{:X} ({})", handle, object->objectType);
+                return result::InvalidHandle;
+            }
         }
 
-        span waitHandles(reinterpret_cast<KHandle *>(state.ctx->gpr.x1), numHandles);
-        std::vector<std::shared_ptr<type::KSyncObject>> objectTable;
-        objectTable.reserve(numHandles);
+        Logger::Debug("Resetting 0x{:X}", handle);
+        return {};
+    }
+
+    Result WaitSynchronization(const DeviceState &state, u32 &wakeIndex, KHandle *handles, u32 numHandles, i64 timeout) {
+        if (numHandles > type::KSyncObject::MaxSyncHandles)
+            return result::OutOfRange;
+
+        span waitHandles(handles, numHandles);
+        boost::container::static_vector<std::shared_ptr<type::KSyncObject>, type::KSyncObject::MaxSyncHandles> objectTable;
 
         for (const auto &handle : waitHandles) {
-            auto object{state.process->GetHandle(handle)};
+            auto object{state.process->TryGetHandle(handle)};
+            if (!object) [[unlikely]] {
+                Logger::Warn("'handle' invalid: 0x{:X}", handle);
+                return result::InvalidHandle;
+            }
+
             switch (object->objectType) {
                 case type::KType::KProcess:
                 case type::KType::KThread:
@@ -631,13 +662,11 @@ namespace skyline::kernel::svc {
 
                 default: {
                     Logger::Debug("An invalid handle was supplied: 0x{:X}", handle);
-                    state.ctx->gpr.w0 = result::InvalidHandle;
-                    return;
+                    return result::InvalidHandle;
                 }
             }
         }
 
-        i64 timeout{static_cast<i64>(state.ctx->gpr.x3)};
         if (waitHandles.size() == 1) {
             Logger::Debug("Waiting on 0x{:X} for {}ns", waitHandles[0], timeout);
         } else if (Logger::LogLevel::Debug <= Logger::configLevel) {
@@ -649,33 +678,42 @@ namespace skyline::kernel::svc {
 
         TRACE_EVENT_FMT("kernel", waitHandles.size() == 1 ? "WaitSynchronization 0x{:X}" : "WaitSynchronizationMultiple 0x{:X}", waitHandles[0]);
 
+        auto findSignalled{[&]() -> bool {
+            for (u32 index{}; index < objectTable.size(); index++) {
+                if (objectTable[index]->signalled.load(std::memory_order_acquire)) {
+                    Logger::Debug("Signalled 0x{:X}", waitHandles[index]);
+                    wakeIndex = index;
+                    return true;
+                }
+            }
+            return false;
+        }};
+
+        // Most waits are on objects that are already signalled, these can be satisfied without serializing with any signalling
+        if (findSignalled())
+            return {};
+
         std::unique_lock lock(type::KSyncObject::syncObjectMutex);
+        if (findSignalled())
+            return {};
+
         if (state.thread->cancelSync) {
             state.thread->cancelSync = false;
-            state.ctx->gpr.w0 = result::Cancelled;
-            return;
-        }
-
-        u32 index{};
-        for (const auto &object : objectTable) {
-            if (object->signalled) {
-                Logger::Debug("Signalled 0x{:X}", waitHandles[index]);
-                state.ctx->gpr.w0 = Result{};
-                state.ctx->gpr.w1 = index;
-                return;
-            }
-            index++;
+            return result::Cancelled;
         }
 
         if (timeout == 0) {
             Logger::Debug("No handle is currently signalled");
-            state.ctx->gpr.w0 = result::TimedOut;
-            return;
+            return result::TimedOut;
         }
 
         auto priority{state.thread->priority.load()};
-        for (const auto &object : objectTable)
-            object->syncObjectWaiters.insert(std::upper_bound(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), priority, type::KThread::IsHigherPriority), state.thread);
+        for (u32 index{}; index < objectTable.size(); index++) {
+            auto &waiter{state.thread->syncWaiters[index]};
+            waiter.thread = state.thread.get();
+            waiter.priority = priority;
+            objectTable[index]->AddWaiter(waiter);
+        }
 
         state.thread->isCancellable = true;
         state.thread->wakeObject = nullptr;
@@ -691,67 +729,53 @@ namespace skyline::kernel::svc {
         state.thread->isCancellable = false;
         auto wakeObject{state.thread->wakeObject};
 
-        u32 wakeIndex{};
-        index = 0;
-        for (const auto &object : objectTable) {
-            if (object.get() == wakeObject)
+        for (u32 index{}; index < objectTable.size(); index++) {
+            if (objectTable[index].get() == wakeObject)
                 wakeIndex = index;
-
-            auto it{std::find(object->syncObjectWaiters.begin(), object->syncObjectWaiters.end(), state.thread)};
-            if (it != object->syncObjectWaiters.end())
-                object->syncObjectWaiters.erase(it);
-            else
-                throw exception("svcWaitSynchronization: An object (0x{:X}) has been removed from the syncObjectWaiters queue incorrectly", waitHandles[index]);
-
-            index++;
+            objectTable[index]->RemoveWaiter(state.thread->syncWaiters[index]);
         }
 
         if (wakeObject) {
             Logger::Debug("Signalled 0x{:X}", waitHandles[wakeIndex]);
-            state.ctx->gpr.w0 = Result{};
-            state.ctx->gpr.w1 = wakeIndex;
+            return {};
         } else if (state.thread->cancelSync) {
             state.thread->cancelSync = false;
             Logger::Debug("Wait has been cancelled");
-            state.ctx->gpr.w0 = result::Cancelled;
+            return result::Cancelled;
         } else {
             Logger::Debug("Wait has timed out");
-            state.ctx->gpr.w0 = result::TimedOut;
             lock.unlock();
             state.scheduler->InsertThread(state.thread);
             state.scheduler->WaitSchedule();
+            return result::TimedOut;
         }
     }
 
-    void CancelSynchronization(const DeviceState &state) {
-        try {
-            std::unique_lock lock(type::KSyncObject::syncObjectMutex);
-            auto thread{state.process->GetHandle<type::KThread>(state.ctx->gpr.w0)};
-            Logger::Debug("Cancelling Synchronization {}", thread->id);
-            thread->cancelSync = true;
-            if (thread->isCancellable) {
-                thread->isCancellable = false;
-                state.scheduler->InsertThread(thread);
-            }
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
-            Logger::Warn("'handle' invalid: 0x{:X}", static_cast<u32>(state.ctx->gpr.w0));
-            state.ctx->gpr.w0 = result::InvalidHandle;
+    Result CancelSynchronization(const DeviceState &state, KHandle handle) {
+        std::unique_lock lock(type::KSyncObject::syncObjectMutex);
+        auto thread{state.process->TryGetHandle<type::KThread>(handle)};
+        if (!thread) [[unlikely]] {
+            Logger::Warn("'handle' invalid: 0x{:X}", handle);
+            return result::InvalidHandle;
+        }
+
+        Logger::Debug("Cancelling Synchronization {}", thread->id);
+        thread->cancelSync = true;
+        if (thread->isCancellable) {
+            thread->isCancellable = false;
+            state.scheduler->InsertThread(thread);
         }
+        return {};
     }
 
-    void ArbitrateLock(const DeviceState &state) {
-        auto mutex{reinterpret_cast<u32 *>(state.ctx->gpr.x1)};
+    Result ArbitrateLock(const DeviceState &state, KHandle ownerHandle, u32 *mutex, KHandle requesterHandle) {
         if (!util::IsWordAligned(mutex)) {
             Logger::Warn("'mutex' not word aligned: 0x{:X}", mutex);
-            state.ctx->gpr.w0 = result::InvalidAddress;
-            return;
+            return result::InvalidAddress;
         }
 
         Logger::Debug("Locking 0x{:X}", mutex);
 
-        KHandle ownerHandle{state.ctx->gpr.w0};
-        KHandle requesterHandle{state.ctx->gpr.w2};
         auto result{state.process->MutexLock(state.thread, mutex, ownerHandle, requesterHandle)};
         if (result == Result{})
             Logger::Debug("Locked 0x{:X}", mutex);
@@ -760,36 +784,28 @@ namespace skyline::kernel::svc {
         else if (result == result::InvalidHandle)
             Logger::Warn("'ownerHandle' invalid: 0x{:X} (0x{:X})", ownerHandle, mutex);
 
-        state.ctx->gpr.w0 = result;
+        return result;
     }
 
-    void ArbitrateUnlock(const DeviceState &state) {
-        auto mutex{reinterpret_cast<u32 *>(state.ctx->gpr.x0)};
+    Result ArbitrateUnlock(const DeviceState &state, u32 *mutex) {
         if (!util::IsWordAligned(mutex)) {
             Logger::Warn("'mutex' not word aligned: 0x{:X}", mutex);
-            state.ctx->gpr.w0 = result::InvalidAddress;
-            return;
+            return result::InvalidAddress;
         }
 
         Logger::Debug("Unlocking 0x{:X}", mutex);
         state.process->MutexUnlock(mutex);
         Logger::Debug("Unlocked 0x{:X}", mutex);
 
-        state.ctx->gpr.w0 = Result{};
+        return {};
     }
 
-    void WaitProcessWideKeyAtomic(const DeviceState &state) {
-        auto mutex{reinterpret_cast<u32 *>(state.ctx->gpr.x0)};
+    Result WaitProcessWideKeyAtomic(const DeviceState &state, u32 *mutex, u32 *conditional, KHandle requesterHandle, i64 timeout) {
         if (!util::IsWordAligned(mutex)) {
             Logger::Warn("'mutex' not word aligned: 0x{:X}", mutex);
-            state.ctx->gpr.w0 = result::InvalidAddress;
-            return;
+            return result::InvalidAddress;
         }
 
-        auto conditional{reinterpret_cast<u32 *>(state.ctx->gpr.x1)};
-        KHandle requesterHandle{state.ctx->gpr.w2};
-
-        i64 timeout{static_cast<i64>(state.ctx->gpr.x3)};
         Logger::Debug("Waiting on 0x{:X} with 0x{:X} for {}ns", conditional, mutex, timeout);
 
         auto result{state.process->ConditionVariableWait(conditional, mutex, requesterHandle, timeout)};
@@ -797,16 +813,13 @@ namespace skyline::kernel::svc {
             Logger::Debug("Waited for 0x{:X} and reacquired 0x{:X}", conditional, mutex);
         else if (result == result::TimedOut)
             Logger::Debug("Wait on 0x{:X} has timed out after {}ns", conditional, timeout);
-        state.ctx->gpr.w0 = result;
+        return result;
     }
 
-    void SignalProcessWideKey(const DeviceState &state) {
-        auto conditional{reinterpret_cast<u32 *>(state.ctx->gpr.x0)};
-        i32 count{static_cast<i32>(state.ctx->gpr.w1)};
-
+    Result SignalProcessWideKey(const DeviceState &state, u32 *conditional, i32 count) {
         Logger::Debug("Signalling 0x{:X} for {} waiters", conditional, count);
         state.process->ConditionVariableSignal(conditional, count);
-        state.ctx->gpr.w0 = Result{};
+        return {};
     }
 
     void GetSystemTick(const DeviceState &state) {
@@ -841,20 +854,21 @@ namespace skyline::kernel::svc {
         state.ctx->gpr.w0 = Result{};
     }
 
-    void SendSyncRequest(const DeviceState &state) {
+    Result SendSyncRequest(const DeviceState &state, KHandle handle) {
         SchedulerScopedLock schedulerLock(state);
-        state.os->serviceManager.SyncRequestHandler(static_cast<KHandle>(state.ctx->gpr.x0));
-        state.ctx->gpr.w0 = Result{};
+        return state.os->serviceManager.SyncRequestHandler(handle);
     }
 
-    void GetThreadId(const DeviceState &state) {
-        KHandle handle{state.ctx->gpr.w1};
-        size_t tid{state.process->GetHandle<type::KThread>(handle)->id};
-
-        Logger::Debug("0x{:X} -> #{}", handle, tid);
+    Result GetThreadId(const DeviceState &state, u64 &threadId, KHandle handle) {
+        auto thread{state.process->TryGetHandle<type::KThread>(handle)};
+        if (!thread) [[unlikely]] {
+            Logger::Warn("'handle' invalid: 0x{:X}", handle);
+            return result::InvalidHandle;
+        }
 
-        state.ctx->gpr.x1 = tid;
-        state.ctx->gpr.w0 = Result{};
+        threadId = thread->id;
+        Logger::Debug("0x{:X} -> #{}", handle, threadId);
+        return {};
     }
 
     void Break(const DeviceState &state) {
@@ -1125,111 +1139,108 @@ namespace skyline::kernel::svc {
         }
 
         KHandle threadHandle{state.ctx->gpr.w0};
-        try {
-            auto thread{state.process->GetHandle<type::KThread>(threadHandle)};
-            if (thread == state.thread) {
-                Logger::Warn("Thread setting own activity: {} (Thread: 0x{:X})", static_cast<u32>(activity), threadHandle);
-                state.ctx->gpr.w0 = result::Busy;
-                return;
-            }
-
-            std::scoped_lock guard{thread->coreMigrationMutex};
-            if (activity == ThreadActivity::Runnable) {
-                if (thread->running && thread->isPaused) {
-                    Logger::Debug("Resuming Thread #{}", thread->id);
-                    state.scheduler->ResumeThread(thread);
-                } else {
-                    Logger::Warn("Attempting to resume thread which is already runnable (Thread: 0x{:X})", threadHandle);
-                    state.ctx->gpr.w0 = result::InvalidState;
-                    return;
-                }
-            } else if (activity == ThreadActivity::Paused) {
-                if (thread->running && !thread->isPaused) {
-                    Logger::Debug("Pausing Thread #{}", thread->id);
-                    state.scheduler->PauseThread(thread);
-                } else {
-                    Logger::Warn("Attempting to pause thread which is already paused (Thread: 0x{:X})", threadHandle);
-                    state.ctx->gpr.w0 = result::InvalidState;
-                    return;
-                }
-            }
-
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
+        auto thread{state.process->TryGetHandle<type::KThread>(threadHandle)};
+        if (!thread) [[unlikely]] {
             Logger::Warn("'handle' invalid: 0x{:X}", static_cast<u32>(threadHandle));
             state.ctx->gpr.w0 = result::InvalidHandle;
+            return;
         }
-    }
 
-    void GetThreadContext3(const DeviceState &state) {
-        KHandle threadHandle{state.ctx->gpr.w1};
-        try {
-            auto thread{state.process->GetHandle<type::KThread>(threadHandle)};
-            if (thread == state.thread) {
-                Logger::Warn("Thread attempting to retrieve own context");
-                state.ctx->gpr.w0 = result::Busy;
+        if (thread == state.thread) {
+            Logger::Warn("Thread setting own activity: {} (Thread: 0x{:X})", static_cast<u32>(activity), threadHandle);
+            state.ctx->gpr.w0 = result::Busy;
+            return;
+        }
+
+        std::scoped_lock guard{thread->coreMigrationMutex};
+        if (activity == ThreadActivity::Runnable) {
+            if (thread->running && thread->isPaused) {
+                Logger::Debug("Resuming Thread #{}", thread->id);
+                state.scheduler->ResumeThread(thread);
+            } else {
+                Logger::Warn("Attempting to resume thread which is already runnable (Thread: 0x{:X})", threadHandle);
+                state.ctx->gpr.w0 = result::InvalidState;
                 return;
             }
-
-            std::scoped_lock guard{thread->coreMigrationMutex};
-            if (!thread->isPaused) {
-                Logger::Warn("Attemping to get context of running thread #{}", thread->id);
+        } else if (activity == ThreadActivity::Paused) {
+            if (thread->running && !thread->isPaused) {
+                Logger::Debug("Pausing Thread #{}", thread->id);
+                state.scheduler->PauseThread(thread);
+            } else {
+                Logger::Warn("Attempting to pause thread which is already paused (Thread: 0x{:X})", threadHandle);
                 state.ctx->gpr.w0 = result::InvalidState;
                 return;
             }
+        }
 
-            struct ThreadContext {
-                std::array<u64, 29> gpr;
-                u64 fp;
-                u64 lr;
-                u64 sp;
-                u64 pc;
-                u32 pstate;
-                u32 _pad_;
-                std::array<u128, 32> vreg;
-                u32 fpcr;
-                u32 fpsr;
-                u64 tpidr;
-            };
-            static_assert(sizeof(ThreadContext) == 0x320);
+        state.ctx->gpr.w0 = Result{};
+    }
 
-            auto &context{*reinterpret_cast<ThreadContext *>(state.ctx->gpr.x0)};
-            context = {}; // Zero-initialize the contents of the context as not all fields are set
+    void GetThreadContext3(const DeviceState &state) {
+        KHandle threadHandle{state.ctx->gpr.w1};
+        auto thread{state.process->TryGetHandle<type::KThread>(threadHandle)};
+        if (!thread) [[unlikely]] {
+            Logger::Warn("'handle' invalid: 0x{:X}", threadHandle);
+            state.ctx->gpr.w0 = result::InvalidHandle;
+            return;
+        }
 
-            auto &targetContext{thread->ctx};
-            for (size_t i{}; i < targetContext.gpr.regs.size(); i++)
-                context.gpr[i] = targetContext.gpr.regs[i];
+        if (thread == state.thread) {
+            Logger::Warn("Thread attempting to retrieve own context");
+            state.ctx->gpr.w0 = result::Busy;
+            return;
+        }
 
-            for (size_t i{}; i < targetContext.fpr.regs.size(); i++)
-                context.vreg[i] = targetContext.fpr.regs[i];
+        std::scoped_lock guard{thread->coreMigrationMutex};
+        if (!thread->isPaused) {
+            Logger::Warn("Attemping to get context of running thread #{}", thread->id);
+            state.ctx->gpr.w0 = result::InvalidState;
+            return;
+        }
 
-            context.fpcr = targetContext.fpr.fpcr;
-            context.fpsr = targetContext.fpr.fpsr;
+        struct ThreadContext {
+            std::array<u64, 29> gpr;
+            u64 fp;
+            u64 lr;
+            u64 sp;
+            u64 pc;
+            u32 pstate;
+            u32 _pad_;
+            std::array<u128, 32> vreg;
+            u32 fpcr;
+            u32 fpsr;
+            u64 tpidr;
+        };
+        static_assert(sizeof(ThreadContext) == 0x320);
 
-            context.tpidr = reinterpret_cast<u64>(targetContext.tpidrEl0);
+        auto &context{*reinterpret_cast<ThreadContext *>(state.ctx->gpr.x0)};
+        context = {}; // Zero-initialize the contents of the context as not all fields are set
 
-            // Note: We don't write the whole context as we only store the parts required according to the ARMv8 ABI for syscall handling
-            Logger::Debug("Written partial context for thread #{}", thread->id);
+        auto &targetContext{thread->ctx};
+        for (size_t i{}; i < targetContext.gpr.regs.size(); i++)
+            context.gpr[i] = targetContext.gpr.regs[i];
 
-            state.ctx->gpr.w0 = Result{};
-        } catch (const std::out_of_range &) {
-            Logger::Warn("'handle' invalid: 0x{:X}", threadHandle);
-            state.ctx->gpr.w0 = result::InvalidHandle;
-        }
+        for (size_t i{}; i < targetContext.fpr.regs.size(); i++)
+            context.vreg[i] = targetContext.fpr.regs[i];
+
+        context.fpcr = targetContext.fpr.fpcr;
+        context.fpsr = targetContext.fpr.fpsr;
+
+        context.tpidr = reinterpret_cast<u64>(targetContext.tpidrEl0);
+
+        // Note: We don't write the whole context as we only store the parts required according to the ARMv8 ABI for syscall handling
+        Logger::Debug("Written partial context for thread #{}", thread->id);
+
+        state.ctx->gpr.w0 = Result{};
     }
 
-    void WaitForAddress(const DeviceState &state) {
-        auto address{reinterpret_cast<u32 *>(state.ctx->gpr.x0)};
+    Result WaitForAddress(const DeviceState &state, u32 *address, type::KProcess::ArbitrationType arbitrationType, u32 value, i64 timeout) {
         if (!util::IsWordAligned(address)) [[unlikely]] {
             Logger::Warn("'address' not word aligned: 0x{:X}", address);
-            state.ctx->gpr.w0 = result::InvalidAddress;
-            return;
+            return result::InvalidAddress;
         }
 
         using ArbitrationType = type::KProcess::ArbitrationType;
-        auto arbitrationType{static_cast<ArbitrationType>(static_cast<u32>(state.ctx->gpr.w1))};
-        u32 value{state.ctx->gpr.w2};
-        i64 timeout{static_cast<i64>(state.ctx->gpr.x3)};
 
         Result result;
         switch (arbitrationType) {
@@ -1251,8 +1262,7 @@ namespace skyline::kernel::svc {
             default:
                 [[unlikely]]
                     Logger::Error("'arbitrationType' invalid: {}", arbitrationType);
-                state.ctx->gpr.w0 = result::InvalidEnumValue;
-                return;
+                return result::InvalidEnumValue;
         }
 
         if (result == Result{})
@@ -1263,21 +1273,16 @@ namespace skyline::kernel::svc {
         else if (result == result::InvalidState)
             Logger::Debug("The value at 0x{:X} did not satisfy the arbitration condition", address);
 
-        state.ctx->gpr.w0 = result;
+        return result;
     }
 
-    void SignalToAddress(const DeviceState &state) {
-        auto address{reinterpret_cast<u32 *>(state.ctx->gpr.x0)};
+    Result SignalToAddress(const DeviceState &state, u32 *address, type::KProcess::SignalType signalType, u32 value, i32 count) {
         if (!util::IsWordAligned(address)) [[unlikely]] {
             Logger::Warn("'address' not word aligned: 0x{:X}", address);
-            state.ctx->gpr.w0 = result::InvalidAddress;
-            return;
+            return result::InvalidAddress;
         }
 
         using SignalType = type::KProcess::SignalType;
-        auto signalType{static_cast<SignalType>(static_cast<u32>(state.ctx->gpr.w1))};
-        u32 value{state.ctx->gpr.w2};
-        i32 count{static_cast<i32>(state.ctx->gpr.w3)};
 
         Result result;
         switch (signalType) {
@@ -1299,8 +1304,7 @@ namespace skyline::kernel::svc {
             default:
                 [[unlikely]]
                     Logger::Error("'signalType' invalid: {}", signalType);
-                state.ctx->gpr.w0 = result::InvalidEnumValue;
-                return;
+                return result::InvalidEnumValue;
         }
 
         if (result == Result{})
@@ -1309,6 +1313,6 @@ namespace skyline::kernel::svc {
         else if (result == result::InvalidState)
             Logger::Debug("The value at 0x{:X} did not satisfy the mutation condition", address);
 
-        state.ctx->gpr.w0 = result;
+        return result;
     }
 }
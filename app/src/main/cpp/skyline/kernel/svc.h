@@ -3,7 +3,8 @@
 
 #pragma once
 
-#include <common.h>
+#include <nce/guest.h>
+#include <kernel/types/KProcess.h>
 
 namespace skyline::kernel::svc {
     /**
@@ -70,13 +71,13 @@ namespace skyline::kernel::svc {
      * @brief Get priority of provided thread handle
      * @url https://switchbrew.org/wiki/SVC#GetThreadPriority
      */
-    void GetThreadPriority(const DeviceState &state);
+    Result GetThreadPriority(const DeviceState &state, u32 &outPriority, KHandle handle);
 
     /**
      * @brief Set priority of provided thread handle
      * @url https://switchbrew.org/wiki/SVC#SetThreadPriority
      */
-    void SetThreadPriority(const DeviceState &state);
+    Result SetThreadPriority(const DeviceState &state, KHandle handle, i8 priority);
 
     /**
      * @brief Get core mask of provided thread handle
@@ -100,7 +101,7 @@ namespace skyline::kernel::svc {
      * @brief Resets a KEvent to its unsignalled state
      * @url https://switchbrew.org/wiki/SVC#ClearEvent
      */
-    void ClearEvent(const DeviceState &state);
+    Result ClearEvent(const DeviceState &state, KHandle handle);
 
     /**
      * @brief Maps shared memory into a memory region
@@ -124,49 +125,49 @@ namespace skyline::kernel::svc {
      * @brief Closes the specified handle
      * @url https://switchbrew.org/wiki/SVC#CloseHandle
      */
-    void CloseHandle(const DeviceState &state);
+    Result CloseHandle(const DeviceState &state, KHandle handle);
 
     /**
      * @brief Resets a particular KEvent or KProcess which is signalled
      * @url https://switchbrew.org/wiki/SVC#ResetSignal
      */
-    void ResetSignal(const DeviceState &state);
+    Result ResetSignal(const DeviceState &state, KHandle handle);
 
     /**
      * @brief Stalls a thread till a KSyncObject signals or the timeout has ended
      * @url https://switchbrew.org/wiki/SVC#WaitSynchronization
      */
-    void WaitSynchronization(const DeviceState &state);
+    Result WaitSynchronization(const DeviceState &state, u32 &wakeIndex, KHandle *handles, u32 numHandles, i64 timeout);
 
     /**
      * @brief If the referenced thread is currently in a synchronization call, that call will be interrupted
      * @url https://switchbrew.org/wiki/SVC#CancelSynchronization
      */
-    void CancelSynchronization(const DeviceState &state);
+    Result CancelSynchronization(const DeviceState &state, KHandle handle);
 
     /**
      * @brief Locks a specified mutex
      * @url https://switchbrew.org/wiki/SVC#ArbitrateLock
      */
-    void ArbitrateLock(const DeviceState &state);
+    Result ArbitrateLock(const DeviceState &state, KHandle ownerHandle, u32 *mutex, KHandle requesterHandle);
 
     /**
      * @brief Unlocks a specified mutex
      * @url https://switchbrew.org/wiki/SVC#ArbitrateUnlock
      */
-    void ArbitrateUnlock(const DeviceState &state);
+    Result ArbitrateUnlock(const DeviceState &state, u32 *mutex);
 
     /**
      * @brief Waits on a process-wide key (Conditional-Variable)
      * @url https://switchbrew.org/wiki/SVC#WaitProcessWideKeyAtomic
      */
-    void WaitProcessWideKeyAtomic(const DeviceState &state);
+    Result WaitProcessWideKeyAtomic(const DeviceState &state, u32 *mutex, u32 *conditional, KHandle requesterHandle, i64 timeout);
 
     /**
      * @brief Signals a process-wide key (Conditional-Variable)
      * @url https://switchbrew.org/wiki/SVC#SignalProcessWideKey
      */
-    void SignalProcessWideKey(const DeviceState &state);
+    Result SignalProcessWideKey(const DeviceState &state, u32 *conditional, i32 count);
 
     /**
      * @brief Returns the value of CNTPCT_EL0 on the Switch
@@ -184,13 +185,13 @@ namespace skyline::kernel::svc {
      * @brief Send a synchronous IPC request to a service
      * @url https://switchbrew.org/wiki/SVC#SendSyncRequest
      */
-    void SendSyncRequest(const DeviceState &state);
+    Result SendSyncRequest(const DeviceState &state, KHandle handle);
 
     /**
      * @brief Retrieves the PID of a specific thread
      * @url https://switchbrew.org/wiki/SVC#GetThreadId
      */
-    void GetThreadId(const DeviceState &state);
+    Result GetThreadId(const DeviceState &state, u64 &threadId, KHandle handle);
 
     /**
      * @brief Causes the debugger to be engaged or the program to end if it isn't being debugged
@@ -238,13 +239,82 @@ namespace skyline::kernel::svc {
      * @brief Waits on an address based on the value of the address
      * @url https://switchbrew.org/wiki/SVC#WaitForAddress
      */
-    void WaitForAddress(const DeviceState &state);
+    Result WaitForAddress(const DeviceState &state, u32 *address, type::KProcess::ArbitrationType arbitrationType, u32 value, i64 timeout);
 
     /**
      * @brief Signals a thread which is waiting on an address
      * @url https://switchbrew.org/wiki/SVC#SignalToAddress
      */
-    void SignalToAddress(const DeviceState &state);
+    Result SignalToAddress(const DeviceState &state, u32 *address, type::KProcess::SignalType signalType, u32 value, i32 count);
+
+    namespace detail {
+        /**
+         * @brief If a parameter of an SVC implementation is an output, these are non-const lvalue references
+         */
+        template<typename Type>
+        constexpr bool IsSvcOutput{std::is_lvalue_reference_v<Type> && !std::is_const_v<std::remove_reference_t<Type>>};
+
+        template<typename Type>
+        constexpr Type ReadSvcArgument(u64 value) {
+            if constexpr (std::is_pointer_v<Type>)
+                return reinterpret_cast<Type>(value);
+            else
+                return static_cast<Type>(value); // This truncates the register to the width of the type, matching a read from the W register for 32-bit types
+        }
+
+        template<typename Type>
+        constexpr u64 WriteSvcArgument(Type value) {
+            if constexpr (std::is_pointer_v<Type>)
+                return reinterpret_cast<u64>(value);
+            else if constexpr (std::is_enum_v<Type>)
+                return static_cast<u64>(static_cast<std::make_unsigned_t<std::underlying_type_t<Type>>>(value));
+            else
+                return static_cast<u64>(static_cast<std::make_unsigned_t<Type>>(value)); // Outputs are zero-extended like writes to a W register
+        }
+
+        template<auto Function, typename... Args, size_t... Indices>
+        void InvokeSvcUnpacked(const DeviceState &state, std::index_sequence<Indices...>) {
+            auto &gpr{state.ctx->gpr};
+            std::tuple<std::remove_cvref_t<Args>...> arguments{[&]() {
+                using Type = std::remove_cvref_t<Args>;
+                if constexpr (IsSvcOutput<Args>)
+                    return Type{};
+                else
+                    return ReadSvcArgument<Type>(gpr.regs[Indices]);
+            }()...};
+
+            Result result{Function(state, std::get<Indices>(arguments)...)};
+
+            // Outputs are returned in registers starting from X1 in the order of their parameters, regardless of the register that they occupy as an argument
+            [[maybe_unused]] size_t outputRegister{1};
+            ([&]() {
+                if constexpr (IsSvcOutput<Args>)
+                    gpr.regs[outputRegister++] = WriteSvcArgument(std::get<Indices>(arguments));
+            }(), ...);
+
+            gpr.w0 = result;
+        }
+
+        template<auto Function, typename... Args>
+        void InvokeSvc(const DeviceState &state, Result (*)(const DeviceState &, Args...)) {
+            InvokeSvcUnpacked<Function, Args...>(state, std::index_sequence_for<Args...>{});
+        }
+
+        template<auto Function>
+        void InvokeSvc(const DeviceState &state, void (*)(const DeviceState &)) {
+            Function(state);
+        }
+    }
+
+    /**
+     * @brief A thunk which calls an SVC implementation directly with arguments unpacked from the guest registers based on its signature
+     * @details Every parameter after the state corresponds to the guest register at the same index, parameters that are non-const references are outputs and are written back to the registers starting from X1 while the returned result is written to W0
+     * @note Implementations which take only the state handle the guest registers themselves
+     */
+    template<auto Function>
+    void SvcWrapper(const DeviceState &state) {
+        detail::InvokeSvc<Function>(state, Function);
+    }
 
     /**
      * @brief A per-SVC descriptor with it's name and a function pointer
@@ -261,7 +331,7 @@ namespace skyline::kernel::svc {
 
     #define SVC_NONE SvcDescriptor{} //!< A macro with a placeholder value for the SVC not being implemented or not existing
     #define SVC_STRINGIFY(name) #name
-    #define SVC_ENTRY(function) SvcDescriptor{function, SVC_STRINGIFY(Svc ## function)} //!< A macro which automatically stringifies the function name as the name to prevent pointless duplication
+    #define SVC_ENTRY(function) SvcDescriptor{&SvcWrapper<function>, SVC_STRINGIFY(Svc ## function)} //!< A macro which automatically stringifies the function name as the name to prevent pointless duplication
 
     /**
      * @brief The SVC table maps all SVCs to their corresponding functions
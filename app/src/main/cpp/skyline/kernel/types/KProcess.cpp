@@ -81,32 +81,98 @@ namespace skyline::kernel::type {
         return thread;
     }
 
+    KHandle KProcess::ReserveHandle() {
+        u16 index;
+        if (freeHandleEntry != NoFreeHandleEntry) {
+            index = freeHandleEntry;
+            freeHandleEntry = handleEntries[index].nextFree;
+        } else if (handleEntryCount < MaxHandleCount) {
+            index = handleEntryCount++;
+        } else {
+            throw exception("The handle table is full with {} handles", MaxHandleCount);
+        }
+
+        auto &entry{handleEntries[index]};
+        entry.generation = static_cast<u16>((entry.generation % HandleGenerationMask) + 1); // The generation is never zero so a handle can never be zero either
+        return (static_cast<KHandle>(entry.generation) << HandleIndexBits) | index;
+    }
+
+    void KProcess::PublishHandle(KHandle handle, std::shared_ptr<KObject> object) {
+        auto &entry{*GetHandleEntry(handle)};
+        auto type{object->objectType};
+        std::scoped_lock lock{entry.lock};
+        entry.object = std::move(object);
+        entry.tag.store(GetHandleTag(handle, type), std::memory_order_release);
+    }
+
+    bool KProcess::CloseHandle(KHandle handle) {
+        auto entry{GetHandleEntry(handle)};
+        if (!entry) [[unlikely]]
+            return false;
+
+        std::shared_ptr<KObject> object;
+        {
+            std::scoped_lock lock{handleMutex};
+            {
+                std::scoped_lock entryLock{entry->lock};
+                if ((entry->tag.load(std::memory_order_relaxed) >> 32) != handle) [[unlikely]]
+                    return false;
+
+                entry->tag.store(0, std::memory_order_release);
+                object = std::move(entry->object);
+            }
+
+            entry->nextFree = freeHandleEntry;
+            freeHandleEntry = static_cast<u16>(entry - handleEntries.get());
+        }
+        // The object is destroyed outside of any locks as it may be the last reference to it
+        return true;
+    }
+
     std::optional<KProcess::HandleOut<KMemory>> KProcess::GetMemoryObject(u8 *ptr) {
-        std::shared_lock lock(handleMutex);
-
-        for (KHandle index{}; index < handles.size(); index++) {
-            auto &object{handles[index]};
-            if (object) {
-                switch (object->objectType) {
-                    case type::KType::KPrivateMemory:
-                    case type::KType::KSharedMemory:
-                    case type::KType::KTransferMemory: {
-                        auto mem{std::static_pointer_cast<type::KMemory>(object)};
-                        if (mem->guest.contains(ptr))
-                            return std::make_optional<KProcess::HandleOut<KMemory>>({mem, constant::BaseHandleIndex + index});
+        std::scoped_lock lock{handleMutex};
+
+        for (u16 index{}; index < handleEntryCount; index++) {
+            auto &entry{handleEntries[index]};
+            u64 tag{entry.tag.load(std::memory_order_acquire)};
+            if (!tag)
+                continue;
+
+            switch (GetHandleTagType(tag)) {
+                case type::KType::KPrivateMemory:
+                case type::KType::KSharedMemory:
+                case type::KType::KTransferMemory: {
+                    std::shared_ptr<KMemory> mem;
+                    {
+                        std::scoped_lock entryLock{entry.lock};
+                        mem = std::static_pointer_cast<type::KMemory>(entry.object);
                     }
-
-                    default:
-                        break;
+                    if (mem && mem->guest.contains(ptr))
+                        return std::make_optional<KProcess::HandleOut<KMemory>>({mem, static_cast<KHandle>(tag >> 32)});
                 }
+
+                default:
+                    break;
             }
         }
         return std::nullopt;
     }
 
     void KProcess::ClearHandleTable() {
-        std::shared_lock lock(handleMutex);
-        handles.clear();
+        std::vector<std::shared_ptr<KObject>> objects; // Objects are destroyed after the table has been unlocked as their destructors may access it
+        {
+            std::scoped_lock lock{handleMutex};
+            objects.reserve(handleEntryCount);
+            for (u16 index{}; index < handleEntryCount; index++) {
+                auto &entry{handleEntries[index]};
+                std::scoped_lock entryLock{entry.lock};
+                entry.tag.store(0, std::memory_order_release);
+                objects.push_back(std::move(entry.object));
+            }
+
+            handleEntryCount = 0;
+            freeHandleEntry = NoFreeHandleEntry;
+        }
     }
 
     constexpr u32 HandleWaitersBit{1UL << 30}; //!< A bit which denotes if a mutex psuedo-handle has waiters or not
@@ -114,10 +180,12 @@ namespace skyline::kernel::type {
     Result KProcess::MutexLock(const std::shared_ptr<KThread> &thread, u32 *mutex, KHandle ownerHandle, KHandle tag, bool failOnOutdated) {
         TRACE_EVENT_FMT("kernel", "MutexLock 0x{:X} @ 0x{:X}", mutex, thread->id);
 
-        std::shared_ptr<KThread> owner;
-        try {
-            owner = GetHandle<KThread>(ownerHandle);
-        } catch (const std::out_of_range &) {
+        // The owner may have released the mutex prior to us arriving here, the guest will retry acquiring it without the handle table being touched
+        if (__atomic_load_n(mutex, __ATOMIC_SEQ_CST) != (ownerHandle | HandleWaitersBit))
+            return failOnOutdated ? result::InvalidCurrentMemory : Result{};
+
+        auto owner{TryGetHandle<KThread>(ownerHandle)};
+        if (!owner) [[unlikely]] {
             if (__atomic_load_n(mutex, __ATOMIC_SEQ_CST) != (ownerHandle | HandleWaitersBit))
                 return failOnOutdated ? result::InvalidCurrentMemory : Result{};
 
@@ -156,6 +224,11 @@ namespace skyline::kernel::type {
     void KProcess::MutexUnlock(u32 *mutex) {
         TRACE_EVENT_FMT("kernel", "MutexUnlock 0x{:X}", mutex);
 
+        // Threads are only queued on a mutex after setting its waiter bit, so the mutex can be released directly if the bit is unset and it stays that way till the CAS
+        u32 value{__atomic_load_n(mutex, __ATOMIC_SEQ_CST)};
+        if (!(value & HandleWaitersBit) && __atomic_compare_exchange_n(mutex, &value, 0, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            return;
+
         std::scoped_lock lock{state.thread->waiterMutex};
         auto &waiters{state.thread->waiters};
         auto nextOwnerIt{std::find_if(waiters.begin(), waiters.end(), [mutex](const std::shared_ptr<KThread> &thread) { return thread->waitMutex == mutex; })};
@@ -229,10 +302,11 @@ namespace skyline::kernel::type {
             state.thread->waitResult = {};
         }
 
+        auto &shard{GetSyncWaiterShard(key)};
         {
-            std::scoped_lock lock{syncWaiterMutex};
-            auto queue{syncWaiters.equal_range(key)};
-            syncWaiters.insert(std::upper_bound(queue.first, queue.second, state.thread->priority.load(), [](const i8 priority, const SyncWaiters::value_type &it) { return it.second->priority > priority; }), {key, state.thread});
+            std::scoped_lock lock{shard.mutex};
+            auto queue{shard.waiters.equal_range(key)};
+            shard.waiters.insert(std::upper_bound(queue.first, queue.second, state.thread->priority.load(), [](const i8 priority, const SyncWaiters::value_type &it) { return it.second->priority > priority; }), {key, state.thread});
 
             __atomic_store_n(key, true, __ATOMIC_SEQ_CST); // We need to notify any userspace threads that there are waiters on this conditional variable by writing back a boolean flag denoting it
 
@@ -244,11 +318,11 @@ namespace skyline::kernel::type {
             bool inQueue{true};
             {
                 // Attempt to remove ourselves from the queue so we cannot be signalled
-                std::unique_lock syncLock{syncWaiterMutex};
-                auto queue{syncWaiters.equal_range(key)};
+                std::unique_lock syncLock{shard.mutex};
+                auto queue{shard.waiters.equal_range(key)};
                 auto iterator{std::find(queue.first, queue.second, SyncWaiters::value_type{key, state.thread})};
                 if (iterator != queue.second)
-                    syncWaiters.erase(iterator);
+                    shard.waiters.erase(iterator);
                 else
                     inQueue = false;
             }
@@ -321,14 +395,19 @@ namespace skyline::kernel::type {
     void KProcess::ConditionVariableSignal(u32 *key, i32 amount) {
         TRACE_EVENT_FMT("kernel", "ConditionVariableSignal 0x{:X}", key);
 
+        // The waiter flag is only set and cleared with the shard locked alongside the queue being modified, a signal that races with it can be ordered prior to the wait
+        if (!__atomic_load_n(key, __ATOMIC_SEQ_CST))
+            return;
+
+        auto &shard{GetSyncWaiterShard(key)};
         i32 waiterCount{amount};
         while (amount <= 0 || waiterCount) {
             std::shared_ptr<type::KThread> thread;
             void *conditionVariable{};
             {
                 // Try to find a thread to signal
-                std::scoped_lock lock{syncWaiterMutex};
-                auto queue{syncWaiters.equal_range(key)};
+                std::scoped_lock lock{shard.mutex};
+                auto queue{shard.waiters.equal_range(key)};
 
                 if (queue.first != queue.second) {
                     // If threads are waiting on us still then we need to remove the highest priority thread from the queue
@@ -340,7 +419,7 @@ namespace skyline::kernel::type {
                         Logger::Warn("Condition variable mismatch: 0x{:X} != 0x{:X}", conditionVariable, key);
                     #endif
 
-                    syncWaiters.erase(it);
+                    shard.waiters.erase(it);
                     waiterCount--;
                 } else if (queue.first == queue.second) {
                     // If we didn't find a thread then we need to clear the boolean flag denoting that there are no more threads waiting on this conditional variable
@@ -393,8 +472,9 @@ namespace skyline::kernel::type {
     Result KProcess::WaitForAddress(u32 *address, u32 value, i64 timeout, ArbitrationType type) {
         TRACE_EVENT_FMT("kernel", "WaitForAddress 0x{:X}", address);
 
+        auto &shard{GetSyncWaiterShard(address)};
         {
-            std::scoped_lock lock{syncWaiterMutex};
+            std::scoped_lock lock{shard.mutex};
 
             u32 userValue{__atomic_load_n(address, __ATOMIC_SEQ_CST)};
             switch (type) {
@@ -420,8 +500,8 @@ namespace skyline::kernel::type {
             if (timeout == 0) [[unlikely]]
                 return result::TimedOut;
 
-            auto queue{syncWaiters.equal_range(address)};
-            syncWaiters.insert(std::upper_bound(queue.first, queue.second, state.thread->priority.load(), [](const i8 priority, const SyncWaiters::value_type &it) { return it.second->priority > priority; }), {address, state.thread});
+            auto queue{shard.waiters.equal_range(address)};
+            shard.waiters.insert(std::upper_bound(queue.first, queue.second, state.thread->priority.load(), [](const i8 priority, const SyncWaiters::value_type &it) { return it.second->priority > priority; }), {address, state.thread});
 
             state.scheduler->RemoveThread();
         }
@@ -429,11 +509,11 @@ namespace skyline::kernel::type {
         if (timeout > 0 && !state.scheduler->TimedWaitSchedule(std::chrono::nanoseconds(timeout))) {
             bool shouldWait{false};
             {
-                std::scoped_lock lock{syncWaiterMutex};
-                auto queue{syncWaiters.equal_range(address)};
+                std::scoped_lock lock{shard.mutex};
+                auto queue{shard.waiters.equal_range(address)};
                 auto iterator{std::find(queue.first, queue.second, SyncWaiters::value_type{address, state.thread})};
                 if (iterator != queue.second) {
-                    if (syncWaiters.erase(iterator) == queue.second)
+                    if (shard.waiters.erase(iterator) == queue.second)
                         // We need to update the boolean flag denoting that there are no more threads waiting on this address
                         __atomic_store_n(address, false, __ATOMIC_SEQ_CST);
                 } else {
@@ -461,8 +541,9 @@ namespace skyline::kernel::type {
     Result KProcess::SignalToAddress(u32 *address, u32 value, i32 amount, SignalType type) {
         TRACE_EVENT_FMT("kernel", "SignalToAddress 0x{:X}", address);
 
-        std::scoped_lock lock{syncWaiterMutex};
-        auto queue{syncWaiters.equal_range(address)};
+        auto &shard{GetSyncWaiterShard(address)};
+        std::scoped_lock lock{shard.mutex};
+        auto queue{shard.waiters.equal_range(address)};
 
         if (type != SignalType::Signal) {
             u32 newValue{value};
@@ -501,7 +582,7 @@ namespace skyline::kernel::type {
         for (auto &it : orderedThreads) {
             auto thread{it->second};
 
-            syncWaiters.erase(it);
+            shard.waiters.erase(it);
             state.scheduler->InsertThread(thread);
 
             if (--waiterCount == 0 && amount > 0)
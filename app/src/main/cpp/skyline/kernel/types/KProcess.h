@@ -13,7 +13,6 @@ namespace skyline {
     namespace constant {
         constexpr u16 TlsSlotSize{0x200}; //!< The size of a single TLS slot
         constexpr u8 TlsSlots{constant::PageSize / TlsSlotSize}; //!< The amount of TLS slots in a single page
-        constexpr KHandle BaseHandleIndex{0xD000}; //!< The index of the base handle
     }
 
     namespace kernel::type {
@@ -31,8 +30,27 @@ namespace skyline {
             std::vector<std::shared_ptr<KThread>> threads;
 
             using SyncWaiters = std::multimap<void *, std::shared_ptr<KThread>>;
-            std::mutex syncWaiterMutex; //!< Synchronizes all mutations to the map to prevent races
-            SyncWaiters syncWaiters; //!< All threads waiting on process-wide synchronization primitives (Atomic keys + Address Arbiter)
+
+            /**
+             * @brief A shard of the threads waiting on process-wide synchronization primitives (Atomic keys + Address Arbiter), the shard for a key is determined by hashing its address
+             * @note Waits on unrelated addresses are serialized only when they hash to the same shard rather than on a single process-wide lock
+             */
+            struct SyncWaiterShard {
+                std::mutex mutex; //!< Synchronizes all mutations to the map to prevent races
+                SyncWaiters waiters; //!< All threads waiting on keys within this shard
+            };
+
+            static constexpr size_t SyncWaiterShardCount{64}; //!< The amount of shards, this must be a power of two
+            std::array<SyncWaiterShard, SyncWaiterShardCount> syncWaiterShards;
+
+            /**
+             * @return The shard holding all waiters on the supplied key
+             */
+            SyncWaiterShard &GetSyncWaiterShard(void *key) {
+                // Keys are word-aligned and primitives are often laid out contiguously, a Fibonacci hash spreads adjacent keys across shards
+                constexpr u64 FibonacciMultiplier{0x9E3779B97F4A7C15};
+                return syncWaiterShards[((reinterpret_cast<u64>(key) >> 2) * FibonacciMultiplier) >> (64 - std::countr_zero(SyncWaiterShardCount))];
+            }
 
             /**
             * @brief The status of a single TLS page (A page is 4096 bytes on ARMv8)
@@ -62,8 +80,56 @@ namespace skyline {
             vfs::NPDM npdm;
 
           private:
-            std::shared_mutex handleMutex;
-            std::vector<std::shared_ptr<KObject>> handles;
+            /**
+             * @brief A single entry in the handle table, lookups only read the tag and lock the entry itself for as long as it takes to copy the object reference
+             */
+            struct HandleEntry {
+                std::atomic<u64> tag{}; //!< The handle currently referring to this entry in the upper 32 bits with the type of the object in the lower bits, this is zero while the entry is free
+                SpinLock lock; //!< Synchronizes copying the object reference with it being replaced
+                std::shared_ptr<KObject> object;
+                u16 generation{}; //!< The generation of the last handle to this entry, this is advanced on every reuse so stale handles can't refer to newer objects
+                u16 nextFree{}; //!< The index of the next entry in the free list
+            };
+
+            static constexpr size_t MaxHandleCount{0x4000}; //!< The maximum amount of handles which can be open at once, this is higher than on HOS as HLE services also hold handles in the guest's table
+            static constexpr u8 HandleIndexBits{15}; //!< The amount of low bits in a handle which encode the index of its entry, the generation is encoded in the bits above it like on HOS
+            static constexpr u16 HandleGenerationMask{0x7FFF}; //!< The bits available for the generation, this keeps all handles below the mutex waiter bit
+            static constexpr u16 NoFreeHandleEntry{0xFFFF};
+
+            std::mutex handleMutex; //!< Synchronizes allocating and freeing handle table entries, this isn't held by lookups
+            std::unique_ptr<HandleEntry[]> handleEntries{std::make_unique<HandleEntry[]>(MaxHandleCount)};
+            u16 handleEntryCount{}; //!< The amount of entries which have ever been allocated, entries past this have never been used
+            u16 freeHandleEntry{NoFreeHandleEntry}; //!< The index of the first entry in the free list
+
+            static constexpr u64 GetHandleTag(KHandle handle, KType type) {
+                return (static_cast<u64>(handle) << 32) | (static_cast<u64>(type) + 1);
+            }
+
+            static constexpr KType GetHandleTagType(u64 tag) {
+                return static_cast<KType>((tag & 0xFF) - 1);
+            }
+
+            /**
+             * @brief Allocates a free entry in the handle table without publishing it
+             * @return The handle which will refer to the entry once it has been published
+             * @note 'handleMutex' must be locked by the calling thread
+             */
+            KHandle ReserveHandle();
+
+            /**
+             * @brief Makes the supplied object retrievable through a handle returned by ReserveHandle
+             */
+            void PublishHandle(KHandle handle, std::shared_ptr<KObject> object);
+
+            /**
+             * @return The entry referred to by the index bits of the handle or nullptr if they're out of range, the generation of it must be checked separately
+             */
+            HandleEntry *GetHandleEntry(KHandle handle) {
+                size_t index{handle & ((1U << HandleIndexBits) - 1)};
+                if (index >= MaxHandleCount) [[unlikely]]
+                    return nullptr;
+                return &handleEntries[index];
+            }
 
           public:
             KProcess(const DeviceState &state);
@@ -114,15 +180,19 @@ namespace skyline {
              */
             template<typename objectClass, typename ...objectArgs>
             HandleOut<objectClass> NewHandle(objectArgs... args) {
-                std::unique_lock lock(handleMutex);
+                KHandle handle;
+                {
+                    std::scoped_lock lock{handleMutex};
+                    handle = ReserveHandle();
+                }
 
                 std::shared_ptr<objectClass> item;
                 if constexpr (std::is_same<objectClass, KThread>() || std::is_same<objectClass, KPrivateMemory>())
-                    item = std::make_shared<objectClass>(state, constant::BaseHandleIndex + handles.size(), args...);
+                    item = std::make_shared<objectClass>(state, handle, args...);
                 else
                     item = std::make_shared<objectClass>(state, args...);
-                handles.push_back(std::static_pointer_cast<KObject>(item));
-                return {item, static_cast<KHandle>((constant::BaseHandleIndex + handles.size()) - 1)};
+                PublishHandle(handle, item);
+                return {item, handle};
             }
 
             /**
@@ -131,17 +201,24 @@ namespace skyline {
              */
             template<typename objectClass>
             KHandle InsertItem(std::shared_ptr<objectClass> &item) {
-                std::unique_lock lock(handleMutex);
+                KHandle handle;
+                {
+                    std::scoped_lock lock{handleMutex};
+                    handle = ReserveHandle();
+                }
 
-                handles.push_back(std::static_pointer_cast<KObject>(item));
-                return static_cast<KHandle>((constant::BaseHandleIndex + handles.size()) - 1);
+                PublishHandle(handle, item);
+                return handle;
             }
 
+            /**
+             * @return The object referred to by the handle or nullptr if the handle is invalid, closed or refers to an object of a different type
+             * @note This doesn't take any process-wide locks, the type of the object is checked using the tag of the entry prior to locking it
+             * @note This should be preferred over GetHandle wherever an invalid handle is a guest error rather than a fatal one, such as in SVCs
+             */
             template<typename objectClass = KObject>
-            std::shared_ptr<objectClass> GetHandle(KHandle handle) {
-                std::shared_lock lock(handleMutex);
-
-                KType objectType;
+            std::shared_ptr<objectClass> TryGetHandle(KHandle handle) {
+                KType objectType{};
                 if constexpr(std::is_same<objectClass, KThread>()) {
                     constexpr KHandle threadSelf{0xFFFF8000}; // The handle used by threads to refer to themselves
                     if (handle == threadSelf)
@@ -162,30 +239,38 @@ namespace skyline {
                     objectType = KType::KSession;
                 } else if constexpr(std::is_same<objectClass, KEvent>()) {
                     objectType = KType::KEvent;
-                } else {
+                } else if constexpr(!std::is_same<objectClass, KObject>()) {
                     throw exception("KProcess::GetHandle couldn't determine object type");
                 }
-                try {
-                    auto &item{handles.at(handle - constant::BaseHandleIndex)};
-                    if (item != nullptr && item->objectType == objectType)
-                        return std::static_pointer_cast<objectClass>(item);
-                    else if (item == nullptr)
-                        throw exception("GetHandle was called with a deleted handle: 0x{:X}", handle);
-                    else
-                        throw exception("Tried to get kernel object (0x{:X}) with different type: {} when object is {}", handle, objectType, item->objectType);
-                } catch (const std::out_of_range &) {
-                    throw std::out_of_range(fmt::format("GetHandle was called with an invalid handle: 0x{:X}", handle));
-                }
+
+                auto entry{GetHandleEntry(handle)};
+                if (!entry) [[unlikely]]
+                    return nullptr;
+
+                u64 tag{entry->tag.load(std::memory_order_acquire)};
+                if ((tag >> 32) != handle) [[unlikely]]
+                    return nullptr;
+
+                if constexpr(!std::is_same<objectClass, KObject>())
+                    if (GetHandleTagType(tag) != objectType) [[unlikely]]
+                        return nullptr;
+
+                std::scoped_lock lock{entry->lock};
+                if (entry->tag.load(std::memory_order_relaxed) != tag) [[unlikely]]
+                    return nullptr; // The handle was closed and possibly reused while we were locking the entry
+                return std::static_pointer_cast<objectClass>(entry->object);
             }
 
-            template<>
-            std::shared_ptr<KObject> GetHandle<KObject>(KHandle handle) {
-                std::shared_lock lock(handleMutex);
-                auto &item{handles.at(handle - constant::BaseHandleIndex)};
-                if (item != nullptr)
-                    return item;
-                else
-                    throw std::out_of_range(fmt::format("GetHandle was called with a deleted handle: 0x{:X}", handle));
+            /**
+             * @return The object referred to by the handle
+             * @throws std::out_of_range If the handle is invalid, closed or refers to an object of a different type
+             */
+            template<typename objectClass = KObject>
+            std::shared_ptr<objectClass> GetHandle(KHandle handle) {
+                auto object{TryGetHandle<objectClass>(handle)};
+                if (!object) [[unlikely]]
+                    throw std::out_of_range(fmt::format("GetHandle was called with an invalid or closed handle or one of a different type: 0x{:X}", handle));
+                return object;
             }
 
             /**
@@ -197,10 +282,9 @@ namespace skyline {
 
             /**
              * @brief Closes a handle in the handle table
+             * @return If the handle was open prior to this, nothing is done if it wasn't
              */
-            void CloseHandle(KHandle handle) {
-                handles.at(handle - constant::BaseHandleIndex) = nullptr;
-            }
+            bool CloseHandle(KHandle handle);
 
             /**
              * @brief Clear the process handle table
@@ -219,6 +303,7 @@ namespace skyline {
 
             /**
              * @brief Unlocks the mutex at the specified address
+             * @note An uncontended mutex is released with a single CAS on guest memory without any kernel locks being taken
              */
             void MutexUnlock(u32 *mutex);
 
@@ -229,6 +314,7 @@ namespace skyline {
 
             /**
              * @brief Signals the conditional variable at the specified address
+             * @note This returns without locking if the waiter flag in the key isn't set as there can be no waiters
              */
             void ConditionVariableSignal(u32 *key, i32 amount);
 
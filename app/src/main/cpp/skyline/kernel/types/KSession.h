@@ -16,8 +16,8 @@ namespace skyline::kernel::type {
     class KSession : public KSyncObject {
       public:
         std::shared_ptr<service::BaseService> serviceObject;
-        std::vector<std::shared_ptr<service::BaseService>> domains; //!< A vector of services that correspond to virtual handles
-        KHandle handleIndex{}; //!< The currently allocated handle index
+        std::vector<std::shared_ptr<service::BaseService>> domains; //!< A vector of services that correspond to virtual handles, closed objects leave a null entry behind
+        std::vector<KHandle> freeObjectIds; //!< The object IDs of closed domain objects, these are reused before the domain is grown so it doesn't grow unbounded with sub-interfaces being opened and closed
         bool isOpen{true}; //!< If the session is open or not
         bool isDomain{}; //!< If this is a domain session or not
 
@@ -33,8 +33,31 @@ namespace skyline::kernel::type {
          */
         KHandle ConvertDomain() {
             isDomain = true;
-            domains.push_back(serviceObject);
-            return handleIndex++;
+            return AddDomainObject(serviceObject);
+        }
+
+        /**
+         * @brief Inserts a service into the domain
+         * @return The object ID of the service in the domain
+         */
+        KHandle AddDomainObject(std::shared_ptr<service::BaseService> service) {
+            if (!freeObjectIds.empty()) {
+                KHandle objectId{freeObjectIds.back()};
+                freeObjectIds.pop_back();
+                domains[objectId] = std::move(service);
+                return objectId;
+            }
+
+            domains.push_back(std::move(service));
+            return static_cast<KHandle>(domains.size() - 1);
+        }
+
+        /**
+         * @brief Removes a service from the domain, its object ID may be reused by subsequently added services
+         */
+        void CloseDomainObject(KHandle objectId) {
+            domains[objectId].reset();
+            freeObjectIds.push_back(objectId);
         }
     };
 }
@@ -22,6 +22,50 @@ namespace skyline::kernel::type {
         host = span<u8>{hostPtr, size};
     }
 
+    KSharedMemory::KSharedMemory(const DeviceState &state, span<u8> guestMemory, memory::Permission permission, memory::MemoryState memState)
+        : memoryState(memState),
+          KMemory(state, KType::KTransferMemory, span<u8>{}) {
+        // The guest address space is backed by shared anonymous memory, so it can be mirrored on the host without copying it
+        // This fails if the memory isn't entirely within a single host mapping, in which case we fall back to a separate backing which the contents are copied into
+        void *mirror{MAP_FAILED};
+        if (state.process->memory.base.contains(guestMemory))
+            mirror = mremap(guestMemory.data(), 0, guestMemory.size(), MREMAP_MAYMOVE);
+
+        if (mirror == MAP_FAILED) {
+            fd = ASharedMemory_create("HOS-KTransferMemory", guestMemory.size());
+            if (fd < 0)
+                throw exception("An error occurred while creating transfer memory: {}", fd);
+
+            auto hostPtr{static_cast<u8 *>(mmap(nullptr, guestMemory.size(), PROT_READ | PROT_WRITE | PROT_EXEC, MAP_SHARED, fd, 0))};
+            if (hostPtr == MAP_FAILED)
+                throw exception("An occurred while mapping transfer memory: {}", strerror(errno));
+
+            host = span<u8>{hostPtr, guestMemory.size()};
+            host.copy_from(guestMemory);
+            Map(guestMemory, permission);
+            return;
+        }
+
+        if (mprotect(mirror, guestMemory.size(), PROT_READ | PROT_WRITE))
+            throw exception("An error occurred while updating the permissions of the transfer memory mirror: {}", strerror(errno));
+        host = span<u8>{static_cast<u8 *>(mirror), guestMemory.size()};
+
+        if (mprotect(guestMemory.data(), guestMemory.size(), permission.Get()))
+            throw exception("An error occurred while borrowing transfer memory: {}", strerror(errno));
+        guest = guestMemory;
+
+        state.process->memory.InsertChunk(ChunkDescriptor{
+            .ptr = guest.data(),
+            .size = guest.size(),
+            .permission = permission,
+            .state = memoryState,
+            .attributes = memory::MemoryAttribute{
+                .isBorrowed = true,
+            },
+            .memory = this
+        });
+    }
+
     u8 *KSharedMemory::Map(span<u8> map, memory::Permission permission) {
         if (!state.process->memory.AddressSpaceContains(map))
             throw exception("KPrivateMemory allocation isn't inside guest address space: 0x{:X} - 0x{:X}", map.data(), map.end().base());
@@ -104,14 +148,20 @@ namespace skyline::kernel::type {
                     .state = memory::states::Unmapped,
                 });
             } else {
-                // KTransferMemory remaps the region with R/W permissions during destruction
+                // KTransferMemory returns the region to the guest with R/W permissions during destruction
                 constexpr memory::Permission UnborrowPermission{true, true, false};
 
-                if (mmap(guest.data(), guest.size(), UnborrowPermission.Get(), MAP_SHARED | MAP_FIXED | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
-                    Logger::Warn("An error occurred while remapping transfer memory: {}", strerror(errno));
-                else if (!host.valid())
-                    Logger::Warn("Expected host mapping of transfer memory to be valid during KTransferMemory destruction");
-                guest.copy_from(host);
+                if (fd < 0) {
+                    // The host mirror aliases the guest memory so it already holds the contents, only the permissions need to be restored
+                    if (mprotect(guest.data(), guest.size(), UnborrowPermission.Get()))
+                        Logger::Warn("An error occurred while unborrowing transfer memory: {}", strerror(errno));
+                } else {
+                    if (mmap(guest.data(), guest.size(), UnborrowPermission.Get(), MAP_SHARED | MAP_FIXED | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+                        Logger::Warn("An error occurred while remapping transfer memory: {}", strerror(errno));
+                    else if (!host.valid())
+                        Logger::Warn("Expected host mapping of transfer memory to be valid during KTransferMemory destruction");
+                    guest.copy_from(host);
+                }
 
                 state.process->memory.InsertChunk(ChunkDescriptor{
                     .ptr = guest.data(),
@@ -129,6 +179,7 @@ namespace skyline::kernel::type {
         if (host.valid())
             munmap(host.data(), host.size());
 
-        close(fd);
+        if (fd >= 0)
+            close(fd);
     }
 }
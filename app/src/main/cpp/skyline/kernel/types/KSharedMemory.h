@@ -11,7 +11,7 @@ namespace skyline::kernel::type {
      */
     class KSharedMemory : public KMemory {
       private:
-        int fd; //!< A file descriptor to the underlying shared memory
+        int fd{-1}; //!< A file descriptor to the underlying shared memory, this is -1 for transfer memory which aliases the guest memory directly
         memory::MemoryState memoryState; //!< The state of the memory as supplied initially, this is retained for any mappings
 
       public:
@@ -19,6 +19,13 @@ namespace skyline::kernel::type {
 
         KSharedMemory(const DeviceState &state, size_t size, memory::MemoryState memState = memory::states::SharedMemory, KType type = KType::KSharedMemory);
 
+        /**
+         * @brief Creates transfer memory out of the supplied guest memory and borrows it from the guest
+         * @details The host mirror aliases the guest memory itself when possible, so borrowing and unborrowing it only changes the guest permissions rather than moving the contents between mappings
+         * @note 'guestMemory' needs to be in guest-reserved address space
+         */
+        KSharedMemory(const DeviceState &state, span<u8> guestMemory, memory::Permission permission, memory::MemoryState memState);
+
         /**
          * @note 'ptr' needs to be in guest-reserved address space
          */
@@ -6,23 +6,41 @@
 
 namespace skyline::kernel::type {
     void KSyncObject::Signal() {
+        // Waiters are only queued under the lock after observing the object as unsignalled and they're all woken by the signal which sets it, so an already signalled object can't have any waiters
+        if (signalled.load(std::memory_order_acquire))
+            return;
+
         std::scoped_lock lock{syncObjectMutex};
-        signalled = true;
-        for (auto &waiter : syncObjectWaiters) {
-            if (waiter->isCancellable) {
-                waiter->isCancellable = false;
-                waiter->wakeObject = this;
-                state.scheduler->InsertThread(waiter);
+        signalled.store(true, std::memory_order_release);
+        for (auto waiter{waitersHead}; waiter; waiter = waiter->next) {
+            auto thread{waiter->thread};
+            if (thread->isCancellable) {
+                thread->isCancellable = false;
+                thread->wakeObject = this;
+                state.scheduler->InsertThread(thread->shared_from_this());
             }
         }
     }
 
     bool KSyncObject::ResetSignal() {
-        std::scoped_lock lock{syncObjectMutex};
-        if (signalled) [[likely]] {
-            signalled = false;
-            return true;
-        }
-        return false;
+        // Resetting never wakes any waiters so it doesn't need to be serialized with them
+        return signalled.exchange(false, std::memory_order_acq_rel);
+    }
+
+    void KSyncObject::AddWaiter(SyncWaiter &waiter) {
+        auto next{waitersHead};
+        while (next && next->priority <= waiter.priority)
+            next = next->next;
+
+        waiter.next = next;
+        waiter.prev = next ? next->prev : waitersTail;
+        (waiter.prev ? waiter.prev->next : waitersHead) = &waiter;
+        (next ? next->prev : waitersTail) = &waiter;
+    }
+
+    void KSyncObject::RemoveWaiter(SyncWaiter &waiter) {
+        (waiter.prev ? waiter.prev->next : waitersHead) = waiter.next;
+        (waiter.next ? waiter.next->prev : waitersTail) = waiter.prev;
+        waiter.prev = waiter.next = nullptr;
     }
 }
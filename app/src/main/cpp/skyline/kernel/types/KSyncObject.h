@@ -12,9 +12,22 @@ namespace skyline::kernel::type {
      */
     class KSyncObject : public KObject {
       public:
+        static constexpr size_t MaxSyncHandles{0x40}; //!< The total amount of objects that a thread can wait on at once
+
+        /**
+         * @brief An intrusive node linking a waiting thread into an object's waiter list, these are stored on the thread itself so waiting never allocates
+         */
+        struct SyncWaiter {
+            KThread *thread{}; //!< The thread which is waiting, it's kept alive by the wait itself
+            i8 priority{}; //!< The priority of the thread at the time it started waiting, this determines the position of the node in the list
+            SyncWaiter *prev{};
+            SyncWaiter *next{};
+        };
+
         inline static std::mutex syncObjectMutex; //!< A global lock used for locking all signalling to avoid races
-        std::list<std::shared_ptr<KThread>> syncObjectWaiters; //!< A list of threads waiting on this object to be signalled
-        bool signalled; //!< If the current object is signalled (An object stays signalled till the signal has been explicitly reset)
+        SyncWaiter *waitersHead{}; //!< The first node in a list of threads waiting on this object to be signalled sorted by priority
+        SyncWaiter *waitersTail{};
+        std::atomic<bool> signalled; //!< If the current object is signalled (An object stays signalled till the signal has been explicitly reset), this may be read without holding 'syncObjectMutex'
 
         /**
          * @param presignalled If this object should be signalled initially or not
@@ -23,6 +36,7 @@ namespace skyline::kernel::type {
 
         /**
          * @brief Wakes up any waiters on this object and flips the 'signalled' flag
+         * @note This doesn't lock 'syncObjectMutex' if the object is already signalled as there can be no waiters
          */
         void Signal();
 
@@ -32,6 +46,18 @@ namespace skyline::kernel::type {
          */
         bool ResetSignal();
 
+        /**
+         * @brief Inserts the supplied node into the waiter list after all waiters with an equal or higher priority
+         * @note 'syncObjectMutex' must be locked by the calling thread
+         */
+        void AddWaiter(SyncWaiter &waiter);
+
+        /**
+         * @brief Unlinks the supplied node from the waiter list
+         * @note 'syncObjectMutex' must be locked by the calling thread
+         */
+        void RemoveWaiter(SyncWaiter &waiter);
+
         virtual ~KSyncObject() = default;
     };
 }
@@ -3,14 +3,81 @@
 
 #include <cxxabi.h>
 #include <unistd.h>
+#include <queue>
 #include <common/signal.h>
 #include <common/trace.h>
+#include <common/performance_hint.h>
 #include <nce.h>
 #include <os.h>
 #include "KProcess.h"
 #include "KThread.h"
 
 namespace skyline::kernel::type {
+    namespace {
+        /**
+         * @brief A pool of parked host threads which guest threads are started on, this avoids creating and tearing down a host thread for every short-lived guest thread
+         * @note Pooled host threads aren't tied to any KThread, all state that KThread::StartThread sets up on the host thread is either overwritten by it or reset here between guest threads
+         * @note The pool is intentionally leaked as parked threads may outlive the emulation session which created them
+         */
+        class HostThreadPool {
+          private:
+            static constexpr size_t MaxParkedThreads{8}; //!< The maximum amount of idle host threads kept parked, any host thread beyond this exits once it's done with its guest thread
+
+            std::mutex mutex;
+            std::condition_variable condition; //!< Signalled when a guest thread is queued for a parked host thread
+            std::queue<std::function<void()>> pending; //!< Guest threads which are yet to be picked up by a host thread
+            size_t parkedThreads{}; //!< The amount of host threads waiting for a guest thread that haven't been assigned one yet
+
+            void Run(std::function<void()> job) {
+                sigset_t signalMask{}, emptySet{};
+                signal::Sigprocmask(SIG_BLOCK, emptySet, &signalMask);
+
+                while (true) {
+                    job();
+                    job = nullptr; // This drops the reference to the KThread so it can be destroyed prior to the host thread being reused
+
+                    // Guest threads can leave the host thread in a state that'd affect the next one, such as blocking SIGINT when killing the process
+                    DeviceState::thread = nullptr;
+                    DeviceState::ctx = nullptr;
+                    Scheduler::YieldPending = false;
+                    signal::Sigprocmask(SIG_SETMASK, signalMask);
+
+                    std::unique_lock lock{mutex};
+                    if (parkedThreads >= MaxParkedThreads)
+                        return;
+
+                    parkedThreads++;
+                    condition.wait(lock, [this] { return !pending.empty(); });
+                    job = std::move(pending.front());
+                    pending.pop();
+                }
+            }
+
+          public:
+            static HostThreadPool &Get() {
+                static auto *pool{new HostThreadPool()};
+                return *pool;
+            }
+
+            /**
+             * @brief Runs the supplied guest thread entry on a parked host thread or a new one if none are parked
+             */
+            void Start(std::function<void()> job) {
+                {
+                    std::scoped_lock lock{mutex};
+                    if (parkedThreads) {
+                        parkedThreads--;
+                        pending.push(std::move(job));
+                        condition.notify_one();
+                        return;
+                    }
+                }
+
+                std::thread(&HostThreadPool::Run, this, std::move(job)).detach();
+            }
+        };
+    }
+
     KThread::KThread(const DeviceState &state, KHandle handle, KProcess *parent, size_t id, void *entry, u64 argument, void *stackTop, i8 priority, u8 idealCore)
         : handle(handle),
           parent(parent),
@@ -24,14 +91,12 @@ namespace skyline::kernel::type {
           coreId(idealCore),
           KSyncObject(state, KType::KThread) {
         affinityMask.set(coreId);
+        if (state.os->guestProfiler)
+            profilerSamples = std::make_unique<GuestProfiler::SampleRing>();
     }
 
     KThread::~KThread() {
         Kill(true);
-        if (thread.joinable())
-            thread.join();
-        if (preemptionTimer)
-            timer_delete(preemptionTimer);
     }
 
     void KThread::StartThread() {
@@ -51,6 +116,10 @@ namespace skyline::kernel::type {
         state.ctx = &ctx;
         state.thread = shared_from_this();
 
+        std::optional<host::PerformanceHint::ScopedThread> performanceHintThread;
+        if (!id)
+            performanceHintThread.emplace(); // The main thread of most titles is the one that drives their frames
+
         if (setjmp(originalCtx)) { // Returns 1 if it's returning from guest, 0 otherwise
             state.scheduler->RemoveThread();
 
@@ -72,16 +141,10 @@ namespace skyline::kernel::type {
             return;
         }
 
-        struct sigevent event{
-            .sigev_signo = Scheduler::PreemptionSignal,
-            .sigev_notify = SIGEV_THREAD_ID,
-            .sigev_notify_thread_id = gettid(),
-        };
-        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &preemptionTimer))
-            throw exception("timer_create has failed with '{}'", strerror(errno));
-
         signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE, SIGSEGV}, nce::NCE::SignalHandler);
         signal::SetSignalHandler({Scheduler::YieldSignal, Scheduler::PreemptionSignal}, Scheduler::SignalHandler, false); // We want futexes to fail and their predicates rechecked
+        if (profilerSamples)
+            signal::SetSignalHandler({GuestProfiler::SampleSignal}, GuestProfiler::SignalHandler); // Sampling shouldn't have any visible effect on the thread, so syscalls are restarted
 
         {
             std::scoped_lock lock{statusMutex};
@@ -220,7 +283,8 @@ namespace skyline::kernel::type {
                 lock.unlock();
                 StartThread();
             } else {
-                thread = std::thread(&KThread::StartThread, this);
+                // The pooled host thread holds a reference to this thread till it's done with it, so it can't be destroyed while it's still running
+                HostThreadPool::Get().Start([thread{shared_from_this()}] { thread->StartThread(); });
             }
         }
     }
@@ -246,30 +310,10 @@ namespace skyline::kernel::type {
             pthread_kill(pthread, signal);
     }
 
-    void KThread::ArmPreemptionTimer(std::chrono::nanoseconds timeToFire) {
-        std::unique_lock lock(statusMutex);
-        statusCondition.wait(lock, [this]() { return ready || killed; });
-        if (!killed && running) {
-            struct itimerspec spec{.it_value = {
-                .tv_nsec = std::min(static_cast<i64>(timeToFire.count()), constant::NsInSecond),
-                .tv_sec = std::max(std::chrono::duration_cast<std::chrono::seconds>(timeToFire).count() - 1, 0LL),
-            }};
-            timer_settime(preemptionTimer, 0, &spec, nullptr);
-            isPreempted = true;
-        }
-    }
-
-    void KThread::DisarmPreemptionTimer() {
-        if (!isPreempted) [[unlikely]]
-            return;
-
-        std::unique_lock lock(statusMutex);
-        statusCondition.wait(lock, [this]() { return ready || killed; });
-        if (!killed && running) {
-            struct itimerspec spec{};
-            timer_settime(preemptionTimer, 0, &spec, nullptr);
-            isPreempted = false;
-        }
+    void KThread::TrySendSignal(int signal) {
+        std::scoped_lock lock(statusMutex);
+        if (ready && !killed && running)
+            pthread_kill(pthread, signal);
     }
 
     void KThread::UpdatePriorityInheritance() {
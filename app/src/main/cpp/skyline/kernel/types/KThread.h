@@ -6,6 +6,7 @@
 #include <csetjmp>
 #include <nce/guest.h>
 #include <kernel/scheduler.h>
+#include <kernel/guest_profiler.h>
 #include <common/signal.h>
 #include <common/spin_lock.h>
 #include "KSyncObject.h"
@@ -20,13 +21,11 @@ namespace skyline {
         class KThread : public KSyncObject, public std::enable_shared_from_this<KThread> {
           private:
             KProcess *parent;
-            std::thread thread; //!< If this KThread is backed by a host thread then this'll hold it
             pthread_t pthread{}; //!< The pthread_t for the host thread running this guest thread
-            timer_t preemptionTimer{}; //!< A kernel timer used for preemption interrupts
 
             /**
              * @brief Entry function any guest threads, sets up necessary context and jumps into guest code from the calling thread
-             * @note This function also serves as the entry point for host threads created in StartThread
+             * @note This function also serves as the entry point for guest threads started on pooled host threads in Start
              */
             void StartThread();
 
@@ -47,19 +46,24 @@ namespace skyline {
             u64 entryArgument; //!< An argument to provide with to the thread entry function
             void *stackTop; //!< The top of the guest's stack, this is set to the initial guest stack pointer
 
-            std::condition_variable scheduleCondition; //!< Signalled to wake the thread when it's scheduled or its resident core changes
+            std::atomic<u32> scheduleFutex{}; //!< A futex word which is advanced to wake the thread when it's scheduled or its resident core changes, the lowest bit is set while the thread is sleeping on it (See Scheduler::WakeThread)
             std::atomic<i8> basePriority; //!< The priority of the thread for the scheduler without any priority-inheritance
             std::atomic<i8> priority; //!< The priority of the thread for the scheduler including priority-inheritance
 
             std::recursive_mutex coreMigrationMutex; //!< Synchronizes operations which depend on which core the thread is running on
             u8 idealCore; //!< The ideal CPU core for this thread to run on
             u8 coreId; //!< The CPU core on which this thread is running
+            KThread *schedulerPrev{}; //!< The previous thread in the resident core's scheduler queue for this thread's priority
+            KThread *schedulerNext{}; //!< The next thread in the resident core's scheduler queue for this thread's priority
+            i8 schedulerPriority{}; //!< The priority of the scheduler queue this thread is in, this may differ from 'priority' till the scheduler has been updated
+            bool isQueued{}; //!< If the thread is in its resident core's scheduler queue
+            u64 schedulerLoad{}; //!< The estimated timeslice that this thread contributed to its resident core's load when it was queued
             CoreMask affinityMask{}; //!< A mask of CPU cores this thread is allowed to run on
 
             u64 timesliceStart{}; //!< A timestamp in host CNTVCT ticks of when the thread's current timeslice started
             u64 averageTimeslice{}; //!< A weighted average of the timeslice duration for this thread
 
-            bool isPreempted{}; //!< If the preemption timer has been armed and will fire
+            bool isPreempted{}; //!< If the timeslice of the thread is being timed by the scheduler and it'll be preempted on expiry
             bool pendingYield{}; //!< If the thread has been yielded and hasn't been acted upon it yet
             bool forceYield{}; //!< If the thread has been forcefully yielded by another thread
 
@@ -75,7 +79,9 @@ namespace skyline {
             bool isCancellable{false}; //!< If the thread is currently in a position where it's cancellable
             bool cancelSync{false}; //!< Whether to cancel the SvcWaitSynchronization call this thread currently is in/the next one it joins
             type::KSyncObject *wakeObject{}; //!< A pointer to the synchronization object responsible for waking this thread up
+            std::array<KSyncObject::SyncWaiter, KSyncObject::MaxSyncHandles> syncWaiters{}; //!< The nodes used to link this thread into the waiter lists of the objects it's waiting on, the node at an index corresponds to the handle at the same index
 
+            std::unique_ptr<GuestProfiler::SampleRing> profilerSamples; //!< The ring which the guest profiler records the samples of this thread into, this is only allocated while profiling
             bool isPaused{false}; //!< If the thread is currently paused and not runnable
             bool insertThreadOnResume{false}; //!< If the thread should be inserted into the scheduler when it resumes (used for pausing threads during sleep/sync)
 
@@ -84,7 +90,7 @@ namespace skyline {
             ~KThread();
 
             /**
-             * @param self If the calling thread should jump directly into guest code or if a new thread should be created for it
+             * @param self If the calling thread should jump directly into guest code or if it should be started on a pooled host thread
              * @note If the thread is already running then this does nothing
              * @note 'stack' will be created if it wasn't set prior to calling this
              */
@@ -101,14 +107,9 @@ namespace skyline {
             void SendSignal(int signal);
 
             /**
-             * @brief Arms the preemption kernel timer to fire in the specified amount of time
+             * @brief Sends a host OS signal to the thread if it's ready to receive them, unlike SendSignal this never blocks on the thread becoming ready
              */
-            void ArmPreemptionTimer(std::chrono::nanoseconds timeToFire);
-
-            /**
-             * @brief Disarms the preemption kernel timer, any scheduled firings will be cancelled
-             */
-            void DisarmPreemptionTimer();
+            void TrySendSignal(int signal);
 
             /**
              * @brief Recursively updates the priority for any threads this thread might be waiting on
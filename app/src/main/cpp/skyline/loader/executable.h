@@ -43,6 +43,7 @@ namespace skyline::loader {
         Segment ro; //!< The .rodata segment container
         Segment data; //!< The .data segment container
         size_t bssSize; //!< The size of the .bss segment
+        u64 textHash; //!< An XXH3 hash of the .text segment if it's already known, 0 otherwise
 
         struct RelativeSegment {
             size_t offset; //!< The offset from the base address of the related segment that this is segment is located at
@@ -27,14 +27,22 @@ namespace skyline::loader {
         if (!util::IsPageAligned(executable.text.offset) || !util::IsPageAligned(executable.ro.offset) || !util::IsPageAligned(executable.data.offset))
             throw exception("Section offsets are not aligned with page size: 0x{:X}, 0x{:X}, 0x{:X}", executable.text.offset, executable.ro.offset, executable.data.offset);
 
-        auto patch{state.nce->GetPatchData(executable.text.contents)};
+        auto patch{state.nce->GetCachedPatchData(executable.text.contents, executable.textHash)};
 
         span dynsym{reinterpret_cast<Elf64_Sym *>(executable.ro.contents.data() + executable.dynsym.offset), executable.dynsym.size / sizeof(Elf64_Sym)};
         span dynstr{reinterpret_cast<char *>(executable.ro.contents.data() + executable.dynstr.offset), executable.dynstr.size};
         std::vector<nce::NCE::HookedSymbolEntry> executableSymbols;
         size_t hookSize{};
         if (dynamicallyLinked) {
-            if constexpr (!hle::HookedSymbols.empty()) {
+            bool serviceFastPath{*state.settings->hleServiceFastPath};
+            if (!hle::HookedSymbols.empty() || serviceFastPath) {
+                auto findHook{[](auto &table, std::string_view symbolName) -> const hle::HookTableEntry * {
+                    auto item{std::find_if(table.begin(), table.end(), [&symbolName](const auto &item) {
+                        return item.name == symbolName;
+                    })};
+                    return item != table.end() ? &*item : nullptr;
+                }};
+
                 for (auto &symbol : dynsym) {
                     if (symbol.st_name == 0 || symbol.st_value == 0)
                         continue;
@@ -44,10 +52,10 @@ namespace skyline::loader {
 
                     std::string_view symbolName{dynstr.data() + symbol.st_name};
 
-                    auto item{std::find_if(hle::HookedSymbols.begin(), hle::HookedSymbols.end(), [&symbolName](const auto &item) {
-                        return item.name == symbolName;
-                    })};
-                    if (item != hle::HookedSymbols.end()) {
+                    auto item{findHook(hle::HookedSymbols, symbolName)};
+                    if (!item && serviceFastPath)
+                        item = findHook(hle::ServiceFastPathSymbols, symbolName);
+                    if (item) {
                         executableSymbols.emplace_back(std::string{symbolName}, item->hook, &symbol.st_value);
                         continue;
                     }
@@ -129,6 +137,7 @@ namespace skyline::loader {
         std::memcpy(executableBase, executable.text.contents.data(), executable.text.contents.size());
         std::memcpy(executableBase + executable.ro.offset, executable.ro.contents.data(), roSize);
         std::memcpy(executableBase + executable.data.offset, executable.data.contents.data(), dataSize - executable.bssSize);
+        process->memory.Prefault(span<u8>{executableBase + executable.data.offset + (dataSize - executable.bssSize), executable.bssSize}); // The rest of the executable has been faulted in by being copied into place
 
         Logger::EmulationContext.Flush();
         return {base, size, executableBase + executable.text.offset};
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <fstream>
+#include <filesystem>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "metadata_cache.h"
+
+namespace skyline::loader {
+    /**
+     * @brief The header of an entry file, this is followed by the path and the contents of all metadata fields in the order of their sizes
+     */
+    struct MetadataCacheEntryHeader {
+        u32 magic{util::MakeMagic<u32>("SMDC")};
+        u32 version{1}; //!< The version of the entry format, this must be incremented after any changes to it
+        u64 size;
+        i64 modificationTime;
+        u32 language;
+        u32 pathSize;
+        u32 applicationNameSize;
+        u32 applicationVersionSize;
+        u32 applicationTitleIdSize;
+        u32 applicationAuthorSize;
+        u32 iconSize;
+        u64 checksum; //!< An XXH64 hash of everything following the header
+    };
+
+    static constexpr u32 MaxEntryFieldSize{0x100000}; //!< The maximum size of a single field in an entry (1 MiB), this guards against allocating arbitrary amounts of memory for corrupted entries
+
+    MetadataCache::MetadataCache(std::string directory) : directory(std::move(directory)) {}
+
+    std::string MetadataCache::GetEntryPath(const Key &key) {
+        // Entries are named after a hash of the path and language, the full path is stored in the entry to detect collisions
+        u64 hash{XXH64(key.path.data(), key.path.size(), key.language)};
+        return fmt::format("{}/{:016X}.bin", directory, hash);
+    }
+
+    std::optional<MetadataCache::Key> MetadataCache::GetKey(int fd, u32 language) {
+        // ROMs are supplied as file descriptors by the frontend, their path is resolved through procfs
+        std::array<char, PATH_MAX> path{};
+        auto pathSize{readlink(fmt::format("/proc/self/fd/{}", fd).c_str(), path.data(), path.size() - 1)};
+        if (pathSize <= 0)
+            return std::nullopt;
+
+        struct stat stat{};
+        if (fstat(fd, &stat) || !S_ISREG(stat.st_mode))
+            return std::nullopt;
+
+        return Key{
+            .path = std::string(path.data(), static_cast<size_t>(pathSize)),
+            .size = static_cast<u64>(stat.st_size),
+            .modificationTime = static_cast<i64>(stat.st_mtim.tv_sec) * constant::NsInSecond + stat.st_mtim.tv_nsec,
+            .language = language,
+        };
+    }
+
+    std::optional<RomMetadata> MetadataCache::Read(const Key &key) {
+        std::ifstream stream{GetEntryPath(key), std::ios::binary};
+        if (!stream.good())
+            return std::nullopt;
+
+        MetadataCacheEntryHeader header{};
+        MetadataCacheEntryHeader expectedHeader{};
+        if (!stream.read(reinterpret_cast<char *>(&header), sizeof(MetadataCacheEntryHeader)) || header.magic != expectedHeader.magic || header.version != expectedHeader.version)
+            return std::nullopt;
+
+        if (header.size != key.size || header.modificationTime != key.modificationTime || header.language != key.language || header.pathSize != key.path.size())
+            return std::nullopt; // The file was modified since the entry was written or the entry is for a different file
+
+        for (auto fieldSize : {header.pathSize, header.applicationNameSize, header.applicationVersionSize, header.applicationTitleIdSize, header.applicationAuthorSize, header.iconSize})
+            if (fieldSize > MaxEntryFieldSize)
+                return std::nullopt;
+
+        std::vector<u8> contents(static_cast<size_t>(header.pathSize) + header.applicationNameSize + header.applicationVersionSize + header.applicationTitleIdSize + header.applicationAuthorSize + header.iconSize);
+        if (!stream.read(reinterpret_cast<char *>(contents.data()), static_cast<std::streamsize>(contents.size())) || XXH64(contents.data(), contents.size(), 0) != header.checksum)
+            return std::nullopt;
+
+        auto readField{[&, offset = size_t{}](u32 fieldSize) mutable {
+            span<u8> field{contents.data() + offset, fieldSize};
+            offset += fieldSize;
+            return field;
+        }};
+
+        if (readField(header.pathSize).as_string() != key.path)
+            return std::nullopt;
+
+        RomMetadata metadata{
+            .applicationName = std::string(readField(header.applicationNameSize).as_string()),
+            .applicationVersion = std::string(readField(header.applicationVersionSize).as_string()),
+            .applicationTitleId = std::string(readField(header.applicationTitleIdSize).as_string()),
+            .applicationAuthor = std::string(readField(header.applicationAuthorSize).as_string()),
+        };
+        auto icon{readField(header.iconSize)};
+        metadata.icon.assign(icon.begin(), icon.end());
+        return metadata;
+    }
+
+    void MetadataCache::Write(const Key &key, const RomMetadata &metadata) {
+        std::vector<u8> contents;
+        for (std::string_view field : {std::string_view{key.path}, std::string_view{metadata.applicationName}, std::string_view{metadata.applicationVersion}, std::string_view{metadata.applicationTitleId}, std::string_view{metadata.applicationAuthor}})
+            contents.insert(contents.end(), field.begin(), field.end());
+        contents.insert(contents.end(), metadata.icon.begin(), metadata.icon.end());
+
+        MetadataCacheEntryHeader header{
+            .size = key.size,
+            .modificationTime = key.modificationTime,
+            .language = key.language,
+            .pathSize = static_cast<u32>(key.path.size()),
+            .applicationNameSize = static_cast<u32>(metadata.applicationName.size()),
+            .applicationVersionSize = static_cast<u32>(metadata.applicationVersion.size()),
+            .applicationTitleIdSize = static_cast<u32>(metadata.applicationTitleId.size()),
+            .applicationAuthorSize = static_cast<u32>(metadata.applicationAuthor.size()),
+            .iconSize = static_cast<u32>(metadata.icon.size()),
+            .checksum = XXH64(contents.data(), contents.size(), 0),
+        };
+
+        // The entry is written to a temporary file which is renamed over the entry, so a concurrent scan never reads a partially written entry
+        auto path{GetEntryPath(key)};
+        auto temporaryPath{fmt::format("{}.{}.tmp", path, gettid())};
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        {
+            std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+            stream.write(reinterpret_cast<const char *>(&header), sizeof(MetadataCacheEntryHeader));
+            stream.write(reinterpret_cast<const char *>(contents.data()), static_cast<std::streamsize>(contents.size()));
+            if (!stream.good()) {
+                Logger::Warn("Failed to write the metadata cache entry for '{}'", key.path);
+                stream.close();
+                std::filesystem::remove(temporaryPath, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error) {
+            Logger::Warn("Failed to commit the metadata cache entry for '{}': {}", key.path, error.message());
+            std::filesystem::remove(temporaryPath, error);
+        }
+    }
+}
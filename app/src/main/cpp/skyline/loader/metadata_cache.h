@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::loader {
+    /**
+     * @brief The metadata of a ROM that's displayed in the game library
+     */
+    struct RomMetadata {
+        std::string applicationName;
+        std::string applicationVersion;
+        std::string applicationTitleId;
+        std::string applicationAuthor;
+        std::vector<u8> icon; //!< The JPEG-encoded icon of the application, this is stored as-is since it's already compressed
+    };
+
+    /**
+     * @brief A persistent cache of ROM metadata, this avoids fully parsing every ROM (including key derivation and NCA decryption) on every scan of the game library
+     * @details Every ROM has an entry file of its own, so concurrent scans of different ROMs never contend on the cache. An entry is keyed by the path of the ROM alongside its size and modification time, so any change to the file invalidates it
+     * @note Only successfully parsed ROMs are cached, so ROMs which failed to parse due to missing keys are parsed again after keys are imported
+     */
+    class MetadataCache {
+      public:
+        /**
+         * @brief The identity of the ROM file that an entry was created from
+         */
+        struct Key {
+            std::string path;
+            u64 size;
+            i64 modificationTime; //!< The modification time of the file in nanoseconds
+            u32 language; //!< The system language the metadata was resolved with, this affects the application name, author and icon
+        };
+
+      private:
+        std::string directory;
+
+        /**
+         * @return The path of the entry file for the supplied key
+         */
+        std::string GetEntryPath(const Key &key);
+
+      public:
+        /**
+         * @param directory The directory containing the entry files, it's created on the first write
+         */
+        MetadataCache(std::string directory);
+
+        /**
+         * @return The key for the ROM file with the supplied descriptor, this is empty if the identity of the file couldn't be determined in which case it mustn't be cached
+         */
+        static std::optional<Key> GetKey(int fd, u32 language);
+
+        /**
+         * @return The cached metadata for the supplied key, this is empty if there's no valid entry for it
+         */
+        std::optional<RomMetadata> Read(const Key &key);
+
+        /**
+         * @brief Writes an entry for the supplied key, failures are only logged as the cache is an optimization
+         */
+        void Write(const Key &key, const RomMetadata &metadata);
+    };
+}
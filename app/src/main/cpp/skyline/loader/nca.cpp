@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <future>
 #include <kernel/types/KProcess.h>
 #include <vfs/npdm.h>
 #include "nso.h"
@@ -19,24 +20,31 @@ namespace skyline::loader {
         if (!exeFs->FileExists("rtld"))
             throw exception("Cannot load an ExeFS that doesn't contain rtld");
 
-        auto nsoFile{exeFs->OpenFile("rtld")};
+        // Every module is read and decompressed in parallel, they're then loaded in order as the placement of each depends on the size of all prior ones after patching
+        auto snapshotDirectory{NsoLoader::GetSnapshotDirectory(state)};
+        auto readModule{[&](const char *nso) {
+            return std::async(std::launch::async, NsoLoader::ReadNso, exeFs->OpenFile(nso), snapshotDirectory);
+        }};
+
+        auto rtld{readModule("rtld")};
+        std::vector<std::pair<const char *, std::future<Executable>>> modules;
+        for (const auto &nso : {"main", "subsdk0", "subsdk1", "subsdk2", "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7", "sdk"})
+            if (exeFs->FileExists(nso))
+                modules.emplace_back(nso, readModule(nso));
 
         state.process->memory.InitializeVmm(process->npdm.meta.flags.type);
 
-        auto loadInfo{NsoLoader::LoadNso(loader, nsoFile, process, state, 0, "rtld.nso")};
+        auto rtldExecutable{rtld.get()};
+        auto loadInfo{loader->LoadExecutable(process, state, rtldExecutable, 0, "rtld.nso")};
         u64 offset{loadInfo.size};
         u8 *base{loadInfo.base};
         void *entry{loadInfo.entry};
 
         Logger::Info("Loaded 'rtld.nso' at 0x{:X} (.text @ 0x{:X})", base, entry);
 
-        for (const auto &nso : {"main", "subsdk0", "subsdk1", "subsdk2", "subsdk3", "subsdk4", "subsdk5", "subsdk6", "subsdk7", "sdk"}) {
-            if (exeFs->FileExists(nso))
-                nsoFile = exeFs->OpenFile(nso);
-            else
-                continue;
-
-            loadInfo = NsoLoader::LoadNso(loader, nsoFile, process, state, offset, nso + std::string(".nso"), true);
+        for (auto &[nso, module] : modules) {
+            auto executable{module.get()};
+            loadInfo = loader->LoadExecutable(process, state, executable, offset, nso + std::string(".nso"), true);
             Logger::Info("Loaded '{}.nso' at 0x{:X} (.text @ 0x{:X})", nso, base + offset, loadInfo.entry);
             offset += loadInfo.size;
         }
@@ -1,8 +1,16 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <future>
 #include <lz4.h>
+#include <xxhash.h>
+#include <common/file_descriptor.h>
 #include <nce.h>
+#include <os.h>
 #include <kernel/types/KProcess.h>
 #include "nso.h"
 
@@ -18,10 +26,18 @@ namespace skyline::loader {
         std::vector<u8> outputBuffer(segment.decompressedSize);
 
         if (compressedSize) {
-            std::vector<u8> compressedBuffer(compressedSize);
-            backing->Read(compressedBuffer, segment.fileOffset);
-
-            LZ4_decompress_safe(reinterpret_cast<char *>(compressedBuffer.data()), reinterpret_cast<char *>(outputBuffer.data()), static_cast<int>(compressedSize), static_cast<int>(segment.decompressedSize));
+            // Segments are decompressed directly from the backing when it can be viewed in-place, otherwise they're read into an intermediate buffer
+            std::vector<u8> compressedBuffer;
+            auto compressed{backing->View(segment.fileOffset, compressedSize)};
+            if (compressed.empty()) {
+                compressedBuffer.resize(compressedSize);
+                backing->Read(compressedBuffer, segment.fileOffset);
+                compressed = compressedBuffer;
+            }
+
+            auto decompressedSize{LZ4_decompress_safe(reinterpret_cast<const char *>(compressed.data()), reinterpret_cast<char *>(outputBuffer.data()), static_cast<int>(compressedSize), static_cast<int>(segment.decompressedSize))};
+            if (decompressedSize != static_cast<int>(segment.decompressedSize))
+                throw exception("Failed to decompress NSO segment: {}/0x{:X}", decompressedSize, segment.decompressedSize);
         } else {
             backing->Read(outputBuffer, segment.fileOffset);
         }
@@ -29,7 +45,91 @@ namespace skyline::loader {
         return outputBuffer;
     }
 
-    Loader::ExecutableLoadInfo NsoLoader::LoadNso(Loader *loader, const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, size_t offset, const std::string &name, bool dynamicallyLinked) {
+    bool NsoLoader::ReadSnapshot(const std::string &path, const NsoHeader &nsoHeader, Executable &executable) {
+        FileDescriptor fd{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (fd == -1)
+            return false;
+
+        struct stat stats{};
+        if (fstat(fd, &stats) == -1 || static_cast<size_t>(stats.st_size) < sizeof(SnapshotHeader))
+            return false;
+
+        auto pointer{static_cast<u8 *>(mmap(nullptr, static_cast<size_t>(stats.st_size), PROT_READ, MAP_PRIVATE, fd, 0))};
+        if (pointer == MAP_FAILED)
+            return false;
+        span<u8> mapping{pointer, static_cast<size_t>(stats.st_size)};
+
+        bool valid{[&] {
+            const auto &header{mapping.as<SnapshotHeader>()};
+            if (header.magic != SnapshotHeader::Magic || header.version != SnapshotHeader::Version || std::memcmp(&header.nso, &nsoHeader, sizeof(NsoHeader)) != 0)
+                return false;
+
+            std::array segments{&executable.text.contents, &executable.ro.contents, &executable.data.contents};
+            size_t offset{util::AlignUp(sizeof(SnapshotHeader), constant::PageSize)};
+            for (size_t index{}; index < segments.size(); index++) {
+                u64 segmentSize{header.segmentSizes[index]};
+                if (offset > mapping.size() || segmentSize > mapping.size() - offset)
+                    return false;
+
+                // Segments are validated prior to being copied out, so a corrupted snapshot is never loaded
+                u8 *contents{mapping.data() + offset};
+                if (XXH3_64bits(contents, segmentSize) != header.segmentHashes[index])
+                    return false;
+                segments[index]->assign(contents, contents + segmentSize);
+                offset += util::AlignUp(segmentSize, constant::PageSize);
+            }
+
+            executable.textHash = header.segmentHashes[0];
+            return true;
+        }()};
+
+        munmap(pointer, mapping.size());
+        return valid;
+    }
+
+    void NsoLoader::WriteSnapshot(const std::string &path, const NsoHeader &nsoHeader, Executable &executable) {
+        SnapshotHeader header{.nso = nsoHeader};
+        std::array segments{&executable.text.contents, &executable.ro.contents, &executable.data.contents};
+        for (size_t index{}; index < segments.size(); index++) {
+            header.segmentSizes[index] = segments[index]->size();
+            header.segmentHashes[index] = XXH3_64bits(segments[index]->data(), segments[index]->size());
+        }
+        executable.textHash = header.segmentHashes[0];
+
+        // Snapshots are written to a temporary file first and then renamed, so a partially written snapshot can never be read
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path{path}.parent_path(), error);
+        auto temporaryPath{path + ".tmp"};
+        {
+            std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+            std::vector<char> padding(constant::PageSize);
+            auto writePadded{[&](const void *data, size_t size) {
+                stream.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+                stream.write(padding.data(), static_cast<std::streamsize>(util::AlignUp(size, constant::PageSize) - size));
+            }};
+
+            writePadded(&header, sizeof(SnapshotHeader));
+            for (auto segment : segments)
+                writePadded(segment->data(), segment->size());
+
+            if (stream.fail()) {
+                Logger::Warn("Failed to write warm boot snapshot: {}", path);
+                stream.close();
+                std::filesystem::remove(temporaryPath, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+            Logger::Warn("Failed to commit warm boot snapshot: {} ({})", path, error.message());
+    }
+
+    std::string NsoLoader::GetSnapshotDirectory(const DeviceState &state) {
+        return *state.settings->warmBootSnapshot ? state.os->publicAppFilesPath + "warm_boot_snapshot/" : std::string{};
+    }
+
+    Executable NsoLoader::ReadNso(const std::shared_ptr<vfs::Backing> &backing, const std::string &snapshotDirectory) {
         auto header{backing->Read<NsoHeader>()};
 
         if (header.magic != util::MakeMagic<u32>("NSO0"))
@@ -37,15 +137,27 @@ namespace skyline::loader {
 
         Executable executable{};
 
-        executable.text.contents = GetSegment(backing, header.text, header.flags.textCompressed ? header.textCompressedSize : 0);
-        executable.text.contents.resize(util::AlignUp(executable.text.contents.size(), constant::PageSize));
-        executable.text.offset = header.text.memoryOffset;
+        // Snapshots are keyed by a hash of the NSO header as it contains the build ID and the hashes of all segments, so any change to the NSO results in a different snapshot
+        std::string snapshotPath{snapshotDirectory.empty() ? std::string{} : fmt::format("{}{:016X}", snapshotDirectory, XXH64(&header, sizeof(NsoHeader), 0))};
+        if (snapshotPath.empty() || !ReadSnapshot(snapshotPath, header, executable)) {
+            // .rodata and .data are decompressed on their own threads while .text is decompressed on this one, the threads are joined when the futures are retrieved or destroyed
+            auto ro{std::async(std::launch::async, GetSegment, std::cref(backing), std::cref(header.ro), header.flags.roCompressed ? header.roCompressedSize : 0)};
+            auto data{std::async(std::launch::async, GetSegment, std::cref(backing), std::cref(header.data), header.flags.dataCompressed ? header.dataCompressedSize : 0)};
 
-        executable.ro.contents = GetSegment(backing, header.ro, header.flags.roCompressed ? header.roCompressedSize : 0);
-        executable.ro.contents.resize(util::AlignUp(executable.ro.contents.size(), constant::PageSize));
-        executable.ro.offset = header.ro.memoryOffset;
+            executable.text.contents = GetSegment(backing, header.text, header.flags.textCompressed ? header.textCompressedSize : 0);
+            executable.text.contents.resize(util::AlignUp(executable.text.contents.size(), constant::PageSize));
+
+            executable.ro.contents = ro.get();
+            executable.ro.contents.resize(util::AlignUp(executable.ro.contents.size(), constant::PageSize));
+
+            executable.data.contents = data.get();
+
+            if (!snapshotPath.empty())
+                WriteSnapshot(snapshotPath, header, executable);
+        }
 
-        executable.data.contents = GetSegment(backing, header.data, header.flags.dataCompressed ? header.dataCompressedSize : 0);
+        executable.text.offset = header.text.memoryOffset;
+        executable.ro.offset = header.ro.memoryOffset;
         executable.data.offset = header.data.memoryOffset;
 
         // Data and BSS are aligned together
@@ -56,6 +168,11 @@ namespace skyline::loader {
             executable.dynstr = {header.dynstr.offset, header.dynstr.size};
         }
 
+        return executable;
+    }
+
+    Loader::ExecutableLoadInfo NsoLoader::LoadNso(Loader *loader, const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<kernel::type::KProcess> &process, const DeviceState &state, size_t offset, const std::string &name, bool dynamicallyLinked) {
+        auto executable{ReadNso(backing, GetSnapshotDirectory(state))};
         return loader->LoadExecutable(process, state, executable, offset, name, dynamicallyLinked);
     }
 
@@ -69,6 +69,20 @@ namespace skyline::loader {
         };
         static_assert(sizeof(NsoHeader) == 0x100);
 
+        /**
+         * @brief The header of a warm boot snapshot of an NSO, it's followed by the decompressed .text, .rodata and .data segments with each one starting on a page boundary
+         */
+        struct SnapshotHeader {
+            static constexpr u32 Magic{util::MakeMagic<u32>("NSOS")};
+            static constexpr u32 Version{1};
+
+            u32 magic{Magic};
+            u32 version{Version};
+            NsoHeader nso; //!< The header of the NSO that the snapshot was taken of, this covers its build ID and the hashes of all its segments
+            std::array<u64, 3> segmentSizes; //!< The sizes of the .text, .rodata and .data segments after they were decompressed and padded
+            std::array<u64, 3> segmentHashes; //!< XXH3 hashes of the .text, .rodata and .data segments
+        };
+
         /**
          * @brief Reads the specified segment from the backing and decompresses it if needed
          * @param segment The header of the segment to read
@@ -77,9 +91,33 @@ namespace skyline::loader {
          */
         static std::vector<u8> GetSegment(const std::shared_ptr<vfs::Backing> &backing, const NsoSegmentHeader &segment, u32 compressedSize);
 
+        /**
+         * @brief Reads the segments of an executable from a warm boot snapshot, the snapshot is memory-mapped and every segment is validated against its hash
+         * @return If the snapshot exists and is valid for the supplied NSO header
+         */
+        static bool ReadSnapshot(const std::string &path, const NsoHeader &header, Executable &executable);
+
+        /**
+         * @brief Writes the segments of an executable to a warm boot snapshot, this also sets the .text hash of the executable
+         */
+        static void WriteSnapshot(const std::string &path, const NsoHeader &header, Executable &executable);
+
       public:
         NsoLoader(std::shared_ptr<vfs::Backing> backing);
 
+        /**
+         * @return The directory that warm boot snapshots should be stored in or an empty string if they're disabled
+         */
+        static std::string GetSnapshotDirectory(const DeviceState &state);
+
+        /**
+         * @brief Reads and decompresses all segments of an NSO, the segments are decompressed in parallel
+         * @param backing The backing that the NSO is contained within, this must support concurrent reads
+         * @param snapshotDirectory The directory of warm boot snapshots from GetSnapshotDirectory, the segments are read from a snapshot if there's a valid one and one is written otherwise
+         * @return An executable that can be loaded with Loader::LoadExecutable
+         */
+        static Executable ReadNso(const std::shared_ptr<vfs::Backing> &backing, const std::string &snapshotDirectory = {});
+
         /**
          * @brief Loads an NSO into memory, offset by the given amount
          * @param backing The backing that the NSO is contained within
@@ -25,6 +25,7 @@ namespace skyline::loader {
     NspLoader::NspLoader(const std::shared_ptr<vfs::Backing> &backing, const std::shared_ptr<crypto::KeyStore> &keyStore) : nsp(std::make_shared<vfs::PartitionFileSystem>(backing)) {
         ExtractTickets(nsp, keyStore);
 
+        std::optional<std::string> patchNcaName;
         auto root{nsp->OpenDirectory("", {false, true})};
         for (const auto &entry : root->Read()) {
             if (entry.name.substr(entry.name.find_last_of('.') + 1) != "nca")
@@ -33,7 +34,9 @@ namespace skyline::loader {
             try {
                 auto nca{vfs::NCA(nsp->OpenFile(entry.name), keyStore)};
 
-                if (nca.contentType == vfs::NcaContentType::Program && nca.romFs != nullptr && nca.exeFs != nullptr)
+                if (nca.contentType == vfs::NcaContentType::Program && nca.romFsPatch && nca.exeFs != nullptr)
+                    patchNcaName = entry.name;
+                else if (nca.contentType == vfs::NcaContentType::Program && nca.romFs != nullptr && nca.exeFs != nullptr)
                     programNca = std::move(nca);
                 else if (nca.contentType == vfs::NcaContentType::Control && nca.romFs != nullptr)
                     controlNca = std::move(nca);
@@ -47,6 +50,10 @@ namespace skyline::loader {
         if (!programNca || !controlNca)
             throw exception("Incomplete NSP file");
 
+        // An update bundled alongside its base is layered over it, the update's ExeFS entirely replaces that of the base
+        if (patchNcaName)
+            programNca = vfs::NCA(nsp->OpenFile(*patchNcaName), keyStore, false, &*programNca);
+
         romFs = programNca->romFs;
         controlRomFs = std::make_shared<vfs::RomFileSystem>(controlNca->romFs);
         nacp.emplace(controlRomFs->OpenFile("control.nacp"));
@@ -29,6 +29,7 @@ namespace skyline::loader {
                 logo = entryDir;
         }
 
+        std::optional<std::string> patchNcaName;
         if (secure) {
             root = secure->OpenDirectory("", {false, true});
             for (const auto &entry : root->Read()) {
@@ -38,7 +39,9 @@ namespace skyline::loader {
                 try {
                     auto nca{vfs::NCA(secure->OpenFile(entry.name), keyStore, true)};
 
-                    if (nca.contentType == vfs::NcaContentType::Program && nca.romFs != nullptr && nca.exeFs != nullptr)
+                    if (nca.contentType == vfs::NcaContentType::Program && nca.romFsPatch && nca.exeFs != nullptr)
+                        patchNcaName = entry.name;
+                    else if (nca.contentType == vfs::NcaContentType::Program && nca.romFs != nullptr && nca.exeFs != nullptr)
                         programNca = std::move(nca);
                     else if (nca.contentType == vfs::NcaContentType::Control && nca.romFs != nullptr)
                         controlNca = std::move(nca);
@@ -55,6 +58,10 @@ namespace skyline::loader {
         if (!programNca || !controlNca)
             throw exception("Incomplete XCI file");
 
+        // An update bundled alongside its base is layered over it, the update's ExeFS entirely replaces that of the base
+        if (patchNcaName)
+            programNca = vfs::NCA(secure->OpenFile(*patchNcaName), keyStore, true, &*programNca);
+
         romFs = programNca->romFs;
         controlRomFs = std::make_shared<vfs::RomFileSystem>(controlNca->romFs);
         nacp.emplace(controlRomFs->OpenFile("control.nacp"));
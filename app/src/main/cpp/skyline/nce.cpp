@@ -3,8 +3,12 @@
 
 #include <cxxabi.h>
 #include <unistd.h>
+#include <fstream>
+#include <xxhash.h>
 #include "common/signal.h"
 #include "common/trace.h"
+#include "common/call_profiler.h"
+#include "common/frame_statistics.h"
 #include "os.h"
 #include "jvm.h"
 #include "kernel/types/KProcess.h"
@@ -20,15 +24,24 @@ namespace skyline::nce {
         return killAllThreads ? "ExitProcess" : "ExitThread";
     }
 
+    /**
+     * @brief The time at which the calling guest thread last returned to guest code from an SVC, this is used to attribute the time between SVCs to guest execution
+     */
+    static thread_local u64 GuestResumeTimestamp{};
+
     void NCE::SvcHandler(u16 svcId, ThreadContext *ctx) {
         TRACE_EVENT_END("guest");
+        if (GuestResumeTimestamp)
+            FrameStatistics::Record(FrameStatistics::Phase::GuestCpu, static_cast<u64>(util::GetTimeNs()) - GuestResumeTimestamp);
 
         const auto &state{*ctx->state};
         auto svc{kernel::svc::SvcTable[svcId]};
         try {
             if (svc) [[likely]] {
                 TRACE_EVENT("kernel", perfetto::StaticString{svc.name});
+                auto start{static_cast<u64>(util::GetTimeNs())};
                 (svc.function)(state);
+                CallProfiler::RecordSvc(state.thread->id, svcId, svc.name, start, static_cast<u64>(util::GetTimeNs()));
             } else {
                 throw exception("Unimplemented SVC 0x{:X}", svcId);
             }
@@ -89,6 +102,7 @@ namespace skyline::nce {
             std::longjmp(state.thread->originalCtx, true);
         }
 
+        GuestResumeTimestamp = static_cast<u64>(util::GetTimeNs());
         TRACE_EVENT_BEGIN("guest", "Guest");
     }
 
@@ -297,57 +311,70 @@ namespace skyline::nce {
         return code;
     }
 
-    constexpr size_t RescaleClockSize{17}; //!< The size of the RescaleClock function in 32-bit ARMv8 instructions
+    constexpr u32 TpidrEl0{0x5E82};         // ID of TPIDR_EL0 in MRS
+    constexpr u32 TpidrroEl0{0x5E83};       // ID of TPIDRRO_EL0 in MRS
+    constexpr u32 CntfrqEl0{0x5F00};        // ID of CNTFRQ_EL0 in MRS
+    constexpr u32 CntpctEl0{0x5F01};        // ID of CNTPCT_EL0 in MRS
+    constexpr u32 CntvctEl0{0x5F02};        // ID of CNTVCT_EL0 in MRS
+    constexpr u32 TegraX1Freq{19200000};    // The clock frequency of the Tegra X1 (19.2 MHz)
+    constexpr u16 SvcGetSystemTick{0x1E};   // The ID of svcGetSystemTick, it's side-effect free and only reads the counter so it's emulated inline
+
+    constexpr size_t RescaleClockSize{13}; //!< The maximum size of the instructions written by WriteRescaleClock in 32-bit ARMv8 instructions
 
     /**
-     * @brief Writes instructions to rescale the host clock to Tegra X1 levels
-     * @note Output is on stack with the stack pointer offset 32B from the initial point
+     * @brief The factor to multiply host counter values by to rescale them to Tegra X1 levels as a 64.64 fixed-point value
      */
-    u32 *WriteRescaleClock(u32 *code) {
-        /* Reserve 32B of stack */
-        /* Save working registers */
-        *code++ = 0xD10083FF; // SUB SP, SP, #32
-        *code++ = 0xA90107E0; // STP X0, X1, [SP, #16]
-
-        /* Load magic constant */
-        *code++ = 0xD28F0860; // MOV X0, #30787
-        *code++ = 0xF2AE3680; // MOVK X0, #29108, LSL #16
-        *code++ = 0xF2CB5880; // MOVK X0, #23236, LSL #32
-        *code++ = 0xF2E14F80; // MOVK X0, #2684, LSL #48
-
-        /* Load clock frequency value */
-        for (const auto &mov : instructions::MoveRegister(registers::X1, util::ClockFrequency))
-            if (mov)
-                *code++ = mov;
+    struct ClockRescaleFactor {
+        u64 integer;
+        u64 fraction;
+    };
+
+    ClockRescaleFactor GetClockRescaleFactor() {
+        auto factor{(static_cast<unsigned __int128>(TegraX1Freq) << 64) / util::ClockFrequency};
+        return {static_cast<u64>(factor >> 64), static_cast<u64>(factor)};
+    }
 
-        /* Multiply clock frequency by magic constant */
-        *code++ = 0xD345FC21; // LSR X1, X1, #5
-        *code++ = 0x9BC07C21; // UMULH X1, X1, X0
-        *code++ = 0xD347FC21; // LSR X1, X1, #7
+    /**
+     * @brief Writes instructions to load the host counter rescaled to Tegra X1 levels into the destination register
+     * @details The rescale factor is baked into the instructions at patch time, so a read only costs a multiply-high and a multiply-add rather than a division
+     * @note All registers aside from the destination register are preserved
+     */
+    u32 *WriteRescaleClock(u32 *code, u8 destReg, ClockRescaleFactor factor) {
+        // Two scratch registers are required which can't be the destination register as it holds the counter value
+        std::array<u8, 2> scratch{};
+        for (u8 reg{}, count{}; count < scratch.size(); reg++)
+            if (reg != destReg)
+                scratch[count++] = reg;
+        auto [low, high]{scratch};
+
+        /* Save scratch registers */
+        *code++ = 0xA9BF03E0 | (high << 10) | low; // STP XLOW, XHIGH, [SP, #-16]!
 
         /* Load counter value */
-        *code++ = 0xD53BE040; // MRS X0, CNTVCT_EL0
+        *code++ = instructions::Mrs(CntvctEl0, registers::X(destReg)).raw;
 
-        /* Rescale counter value */
-        *code++ = 0x9AC10801; // UDIV X1, X0, X1
-        *code++ = 0x8B010421; // ADD X1, X1, X1, LSL #1
-        *code++ = 0xD37AE420; // LSL X0, X1, #6
+        /* Multiply counter value by fractional part of factor */
+        for (const auto &mov : instructions::MoveRegister(registers::X(low), factor.fraction))
+            if (mov)
+                *code++ = mov;
+        *code++ = 0x9BC07C00 | (low << 16) | (destReg << 5) | low; // UMULH XLOW, XDEST, XLOW
+
+        /* Multiply counter value by integer part of factor and accumulate */
+        if (factor.integer) {
+            for (const auto &mov : instructions::MoveRegister(registers::X(high), factor.integer))
+                if (mov)
+                    *code++ = mov;
+            *code++ = 0x9B000000 | (high << 16) | (low << 10) | (destReg << 5) | destReg; // MADD XDEST, XDEST, XHIGH, XLOW
+        } else {
+            *code++ = instructions::Mov(registers::X(destReg), registers::X(low)).raw;
+        }
 
-        /* Store result */
-        /* Restore registers */
-        *code++ = 0xF90003E0; // STR X0, [SP, #0]
-        *code++ = 0xA94107E0; // LDP X0, X1, [SP, #16]
+        /* Restore scratch registers */
+        *code++ = 0xA8C103E0 | (high << 10) | low; // LDP XLOW, XHIGH, [SP], #16
 
         return code;
     }
 
-    constexpr u32 TpidrEl0{0x5E82};         // ID of TPIDR_EL0 in MRS
-    constexpr u32 TpidrroEl0{0x5E83};       // ID of TPIDRRO_EL0 in MRS
-    constexpr u32 CntfrqEl0{0x5F00};        // ID of CNTFRQ_EL0 in MRS
-    constexpr u32 CntpctEl0{0x5F01};        // ID of CNTPCT_EL0 in MRS
-    constexpr u32 CntvctEl0{0x5F02};        // ID of CNTVCT_EL0 in MRS
-    constexpr u32 TegraX1Freq{19200000};    // The clock frequency of the Tegra X1 (19.2 MHz)
-
     NCE::PatchData NCE::GetPatchData(const std::vector<u8> &text) {
         size_t size{guest::SaveCtxSize + guest::LoadCtxSize + TrampolineSize};
         std::vector<size_t> offsets;
@@ -362,7 +389,10 @@ namespace skyline::nce {
             auto instructionOffset{static_cast<size_t>(instruction - start)};
 
             if (svc.Verify()) {
-                size += 7;
+                if (svc.value == SvcGetSystemTick)
+                    size += rescaleClock ? RescaleClockSize + 1 : 0;
+                else
+                    size += 7;
                 offsets.push_back(instructionOffset);
             } else if (mrs.Verify()) {
                 if (mrs.srcReg == TpidrroEl0 || mrs.srcReg == TpidrEl0) {
@@ -371,7 +401,7 @@ namespace skyline::nce {
                 } else {
                     if (rescaleClock) {
                         if (mrs.srcReg == CntpctEl0) {
-                            size += RescaleClockSize + 3;
+                            size += RescaleClockSize + 1;
                             offsets.push_back(instructionOffset);
                         } else if (mrs.srcReg == CntfrqEl0) {
                             size += 3;
@@ -389,6 +419,67 @@ namespace skyline::nce {
         return {util::AlignUp(size * sizeof(u32), constant::PageSize), offsets};
     }
 
+    struct PatchCacheFileHeader {
+        static constexpr u32 Magic{util::MakeMagic<u32>("PTCH")}; //!< The magic value used to identify a patch cache file
+        static constexpr u32 Version{3}; //!< The version of the patch cache file format, MUST be incremented for any format changes or changes to which instructions are patched or the size of their patches
+
+        u32 magic{Magic};
+        u32 version{Version};
+        u64 textHash; //!< An XXH3 hash of the .text section
+        u64 textSize;
+        u64 clockFrequency; //!< The host clock frequency at the time of patching as it determines if clock reads are rescaled
+        u64 patchSize; //!< The size of the .patch section
+        u64 offsetCount; //!< The amount of offsets following the header, these are stored as u32 instruction offsets
+    };
+
+    NCE::PatchData NCE::GetCachedPatchData(const std::vector<u8> &text, u64 textHash) {
+        TRACE_EVENT("host", "NCE::GetCachedPatchData");
+
+        PatchCacheFileHeader expectedHeader{
+            .textHash = textHash ? textHash : XXH3_64bits(text.data(), text.size()),
+            .textSize = text.size(),
+            .clockFrequency = util::ClockFrequency,
+        };
+        auto directory{state.os->publicAppFilesPath + "patch_cache/"};
+        auto entryPath{fmt::format("{}{:016X}", directory, expectedHeader.textHash)};
+
+        {
+            std::ifstream stream{entryPath, std::ios::binary};
+            PatchCacheFileHeader header{};
+            if (stream.read(reinterpret_cast<char *>(&header), sizeof(PatchCacheFileHeader)) && header.magic == expectedHeader.magic && header.version == expectedHeader.version && header.textHash == expectedHeader.textHash && header.textSize == expectedHeader.textSize && header.clockFrequency == expectedHeader.clockFrequency) {
+                std::vector<u32> offsets(header.offsetCount);
+                if (stream.read(reinterpret_cast<char *>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(u32))))
+                    return {header.patchSize, std::vector<size_t>(offsets.begin(), offsets.end())};
+            }
+        }
+
+        auto patch{GetPatchData(text)};
+
+        // Entries are written to a temporary file first and then renamed, so a partially written entry can never be read
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        auto temporaryPath{entryPath + ".tmp"};
+        {
+            std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+            expectedHeader.patchSize = patch.size;
+            expectedHeader.offsetCount = patch.offsets.size();
+            std::vector<u32> offsets(patch.offsets.begin(), patch.offsets.end()); // Instruction offsets always fit within 32 bits as executables can't exceed 16GiB
+            stream.write(reinterpret_cast<const char *>(&expectedHeader), sizeof(PatchCacheFileHeader));
+            stream.write(reinterpret_cast<const char *>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(u32)));
+            if (stream.fail()) {
+                Logger::Warn("Failed to write patch cache entry: {}", entryPath);
+                stream.close();
+                std::filesystem::remove(temporaryPath, error);
+                return patch;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, entryPath, error);
+        if (error)
+            Logger::Warn("Failed to commit patch cache entry: {} ({})", entryPath, error.message());
+        return patch;
+    }
+
     void NCE::PatchCode(std::vector<u8> &text, u32 *patch, size_t patchSize, const std::vector<size_t> &offsets, size_t textOffset) {
         u32 *start{patch};
         u32 *end{patch + (patchSize / sizeof(u32))};
@@ -402,6 +493,7 @@ namespace skyline::nce {
         patch += guest::LoadCtxSize;
 
         bool rescaleClock{util::ClockFrequency != TegraX1Freq};
+        auto rescaleFactor{rescaleClock ? GetClockRescaleFactor() : ClockRescaleFactor{}};
 
         for (auto offset : offsets) {
             u32 *instruction{reinterpret_cast<u32 *>(text.data()) + offset};
@@ -411,7 +503,18 @@ namespace skyline::nce {
             auto endOffset{[&] { return static_cast<size_t>(end - patch) + (textOffset / sizeof(u32)); }};
             auto startOffset{[&] { return static_cast<size_t>(start - patch); }};
 
-            if (svc.Verify()) {
+            if (svc.Verify() && svc.value == SvcGetSystemTick) {
+                /* Inline System Tick Read */
+                // This avoids a full context switch for an SVC which is commonly called in tight loops for timing
+                if (rescaleClock) {
+                    *instruction = instructions::B(static_cast<i32>(endOffset() + offset), true).raw;
+                    patch = WriteRescaleClock(patch, registers::X0, rescaleFactor);
+                    *patch = instructions::B(static_cast<i32>(endOffset() + offset + 1)).raw;
+                    patch++;
+                } else {
+                    *instruction = instructions::Mrs(CntvctEl0, registers::X0).raw;
+                }
+            } else if (svc.Verify()) {
                 /* Per-SVC Trampoline */
                 /* Rewrite SVC with B to trampoline */
                 *instruction = instructions::B(static_cast<i32>(endOffset() + offset), true).raw;
@@ -463,16 +566,8 @@ namespace skyline::nce {
                             /* Rewrite MRS with B to trampoline */
                             *instruction = instructions::B(static_cast<i32>(endOffset() + offset), true).raw;
 
-                            /* Rescale host clock */
-                            patch = WriteRescaleClock(patch);
-
-                            /* Load result from stack into destination register */
-                            instructions::Ldr ldr(0xF94003E0); // LDR XOUT, [SP]
-                            ldr.destReg = mrs.destReg;
-                            *patch++ = ldr.raw;
-
-                            /* Free 32B stack allocation by RescaleClock and Return */
-                            *patch++ = {0x910083FF}; // ADD SP, SP, #32
+                            /* Rescale host clock into destination register and Return */
+                            patch = WriteRescaleClock(patch, static_cast<u8>(mrs.destReg), rescaleFactor);
                             *patch = instructions::B(static_cast<i32>(endOffset() + offset + 1)).raw;
                             patch++;
                         } else if (mrs.srcReg == CntfrqEl0) {
@@ -606,16 +701,32 @@ namespace skyline::nce {
         }
     }
 
-    NCE::CallbackEntry::CallbackEntry(TrapProtection protection, LockCallback lockCallback, TrapCallback readCallback, TrapCallback writeCallback) : protection{protection}, lockCallback{std::move(lockCallback)}, readCallback{std::move(readCallback)}, writeCallback{std::move(writeCallback)} {}
+    NCE::CallbackEntry::CallbackEntry(TrapProtection protection, LockCallback lockCallback, TrapCallback readCallback, TrapCallback writeCallback, PageWriteCallback pageWriteCallback) : protection{protection}, lockCallback{std::move(lockCallback)}, readCallback{std::move(readCallback)}, writeCallback{std::move(writeCallback)}, pageWriteCallback{std::move(pageWriteCallback)} {}
 
     void NCE::ReprotectIntervals(const std::vector<TrapMap::Interval> &intervals, TrapProtection protection) {
         TRACE_EVENT("host", "NCE::ReprotectIntervals");
 
         auto reprotectIntervalsWithFunction = [&intervals](auto getProtection) {
+            // Adjacent intervals with the same protection are coalesced into a single mprotect call
+            u8 *pendingStart{}, *pendingEnd{};
+            int pendingProtection{};
             for (auto region : intervals) {
                 region = region.Align(constant::PageSize);
-                mprotect(region.start, region.Size(), getProtection(region));
+                int protection{getProtection(region)};
+                if (pendingEnd == region.start && pendingProtection == protection && pendingStart) {
+                    pendingEnd = region.end;
+                    continue;
+                }
+
+                if (pendingStart)
+                    mprotect(pendingStart, static_cast<size_t>(pendingEnd - pendingStart), pendingProtection);
+                pendingStart = region.start;
+                pendingEnd = region.end;
+                pendingProtection = protection;
             }
+
+            if (pendingStart)
+                mprotect(pendingStart, static_cast<size_t>(pendingEnd - pendingStart), pendingProtection);
         };
 
         // We need to determine the lowest protection possible for the given interval
@@ -658,6 +769,21 @@ namespace skyline::nce {
         }
     }
 
+    const NCE::TrapLookup &NCE::LookupTrap(u8 *page) {
+        if (auto it{trapLookaside.find(page)}; it != trapLookaside.end()) [[likely]]
+            return it->second;
+
+        auto lookup{trapMap.GetAlignedRecursiveRange<constant::PageSize>(page)};
+        if (lookup.first.empty()) {
+            static const TrapLookup EmptyLookup{};
+            return EmptyLookup; // Faults without traps aren't cached as they're unlikely to reoccur
+        }
+
+        if (trapLookaside.size() >= MaxTrapLookasideSize)
+            trapLookaside.clear();
+        return trapLookaside.emplace(page, std::move(lookup)).first->second;
+    }
+
     bool NCE::TrapHandler(u8 *address, bool write) {
         TRACE_EVENT("host", "NCE::TrapHandler");
 
@@ -671,13 +797,50 @@ namespace skyline::nce {
 
             std::scoped_lock lock(trapMutex);
 
-            // Retrieve any callbacks for the page that was faulted
-            auto[entries, intervals]{trapMap.GetAlignedRecursiveRange<constant::PageSize>(address)};
+            // Retrieve any callbacks for the page that was faulted, the entries can be modified through the lookup as only the structure of the trap map is cached
+            u8 *page{util::AlignDown(address, constant::PageSize)};
+            const auto &[entries, intervals]{LookupTrap(page)};
             if (entries.empty())
                 return false; // There's no callbacks associated with this page
 
             // Do callbacks for every entry in the intervals
             if (write) {
+                // If all entries that require protection can track writes at page granularity, we only need to unprotect the faulting page rather than all intervals
+                bool pageGranular{false};
+                for (auto entryRef : entries) {
+                    auto &entry{entryRef.get()};
+                    if (entry.protection == TrapProtection::None)
+                        continue;
+
+                    pageGranular = entry.protection == TrapProtection::WriteOnly && entry.pageWriteCallback;
+                    if (!pageGranular)
+                        break;
+                }
+
+                if (pageGranular) {
+                    for (auto entryRef : entries) {
+                        auto &entry{entryRef.get()};
+                        if (entry.protection == TrapProtection::None)
+                            continue;
+
+                        auto result{entry.pageWriteCallback(page)};
+                        if (result == PageWriteResult::WouldBlock) {
+                            lockCallback = entry.lockCallback;
+                            break;
+                        } else if (result == PageWriteResult::Untrapped) {
+                            pageGranular = false; // All entries will be untrapped in their entirety as their intervals would be unprotected regardless
+                        }
+                    }
+                    if (lockCallback)
+                        continue; // We need to retry the loop because a callback was blocking
+
+                    if (pageGranular) {
+                        // The entries remain write protected aside from the faulting page, so any writes to other pages will still be trapped
+                        mprotect(page, constant::PageSize, PROT_READ | PROT_WRITE | PROT_EXEC);
+                        return true;
+                    }
+                }
+
                 for (auto entryRef : entries) {
                     auto &entry{entryRef.get()};
                     if (entry.protection == TrapProtection::None)
@@ -724,10 +887,11 @@ namespace skyline::nce {
 
     constexpr NCE::TrapHandle::TrapHandle(const TrapMap::GroupHandle &handle) : TrapMap::GroupHandle(handle) {}
 
-    NCE::TrapHandle NCE::CreateTrap(span<span<u8>> regions, const LockCallback &lockCallback, const TrapCallback &readCallback, const TrapCallback &writeCallback) {
+    NCE::TrapHandle NCE::CreateTrap(span<span<u8>> regions, const LockCallback &lockCallback, const TrapCallback &readCallback, const TrapCallback &writeCallback, const PageWriteCallback &pageWriteCallback) {
         TRACE_EVENT("host", "NCE::CreateTrap");
         std::scoped_lock lock{trapMutex};
-        TrapHandle handle{trapMap.Insert(regions, CallbackEntry{TrapProtection::None, lockCallback, readCallback, writeCallback})};
+        TrapHandle handle{trapMap.Insert(regions, CallbackEntry{TrapProtection::None, lockCallback, readCallback, writeCallback, pageWriteCallback})};
+        trapLookaside.clear();
         return handle;
     }
 
@@ -752,5 +916,6 @@ namespace skyline::nce {
         handle->value.protection = TrapProtection::None;
         ReprotectIntervals(handle->intervals, TrapProtection::None);
         trapMap.Remove(handle);
+        trapLookaside.clear();
     }
 }
@@ -31,18 +31,40 @@ namespace skyline::nce {
         using TrapCallback = std::function<bool()>;
         using LockCallback = std::function<void()>;
 
+        /**
+         * @brief The result of a page write callback
+         */
+        enum class PageWriteResult {
+            WouldBlock, //!< The callback would block, the lock callback will be called prior to retrying it
+            Trapped, //!< The write was tracked, only the written page is untrapped while the rest of the region remains trapped
+            Untrapped, //!< Writes don't need to be tracked at page granularity anymore, the write callback will be called and the entire region will be untrapped
+        };
+
+        using PageWriteCallback = std::function<PageWriteResult(u8 *page)>;
+
         struct CallbackEntry {
             TrapProtection protection; //!< The least restrictive protection that this callback needs to have
             LockCallback lockCallback;
             TrapCallback readCallback, writeCallback;
+            PageWriteCallback pageWriteCallback; //!< An optional callback for write accesses to a single page of a write-only trapped region, the region stays trapped aside from that page after it's called
 
-            CallbackEntry(TrapProtection protection, LockCallback lockCallback, TrapCallback readCallback, TrapCallback writeCallback);
+            CallbackEntry(TrapProtection protection, LockCallback lockCallback, TrapCallback readCallback, TrapCallback writeCallback, PageWriteCallback pageWriteCallback);
         };
 
         std::mutex trapMutex; //!< Synchronizes the accesses to the trap map
         using TrapMap = IntervalMap<u8*, CallbackEntry>;
         TrapMap trapMap; //!< A map of all intervals and corresponding callbacks that have been registered
 
+        using TrapLookup = std::pair<std::vector<std::reference_wrapper<CallbackEntry>>, std::vector<TrapMap::Interval>>;
+        static constexpr size_t MaxTrapLookasideSize{0x2000}; //!< The maximum amount of pages in the lookaside table, it's cleared once this is exceeded to bound its memory usage
+        std::unordered_map<u8 *, TrapLookup> trapLookaside; //!< A cache of trap map lookups keyed by the faulting page, this avoids the recursive interval map query on repeated faults to the same pages and is invalidated whenever traps are created or deleted
+
+        /**
+         * @return The entries and intervals of all traps on the supplied page, these are served from the lookaside table when possible
+         * @note The trap mutex must be locked when calling this, the returned reference is valid until the lookaside table is next modified
+         */
+        const TrapLookup &LookupTrap(u8 *page);
+
         /**
          * @brief Reprotects the intervals to the least restrictive protection given the supplied protection
          */
@@ -107,6 +129,13 @@ namespace skyline::nce {
 
         static PatchData GetPatchData(const std::vector<u8> &text);
 
+        /**
+         * @brief Retrieves the patch data for the supplied .text section from the on-disk patch cache, the section is scanned and the cache is populated if there's no valid entry for it
+         * @param textHash An XXH3 hash of the section if it's already known, this avoids rehashing it
+         * @note Entries are keyed by a hash of the section's contents, so they're shared across all titles and updates that contain the same executable
+         */
+        PatchData GetCachedPatchData(const std::vector<u8> &text, u64 textHash = 0);
+
         /**
          * @brief Writes the .patch section and mutates the code accordingly
          * @param patch A pointer to the .patch section which should be exactly patchSize in size and located before the .text section
@@ -138,11 +167,14 @@ namespace skyline::nce {
          * @param lockCallback A callback to lock the resource that is being trapped, it must block until the resource is locked but unlock it prior to returning
          * @param readCallback A callback for read accesses to the trapped region, it must not block and return a boolean if it would block
          * @param writeCallback A callback for write accesses to the trapped region, it must not block and return a boolean if it would block
+         * @param pageWriteCallback An optional callback for write accesses to write-only trapped regions with the address of the written page, it must not block and return PageWriteResult::WouldBlock if it would block
+         * @note The page callback is only used when every other trap on the page also supports it, the write callback is used otherwise and the entire region is untrapped
+         * @note The page callback may be called with pages outside the trapped region when traps overlap, these must be ignored
          * @note The handle **must** be deleted using DeleteTrap before the NCE instance is destroyed
          * @note It is UB to supply a region of host memory rather than guest memory
          * @note This doesn't trap the region in itself, any trapping must be done via TrapRegions(...)
          */
-        TrapHandle CreateTrap(span<span<u8>> regions, const LockCallback& lockCallback, const TrapCallback& readCallback, const TrapCallback& writeCallback);
+        TrapHandle CreateTrap(span<span<u8>> regions, const LockCallback& lockCallback, const TrapCallback& readCallback, const TrapCallback& writeCallback, const PageWriteCallback& pageWriteCallback = {});
 
         /**
          * @brief Re-traps a region of memory after protections were removed
@@ -1,11 +1,14 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <future>
 #include "gpu.h"
 #include "nce.h"
 #include "nce/guest.h"
 #include "kernel/types/KProcess.h"
 #include "vfs/os_backing.h"
+#include "vfs/mmap_backing.h"
+#include "vfs/cached_backing.h"
 #include "loader/nro.h"
 #include "loader/nso.h"
 #include "loader/nca.h"
@@ -31,8 +34,26 @@ namespace skyline::kernel {
           serviceManager(state) {}
 
     void OS::Execute(int romFd, loader::RomFormat romType) {
-        auto romFile{std::make_shared<vfs::OsBacking>(romFd)};
-        auto keyStore{std::make_shared<crypto::KeyStore>(privateAppFilesPath + "keys/")};
+        auto bootStart{util::GetTimeNs()}, stageStart{bootStart};
+        auto endStage{[&stageStart](std::string_view stage) {
+            auto now{util::GetTimeNs()};
+            Logger::Info("Boot stage '{}' took {}ms", stage, (now - stageStart) / constant::NsInMillisecond);
+            stageStart = now;
+        }};
+
+        // Unencrypted executables are mapped so they can be parsed in-place, encrypted containers are kept as files as almost all of their contents have to be decrypted into a copy regardless
+        auto romFile{[&]() -> std::shared_ptr<vfs::Backing> {
+            if (romType == loader::RomFormat::NRO || romType == loader::RomFormat::NSO) {
+                try {
+                    return std::make_shared<vfs::MmapBacking>(romFd);
+                } catch (const std::exception &e) {
+                    Logger::Warn("Falling back to reading the ROM as a file: {}", e.what());
+                }
+            }
+            return std::make_shared<vfs::OsBacking>(romFd);
+        }()};
+        // Keys are only parsed for formats which are encrypted with them
+        auto createKeyStore{[this] { return std::make_shared<crypto::KeyStore>(privateAppFilesPath + "keys/"); }};
 
         state.loader = [&]() -> std::shared_ptr<loader::Loader> {
             switch (romType) {
@@ -41,22 +62,41 @@ namespace skyline::kernel {
                 case loader::RomFormat::NSO:
                     return std::make_shared<loader::NsoLoader>(std::move(romFile));
                 case loader::RomFormat::NCA:
-                    return std::make_shared<loader::NcaLoader>(std::move(romFile), std::move(keyStore));
+                    return std::make_shared<loader::NcaLoader>(std::move(romFile), createKeyStore());
                 case loader::RomFormat::NSP:
-                    return std::make_shared<loader::NspLoader>(romFile, keyStore);
+                    return std::make_shared<loader::NspLoader>(romFile, createKeyStore());
                 case loader::RomFormat::XCI:
-                    return std::make_shared<loader::XciLoader>(romFile, keyStore);
+                    return std::make_shared<loader::XciLoader>(romFile, createKeyStore());
                 default:
                     throw exception("Unsupported ROM extension.");
             }
         }();
 
-        state.gpu->Initialise();
+        // Title profiles are applied as soon as the title is known so its overrides are seen by everything initialised for it, settings which are only read on GPU construction (such as asyncWriteTracking) aren't affected
+        if (auto &nacp{state.loader->nacp})
+            if (auto profile{TitleProfile::Load(publicAppFilesPath + "profiles/", nacp->GetSaveDataOwnerId())})
+                state.settings->SetTitleProfile(std::move(profile));
+
+        if (state.loader->romFs && *state.settings->romFsCacheSize)
+            state.loader->romFs = std::make_shared<vfs::CachedBacking>(state.loader->romFs, static_cast<size_t>(*state.settings->romFsCacheSize) * 1024 * 1024);
+        endStage("Container Parsing");
+
+        // The GPU caches only depend on the title ID from the NACP, so they're loaded while executables are loaded and patched on this thread, the future is joined before any guest code can run
+        auto gpuInitialisation{std::async(std::launch::async, [this] {
+            auto start{util::GetTimeNs()};
+            state.gpu->Initialise();
+            return util::GetTimeNs() - start;
+        })};
 
         auto &process{state.process};
         process = std::make_shared<kernel::type::KProcess>(state);
 
         auto entry{state.loader->LoadProcessData(process, state)};
+        endStage("Executable Loading");
+
+        auto gpuInitialisationTime{gpuInitialisation.get()};
+        Logger::Info("Boot stage 'GPU Initialisation' took {}ms concurrently with executable loading", gpuInitialisationTime / constant::NsInMillisecond);
+        endStage("GPU Initialisation Wait");
         auto &nacp{state.loader->nacp};
         if (nacp) {
             std::string name{nacp->GetApplicationName(language::ApplicationLanguage::AmericanEnglish)}, publisher{nacp->GetApplicationPublisher(language::ApplicationLanguage::AmericanEnglish)};
@@ -67,13 +107,20 @@ namespace skyline::kernel {
             Logger::InfoNoPrefix(R"(Starting "{}" ({}) v{} by "{}")", name, nacp->GetSaveDataOwnerId(), nacp->GetApplicationVersion(), publisher);
         }
 
+        if (*state.settings->guestProfiler)
+            guestProfiler = std::make_unique<GuestProfiler>(state);
+
         process->InitializeHeapTls();
         auto thread{process->CreateThread(entry)};
+        Logger::Info("Booted in {}ms", (util::GetTimeNs() - bootStart) / constant::NsInMillisecond);
         if (thread) {
             Logger::Info("Starting main HOS thread");
             Logger::EmulationContext.Flush();
             thread->Start(true);
             process->Kill(true, true, true);
         }
+
+        if (guestProfiler)
+            guestProfiler->Stop();
     }
 }
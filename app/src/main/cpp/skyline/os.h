@@ -7,6 +7,7 @@
 #include "vfs/filesystem.h"
 #include "loader/loader.h"
 #include "services/serviceman.h"
+#include "kernel/guest_profiler.h"
 
 namespace skyline::kernel {
     /**
@@ -21,6 +22,7 @@ namespace skyline::kernel {
         std::shared_ptr<vfs::FileSystem> assetFileSystem; //!< A filesystem to be used for accessing emulator assets (like tzdata)
         DeviceState state;
         service::ServiceManager serviceManager;
+        std::unique_ptr<GuestProfiler> guestProfiler; //!< The sampling profiler for guest code, this is only created when it's enabled in the settings
 
         /**
          * @param settings An instance of the Settings class
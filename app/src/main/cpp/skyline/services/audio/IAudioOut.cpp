@@ -1,12 +1,14 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <common/settings.h>
 #include <kernel/types/KProcess.h>
 #include "IAudioOut.h"
 
 namespace skyline::service::audio {
     IAudioOut::IAudioOut(const DeviceState &state, ServiceManager &manager, u8 channelCount, u32 sampleRate)
-        : sampleRate(sampleRate),
+        : resampler(*state.settings->highQualityAudioResampling ? skyline::audio::Resampler::Quality::Polyphase : skyline::audio::Resampler::Quality::Fast),
+          sampleRate(sampleRate),
           channelCount(channelCount),
           releaseEvent(std::make_shared<type::KEvent>(state, false)),
           BaseService(state, manager) {
@@ -18,7 +20,7 @@ namespace skyline::service::audio {
     }
 
     Result IAudioOut::GetAudioOutState(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        response.Push(static_cast<u32>(track->playbackState));
+        response.Push(static_cast<u32>(track->playbackState.load()));
         return {};
     }
 
@@ -48,7 +50,9 @@ namespace skyline::service::audio {
 
         span samples(data.sampleBuffer, data.sampleSize / sizeof(i16));
         if (sampleRate != constant::SampleRate) {
-            auto resampledBuffer{resampler.ResampleBuffer(samples, static_cast<double>(sampleRate) / constant::SampleRate, channelCount)};
+            double ratio{static_cast<double>(sampleRate) / constant::SampleRate};
+            resampledBuffer.resize(skyline::audio::Resampler::GetOutputSize(samples.size(), ratio, channelCount));
+            resampledBuffer.resize(resampler.ResampleBuffer(samples, resampledBuffer, ratio, channelCount));
             track->AppendBuffer(tag, resampledBuffer);
         } else {
             track->AppendBuffer(tag, samples);
@@ -2,27 +2,122 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <common/settings.h>
+#include <common/signal.h>
+#include <common/host_topology.h>
+#include <common/trace.h>
 #include <kernel/types/KProcess.h>
+#include <nce.h>
+#include <services/serviceman.h>
+#include <audio/mixer.h>
 #include "IAudioRenderer.h"
 
 namespace skyline::service::audio::IAudioRenderer {
     IAudioRenderer::IAudioRenderer(const DeviceState &state, ServiceManager &manager, AudioRendererParameters &parameters)
         : systemEvent(std::make_shared<type::KEvent>(state, true)), parameters(parameters), BaseService(state, manager) {
-        track = state.audio->OpenTrack(constant::StereoChannelCount, constant::SampleRate, [&]() { systemEvent->Signal(); });
-        track->Start();
-
         memoryPools.resize(parameters.effectCount + parameters.voiceCount * 4);
         effects.resize(parameters.effectCount);
-        voices.resize(parameters.voiceCount, Voice(state));
+        voices.resize(parameters.voiceCount, Voice(state, constant::MixBufferSize));
+
+        // Voices are only mixed in parallel when there are enough batches for every thread, the renderer thread itself always mixes batches as well
+        size_t batchCount{util::DivideCeil<size_t>(voices.size(), VoiceBatchSize)};
+        size_t workerCount{std::min({MaxVoiceWorkerCount, batchCount ? batchCount - 1 : 0, static_cast<size_t>(host::Topology::Get().GetCoreCount(*state.settings->audioAffinity)) - 1})};
+        for (size_t index{}; index < workerCount; index++) {
+            auto &voiceWorker{*voiceWorkers.emplace_back(std::make_unique<VoiceWorker>())};
+            voiceWorker.thread = std::thread(&IAudioRenderer::VoiceWorkerThread, this, std::ref(voiceWorker));
+        }
+
+        track = state.audio->OpenTrack(constant::StereoChannelCount, constant::SampleRate, [this]() {
+            {
+                std::scoped_lock lock{renderRequestMutex};
+                renderRequested = true;
+            }
+            renderRequestCondition.notify_one();
+        });
+        track->Start();
 
         // Fill track with empty samples that we will triple buffer
         track->AppendBuffer(0);
         track->AppendBuffer(1);
         track->AppendBuffer(2);
+
+        rendererThread = std::thread(&IAudioRenderer::RendererThread, this);
     }
 
     IAudioRenderer::~IAudioRenderer() {
-        state.audio->CloseTrack(track);
+        state.audio->CloseTrack(track); // The release callback won't be called after this returns
+
+        {
+            std::scoped_lock lock{renderRequestMutex};
+            exitRenderer = true;
+        }
+        renderRequestCondition.notify_one();
+        rendererThread.join();
+
+        {
+            std::scoped_lock lock{batchMutex};
+            exitWorkers = true;
+        }
+        batchCondition.notify_all();
+        for (auto &voiceWorker : voiceWorkers)
+            voiceWorker->thread.join();
+    }
+
+    void IAudioRenderer::SetupRendererThread(const char *name) {
+        if (int result{pthread_setname_np(pthread_self(), name)})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE}, signal::ExceptionalSignalHandler);
+        signal::SetSignalHandler({SIGSEGV}, nce::NCE::HostSignalHandler); // Wave buffers may reside in NCE trapped memory
+
+        host::Topology::Get().SetThreadAffinity(*state.settings->audioAffinity);
+    }
+
+    void IAudioRenderer::RendererThread() {
+        SetupRendererThread("Sky-AudRenderer");
+
+        while (true) {
+            {
+                std::unique_lock lock{renderRequestMutex};
+                renderRequestCondition.wait(lock, [this] { return renderRequested || exitRenderer; });
+                if (exitRenderer)
+                    return;
+                renderRequested = false;
+            }
+
+            try {
+                std::scoped_lock lock{rendererMutex};
+                UpdateAudio();
+            } catch (const std::exception &e) {
+                Logger::Error("Audio renderer failed to render: {}", e.what());
+            }
+
+            systemEvent->Signal();
+        }
+    }
+
+    void IAudioRenderer::VoiceWorkerThread(VoiceWorker &voiceWorker) {
+        SetupRendererThread("Sky-AudVoice");
+
+        u64 generation{};
+        std::unique_lock lock{batchMutex};
+        while (true) {
+            batchCondition.wait(lock, [&] { return batchGeneration != generation || exitWorkers; });
+            if (exitWorkers)
+                return;
+            generation = batchGeneration;
+            lock.unlock();
+
+            voiceWorker.bus.fill(0.0f);
+            try {
+                MixVoiceBatches(voiceWorker.bus);
+            } catch (const std::exception &e) {
+                Logger::Error("Audio renderer failed to mix voices: {}", e.what());
+            }
+
+            lock.lock();
+            completedWorkers++;
+            batchCompleteCondition.notify_one();
+        }
     }
 
     Result IAudioRenderer::GetSampleRate(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
@@ -46,6 +141,9 @@ namespace skyline::service::audio::IAudioRenderer {
     }
 
     Result IAudioRenderer::RequestUpdate(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        TRACE_EVENT("audio", "RequestUpdate");
+        auto startTime{util::GetTimeNs()};
+        std::scoped_lock lock{rendererMutex};
         auto input{request.inputBuf.at(0).data()};
 
         auto inputHeader{*reinterpret_cast<UpdateDataHeader *>(input)};
@@ -69,9 +167,6 @@ namespace skyline::service::audio::IAudioRenderer {
         for (u32 i{}; i < effectsIn.size(); i++)
             effects[i].ProcessInput(effectsIn[i]);
 
-        if (!*state.settings->isAudioOutputDisabled)
-            UpdateAudio();
-
         UpdateDataHeader outputHeader{
             .revision = constant::RevMagic,
             .behaviorSize = 0xB0,
@@ -116,6 +211,7 @@ namespace skyline::service::audio::IAudioRenderer {
             output += sizeof(EffectOut);
         }
 
+        state.audio->statistics.requestUpdate.Record(static_cast<u64>(util::GetTimeNs() - startTime));
         return {};
     }
 
@@ -123,44 +219,58 @@ namespace skyline::service::audio::IAudioRenderer {
         auto released{track->GetReleasedBuffers(2)};
 
         for (auto &tag : released) {
-            MixFinalBuffer();
-            track->AppendBuffer(tag, sampleBuffer);
+            // Silent buffers are still appended when output is disabled so buffers continue to be released and the guest is signalled at the usual rate
+            if (!*state.settings->isAudioOutputDisabled)
+                MixFinalBuffer();
+            else
+                mixBus.fill(0.0f);
+            track->AppendBuffer(tag, span<const float>(mixBus));
         }
     }
 
-    void IAudioRenderer::MixFinalBuffer() {
-        u32 writtenSamples{};
-
-        for (auto &voice : voices) {
-            if (!voice.Playable())
-                continue;
-
-            u32 bufferOffset{};
-            u32 pendingSamples{constant::MixBufferSize};
-
-            while (pendingSamples > 0) {
-                u32 voiceBufferOffset{};
-                u32 voiceBufferSize{};
-                auto &voiceSamples{voice.GetBufferData(pendingSamples, voiceBufferOffset, voiceBufferSize)};
-
-                if (voiceBufferSize == 0)
-                    break;
+    void IAudioRenderer::MixVoiceBatches(MixBus &bus) {
+        for (size_t batch{nextBatch.fetch_add(1, std::memory_order_relaxed)}; batch * VoiceBatchSize < voices.size(); batch = nextBatch.fetch_add(1, std::memory_order_relaxed)) {
+            // Every voice is only in a single batch, so the state of a voice is only ever touched by the thread that claimed its batch
+            TRACE_EVENT("audio", "MixVoiceBatch", "batch", batch);
+            auto batchVoices{span(voices).subspan(batch * VoiceBatchSize, std::min(VoiceBatchSize, voices.size() - batch * VoiceBatchSize))};
+            for (auto &voice : batchVoices) {
+                if (!voice.Playable())
+                    continue;
+
+                auto startTime{util::GetTimeNs()};
+                auto voiceSamples{voice.Render(constant::MixBufferSize)};
+                skyline::audio::AccumulateScaled(bus.data(), voiceSamples.data(), voice.volume * skyline::audio::SampleScale, voiceSamples.size());
+                state.audio->statistics.voiceMix.Record(static_cast<u64>(util::GetTimeNs() - startTime));
+            }
+        }
+    }
 
-                pendingSamples -= voiceBufferSize / constant::StereoChannelCount;
+    void IAudioRenderer::MixFinalBuffer() {
+        TRACE_EVENT("audio", "MixFinalBuffer");
+        auto startTime{util::GetTimeNs()};
+        mixBus.fill(0.0f);
+        nextBatch.store(0, std::memory_order_relaxed);
+
+        if (voiceWorkers.empty()) {
+            MixVoiceBatches(mixBus);
+        } else {
+            {
+                std::scoped_lock lock{batchMutex};
+                completedWorkers = 0;
+                batchGeneration++;
+            }
+            batchCondition.notify_all();
 
-                for (auto index{voiceBufferOffset}; index < voiceBufferOffset + voiceBufferSize; index++) {
-                    if (writtenSamples == bufferOffset) {
-                        sampleBuffer[bufferOffset] = skyline::audio::Saturate<i16, i32>(voiceSamples[index] * voice.volume);
+            MixVoiceBatches(mixBus);
 
-                        writtenSamples++;
-                    } else {
-                        sampleBuffer[bufferOffset] = skyline::audio::Saturate<i16, i32>(sampleBuffer[bufferOffset] + (voiceSamples[index] * voice.volume));
-                    }
+            std::unique_lock lock{batchMutex};
+            batchCompleteCondition.wait(lock, [this] { return completedWorkers == voiceWorkers.size(); });
 
-                    bufferOffset++;
-                }
-            }
+            for (auto &voiceWorker : voiceWorkers)
+                skyline::audio::MixFloat(mixBus.data(), voiceWorker->bus.data(), mixBus.size());
         }
+
+        state.audio->statistics.rendererMix.Record(static_cast<u64>(util::GetTimeNs() - startTime));
     }
 
     Result IAudioRenderer::Start(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
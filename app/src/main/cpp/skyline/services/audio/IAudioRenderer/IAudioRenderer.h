@@ -69,17 +69,61 @@ namespace skyline {
             std::vector<MemoryPool> memoryPools;
             std::vector<Effect> effects;
             std::vector<Voice> voices;
-            std::array<i16, constant::MixBufferSize * constant::StereoChannelCount> sampleBuffer{}; //!< The final output data that is appended to the stream
             skyline::audio::AudioOutState playbackState{skyline::audio::AudioOutState::Stopped};
 
+            using MixBus = std::array<float, constant::MixBufferSize * constant::StereoChannelCount>; //!< A bus of normalized floating-point samples that voices are accumulated into, this is appended to the track as-is and only clamped at the output
+            MixBus mixBus{};
+
+            std::mutex rendererMutex; //!< Synchronizes the state of voices, memory pools and effects between RequestUpdate and the renderer thread
+            std::thread rendererThread; //!< A thread which renders a buffer whenever the track releases one, this decouples rendering from when the guest calls RequestUpdate
+            std::mutex renderRequestMutex; //!< Synchronizes the render request flags, this is separate from the renderer mutex as the track's release callback is called with its buffer lock held
+            std::condition_variable renderRequestCondition;
+            bool renderRequested{}; //!< If the track has released buffers that need to be rendered
+            bool exitRenderer{};
+
+            static constexpr size_t VoiceBatchSize{16}; //!< The amount of voices mixed together by a single thread at a time
+            static constexpr size_t MaxVoiceWorkerCount{3}; //!< The maximum amount of threads aside from the renderer thread that voice batches are distributed across
+
+            /**
+             * @brief A thread that mixes batches of voices into its own bus in parallel with the renderer thread
+             */
+            struct VoiceWorker {
+                std::thread thread;
+                MixBus bus;
+            };
+
+            std::vector<std::unique_ptr<VoiceWorker>> voiceWorkers; //!< The voice workers, these are only created when there are enough voices for parallel mixing to be worthwhile
+            std::mutex batchMutex; //!< Synchronizes the batch generation and completion state
+            std::condition_variable batchCondition; //!< Signalled when a new generation of batches is ready to be mixed or the workers should exit
+            std::condition_variable batchCompleteCondition; //!< Signalled when a worker has completed its share of batches
+            u64 batchGeneration{}; //!< A counter which is incremented for every mix the workers should participate in
+            size_t completedWorkers{}; //!< The amount of workers that have completed the current generation
+            std::atomic<size_t> nextBatch{}; //!< The index of the next batch of voices to be mixed by any thread
+            bool exitWorkers{};
+
+            /**
+             * @brief Performs the initialization common to all renderer threads as they access guest memory through voices
+             */
+            void SetupRendererThread(const char *name);
+
+            void RendererThread();
+
+            void VoiceWorkerThread(VoiceWorker &worker);
+
+            /**
+             * @brief Mixes batches of voices into the supplied bus till there are no more unclaimed batches
+             */
+            void MixVoiceBatches(MixBus &bus);
+
             /**
              * @brief Obtains new sample data from voices and mixes it together into the sample buffer
-             * @return The amount of samples present in the buffer
+             * @note The renderer mutex MUST be locked when calling this
              */
             void MixFinalBuffer();
 
             /**
              * @brief Appends all released buffers with new mixed sample data
+             * @note The renderer mutex MUST be locked when calling this
              */
             void UpdateAudio();
 
@@ -90,7 +134,7 @@ namespace skyline {
             IAudioRenderer(const DeviceState &state, ServiceManager &manager, AudioRendererParameters &parameters);
 
             /**
-             * @brief Closes the audio track
+             * @brief Closes the audio track and stops all renderer threads
              */
             ~IAudioRenderer();
 
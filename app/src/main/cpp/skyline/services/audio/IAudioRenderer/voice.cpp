@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <common/settings.h>
 #include <kernel/types/KProcess.h>
 #include <audio/downmixer.h>
 #include "voice.h"
@@ -11,14 +12,25 @@ namespace skyline::service::audio::IAudioRenderer {
         bufferReload = true;
     }
 
-    Voice::Voice(const DeviceState &state) : state(state) {}
+    Voice::Voice(const DeviceState &state, u32 frameCount)
+        : state(state),
+          sourceSamples(SourceBufferFrames * constant::StereoChannelCount),
+          outputSamples(frameCount * constant::StereoChannelCount),
+          resampler(*state.settings->highQualityAudioResampling ? skyline::audio::Resampler::Quality::Polyphase : skyline::audio::Resampler::Quality::Fast) {}
+
+    void Voice::ResetStream() {
+        sourceFrames = 0;
+        waveBufferOffset = 0;
+        cachedSamples.reset();
+        resampler.Reset();
+    }
 
     void Voice::ProcessInput(const VoiceIn &input) {
         // Voice no longer in use, reset it
         if (acquired && !input.acquired) {
             bufferReload = true;
             bufferIndex = 0;
-            sampleOffset = 0;
+            ResetStream();
 
             output.playedSamplesCount = 0;
             output.playedWaveBuffersCount = 0;
@@ -42,92 +54,132 @@ namespace skyline::service::audio::IAudioRenderer {
 
             channelCount = static_cast<u8>(input.channelCount);
 
-            if (input.format == skyline::audio::AudioFormat::ADPCM) {
-                std::vector<std::array<i16, 2>> adpcmCoefficients(input.adpcmCoeffsSize / (sizeof(u16) * 2));
-                span(adpcmCoefficients).copy_from(span(input.adpcmCoeffs, input.adpcmCoeffsSize / sizeof(u32)));
-
-                adpcmDecoder = skyline::audio::AdpcmDecoder(std::move(adpcmCoefficients));
-            }
+            if (input.format == skyline::audio::AudioFormat::ADPCM)
+                adpcmDecoder.emplace(span(reinterpret_cast<const std::array<i16, 2> *>(input.adpcmCoeffs), input.adpcmCoeffsSize / sizeof(std::array<i16, 2>)));
 
+            ResetStream();
             SetWaveBufferIndex(static_cast<u8>(input.baseWaveBufferIndex));
         }
 
         waveBuffers = input.waveBuffers;
         volume = input.volume;
+        pitch = input.pitch > 0.0f ? input.pitch : 1.0f;
         playbackState = input.playbackState;
     }
 
-    void Voice::UpdateBuffers() {
-        const auto &currentBuffer{waveBuffers.at(bufferIndex)};
-        span buffer(currentBuffer.pointer, currentBuffer.size);
+    size_t Voice::QueueSourceFrames(size_t frameCount) {
+        u8 sourceChannelCount{GetSourceChannelCount()};
+        frameCount = std::min(frameCount, SourceBufferFrames - sourceFrames);
 
-        if (currentBuffer.size == 0)
-            return;
-
-        switch (format) {
-            case skyline::audio::AudioFormat::Int16:
-                samples.resize(currentBuffer.size / sizeof(i16));
-                span(samples).copy_from(buffer);
-                break;
-            case skyline::audio::AudioFormat::ADPCM: {
-                samples = adpcmDecoder->Decode(buffer);
+        size_t queuedFrames{};
+        while (queuedFrames < frameCount && playbackState == skyline::audio::AudioOutState::Started) {
+            const auto &waveBuffer{waveBuffers[bufferIndex]};
+            size_t waveBufferFrames{format == skyline::audio::AudioFormat::ADPCM ? (waveBuffer.size / skyline::audio::AdpcmDecoder::BytesPerFrame) * skyline::audio::AdpcmDecoder::SamplesPerFrame : waveBuffer.size / (sizeof(i16) * channelCount)};
+            if (waveBufferFrames == 0)
                 break;
-            }
-            default:
-                throw exception("Unsupported PCM format used by Voice: {}", format);
-        }
-
-        if (sampleRate != constant::SampleRate)
-            samples = resampler.ResampleBuffer(samples, static_cast<double>(sampleRate) / constant::SampleRate, channelCount);
 
-        if (channelCount == 1 && constant::StereoChannelCount != channelCount) {
-            auto originalSize{samples.size()};
-            samples.resize((originalSize / channelCount) * constant::StereoChannelCount);
+            if (bufferReload) {
+                bufferReload = false;
+                waveBufferOffset = 0;
+                cachedSamples = format == skyline::audio::AudioFormat::ADPCM ? adpcmDecoder->DecodeCached(span(waveBuffer.pointer, waveBuffer.size), state.audio->adpcmCache) : nullptr;
+            }
 
-            for (auto monoIndex{originalSize - 1}, targetIndex{samples.size()}; monoIndex > 0; monoIndex--) {
-                auto sample{samples[monoIndex]};
-                for (u8 i{}; i < constant::StereoChannelCount; i++)
-                    samples[--targetIndex] = sample;
+            size_t count{std::min(frameCount - queuedFrames, waveBufferFrames - waveBufferOffset)};
+            i16 *destination{sourceSamples.data() + (sourceFrames + queuedFrames) * sourceChannelCount};
+            switch (format) {
+                case skyline::audio::AudioFormat::ADPCM:
+                    if (cachedSamples) {
+                        std::memcpy(destination, cachedSamples->data() + waveBufferOffset, count * sizeof(i16));
+                    } else {
+                        // Uncached buffers are decoded in whole frames as decoding can only start at the beginning of a frame
+                        count -= count % skyline::audio::AdpcmDecoder::SamplesPerFrame;
+                        if (count == 0)
+                            return queuedFrames;
+
+                        auto frameData{span(waveBuffer.pointer, waveBuffer.size).subspan((waveBufferOffset / skyline::audio::AdpcmDecoder::SamplesPerFrame) * skyline::audio::AdpcmDecoder::BytesPerFrame, (count / skyline::audio::AdpcmDecoder::SamplesPerFrame) * skyline::audio::AdpcmDecoder::BytesPerFrame)};
+                        adpcmDecoder->DecodeFrames(frameData, span(destination, count));
+                    }
+                    break;
+
+                case skyline::audio::AudioFormat::Int16: {
+                    auto source{reinterpret_cast<const i16 *>(waveBuffer.pointer) + waveBufferOffset * channelCount};
+                    if (channelCount <= constant::StereoChannelCount) {
+                        std::memcpy(destination, source, count * channelCount * sizeof(i16));
+                    } else if (channelCount == constant::SurroundChannelCount) {
+                        skyline::audio::DownMix(span(reinterpret_cast<const skyline::audio::Surround51Sample *>(source), count), span(reinterpret_cast<skyline::audio::StereoSample *>(destination), count));
+                    } else {
+                        // Only the front channels are kept for other layouts as there's no defined downmix for them
+                        for (size_t frame{}; frame < count; frame++) {
+                            destination[frame * constant::StereoChannelCount] = source[frame * channelCount];
+                            destination[frame * constant::StereoChannelCount + 1] = source[frame * channelCount + 1];
+                        }
+                    }
+                    break;
+                }
+
+                default:
+                    throw exception("Unsupported PCM format used by Voice: {}", format);
             }
-        }
 
-        if (channelCount == constant::SurroundChannelCount) {
-            span(samples).copy_from(span(skyline::audio::DownMix(span(samples).cast<skyline::audio::Surround51Sample>())));
-            samples.resize((samples.size() / constant::SurroundChannelCount) * constant::StereoChannelCount);
-        }
-    }
+            waveBufferOffset += count;
+            queuedFrames += count;
+            output.playedSamplesCount += count;
 
-    std::vector<i16> &Voice::GetBufferData(u32 maxSamples, u32 &outOffset, u32 &outSize) {
-        auto &currentBuffer{waveBuffers.at(bufferIndex)};
+            if (waveBufferOffset == waveBufferFrames) {
+                waveBufferOffset = 0;
+                output.playedWaveBuffersCount++;
 
-        if (!acquired || playbackState != skyline::audio::AudioOutState::Started) {
-            outSize = 0;
-            return samples;
-        }
+                if (waveBuffer.lastBuffer)
+                    playbackState = skyline::audio::AudioOutState::Paused;
 
-        if (bufferReload) {
-            bufferReload = false;
-            UpdateBuffers();
+                if (!waveBuffer.looping)
+                    SetWaveBufferIndex(static_cast<u8>(bufferIndex + 1));
+            }
         }
 
-        outOffset = sampleOffset;
-        outSize = std::min(maxSamples * constant::StereoChannelCount, static_cast<u32>(samples.size() - sampleOffset));
-
-        output.playedSamplesCount += outSize / constant::StereoChannelCount;
-        sampleOffset += outSize;
-
-        if (sampleOffset == samples.size()) {
-            sampleOffset = 0;
+        sourceFrames += queuedFrames;
+        return queuedFrames;
+    }
 
-            if (currentBuffer.lastBuffer)
-                playbackState = skyline::audio::AudioOutState::Paused;
+    span<const i16> Voice::Render(u32 frameCount) {
+        if (!acquired || playbackState != skyline::audio::AudioOutState::Started)
+            return {};
+
+        u8 sourceChannelCount{GetSourceChannelCount()};
+        double ratio{static_cast<double>(sampleRate) * pitch / constant::SampleRate};
+        size_t maxFrames{std::min<size_t>(frameCount, outputSamples.size() / constant::StereoChannelCount)}, renderedFrames{};
+        while (renderedFrames < maxFrames) {
+            // Only as many source frames as the remaining output requires are queued, this limits how much is left queued when the voice stops
+            size_t remainingFrames{maxFrames - renderedFrames};
+            size_t requiredFrames{static_cast<size_t>(std::ceil(static_cast<double>(remainingFrames) * ratio)) + ResamplerTapFrames};
+            size_t queuedFrames{sourceFrames < requiredFrames ? QueueSourceFrames(requiredFrames - sourceFrames) : 0};
+
+            // Samples are rendered with the source channel count and mono samples are expanded to stereo after all frames are rendered
+            span<const i16> source{sourceSamples.data(), sourceFrames * sourceChannelCount};
+            span<i16> destination{outputSamples.data() + renderedFrames * sourceChannelCount, remainingFrames * sourceChannelCount};
+            size_t consumedFrames, written;
+            if (ratio == 1.0) {
+                consumedFrames = std::min(sourceFrames, remainingFrames);
+                written = consumedFrames * sourceChannelCount;
+                std::memcpy(destination.data(), source.data(), written * sizeof(i16));
+            } else {
+                written = resampler.ResampleStream(source, destination, ratio, sourceChannelCount, consumedFrames);
+            }
 
-            if (!currentBuffer.looping)
-                SetWaveBufferIndex(static_cast<u8>(bufferIndex + 1));
+            if (consumedFrames) {
+                sourceFrames -= consumedFrames;
+                std::memmove(sourceSamples.data(), sourceSamples.data() + consumedFrames * sourceChannelCount, sourceFrames * sourceChannelCount * sizeof(i16));
+            }
+            renderedFrames += written / sourceChannelCount;
 
-            output.playedWaveBuffersCount++;
+            if (!queuedFrames && !written)
+                break; // The wave buffers have been exhausted, the voice will be resumed when more are appended
         }
 
-        return samples;
+        if (sourceChannelCount == 1)
+            for (size_t frame{renderedFrames}; frame-- > 0;)
+                outputSamples[frame * constant::StereoChannelCount] = outputSamples[frame * constant::StereoChannelCount + 1] = outputSamples[frame];
+
+        return span(outputSamples).first(renderedFrames * constant::StereoChannelCount);
     }
 }
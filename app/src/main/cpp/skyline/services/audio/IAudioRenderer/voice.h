@@ -71,28 +71,50 @@ namespace skyline::service::audio::IAudioRenderer {
 
     /**
      * @brief The Voice class manages an audio voice
+     * @note All sample buffers are allocated when the voice is created and wave buffers are streamed through them, so rendering a voice doesn't allocate
      */
     class Voice {
       private:
+        static constexpr size_t SourceBufferFrames{0x200}; //!< The maximum amount of source frames queued for resampling at once
+        static constexpr size_t ResamplerTapFrames{0x10}; //!< The amount of frames past the output position that the resampler may require
+
         const DeviceState &state;
         std::array<WaveBuffer, 4> waveBuffers;
-        std::vector<i16> samples; //!< A vector containing processed sample data
+        std::vector<i16> sourceSamples; //!< Frames from wave buffers at the source sample rate that are queued for resampling, these have at most two channels as surround audio is downmixed when queued
+        size_t sourceFrames{}; //!< The amount of frames in the source buffer
+        std::vector<i16> outputSamples; //!< The stereo output of the last render
+        std::shared_ptr<const std::vector<i16>> cachedSamples; //!< The decoded samples of the current ADPCM wave buffer if it was decoded through the ADPCM cache
         skyline::audio::Resampler resampler; //!< The resampler object used for changing the sample rate of a wave buffer's stream
         std::optional<skyline::audio::AdpcmDecoder> adpcmDecoder;
 
         bool acquired{false}; //!< If the voice is in use
         bool bufferReload{true};
         u8 bufferIndex{}; //!< The index of the wave buffer currently in use
-        u32 sampleOffset{}; //!< The offset in the sample data of the current wave buffer
+        size_t waveBufferOffset{}; //!< The offset in frames of the next frame to be queued from the current wave buffer
         u32 sampleRate{};
+        float pitch{1.0f}; //!< The playback rate of the voice relative to its sample rate
         u8 channelCount{};
         skyline::audio::AudioOutState playbackState{skyline::audio::AudioOutState::Stopped};
         skyline::audio::AudioFormat format{skyline::audio::AudioFormat::Invalid};
 
         /**
-         * @brief Updates the sample buffer with data from the current wave buffer and processes it
+         * @return The amount of channels in the source buffer
+         */
+        u8 GetSourceChannelCount() const {
+            return channelCount == 1 ? 1 : constant::StereoChannelCount;
+        }
+
+        /**
+         * @brief Queues frames from the wave buffers into the source buffer, advancing through wave buffers as they're exhausted
+         * @param frameCount The maximum amount of frames to queue
+         * @return The amount of frames that were queued
          */
-        void UpdateBuffers();
+        size_t QueueSourceFrames(size_t frameCount);
+
+        /**
+         * @brief Discards all queued samples and resets the streaming state
+         */
+        void ResetStream();
 
         /**
          * @brief Sets the current wave buffer index to use
@@ -104,7 +126,10 @@ namespace skyline::service::audio::IAudioRenderer {
         VoiceOut output{};
         float volume{};
 
-        Voice(const DeviceState &state);
+        /**
+         * @param frameCount The maximum amount of frames that will be rendered at once
+         */
+        Voice(const DeviceState &state, u32 frameCount);
 
         /**
          * @brief Reads the input voice data from the guest and sets internal data based off it
@@ -113,11 +138,11 @@ namespace skyline::service::audio::IAudioRenderer {
         void ProcessInput(const VoiceIn &input);
 
         /**
-         * @brief Obtains the voices audio sample data, updating it if required
-         * @param maxSamples The maximum amount of samples the output buffer should contain
-         * @return A vector of I16 PCM sample data
+         * @brief Renders the next frames of the voice at the output sample rate
+         * @param frameCount The maximum amount of frames to render
+         * @return A span of stereo I16 PCM sample data, this is shorter than requested if the voice ran out of wave buffers and is only valid till the next render
          */
-        std::vector<i16> &GetBufferData(u32 maxSamples, u32 &outOffset, u32 &outSize);
+        span<const i16> Render(u32 frameCount);
 
         /**
          * @return If the voice is currently playable
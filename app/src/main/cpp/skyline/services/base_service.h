@@ -10,7 +10,7 @@ constexpr static skyline::u32 TipcFunctionIdFlag{1U << 31}; //!< Flag applied to
 #define SFUNC(id, Class, Function) std::pair<u32, std::pair<Result(Class::*)(type::KSession &, ipc::IpcRequest &, ipc::IpcResponse &), const char*>>{id, {&Class::Function, SERVICE_STRINGIFY(Class::Function)}}
 #define SFUNC_TIPC(id, Class, Function) std::pair<u32, std::pair<Result(Class::*)(type::KSession &, ipc::IpcRequest &, ipc::IpcResponse &), const char*>>{TipcFunctionIdFlag | id, {&Class::Function, SERVICE_STRINGIFY(Class::Function)}}
 #define SFUNC_BASE(id, Class, BaseClass, Function) std::pair<u32, std::pair<Result(Class::*)(type::KSession &, ipc::IpcRequest &, ipc::IpcResponse &), const char*>>{id, {&Class::CallBaseFunction<BaseClass, decltype(&BaseClass::Function), &BaseClass::Function>, SERVICE_STRINGIFY(Class::Function)}}
-#define SERVICE_DECL_AUTO(name, value) decltype(value) name = value
+#define SERVICE_DECL_AUTO(name, value) static constexpr decltype(value) name{value}
 #define SERVICE_DECL(...)                                                                                      \
 private:                                                                                                       \
 template<typename BaseClass, typename BaseFunctionType, BaseFunctionType BaseFunction>                         \
@@ -19,8 +19,11 @@ Result CallBaseFunction(type::KSession &session, ipc::IpcRequest &request, ipc::
 }                                                                                                              \
 SERVICE_DECL_AUTO(functions, frozen::make_unordered_map({__VA_ARGS__}));                                       \
 protected:                                                                                                     \
-ServiceFunctionDescriptor GetServiceFunction(u32 id, bool isTipc) override {                                   \
-    auto& function{functions.at((isTipc ? TipcFunctionIdFlag : 0U) | id)};                                     \
+std::optional<ServiceFunctionDescriptor> GetServiceFunction(u32 id, bool isTipc) override {                    \
+    auto it{functions.find((isTipc ? TipcFunctionIdFlag : 0U) | id)};                                          \
+    if (it == functions.end()) [[unlikely]]                                                                    \
+        return std::nullopt;                                                                                   \
+    auto &function{it->second};                                                                                \
     return ServiceFunctionDescriptor{                                                                          \
         reinterpret_cast<DerivedService*>(this),                                                               \
         reinterpret_cast<decltype(ServiceFunctionDescriptor::function)>(function.first),                       \
@@ -38,6 +41,7 @@ namespace skyline::service {
     using ServiceName = u64; //!< Service names are a maximum of 8 bytes so we use a u64 to store them
 
     class ServiceManager;
+    class ServiceWorker;
 
     /**
      * @brief The base class for the HOS service interfaces hosted by sysmodules
@@ -49,6 +53,7 @@ namespace skyline::service {
       protected:
         const DeviceState &state;
         ServiceManager &manager;
+        ServiceWorker *worker{}; //!< The worker thread that requests to this service are executed on, requests are executed on the calling thread when this is null
 
         class DerivedService; //!< A placeholder derived class which is used for class function semantics
 
@@ -73,8 +78,11 @@ namespace skyline::service {
          */
         virtual ~BaseService() = default;
 
-        virtual ServiceFunctionDescriptor GetServiceFunction(u32 id, bool isTipc) {
-            throw std::out_of_range("GetServiceFunction not implemented");
+        /**
+         * @return The descriptor of the function with the supplied ID or std::nullopt if the service doesn't implement it
+         */
+        virtual std::optional<ServiceFunctionDescriptor> GetServiceFunction(u32 id, bool isTipc) {
+            return std::nullopt;
         }
 
         /**
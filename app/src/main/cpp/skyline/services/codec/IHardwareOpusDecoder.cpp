@@ -23,7 +23,7 @@ namespace skyline::service::codec {
         // We utilize the guest-supplied work buffer for allocating the OpusDecoder object into
         decoderState = reinterpret_cast<OpusDecoder *>(workBuffer->host.data());
 
-        if (int result = opus_decoder_init(decoderState, sampleRate, channelCount) != OPUS_OK)
+        if (int result{opus_decoder_init(decoderState, sampleRate, channelCount)}; result != OPUS_OK)
             throw OpusException(result);
     }
 
@@ -63,7 +63,9 @@ namespace skyline::service::codec {
         auto sampleDataIn = dataIn.subspan(sizeof(OpusDataHeader));
 
         auto perfTimer{timesrv::TimeSpanType::FromNanoseconds(util::GetTimeNs())};
-        i32 decodedCount{opus_decode(decoderState, sampleDataIn.data(), opusPacketSize, dataOut.data(), static_cast<int>(decoderOutputBufferSize), false)};
+        // The frame size is in samples per channel and is bounded by the output buffer so libopus can never write past its end
+        auto maxFrameSize{static_cast<int>(std::min<size_t>(dataOut.size(), decoderOutputBufferSize) / static_cast<size_t>(channelCount))};
+        i32 decodedCount{opus_decode(decoderState, sampleDataIn.data(), opusPacketSize, dataOut.data(), maxFrameSize, false)};
         perfTimer = timesrv::TimeSpanType::FromNanoseconds(util::GetTimeNs()) - perfTimer;
 
         if (decodedCount < 0)
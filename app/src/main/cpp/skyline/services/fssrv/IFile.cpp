@@ -1,13 +1,16 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <services/serviceman.h>
 #include "results.h"
 #include "IFile.h"
 
 namespace skyline::service::fssrv {
     IFile::IFile(std::shared_ptr<vfs::Backing> backing, const DeviceState &state, ServiceManager &manager)
         : BaseService(state, manager),
-          backing(std::move(backing)) {}
+          backing(std::move(backing)) {
+        worker = &manager.GetServiceWorker("fs"); // Reads may block on host storage for a considerable amount of time
+    }
 
     Result IFile::Read(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         auto readOption{request.Pop<u32>()};
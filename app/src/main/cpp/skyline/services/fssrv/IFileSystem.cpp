@@ -83,6 +83,7 @@ namespace skyline::service::fssrv {
     }
 
     Result IFileSystem::Commit(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        backing->Commit();
         return {};
     }
 }
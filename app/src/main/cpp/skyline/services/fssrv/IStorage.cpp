@@ -1,11 +1,15 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <services/serviceman.h>
 #include "results.h"
 #include "IStorage.h"
 
 namespace skyline::service::fssrv {
-    IStorage::IStorage(std::shared_ptr<vfs::Backing> backing, const DeviceState &state, ServiceManager &manager) : backing(std::move(backing)), BaseService(state, manager) {}
+    IStorage::IStorage(std::shared_ptr<vfs::Backing> backing, const DeviceState &state, ServiceManager &manager) : backing(std::move(backing)), BaseService(state, manager) {
+        // Storage is read-only and every backing beneath it can be read concurrently, so reads from parallel guest loader threads are serviced in parallel to keep multiple reads outstanding on host storage
+        worker = &manager.GetServiceWorker("fs:storage", StorageWorkerThreadCount);
+    }
 
     Result IStorage::Read(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         auto offset{request.Pop<i64>()};
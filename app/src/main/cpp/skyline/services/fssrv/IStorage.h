@@ -13,6 +13,7 @@ namespace skyline::service::fssrv {
      */
     class IStorage : public BaseService {
       private:
+        static constexpr size_t StorageWorkerThreadCount{4}; //!< The amount of threads that reads from all storages are serviced on
         std::shared_ptr<vfs::Backing> backing;
 
       public:
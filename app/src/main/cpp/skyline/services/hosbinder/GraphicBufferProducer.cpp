@@ -141,7 +141,7 @@ namespace skyline::service::hosbinder {
         }
 
         buffer->state = BufferState::Dequeued;
-        fence = buffer->fence; // We just let the presentation engine return a buffer which is ready to be written into, there is no need for further synchronization
+        fence = buffer->fence; // Presented buffers are only freed once they're ready to be written into while cancelled buffers retain the fence supplied with them, the client waits on it prior to writing
 
         Logger::Debug("#{} - Dimensions: {}x{}, Format: {}, Usage: 0x{:X}, Is Async: {}", slot, width, height, ToString(format), usage, async);
         return AndroidStatus::Ok;
@@ -423,11 +423,12 @@ namespace skyline::service::hosbinder {
             return;
         }
 
-        fence.Wait(state.soc->host1x);
-
+        // The fence isn't waited on here as that would block the binder transaction, it's instead handed back to the client with the buffer when it's next dequeued as Android does
+        buffer.fence = fence;
         buffer.state = BufferState::Free;
         buffer.frameNumber = 0;
         bufferEvent->Signal();
+        freeCondition.notify_all();
 
         Logger::Debug("#{}", slot);
     }
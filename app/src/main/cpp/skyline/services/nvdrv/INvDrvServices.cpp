@@ -38,32 +38,30 @@ namespace skyline::service::nvdrv {
         return NVRESULT(NvResult::Success);
     }
 
-    static NvResultValue<span<u8>> GetMainIoctlBuffer(IoctlDescriptor ioctl, span<u8> inBuf, span<u8> outBuf) {
+    static NvResultValue<IoctlBuffers> GetMainIoctlBuffers(IoctlDescriptor ioctl, span<u8> inBuf, span<u8> outBuf) {
         if (ioctl.in && inBuf.size() < ioctl.size)
             return NvResult::InvalidSize;
 
         if (ioctl.out && outBuf.size() < ioctl.size)
             return NvResult::InvalidSize;
 
-        if (ioctl.in && ioctl.out) {
-            if (outBuf.size() < inBuf.size())
-                return NvResult::InvalidSize;
-
-            // Copy in buf to out buf for inout ioctls to avoid needing to pass around two buffers everywhere
-            if (outBuf.data() != inBuf.data())
-                outBuf.copy_from(inBuf, ioctl.size);
-        }
+        // The input isn't copied to the output for inout ioctls, arguments are decoded from whichever buffer they're accessed through and only those which are written are copied over
+        if (ioctl.in && ioctl.out && outBuf.size() < inBuf.size())
+            return NvResult::InvalidSize;
 
-        return ioctl.out ? outBuf : inBuf;
+        return IoctlBuffers{
+            .in = ioctl.in ? inBuf : span<u8>{},
+            .out = ioctl.out ? outBuf : span<u8>{},
+        };
     }
 
     Result INvDrvServices::Ioctl(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         auto fd{request.Pop<FileDescriptor>()};
         auto ioctl{request.Pop<IoctlDescriptor>()};
 
-        auto buf{GetMainIoctlBuffer(ioctl,
-                                    !request.inputBuf.empty() ? request.inputBuf.at(0) : span<u8>{},
-                                    !request.outputBuf.empty() ? request.outputBuf.at(0) : span<u8>{})};
+        auto buf{GetMainIoctlBuffers(ioctl,
+                                     !request.inputBuf.empty() ? request.inputBuf.at(0) : span<u8>{},
+                                     !request.outputBuf.empty() ? request.outputBuf.at(0) : span<u8>{})};
         if (!buf)
             return NVRESULT(buf);
         else
@@ -108,9 +106,9 @@ namespace skyline::service::nvdrv {
         // Inline buffer is optional
         auto inlineBuf{request.inputBuf.size() > 1 ? request.inputBuf.at(1) : span<u8>{}};
 
-        auto buf{GetMainIoctlBuffer(ioctl,
-                                    !request.inputBuf.empty() ? request.inputBuf.at(0) : span<u8>{},
-                                    !request.outputBuf.empty() ? request.outputBuf.at(0) : span<u8>{})};
+        auto buf{GetMainIoctlBuffers(ioctl,
+                                     !request.inputBuf.empty() ? request.inputBuf.at(0) : span<u8>{},
+                                     !request.outputBuf.empty() ? request.outputBuf.at(0) : span<u8>{})};
         if (!buf)
             return NVRESULT(buf);
         else
@@ -124,9 +122,9 @@ namespace skyline::service::nvdrv {
         // Inline buffer is optional
         auto inlineBuf{request.outputBuf.size() > 1 ? request.outputBuf.at(1) : span<u8>{}};
 
-        auto buf{GetMainIoctlBuffer(ioctl,
-                                    !request.inputBuf.empty() ? request.inputBuf.at(0) : span<u8>{},
-                                    !request.outputBuf.empty() ? request.outputBuf.at(0) : span<u8>{})};
+        auto buf{GetMainIoctlBuffers(ioctl,
+                                     !request.inputBuf.empty() ? request.inputBuf.at(0) : span<u8>{},
+                                     !request.outputBuf.empty() ? request.outputBuf.at(0) : span<u8>{})};
         if (!buf)
             return NVRESULT(buf);
         else
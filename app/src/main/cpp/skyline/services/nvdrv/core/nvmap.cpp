@@ -58,18 +58,70 @@ namespace skyline::service::nvdrv::core {
 
     NvMap::NvMap(const DeviceState &state) : state(state), smmuAllocator(soc::SmmuPageSize) {}
 
-    void NvMap::AddHandle(std::shared_ptr<Handle> handleDesc) {
+    std::shared_ptr<NvMap::Handle> NvMap::AddHandle(u64 size) {
         std::scoped_lock lock(handlesLock);
 
-        handles.emplace(handleDesc->id, std::move(handleDesc));
+        u32 slotIndex;
+        if (!freeHandleSlots.empty()) {
+            slotIndex = freeHandleSlots.back();
+            freeHandleSlots.pop_back();
+        } else {
+            if (handleSlots.size() >= MaxHandleSlots) [[unlikely]]
+                throw exception("Ran out of nvmap handle slots!");
+
+            slotIndex = static_cast<u32>(handleSlots.size());
+            handleSlots.emplace_back();
+        }
+
+        auto &slot{handleSlots[slotIndex]};
+        slot.handle = std::make_shared<Handle>(size, GetHandleId(slotIndex, slot.generation));
+        return slot.handle;
+    }
+
+    NvMap::HandleSlot *NvMap::FindHandleSlot(Handle::Id id) {
+        u32 slotIndex{((id >> HandleSlotShift) & MaxHandleSlots) - 1};
+        if (slotIndex >= handleSlots.size()) [[unlikely]]
+            return nullptr;
+
+        // Checking the whole ID rejects IDs of previous occupants of the slot along with any that have unexpected low bits set
+        auto &slot{handleSlots[slotIndex]};
+        if (!slot.handle || GetHandleId(slotIndex, slot.generation) != id) [[unlikely]]
+            return nullptr;
+
+        return &slot;
+    }
+
+    void NvMap::PushUnmapQueue(std::shared_ptr<Handle> handleDesc) {
+        handleDesc->unmapQueuePrev = unmapQueueTail;
+        handleDesc->unmapQueueNext = nullptr;
+        if (unmapQueueTail)
+            unmapQueueTail->unmapQueueNext = handleDesc.get();
+        else
+            unmapQueueHead = handleDesc.get();
+        unmapQueueTail = handleDesc.get();
+
+        handleDesc->unmapQueueRef = std::move(handleDesc);
+    }
+
+    void NvMap::EraseUnmapQueue(Handle &handleDesc) {
+        if (handleDesc.unmapQueuePrev)
+            handleDesc.unmapQueuePrev->unmapQueueNext = handleDesc.unmapQueueNext;
+        else
+            unmapQueueHead = handleDesc.unmapQueueNext;
+
+        if (handleDesc.unmapQueueNext)
+            handleDesc.unmapQueueNext->unmapQueuePrev = handleDesc.unmapQueuePrev;
+        else
+            unmapQueueTail = handleDesc.unmapQueuePrev;
+
+        handleDesc.unmapQueuePrev = handleDesc.unmapQueueNext = nullptr;
+        handleDesc.unmapQueueRef.reset(); // This must be last as it may destroy the handle
     }
 
     void NvMap::UnmapHandle(Handle &handleDesc) {
         // Remove pending unmap queue entry if needed
-        if (handleDesc.unmapQueueEntry) {
-            unmapQueue.erase(*handleDesc.unmapQueueEntry);
-            handleDesc.unmapQueueEntry.reset();
-        }
+        if (handleDesc.unmapQueueRef)
+            EraseUnmapQueue(handleDesc);
 
         // Free and unmap the handle from the SMMU
         state.soc->smmu.Unmap(handleDesc.pinVirtAddress, static_cast<u32>(handleDesc.alignedSize));
@@ -77,15 +129,16 @@ namespace skyline::service::nvdrv::core {
         handleDesc.pinVirtAddress = 0;
     }
 
-
     bool NvMap::TryRemoveHandle(const Handle &handleDesc) {
         // No dupes left, we can remove from handle map
         if (handleDesc.dupes == 0 && handleDesc.internalDupes == 0) {
             std::scoped_lock lock(handlesLock);
 
-            auto it{handles.find(handleDesc.id)};
-            if (it != handles.end())
-                handles.erase(it);
+            if (auto slot{FindHandleSlot(handleDesc.id)}) {
+                slot->handle.reset();
+                slot->generation++;
+                freeHandleSlots.push_back(static_cast<u32>(slot - handleSlots.data()));
+            }
 
             return true;
         } else {
@@ -97,21 +150,14 @@ namespace skyline::service::nvdrv::core {
         if (!size) [[unlikely]]
             return PosixResult::InvalidArgument;
 
-        u32 id{nextHandleId.fetch_add(HandleIdIncrement, std::memory_order_relaxed)};
-        auto handleDesc{std::make_shared<Handle>(size, id)};
-        AddHandle(handleDesc);
-
-        return handleDesc;
+        return AddHandle(size);
     }
 
     std::shared_ptr<NvMap::Handle> NvMap::GetHandle(Handle::Id handle) {
         std::scoped_lock lock(handlesLock);
 
-        try {
-            return handles.at(handle);
-        } catch (std::out_of_range &e) {
-            return nullptr;
-        }
+        auto slot{FindHandleSlot(handle)};
+        return slot ? slot->handle : nullptr;
     }
 
     u32 NvMap::PinHandle(NvMap::Handle::Id handle) {
@@ -125,9 +171,8 @@ namespace skyline::service::nvdrv::core {
             {
                 // Lock now to prevent our queue entry from being removed for allocation in-between the following check and erase
                 std::scoped_lock queueLock(unmapQueueLock);
-                if (handleDesc->unmapQueueEntry) {
-                    unmapQueue.erase(*handleDesc->unmapQueueEntry);
-                    handleDesc->unmapQueueEntry.reset();
+                if (handleDesc->unmapQueueRef) {
+                    EraseUnmapQueue(*handleDesc);
 
                     handleDesc->pins++;
                     return handleDesc->pinVirtAddress;
@@ -139,11 +184,16 @@ namespace skyline::service::nvdrv::core {
             while (!(address = smmuAllocator.Allocate(static_cast<u32>(handleDesc->alignedSize)))) {
                 // Free handles until the allocation succeeds
                 std::scoped_lock queueLock(unmapQueueLock);
-                if (auto freeHandleDesc{unmapQueue.front()}) {
+                if (unmapQueueHead) {
+                    // A reference is taken as unmapping removes the handle from the queue which may otherwise destroy it while its mutex is held
+                    auto freeHandleDesc{unmapQueueHead->unmapQueueRef};
+
                     // Handles in the unmap queue are guaranteed not to be pinned so don't bother checking if they are before unmapping
                     std::scoped_lock freeLock(freeHandleDesc->mutex);
-                    if (handleDesc->pinVirtAddress)
+                    if (freeHandleDesc->pinVirtAddress)
                         UnmapHandle(*freeHandleDesc);
+                    else
+                        EraseUnmapQueue(*freeHandleDesc);
                 } else {
                     throw exception("Ran out of SMMU address space!");
                 }
@@ -169,8 +219,7 @@ namespace skyline::service::nvdrv::core {
             std::scoped_lock queueLock(unmapQueueLock);
 
             // Add to the unmap queue allowing this handle's memory to be freed if needed
-            unmapQueue.push_back(handleDesc);
-            handleDesc->unmapQueueEntry = std::prev(unmapQueue.end());
+            PushUnmapQueue(std::move(handleDesc));
         }
     }
 
@@ -33,7 +33,10 @@ namespace skyline::service::nvdrv::core {
 
             i32 pins{};
             u32 pinVirtAddress{};
-            std::optional<std::list<std::shared_ptr<Handle>>::iterator> unmapQueueEntry{};
+
+            Handle *unmapQueuePrev{}; //!< The handle unpinned before this one in the unmap queue
+            Handle *unmapQueueNext{}; //!< The handle unpinned after this one in the unmap queue
+            std::shared_ptr<Handle> unmapQueueRef; //!< Keeps the handle alive while it's in the unmap queue, this is only non-null while the handle is queued
 
             struct Flags {
                 bool mapUncached : 1; //!< If the handle should be mapped as uncached
@@ -79,20 +82,61 @@ namespace skyline::service::nvdrv::core {
         const DeviceState &state;
 
         FlatAllocator<u32, 0, 32> smmuAllocator;
-        std::list<std::shared_ptr<Handle>> unmapQueue;
-        std::mutex unmapQueueLock; //!< Protects access to `unmapQueue`
+        Handle *unmapQueueHead{}; //!< The least recently unpinned handle, this is the first to be unmapped when SMMU address space runs out
+        Handle *unmapQueueTail{}; //!< The most recently unpinned handle
+        std::mutex unmapQueueLock; //!< Protects access to the unmap queue and the queue members of all handles
+
+        /**
+         * @brief A slot in the handle table, handle IDs encode the slot index alongside its generation so stale IDs of a reused slot are rejected
+         */
+        struct HandleSlot {
+            std::shared_ptr<Handle> handle;
+            u32 generation{};
+        };
 
-        std::unordered_map<Handle::Id, std::shared_ptr<Handle>> handles; //!< Main owning map of handles
-        std::mutex handlesLock; //!< Protects access to `handles`
+        static constexpr u32 HandleIdIncrement{4}; //!< Each handle ID is a multiple of 4 as on HOS, the slot index (offset by 1 to avoid a 0 ID) is stored directly above these bits
+        static constexpr u32 HandleSlotBits{18}; //!< The amount of bits used for the slot index in a handle ID, the remaining upper bits hold the slot generation
+        static constexpr u32 HandleSlotShift{std::countr_zero(HandleIdIncrement)};
+        static constexpr u32 HandleGenerationShift{HandleSlotShift + HandleSlotBits};
+        static constexpr u32 MaxHandleSlots{(1U << HandleSlotBits) - 1};
 
-        static constexpr u32 HandleIdIncrement{4}; //!< Each new handle ID is an increment of 4 from the previous
-        std::atomic<u32> nextHandleId{HandleIdIncrement};
+        std::vector<HandleSlot> handleSlots; //!< Main owning table of handles indexed by the slot encoded in their ID
+        std::vector<u32> freeHandleSlots; //!< Indices of slots in `handleSlots` which currently don't hold a handle
+        std::mutex handlesLock; //!< Protects access to `handleSlots` and `freeHandleSlots`
 
-        void AddHandle(std::shared_ptr<Handle> handle);
+        /**
+         * @return The ID of a handle in the slot with the given index and generation, any generation bits that don't fit into the ID are discarded
+         */
+        static constexpr Handle::Id GetHandleId(u32 slotIndex, u32 generation) {
+            return (generation << HandleGenerationShift) | ((slotIndex + 1) << HandleSlotShift);
+        }
+
+        /**
+         * @brief Creates a handle of the given size in a free slot of the handle table, reusing previously freed slots where possible
+         */
+        std::shared_ptr<Handle> AddHandle(u64 size);
+
+        /**
+         * @return The slot corresponding to the supplied ID or nullptr if the ID doesn't refer to a live handle
+         * @note `handlesLock` MUST be locked when calling this
+         */
+        HandleSlot *FindHandleSlot(Handle::Id id);
+
+        /**
+         * @brief Appends a handle to the end of the unmap queue
+         * @note `unmapQueueLock` MUST be locked when calling this
+         */
+        void PushUnmapQueue(std::shared_ptr<Handle> handleDesc);
+
+        /**
+         * @brief Removes a handle from the unmap queue, this may destroy the handle if the queue held the last reference to it
+         * @note `unmapQueueLock` MUST be locked when calling this
+         */
+        void EraseUnmapQueue(Handle &handleDesc);
 
         /**
          * @brief Unmaps and frees the SMMU memory region a handle is mapped to
-         * @note Both `unmapQueueLock` and `handleDesc.mutex` MUST be locked when calling this
+         * @note Both `unmapQueueLock` and `handleDesc.mutex` MUST be locked when calling this, the caller must also hold a reference to the handle
          */
         void UnmapHandle(Handle &handleDesc);
 
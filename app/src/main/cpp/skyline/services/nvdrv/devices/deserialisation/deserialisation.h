@@ -8,31 +8,64 @@
 #include "types.h"
 
 namespace skyline::service::nvdrv::deserialisation {
+    /**
+     * @return The region of the ioctl buffers that an argument at the given offset should be accessed through
+     * @tparam Read If the handler reads the argument, these are accessed in-place in the input buffer unless they're also written
+     * @tparam Write If the handler writes the argument, these are accessed in-place in the output buffer with their input value copied over beforehand if they're also read
+     */
+    template<typename Desc, bool Read, bool Write>
+    constexpr span<u8> GetArgumentRegion(IoctlBuffers buffers, size_t offset, size_t size) {
+        if constexpr (!Desc::Out) {
+            return buffers.in.subspan(offset, size);
+        } else if constexpr (!Desc::In || !Read) {
+            return buffers.out.subspan(offset, size);
+        } else if constexpr (!Write) {
+            return buffers.in.subspan(offset, size);
+        } else {
+            auto region{buffers.out.subspan(offset, size)};
+            if (buffers.in.data() != buffers.out.data())
+                region.copy_from(buffers.in.subspan(offset, size));
+            return region;
+        }
+    }
+
+    /**
+     * @return The size of the region after the given offset which variable length arguments can occupy
+     */
+    template<typename Desc>
+    constexpr size_t GetRemainingSize(IoctlBuffers buffers, size_t offset) {
+        return (Desc::In ? buffers.in.size() : buffers.out.size()) - offset;
+    }
+
     template<typename Desc, typename ArgType> requires (Desc::In && IsIn<ArgType>::value)
-    constexpr ArgType DecodeArgument(span<u8, Desc::Size> buffer, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
-        auto out{buffer.subspan(offset).template as<ArgType, true>()};
+    constexpr ArgType DecodeArgument(IoctlBuffers buffers, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
+        auto out{GetArgumentRegion<Desc, true, false>(buffers, offset, sizeof(ArgType)).template as<ArgType, true>()};
         offset += sizeof(ArgType);
         return out;
     }
 
     template<typename Desc, typename ArgType> requires (Desc::Out && Desc::In && IsInOut<ArgType>::value)
-    constexpr ArgType DecodeArgument(span<u8, Desc::Size> buffer, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
-        auto &out{buffer.subspan(offset).template as<RemoveInOut<ArgType>, true>()};
+    constexpr ArgType DecodeArgument(IoctlBuffers buffers, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
+        auto &out{GetArgumentRegion<Desc, true, true>(buffers, offset, sizeof(RemoveInOut<ArgType>)).template as<RemoveInOut<ArgType>, true>()};
         offset += sizeof(RemoveInOut<ArgType>);
         return out;
     }
 
     template<typename Desc, typename ArgType> requires (Desc::Out && IsOut<ArgType>::value)
-    constexpr ArgType DecodeArgument(span<u8, Desc::Size> buffer, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
-        auto out{Out(buffer.subspan(offset).template as<RemoveOut<ArgType>, true>())};
+    constexpr ArgType DecodeArgument(IoctlBuffers buffers, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
+        auto out{Out(GetArgumentRegion<Desc, false, true>(buffers, offset, sizeof(RemoveOut<ArgType>)).template as<RemoveOut<ArgType>, true>())};
         offset += sizeof(RemoveOut<ArgType>);
         return out;
     }
 
+    /**
+     * @note Spans of const elements are only read by their handler so they're accessed directly from the input buffer, otherwise they're copied to the output buffer for in/out ioctls
+     */
     template<typename Desc, typename ArgType> requires (IsSlotSizeSpan<ArgType>::value)
-    constexpr auto DecodeArgument(span<u8, Desc::Size> buffer, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
-        size_t bytes{saveSlots[ArgType::SaveSlot] * sizeof(RemoveSlotSizeSpan<ArgType>)};
-        auto out{buffer.subspan(offset, bytes).template cast<RemoveSlotSizeSpan<ArgType>, std::dynamic_extent, true>()};
+    constexpr auto DecodeArgument(IoctlBuffers buffers, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
+        using ElementType = RemoveSlotSizeSpan<ArgType>;
+        size_t bytes{saveSlots[ArgType::SaveSlot] * sizeof(ElementType)};
+        auto out{GetArgumentRegion<Desc, true, !std::is_const_v<ElementType>>(buffers, offset, bytes).template cast<ElementType, std::dynamic_extent, true>()};
         offset += bytes;
 
         // Return a simple `span` as that will be the function argument type as opposed to `SlotSizeSpan`
@@ -48,41 +81,42 @@ namespace skyline::service::nvdrv::deserialisation {
     }
 
     template<typename Desc, typename ArgType, typename... ArgTypes>
-    constexpr auto DecodeArgumentsImpl(span<u8, Desc::Size> buffer, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
+    constexpr auto DecodeArgumentsImpl(IoctlBuffers buffers, size_t &offset, std::array<size_t, NumSaveSlots> &saveSlots) {
         if constexpr (IsAutoSizeSpan<ArgType>::value) {
             // AutoSizeSpan needs to be the last argument
             static_assert(sizeof...(ArgTypes) == 0);
-            return make_ref_tuple(buffer.subspan(offset).template cast<RemoveAutoSizeSpan<ArgType>, std::dynamic_extent, true>());
+            using ElementType = RemoveAutoSizeSpan<ArgType>;
+            return make_ref_tuple(GetArgumentRegion<Desc, true, !std::is_const_v<ElementType>>(buffers, offset, GetRemainingSize<Desc>(buffers, offset)).template cast<ElementType, std::dynamic_extent, true>());
         } else if constexpr (IsPad<ArgType>::value) {
             offset += ArgType::Bytes;
             if constexpr(sizeof...(ArgTypes) == 0) {
                 return std::tuple{};
             } else {
-                return DecodeArgumentsImpl<Desc, ArgTypes...>(buffer, offset, saveSlots);
+                return DecodeArgumentsImpl<Desc, ArgTypes...>(buffers, offset, saveSlots);
             }
         } else if constexpr (IsSave<ArgType>::value) {
-            saveSlots[ArgType::SaveSlot] = buffer.subspan(offset).template as<RemoveSave<ArgType>, true>();
+            saveSlots[ArgType::SaveSlot] = GetArgumentRegion<Desc, true, false>(buffers, offset, sizeof(RemoveSave<ArgType>)).template as<RemoveSave<ArgType>, true>();
             offset += sizeof(RemoveSave<ArgType>);
-            return DecodeArgumentsImpl<Desc, ArgTypes...>(buffer, offset, saveSlots);
+            return DecodeArgumentsImpl<Desc, ArgTypes...>(buffers, offset, saveSlots);
         } else {
             if constexpr(sizeof...(ArgTypes) == 0) {
-                return make_ref_tuple(DecodeArgument<Desc, ArgType>(buffer, offset, saveSlots));
+                return make_ref_tuple(DecodeArgument<Desc, ArgType>(buffers, offset, saveSlots));
             } else {
-                return std::tuple_cat(make_ref_tuple(DecodeArgument<Desc, ArgType>(buffer, offset, saveSlots)),
-                                                     DecodeArgumentsImpl<Desc, ArgTypes...>(buffer, offset, saveSlots));
+                return std::tuple_cat(make_ref_tuple(DecodeArgument<Desc, ArgType>(buffers, offset, saveSlots)),
+                                                     DecodeArgumentsImpl<Desc, ArgTypes...>(buffers, offset, saveSlots));
             }
         }
     }
 
     /**
-     * @brief This fancy thing takes a varadic template of argument types and uses it to deserialise the given buffer
+     * @brief This fancy thing takes a varadic template of argument types and uses it to deserialise the given buffers
      * @tparam Desc A MetaIoctlDescriptor or MetaVariableIoctlDescriptor corresponding to the IOCTL that takes these arguments
-     * @return A tuple containing the arguments to be passed to the IOCTL's handler
+     * @return A tuple containing the arguments to be passed to the IOCTL's handler, these refer directly to the guest buffers
      */
     template<typename Desc, typename... ArgTypes>
-    constexpr auto DecodeArguments(span<u8, Desc::Size> buffer) {
+    constexpr auto DecodeArguments(IoctlBuffers buffers) {
         size_t offset{};
         std::array<size_t, NumSaveSlots> saveSlots{}; // No need to zero init as used slots will always be loaded first
-        return DecodeArgumentsImpl<Desc, ArgTypes...>(buffer, offset, saveSlots);
+        return DecodeArgumentsImpl<Desc, ArgTypes...>(buffers, offset, saveSlots);
     }
 }
\ No newline at end of file
@@ -43,13 +43,13 @@ namespace skyline::service::nvdrv::device {
          */
         const std::string &GetName();
 
-        virtual PosixResult Ioctl(IoctlDescriptor cmd, span<u8> buffer) = 0;
+        virtual PosixResult Ioctl(IoctlDescriptor cmd, IoctlBuffers buffers) = 0;
 
-        virtual PosixResult Ioctl2(IoctlDescriptor cmd, span<u8> buffer, span<u8> inlineOutput) {
+        virtual PosixResult Ioctl2(IoctlDescriptor cmd, IoctlBuffers buffers, span<u8> inlineOutput) {
             return PosixResult::InappropriateIoctlForDevice;
         }
 
-        virtual PosixResult Ioctl3(IoctlDescriptor cmd, span<u8> buffer, span<u8> inlineInput) {
+        virtual PosixResult Ioctl3(IoctlDescriptor cmd, IoctlBuffers buffers, span<u8> inlineInput) {
             return PosixResult::InappropriateIoctlForDevice;
         }
 
@@ -101,13 +101,21 @@ namespace skyline::service::nvdrv::device::nvhost {
         // Sparse mappings shouldn't be fully unmapped, just returned to their sparse state
         // Only FreeSpace can unmap them fully
         if (mapping->sparseAlloc)
-            asCtx->gmmu.Map(offset, GMMU::SparsePlaceholderAddress(), mapping->size, {true});
+            pendingMappingUpdates.push_back({offset, GMMU::SparsePlaceholderAddress(), mapping->size, {true}});
         else
-            asCtx->gmmu.Unmap(offset, mapping->size);
+            pendingMappingUpdates.push_back({offset, nullptr, mapping->size, {}});
 
         mappingMap.erase(offset);
     }
 
+    void AsGpu::FlushMappingUpdatesLocked() {
+        if (pendingMappingUpdates.empty())
+            return;
+
+        asCtx->gmmu.MapBatch(pendingMappingUpdates);
+        pendingMappingUpdates.clear();
+    }
+
     PosixResult AsGpu::FreeSpace(In<u64> offset, In<u32> pages, In<u32> pageSize) {
         Logger::Debug("offset: 0x{:X}, pages: 0x{:X}, pageSize: 0x{:X}", offset, pages, pageSize);
 
@@ -127,7 +135,9 @@ namespace skyline::service::nvdrv::device::nvhost {
 
             // Unset sparse flag if required
             if (allocation.sparse)
-                asCtx->gmmu.Unmap(offset, allocation.size);
+                pendingMappingUpdates.push_back({offset, nullptr, allocation.size, {}});
+
+            FlushMappingUpdatesLocked();
 
             bool bigPage{pageSize != VM::PageSize};
             auto &allocator{bigPage ? *vm.bigPageAllocator : *vm.smallPageAllocator};
@@ -136,6 +146,7 @@ namespace skyline::service::nvdrv::device::nvhost {
             allocator.Free(static_cast<u32>(offset >> pageSizeBits), static_cast<u32>(allocation.size >> pageSizeBits));
             allocationMap.erase(offset);
         } catch (const std::out_of_range &e) {
+            FlushMappingUpdatesLocked();
             return PosixResult::InvalidArgument;
         }
 
@@ -152,6 +163,7 @@ namespace skyline::service::nvdrv::device::nvhost {
 
         try {
             FreeMappingLocked(offset);
+            FlushMappingUpdatesLocked();
         } catch (const std::out_of_range &e) {
             Logger::Warn("Couldn't find region to unmap at 0x{:X}", offset);
         }
@@ -316,7 +328,7 @@ namespace skyline::service::nvdrv::device::nvhost {
         return PosixResult::Success;
     }
 
-    PosixResult AsGpu::Remap(span<RemapEntry> entries) {
+    PosixResult AsGpu::Remap(span<const RemapEntry> entries) {
         std::scoped_lock lock(mutex);
 
         if (!vm.initialised)
@@ -330,27 +342,34 @@ namespace skyline::service::nvdrv::device::nvhost {
 
             if (alloc-- == allocationMap.begin() || (virtAddr - alloc->first) + size > alloc->second.size) {
                 Logger::Warn("Cannot remap into an unallocated region!");
+                FlushMappingUpdatesLocked();
                 return PosixResult::InvalidArgument;
             }
 
             if (!alloc->second.sparse) {
                 Logger::Warn("Cannot remap a non-sparse mapping!");
+                FlushMappingUpdatesLocked();
                 return PosixResult::InvalidArgument;
             }
 
             if (!entry.handle) {
-                asCtx->gmmu.Map(virtAddr, GMMU::SparsePlaceholderAddress(), size, {true});
+                pendingMappingUpdates.push_back({virtAddr, GMMU::SparsePlaceholderAddress(), size, {true}});
             } else {
                 auto h{core.nvMap.GetHandle(entry.handle)};
-                if (!h)
+                if (!h) {
+                    FlushMappingUpdatesLocked();
                     return PosixResult::InvalidArgument;
+                }
 
                 u8 *cpuPtr{reinterpret_cast<u8 *>(h->address + (static_cast<u64>(entry.handleOffsetBigPages) << vm.bigPageSizeBits))};
 
-                asCtx->gmmu.Map(virtAddr, cpuPtr, size);
+                pendingMappingUpdates.push_back({virtAddr, cpuPtr, size, {}});
             }
         }
 
+        // All entries are applied together so lookups never observe a partially remapped region and cached lookups are only invalidated once
+        FlushMappingUpdatesLocked();
+
         return PosixResult::Success;
     }
 
@@ -374,7 +393,7 @@ namespace skyline::service::nvdrv::device::nvhost {
                         AllocAsEx,    ARGS(In<u32>, In<FileDescriptor>, In<u32>, Pad<u32>, In<u64>, In<u64>, In<u64>))
     }), ({
         VARIABLE_IOCTL_CASE_ARGS(INOUT, MAGIC(AsGpuMagic), FUNC(0x14),
-                                 Remap, ARGS(AutoSizeSpan<RemapEntry>))
+                                 Remap, ARGS(AutoSizeSpan<const RemapEntry>))
     }))
 
     INLINE_IOCTL_HANDLER_FUNC(Ioctl3, AsGpu, ({
@@ -42,6 +42,7 @@ namespace skyline::service::nvdrv::device::nvhost {
         std::map<u64, std::shared_ptr<Mapping>> mappingMap; //!< This maps the base addresses of mapped buffers to their total sizes and mapping type, this is needed as what was originally a single buffer may have been split into multiple GPU side buffers with the remap flag.
         std::map<u64, Allocation> allocationMap; //!< Holds allocations created by AllocSpace from which fixed buffers can be mapped into
         std::mutex mutex; //!< Locks all AS operations
+        std::vector<soc::gm20b::GMMU::MappingUpdate> pendingMappingUpdates; //!< GMMU mapping changes that are batched up to be applied together, this is retained between operations to avoid reallocation
 
         struct VM {
             static constexpr u32 PageSize{soc::gm20b::GmmuSmallPageSize};
@@ -71,8 +72,18 @@ namespace skyline::service::nvdrv::device::nvhost {
 
         friend GpuChannel;
 
+        /**
+         * @brief Frees a mapping and queues its GMMU unmap into `pendingMappingUpdates`
+         * @note `mutex` MUST be locked when calling this and `FlushMappingUpdatesLocked()` MUST be called afterwards
+         */
         void FreeMappingLocked(u64 offset);
 
+        /**
+         * @brief Applies all of the pending GMMU mapping changes as a single batch
+         * @note `mutex` MUST be locked when calling this
+         */
+        void FlushMappingUpdatesLocked();
+
       public:
         struct MappingFlags {
             bool fixed : 1;
@@ -159,10 +170,10 @@ namespace skyline::service::nvdrv::device::nvhost {
          * @brief Remaps a region of the GPU address space
          * @url https://switchbrew.org/wiki/NV_services#NVGPU_AS_IOCTL_REMAP
          */
-        PosixResult Remap(span<RemapEntry> entries);
+        PosixResult Remap(span<const RemapEntry> entries);
 
-        PosixResult Ioctl(IoctlDescriptor cmd, span<u8> buffer) override;
+        PosixResult Ioctl(IoctlDescriptor cmd, IoctlBuffers buffers) override;
 
-        PosixResult Ioctl3(IoctlDescriptor cmd, span<u8> buffer, span<u8> inlineBuffer) override;
+        PosixResult Ioctl3(IoctlDescriptor cmd, IoctlBuffers buffers, span<u8> inlineBuffer) override;
     };
 }
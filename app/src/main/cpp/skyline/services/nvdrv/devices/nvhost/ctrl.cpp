@@ -7,7 +7,14 @@
 #include "ctrl.h"
 
 namespace skyline::service::nvdrv::device::nvhost {
-    Ctrl::SyncpointEvent::SyncpointEvent(const DeviceState &state) : event(std::make_shared<type::KEvent>(state, false)) {}
+    Ctrl::SyncpointEvent::SyncpointEvent(const DeviceState &state) : signalCallback([this] { Signal(); }), event(std::make_shared<type::KEvent>(state, false)) {}
+
+    void Ctrl::SyncpointEvent::Allocate() {
+        allocated = true;
+        state = State::Available;
+        fence = {};
+        event->ResetSignal();
+    }
 
     void Ctrl::SyncpointEvent::Signal() {
         // We should only signal the KEvent if the event is actively being waited on
@@ -20,10 +27,11 @@ namespace skyline::service::nvdrv::device::nvhost {
         waiterHandle = {};
     }
 
-    void Ctrl::SyncpointEvent::RegisterWaiter(soc::host1x::Host1x &host1x, const Fence &pFence) {
+    bool Ctrl::SyncpointEvent::RegisterWaiter(soc::host1x::Host1x &host1x, const Fence &pFence) {
         fence = pFence;
         state = State::Waiting;
-        waiterHandle = host1x.syncpoints.at(fence.id).host.RegisterWaiter(fence.threshold, [this] { Signal(); });
+        waiterHandle = host1x.syncpoints.at(fence.id).host.RegisterWaiter(fence.threshold, signalCallback);
+        return !waiterHandle; // The handle is only invalid when the callback was called immediately
     }
 
     bool Ctrl::SyncpointEvent::IsInUse() {
@@ -32,21 +40,21 @@ namespace skyline::service::nvdrv::device::nvhost {
             state == SyncpointEvent::State::Signalling;
     }
 
-    Ctrl::Ctrl(const DeviceState &state, Driver &driver, Core &core, const SessionContext &ctx) : NvDevice(state, driver, core, ctx) {}
+    Ctrl::Ctrl(const DeviceState &state, Driver &driver, Core &core, const SessionContext &ctx) : NvDevice(state, driver, core, ctx), syncpointEvents(util::MakeFilledArray<SyncpointEvent, SyncpointEventCount>(state)) {}
 
     u32 Ctrl::FindFreeSyncpointEvent(u32 syncpointId) {
         u32 eventSlot{SyncpointEventCount}; //!< Holds the slot of the last populated event in the event array
         u32 freeSlot{SyncpointEventCount}; //!< Holds the slot of the first unused event id
 
         for (u32 i{}; i < SyncpointEventCount; i++) {
-            if (syncpointEvents[i]) {
-                const auto &event{syncpointEvents[i]};
+            if (syncpointEvents[i].allocated) {
+                auto &event{syncpointEvents[i]};
 
-                if (!event->IsInUse()) {
+                if (!event.IsInUse()) {
                     eventSlot = i;
 
                     // This event is already attached to the requested syncpoint, so use it
-                    if (event->fence.id == syncpointId)
+                    if (event.fence.id == syncpointId)
                         return eventSlot;
                 }
             } else if (freeSlot == SyncpointEventCount) {
@@ -56,7 +64,7 @@ namespace skyline::service::nvdrv::device::nvhost {
 
         // Use an unused event if possible
         if (freeSlot < SyncpointEventCount) {
-            syncpointEvents[freeSlot] = std::make_unique<SyncpointEvent>(state);
+            syncpointEvents[freeSlot].Allocate();
             return freeSlot;
         }
 
@@ -115,12 +123,18 @@ namespace skyline::service::nvdrv::device::nvhost {
             return PosixResult::InvalidArgument;
 
         auto &event{syncpointEvents[slot]};
-        if (!event)
+        if (!event.allocated)
             return PosixResult::InvalidArgument;
 
-        if (!event->IsInUse()) {
+        if (!event.IsInUse()) {
             Logger::Debug("Waiting on syncpoint event: {} with fence: ({}, {})", slot, fence.id, fence.threshold);
-            event->RegisterWaiter(state.soc->host1x, fence);
+            if (event.RegisterWaiter(state.soc->host1x, fence)) {
+                // The fence was reached between the checks above and registration, returning success avoids the guest waiting on the event for no reason
+                event.state = SyncpointEvent::State::Available;
+                event.event->ResetSignal();
+                value.val = core.syncpointManager.UpdateMin(fence.id);
+                return PosixResult::Success;
+            }
 
             value.val = 0;
 
@@ -145,13 +159,13 @@ namespace skyline::service::nvdrv::device::nvhost {
             return PosixResult::InvalidArgument;
 
         auto &event{syncpointEvents[slot]};
-        if (!event)
+        if (!event.allocated)
             return PosixResult::Success; // If the event doesn't already exist then we don't need to do anything
 
-        if (event->IsInUse()) // Avoid freeing events when they are still waiting etc.
+        if (event.IsInUse()) // Avoid freeing events when they are still waiting etc.
             return PosixResult::Busy;
 
-        syncpointEvents[slot] = nullptr;
+        event.allocated = false;
 
         return PosixResult::Success;
     }
@@ -166,17 +180,17 @@ namespace skyline::service::nvdrv::device::nvhost {
         std::scoped_lock lock{syncpointEventMutex};
 
         auto &event{syncpointEvents[slot]};
-        if (!event)
+        if (!event.allocated)
             return PosixResult::InvalidArgument;
 
-        if (event->state.exchange(SyncpointEvent::State::Cancelling) == SyncpointEvent::State::Waiting) {
+        if (event.state.exchange(SyncpointEvent::State::Cancelling) == SyncpointEvent::State::Waiting) {
             Logger::Debug("Cancelling waiting syncpoint event: {}", slot);
-            event->Cancel(state.soc->host1x);
-            core.syncpointManager.UpdateMin(event->fence.id);
+            event.Cancel(state.soc->host1x);
+            core.syncpointManager.UpdateMin(event.fence.id);
         }
 
-        event->state = SyncpointEvent::State::Cancelled;
-        event->event->ResetSignal();
+        event.state = SyncpointEvent::State::Cancelled;
+        event.event->ResetSignal();
 
         return PosixResult::Success;
     }
@@ -198,11 +212,11 @@ namespace skyline::service::nvdrv::device::nvhost {
         std::scoped_lock lock{syncpointEventMutex};
 
         auto &event{syncpointEvents[slot]};
-        if (event) // Recreate event if it already exists
+        if (event.allocated) // Recreate event if it already exists
             if (auto err{SyncpointFreeEventLocked(slot)}; err != PosixResult::Success)
                 return err;
 
-        event = std::make_unique<SyncpointEvent>(state);
+        event.Allocate();
 
         return PosixResult::Success;
     }
@@ -243,8 +257,8 @@ namespace skyline::service::nvdrv::device::nvhost {
         std::scoped_lock lock{syncpointEventMutex};
 
         auto &event{syncpointEvents[slot]};
-        if (event && event->fence.id == syncpointId)
-            return event->event;
+        if (event.allocated && event.fence.id == syncpointId)
+            return event.event;
 
         return nullptr;
     }
@@ -36,10 +36,12 @@ namespace skyline::service::nvdrv::device::nvhost {
       private:
         /**
          * @brief Syncpoint Events are used to expose fences to the userspace, they can be waited on using an IOCTL or be converted into a native HOS KEvent object that can be waited on just like any other KEvent on the guest
+         * @note Events are preallocated for every slot and reused across guest allocations, so waiting on them never requires any allocations
          */
         class SyncpointEvent {
           private:
             soc::host1x::Syncpoint::WaiterHandle waiterHandle{};
+            std::function<void()> signalCallback; //!< The callback registered as the syncpoint waiter, this is constructed once rather than on every wait
 
             void Signal();
 
@@ -58,6 +60,13 @@ namespace skyline::service::nvdrv::device::nvhost {
             std::atomic<State> state{State::Available};
             Fence fence{}; //!< The fence that is associated with this syncpoint event
             std::shared_ptr<type::KEvent> event{}; //!< Returned by 'QueryEvent'
+            bool allocated{}; //!< If the event is currently allocated by the guest
+
+            /**
+             * @brief Marks the event as allocated and resets it to its initial state
+             * @note Accesses to this function for a specific event should be locked
+             */
+            void Allocate();
 
             /**
              * @brief Removes any wait requests on a syncpoint event and resets its state
@@ -68,8 +77,9 @@ namespace skyline::service::nvdrv::device::nvhost {
             /**
              * @brief Asynchronously waits on a syncpoint event using the given fence
              * @note Accesses to this function for a specific event should be locked
+             * @return If the fence had already been reached, in which case the event has been signalled immediately
              */
-            void RegisterWaiter(soc::host1x::Host1x &host1x, const Fence &fence);
+            bool RegisterWaiter(soc::host1x::Host1x &host1x, const Fence &fence);
 
             bool IsInUse();
         };
@@ -77,7 +87,7 @@ namespace skyline::service::nvdrv::device::nvhost {
         static constexpr u32 SyncpointEventCount{64}; //!< The maximum number of nvhost syncpoint events
 
         std::mutex syncpointEventMutex;
-        std::array<std::unique_ptr<SyncpointEvent>, SyncpointEventCount> syncpointEvents{};
+        std::array<SyncpointEvent, SyncpointEventCount> syncpointEvents;
 
         /**
          * @brief Finds a free syncpoint event for the given syncpoint ID
@@ -136,6 +146,6 @@ namespace skyline::service::nvdrv::device::nvhost {
 
         std::shared_ptr<type::KEvent> QueryEvent(u32 slot) override;
 
-        PosixResult Ioctl(IoctlDescriptor cmd, span<u8> buffer) override;
+        PosixResult Ioctl(IoctlDescriptor cmd, IoctlBuffers buffers) override;
     };
 }
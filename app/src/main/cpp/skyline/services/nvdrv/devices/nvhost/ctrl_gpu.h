@@ -130,8 +130,8 @@ namespace skyline::service::nvdrv::device::nvhost {
 
         std::shared_ptr<type::KEvent> QueryEvent(u32 eventId) override;
 
-        PosixResult Ioctl(IoctlDescriptor cmd, span<u8> buffer) override;
+        PosixResult Ioctl(IoctlDescriptor cmd, IoctlBuffers buffers) override;
 
-        PosixResult Ioctl3(IoctlDescriptor cmd, span<u8> buffer, span<u8> inlineBuffer) override;
+        PosixResult Ioctl3(IoctlDescriptor cmd, IoctlBuffers buffers, span<u8> inlineBuffer) override;
     };
 }
@@ -83,7 +83,7 @@ namespace skyline::service::nvdrv::device::nvhost {
     PosixResult GpuChannel::SubmitGpfifo(In<u64> userAddress, In<u32> numEntries,
                                          InOut<SubmitGpfifoFlags> flags,
                                          InOut<Fence> fence,
-                                         span<soc::gm20b::GpEntry> gpEntries) {
+                                         span<const soc::gm20b::GpEntry> gpEntries) {
         Logger::Debug("userAddress: 0x{:X}, numEntries: {},"
                             "flags ( fenceWait: {}, fenceIncrement: {}, hwFormat: {}, suppressWfi: {}, incrementWithValue: {}),"
                             "fence ( id: {}, threshold: {} )",
@@ -138,7 +138,7 @@ namespace skyline::service::nvdrv::device::nvhost {
     }
 
     PosixResult GpuChannel::SubmitGpfifo2(span<u8> inlineBuffer, In<u64> userAddress, In<u32> numEntries, InOut<GpuChannel::SubmitGpfifoFlags> flags, InOut<Fence> fence) {
-        return SubmitGpfifo(userAddress, numEntries, flags, fence, inlineBuffer.cast<soc::gm20b::GpEntry>());
+        return SubmitGpfifo(userAddress, numEntries, flags, fence, inlineBuffer.cast<const soc::gm20b::GpEntry>());
     }
 
     PosixResult GpuChannel::AllocObjCtx(In<u32> classId, In<u32> flags, Out<u64> objId) {
@@ -252,7 +252,7 @@ namespace skyline::service::nvdrv::device::nvhost {
                         GetUserData,      ARGS(Out<u64>))
     }), ({
         VARIABLE_IOCTL_CASE_ARGS(INOUT, MAGIC(GpuChannelMagic), FUNC(0x8),
-                                 SubmitGpfifo, ARGS(In<u64>, In<u32>, InOut<SubmitGpfifoFlags>, InOut<Fence>, AutoSizeSpan<soc::gm20b::GpEntry>))
+                                 SubmitGpfifo, ARGS(In<u64>, In<u32>, InOut<SubmitGpfifoFlags>, InOut<Fence>, AutoSizeSpan<const soc::gm20b::GpEntry>))
     }))
 
     INLINE_IOCTL_HANDLER_FUNC(Ioctl2, GpuChannel, ({
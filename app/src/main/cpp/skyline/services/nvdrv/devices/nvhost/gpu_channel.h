@@ -73,7 +73,7 @@ namespace skyline::service::nvdrv::device::nvhost {
         PosixResult SubmitGpfifo(In<u64> userAddress, In<u32> numEntries,
                                  InOut<SubmitGpfifoFlags> flags,
                                  InOut<Fence> fence,
-                                 span<soc::gm20b::GpEntry> gpEntries);
+                                 span<const soc::gm20b::GpEntry> gpEntries);
 
         /**
          * @brief Ioctl2 variant of SubmitGpfifo
@@ -132,8 +132,8 @@ namespace skyline::service::nvdrv::device::nvhost {
 
         std::shared_ptr<type::KEvent> QueryEvent(u32 eventId) override;
 
-        PosixResult Ioctl(IoctlDescriptor cmd, span<u8> buffer) override;
+        PosixResult Ioctl(IoctlDescriptor cmd, IoctlBuffers buffers) override;
 
-        PosixResult Ioctl2(IoctlDescriptor cmd, span<u8> buffer, span<u8> inlineBuffer) override;
+        PosixResult Ioctl2(IoctlDescriptor cmd, IoctlBuffers buffers, span<u8> inlineBuffer) override;
     };
 }
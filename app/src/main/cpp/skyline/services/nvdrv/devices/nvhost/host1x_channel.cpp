@@ -21,9 +21,9 @@ namespace skyline::service::nvdrv::device::nvhost {
         return PosixResult::Success;
     }
 
-    PosixResult Host1xChannel::Submit(span<SubmitCmdBuf> cmdBufs,
-                                      span<SubmitReloc> relocs, span<u32> relocShifts,
-                                      span<SubmitSyncpointIncr> syncpointIncrs, span<u32> fenceThresholds) {
+    PosixResult Host1xChannel::Submit(span<const SubmitCmdBuf> cmdBufs,
+                                      span<const SubmitReloc> relocs, span<const u32> relocShifts,
+                                      span<const SubmitSyncpointIncr> syncpointIncrs, span<u32> fenceThresholds) {
         Logger::Debug("numCmdBufs: {}, numRelocs: {}, numSyncpointIncrs: {}, numFenceThresholds: {}",
                             cmdBufs.size(), relocs.size(), syncpointIncrs.size(), fenceThresholds.size());
 
@@ -35,14 +35,17 @@ namespace skyline::service::nvdrv::device::nvhost {
 
         std::scoped_lock lock(channelMutex);
 
+        bool processGathers{channelType == core::ChannelType::NvDec || channelType == core::ChannelType::VIC};
+
         for (size_t i{}; i < syncpointIncrs.size(); i++) {
             const auto &incr{syncpointIncrs[i]};
 
             u32 max{core.syncpointManager.IncrementSyncpointMaxExt(incr.syncpointId, incr.numIncrs)};
 
-            // Increment syncpoints on the CPU to avoid needing to pass through the emulated nvdec code which currently does nothing
-            for (size_t j{}; j < incr.numIncrs; j++)
-                state.soc->host1x.syncpoints[incr.syncpointId].Increment();
+            // Classes other than NVDEC and VIC aren't emulated, so their syncpoints are incremented on the CPU rather than by their command buffers
+            if (!processGathers)
+                for (size_t j{}; j < incr.numIncrs; j++)
+                    state.soc->host1x.syncpoints[incr.syncpointId].Increment();
 
             if (i < fenceThresholds.size())
                 fenceThresholds[i] = max;
@@ -57,8 +60,8 @@ namespace skyline::service::nvdrv::device::nvhost {
             Logger::Debug("Submit gather, CPU address: 0x{:X}, words: 0x{:X}", gatherAddress, cmdBuf.words);
 
             span gather(reinterpret_cast<u32 *>(gatherAddress), cmdBuf.words);
-            // Skip submitting the cmdbufs as no functionality is implemented
-            // state.soc->host1x.channels[static_cast<size_t>(channelType)].Push(gather);
+            if (processGathers)
+                state.soc->host1x.channels[static_cast<size_t>(channelType)].Push(gather);
         }
 
         return PosixResult::Success;
@@ -127,9 +130,9 @@ namespace skyline::service::nvdrv::device::nvhost {
     }), ({
         VARIABLE_IOCTL_CASE_ARGS(INOUT, MAGIC(Host1xChannelMagic), FUNC(0x1),
                                  Submit,      ARGS(Save<u32, 0>, Save<u32, 1>, Save<u32, 2>, Save<u32, 3>,
-                                                   SlotSizeSpan<SubmitCmdBuf, 0>,
-                                                   SlotSizeSpan<SubmitReloc, 1>, SlotSizeSpan<u32, 1>,
-                                                   SlotSizeSpan<SubmitSyncpointIncr, 2>, SlotSizeSpan<u32, 3>))
+                                                   SlotSizeSpan<const SubmitCmdBuf, 0>,
+                                                   SlotSizeSpan<const SubmitReloc, 1>, SlotSizeSpan<const u32, 1>,
+                                                   SlotSizeSpan<const SubmitSyncpointIncr, 2>, SlotSizeSpan<u32, 3>))
         VARIABLE_IOCTL_CASE_ARGS(INOUT, MAGIC(Host1xChannelMagic), FUNC(0x9),
                                  MapBuffer,   ARGS(Save<u32, 0>, Pad<u32>, In<u8>, Pad<u8, 3>, SlotSizeSpan<BufferHandle, 0>))
         VARIABLE_IOCTL_CASE_ARGS(INOUT, MAGIC(Host1xChannelMagic), FUNC(0xA),
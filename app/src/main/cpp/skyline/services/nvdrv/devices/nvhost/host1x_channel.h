@@ -71,9 +71,9 @@ namespace skyline::service::nvdrv::device::nvhost {
          * @brief Submits the specified command buffer data to the channel and returns fences that can be waited on
          * @url https://switchbrew.org/wiki/NV_services#NVHOST_IOCTL_CHANNEL_SUBMIT
          */
-        PosixResult Submit(span<SubmitCmdBuf> cmdBufs,
-                           span<SubmitReloc> relocs, span<u32> relocShifts,
-                           span<SubmitSyncpointIncr> syncpointIncrs, span<u32> fenceThresholds);
+        PosixResult Submit(span<const SubmitCmdBuf> cmdBufs,
+                           span<const SubmitReloc> relocs, span<const u32> relocShifts,
+                           span<const SubmitSyncpointIncr> syncpointIncrs, span<u32> fenceThresholds);
 
         /**
          * @brief Returns the syncpoint ID that is located at the given index in this channel's syncpoint array
@@ -105,6 +105,6 @@ namespace skyline::service::nvdrv::device::nvhost {
          */
         PosixResult UnmapBuffer(u8 compressed, span<BufferHandle> handles);
 
-        PosixResult Ioctl(IoctlDescriptor cmd, span<u8> buffer) override;
+        PosixResult Ioctl(IoctlDescriptor cmd, IoctlBuffers buffers) override;
     };
 }
@@ -41,17 +41,17 @@ namespace skyline::service::nvdrv {
         /**
          * @brief Calls an IOCTL on the device specified by `fd`
          */
-        NvResult Ioctl(FileDescriptor fd, IoctlDescriptor cmd, span<u8> buffer);
+        NvResult Ioctl(FileDescriptor fd, IoctlDescriptor cmd, IoctlBuffers buffers);
 
         /**
          * @brief Calls an IOCTL on the device specified by `fd` using the given inline input buffer
          */
-        NvResult Ioctl2(FileDescriptor fd, IoctlDescriptor cmd, span<u8> buffer, span<u8> inlineBuffer);
+        NvResult Ioctl2(FileDescriptor fd, IoctlDescriptor cmd, IoctlBuffers buffers, span<u8> inlineBuffer);
 
         /**
          * @brief Calls an IOCTL on the device specified by `fd` using the given inline output buffer
          */
-        NvResult Ioctl3(FileDescriptor fd, IoctlDescriptor cmd, span<u8> buffer, span<u8> inlineBuffer);
+        NvResult Ioctl3(FileDescriptor fd, IoctlDescriptor cmd, IoctlBuffers buffers, span<u8> inlineBuffer);
 
         /**
          * @brief Queries a KEvent for the given `eventId` for the device specified by `fd`
@@ -70,6 +70,15 @@ namespace skyline::service::nvdrv {
     };
     static_assert(sizeof(IoctlDescriptor) == sizeof(u32));
 
+    /**
+     * @brief The guest IPC buffers of an ioctl, arguments are accessed in-place within these rather than being copied into an intermediate buffer
+     * @note For ioctls that are both in and out, the buffers may be distinct in which case only arguments that are both read and written are copied from the input to the output
+     */
+    struct IoctlBuffers {
+        span<u8> in; //!< The buffer arguments are read from, this is empty for ioctls that aren't in
+        span<u8> out; //!< The buffer results are written to, this is empty for ioctls that aren't out
+    };
+
     /**
      * @brief NvRm result codes that are translated from the POSIX error codes used internally
      * @url https://switchbrew.org/wiki/NV_services#NvError
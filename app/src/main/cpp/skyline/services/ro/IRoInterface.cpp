@@ -61,7 +61,7 @@ namespace skyline::service::ro {
         u64 roSize{executable.ro.contents.size()};
         u64 dataSize{executable.data.contents.size() + executable.bssSize};
 
-        auto patch{state.nce->GetPatchData(executable.text.contents)};
+        auto patch{state.nce->GetCachedPatchData(executable.text.contents)};
         auto size{patch.size + textSize + roSize + dataSize};
 
         u8 *ptr{};
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <common/signal.h>
+#include <nce.h>
+#include "service_worker.h"
+
+namespace skyline::service {
+    ServiceWorker::ServiceWorker(const DeviceState &state, std::string pName, size_t threadCount) : state{state}, name{std::move(pName)} {
+        for (size_t index{}; index < threadCount; index++)
+            threads.emplace_back(&ServiceWorker::Run, this);
+    }
+
+    ServiceWorker::~ServiceWorker() {
+        {
+            std::scoped_lock lock{mutex};
+            exit = true;
+        }
+        submitCondition.notify_all();
+        for (auto &thread : threads)
+            if (thread.joinable())
+                thread.join();
+    }
+
+    void ServiceWorker::Run() {
+        if (int result{pthread_setname_np(pthread_self(), fmt::format("Sky-Svc-{}", name).substr(0, 15).c_str())})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE}, signal::ExceptionalSignalHandler);
+        signal::SetSignalHandler({SIGSEGV}, nce::NCE::HostSignalHandler); // Request buffers may reside in NCE trapped memory
+
+        std::unique_lock lock{mutex};
+        while (true) {
+            submitCondition.wait(lock, [this] { return head || exit; });
+            if (!head)
+                return;
+
+            auto job{head};
+            head = job->next;
+            if (!head)
+                tail = nullptr;
+            lock.unlock();
+
+            // Services may access the guest state of the calling thread, so it's temporarily assumed by the worker
+            state.thread = job->thread;
+            state.ctx = job->ctx;
+            try {
+                job->result = job->function(job->context);
+            } catch (...) {
+                job->exception = std::current_exception();
+            }
+            state.thread = nullptr;
+            state.ctx = nullptr;
+
+            lock.lock();
+            job->done = true;
+            completeCondition.notify_all();
+        }
+    }
+
+    void ServiceWorker::SubmitJob(Job &job) {
+        {
+            std::unique_lock lock{mutex};
+            if (tail)
+                tail->next = &job;
+            else
+                head = &job;
+            tail = &job;
+            submitCondition.notify_one();
+
+            completeCondition.wait(lock, [&job] { return job.done; });
+        }
+
+        if (job.exception)
+            std::rethrow_exception(job.exception);
+    }
+}
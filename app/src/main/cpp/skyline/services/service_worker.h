@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <common.h>
+
+namespace skyline::service {
+    /**
+     * @brief A host thread that requests to a set of services are executed on, this is analogous to the server thread of a HOS sysmodule
+     * @note Requests to services sharing a worker are serialized and callers block until their request has been executed, they're removed from their guest core during this so other guest threads can run in the meantime
+     * @note A worker may have multiple threads which execute requests concurrently, this must only be used for services that are thread-safe
+     */
+    class ServiceWorker {
+      private:
+        /**
+         * @brief A request that has been submitted to the worker, this resides on the stack of the submitting thread
+         */
+        struct Job {
+            Result (*function)(void *); //!< A trampoline into the request function
+            void *context; //!< The request function which is passed into the trampoline
+            const std::shared_ptr<kernel::type::KThread> &thread; //!< The guest thread that submitted the request
+            nce::ThreadContext *ctx; //!< The context of the guest thread that submitted the request
+            Result result{};
+            std::exception_ptr exception{}; //!< Any exception that was thrown while executing the job, this is rethrown on the submitting thread
+            bool done{};
+            Job *next{};
+        };
+
+        const DeviceState &state;
+        std::string name;
+        std::mutex mutex; //!< Synchronizes access to the job queue
+        std::condition_variable submitCondition; //!< Signalled when a job is submitted or the worker is being destroyed
+        std::condition_variable completeCondition; //!< Signalled when a job has been executed
+        Job *head{}, *tail{}; //!< An intrusive FIFO queue of pending jobs
+        bool exit{}; //!< If the worker threads should exit once the queue has been drained
+        std::vector<std::thread> threads;
+
+        void Run();
+
+        /**
+         * @brief Queues the supplied job and blocks till it has been executed by the worker
+         */
+        void SubmitJob(Job &job);
+
+      public:
+        /**
+         * @param threadCount The amount of threads that execute requests, requests are only serialized if this is 1
+         */
+        ServiceWorker(const DeviceState &state, std::string name, size_t threadCount = 1);
+
+        ~ServiceWorker();
+
+        /**
+         * @brief Executes the supplied function on the worker thread with the guest state of the calling thread
+         * @return The result of the function, any exceptions it throws are forwarded to the caller
+         */
+        template<typename Function>
+        Result Submit(Function &&function) {
+            Job job{
+                .function = [](void *context) -> Result {
+                    return (*static_cast<std::remove_reference_t<Function> *>(context))();
+                },
+                .context = &function,
+                .thread = state.thread,
+                .ctx = state.ctx,
+            };
+            SubmitJob(job);
+            return job.result;
+        }
+    };
+}
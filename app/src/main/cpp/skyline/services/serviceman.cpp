@@ -2,6 +2,7 @@
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
 #include <kernel/types/KProcess.h>
+#include <kernel/results.h>
 #include <common/trace.h>
 #include "sm/IUserInterface.h"
 #include "settings/ISettingsServer.h"
@@ -62,10 +63,15 @@
     case util::MakeMagic<ServiceName>(name): { \
             std::shared_ptr<BaseService> serviceObject{std::make_shared<class>(state, *this, ##__VA_ARGS__)}; \
             serviceMap[util::MakeMagic<ServiceName>(name)] = serviceObject; \
+            serviceNameMap[serviceObject.get()] = util::MakeMagic<ServiceName>(name); \
             return serviceObject; \
         }
 
 namespace skyline::service {
+    namespace {
+        constexpr Result TargetNotFound(10, 261); //!< The CMIF result for a domain request to an object ID that doesn't refer to any object
+    }
+
     struct GlobalServiceState {
         timesrv::core::TimeServiceObject timesrv;
         pl::SharedFontCore sharedFontCore;
@@ -148,14 +154,21 @@ namespace skyline::service {
         }
     }
 
+    ServiceWorker &ServiceManager::GetServiceWorker(std::string_view name, size_t threadCount) {
+        std::scoped_lock lock{workerMutex};
+        auto &worker{workers[name]};
+        if (!worker)
+            worker = std::make_unique<ServiceWorker>(state, std::string{name}, threadCount);
+        return *worker;
+    }
+
     std::shared_ptr<BaseService> ServiceManager::NewService(ServiceName name, type::KSession &session, ipc::IpcResponse &response) {
         std::scoped_lock serviceGuard{mutex};
         auto serviceObject{CreateOrGetService(name)};
         KHandle handle{};
         if (session.isDomain) {
-            session.domains.push_back(serviceObject);
-            response.domainObjects.push_back(session.handleIndex);
-            handle = session.handleIndex++;
+            handle = session.AddDomainObject(serviceObject);
+            response.domainObjects.push_back(handle);
         } else {
             handle = state.process->NewHandle<type::KSession>(serviceObject).handle;
             response.moveHandles.push_back(handle);
@@ -169,9 +182,8 @@ namespace skyline::service {
         KHandle handle{};
 
         if (session.isDomain) {
-            session.domains.push_back(serviceObject);
-            response.domainObjects.push_back(session.handleIndex);
-            handle = session.handleIndex++;
+            handle = session.AddDomainObject(serviceObject);
+            response.domainObjects.push_back(handle);
         } else {
             handle = state.process->NewHandle<type::KSession>(serviceObject).handle;
             response.moveHandles.push_back(handle);
@@ -180,29 +192,38 @@ namespace skyline::service {
         Logger::Debug("Service has been registered: \"{}\" (0x{:X})", serviceObject->GetName(), handle);
     }
 
+    void ServiceManager::ReleaseService(const BaseService *service) {
+        auto nameIt{serviceNameMap.find(service)};
+        if (nameIt == serviceNameMap.end())
+            return; // Sub-interfaces aren't named services and are only kept alive by the sessions referring to them
+
+        serviceMap.erase(nameIt->second);
+        serviceNameMap.erase(nameIt);
+    }
+
     void ServiceManager::CloseSession(KHandle handle) {
         std::scoped_lock serviceGuard{mutex};
         auto session{state.process->GetHandle<type::KSession>(handle)};
         if (session->isOpen) {
             if (session->isDomain) {
                 for (const auto &domainService : session->domains)
-                    std::erase_if(serviceMap, [domainService](const auto &entry) {
-                        return entry.second == domainService;
-                    });
+                    if (domainService)
+                        ReleaseService(domainService.get());
             } else {
-                std::erase_if(serviceMap, [session](const auto &entry) {
-                    return entry.second == session->serviceObject;
-                });
+                ReleaseService(session->serviceObject.get());
             }
             session->isOpen = false;
         }
     }
 
-    void ServiceManager::SyncRequestHandler(KHandle handle) {
+    Result ServiceManager::SyncRequestHandler(KHandle handle) {
         TRACE_EVENT("kernel", "ServiceManager::SyncRequestHandler");
-        auto session{state.process->GetHandle<type::KSession>(handle)};
-        Logger::Verbose("----IPC Start----");
-        Logger::Verbose("Handle is 0x{:X}", handle);
+        auto session{state.process->TryGetHandle<type::KSession>(handle)};
+        if (!session) [[unlikely]] {
+            Logger::Warn("svcSendSyncRequest called on invalid handle: 0x{:X}", handle);
+            return kernel::result::InvalidHandle;
+        }
+        Logger::Verbose("IPC request on 0x{:X}", handle);
 
         if (session->isOpen) {
             ipc::IpcRequest request(session->isDomain, state);
@@ -212,24 +233,29 @@ namespace skyline::service {
                 case ipc::CommandType::Request:
                 case ipc::CommandType::RequestWithContext:
                     if (session->isDomain) {
-                        try {
-                            auto service{session->domains.at(request.domain->objectId)};
-                            if (service == nullptr)
-                                throw exception("Domain request used an expired handle");
-                            switch (request.domain->command) {
-                                case ipc::DomainCommand::SendMessage:
-                                    response.errorCode = service->HandleRequest(*session, request, response);
-                                    break;
+                        // Object IDs are indices into the domain, a raw pointer is used as the domain may be resized by the request while the object itself remains alive in it
+                        auto objectId{request.domain->objectId};
+                        auto service{objectId < session->domains.size() ? session->domains[objectId].get() : nullptr};
+                        if (!service) [[unlikely]] {
+                            Logger::Warn("Domain request used an invalid or closed object ID: {}", objectId);
+                            response.errorCode = TargetNotFound;
+                            response.WriteResponse(true);
+                            break;
+                        }
+
+                        switch (request.domain->command) {
+                            case ipc::DomainCommand::SendMessage:
+                                response.errorCode = service->HandleRequest(*session, request, response);
+                                break;
 
-                                case ipc::DomainCommand::CloseVHandle:
-                                    std::erase_if(serviceMap, [service](const auto &entry) {
-                                        return entry.second == service;
-                                    });
-                                    session->domains.at(request.domain->objectId).reset();
-                                    break;
+                            case ipc::DomainCommand::CloseVHandle: {
+                                {
+                                    std::scoped_lock serviceGuard{mutex};
+                                    ReleaseService(service);
+                                }
+                                session->CloseDomainObject(objectId); // The service is destroyed here as the domain holds the last reference to it, this is done without the lock held as its destructor may use the manager
+                                break;
                             }
-                        } catch (std::out_of_range &) {
-                            throw exception("Invalid object ID was used with domain request");
                         }
                     } else {
                         response.errorCode = session->serviceObject->HandleRequest(*session, request, response);
@@ -276,7 +302,8 @@ namespace skyline::service {
             }
         } else {
             Logger::Warn("svcSendSyncRequest called on closed handle: 0x{:X}", handle);
+            return kernel::result::SessionClosed;
         }
-        Logger::Verbose("====IPC End====");
+        return {};
     }
 }
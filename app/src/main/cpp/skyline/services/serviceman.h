@@ -5,6 +5,7 @@
 
 #include <kernel/types/KSession.h>
 #include "base_service.h"
+#include "service_worker.h"
 
 namespace skyline::service {
     /**
@@ -19,7 +20,16 @@ namespace skyline::service {
       private:
         const DeviceState &state;
         std::unordered_map<ServiceName, std::shared_ptr<BaseService>> serviceMap; //!< A mapping from a Service to the underlying object
+        std::unordered_map<const BaseService *, ServiceName> serviceNameMap; //!< A reverse mapping of 'serviceMap', this allows releasing a named service in constant time when a handle to it is closed
         std::mutex mutex; //!< Synchronizes concurrent access to services to prevent crashes
+        std::unordered_map<std::string_view, std::unique_ptr<ServiceWorker>> workers; //!< A mapping from the names of workers to their instances, these are kept alive till the manager is destroyed
+        std::mutex workerMutex; //!< Synchronizes access to the workers, this is separate from the service mutex as workers are requested during service construction while it's held
+
+        /**
+         * @brief Removes the supplied service from the named services if it's one of them, so it'll be recreated when it's requested again
+         * @note The service mutex must be locked by the caller
+         */
+        void ReleaseService(const BaseService *service);
 
       public:
         std::shared_ptr<BaseService> smUserInterface; //!< Used by applications to open connections to services
@@ -53,6 +63,13 @@ namespace skyline::service {
          */
         std::shared_ptr<BaseService> CreateOrGetService(ServiceName name);
 
+        /**
+         * @return The worker with the supplied name, it's created if it doesn't already exist
+         * @param name A static string with the name of the worker, services that share state should share a worker
+         * @param threadCount The amount of threads the worker executes requests on if it's created, this must be 1 unless all services using the worker are thread-safe
+         */
+        ServiceWorker &GetServiceWorker(std::string_view name, size_t threadCount = 1);
+
         template<typename Type>
         constexpr std::shared_ptr<Type> CreateOrGetService(std::string_view name) {
             return std::static_pointer_cast<Type>(CreateOrGetService(util::MakeMagic<ServiceName>(name)));
@@ -67,7 +84,8 @@ namespace skyline::service {
         /**
          * @brief Handles a Synchronous IPC Request
          * @param handle The handle of the object
+         * @return The result of the SVC, errors from the service itself are written into the response instead
          */
-        void SyncRequestHandler(KHandle handle);
+        Result SyncRequestHandler(KHandle handle);
     };
 }
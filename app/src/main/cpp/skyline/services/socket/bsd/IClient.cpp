@@ -1,11 +1,371 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2020 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
 #include "IClient.h"
 
 namespace skyline::service::socket {
+    namespace {
+        /**
+         * @brief The guest representation of an IPv4 socket address, this follows the BSD layout which has a length field prior to the family
+         */
+        struct GuestSockAddrIn {
+            u8 length;
+            u8 family;
+            u16 port; //!< The port in network byte order
+            u32 address; //!< The address in network byte order
+            u8 zero[8];
+        };
+        static_assert(sizeof(GuestSockAddrIn) == 0x10);
+
+        /**
+         * @brief The guest representation of a timeval used for SO_RCVTIMEO and SO_SNDTIMEO
+         */
+        struct GuestTimeval {
+            i64 seconds;
+            i64 microseconds;
+        };
+
+        static_assert(sizeof(pollfd) == 8 && offsetof(pollfd, events) == 4 && offsetof(pollfd, revents) == 6); // The guest pollfd layout, it's used directly for translation
+        static_assert(POLLIN == 0x1 && POLLPRI == 0x2 && POLLOUT == 0x4 && POLLERR == 0x8 && POLLHUP == 0x10 && POLLNVAL == 0x20); // The guest poll events, these are shared between BSD and Linux
+
+        constexpr u32 GuestMsgOob{0x1};
+        constexpr u32 GuestMsgPeek{0x2};
+        constexpr u32 GuestMsgDontRoute{0x4};
+        constexpr u32 GuestMsgWaitAll{0x40};
+        constexpr u32 GuestMsgDontWait{0x80};
+
+        constexpr i32 GuestSolSocket{0xFFFF};
+        constexpr i32 GuestONonBlock{0x4};
+        constexpr i32 GuestORdWr{0x2};
+        constexpr size_t GuestFdSetSize{1024}; //!< The amount of FDs in a guest fd_set
+
+        /**
+         * @return The BSD errno corresponding to the supplied host errno
+         */
+        u32 TranslateErrno(int error) {
+            switch (error) {
+                case EAGAIN:
+                    return 35;
+                case EINPROGRESS:
+                    return 36;
+                case EALREADY:
+                    return 37;
+                case ENOTSOCK:
+                    return 38;
+                case EDESTADDRREQ:
+                    return 39;
+                case EMSGSIZE:
+                    return 40;
+                case EPROTOTYPE:
+                    return 41;
+                case ENOPROTOOPT:
+                    return 42;
+                case EPROTONOSUPPORT:
+                    return 43;
+                case EOPNOTSUPP:
+                    return 45;
+                case EAFNOSUPPORT:
+                    return 47;
+                case EADDRINUSE:
+                    return 48;
+                case EADDRNOTAVAIL:
+                    return 49;
+                case ENETDOWN:
+                    return 50;
+                case ENETUNREACH:
+                    return 51;
+                case ECONNABORTED:
+                    return 53;
+                case ECONNRESET:
+                    return 54;
+                case ENOBUFS:
+                    return 55;
+                case EISCONN:
+                    return 56;
+                case ENOTCONN:
+                    return 57;
+                case ETIMEDOUT:
+                    return 60;
+                case ECONNREFUSED:
+                    return 61;
+                case EHOSTUNREACH:
+                    return 65;
+                default:
+                    return static_cast<u32>(error); // All errno values below 35 aside from EAGAIN are shared between BSD and Linux
+            }
+        }
+
+        /**
+         * @brief Writes the return value of a successful call into the response
+         */
+        Result PushReturn(ipc::IpcResponse &response, i32 value) {
+            response.Push<i32>(value);
+            response.Push<u32>(0);
+            return {};
+        }
+
+        /**
+         * @brief Writes the failure of a call with the supplied host errno into the response
+         */
+        Result PushError(ipc::IpcResponse &response, int error) {
+            response.Push<i32>(-1);
+            response.Push<u32>(TranslateErrno(error));
+            return {};
+        }
+
+        /**
+         * @return The buffer at the supplied index or an empty span if the guest didn't supply it, null buffers aren't included in the request
+         */
+        template<typename Buffers>
+        span<u8> GetBuffer(Buffers &buffers, size_t index) {
+            return index < buffers.size() ? buffers[index] : span<u8>{};
+        }
+
+        bool ToHostAddress(span<u8> guest, sockaddr_in &host) {
+            if (guest.size() < offsetof(GuestSockAddrIn, zero))
+                return false;
+
+            auto &address{*reinterpret_cast<GuestSockAddrIn *>(guest.data())};
+            host = sockaddr_in{
+                .sin_family = address.family,
+                .sin_port = address.port,
+                .sin_addr = {.s_addr = address.address},
+            };
+            return true;
+        }
+
+        /**
+         * @return The length of the guest address, the address is truncated if the buffer is too small for it
+         */
+        u32 FromHostAddress(const sockaddr_in &host, span<u8> guest) {
+            GuestSockAddrIn address{
+                .length = sizeof(GuestSockAddrIn),
+                .family = static_cast<u8>(host.sin_family),
+                .port = host.sin_port,
+                .address = host.sin_addr.s_addr,
+            };
+            if (!guest.empty())
+                std::memcpy(guest.data(), &address, std::min(guest.size(), sizeof(GuestSockAddrIn)));
+            return sizeof(GuestSockAddrIn);
+        }
+
+        /**
+         * @return The host level and name of the supplied guest socket option or nullopt if it isn't supported
+         */
+        std::optional<std::pair<int, int>> TranslateSocketOption(i32 level, i32 name) {
+            if (level == GuestSolSocket) {
+                switch (name) {
+                    case 0x1:
+                        return std::pair{SOL_SOCKET, SO_DEBUG};
+                    case 0x2:
+                        return std::pair{SOL_SOCKET, SO_ACCEPTCONN};
+                    case 0x4:
+                        return std::pair{SOL_SOCKET, SO_REUSEADDR};
+                    case 0x8:
+                        return std::pair{SOL_SOCKET, SO_KEEPALIVE};
+                    case 0x10:
+                        return std::pair{SOL_SOCKET, SO_DONTROUTE};
+                    case 0x20:
+                        return std::pair{SOL_SOCKET, SO_BROADCAST};
+                    case 0x80:
+                        return std::pair{SOL_SOCKET, SO_LINGER};
+                    case 0x100:
+                        return std::pair{SOL_SOCKET, SO_OOBINLINE};
+                    case 0x200:
+                        return std::pair{SOL_SOCKET, SO_REUSEPORT};
+                    case 0x1001:
+                        return std::pair{SOL_SOCKET, SO_SNDBUF};
+                    case 0x1002:
+                        return std::pair{SOL_SOCKET, SO_RCVBUF};
+                    case 0x1003:
+                        return std::pair{SOL_SOCKET, SO_SNDLOWAT};
+                    case 0x1004:
+                        return std::pair{SOL_SOCKET, SO_RCVLOWAT};
+                    case 0x1005:
+                        return std::pair{SOL_SOCKET, SO_SNDTIMEO};
+                    case 0x1006:
+                        return std::pair{SOL_SOCKET, SO_RCVTIMEO};
+                    case 0x1007:
+                        return std::pair{SOL_SOCKET, SO_ERROR};
+                    case 0x1008:
+                        return std::pair{SOL_SOCKET, SO_TYPE};
+                    default:
+                        return std::nullopt;
+                }
+            } else if (level == IPPROTO_IP) {
+                switch (name) {
+                    case 0x3:
+                        return std::pair{IPPROTO_IP, IP_TOS};
+                    case 0x4:
+                        return std::pair{IPPROTO_IP, IP_TTL};
+                    case 0x9:
+                        return std::pair{IPPROTO_IP, IP_MULTICAST_IF};
+                    case 0xA:
+                        return std::pair{IPPROTO_IP, IP_MULTICAST_TTL};
+                    case 0xB:
+                        return std::pair{IPPROTO_IP, IP_MULTICAST_LOOP};
+                    case 0xC:
+                        return std::pair{IPPROTO_IP, IP_ADD_MEMBERSHIP};
+                    case 0xD:
+                        return std::pair{IPPROTO_IP, IP_DROP_MEMBERSHIP};
+                    default:
+                        return std::nullopt;
+                }
+            } else if (level == IPPROTO_TCP) {
+                return std::pair{IPPROTO_TCP, name}; // TCP options such as TCP_NODELAY share their values
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * @brief A wrapper around poll that retries on interruption by signals while respecting the timeout
+         * @param timeout The timeout in milliseconds, a negative value waits indefinitely
+         */
+        int PollRetrying(pollfd *fds, nfds_t count, int timeout) {
+            auto deadline{std::chrono::steady_clock::now() + std::chrono::milliseconds{timeout}};
+            while (true) {
+                int result{poll(fds, count, timeout)};
+                if (result != -1 || errno != EINTR)
+                    return result;
+
+                if (timeout > 0)
+                    timeout = static_cast<int>(std::max<i64>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count(), 0));
+            }
+        }
+
+        /**
+         * @brief Waits for the supplied events on a host socket
+         * @param timeout The maximum duration to wait for, zero waits indefinitely
+         * @return 0 if any of the events occurred or a host errno on failure, a timeout yields EAGAIN as it does on BSD
+         */
+        int WaitForSocket(int fd, short events, std::chrono::milliseconds timeout) {
+            pollfd pollFd{.fd = fd, .events = events};
+            int result{PollRetrying(&pollFd, 1, timeout.count() ? static_cast<int>(timeout.count()) : -1)};
+            if (result > 0)
+                return 0; // Any errors or hangups are reported by the operation being retried
+            return result == 0 ? EAGAIN : errno;
+        }
+
+        /**
+         * @brief Calls the supplied function till it doesn't fail with EAGAIN, waiting for the supplied events on the socket in between calls
+         * @param nonBlocking If the call should not wait but return the EAGAIN failure instead
+         */
+        template<typename Function>
+        auto RetryWhileBlocking(int fd, short events, std::chrono::milliseconds timeout, bool nonBlocking, Function &&function) {
+            while (true) {
+                auto result{function()};
+                if (result >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK) || nonBlocking)
+                    return result;
+
+                if (int error{WaitForSocket(fd, events, timeout)}) {
+                    errno = error;
+                    return decltype(result){-1};
+                }
+            }
+        }
+
+        int TranslateMessageFlags(u32 guestFlags) {
+            int flags{MSG_NOSIGNAL | MSG_DONTWAIT}; // The host socket is always non-blocking, blocking is emulated by waiting on it
+            if (guestFlags & GuestMsgOob)
+                flags |= MSG_OOB;
+            if (guestFlags & GuestMsgPeek)
+                flags |= MSG_PEEK;
+            if (guestFlags & GuestMsgDontRoute)
+                flags |= MSG_DONTROUTE;
+            return flags;
+        }
+    }
+
     IClient::IClient(const DeviceState &state, ServiceManager &manager) : BaseService(state, manager) {}
 
+    std::shared_ptr<IClient::BsdSocket> IClient::GetSocket(i32 fd) {
+        std::scoped_lock lock{mutex};
+        if (fd < 0 || static_cast<size_t>(fd) >= sockets.size())
+            return nullptr;
+        return sockets[static_cast<size_t>(fd)];
+    }
+
+    i32 IClient::InsertSocket(std::shared_ptr<BsdSocket> socket) {
+        std::scoped_lock lock{mutex};
+        auto it{std::find(sockets.begin(), sockets.end(), nullptr)};
+        if (it != sockets.end()) {
+            *it = std::move(socket);
+            return static_cast<i32>(std::distance(sockets.begin(), it));
+        }
+
+        sockets.push_back(std::move(socket));
+        return static_cast<i32>(sockets.size() - 1);
+    }
+
+    ssize_t IClient::Receive(BsdSocket &socket, span<u8> buffer, u32 guestFlags, sockaddr_in *address) {
+        int flags{TranslateMessageFlags(guestFlags)};
+        bool nonBlocking{socket.nonBlocking || (guestFlags & GuestMsgDontWait)};
+        bool waitAll{!nonBlocking && (guestFlags & GuestMsgWaitAll) && socket.type == SOCK_STREAM};
+
+        auto receive{[&](span<u8> output) {
+            socklen_t addressLength{sizeof(sockaddr_in)};
+            return RetryWhileBlocking(socket.fd, POLLIN, socket.receiveTimeout, nonBlocking, [&]() {
+                auto result{recvfrom(socket.fd, output.data(), output.size(), flags, reinterpret_cast<sockaddr *>(address), address ? &addressLength : nullptr)};
+                if (result == -1 && errno == EFAULT) {
+                    // The buffer may be in trapped guest memory which the kernel can't write to, so it's received into a temporary buffer and copied with trap handling instead
+                    std::vector<u8> bounce(output.size());
+                    result = recvfrom(socket.fd, bounce.data(), bounce.size(), flags, reinterpret_cast<sockaddr *>(address), address ? &addressLength : nullptr);
+                    if (result > 0)
+                        std::memcpy(output.data(), bounce.data(), static_cast<size_t>(result));
+                }
+                return result;
+            });
+        }};
+
+        if (!waitAll)
+            return receive(buffer);
+
+        size_t received{};
+        while (received < buffer.size()) {
+            auto result{receive(buffer.subspan(received))};
+            if (result < 0)
+                return received ? static_cast<ssize_t>(received) : -1;
+            if (result == 0)
+                break;
+            received += static_cast<size_t>(result);
+        }
+        return static_cast<ssize_t>(received);
+    }
+
+    ssize_t IClient::Send(BsdSocket &socket, span<u8> buffer, u32 guestFlags, const sockaddr_in *address) {
+        int flags{TranslateMessageFlags(guestFlags)};
+        bool nonBlocking{socket.nonBlocking || (guestFlags & GuestMsgDontWait)};
+
+        auto send{[&](span<u8> input) {
+            return RetryWhileBlocking(socket.fd, POLLOUT, socket.sendTimeout, nonBlocking, [&]() {
+                auto result{sendto(socket.fd, input.data(), input.size(), flags, reinterpret_cast<const sockaddr *>(address), address ? sizeof(sockaddr_in) : 0)};
+                if (result == -1 && errno == EFAULT) {
+                    // See Receive for details about why this is required
+                    std::vector<u8> bounce(input.begin(), input.end());
+                    result = sendto(socket.fd, bounce.data(), bounce.size(), flags, reinterpret_cast<const sockaddr *>(address), address ? sizeof(sockaddr_in) : 0);
+                }
+                return result;
+            });
+        }};
+
+        if (nonBlocking || socket.type != SOCK_STREAM)
+            return send(buffer);
+
+        // Blocking sends on stream sockets only return once all data has been sent on BSD while the host may send partially
+        size_t sent{};
+        do {
+            auto result{send(buffer.subspan(sent))};
+            if (result < 0)
+                return sent ? static_cast<ssize_t>(sent) : -1;
+            sent += static_cast<size_t>(result);
+        } while (sent < buffer.size());
+        return static_cast<ssize_t>(sent);
+    }
+
     Result IClient::RegisterClient(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
         response.Push<u32>(0);
         return {};
@@ -15,70 +375,478 @@ namespace skyline::service::socket {
         return {};
     }
 
+    Result IClient::Socket(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto domain{request.Pop<i32>()};
+        auto type{request.Pop<i32>()};
+        auto protocol{request.Pop<i32>()};
+
+        if (domain != AF_INET)
+            return PushError(response, EAFNOSUPPORT); // The guest only supports IPv4 sockets
+
+        int fd{socket(domain, type | SOCK_NONBLOCK | SOCK_CLOEXEC, protocol)};
+        if (fd == -1)
+            return PushError(response, errno);
+
+        auto guestFd{InsertSocket(std::make_shared<BsdSocket>(BsdSocket{.fd = fd, .type = type}))};
+        Logger::Debug("Created socket {} (Type: {}, Protocol: {})", guestFd, type, protocol);
+        return PushReturn(response, guestFd);
+    }
+
+    Result IClient::SocketExempt(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        return Socket(session, request, response);
+    }
+
     Result IClient::Select(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto count{std::min(static_cast<size_t>(request.Pop<u32>()), GuestFdSetSize)};
+        request.Skip<u32>();
+        auto timeout{request.Pop<GuestTimeval>()};
+        bool infinite{request.Pop<u8>() != 0};
+
+        // The read, write and exception sets are supplied in order, null sets aren't included in the request and are treated as empty
+        std::array<span<u8>, 3> inputSets{GetBuffer(request.inputBuf, 0), GetBuffer(request.inputBuf, 1), GetBuffer(request.inputBuf, 2)};
+        std::array<span<u8>, 3> outputSets{GetBuffer(request.outputBuf, 0), GetBuffer(request.outputBuf, 1), GetBuffer(request.outputBuf, 2)};
+        constexpr std::array<short, 3> SetEvents{POLLIN, POLLOUT, POLLPRI};
+
+        auto isSet{[](span<u8> set, size_t fd) {
+            return (fd / 8) < set.size() && (set[fd / 8] & (1 << (fd % 8)));
+        }};
+
+        std::vector<pollfd> pollFds;
+        std::vector<i32> guestFds;
+        std::vector<std::shared_ptr<BsdSocket>> polledSockets; // The sockets are kept alive while they're being polled
+        for (size_t fd{}; fd < count; fd++) {
+            short events{};
+            for (size_t set{}; set < inputSets.size(); set++)
+                if (isSet(inputSets[set], fd))
+                    events |= SetEvents[set];
+            if (!events)
+                continue;
+
+            auto socket{GetSocket(static_cast<i32>(fd))};
+            if (!socket)
+                return PushError(response, EBADF);
+
+            pollFds.push_back(pollfd{.fd = socket->fd, .events = events});
+            guestFds.push_back(static_cast<i32>(fd));
+            polledSockets.push_back(std::move(socket));
+        }
+
+        int timeoutMs{infinite ? -1 : static_cast<int>(timeout.seconds * 1000 + timeout.microseconds / 1000)};
+        int result{PollRetrying(pollFds.data(), pollFds.size(), timeoutMs)};
+        if (result == -1)
+            return PushError(response, errno);
+
+        for (auto &set : outputSets)
+            std::fill(set.begin(), set.end(), 0);
+
+        i32 readyCount{};
+        for (size_t index{}; index < pollFds.size(); index++) {
+            auto fd{static_cast<size_t>(guestFds[index])};
+            auto revents{pollFds[index].revents};
+            for (size_t set{}; set < outputSets.size(); set++) {
+                // Errors and hangups make sockets readable and writable as the subsequent operation will return them
+                if ((pollFds[index].events & SetEvents[set]) && (revents & (SetEvents[set] | (set < 2 ? POLLERR | POLLHUP : 0))) && (fd / 8) < outputSets[set].size()) {
+                    outputSets[set][fd / 8] |= static_cast<u8>(1 << (fd % 8));
+                    readyCount++;
+                }
+            }
+        }
+
+        return PushReturn(response, readyCount);
     }
 
     Result IClient::Poll(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto count{request.Pop<u32>()};
+        auto timeout{request.Pop<i32>()};
+
+        auto input{GetBuffer(request.inputBuf, 0).cast<pollfd, std::dynamic_extent, true>()};
+        auto output{GetBuffer(request.outputBuf, 0).cast<pollfd, std::dynamic_extent, true>()};
+        if (input.size() < count || output.size() < count)
+            return PushError(response, EINVAL);
+
+        std::vector<pollfd> pollFds(count);
+        std::vector<std::shared_ptr<BsdSocket>> polledSockets(count); // The sockets are kept alive while they're being polled
+        for (size_t index{}; index < count; index++) {
+            pollFds[index] = input[index];
+            if (input[index].fd < 0)
+                continue; // Negative FDs are ignored by poll on both the guest and the host
+
+            polledSockets[index] = GetSocket(input[index].fd);
+            pollFds[index].fd = polledSockets[index] ? static_cast<int>(polledSockets[index]->fd) : -1;
+        }
+
+        int result{PollRetrying(pollFds.data(), count, timeout)};
+        if (result == -1)
+            return PushError(response, errno);
+
+        i32 readyCount{};
+        for (size_t index{}; index < count; index++) {
+            output[index] = input[index];
+            output[index].revents = (input[index].fd >= 0 && !polledSockets[index]) ? POLLNVAL : pollFds[index].revents;
+            if (output[index].revents)
+                readyCount++;
+        }
+
+        return PushReturn(response, readyCount);
     }
 
     Result IClient::Recv(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto fd{request.Pop<i32>()};
+        auto flags{request.Pop<u32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        auto result{Receive(*socket, GetBuffer(request.outputBuf, 0), flags, nullptr)};
+        return result < 0 ? PushError(response, errno) : PushReturn(response, static_cast<i32>(result));
     }
 
     Result IClient::RecvFrom(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto flags{request.Pop<u32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket) {
+            PushError(response, EBADF);
+            response.Push<u32>(0);
+            return {};
+        }
+
+        sockaddr_in address{};
+        auto result{Receive(*socket, GetBuffer(request.outputBuf, 0), flags, &address)};
+        if (result < 0) {
+            PushError(response, errno);
+            response.Push<u32>(0);
+            return {};
+        }
+
+        auto addressBuffer{GetBuffer(request.outputBuf, 1)};
+        PushReturn(response, static_cast<i32>(result));
+        response.Push<u32>((addressBuffer.empty() || socket->type == SOCK_STREAM) ? 0 : FromHostAddress(address, addressBuffer));
         return {};
     }
 
     Result IClient::Send(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto fd{request.Pop<i32>()};
+        auto flags{request.Pop<u32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        auto result{Send(*socket, GetBuffer(request.inputBuf, 0), flags, nullptr)};
+        return result < 0 ? PushError(response, errno) : PushReturn(response, static_cast<i32>(result));
     }
 
     Result IClient::SendTo(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        response.Push<u32>(0);
-        return {};
+        auto fd{request.Pop<i32>()};
+        auto flags{request.Pop<u32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        sockaddr_in address{};
+        bool hasAddress{ToHostAddress(GetBuffer(request.inputBuf, 1), address)};
+        auto result{Send(*socket, GetBuffer(request.inputBuf, 0), flags, hasAddress ? &address : nullptr)};
+        return result < 0 ? PushError(response, errno) : PushReturn(response, static_cast<i32>(result));
     }
 
     Result IClient::Accept(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket) {
+            PushError(response, EBADF);
+            response.Push<u32>(0);
+            return {};
+        }
+
+        sockaddr_in address{};
+        socklen_t addressLength{sizeof(sockaddr_in)};
+        int result{RetryWhileBlocking(socket->fd, POLLIN, socket->receiveTimeout, socket->nonBlocking, [&]() {
+            return accept4(socket->fd, reinterpret_cast<sockaddr *>(&address), &addressLength, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        })};
+        if (result == -1) {
+            PushError(response, errno);
+            response.Push<u32>(0);
+            return {};
+        }
+
+        // Accepted sockets inherit the non-blocking state and timeouts of the listening socket on BSD
+        auto guestFd{InsertSocket(std::make_shared<BsdSocket>(BsdSocket{
+            .fd = result,
+            .type = socket->type,
+            .nonBlocking = socket->nonBlocking,
+            .receiveTimeout = socket->receiveTimeout,
+            .sendTimeout = socket->sendTimeout,
+        }))};
+
+        auto addressBuffer{GetBuffer(request.outputBuf, 0)};
+        PushReturn(response, guestFd);
+        response.Push<u32>(addressBuffer.empty() ? 0 : FromHostAddress(address, addressBuffer));
         return {};
     }
 
     Result IClient::Bind(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto fd{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        sockaddr_in address{};
+        if (!ToHostAddress(GetBuffer(request.inputBuf, 0), address))
+            return PushError(response, EINVAL);
+
+        if (bind(socket->fd, reinterpret_cast<sockaddr *>(&address), sizeof(sockaddr_in)) == -1)
+            return PushError(response, errno);
+        return PushReturn(response, 0);
     }
 
     Result IClient::Connect(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        sockaddr_in address{};
+        if (!ToHostAddress(GetBuffer(request.inputBuf, 0), address))
+            return PushError(response, EINVAL);
+
+        if (connect(socket->fd, reinterpret_cast<sockaddr *>(&address), sizeof(sockaddr_in)) == 0)
+            return PushReturn(response, 0);
+        if (errno != EINPROGRESS || socket->nonBlocking)
+            return PushError(response, errno);
+
+        // The host socket is non-blocking so the connection is always established asynchronously, a blocking connect waits for it to complete
+        if (int error{WaitForSocket(socket->fd, POLLOUT, socket->sendTimeout)})
+            return PushError(response, error == EAGAIN ? ETIMEDOUT : error);
+
+        int error{};
+        socklen_t errorLength{sizeof(error)};
+        if (getsockopt(socket->fd, SOL_SOCKET, SO_ERROR, &error, &errorLength) == -1)
+            return PushError(response, errno);
+        return error ? PushError(response, error) : PushReturn(response, 0);
+    }
+
+    Result IClient::GetPeerName(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        sockaddr_in address{};
+        socklen_t addressLength{sizeof(sockaddr_in)};
+        if (!socket || getpeername(socket->fd, reinterpret_cast<sockaddr *>(&address), &addressLength) == -1) {
+            PushError(response, socket ? errno : EBADF);
+            response.Push<u32>(0);
+            return {};
+        }
+
+        PushReturn(response, 0);
+        response.Push<u32>(FromHostAddress(address, GetBuffer(request.outputBuf, 0)));
         return {};
     }
 
-    Result IClient::Listen(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+    Result IClient::GetSockName(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        sockaddr_in address{};
+        socklen_t addressLength{sizeof(sockaddr_in)};
+        if (!socket || getsockname(socket->fd, reinterpret_cast<sockaddr *>(&address), &addressLength) == -1) {
+            PushError(response, socket ? errno : EBADF);
+            response.Push<u32>(0);
+            return {};
+        }
+
+        PushReturn(response, 0);
+        response.Push<u32>(FromHostAddress(address, GetBuffer(request.outputBuf, 0)));
         return {};
     }
 
-    Result IClient::SetSockOpt(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+    Result IClient::GetSockOpt(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto level{request.Pop<i32>()};
+        auto name{request.Pop<i32>()};
+        auto output{GetBuffer(request.outputBuf, 0)};
+
+        auto fail{[&](int error) {
+            PushError(response, error);
+            response.Push<u32>(0);
+            return Result{};
+        }};
+
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return fail(EBADF);
+
+        auto option{TranslateSocketOption(level, name)};
+        if (!option) {
+            Logger::Warn("Unsupported socket option: Level: 0x{:X}, Name: 0x{:X}", level, name);
+            return fail(ENOPROTOOPT);
+        }
+
+        auto [hostLevel, hostName]{*option};
+        if (hostLevel == SOL_SOCKET && (hostName == SO_RCVTIMEO || hostName == SO_SNDTIMEO)) {
+            // Timeouts are emulated as the host socket is non-blocking
+            auto timeout{hostName == SO_RCVTIMEO ? socket->receiveTimeout : socket->sendTimeout};
+            if (output.size() < sizeof(GuestTimeval))
+                return fail(EINVAL);
+            output.as<GuestTimeval>() = GuestTimeval{timeout.count() / 1000, (timeout.count() % 1000) * 1000};
+            PushReturn(response, 0);
+            response.Push<u32>(sizeof(GuestTimeval));
+            return {};
+        }
+
+        socklen_t length{static_cast<socklen_t>(output.size())};
+        if (getsockopt(socket->fd, hostLevel, hostName, output.data(), &length) == -1)
+            return fail(errno);
+
+        if (hostLevel == SOL_SOCKET && hostName == SO_ERROR && length >= sizeof(i32))
+            output.as<i32>() = static_cast<i32>(TranslateErrno(output.as<i32>()));
+
+        PushReturn(response, 0);
+        response.Push<u32>(length);
         return {};
     }
 
+    Result IClient::Listen(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto backlog{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        if (listen(socket->fd, backlog) == -1)
+            return PushError(response, errno);
+        return PushReturn(response, 0);
+    }
+
+    Result IClient::Fcntl(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto command{request.Pop<i32>()};
+        auto argument{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        switch (command) {
+            case F_GETFL:
+                return PushReturn(response, GuestORdWr | (socket->nonBlocking ? GuestONonBlock : 0));
+
+            case F_SETFL:
+                socket->nonBlocking = argument & GuestONonBlock;
+                return PushReturn(response, 0);
+
+            default:
+                Logger::Warn("Unsupported fcntl command: {}", command);
+                return PushError(response, EINVAL);
+        }
+    }
+
+    Result IClient::SetSockOpt(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto level{request.Pop<i32>()};
+        auto name{request.Pop<i32>()};
+        auto input{GetBuffer(request.inputBuf, 0)};
+
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        auto option{TranslateSocketOption(level, name)};
+        if (!option) {
+            Logger::Warn("Unsupported socket option: Level: 0x{:X}, Name: 0x{:X}", level, name);
+            return PushError(response, ENOPROTOOPT);
+        }
+
+        auto [hostLevel, hostName]{*option};
+        if (hostLevel == SOL_SOCKET && (hostName == SO_RCVTIMEO || hostName == SO_SNDTIMEO)) {
+            if (input.size() < sizeof(GuestTimeval))
+                return PushError(response, EINVAL);
+
+            auto &timeval{input.as<GuestTimeval>()};
+            std::chrono::milliseconds timeout{timeval.seconds * 1000 + timeval.microseconds / 1000};
+            if (timeout.count() == 0 && timeval.microseconds)
+                timeout = std::chrono::milliseconds{1}; // A sub-millisecond timeout shouldn't wait indefinitely
+            (hostName == SO_RCVTIMEO ? socket->receiveTimeout : socket->sendTimeout) = timeout;
+            return PushReturn(response, 0);
+        }
+
+        if (setsockopt(socket->fd, hostLevel, hostName, input.data(), static_cast<socklen_t>(input.size())) == -1)
+            return PushError(response, errno);
+        return PushReturn(response, 0);
+    }
+
     Result IClient::Shutdown(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto fd{request.Pop<i32>()};
+        auto how{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        if (shutdown(socket->fd, how) == -1)
+            return PushError(response, errno);
+        return PushReturn(response, 0);
     }
 
     Result IClient::ShutdownAllSockets(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto how{request.Pop<i32>()};
+        std::scoped_lock lock{mutex};
+        for (const auto &socket : sockets)
+            if (socket)
+                shutdown(socket->fd, how); // Any threads waiting on the sockets are woken up by this
+        return PushReturn(response, 0);
     }
 
     Result IClient::Write(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto fd{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        auto result{Send(*socket, GetBuffer(request.inputBuf, 0), 0, nullptr)};
+        return result < 0 ? PushError(response, errno) : PushReturn(response, static_cast<i32>(result));
     }
 
     Result IClient::Read(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        response.Push<u32>(0);
-        response.Push<u32>(0);
-        return {};
+        auto fd{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        auto result{Receive(*socket, GetBuffer(request.outputBuf, 0), 0, nullptr)};
+        return result < 0 ? PushError(response, errno) : PushReturn(response, static_cast<i32>(result));
     }
 
     Result IClient::Close(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
-        return {};
+        auto fd{request.Pop<i32>()};
+        std::shared_ptr<BsdSocket> socket;
+        {
+            std::scoped_lock lock{mutex};
+            if (fd >= 0 && static_cast<size_t>(fd) < sockets.size())
+                socket = std::move(sockets[static_cast<size_t>(fd)]);
+        }
+        if (!socket)
+            return PushError(response, EBADF);
+
+        // The host socket is only closed once the last reference to it is dropped, any threads still waiting on it need to be woken up for that to happen
+        if (socket.use_count() > 1)
+            shutdown(socket->fd, SHUT_RDWR);
+
+        Logger::Debug("Closed socket {}", fd);
+        return PushReturn(response, 0);
+    }
+
+    Result IClient::DuplicateSocket(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response) {
+        auto fd{request.Pop<i32>()};
+        auto socket{GetSocket(fd)};
+        if (!socket)
+            return PushError(response, EBADF);
+
+        int duplicate{fcntl(socket->fd, F_DUPFD_CLOEXEC, 0)};
+        if (duplicate == -1)
+            return PushError(response, errno);
+
+        return PushReturn(response, InsertSocket(std::make_shared<BsdSocket>(BsdSocket{
+            .fd = duplicate,
+            .type = socket->type,
+            .nonBlocking = socket->nonBlocking,
+            .receiveTimeout = socket->receiveTimeout,
+            .sendTimeout = socket->sendTimeout,
+        })));
     }
 }
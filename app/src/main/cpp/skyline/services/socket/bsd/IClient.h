@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <netinet/in.h>
+#include <common/file_descriptor.h>
 #include <services/serviceman.h>
 
 namespace skyline::service::socket {
@@ -11,6 +13,46 @@ namespace skyline::service::socket {
      * @url https://switchbrew.org/wiki/Sockets_services#bsd:u.2C_bsd:s
      */
     class IClient : public BaseService {
+      private:
+        /**
+         * @brief A guest socket backed by a non-blocking host socket, blocking guest calls wait for readiness of the host socket on the calling thread
+         * @note The calling guest thread is removed from its core for the duration of any IPC request, so waiting doesn't occupy a guest core
+         */
+        struct BsdSocket {
+            FileDescriptor fd;
+            int type; //!< The host socket type (SOCK_STREAM, SOCK_DGRAM or SOCK_RAW)
+            bool nonBlocking{}; //!< If the guest has put the socket into non-blocking mode, calls fail with EAGAIN rather than waiting if so
+            std::chrono::milliseconds receiveTimeout{}; //!< The SO_RCVTIMEO of the socket, zero means waiting indefinitely
+            std::chrono::milliseconds sendTimeout{}; //!< The SO_SNDTIMEO of the socket, zero means waiting indefinitely
+        };
+
+        std::mutex mutex; //!< Synchronizes access to the socket table, it isn't held while waiting on sockets
+        std::vector<std::shared_ptr<BsdSocket>> sockets; //!< A table of sockets indexed by their guest FD, closed FDs leave a null entry behind which is reused
+
+        /**
+         * @return The socket with the supplied guest FD or nullptr if there's none
+         */
+        std::shared_ptr<BsdSocket> GetSocket(i32 fd);
+
+        /**
+         * @return The lowest free guest FD, which the supplied socket has been inserted at
+         */
+        i32 InsertSocket(std::shared_ptr<BsdSocket> socket);
+
+        /**
+         * @brief Receives data from a socket while respecting guest blocking semantics
+         * @param address An optional output for the address of the sender
+         * @return The amount of bytes received or -1 with errno set on failure
+         */
+        ssize_t Receive(BsdSocket &socket, span<u8> buffer, u32 guestFlags, sockaddr_in *address);
+
+        /**
+         * @brief Sends data on a socket while respecting guest blocking semantics, blocking stream sockets send all of the data unless an error occurs
+         * @param address An optional address to send the data to
+         * @return The amount of bytes sent or -1 with errno set on failure
+         */
+        ssize_t Send(BsdSocket &socket, span<u8> buffer, u32 guestFlags, const sockaddr_in *address);
+
       public:
         IClient(const DeviceState &state, ServiceManager &manager);
 
@@ -26,12 +68,26 @@ namespace skyline::service::socket {
         Result StartMonitoring(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
 
         /**
-         * @brief Selects the socket
+         * @brief Creates a socket
+         * @url https://switchbrew.org/wiki/Sockets_services#Socket
+         */
+        Result Socket(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+
+        /**
+         * @brief Creates a socket which is exempt from the network connection check, this is equivalent to Socket for us
+         * @url https://switchbrew.org/wiki/Sockets_services#SocketExempt
+         */
+        Result SocketExempt(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+
+        /**
+         * @brief Waits for any sockets in the supplied sets to become ready, this is translated into a host poll
+         * @url https://switchbrew.org/wiki/Sockets_services#Select
          */
         Result Select(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
 
         /**
-         * @brief Polls the socket for events
+         * @brief Polls the socket for events, the guest and host pollfd structures and event bits are identical so only the FDs are translated
+         * @url https://switchbrew.org/wiki/Sockets_services#Poll
          */
         Result Poll(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
 
@@ -70,11 +126,31 @@ namespace skyline::service::socket {
          */
         Result Connect(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
 
+        /**
+         * @brief Retrieves the address of the peer a socket is connected to
+         */
+        Result GetPeerName(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+
+        /**
+         * @brief Retrieves the local address of a socket
+         */
+        Result GetSockName(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+
+        /**
+         * @brief Retrieves the value of an option associated with a socket
+         */
+        Result GetSockOpt(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+
         /**
          * @brief Places a socket in a state in which it is listening for an incoming connection
          */
         Result Listen(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
 
+        /**
+         * @brief Manipulates the file status flags of a socket, only O_NONBLOCK is supported
+         */
+        Result Fcntl(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+
         /**
          * @brief Manipulates the options associated with a socket
          */
@@ -105,9 +181,16 @@ namespace skyline::service::socket {
          */
         Result Close(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
 
+        /**
+         * @brief Duplicates a socket into a new FD which refers to the same host socket
+         */
+        Result DuplicateSocket(type::KSession &session, ipc::IpcRequest &request, ipc::IpcResponse &response);
+
         SERVICE_DECL(
             SFUNC(0x0, IClient, RegisterClient),
             SFUNC(0x1, IClient, StartMonitoring),
+            SFUNC(0x2, IClient, Socket),
+            SFUNC(0x3, IClient, SocketExempt),
             SFUNC(0x5, IClient, Select),
             SFUNC(0x6, IClient, Poll),
             SFUNC(0x8, IClient, Recv),
@@ -117,13 +200,18 @@ namespace skyline::service::socket {
             SFUNC(0xC, IClient, Accept),
             SFUNC(0xD, IClient, Bind),
             SFUNC(0xE, IClient, Connect),
+            SFUNC(0xF, IClient, GetPeerName),
+            SFUNC(0x10, IClient, GetSockName),
+            SFUNC(0x11, IClient, GetSockOpt),
             SFUNC(0x12, IClient, Listen),
+            SFUNC(0x14, IClient, Fcntl),
             SFUNC(0x15, IClient, SetSockOpt),
             SFUNC(0x16, IClient, Shutdown),
             SFUNC(0x17, IClient, ShutdownAllSockets),
             SFUNC(0x18, IClient, Write),
             SFUNC(0x19, IClient, Read),
-            SFUNC(0x1A, IClient, Close)
+            SFUNC(0x1A, IClient, Close),
+            SFUNC(0x1B, IClient, DuplicateSocket)
         )
     };
 }
@@ -204,17 +204,23 @@ namespace skyline::service::timesrv::core {
     }
 
     ResultValue<SystemClockContext> StandardUserSystemClockCore::GetClockContext() {
-        if (automaticCorrectionEnabled && networkSystemClock.IsClockSetup()) {
-            auto ctx{networkSystemClock.GetClockContext()};
-            if (!ctx)
-                return ctx;
+        auto localContext{localSystemClock.GetClockContext()};
+        if (!automaticCorrectionEnabled || !localContext)
+            return localContext;
 
-            auto result{localSystemClock.SetClockContext(*ctx)};
-            if (result)
-                return result;
-        }
+        auto networkContext{networkSystemClock.GetClockContext()};
+        if (!networkContext)
+            return networkContext;
+
+        // This is called for every user clock query, the local clock only needs to be resynced (and the network clock checked for being set up) when the contexts have diverged since the last query
+        if (*localContext == *networkContext || !networkSystemClock.IsClockSetup())
+            return localContext;
+
+        auto result{localSystemClock.SetClockContext(*networkContext)};
+        if (result)
+            return result;
 
-        return localSystemClock.GetClockContext();
+        return networkContext;
     }
 
     TimeServiceObject::TimeServiceObject(const DeviceState &state)
@@ -6,6 +6,7 @@
 #include "soc/smmu.h"
 #include "soc/host1x.h"
 #include "soc/gm20b/gpfifo.h"
+#include "soc/gm20b/gpfifo_capture.h"
 
 namespace skyline::soc {
     /**
@@ -16,7 +17,9 @@ namespace skyline::soc {
       public:
         SMMU smmu;
         host1x::Host1x host1x;
+        std::atomic<u32> pendingGpEntryCount{}; //!< The amount of GpEntries pushed to all channels which haven't been executed yet
+        std::unique_ptr<gm20b::GpfifoCapture> gpfifoCapture; //!< The capture that the GPFIFO streams of all channels are written to, this is null unless capturing is enabled
 
-        SOC(const DeviceState &state) : host1x(state) {}
+        SOC(const DeviceState &state) : host1x(state), gpfifoCapture(gm20b::GpfifoCapture::Create(state)) {}
     };
 }
@@ -1,12 +1,14 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <common/settings.h>
 #include "channel.h"
 
 namespace skyline::soc::gm20b {
     ChannelContext::ChannelContext(const DeviceState &state, std::shared_ptr<AddressSpaceContext> pAsCtx, size_t numEntries)
         : asCtx{std::move(pAsCtx)},
           executor{state},
+          macroState{*state.settings->logUnhandledMacros},
           maxwell3D{state, *this, macroState},
           fermi2D{state, *this, macroState},
           maxwellDma{state, *this},
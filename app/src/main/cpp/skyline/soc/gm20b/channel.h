@@ -30,8 +30,9 @@ namespace skyline::soc::gm20b {
         engine::KeplerCompute keplerCompute;
         engine::Inline2Memory inline2Memory;
         ChannelGpfifo gpfifo;
-        std::mutex &globalChannelLock;
+        AdaptiveMutex &globalChannelLock;
         size_t channelSequenceNumber{};
+        gpu::interconnect::Inline2Memory *pendingInline2Memory{}; //!< The I2M interconnect with a batch of uploads pending, this must be flushed prior to any non-I2M method
 
         ChannelContext(const DeviceState &state, std::shared_ptr<AddressSpaceContext> asCtx, size_t numEntries);
 
@@ -18,7 +18,14 @@ namespace skyline::soc::gm20b::engine {
 
     MacroEngineBase::MacroEngineBase(MacroState &macroState) : macroState(macroState) {}
 
-    void MacroEngineBase::HandleMacroCall(u32 macroMethodOffset, u32 argument, bool lastCall) {
+    span<u8> MacroEngineBase::GetMacroArgumentSource(size_t index, size_t count) {
+        if (!macroInvocation.argumentsSource || index < macroInvocation.argumentsSourceStart || index + count > macroInvocation.arguments.size())
+            return {};
+
+        return span<u32>{macroInvocation.argumentsSource + (index - macroInvocation.argumentsSourceStart), count}.cast<u8>();
+    }
+
+    void MacroEngineBase::HandleMacroCall(u32 macroMethodOffset, u32 argument, bool lastCall, u32 *argumentSource) {
         // Starting a new macro at index 'macroMethodOffset / 2'
         if (!(macroMethodOffset & 1)) {
             // Flush the current macro as we are switching to another one
@@ -31,6 +38,14 @@ namespace skyline::soc::gm20b::engine {
             macroInvocation.index = (macroMethodOffset / 2) % macroState.macroPositions.size();
         }
 
+        // Only the trailing run of contiguous arguments is tracked, this covers parameters that are entirely sourced from a separate pushbuffer segment such as those of indirect draws
+        if (!argumentSource) {
+            macroInvocation.argumentsSource = nullptr;
+        } else if (!macroInvocation.argumentsSource || macroInvocation.argumentsSource + (macroInvocation.arguments.size() - macroInvocation.argumentsSourceStart) != argumentSource) {
+            macroInvocation.argumentsSource = argumentSource;
+            macroInvocation.argumentsSourceStart = macroInvocation.arguments.size();
+        }
+
         macroInvocation.arguments.emplace_back(argument);
 
         // Flush macro after all of the data in the method call has been sent
@@ -81,6 +81,8 @@ namespace skyline::soc::gm20b::engine {
         struct {
             u32 index{std::numeric_limits<u32>::max()};
             std::vector<u32> arguments;
+            u32 *argumentsSource{}; //!< The guest memory that the arguments from `argumentsSourceStart` onwards were contiguously read from, this is nullptr if the last argument wasn't read from guest memory
+            size_t argumentsSourceStart{}; //!< The index of the first argument in the trailing run of arguments that were contiguously read from guest memory
 
             bool Valid() {
                 return index != std::numeric_limits<u32>::max();
@@ -89,6 +91,8 @@ namespace skyline::soc::gm20b::engine {
             void Reset() {
                 index = std::numeric_limits<u32>::max();
                 arguments.clear();
+                argumentsSource = nullptr;
+                argumentsSourceStart = 0;
             }
         } macroInvocation{}; //!< Data for a macro that is pending execution
 
@@ -114,10 +118,27 @@ namespace skyline::soc::gm20b::engine {
             throw exception("DrawIndexedInstanced is not implemented for this engine");
         }
 
+        /**
+         * @brief Performs draws with parameters that the GPU reads from guest memory, this avoids stalling on GPU writes to the parameters that are yet to execute
+         * @param indirectBuffer The guest memory holding the draw parameters in the layout of VkDrawIndirectCommand or VkDrawIndexedIndirectCommand
+         * @param countBuffer The guest memory holding the amount of draws to perform, this is capped to `drawCount`, if this is empty then `drawCount` draws are always performed
+         * @param vertexArrayCount The vertex or index count of the first draw as seen by the CPU, this is only used as an estimate for sizing vertex and index buffers
+         * @return If the draws were performed, otherwise they must be performed directly with the parameters as seen by the CPU
+         */
+        virtual bool DrawIndirect(u32 drawTopology, bool indexed, span<u8> indirectBuffer, u32 drawCount, u32 stride, span<u8> countBuffer, u32 vertexArrayCount, u32 vertexArrayStart) {
+            return false;
+        }
+
+        /**
+         * @return The guest memory that the supplied arguments of the pending macro were read from, this is empty if they weren't all contiguously read from guest memory
+         */
+        span<u8> GetMacroArgumentSource(size_t index, size_t count);
+
         /**
          * @brief Handles a call to a method in the MME space
          * @param macroMethodOffset The target offset from EngineMethodsEnd
+         * @param argumentSource The guest memory that the argument was read from, this is nullptr for immediate arguments
          */
-        void HandleMacroCall(u32 macroMethodOffset, u32 value, bool lastCall);
+        void HandleMacroCall(u32 macroMethodOffset, u32 value, bool lastCall, u32 *argumentSource = nullptr);
     };
 }
@@ -62,12 +62,14 @@ namespace skyline::soc::gm20b::engine::fermi2d::type {
 
         MemoryLayout memoryLayout;
 
-        struct {
+        struct BlockSize {
             u8 widthLog2 : 4;
             u8 heightLog2 : 4;
             u8 depthLog2 : 4;
             u32 _pad_ : 20;
 
+            bool operator==(const BlockSize &) const = default;
+
             u8 Width() const {
                 return static_cast<u8>(1 << widthLog2);
             }
@@ -87,6 +89,8 @@ namespace skyline::soc::gm20b::engine::fermi2d::type {
         u32 width;
         u32 height;
         Address address;
+
+        bool operator==(const Surface &) const = default;
     };
 
     enum class SampleModeOrigin : u8 {
@@ -119,6 +119,9 @@ namespace skyline::soc::gm20b::engine {
         };
         static_assert(sizeof(RegisterState) == (0xE * 0x4));
 
+        static constexpr u32 RegisterOffset{0x60}; //!< The method offset of the I2M registers in every engine which contains the I2M block
+        static constexpr u32 RegisterCount{sizeof(RegisterState) / sizeof(u32)};
+
       private:
         /**
          * @brief Ran after all the inline data has been pushed and handles writing that data into memory
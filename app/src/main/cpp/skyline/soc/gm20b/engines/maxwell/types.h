@@ -834,6 +834,25 @@ namespace skyline::soc::gm20b::engine::maxwell3d::type {
     };
     static_assert(sizeof(SemaphoreInfo) == sizeof(u32));
 
+    /**
+     * @brief The counters that can be reset with the ClearReportValue method
+     */
+    enum class ClearReportValue : u32 {
+        ZPassPixelCount = 0x01, //!< The amount of samples that passed depth and stencil testing, this is reported with the SamplesPassed counter
+    };
+
+    /**
+     * @brief The condition under which draws and clears are performed
+     * @note The conditional modes use a pair of four word semaphore reports at the render enable address
+     */
+    enum class RenderEnableMode : u32 {
+        False = 0,
+        True = 1,
+        Conditional = 2, //!< Renders if the payload of the first report is non-zero
+        IfEqual = 3, //!< Renders if the payloads of both reports are equal
+        IfNotEqual = 4, //!< Renders if the payloads of both reports differ
+    };
+
     constexpr static size_t ShaderStageCount{5}; //!< Amount of pipeline stages on Maxwell 3D
 
     /**
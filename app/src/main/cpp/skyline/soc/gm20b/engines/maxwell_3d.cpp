@@ -52,7 +52,8 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             .constantBufferSelectorRegisters = {*registers.constantBufferSelector},
             .samplerPoolRegisters = {*registers.texSamplerPool, *registers.texHeaderPool},
             .samplerBinding = *registers.samplerBinding,
-            .texturePoolRegisters = {*registers.texHeaderPool}
+            .texturePoolRegisters = {*registers.texHeaderPool},
+            .queriesRegisters = {*registers.sampleCounterEnable}
         };
     }
     #undef REGTYPE
@@ -81,6 +82,35 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
         }
     }
 
+    template<typename IndexType>
+    void Maxwell3D::AppendInlineIndices(span<u32> arguments) {
+        constexpr size_t IndicesPerArgument{sizeof(u32) / sizeof(IndexType)};
+        for (u32 argument : arguments) {
+            for (size_t index{}; index < IndicesPerArgument; index++) {
+                if (inlineIndexSkip) {
+                    inlineIndexSkip--;
+                    continue;
+                }
+
+                if (!inlineIndexRemaining)
+                    return;
+
+                inlineIndices.push_back(static_cast<IndexType>(argument >> (index * sizeof(IndexType) * 8)));
+                inlineIndexRemaining--;
+            }
+        }
+    }
+
+    void Maxwell3D::FlushInlineIndexDraw() {
+        if (inlineIndices.empty())
+            return;
+
+        // Every begin/end pair of an instanced inline draw supplies the indices again, so each is drawn as a single instance of its own
+        interconnect.Draw(ApplyTopologyOverride(registers.begin->op), *registers.streamOutputEnable, true, static_cast<u32>(inlineIndices.size()), 0, 1,
+                          *registers.globalBaseVertexIndex, *registers.globalBaseInstanceIndex + deferredDraw.instanceCount - 1, inlineIndices);
+        inlineIndices.clear();
+    }
+
     __attribute__((always_inline)) void Maxwell3D::HandleMethod(u32 method, u32 argument) {
         if (method == ENGINE_STRUCT_OFFSET(mme, shadowRamControl)) [[unlikely]] {
             shadowRegisters.raw[method] = registers.raw[method] = argument;
@@ -234,6 +264,12 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
                     deferredDraw.instanceCount++;
                 else
                     deferredDraw.instanceCount = 1;
+
+                inlineIndices.clear();
+            })
+
+            ENGINE_CASE(end, {
+                FlushInlineIndexDraw();
             })
 
             ENGINE_STRUCT_CASE(drawVertexArray, count, {
@@ -263,12 +299,26 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
                 batchEnableState.drawActive = true;
             })
 
+            ENGINE_CASE(inlineIndex4X8Align, {
+                inlineIndexSkip = inlineIndex4X8Align.start;
+                inlineIndexRemaining = inlineIndex4X8Align.count;
+            })
+
             ENGINE_STRUCT_CASE(drawInlineIndex4X8, index0, {
-                throw exception("drawInlineIndex4X8 not implemented!");
+                AppendInlineIndices<u8>(span<u32>{argument});
+            })
+
+            ENGINE_CASE(inlineIndex2X16Align, {
+                inlineIndexSkip = inlineIndex2X16Align.startOdd ? 1 : 0;
+                inlineIndexRemaining = inlineIndex2X16Align.count;
             })
 
             ENGINE_STRUCT_CASE(drawInlineIndex2X16, even, {
-                throw exception("drawInlineIndex2X16 not implemented!");
+                AppendInlineIndices<u16>(span<u32>{argument});
+            })
+
+            ENGINE_CASE(drawInlineIndex, {
+                inlineIndices.push_back(drawInlineIndex);
             })
 
             ENGINE_STRUCT_CASE(drawIndexBuffer, count, {
@@ -340,19 +390,26 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
 
                 switch (info.op) {
                     case type::SemaphoreInfo::Op::Release:
-                        channelCtx.executor.Submit([=, this, semaphore = *registers.semaphore]() {
-                            WriteSemaphoreResult(semaphore, semaphore.payload);
-                        });
+                        // Writing the payload on the GPU avoids submitting and waiting on the execution, the CPU will only wait if the guest accesses the semaphore
+                        if (!WriteSemaphoreResultGpu(*registers.semaphore, registers.semaphore->payload))
+                            channelCtx.executor.Submit([=, this, semaphore = *registers.semaphore]() {
+                                WriteSemaphoreResult(semaphore, semaphore.payload);
+                            });
                         break;
 
                     case type::SemaphoreInfo::Op::Counter: {
                         switch (info.counterType) {
                             case type::SemaphoreInfo::CounterType::Zero:
-                                WriteSemaphoreResult(*registers.semaphore, registers.semaphore->payload);
+                                if (!WriteSemaphoreResultGpu(*registers.semaphore, registers.semaphore->payload))
+                                    WriteSemaphoreResult(*registers.semaphore, registers.semaphore->payload);
                                 break;
                             case type::SemaphoreInfo::CounterType::SamplesPassed:
-                                // Return a fake result for now
-                                WriteSemaphoreResult(*registers.semaphore, 0xffffff);
+                                if (interconnect.ReportSamplesPassed(u64{registers.semaphore->address}, info.structureSize == type::SemaphoreInfo::StructureSize::FourWords, GetGpuTimeTicks()))
+                                    break;
+
+                                // Return a fake result if the report can't be written on the GPU
+                                if (!WriteSemaphoreResultGpu(*registers.semaphore, 0xffffff))
+                                    WriteSemaphoreResult(*registers.semaphore, 0xffffff);
                                 break;
 
                             default:
@@ -368,6 +425,17 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
                 }
             })
 
+            ENGINE_CASE(clearReportValue, {
+                if (clearReportValue == type::ClearReportValue::ZPassPixelCount)
+                    interconnect.ResetSamplesPassed();
+                else
+                    Logger::Debug("Unsupported report value clear: 0x{:X}", static_cast<u32>(clearReportValue));
+            })
+
+            ENGINE_STRUCT_CASE(renderEnable, mode, {
+                interconnect.SetRenderEnable(u64{registers.renderEnable->address}, mode);
+            })
+
             ENGINE_ARRAY_CASE(firmwareCall, 4, {
                 registers.raw[0xD00] = 1;
             })
@@ -416,6 +484,23 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
         }
     }
 
+    bool Maxwell3D::WriteSemaphoreResultGpu(const Registers::Semaphore &semaphore, u64 result) {
+        switch (semaphore.info.structureSize) {
+            case type::SemaphoreInfo::StructureSize::OneWord: {
+                u32 payload{static_cast<u32>(result)};
+                return interconnect.WriteSemaphore(u64{semaphore.address}, span<u32>{payload}.cast<u8>());
+            }
+
+            case type::SemaphoreInfo::StructureSize::FourWords: {
+                // The timestamp is sampled when the report is recorded rather than when the GPU reaches it, Vulkan timestamps can't be converted to GPU ticks without a readback
+                std::array<u64, 2> report{result, GetGpuTimeTicks()};
+                return interconnect.WriteSemaphore(u64{semaphore.address}, span{report}.cast<u8>());
+            }
+        }
+
+        return false;
+    }
+
     void Maxwell3D::FlushEngineState() {
         FlushDeferredDraw();
 
@@ -435,10 +520,33 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
     }
 
     void Maxwell3D::CallMethodBatchNonInc(u32 method, span<u32> arguments) {
+        if (arguments.empty())
+            return;
+
         switch (method) {
             case ENGINE_STRUCT_OFFSET(i2m, loadInlineData):
                 i2m.LoadInlineData(*registers.i2m, arguments);
                 return;
+
+            // Inline indices are streamed in bulk, only the first argument goes through HandleMethod to flush any batched state
+            case ENGINE_OFFSET(drawInlineIndex):
+                HandleMethod(method, arguments.front());
+                inlineIndices.insert(inlineIndices.end(), std::next(arguments.begin()), arguments.end());
+                registers.raw[method] = arguments.back();
+                return;
+
+            case ENGINE_STRUCT_OFFSET(drawInlineIndex4X8, index0):
+                HandleMethod(method, arguments.front());
+                AppendInlineIndices<u8>(arguments.subspan(1));
+                registers.raw[method] = arguments.back();
+                return;
+
+            case ENGINE_STRUCT_OFFSET(drawInlineIndex2X16, even):
+                HandleMethod(method, arguments.front());
+                AppendInlineIndices<u16>(arguments.subspan(1));
+                registers.raw[method] = arguments.back();
+                return;
+
             default:
                 break;
         }
@@ -447,6 +555,80 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             HandleMethod(method, argument);
     }
 
+    void Maxwell3D::CallMethodBatchInc(u32 method, span<u32> arguments) {
+        // Methods which have any effect in HandleMethod beyond writing to the register and marking it dirty, this must be kept in sync with HandleMethod
+        constexpr static auto SideEffectMethods{[] {
+            std::array<bool, EngineMethodsEnd> methods{};
+            for (u32 offset : {
+                ENGINE_STRUCT_OFFSET(mme, shadowRamControl),
+                ENGINE_STRUCT_OFFSET(mme, instructionRamLoad),
+                ENGINE_STRUCT_OFFSET(mme, startAddressRamLoad),
+                ENGINE_STRUCT_OFFSET(i2m, launchDma),
+                ENGINE_STRUCT_OFFSET(i2m, loadInlineData),
+                ENGINE_OFFSET(syncpointAction),
+                ENGINE_OFFSET(clearSurface),
+                ENGINE_OFFSET(begin),
+                ENGINE_OFFSET(end),
+                ENGINE_STRUCT_OFFSET(drawVertexArray, count),
+                ENGINE_OFFSET(drawVertexArrayBeginEndInstanceFirst),
+                ENGINE_OFFSET(drawVertexArrayBeginEndInstanceSubsequent),
+                ENGINE_OFFSET(inlineIndex4X8Align),
+                ENGINE_STRUCT_OFFSET(drawInlineIndex4X8, index0),
+                ENGINE_OFFSET(inlineIndex2X16Align),
+                ENGINE_STRUCT_OFFSET(drawInlineIndex2X16, even),
+                ENGINE_OFFSET(drawInlineIndex),
+                ENGINE_STRUCT_OFFSET(drawIndexBuffer, count),
+                ENGINE_OFFSET(drawIndexBuffer32BeginEndInstanceFirst),
+                ENGINE_OFFSET(drawIndexBuffer16BeginEndInstanceFirst),
+                ENGINE_OFFSET(drawIndexBuffer8BeginEndInstanceFirst),
+                ENGINE_OFFSET(drawIndexBuffer32BeginEndInstanceSubsequent),
+                ENGINE_OFFSET(drawIndexBuffer16BeginEndInstanceSubsequent),
+                ENGINE_OFFSET(drawIndexBuffer8BeginEndInstanceSubsequent),
+                ENGINE_STRUCT_OFFSET(semaphore, info),
+                ENGINE_OFFSET(clearReportValue),
+                ENGINE_STRUCT_OFFSET(renderEnable, mode),
+                ENGINE_ARRAY_OFFSET(firmwareCall, 4),
+            })
+                methods[offset] = true;
+
+            for (u32 index{}; index < 16; index++)
+                methods[ENGINE_STRUCT_ARRAY_OFFSET(loadConstantBuffer, data, index)] = true;
+
+            for (u32 index{}; index < type::ShaderStageCount; index++)
+                methods[ENGINE_ARRAY_STRUCT_OFFSET(bindGroups, index, constantBuffer)] = true;
+
+            return methods;
+        }()};
+
+        auto shadowRamControl{shadowRegisters.mme->shadowRamControl};
+        if (shadowRamControl == type::MmeShadowRamControl::MethodReplay || std::any_of(SideEffectMethods.begin() + method, SideEffectMethods.begin() + method + arguments.size(), [](bool sideEffect) { return sideEffect; })) [[unlikely]] {
+            for (u32 argument : arguments)
+                HandleMethod(method++, argument);
+            return;
+        }
+
+        // Plain register writes terminate any batched state in the same way as they would in HandleMethod
+        if (batchEnableState.drawActive)
+            FlushDeferredDraw();
+
+        if (batchEnableState.constantBufferActive) {
+            interconnect.DisableQuickConstantBufferBind();
+            interconnect.LoadConstantBuffer(batchLoadConstantBuffer.buffer, batchLoadConstantBuffer.startOffset);
+            batchEnableState.constantBufferActive = false;
+            batchLoadConstantBuffer.Reset();
+        }
+
+        if (shadowRamControl == type::MmeShadowRamControl::MethodTrack || shadowRamControl == type::MmeShadowRamControl::MethodTrackWithFilter)
+            span(shadowRegisters.raw).subspan(method, arguments.size()).copy_from(arguments);
+
+        auto target{span(registers.raw).subspan(method, arguments.size())};
+        for (size_t i{}; i < arguments.size(); i++)
+            if (target[i] != arguments[i])
+                dirtyManager.MarkDirty(method + i);
+
+        target.copy_from(arguments);
+    }
+
     void Maxwell3D::CallMethodFromMacro(u32 method, u32 argument) {
         HandleMethod(method, argument);
     }
@@ -479,4 +661,13 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
 
         interconnect.Draw(topology, *registers.streamOutputEnable, true, indexBufferCount, indexBufferFirst, instanceCount, globalBaseVertexIndex, globalBaseInstanceIndex);
     }
+
+    bool Maxwell3D::DrawIndirect(u32 drawTopology, bool indexed, span<u8> indirectBuffer, u32 drawCount, u32 stride, span<u8> countBuffer, u32 vertexArrayCount, u32 vertexArrayStart) {
+        auto topology{static_cast<type::DrawTopology>(drawTopology)};
+        if (!interconnect.DrawIndirect(topology, *registers.streamOutputEnable, indexed, indirectBuffer, drawCount, stride, countBuffer, vertexArrayCount, vertexArrayStart))
+            return false;
+
+        registers.begin->op = topology;
+        return true;
+    }
 }
@@ -69,10 +69,25 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             }
         } deferredDraw{};
 
+        std::vector<u32> inlineIndices; //!< The indices supplied inline in the pushbuffer since the last begin method, they're drawn with at the end method
+        u32 inlineIndexSkip{}; //!< The amount of packed indices at the start of the next inline index method which are skipped, this is set by the alignment methods
+        u32 inlineIndexRemaining{}; //!< The amount of packed indices which are still expected from inline index methods, any further packed indices are padding
+
         type::DrawTopology ApplyTopologyOverride(type::DrawTopology beginMethodTopology);
 
         void FlushDeferredDraw();
 
+        /**
+         * @brief Unpacks the indices packed into the arguments of an inline index method and appends them to `inlineIndices`
+         */
+        template<typename IndexType>
+        void AppendInlineIndices(span<u32> arguments);
+
+        /**
+         * @brief Draws with the indices accumulated in `inlineIndices` if there are any
+         */
+        void FlushInlineIndexDraw();
+
         /**
          * @brief Calls the appropriate function corresponding to a certain method with the supplied argument
          */
@@ -219,6 +234,7 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
                 u8 index3;
             };
 
+            Register<0x4C0, InlineIndexAlign> inlineIndex4X8Align;
             Register<0x4C1, DrawInlineIndex> drawInlineIndex4X8;
 
             Register<0x4C3, type::CompareFunc> depthFunc;
@@ -255,11 +271,18 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
             Register<0x547, u32> zCullStatCountersEnable;
             Register<0x548, u32> pointSpriteEnable;
             Register<0x54A, u32> shaderExceptions;
+            Register<0x54C, type::ClearReportValue> clearReportValue; //!< Method-only register that resets the specified counter to zero
             Register<0x54D, u32> multisampleEnable;
             Register<0x54E, type::ZtSelect> ztSelect;
 
             Register<0x54F, type::MultisampleControl> multisampleControl;
 
+            struct RenderEnable {
+                Address address; // 0x554
+                type::RenderEnableMode mode; // 0x556
+            };
+            Register<0x554, RenderEnable> renderEnable;
+
             Register<0x557, TexSamplerPool> texSamplerPool;
 
             Register<0x55B, float> slopeScaleDepthBias;
@@ -422,6 +445,12 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
          */
         void WriteSemaphoreResult(const Registers::Semaphore &semaphore, u64 result);
 
+        /**
+         * @brief Records writing back a semaphore result to the guest on the GPU after all prior work, in the same format as WriteSemaphoreResult
+         * @return If the write could be recorded on the GPU, if not WriteSemaphoreResult must be used instead
+         */
+        bool WriteSemaphoreResultGpu(const Registers::Semaphore &semaphore, u64 result);
+
       public:
         Registers registers{};
         Registers shadowRegisters{}; //!< A shadow-copy of the registers, their function is controlled by the 'shadowRamControl' register
@@ -444,6 +473,11 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
 
         void CallMethodBatchNonInc(u32 method, span<u32> arguments);
 
+        /**
+         * @brief Calls a run of consecutive methods starting at the supplied method, runs that only contain plain register writes are applied to the register file in bulk
+         */
+        void CallMethodBatchInc(u32 method, span<u32> arguments);
+
         void CallMethodFromMacro(u32 method, u32 argument) override;
 
         u32 ReadMethodFromMacro(u32 method) override;
@@ -451,5 +485,7 @@ namespace skyline::soc::gm20b::engine::maxwell3d {
         void DrawInstanced(bool setRegs, u32 drawTopology, u32 vertexArrayCount, u32 instanceCount, u32 vertexArrayStart, u32 globalBaseInstanceIndex) override;
 
         void DrawIndexedInstanced(bool setRegs, u32 drawTopology, u32 indexBufferCount, u32 instanceCount, u32 globalBaseVertexIndex, u32 indexBufferFirst, u32 globalBaseInstanceIndex) override;
+
+        bool DrawIndirect(u32 drawTopology, bool indexed, span<u8> indirectBuffer, u32 drawCount, u32 stride, span<u8> countBuffer, u32 vertexArrayCount, u32 vertexArrayStart) override;
     };
 }
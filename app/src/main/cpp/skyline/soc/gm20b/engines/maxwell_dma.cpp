@@ -39,7 +39,6 @@ namespace skyline::soc::gm20b::engine {
         }
 
         if (registers.launchDma->multiLineEnable) {
-            channelCtx.executor.Submit();
             if (registers.launchDma->srcMemoryLayout == Registers::LaunchDma::MemoryLayout::Pitch &&
                 registers.launchDma->dstMemoryLayout == Registers::LaunchDma::MemoryLayout::BlockLinear)
                 CopyPitchToBlockLinear();
@@ -131,6 +130,11 @@ namespace skyline::soc::gm20b::engine {
 
         Logger::Debug("{}x{}@0x{:X} -> {}x{}@0x{:X}", srcDimensions.width, srcDimensions.height, u64{*registers.offsetIn}, dstDimensions.width, dstDimensions.height, dstLayerAddress);
 
+        if (interconnect.CopySwizzled(dstMappings.front(), srcMappings.front(), dstDimensions, bytesPerPixel, dstBlockHeight, dstBlockDepth, false))
+            return;
+
+        // The copy has to be performed on the CPU, any prior GPU work needs to complete before the guest memory can be accessed
+        channelCtx.executor.Submit();
         gpu::texture::CopyLinearToBlockLinear(
             dstDimensions,
             1, 1, bytesPerPixel,
@@ -186,6 +190,11 @@ namespace skyline::soc::gm20b::engine {
 
         Logger::Debug("{}x{}@0x{:X} -> {}x{}@0x{:X}", srcDimensions.width, srcDimensions.height, u64{*registers.offsetIn}, dstDimensions.width, dstDimensions.height, u64{*registers.offsetOut});
 
+        if (interconnect.CopySwizzled(srcMappings.front(), dstMappings.front(), srcDimensions, bytesPerPixel, srcBlockHeight, srcBlockDepth, true))
+            return;
+
+        // The copy has to be performed on the CPU, any prior GPU work needs to complete before the guest memory can be accessed
+        channelCtx.executor.Submit();
         gpu::texture::CopyBlockLinearToLinear(
             srcDimensions,
             1, 1, bytesPerPixel,
@@ -4,6 +4,8 @@
 #include <gpu.h>
 #include <common/signal.h>
 #include <common/settings.h>
+#include <common/frame_statistics.h>
+#include <common/performance_hint.h>
 #include <loader/loader.h>
 #include <kernel/types/KProcess.h>
 #include <soc.h>
@@ -78,6 +80,29 @@ namespace skyline::soc::gm20b {
             u32 end{static_cast<u32>(methodAddress + size)};
             return end < engine::EngineMethodsEnd && methodAddress >= engine::GPFIFO::RegisterCount;
         }
+
+        /**
+         * @brief Checks if a method only touches the I2M registers of an engine which contains the I2M block
+         */
+        bool Inline2MemoryOnly() const {
+            if (methodSubChannel != SubchannelId::ThreeD && methodSubChannel != SubchannelId::Compute && methodSubChannel != SubchannelId::Inline2Mem)
+                return false;
+
+            u32 last{[&]() -> u32 {
+                switch (secOp) {
+                    case SecOp::NonIncMethod:
+                    case SecOp::ImmdDataMethod:
+                        return methodAddress;
+                    case SecOp::OneInc:
+                        return methodAddress + (methodCount > 1 ? 1 : 0);
+                    default:
+                        return methodAddress + (methodCount ? methodCount - 1 : 0);
+                }
+            }()};
+
+            using Inline2MemoryBackend = engine::Inline2MemoryBackend;
+            return methodAddress >= Inline2MemoryBackend::RegisterOffset && last < Inline2MemoryBackend::RegisterOffset + Inline2MemoryBackend::RegisterCount;
+        }
     };
     static_assert(sizeof(PushBufferMethodHeader) == sizeof(u32));
 
@@ -86,9 +111,12 @@ namespace skyline::soc::gm20b {
         gpfifoEngine(state.soc->host1x.syncpoints, channelCtx),
         channelCtx(channelCtx),
         gpEntries(numEntries),
+        prefetchedEntries(PrefetchQueueSize),
+        captureChannelId(state.soc->gpfifoCapture ? state.soc->gpfifoCapture->RegisterChannel() : 0),
+        prefetchThread(std::thread(&ChannelGpfifo::RunPrefetch, this)),
         thread(std::thread(&ChannelGpfifo::Run, this)) {}
 
-    void ChannelGpfifo::SendFull(u32 method, u32 argument, SubchannelId subChannel, bool lastCall) {
+    void ChannelGpfifo::SendFull(u32 method, u32 argument, SubchannelId subChannel, bool lastCall, u32 *argumentSource) {
         if (method < engine::GPFIFO::RegisterCount) {
             gpfifoEngine.CallMethod(method, argument);
         } else if (method < engine::EngineMethodsEnd) { [[likely]]
@@ -96,10 +124,10 @@ namespace skyline::soc::gm20b {
         } else {
             switch (subChannel) {
                 case SubchannelId::ThreeD:
-                    channelCtx.maxwell3D.HandleMacroCall(method - engine::EngineMethodsEnd, argument, lastCall);
+                    channelCtx.maxwell3D.HandleMacroCall(method - engine::EngineMethodsEnd, argument, lastCall, argumentSource);
                     break;
                 case SubchannelId::TwoD:
-                    channelCtx.fermi2D.HandleMacroCall(method - engine::EngineMethodsEnd, argument, lastCall);
+                    channelCtx.fermi2D.HandleMacroCall(method - engine::EngineMethodsEnd, argument, lastCall, argumentSource);
                     break;
                 default:
                     Logger::Warn("Called method 0x{:X} out of bounds for engine 0x{:X}, args: 0x{:X}", method, subChannel, argument);
@@ -155,11 +183,47 @@ namespace skyline::soc::gm20b {
         }
     }
 
-    void ChannelGpfifo::Process(GpEntry gpEntry) {
+    void ChannelGpfifo::SendPureBatchInc(u32 method, span<u32> arguments, SubchannelId subChannel) {
+        if (subChannel == SubchannelId::ThreeD) [[likely]] {
+            channelCtx.maxwell3D.CallMethodBatchInc(method, arguments);
+            return;
+        }
+
+        for (u32 argument : arguments)
+            SendPure(method++, argument, subChannel);
+    }
+
+    void ChannelGpfifo::CaptureEntry(const PrefetchedGpEntry &entry) {
+        const auto &gpEntry{entry.gpEntry};
+        if (!gpEntry.size) {
+            state.soc->gpfifoCapture->WriteEntry(captureChannelId, gpEntry, {});
+            return;
+        }
+
+        boost::container::small_vector<span<u32>, PrefetchedGpEntry::MaxMappings> pushBuffer;
+        if (entry.mappingCount) {
+            pushBuffer.assign(entry.mappings.begin(), entry.mappings.begin() + entry.mappingCount);
+        } else {
+            for (auto mapping : channelCtx.asCtx->gmmu.TranslateRange(gpEntry.Address(), gpEntry.size * sizeof(u32))) {
+                if (!mapping.valid()) [[unlikely]]
+                    return; // This is reported when the entry is executed
+                pushBuffer.push_back(mapping.cast<u32>());
+            }
+        }
+
+        state.soc->gpfifoCapture->WriteEntry(captureChannelId, gpEntry, pushBuffer);
+    }
+
+    void ChannelGpfifo::Process(const PrefetchedGpEntry &entry) {
+        const auto &gpEntry{entry.gpEntry};
+        if (state.soc->gpfifoCapture) [[unlikely]]
+            CaptureEntry(entry);
+
         // Submit if required by the GpEntry, this is needed as some games dynamically generate pushbuffer contents
         if (gpEntry.sync == GpEntry::Sync::Wait)
-            channelCtx.executor.Submit({}, *state.settings->useDirectMemoryImport);
+            channelCtx.executor.Submit({}, state.gpu->buffer.directMemoryImport);
 
+        FrameStatistics::ScopedPhase phase{FrameStatistics::Phase::GpfifoDecode};
         if (!gpEntry.size) {
             // This is a GPFIFO control entry, all control entries have a zero length and contain no pushbuffers
             switch (gpEntry.opcode) {
@@ -171,38 +235,77 @@ namespace skyline::soc::gm20b {
             }
         }
 
-        auto pushBufferMappedRanges{channelCtx.asCtx->gmmu.TranslateRange(gpEntry.Address(), gpEntry.size * sizeof(u32))};
-        auto pushBuffer{[&]() -> span<u32> {
-            if (pushBufferMappedRanges.size() == 1) {
-                return pushBufferMappedRanges.front().cast<u32>();
-            } else {
-                // Create an intermediate copy of pushbuffer data if it's split across multiple mappings
-                pushBufferData.resize(gpEntry.size);
-                channelCtx.asCtx->gmmu.Read<u32>(pushBufferData, gpEntry.Address());
-                return span(pushBufferData);
-            }
-        }()};
+        // Process the pushbuffer in-place within each of the mappings it spans, methods which cross the boundary between mappings are resumed in the same way as those split across GpEntries
+        if (entry.mappingCount) [[likely]] {
+            for (auto mapping : span(entry.mappings).first(entry.mappingCount))
+                if (ProcessPushBufferMapping(mapping))
+                    break;
+
+            return;
+        }
+
+        for (auto mapping : channelCtx.asCtx->gmmu.TranslateRange(gpEntry.Address(), gpEntry.size * sizeof(u32))) {
+            if (!mapping.valid()) [[unlikely]]
+                throw exception("Pushbuffer at 0x{:X} is not fully mapped", gpEntry.Address());
+
+            if (ProcessPushBufferMapping(mapping.cast<u32>()))
+                break;
+        }
+    }
+
+    ChannelGpfifo::PrefetchedGpEntry ChannelGpfifo::Prefetch(GpEntry gpEntry) {
+        PrefetchedGpEntry entry{.gpEntry = gpEntry};
+        if (!gpEntry.size)
+            return entry; // Control entries have no pushbuffer to resolve
+
+        auto mappings{channelCtx.asCtx->gmmu.TranslateRange(gpEntry.Address(), gpEntry.size * sizeof(u32))};
+        if (mappings.size() > PrefetchedGpEntry::MaxMappings) [[unlikely]]
+            return entry;
+
+        for (auto mapping : mappings) {
+            // Unmapped pushbuffers are left for execution to translate again and report
+            if (!mapping.valid()) [[unlikely]]
+                return entry;
 
+            // Start pulling in the method headers at the start of each mapping while the preceding entry is executing
+            __builtin_prefetch(mapping.data());
+            entry.mappings[entry.mappingCount++] = mapping.cast<u32>();
+        }
+
+        return entry;
+    }
+
+    bool ChannelGpfifo::ProcessPushBufferMapping(span<u32> pushBuffer) {
         // There will be at least one entry here
         auto entry{pushBuffer.begin()};
+        bool endPbSegment{}; // If the remainder of the GpEntry should be skipped, this differentiates EndPbSegment from reaching the end of the mapping
 
         // Executes the current split method, returning once execution is finished or the current GpEntry has reached its end
         auto resumeSplitMethod{[&](){
             switch (resumeState.state) {
                 case MethodResumeState::State::Inc:
-                    while (entry != pushBuffer.end() && resumeState.remaining)
-                        SendFull(resumeState.address++, *(entry++), resumeState.subChannel, --resumeState.remaining == 0);
+                    while (entry != pushBuffer.end() && resumeState.remaining) {
+                        SendFull(resumeState.address++, *entry, resumeState.subChannel, --resumeState.remaining == 0, &*entry);
+                        entry++;
+                    }
 
                     break;
                 case MethodResumeState::State::OneInc:
-                    SendFull(resumeState.address++, *(entry++), resumeState.subChannel, --resumeState.remaining == 0);
+                    // The method header may have been the final entry in the mapping, in which case there's nothing to send yet
+                    if (entry == pushBuffer.end())
+                        break;
+
+                    SendFull(resumeState.address++, *entry, resumeState.subChannel, --resumeState.remaining == 0, &*entry);
+                    entry++;
 
                     // After the first increment OneInc methods work the same as a NonInc method, this is needed so they can resume correctly if they are broken up by multiple GpEntries
                     resumeState.state = MethodResumeState::State::NonInc;
                     [[fallthrough]];
                 case MethodResumeState::State::NonInc:
-                    while (entry != pushBuffer.end() && resumeState.remaining)
-                        SendFull(resumeState.address, *(entry++), resumeState.subChannel, --resumeState.remaining == 0);
+                    while (entry != pushBuffer.end() && resumeState.remaining) {
+                        SendFull(resumeState.address, *entry, resumeState.subChannel, --resumeState.remaining == 0, &*entry);
+                        entry++;
+                    }
 
                     break;
             }
@@ -220,7 +323,7 @@ namespace skyline::soc::gm20b {
             // Entries containing all zeroes is a NOP, skip over them
             for (; *entry == 0; entry++)
                 if (entry == std::prev(pushBuffer.end()))
-                    return;
+                    return false;
 
             PushBufferMethodHeader methodHeader{.raw = *entry};
 
@@ -263,7 +366,15 @@ namespace skyline::soc::gm20b {
 
                 if (remainingEntries >= methodHeader.methodCount) { [[likely]]
                     if (methodHeader.Pure()) [[likely]] {
-                        if constexpr (State == MethodResumeState::State::NonInc) {
+                        if constexpr (State == MethodResumeState::State::Inc) {
+                            // For pure inc methods the engine can apply runs of plain register writes in bulk
+                            if (methodHeader.methodCount > BatchCutoff) {
+                                SendPureBatchInc(methodHeader.methodAddress, span(&(*++entry), methodHeader.methodCount), methodHeader.methodSubChannel);
+
+                                entry += methodHeader.methodCount - 1;
+                                return false;
+                            }
+                        } else if constexpr (State == MethodResumeState::State::NonInc) {
                             // For pure noninc methods we can send all method calls as a span in one go
                             if (methodHeader.methodCount > BatchCutoff) [[unlikely]] {
                                 SendPureBatchNonInc(methodHeader.methodAddress, span(&(*++entry), methodHeader.methodCount), methodHeader.methodSubChannel);
@@ -287,8 +398,10 @@ namespace skyline::soc::gm20b {
                             SendPure(methodHeader.methodAddress + methodOffset(i), *++entry, methodHeader.methodSubChannel);
                     } else {
                         // Slow path for methods that touch GPFIFO or macros
-                        for (u32 i{}; i < methodHeader.methodCount; i++)
-                            SendFull(methodHeader.methodAddress + methodOffset(i), *++entry, methodHeader.methodSubChannel, i == methodHeader.methodCount - 1);
+                        for (u32 i{}; i < methodHeader.methodCount; i++) {
+                            entry++;
+                            SendFull(methodHeader.methodAddress + methodOffset(i), *entry, methodHeader.methodSubChannel, i == methodHeader.methodCount - 1, &*entry);
+                        }
                     }
                 } else {
                     startSplitMethod(State);
@@ -317,6 +430,7 @@ namespace skyline::soc::gm20b {
                 } else if (methodHeader.secOp == PushBufferMethodHeader::SecOp::NonIncMethod) [[unlikely]] {
                     return dispatchCalls.operator()<MethodResumeState::State::NonInc>();
                 } else if (methodHeader.secOp == PushBufferMethodHeader::SecOp::EndPbSegment) [[unlikely]] {
+                    endPbSegment = true;
                     return true;
                 } else if (methodHeader.secOp == PushBufferMethodHeader::SecOp::Grp0UseTert) {
                     if (methodHeader.tertOp == PushBufferMethodHeader::TertOp::Grp0SetSubDevMask)
@@ -331,42 +445,31 @@ namespace skyline::soc::gm20b {
             bool hitEnd{[&]() {
                 if (methodHeader.methodSubChannel != SubchannelId::ThreeD) [[unlikely]]
                     channelCtx.maxwell3D.FlushEngineState(); // Flush the 3D engine state when doing any calls to other engines
+                if (channelCtx.pendingInline2Memory && !methodHeader.Inline2MemoryOnly()) [[unlikely]]
+                    channelCtx.pendingInline2Memory->FlushBatch(); // Flush any batched I2M uploads prior to methods that could depend on them
                 return processMethod();
             }()};
 
             if (hitEnd)
                 break;
         }
+
+        return endPbSegment;
     }
 
-    void ChannelGpfifo::Run() {
-        if (int result{pthread_setname_np(pthread_self(), "GPFIFO")})
+    template<typename Function>
+    void ChannelGpfifo::RunThread(const char *name, Function &&function) {
+        if (int result{pthread_setname_np(pthread_self(), name)})
             Logger::Warn("Failed to set the thread name: {}", strerror(result));
 
+        host::Topology::Get().SetThreadAffinity(*state.settings->gpfifoAffinity);
+        host::PerformanceHint::ScopedThread performanceHintThread;
+
         try {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE}, signal::ExceptionalSignalHandler);
             signal::SetSignalHandler({SIGSEGV}, nce::NCE::HostSignalHandler); // We may access NCE trapped memory
 
-            bool channelLocked{};
-
-            gpEntries.Process([this, &channelLocked](GpEntry gpEntry) {
-                Logger::Debug("Processing pushbuffer: 0x{:X}, Size: 0x{:X}", gpEntry.Address(), +gpEntry.size);
-
-                if (!channelLocked) {
-                    channelCtx.Lock();
-                    channelLocked = true;
-                }
-
-                Process(gpEntry);
-            }, [this, &channelLocked]() {
-                // If we run out of GpEntries to process ensure we submit any remaining GPU work before waiting for more to arrive
-                Logger::Debug("Finished processing pushbuffer batch");
-                if (channelLocked) {
-                    channelCtx.executor.Submit();
-                    channelCtx.Unlock();
-                    channelLocked = false;
-                }
-            });
+            function();
         } catch (const signal::SignalException &e) {
             if (e.signal != SIGINT) {
                 Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
@@ -387,18 +490,67 @@ namespace skyline::soc::gm20b {
         }
     }
 
-    void ChannelGpfifo::Push(span<GpEntry> entries) {
+    void ChannelGpfifo::RunPrefetch() {
+        RunThread("GPFIFO Prefetch", [this]() {
+            gpEntries.Process([this](GpEntry gpEntry) {
+                prefetchedEntries.Push(Prefetch(gpEntry));
+            }, [] {});
+        });
+    }
+
+    void ChannelGpfifo::Run() {
+        RunThread("GPFIFO", [this]() {
+            bool channelLocked{};
+
+            prefetchedEntries.Process([this, &channelLocked](const PrefetchedGpEntry &entry) {
+                Logger::Debug("Processing pushbuffer: 0x{:X}, Size: 0x{:X}", entry.gpEntry.Address(), +entry.gpEntry.size);
+
+                if (!channelLocked) {
+                    channelCtx.Lock();
+                    channelLocked = true;
+                }
+
+                Process(entry);
+
+                pendingEntryCount.fetch_sub(1, std::memory_order_relaxed);
+                state.soc->pendingGpEntryCount.fetch_sub(1, std::memory_order_relaxed);
+            }, [this, &channelLocked]() {
+                // Entries are only removed from the guest queue after being pushed to the prefetched queue, if any are left then more work is imminent and submitting would split the batch
+                if (!gpEntries.Empty())
+                    return;
+
+                // If we run out of GpEntries to process ensure we submit any remaining GPU work before waiting for more to arrive
+                Logger::Debug("Finished processing pushbuffer batch");
+                if (channelLocked) {
+                    channelCtx.executor.Submit();
+                    channelCtx.Unlock();
+                    channelLocked = false;
+                }
+            });
+        });
+    }
+
+    void ChannelGpfifo::Push(span<const GpEntry> entries) {
+        pendingEntryCount.fetch_add(static_cast<u32>(entries.size()), std::memory_order_relaxed);
+        state.soc->pendingGpEntryCount.fetch_add(static_cast<u32>(entries.size()), std::memory_order_relaxed);
         gpEntries.Append(entries);
     }
 
     void ChannelGpfifo::Push(GpEntry entry) {
+        pendingEntryCount.fetch_add(1, std::memory_order_relaxed);
+        state.soc->pendingGpEntryCount.fetch_add(1, std::memory_order_relaxed);
         gpEntries.Push(entry);
     }
 
     ChannelGpfifo::~ChannelGpfifo() {
-        if (thread.joinable()) {
-            pthread_kill(thread.native_handle(), SIGINT);
-            thread.join();
+        for (auto *stageThread : {&prefetchThread, &thread}) {
+            if (stageThread->joinable()) {
+                pthread_kill(stageThread->native_handle(), SIGINT);
+                stageThread->join();
+            }
         }
+
+        // Any entries that were never executed are dropped with the channel
+        state.soc->pendingGpEntryCount.fetch_sub(pendingEntryCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
     }
 }
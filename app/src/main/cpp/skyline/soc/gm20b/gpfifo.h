@@ -96,7 +96,7 @@ namespace skyline::soc::gm20b {
 
     /**
      * @brief The ChannelGpfifo class handles creating pushbuffers from GP entries and then processing them for a single channel
-     * @note A single ChannelGpfifo thread exists per channel, allowing them to run asynchronously
+     * @note A pair of ChannelGpfifo threads exist per channel, allowing them to run asynchronously, one resolves pushbuffer mappings ahead of the other which executes them
      * @note This class doesn't perfectly map to any particular hardware component on the X1, it does a mix of the GPU Host PBDMA and handling the GPFIFO entries
      * @url https://github.com/NVIDIA/open-gpu-doc/blob/ab27fc22db5de0d02a4cabe08e555663b62db4d4/manuals/volta/gv100/dev_pbdma.ref.txt#L62
      */
@@ -105,8 +105,24 @@ namespace skyline::soc::gm20b {
         const DeviceState &state;
         ChannelContext &channelCtx;
         engine::GPFIFO gpfifoEngine; //!< The engine for processing GPFIFO method calls
-        CircularQueue<GpEntry> gpEntries;
-        std::vector<u32> pushBufferData; //!< Persistent vector storing pushbuffer data to avoid constant reallocations
+        CircularQueue<GpEntry> gpEntries; //!< Entries pushed by the guest that are yet to be prefetched
+
+        /**
+         * @brief A GpEntry alongside the host mappings of its pushbuffer, these are resolved on the prefetch thread ahead of execution
+         */
+        struct PrefetchedGpEntry {
+            static constexpr size_t MaxMappings{4}; //!< The maximum amount of mappings that can be resolved ahead of time, pushbuffers split across more are translated during execution
+
+            GpEntry gpEntry;
+            std::array<span<u32>, MaxMappings> mappings;
+            u8 mappingCount; //!< The amount of resolved mappings in `mappings`, if this is zero the pushbuffer of a non-control entry must be translated during execution
+        };
+        static_assert(std::is_trivially_copyable_v<PrefetchedGpEntry>);
+
+        static constexpr size_t PrefetchQueueSize{0x40}; //!< The maximum amount of entries that can be prefetched ahead of execution
+        CircularQueue<PrefetchedGpEntry> prefetchedEntries; //!< Entries with resolved pushbuffer mappings that are waiting to be executed
+        std::atomic<u32> pendingEntryCount{}; //!< The amount of entries pushed to this channel which haven't been executed yet, these are also counted in `SOC::pendingGpEntryCount`
+        u32 captureChannelId{}; //!< The ID of this channel in the GPFIFO capture, this is only valid while capturing
 
         /**
          * @brief Holds the required state in order to resume a method started from one call to `Process` in another
@@ -127,12 +143,13 @@ namespace skyline::soc::gm20b {
             } state; //!< The type of method to resume
         } resumeState{};
 
+        std::thread prefetchThread; //!< The thread that resolves the pushbuffer mappings of entries ahead of execution
         std::thread thread; //!< The thread that manages processing of pushbuffers
 
         /**
          * @brief Sends a method call to the appropriate subchannel and handles macro and GPFIFO methods
          */
-        void SendFull(u32 method, u32 argument, SubchannelId subchannel, bool lastCall);
+        void SendFull(u32 method, u32 argument, SubchannelId subchannel, bool lastCall, u32 *argumentSource = nullptr);
 
         /**
          * @brief Sends a method call to the appropriate subchannel, macro and GPFIFO methods are not handled
@@ -144,13 +161,45 @@ namespace skyline::soc::gm20b {
          */
         void SendPureBatchNonInc(u32 method, span<u32> arguments, SubchannelId subChannel);
 
+        /**
+         * @brief Sends a batch of method calls to consecutive methods to the appropriate subchannel, macro and GPFIFO methods are not handled
+         */
+        void SendPureBatchInc(u32 method, span<u32> arguments, SubchannelId subChannel);
+
+        /**
+         * @brief Processes a contiguously mapped section of a GpEntry's pushbuffer, any method that extends past the end of it is resumed in the next call
+         * @return If an EndPbSegment method was encountered and the rest of the GpEntry should be skipped
+         */
+        bool ProcessPushBufferMapping(span<u32> pushBuffer);
+
         /**
          * @brief Processes the pushbuffer contained within the given GpEntry, calling methods as needed
          */
-        void Process(GpEntry gpEntry);
+        void Process(const PrefetchedGpEntry &entry);
+
+        /**
+         * @brief Resolves the host mappings of the pushbuffer contained within the given GpEntry
+         */
+        PrefetchedGpEntry Prefetch(GpEntry gpEntry);
+
+        /**
+         * @brief Sets up the calling thread for GPFIFO processing and runs the supplied function, handling any exceptions it throws
+         */
+        template<typename Function>
+        void RunThread(const char *name, Function &&function);
+
+        /**
+         * @brief Prefetches all pending entries in the FIFO and polls for more
+         */
+        void RunPrefetch();
+
+        /**
+         * @brief Writes the entry and the current contents of its pushbuffer to the GPFIFO capture
+         */
+        void CaptureEntry(const PrefetchedGpEntry &entry);
 
         /**
-         * @brief Executes all pending entries in the FIFO and polls for more
+         * @brief Executes all prefetched entries and polls for more
          */
         void Run();
 
@@ -164,8 +213,9 @@ namespace skyline::soc::gm20b {
 
         /**
          * @brief Pushes a list of entries to the FIFO, these commands will be executed on calls to 'Process'
+         * @note The entries are copied directly into the FIFO in bulk, this only blocks if the FIFO is full which mirrors HW where the GPFIFO ring is only as large as was requested by the guest
          */
-        void Push(span<GpEntry> entries);
+        void Push(span<const GpEntry> entries);
 
         /**
          * @brief Pushes a single entry to the FIFO, these commands will be executed on calls to 'Process'
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <filesystem>
+#include <common/settings.h>
+#include <os.h>
+#include "gpfifo_capture.h"
+
+namespace skyline::soc::gm20b {
+    std::unique_ptr<GpfifoCapture> GpfifoCapture::Create(const DeviceState &state) {
+        if (!*state.settings->gpfifoCapture)
+            return nullptr;
+
+        std::string directory{state.os->publicAppFilesPath + "gpfifo_captures/"};
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            Logger::Warn("Failed to create the GPFIFO capture directory '{}': {}", directory, error.message());
+            return nullptr;
+        }
+
+        auto path{fmt::format("{}{}.skgc", directory, std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count())};
+        Logger::Info("Capturing the GPFIFO stream to '{}'", path);
+        return std::make_unique<GpfifoCapture>(path);
+    }
+
+    GpfifoCapture::GpfifoCapture(const std::string &path) : file{path, std::ios::binary | std::ios::trunc} {
+        if (!file)
+            throw exception("Failed to open the GPFIFO capture file '{}'", path);
+
+        FileHeader header{
+            .magic = Magic,
+            .version = Version,
+        };
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+
+    void GpfifoCapture::WriteRecord(RecordType type, u32 channelId, u64 size) {
+        RecordHeader header{
+            .type = type,
+            .channelId = channelId,
+            .timestamp = static_cast<u64>(util::GetTimeNs()),
+            .size = size,
+        };
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+
+    u32 GpfifoCapture::RegisterChannel() {
+        std::scoped_lock lock{mutex};
+        u32 channelId{nextChannelId++};
+        WriteRecord(RecordType::Channel, channelId, 0);
+        return channelId;
+    }
+
+    void GpfifoCapture::WriteEntry(u32 channelId, GpEntry entry, span<const span<u32>> pushBuffer) {
+        u64 size{sizeof(GpEntry)};
+        for (auto mapping : pushBuffer)
+            size += mapping.size_bytes();
+
+        std::scoped_lock lock{mutex};
+        WriteRecord(RecordType::Entry, channelId, size);
+        file.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        for (auto mapping : pushBuffer)
+            file.write(reinterpret_cast<const char *>(mapping.data()), static_cast<std::streamsize>(mapping.size_bytes()));
+    }
+
+    void GpfifoCapture::WriteFrameEnd(const FrameStatistics::FrameRecord &frame) {
+        std::scoped_lock lock{mutex};
+        WriteRecord(RecordType::FrameEnd, 0, sizeof(frame));
+        file.write(reinterpret_cast<const char *>(&frame), sizeof(frame));
+        file.flush(); // Frames are the unit of comparison, so a capture that's cut short still contains every frame prior to it
+    }
+}
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <fstream>
+#include <common/frame_statistics.h>
+#include "gpfifo.h"
+
+namespace skyline::soc::gm20b {
+    /**
+     * @brief Records the GPFIFO stream of all channels alongside the contents of the pushbuffers it references to a file, so a GPU workload can be inspected and compared frame by frame
+     * @details The file starts with a FileHeader which is followed by records that each start with a RecordHeader, its payload immediately follows it:
+     * * Channel: No payload, the channel with the ID in the header was created
+     * * Entry: The raw 64-bit GpEntry followed by the pushbuffer words it references as they were when they were executed
+     * * FrameEnd: The FrameStatistics::FrameRecord of the presented frame, every entry since the prior FrameEnd was executed during this frame
+     * @note Macro uploads and inline memory uploads are methods in pushbuffers and are captured alongside them, guest memory that isn't a pushbuffer isn't captured
+     */
+    class GpfifoCapture {
+      public:
+        static constexpr u32 Magic{util::MakeMagic<u32>("SKGC")};
+        static constexpr u32 Version{1};
+
+        struct FileHeader {
+            u32 magic;
+            u32 version;
+        };
+
+        enum class RecordType : u32 {
+            Channel,
+            Entry,
+            FrameEnd,
+        };
+
+        struct RecordHeader {
+            RecordType type;
+            u32 channelId; //!< The ID of the channel the record is for, this is zero for records that aren't specific to a channel
+            u64 timestamp; //!< The time at which the record was written in nanoseconds
+            u64 size; //!< The size of the payload following the header in bytes
+        };
+
+      private:
+        std::mutex mutex; //!< Serializes writes from the GPFIFO threads of all channels and the presentation thread
+        std::ofstream file;
+        u32 nextChannelId{1};
+
+        /**
+         * @note The mutex must be locked by the caller
+         */
+        void WriteRecord(RecordType type, u32 channelId, u64 size);
+
+      public:
+        /**
+         * @return A capture writing to a new file in the GPFIFO capture directory, or nullptr if capturing is disabled
+         */
+        static std::unique_ptr<GpfifoCapture> Create(const DeviceState &state);
+
+        GpfifoCapture(const std::string &path);
+
+        /**
+         * @return The ID that records of a newly created channel are written with
+         */
+        u32 RegisterChannel();
+
+        /**
+         * @param pushBuffer The mappings of the pushbuffer in order, these are empty for control entries
+         */
+        void WriteEntry(u32 channelId, GpEntry entry, span<const span<u32>> pushBuffer);
+
+        void WriteFrameEnd(const FrameStatistics::FrameRecord &frame);
+    };
+}
@@ -0,0 +1,543 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/mman.h>
+#include "soc/gm20b/engines/engine.h"
+#include "macro_jit.h"
+
+namespace skyline::soc::gm20b::engine {
+    namespace {
+        using Register = u8; //!< A 5-bit AArch64 register index, all encodings used here treat 31 as the zero register
+
+        constexpr Register ZeroRegister{31};
+        constexpr Register ContextRegister{19}; //!< X19: A pointer to the MacroJit::Context of the invocation
+        constexpr Register ArgumentRegister{27}; //!< X27: A pointer to the next argument to be fetched
+        constexpr Register CarryRegister{28}; //!< W28: The carry flag, either 0 or 1
+        constexpr Register ResultRegister{9}; //!< W9: The result of the instruction currently being executed
+        constexpr Register ScratchRegister{10}; //!< W10: A temporary used for materializing immediates
+        constexpr Register CallRegister{16}; //!< X16: Holds the address of a thunk that is being called
+
+        /**
+         * @return The host register that the supplied macro register is statically allocated to, r1-r7 map to the callee-saved W20-W26 so they're preserved across thunk calls
+         */
+        constexpr Register HostRegister(u8 macroRegister) {
+            return macroRegister ? static_cast<Register>(19 + macroRegister) : ZeroRegister;
+        }
+
+        /**
+         * @url https://developer.arm.com/documentation/ddi0596/2021-12/Base-Instructions/B-cond--Branch-conditionally-
+         */
+        enum class Condition : u8 {
+            Equal = 0b0000,
+            NotEqual = 0b0001,
+            CarrySet = 0b0010,
+        };
+
+        /**
+         * @brief A minimal AArch64 assembler covering the subset of the ISA used for translating macros
+         * @note All data-processing instructions emitted are 32-bit variants as the Maxwell MME is a 32-bit machine
+         */
+        class Assembler {
+          private:
+            void DataProcessing(u32 base, Register d, Register n, Register m) {
+                Emit(base | (static_cast<u32>(m) << 16) | (static_cast<u32>(n) << 5) | d);
+            }
+
+            void Ubfm(Register d, Register n, u8 immr, u8 imms) {
+                Emit(0x53000000 | (static_cast<u32>(immr) << 16) | (static_cast<u32>(imms) << 10) | (static_cast<u32>(n) << 5) | d);
+            }
+
+          public:
+            std::vector<u32> code;
+
+            void Emit(u32 instruction) {
+                code.push_back(instruction);
+            }
+
+            size_t Position() {
+                return code.size();
+            }
+
+            void Add(Register d, Register n, Register m) { DataProcessing(0x0B000000, d, n, m); }
+
+            void Adds(Register d, Register n, Register m) { DataProcessing(0x2B000000, d, n, m); }
+
+            void Adcs(Register d, Register n, Register m) { DataProcessing(0x3A000000, d, n, m); }
+
+            void Subs(Register d, Register n, Register m) { DataProcessing(0x6B000000, d, n, m); }
+
+            void Sbcs(Register d, Register n, Register m) { DataProcessing(0x7A000000, d, n, m); }
+
+            void And(Register d, Register n, Register m) { DataProcessing(0x0A000000, d, n, m); }
+
+            void Bic(Register d, Register n, Register m) { DataProcessing(0x0A200000, d, n, m); }
+
+            void Orr(Register d, Register n, Register m) { DataProcessing(0x2A000000, d, n, m); }
+
+            void Orn(Register d, Register n, Register m) { DataProcessing(0x2A200000, d, n, m); }
+
+            void Eor(Register d, Register n, Register m) { DataProcessing(0x4A000000, d, n, m); }
+
+            void Lslv(Register d, Register n, Register m) { DataProcessing(0x1AC02000, d, n, m); }
+
+            void Lsrv(Register d, Register n, Register m) { DataProcessing(0x1AC02400, d, n, m); }
+
+            void Mov(Register d, Register m) {
+                Orr(d, ZeroRegister, m);
+            }
+
+            void MovX(Register d, Register m) {
+                DataProcessing(0xAA000000, d, ZeroRegister, m);
+            }
+
+            void Lsr(Register d, Register n, u8 shift) {
+                Ubfm(d, n, shift, 31);
+            }
+
+            void Lsl(Register d, Register n, u8 shift) {
+                Ubfm(d, n, static_cast<u8>((32 - shift) & 31), static_cast<u8>(31 - shift));
+            }
+
+            void Ubfx(Register d, Register n, u8 lsb, u8 width) {
+                Ubfm(d, n, lsb, static_cast<u8>(lsb + width - 1));
+            }
+
+            /**
+             * @brief Sets the destination to 1 if the condition holds or 0 otherwise (CSINC Wd, WZR, WZR, !cond)
+             */
+            void Cset(Register d, Condition condition) {
+                Emit(0x1A9F07E0 | (static_cast<u32>(static_cast<u8>(condition) ^ 1) << 12) | d);
+            }
+
+            /**
+             * @brief CMP Wn, #imm (SUBS WZR, Wn, #imm)
+             */
+            void Cmp(Register n, u16 imm12) {
+                Emit(0x7100001F | (static_cast<u32>(imm12 & 0xFFF) << 10) | (static_cast<u32>(n) << 5));
+            }
+
+            void LoadConstant(Register d, u32 value) {
+                Emit(0x52800000 | ((value & 0xFFFF) << 5) | d); // MOVZ
+                if (value >> 16)
+                    Emit(0x72A00000 | ((value >> 16) << 5) | d); // MOVK, LSL #16
+            }
+
+            void LoadAddress(Register d, u64 value) {
+                Emit(0xD2800000 | (static_cast<u32>(value & 0xFFFF) << 5) | d); // MOVZ
+                for (u32 hw{1}; hw < 4; hw++)
+                    if (u32 chunk{static_cast<u32>((value >> (hw * 16)) & 0xFFFF)})
+                        Emit(0xF2800000 | (hw << 21) | (chunk << 5) | d); // MOVK
+            }
+
+            /**
+             * @brief LDR Wt, [Xn], #imm
+             */
+            void LdrPostIndex(Register t, Register n, i16 imm9) {
+                Emit(0xB8400400 | ((static_cast<u32>(imm9) & 0x1FF) << 12) | (static_cast<u32>(n) << 5) | t);
+            }
+
+            /**
+             * @brief STR Wt, [Xn, #offset]
+             */
+            void Str(Register t, Register n, u32 offset) {
+                Emit(0xB9000000 | ((offset / sizeof(u32)) << 10) | (static_cast<u32>(n) << 5) | t);
+            }
+
+            void StpPreIndex(Register t, Register t2, Register n, i16 offset) {
+                Emit(0xA9800000 | ((static_cast<u32>(offset / 8) & 0x7F) << 15) | (static_cast<u32>(t2) << 10) | (static_cast<u32>(n) << 5) | t);
+            }
+
+            void Stp(Register t, Register t2, Register n, i16 offset) {
+                Emit(0xA9000000 | ((static_cast<u32>(offset / 8) & 0x7F) << 15) | (static_cast<u32>(t2) << 10) | (static_cast<u32>(n) << 5) | t);
+            }
+
+            void Ldp(Register t, Register t2, Register n, i16 offset) {
+                Emit(0xA9400000 | ((static_cast<u32>(offset / 8) & 0x7F) << 15) | (static_cast<u32>(t2) << 10) | (static_cast<u32>(n) << 5) | t);
+            }
+
+            void LdpPostIndex(Register t, Register t2, Register n, i16 offset) {
+                Emit(0xA8C00000 | ((static_cast<u32>(offset / 8) & 0x7F) << 15) | (static_cast<u32>(t2) << 10) | (static_cast<u32>(n) << 5) | t);
+            }
+
+            void MovFramePointer() {
+                Emit(0x910003FD); // MOV X29, SP
+            }
+
+            void Blr(Register n) {
+                Emit(0xD63F0000 | (static_cast<u32>(n) << 5));
+            }
+
+            void Ret() {
+                Emit(0xD65F03C0);
+            }
+
+            /**
+             * @brief TBZ Xt, #bit, #offset with the offset being in instructions
+             */
+            void Tbz(Register t, u8 bit, i16 offset) {
+                Emit(0x36000000 | (static_cast<u32>(bit >> 5) << 31) | (static_cast<u32>(bit & 31) << 19) | ((static_cast<u32>(offset) & 0x3FFF) << 5) | t);
+            }
+
+            /**
+             * @return The position of a B instruction that must be patched with PatchBranch
+             */
+            size_t B() {
+                Emit(0x14000000);
+                return Position() - 1;
+            }
+
+            /**
+             * @return The position of a CBZ/CBNZ instruction that must be patched with PatchCompareBranch
+             */
+            size_t CompareBranch(Register t, bool nonZero) {
+                Emit((nonZero ? 0x35000000 : 0x34000000) | t);
+                return Position() - 1;
+            }
+
+            void PatchBranch(size_t position, size_t target) {
+                code[position] |= static_cast<u32>(static_cast<i64>(target) - static_cast<i64>(position)) & 0x3FFFFFF;
+            }
+
+            void PatchCompareBranch(size_t position, size_t target) {
+                code[position] |= (static_cast<u32>(static_cast<i64>(target) - static_cast<i64>(position)) & 0x7FFFF) << 5;
+            }
+        };
+    }
+
+    MacroJit::MacroJit(span<u32> macroCode) : macroCode(macroCode) {}
+
+    MacroJit::~MacroJit() {
+        if (codeRegion.valid())
+            munmap(codeRegion.data(), codeRegion.size_bytes());
+    }
+
+    u64 MacroJit::SendThunk(Context *context, u32 argument) noexcept {
+        try {
+            context->engine->CallMethodFromMacro(context->methodAddress.address, argument);
+            context->methodAddress.address += context->methodAddress.increment;
+            return 0;
+        } catch (...) {
+            context->exception = std::current_exception();
+            return 1ULL << 32;
+        }
+    }
+
+    u64 MacroJit::ReadThunk(Context *context, u32 method) noexcept {
+        try {
+            return context->engine->ReadMethodFromMacro(method);
+        } catch (...) {
+            context->exception = std::current_exception();
+            return 1ULL << 32;
+        }
+    }
+
+    std::vector<u32> MacroJit::Translate(size_t offset) {
+        if (offset >= macroCode.size())
+            return {};
+
+        auto macro{macroCode.subspan(offset)};
+        auto isValid{[&](size_t index, bool delaySlot) {
+            if (index >= macro.size())
+                return false;
+
+            Opcode opcode{macro[index]};
+            switch (opcode.operation) {
+                case Opcode::Operation::AluRegister:
+                    switch (opcode.aluOperation) {
+                        case Opcode::AluOperation::Add:
+                        case Opcode::AluOperation::AddWithCarry:
+                        case Opcode::AluOperation::Subtract:
+                        case Opcode::AluOperation::SubtractWithBorrow:
+                        case Opcode::AluOperation::BitwiseXor:
+                        case Opcode::AluOperation::BitwiseOr:
+                        case Opcode::AluOperation::BitwiseAnd:
+                        case Opcode::AluOperation::BitwiseAndNot:
+                        case Opcode::AluOperation::BitwiseNand:
+                            return true;
+                        default:
+                            return false;
+                    }
+
+                case Opcode::Operation::AddImmediate:
+                case Opcode::Operation::BitfieldReplace:
+                case Opcode::Operation::BitfieldExtractShiftLeftImmediate:
+                case Opcode::Operation::BitfieldExtractShiftLeftRegister:
+                case Opcode::Operation::ReadImmediate:
+                    return true;
+
+                case Opcode::Operation::Branch:
+                    return !delaySlot; // The interpreter throws on branches within delay slots, leave that to it
+
+                default:
+                    return false;
+            }
+        }};
+
+        // Determine every instruction that can be executed outside of a delay slot, the macro is rejected if any path can reach an invalid instruction
+        std::vector<bool> reachable(macro.size());
+        std::vector<size_t> pending{0};
+        while (!pending.empty()) {
+            size_t index{pending.back()};
+            pending.pop_back();
+            if (index < reachable.size() && reachable[index])
+                continue;
+
+            if (!isValid(index, false))
+                return {};
+            reachable[index] = true;
+
+            Opcode opcode{macro[index]};
+            if (opcode.operation == Opcode::Operation::Branch) {
+                i64 target{static_cast<i64>(index) + opcode.immediate};
+                if (target < 0 || static_cast<size_t>(target) >= macro.size() || (!opcode.noDelay && !isValid(index + 1, true)))
+                    return {};
+                pending.push_back(static_cast<size_t>(target));
+            }
+
+            if (opcode.exit) {
+                if (!isValid(index + 1, true))
+                    return {};
+            } else {
+                pending.push_back(index + 1);
+            }
+        }
+
+        Assembler as;
+        std::vector<size_t> labels(macro.size()); //!< The host position of every reachable macro instruction
+        std::vector<std::pair<size_t, size_t>> branchFixups; //!< Pairs of the host position of a branch and the macro instruction it targets
+        std::vector<size_t> exitFixups; //!< The host positions of branches to the epilogue
+
+        constexpr i16 FrameSize{0x60};
+        as.StpPreIndex(29, 30, 31, -FrameSize);
+        as.MovFramePointer();
+        for (Register reg{19}; reg < 29; reg += 2)
+            as.Stp(reg, static_cast<Register>(reg + 1), 31, static_cast<i16>(reg - 17) * 8);
+
+        as.MovX(ContextRegister, 0);
+        as.MovX(ArgumentRegister, 1);
+        // The first argument is stored in register 1
+        as.LdrPostIndex(HostRegister(1), ArgumentRegister, sizeof(u32));
+        for (u8 reg{2}; reg < 8; reg++)
+            as.Mov(HostRegister(reg), ZeroRegister);
+        as.Mov(CarryRegister, ZeroRegister);
+
+        auto emitCall{[&](auto thunk) {
+            as.MovX(0, ContextRegister);
+            as.LoadAddress(CallRegister, reinterpret_cast<u64>(thunk));
+            as.Blr(CallRegister);
+            // Bit 32 of the return value denotes that the engine threw, skip over the exit unless it's set
+            as.Tbz(0, 32, 2);
+            exitFixups.push_back(as.B());
+        }};
+
+        auto emitSend{[&](Register value) {
+            if (value != 1)
+                as.Mov(1, value);
+            emitCall(&SendThunk);
+        }};
+
+        auto emitInstruction{[&](Opcode opcode) {
+            Register srcA{HostRegister(opcode.srcA)}, srcB{HostRegister(opcode.srcB)};
+            u32 mask{(1U << opcode.bitfield.size) - 1};
+
+            switch (opcode.operation) {
+                case Opcode::Operation::AluRegister:
+                    switch (opcode.aluOperation) {
+                        case Opcode::AluOperation::Add:
+                            as.Adds(ResultRegister, srcA, srcB);
+                            as.Cset(CarryRegister, Condition::CarrySet);
+                            break;
+                        case Opcode::AluOperation::AddWithCarry:
+                            as.Cmp(CarryRegister, 1); // Sets the host carry flag to the macro carry flag
+                            as.Adcs(ResultRegister, srcA, srcB);
+                            as.Cset(CarryRegister, Condition::CarrySet);
+                            break;
+                        case Opcode::AluOperation::Subtract:
+                            // The interpreter sets the carry flag when the lower 32-bits of the result are non-zero, this is matched exactly
+                            as.Subs(ResultRegister, srcA, srcB);
+                            as.Cset(CarryRegister, Condition::NotEqual);
+                            break;
+                        case Opcode::AluOperation::SubtractWithBorrow:
+                            as.Cmp(CarryRegister, 1);
+                            as.Sbcs(ResultRegister, srcA, srcB);
+                            as.Cset(CarryRegister, Condition::NotEqual);
+                            break;
+                        case Opcode::AluOperation::BitwiseXor:
+                            as.Eor(ResultRegister, srcA, srcB);
+                            break;
+                        case Opcode::AluOperation::BitwiseOr:
+                            as.Orr(ResultRegister, srcA, srcB);
+                            break;
+                        case Opcode::AluOperation::BitwiseAnd:
+                            as.And(ResultRegister, srcA, srcB);
+                            break;
+                        case Opcode::AluOperation::BitwiseAndNot:
+                            as.Bic(ResultRegister, srcA, srcB);
+                            break;
+                        case Opcode::AluOperation::BitwiseNand:
+                            as.And(ResultRegister, srcA, srcB);
+                            as.Orn(ResultRegister, ZeroRegister, ResultRegister);
+                            break;
+                    }
+                    break;
+
+                case Opcode::Operation::AddImmediate:
+                    as.LoadConstant(ScratchRegister, static_cast<u32>(opcode.immediate));
+                    as.Add(ResultRegister, srcA, ScratchRegister);
+                    break;
+
+                case Opcode::Operation::BitfieldReplace:
+                    as.Lsr(ResultRegister, srcB, opcode.bitfield.srcBit);
+                    as.LoadConstant(ScratchRegister, mask);
+                    as.And(ResultRegister, ResultRegister, ScratchRegister);
+                    as.Lsl(ResultRegister, ResultRegister, opcode.bitfield.destBit);
+                    as.LoadConstant(ScratchRegister, ~(mask << opcode.bitfield.destBit));
+                    as.And(ScratchRegister, srcA, ScratchRegister);
+                    as.Orr(ResultRegister, ResultRegister, ScratchRegister);
+                    break;
+
+                case Opcode::Operation::BitfieldExtractShiftLeftImmediate:
+                    as.Lsrv(ResultRegister, srcB, srcA);
+                    as.LoadConstant(ScratchRegister, mask);
+                    as.And(ResultRegister, ResultRegister, ScratchRegister);
+                    as.Lsl(ResultRegister, ResultRegister, opcode.bitfield.destBit);
+                    break;
+
+                case Opcode::Operation::BitfieldExtractShiftLeftRegister:
+                    as.Lsr(ResultRegister, srcB, opcode.bitfield.srcBit);
+                    as.LoadConstant(ScratchRegister, mask);
+                    as.And(ResultRegister, ResultRegister, ScratchRegister);
+                    as.Lslv(ResultRegister, ResultRegister, srcA);
+                    break;
+
+                case Opcode::Operation::ReadImmediate:
+                    as.LoadConstant(ScratchRegister, static_cast<u32>(opcode.immediate));
+                    as.Add(1, srcA, ScratchRegister);
+                    emitCall(&ReadThunk);
+                    as.Mov(ResultRegister, 0);
+                    break;
+
+                default:
+                    break; // Branches are handled by the caller and other operations are rejected beforehand
+            }
+
+            Register dest{HostRegister(opcode.dest)};
+            auto setMethod{[&]() {
+                as.Str(ResultRegister, ContextRegister, offsetof(Context, methodAddress));
+            }};
+
+            // Register writes use the zero register for r0 which discards them, fetches into it still advance the argument pointer
+            switch (opcode.assignmentOperation) {
+                case Opcode::AssignmentOperation::IgnoreAndFetch:
+                    as.LdrPostIndex(dest, ArgumentRegister, sizeof(u32));
+                    break;
+                case Opcode::AssignmentOperation::Move:
+                    as.Mov(dest, ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSetMethod:
+                    as.Mov(dest, ResultRegister);
+                    setMethod();
+                    break;
+                case Opcode::AssignmentOperation::FetchAndSend:
+                    as.LdrPostIndex(dest, ArgumentRegister, sizeof(u32));
+                    emitSend(ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSend:
+                    as.Mov(dest, ResultRegister);
+                    emitSend(ResultRegister);
+                    break;
+                case Opcode::AssignmentOperation::FetchAndSetMethod:
+                    as.LdrPostIndex(dest, ArgumentRegister, sizeof(u32));
+                    setMethod();
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSetMethodThenFetchAndSend:
+                    as.Mov(dest, ResultRegister);
+                    setMethod();
+                    as.LdrPostIndex(1, ArgumentRegister, sizeof(u32));
+                    emitSend(1);
+                    break;
+                case Opcode::AssignmentOperation::MoveAndSetMethodThenSendHigh:
+                    as.Mov(dest, ResultRegister);
+                    setMethod();
+                    as.Ubfx(1, ResultRegister, 12, 6); // MethodAddress::increment
+                    emitSend(1);
+                    break;
+            }
+        }};
+
+        for (size_t index{}; index < macro.size(); index++) {
+            if (!reachable[index])
+                continue;
+
+            labels[index] = as.Position();
+            Opcode opcode{macro[index]};
+            if (opcode.operation == Opcode::Operation::Branch) {
+                // Skip over the taken path when the condition doesn't hold, the exit bit is only respected on the fallthrough path
+                size_t skip{as.CompareBranch(HostRegister(opcode.srcA), opcode.branchCondition == Opcode::BranchCondition::Zero)};
+                if (!opcode.noDelay)
+                    emitInstruction(Opcode{macro[index + 1]});
+                branchFixups.emplace_back(as.B(), static_cast<size_t>(static_cast<i64>(index) + opcode.immediate));
+                as.PatchCompareBranch(skip, as.Position());
+            } else {
+                emitInstruction(opcode);
+            }
+
+            // Exit has a delay slot, the exit bit of the delay slot instruction is ignored
+            if (opcode.exit) {
+                emitInstruction(Opcode{macro[index + 1]});
+                exitFixups.push_back(as.B());
+            }
+        }
+
+        size_t exitLabel{as.Position()};
+        for (Register reg{19}; reg < 29; reg += 2)
+            as.Ldp(reg, static_cast<Register>(reg + 1), 31, static_cast<i16>(reg - 17) * 8);
+        as.LdpPostIndex(29, 30, 31, FrameSize);
+        as.Ret();
+
+        for (auto [position, target] : branchFixups)
+            as.PatchBranch(position, labels[target]);
+        for (auto position : exitFixups)
+            as.PatchBranch(position, exitLabel);
+
+        return std::move(as.code);
+    }
+
+    MacroJit::Function MacroJit::Compile(size_t offset) {
+        auto code{Translate(offset)};
+        if (code.empty())
+            return nullptr;
+
+        if (!codeRegion.valid()) {
+            auto region{mmap(nullptr, CodeRegionSize, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+            if (region == MAP_FAILED)
+                throw exception("Failed to allocate macro JIT code region: {}", strerror(errno));
+            codeRegion = span{reinterpret_cast<u32 *>(region), CodeRegionSize / sizeof(u32)};
+        }
+
+        if (codeOffset + code.size() > codeRegion.size()) {
+            Logger::Warn("Macro JIT code region exhausted, interpreting macro at 0x{:X} until the next invalidation", offset);
+            return nullptr;
+        }
+
+        auto function{codeRegion.subspan(codeOffset, code.size())};
+        std::copy(code.begin(), code.end(), function.begin());
+        __builtin___clear_cache(reinterpret_cast<char *>(function.data()), reinterpret_cast<char *>(function.data() + function.size()));
+        codeOffset += code.size();
+
+        Logger::Debug("Compiled macro at 0x{:X} into {} host instructions", offset, code.size());
+        return reinterpret_cast<Function>(function.data());
+    }
+
+    void MacroJit::Reset() {
+        codeOffset = 0;
+    }
+
+    void MacroJit::Execute(Function function, span<u32> args, MacroEngineBase *targetEngine) {
+        Context context{.engine = targetEngine};
+        function(&context, args.data());
+
+        if (context.exception)
+            std::rethrow_exception(context.exception);
+    }
+}
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <exception>
+#include <common.h>
+#include "macro_interpreter.h"
+
+namespace skyline::soc::gm20b::engine {
+    /**
+     * @brief The MacroJit class compiles macros into AArch64 code once after they're uploaded, avoiding the decoding and dispatch overhead of the interpreter on every invocation
+     * @note Macros that cannot be statically proven to only execute valid instructions are rejected and left to the interpreter, which will raise the appropriate error when they're executed
+     */
+    class MacroJit {
+      public:
+        /**
+         * @brief The state of a single macro invocation that is shared between the compiled code and the host
+         */
+        struct Context {
+            MacroInterpreter::MethodAddress methodAddress{}; //!< The method address that is used for sends, this is written directly by the compiled code
+            MacroEngineBase *engine; //!< The target engine of the invocation
+            std::exception_ptr exception; //!< Any exception thrown by the engine during the invocation, it's rethrown after the compiled code returns as it cannot be unwound through
+        };
+
+        using Function = void (*)(Context *context, const u32 *arguments);
+
+      private:
+        using Opcode = MacroInterpreter::Opcode;
+
+        static constexpr size_t CodeRegionSize{0x400000}; //!< The size of the region that compiled functions are allocated from, a single macro can never exceed 2MiB of host code
+
+        span<u32> macroCode; //!< Span pointing to the global macro code memory
+        span<u32> codeRegion; //!< The RWX region that compiled functions are written into
+        size_t codeOffset{}; //!< The offset of the first free instruction inside the code region
+
+        /**
+         * @brief Sends a method to the engine and increments the method address, this is called from compiled code
+         * @return A non-zero value if the engine threw an exception which has been stored in the context
+         */
+        static u64 SendThunk(Context *context, u32 argument) noexcept;
+
+        /**
+         * @brief Reads a method from the engine, this is called from compiled code
+         * @return The value of the method in the lower 32-bits, bit 32 is set if the engine threw an exception which has been stored in the context
+         */
+        static u64 ReadThunk(Context *context, u32 method) noexcept;
+
+        /**
+         * @brief Translates the macro at the supplied offset into host code
+         * @return The host code for the macro or an empty vector if it cannot be compiled
+         */
+        std::vector<u32> Translate(size_t offset);
+
+      public:
+        MacroJit(span<u32> macroCode);
+
+        MacroJit(const MacroJit &) = delete;
+
+        MacroJit &operator=(const MacroJit &) = delete;
+
+        ~MacroJit();
+
+        /**
+         * @brief Compiles the macro at the supplied offset in macro memory
+         * @return The compiled function or nullptr if the macro should be interpreted instead
+         */
+        Function Compile(size_t offset);
+
+        /**
+         * @brief Frees all compiled code, any function returned by Compile prior to this call must not be executed after it
+         */
+        void Reset();
+
+        /**
+         * @brief Executes a compiled macro with the given arguments targeting the specified engine
+         */
+        void Execute(Function function, span<u32> args, MacroEngineBase *targetEngine);
+    };
+}
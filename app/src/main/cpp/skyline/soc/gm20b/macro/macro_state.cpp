@@ -8,7 +8,15 @@
 namespace skyline::soc::gm20b {
     namespace macro_hle {
         void DrawInstanced(size_t offset, span<u32> args, engine::MacroEngineBase *targetEngine) {
-            u32 instanceCount{targetEngine->ReadMethodFromMacro(0xD1B) & args[2]};
+            u32 instanceMask{targetEngine->ReadMethodFromMacro(0xD1B)};
+
+            // The count, instance count, first vertex and first instance arguments match the layout of VkDrawIndirectCommand, if they're sourced from a buffer the GPU writes to (as is the case for indirect draws) then they can be read by the GPU directly
+            if (instanceMask == std::numeric_limits<u32>::max())
+                if (auto source{targetEngine->GetMacroArgumentSource(1, 4)}; !source.empty())
+                    if (targetEngine->DrawIndirect(args[0], false, source, 1, static_cast<u32>(source.size()), {}, args[1], args[3]))
+                        return;
+
+            u32 instanceCount{instanceMask & args[2]};
 
             targetEngine->DrawInstanced(true, args[0], args[1], instanceCount, args[3], args[4]);
         }
@@ -35,26 +43,59 @@ namespace skyline::soc::gm20b {
             Function function;
             u64 size;
             u32 hash;
+            std::string_view name; //!< The name of the macro, used for logging
         };
 
+        /**
+         * @brief All macros with an HLE implementation, these are matched against the XXH32 hash of the first `size` instructions of a macro
+         * @note The size and hash of candidate macros can be found by enabling unhandled macro logging which reports them alongside their invocation counts
+         */
         constexpr std::array<HleFunctionInfo, 0x3> functions{{
-            {DrawInstanced, 0x12, 0x6F0DD310},
-            {DrawIndexedInstanced, 0x17, 0x2764C4F},
-            {DrawInstancedIndexedWithConstantBuffer, 0x1F, 0xF2F16988},
+            {DrawInstanced, 0x12, 0x6F0DD310, "DrawInstanced"},
+            {DrawIndexedInstanced, 0x17, 0x2764C4F, "DrawIndexedInstanced"},
+            {DrawInstancedIndexedWithConstantBuffer, 0x1F, 0xF2F16988, "DrawInstancedIndexedWithConstantBuffer"},
         }};
 
-        static Function LookupFunction(span<u32> code) {
+        static const HleFunctionInfo *LookupFunction(span<u32> code) {
             for (const auto &function : functions) {
                 if (function.size > code.size())
                     continue;
 
                 auto macro{code.subspan(0, function.size)};
 
-                if (XXH32(code.data(), code.size_bytes(), 0) == function.hash)
-                    return function.function;
+                if (XXH32(macro.data(), macro.size_bytes(), 0) == function.hash)
+                    return &function;
             }
 
-            return {};
+            return nullptr;
+        }
+    }
+
+    size_t MacroState::GetMacroSize(size_t offset) {
+        size_t end{macroCode.size()};
+        for (size_t position : macroPositions)
+            if (position > offset)
+                end = std::min(end, position);
+
+        if (end == macroCode.size()) {
+            // The last macro in memory has no following macro to bound it, assume it ends with the delay slot of its first exit
+            constexpr u32 ExitBit{1 << 7};
+            for (size_t index{offset}; index < macroCode.size(); index++) {
+                if (macroCode[index] & ExitBit) {
+                    end = std::min(index + 2, macroCode.size());
+                    break;
+                }
+            }
+        }
+
+        return end - offset;
+    }
+
+    void MacroState::LogUnhandledMacros() {
+        for (size_t position{}; position < macroHleFunctions.size(); position++) {
+            const auto &entry{macroHleFunctions[position]};
+            if (entry.valid && !entry.function && entry.invocations)
+                Logger::Info("Unhandled macro at position 0x{:X}: hash: 0x{:08X}, size: 0x{:X}, invocations: {}", position, entry.hash, entry.size, entry.invocations);
         }
     }
 
@@ -66,19 +107,44 @@ namespace skyline::soc::gm20b {
         size_t offset{macroPositions[position]};
 
         if (invalidatePending) {
+            if (logUnhandledMacros)
+                LogUnhandledMacros();
+
             macroHleFunctions.fill({});
+            macroJit.Reset();
             invalidatePending = false;
         }
 
         auto &hleEntry{macroHleFunctions[position]};
 
         if (!hleEntry.valid) {
-            hleEntry.function = macro_hle::LookupFunction(span(macroCode).subspan(offset));
+            auto hleFunction{macro_hle::LookupFunction(span(macroCode).subspan(offset))};
+            if (hleFunction) {
+                hleEntry.function = hleFunction->function;
+                if (logUnhandledMacros)
+                    Logger::Info("Using HLE implementation {} for macro at position 0x{:X}", hleFunction->name, position);
+            } else {
+                hleEntry.jitFunction = macroJit.Compile(offset);
+                if (logUnhandledMacros) {
+                    hleEntry.size = static_cast<u32>(GetMacroSize(offset));
+                    hleEntry.hash = XXH32(&macroCode[offset], hleEntry.size * sizeof(u32), 0);
+                    Logger::Info("Unhandled macro at position 0x{:X}: hash: 0x{:08X}, size: 0x{:X}, {}", position, hleEntry.hash, hleEntry.size, hleEntry.jitFunction ? "compiled" : "interpreted");
+                }
+            }
             hleEntry.valid = true;
         }
 
-        if (macroHleFunctions[position].function)
-            macroHleFunctions[position].function(offset, args, targetEngine);
+        if (logUnhandledMacros && !hleEntry.function) {
+            // Report hot macros as their invocation counts reach every power of two so they can be found without waiting for an invalidation
+            constexpr u32 InvocationLogThreshold{0x100};
+            if (std::has_single_bit(++hleEntry.invocations) && hleEntry.invocations >= InvocationLogThreshold)
+                Logger::Info("Unhandled macro at position 0x{:X}: hash: 0x{:08X}, size: 0x{:X}, invocations: {}", position, hleEntry.hash, hleEntry.size, hleEntry.invocations);
+        }
+
+        if (hleEntry.function)
+            hleEntry.function(offset, args, targetEngine);
+        else if (hleEntry.jitFunction)
+            macroJit.Execute(hleEntry.jitFunction, args, targetEngine);
         else
             macroInterpreter.Execute(offset, args, targetEngine);
     }
@@ -5,6 +5,7 @@
 
 #include <common.h>
 #include "macro_interpreter.h"
+#include "macro_jit.h"
 
 namespace skyline::soc::gm20b {
     namespace macro_hle {
@@ -17,16 +18,32 @@ namespace skyline::soc::gm20b {
     struct MacroState {
         struct MacroHleEntry {
             macro_hle::Function function;
+            engine::MacroJit::Function jitFunction; //!< The compiled macro, this is only used when there's no HLE function for the macro
             bool valid;
+            u32 hash; //!< The XXH32 hash of the macro code, this is only calculated when logging unhandled macros
+            u32 size; //!< The size of the macro in instructions, this is only calculated when logging unhandled macros
+            u32 invocations; //!< The amount of times the macro has been executed since the last invalidation, this is only counted when logging unhandled macros
         };
 
         engine::MacroInterpreter macroInterpreter; //!< The macro interpreter for handling 3D/2D macros
+        engine::MacroJit macroJit; //!< The macro JIT for compiling 3D/2D macros, the interpreter is used for any macros it rejects
         std::array<u32, 0x2000> macroCode{}; //!< Stores GPU macros, writes to it will wraparound on overflow
         std::array<size_t, 0x80> macroPositions{}; //!< The positions of each individual macro in macro code memory, there can be a maximum of 0x80 macros at any one time
-        std::array<MacroHleEntry, 0x80> macroHleFunctions{}; //!< The HLE functions for each macro position, used to optionally override the interpreter
+        std::array<MacroHleEntry, 0x80> macroHleFunctions{}; //!< The HLE functions for each macro position, used to optionally override the JIT and interpreter
         bool invalidatePending{};
+        bool logUnhandledMacros; //!< If macros without an HLE implementation should be logged alongside their invocation counts, this is used for finding hot macros to implement
 
-        MacroState() : macroInterpreter(macroCode) {}
+        MacroState(bool logUnhandledMacros = false) : macroInterpreter(macroCode), macroJit(macroCode), logUnhandledMacros(logUnhandledMacros) {}
+
+        /**
+         * @return The size of the macro at the supplied offset in instructions, determined by the start of the following macro or the first exit if there's no following macro
+         */
+        size_t GetMacroSize(size_t offset);
+
+        /**
+         * @brief Logs the invocation counts of all unhandled macros since the last invalidation
+         */
+        void LogUnhandledMacros();
 
         void Invalidate();
 
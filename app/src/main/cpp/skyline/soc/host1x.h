@@ -4,6 +4,7 @@
 #pragma once
 
 #include "host1x/syncpoint.h"
+#include "host1x/frame_cache.h"
 #include "host1x/command_fifo.h"
 
 namespace skyline::soc::host1x {
@@ -16,8 +17,9 @@ namespace skyline::soc::host1x {
     class Host1x {
       public:
         SyncpointSet syncpoints;
+        FrameCache frameCache; //!< The frames decoded by NVDEC on any channel, these are used as the source surfaces for VIC
         std::array<ChannelCommandFifo, ChannelCount> channels;
 
-        Host1x(const DeviceState &state) : channels{util::MakeFilledArray<ChannelCommandFifo, ChannelCount>(state, syncpoints)} {}
+        Host1x(const DeviceState &state) : channels{util::MakeFilledArray<ChannelCommandFifo, ChannelCount>(state, syncpoints, frameCache)} {}
     };
 }
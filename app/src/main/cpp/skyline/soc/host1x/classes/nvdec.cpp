@@ -1,13 +1,76 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <soc.h>
 #include "nvdec.h"
 
 namespace skyline::soc::host1x {
-    NvDecClass::NvDecClass(std::function<void()> opDoneCallback)
-        : opDoneCallback(std::move(opDoneCallback)) {}
+    NvDecClass::NvDecClass(const DeviceState &state, FrameCache &frameCache)
+        : state(state),
+          frameCache(frameCache) {}
+
+    void NvDecClass::Execute() {
+        u32 pictureInfoAddress{*registers.pictureInfoOffset << 8}, bitstreamAddress{*registers.bitstreamOffset << 8};
+
+        span<u8> frame;
+        u32 width, height, surfaceIndex;
+        std::string_view mimeType;
+        switch (*registers.codecType) {
+            case CodecType::H264:
+                frame = h264.ComposeFrame(state.soc->smmu, pictureInfoAddress, bitstreamAddress);
+                width = h264.GetWidth();
+                height = h264.GetHeight();
+                surfaceIndex = h264.GetOutputSurfaceIndex();
+                mimeType = "video/avc";
+                break;
+
+            case CodecType::Vp8:
+                frame = vp8.ComposeFrame(state.soc->smmu, pictureInfoAddress, bitstreamAddress);
+                width = vp8.GetWidth();
+                height = vp8.GetHeight();
+                surfaceIndex = vp8.GetOutputSurfaceIndex();
+                mimeType = "video/x-vnd.on2.vp8";
+                break;
+
+            default:
+                if (unsupportedCodec != *registers.codecType) {
+                    Logger::Warn("Unimplemented NVDEC codec: 0x{:X}", static_cast<u32>(*registers.codecType));
+                    unsupportedCodec = *registers.codecType;
+                }
+                return;
+        }
+
+        if (unsupportedCodec == *registers.codecType || surfaceIndex >= SurfaceCount)
+            return;
+
+        if (!decoder || !decoder->IsCompatible(mimeType, width, height)) {
+            decoder.reset();
+            try {
+                decoder = std::make_unique<nvdec::MediaCodecDecoder>(frameCache, mimeType, width, height);
+            } catch (const exception &e) {
+                Logger::Warn("Failed to create host decoder: {}", e.what());
+                unsupportedCodec = *registers.codecType;
+                return;
+            }
+        }
+
+        if (!decoder->Decode(frame, registers.surfaceLumaOffsets[surfaceIndex] << 8))
+            Logger::Warn("Dropped NVDEC frame #{}", *registers.frameNumber);
+    }
 
     void NvDecClass::CallMethod(u32 method, u32 argument) {
-        Logger::Warn("Unknown NVDEC class method called: 0x{:X} argument: 0x{:X}", method, argument);
+        if (method >= Registers::RegisterCount) [[unlikely]] {
+            Logger::Warn("Unknown NVDEC class method called: 0x{:X} argument: 0x{:X}", method, argument);
+            return;
+        }
+
+        registers.raw[method] = argument;
+
+        if (method == ExecuteMethodId)
+            Execute();
+    }
+
+    void NvDecClass::Signal(std::function<void()> &&callback) {
+        callback(); // Frames are queued to the decoder synchronously within Execute
     }
 }
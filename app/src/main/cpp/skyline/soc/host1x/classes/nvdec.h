@@ -4,18 +4,82 @@
 #pragma once
 
 #include <common.h>
+#include "nvdec/h264.h"
+#include "nvdec/vp8.h"
+#include "nvdec/media_codec.h"
 
 namespace skyline::soc::host1x {
     /**
      * @brief The NVDEC Host1x class implements hardware accelerated video decoding for the VP9/VP8/H264/VC1 codecs
+     * @note Decoding is performed by the host's hardware decoders through MediaCodec, the guest bitstream is reassembled into a standard one for this
      */
     class NvDecClass {
       private:
-        std::function<void()> opDoneCallback;
+        const DeviceState &state;
+        FrameCache &frameCache;
+
+        enum class CodecType : u32 {
+            None = 0x0,
+            H264 = 0x3,
+            Vp8 = 0x5,
+            H265 = 0x7,
+            Vp9 = 0x9,
+        };
+
+        static constexpr size_t SurfaceCount{17}; //!< The amount of surfaces that can be bound as the output or references of a frame
+
+        /**
+         * @note All offsets are in the SMMU address space in units of 0x100 bytes
+         * @url https://github.com/yuzu-emu/yuzu/blob/0b8f4a6/src/video_core/host1x/nvdec_common.h
+         */
+        union Registers {
+            static constexpr size_t RegisterCount{0x200};
+
+            std::array<u32, RegisterCount> raw;
+
+            template<size_t Offset, typename Type>
+            using Register = util::OffsetMember<Offset, Type, u32>;
+
+            Register<0x80, CodecType> codecType;
+            Register<0xC0, u32> execute; //!< Decodes a frame with the current state when written to
+            Register<0x100, u32> controlParams;
+            Register<0x101, u32> pictureInfoOffset;
+            Register<0x102, u32> bitstreamOffset;
+            Register<0x103, u32> frameNumber;
+            Register<0x104, u32> h264SliceDataOffsets;
+            Register<0x105, u32> h264MvDumpOffset;
+            Register<0x109, u32> frameStatsOffset;
+            Register<0x10A, u32> h264LastSurfaceLumaOffset;
+            Register<0x10B, u32> h264LastSurfaceChromaOffset;
+            Register<0x10C, std::array<u32, SurfaceCount>> surfaceLumaOffsets;
+            Register<0x11D, std::array<u32, SurfaceCount>> surfaceChromaOffsets;
+        } registers{};
+        static_assert(sizeof(Registers) == sizeof(u32) * Registers::RegisterCount);
+
+        static constexpr u32 ExecuteMethodId{0xC0};
+
+        nvdec::H264 h264;
+        nvdec::Vp8 vp8;
+        std::unique_ptr<nvdec::MediaCodecDecoder> decoder; //!< The host decoder for the current codec and resolution, this is recreated whenever either changes
+        CodecType unsupportedCodec{CodecType::None}; //!< The last codec that was found to have no host decoder, this avoids repeatedly attempting to create it
+
+        /**
+         * @brief Decodes a single frame using the current register state
+         */
+        void Execute();
 
       public:
-        NvDecClass(std::function<void()> opDoneCallback);
+        /**
+         * @param frameCache The cache that decoded frames are inserted into, they're decoded asynchronously so they may only become available after the operation has been signalled as done
+         */
+        NvDecClass(const DeviceState &state, FrameCache &frameCache);
 
         void CallMethod(u32 method, u32 argument);
+
+        /**
+         * @brief Calls the supplied callback once all previously issued operations have completed
+         * @note An operation is complete once the bitstream has been consumed by the decoder, the decoded frame is delivered asynchronously
+         */
+        void Signal(std::function<void()> &&callback);
     };
 }
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "h264.h"
+
+namespace skyline::soc::host1x::nvdec {
+    /**
+     * @brief Writes RBSP syntax elements MSB-first into a byte vector
+     */
+    class BitWriter {
+      private:
+        std::vector<u8> &output;
+        u8 current{}; //!< The byte that is currently being filled
+        u8 bitCount{}; //!< The amount of bits written into the current byte
+
+      public:
+        BitWriter(std::vector<u8> &output) : output{output} {}
+
+        void WriteBit(bool value) {
+            current = static_cast<u8>((current << 1) | (value ? 1 : 0));
+            if (++bitCount == 8) {
+                output.push_back(current);
+                current = 0;
+                bitCount = 0;
+            }
+        }
+
+        void WriteU(u32 value, u8 bits) {
+            while (bits)
+                WriteBit((value >> --bits) & 1);
+        }
+
+        /**
+         * @brief Writes an unsigned Exp-Golomb coded value
+         */
+        void WriteUe(u32 value) {
+            u32 coded{value + 1};
+            u8 bits{static_cast<u8>(std::bit_width(coded))};
+            WriteU(0, static_cast<u8>(bits - 1));
+            WriteU(coded, bits);
+        }
+
+        /**
+         * @brief Writes a signed Exp-Golomb coded value
+         */
+        void WriteSe(i32 value) {
+            WriteUe(value > 0 ? static_cast<u32>(value * 2 - 1) : static_cast<u32>(-value * 2));
+        }
+
+        /**
+         * @brief Writes a delta coded scaling list from a matrix in raster order
+         */
+        void WriteScalingList(span<const u8> matrix, span<const u8> scan) {
+            u8 lastScale{8};
+            for (u8 index : scan) {
+                u8 value{matrix[index]};
+                WriteSe(static_cast<i8>(value - lastScale));
+                lastScale = value;
+            }
+        }
+
+        /**
+         * @brief Writes the RBSP trailing bits and flushes the final byte
+         */
+        void End() {
+            WriteBit(true);
+            while (bitCount)
+                WriteBit(false);
+        }
+    };
+
+    /**
+     * @brief Writes the start code and header of a NAL unit
+     */
+    static void WriteNalHeader(BitWriter &writer, u8 type) {
+        writer.WriteU(1, 24);
+        writer.WriteU(0, 1); // forbidden_zero_bit
+        writer.WriteU(3, 2); // nal_ref_idc
+        writer.WriteU(type, 5);
+    }
+
+    constexpr std::array<u8, 16> ZigZagScan4x4{
+        0, 1, 4, 8, 5, 2, 3, 6, 9, 12, 13, 10, 7, 11, 14, 15,
+    };
+
+    constexpr std::array<u8, 64> ZigZagScan8x8{
+        0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+        12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+        35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+        58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    };
+
+    span<u8> H264::ComposeFrame(SMMU &smmu, u32 pictureInfoAddress, u32 bitstreamAddress) {
+        pictureInfo = smmu.Read<PictureInfo>(pictureInfoAddress);
+        const auto &params{pictureInfo.parameterSet};
+
+        frame.clear();
+        BitWriter writer{frame};
+
+        constexpr u8 NalTypeSps{7};
+        WriteNalHeader(writer, NalTypeSps);
+        writer.WriteU(100, 8); // profile_idc: High, this is a superset of all features NVDEC exposes
+        writer.WriteU(0, 8); // constraint_set_flags
+        writer.WriteU(31, 8); // level_idc
+        writer.WriteUe(0); // seq_parameter_set_id
+        writer.WriteUe(static_cast<u32>(params.chromaFormatIdc));
+        if (params.chromaFormatIdc == 3)
+            writer.WriteBit(false); // separate_colour_plane_flag
+        writer.WriteUe(0); // bit_depth_luma_minus8
+        writer.WriteUe(0); // bit_depth_chroma_minus8
+        writer.WriteBit(false); // qpprime_y_zero_transform_bypass_flag
+        writer.WriteBit(false); // seq_scaling_matrix_present_flag, the scaling matrices are supplied in the PPS instead
+        writer.WriteUe(static_cast<u32>(params.log2MaxFrameNumMinus4));
+        writer.WriteUe(static_cast<u32>(params.picOrderCntType));
+        if (params.picOrderCntType == 0) {
+            writer.WriteUe(static_cast<u32>(params.log2MaxPicOrderCntLsbMinus4));
+        } else if (params.picOrderCntType == 1) {
+            writer.WriteBit(params.deltaPicOrderAlwaysZeroFlag != 0);
+            writer.WriteSe(0); // offset_for_non_ref_pic
+            writer.WriteSe(0); // offset_for_top_to_bottom_field
+            writer.WriteUe(0); // num_ref_frames_in_pic_order_cnt_cycle
+        }
+        writer.WriteUe(16); // max_num_ref_frames, the guest manages the DPB so the maximum is always used
+        writer.WriteBit(false); // gaps_in_frame_num_value_allowed_flag
+        writer.WriteUe(params.picWidthInMbs - 1);
+        writer.WriteUe(params.frameHeightInMapUnits / (params.frameMbsOnlyFlag ? 1 : 2) - 1);
+        writer.WriteBit(params.frameMbsOnlyFlag != 0);
+        if (!params.frameMbsOnlyFlag)
+            writer.WriteBit(params.mbaffFrame);
+        writer.WriteBit(params.direct8x8Inference);
+        writer.WriteBit(false); // frame_cropping_flag
+        writer.WriteBit(false); // vui_parameters_present_flag
+        writer.End();
+
+        constexpr u8 NalTypePps{8};
+        WriteNalHeader(writer, NalTypePps);
+        writer.WriteUe(0); // pic_parameter_set_id
+        writer.WriteUe(0); // seq_parameter_set_id
+        writer.WriteBit(params.entropyCodingModeFlag != 0);
+        writer.WriteBit(params.picOrderPresentFlag != 0);
+        writer.WriteUe(0); // num_slice_groups_minus1
+        writer.WriteUe(static_cast<u32>(params.numRefIdxL0DefaultActive));
+        writer.WriteUe(static_cast<u32>(params.numRefIdxL1DefaultActive));
+        writer.WriteBit(params.weightedPred);
+        writer.WriteU(static_cast<u32>(params.weightedBipredIdc), 2);
+        writer.WriteSe(static_cast<i32>(params.picInitQpMinus26));
+        writer.WriteSe(0); // pic_init_qs_minus26
+        writer.WriteSe(static_cast<i32>(params.chromaQpIndexOffset));
+        writer.WriteBit(params.deblockingFilterControlPresentFlag != 0);
+        writer.WriteBit(params.constrainedIntraPred);
+        writer.WriteBit(params.redundantPicCntPresentFlag != 0);
+        writer.WriteBit(params.transform8x8ModeFlag != 0);
+        writer.WriteBit(true); // pic_scaling_matrix_present_flag
+        for (size_t list{}; list < 6; list++) {
+            writer.WriteBit(true); // pic_scaling_list_present_flag
+            writer.WriteScalingList(span{pictureInfo.weightScale}.subspan(list * ZigZagScan4x4.size(), ZigZagScan4x4.size()), ZigZagScan4x4);
+        }
+        if (params.transform8x8ModeFlag) {
+            for (size_t list{}; list < 2; list++) {
+                writer.WriteBit(true); // pic_scaling_list_present_flag
+                writer.WriteScalingList(span{pictureInfo.weightScale8x8}.subspan(list * ZigZagScan8x8.size(), ZigZagScan8x8.size()), ZigZagScan8x8);
+            }
+        }
+        writer.WriteSe(static_cast<i32>(params.secondChromaQpIndexOffset));
+        writer.End();
+
+        // The bitstream buffer already contains the slice NAL units with their start codes
+        size_t headerSize{frame.size()};
+        frame.resize(headerSize + pictureInfo.streamLength);
+        smmu.Read(frame.data() + headerSize, bitstreamAddress, pictureInfo.streamLength);
+
+        return frame;
+    }
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <soc/smmu.h>
+
+namespace skyline::soc::host1x::nvdec {
+    /**
+     * @brief Reconstructs an Annex B H.264 bitstream from the NVDEC state, the guest only supplies the slice data in the bitstream buffer while the parameter sets are supplied as fields of the picture info
+     * @url https://github.com/yuzu-emu/yuzu/blob/0b8f4a6/src/video_core/host1x/codecs/h264.h
+     */
+    class H264 {
+      public:
+        /**
+         * @brief The subset of the sequence and picture parameter sets that NVDEC requires
+         */
+        struct ParameterSet {
+            i32 log2MaxPicOrderCntLsbMinus4; //!< 0x00
+            i32 deltaPicOrderAlwaysZeroFlag; //!< 0x04
+            i32 frameMbsOnlyFlag; //!< 0x08
+            u32 picWidthInMbs; //!< 0x0C
+            u32 frameHeightInMapUnits; //!< 0x10
+            u32 surfaceFormat; //!< 0x14
+            u32 entropyCodingModeFlag; //!< 0x18
+            i32 picOrderPresentFlag; //!< 0x1C
+            i32 numRefIdxL0DefaultActive; //!< 0x20
+            i32 numRefIdxL1DefaultActive; //!< 0x24
+            i32 deblockingFilterControlPresentFlag; //!< 0x28
+            i32 redundantPicCntPresentFlag; //!< 0x2C
+            u32 transform8x8ModeFlag; //!< 0x30
+            u32 pitchLuma; //!< 0x34
+            u32 pitchChroma; //!< 0x38
+            u32 lumaTopOffset; //!< 0x3C
+            u32 lumaBottomOffset; //!< 0x40
+            u32 lumaFrameOffset; //!< 0x44
+            u32 chromaTopOffset; //!< 0x48
+            u32 chromaBottomOffset; //!< 0x4C
+            u32 chromaFrameOffset; //!< 0x50
+            u32 histBufferSize; //!< 0x54
+
+            struct {
+                u64 mbaffFrame : 1;
+                u64 direct8x8Inference : 1;
+                u64 weightedPred : 1;
+                u64 constrainedIntraPred : 1;
+                u64 refPic : 1;
+                u64 fieldPic : 1;
+                u64 bottomField : 1;
+                u64 secondField : 1;
+                u64 log2MaxFrameNumMinus4 : 4;
+                u64 chromaFormatIdc : 2;
+                u64 picOrderCntType : 2;
+                i64 picInitQpMinus26 : 6;
+                i64 chromaQpIndexOffset : 5;
+                i64 secondChromaQpIndexOffset : 5;
+                u64 weightedBipredIdc : 2;
+                u64 currPicIdx : 7; //!< The index of the surface the picture should be decoded into
+                u64 currColIdx : 5;
+                u64 frameNumber : 16;
+                u64 frameSurfaces : 1;
+                u64 outputMemoryLayout : 1;
+            }; //!< 0x58
+        };
+        static_assert(sizeof(ParameterSet) == 0x60);
+
+        struct PictureInfo {
+            u32 _pad0_[18];
+            u32 streamLength; //!< 0x48
+            u32 _pad1_[3];
+            ParameterSet parameterSet; //!< 0x58
+            u32 _pad2_[66];
+            std::array<u8, 0x60> weightScale; //!< 0x1C0
+            std::array<u8, 0x80> weightScale8x8; //!< 0x220
+        };
+        static_assert(sizeof(PictureInfo) == 0x2A0);
+
+      private:
+        std::vector<u8> frame; //!< The buffer the frame is composed into, this is reused across frames
+
+      public:
+        PictureInfo pictureInfo{}; //!< The picture info of the most recently composed frame
+
+        /**
+         * @brief Composes a frame from the picture info and bitstream at the supplied SMMU addresses
+         * @return A span of the frame which is valid until the next call
+         * @note The parameter sets are prepended to every frame as they may change at any point and are tiny in comparison to the slice data
+         */
+        span<u8> ComposeFrame(SMMU &smmu, u32 pictureInfoAddress, u32 bitstreamAddress);
+
+        /**
+         * @return The index of the output surface that the current frame is decoded into
+         */
+        u32 GetOutputSurfaceIndex() const {
+            return static_cast<u32>(pictureInfo.parameterSet.currPicIdx);
+        }
+
+        u32 GetWidth() const {
+            return pictureInfo.parameterSet.picWidthInMbs * 16;
+        }
+
+        u32 GetHeight() const {
+            return pictureInfo.parameterSet.frameHeightInMapUnits * 16; // NVDEC supplies the height in frame macroblocks regardless of field coding
+        }
+    };
+}
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <android/hardware_buffer.h>
+#include "media_codec.h"
+
+namespace skyline::soc::host1x::nvdec {
+    MediaCodecDecoder::MediaCodecDecoder(FrameCache &frameCache, std::string_view pMimeType, u32 width, u32 height) : frameCache{frameCache}, mimeType{pMimeType}, width{width}, height{height} {
+        // The decoded images are only ever sampled by the GPU so they can stay in an opaque layout which avoids any conversion by the codec
+        AImageReader *reader{};
+        if (auto result{AImageReader_newWithUsage(static_cast<i32>(width), static_cast<i32>(height), AIMAGE_FORMAT_PRIVATE, AHARDWAREBUFFER_USAGE_GPU_SAMPLED_IMAGE, MaxImages, &reader)}; result != AMEDIA_OK)
+            throw exception("Failed to create image reader for {}x{} video: {}", width, height, static_cast<i32>(result));
+        imageReader = std::shared_ptr<AImageReader>(reader, AImageReader_delete);
+
+        imageListener = {
+            .context = this,
+            .onImageAvailable = &OnImageAvailable,
+        };
+        AImageReader_setImageListener(reader, &imageListener);
+
+        ANativeWindow *window{};
+        AImageReader_getWindow(reader, &window);
+
+        codec = AMediaCodec_createDecoderByType(mimeType.c_str());
+        if (!codec)
+            throw exception("No decoder is available for '{}'", mimeType);
+
+        AMediaCodecOnAsyncNotifyCallback callback{
+            .onAsyncInputAvailable = &OnInputAvailable,
+            .onAsyncOutputAvailable = &OnOutputAvailable,
+            .onAsyncFormatChanged = &OnFormatChanged,
+            .onAsyncError = &OnError,
+        };
+        AMediaCodec_setAsyncNotifyCallback(codec, callback, this);
+
+        AMediaFormat *format{AMediaFormat_new()};
+        AMediaFormat_setString(format, AMEDIAFORMAT_KEY_MIME, mimeType.c_str());
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_WIDTH, static_cast<i32>(width));
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_HEIGHT, static_cast<i32>(height));
+        AMediaFormat_setInt32(format, "low-latency", 1); // The guest manages reordering itself, this is ignored by codecs that don't support it
+
+        media_status_t result{AMediaCodec_configure(codec, format, window, nullptr, 0)};
+        AMediaFormat_delete(format);
+        if (result != AMEDIA_OK || (result = AMediaCodec_start(codec)) != AMEDIA_OK) {
+            AMediaCodec_delete(codec);
+            throw exception("Failed to start decoder for '{}' at {}x{}: {}", mimeType, width, height, static_cast<i32>(result));
+        }
+
+        Logger::Info("Created {}x{} '{}' decoder", width, height, mimeType);
+    }
+
+    MediaCodecDecoder::~MediaCodecDecoder() {
+        // The reader may outlive the decoder due to frames still being held, so the listener must be cleared as it refers to the decoder
+        AImageReader_setImageListener(imageReader.get(), nullptr);
+
+        AMediaCodec_stop(codec);
+        AMediaCodec_delete(codec);
+    }
+
+    void MediaCodecDecoder::OnInputAvailable(AMediaCodec *, void *userdata, i32 index) {
+        auto decoder{static_cast<MediaCodecDecoder *>(userdata)};
+        {
+            std::scoped_lock lock{decoder->inputMutex};
+            decoder->inputBuffers.push(static_cast<size_t>(index));
+        }
+        decoder->inputCondition.notify_one();
+    }
+
+    void MediaCodecDecoder::OnOutputAvailable(AMediaCodec *codec, void *, i32 index, AMediaCodecBufferInfo *bufferInfo) {
+        // Rendering the buffer queues it to the image reader without any copies, empty buffers are only returned to the codec
+        AMediaCodec_releaseOutputBuffer(codec, static_cast<size_t>(index), bufferInfo->size != 0);
+    }
+
+    void MediaCodecDecoder::OnFormatChanged(AMediaCodec *, void *userdata, AMediaFormat *format) {
+        auto decoder{static_cast<MediaCodecDecoder *>(userdata)};
+        i32 outputWidth{}, outputHeight{};
+        AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_WIDTH, &outputWidth);
+        AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_HEIGHT, &outputHeight);
+        Logger::Debug("'{}' decoder output format changed: {}x{}", decoder->mimeType, outputWidth, outputHeight);
+    }
+
+    void MediaCodecDecoder::OnError(AMediaCodec *, void *userdata, media_status_t error, i32 actionCode, const char *detail) {
+        auto decoder{static_cast<MediaCodecDecoder *>(userdata)};
+        Logger::Warn("'{}' decoder error: {} (action: {}): {}", decoder->mimeType, static_cast<i32>(error), actionCode, detail ? detail : "");
+
+        constexpr i32 TransientActionCode{1}; //!< MediaCodec.CodecException.ACTION_TRANSIENT, the NDK only exposes a query for this from API 31 onwards
+        if (actionCode != TransientActionCode) {
+            {
+                std::scoped_lock lock{decoder->inputMutex};
+                decoder->errored = true;
+            }
+            decoder->inputCondition.notify_all();
+        }
+    }
+
+    void MediaCodecDecoder::OnImageAvailable(void *context, AImageReader *reader) {
+        auto decoder{static_cast<MediaCodecDecoder *>(context)};
+
+        AImage *image{};
+        if (auto result{AImageReader_acquireNextImage(reader, &image)}; result != AMEDIA_OK) {
+            Logger::Warn("Failed to acquire decoded image: {}", static_cast<i32>(result));
+            return;
+        }
+
+        i64 timestamp{};
+        AImage_getTimestamp(image, &timestamp);
+        auto frame{std::make_shared<DecodedFrame>(decoder->imageReader, image)};
+
+        u32 surface;
+        {
+            std::scoped_lock lock{decoder->frameMutex};
+
+            // The surface timestamp is the presentation timestamp of the input in nanoseconds, any earlier pending frames were dropped by the codec and can be discarded
+            auto pending{decoder->pendingSurfaces.find(static_cast<u64>(timestamp) / constant::NsInMicrosecond)};
+            if (pending == decoder->pendingSurfaces.end())
+                return;
+            surface = pending->second;
+            decoder->pendingSurfaces.erase(decoder->pendingSurfaces.begin(), std::next(pending));
+        }
+
+        decoder->frameCache.Insert(surface, std::move(frame));
+    }
+
+    bool MediaCodecDecoder::Decode(span<u8> frame, u32 lumaAddress) {
+        size_t index;
+        {
+            std::unique_lock lock{inputMutex};
+            if (!inputCondition.wait_for(lock, std::chrono::microseconds{InputTimeout}, [this] { return !inputBuffers.empty() || errored; }) || errored)
+                return false;
+
+            index = inputBuffers.front();
+            inputBuffers.pop();
+        }
+
+        size_t capacity{};
+        u8 *buffer{AMediaCodec_getInputBuffer(codec, index, &capacity)};
+        if (!buffer || capacity < frame.size()) {
+            Logger::Warn("Frame of 0x{:X} bytes exceeds the decoder's input buffer capacity of 0x{:X} bytes", frame.size(), capacity);
+            AMediaCodec_queueInputBuffer(codec, index, 0, 0, 0, 0);
+            return false;
+        }
+        std::memcpy(buffer, frame.data(), frame.size());
+
+        u64 timestamp;
+        {
+            std::scoped_lock lock{frameMutex};
+            timestamp = frameCounter++;
+            pendingSurfaces[timestamp] = lumaAddress;
+        }
+
+        return AMediaCodec_queueInputBuffer(codec, index, 0, frame.size(), timestamp, 0) == AMEDIA_OK;
+    }
+}
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <queue>
+#include <media/NdkMediaCodec.h>
+#include <soc/host1x/frame_cache.h>
+
+namespace skyline::soc::host1x::nvdec {
+    /**
+     * @brief A wrapper around an asynchronous AMediaCodec hardware decoder which outputs into an AImageReader surface
+     * @note Frames are submitted synchronously but decoded asynchronously, they're delivered into the frame cache once decoding has completed
+     */
+    class MediaCodecDecoder {
+      private:
+        static constexpr i32 MaxImages{8}; //!< The maximum amount of images that can be acquired from the image reader at once, this leaves headroom beyond the frames retained by the cache to acquire new images
+        static constexpr i64 InputTimeout{100'000}; //!< The maximum time to wait for an input buffer in microseconds, frames are dropped beyond this to avoid stalling the channel on a hung decoder
+
+        FrameCache &frameCache;
+        std::string mimeType;
+        u32 width;
+        u32 height;
+
+        AMediaCodec *codec{};
+        std::shared_ptr<AImageReader> imageReader; //!< The reader that the codec outputs into, this is shared with any decoded frames as they must be released prior to it
+        AImageReader_ImageListener imageListener;
+
+        std::mutex inputMutex;
+        std::condition_variable inputCondition;
+        std::queue<size_t> inputBuffers; //!< The indices of codec input buffers that are available for submission
+        bool errored{}; //!< If the codec has encountered an unrecoverable error, no further frames are submitted in this case
+
+        std::mutex frameMutex;
+        u64 frameCounter{}; //!< A monotonically increasing counter used as the presentation timestamp of frames to associate decoded images with their surfaces
+        std::map<u64, u32> pendingSurfaces; //!< A map from the presentation timestamp of submitted frames to the SMMU address of the luma surface they'll be decoded into
+
+        static void OnInputAvailable(AMediaCodec *codec, void *userdata, i32 index);
+
+        static void OnOutputAvailable(AMediaCodec *codec, void *userdata, i32 index, AMediaCodecBufferInfo *bufferInfo);
+
+        static void OnFormatChanged(AMediaCodec *codec, void *userdata, AMediaFormat *format);
+
+        static void OnError(AMediaCodec *codec, void *userdata, media_status_t error, i32 actionCode, const char *detail);
+
+        static void OnImageAvailable(void *context, AImageReader *reader);
+
+      public:
+        /**
+         * @param mimeType The MIME type of the codec, such as "video/avc"
+         */
+        MediaCodecDecoder(FrameCache &frameCache, std::string_view mimeType, u32 width, u32 height);
+
+        MediaCodecDecoder(const MediaCodecDecoder &) = delete;
+
+        MediaCodecDecoder &operator=(const MediaCodecDecoder &) = delete;
+
+        ~MediaCodecDecoder();
+
+        /**
+         * @return If this decoder can be used for frames with the supplied parameters
+         */
+        bool IsCompatible(std::string_view pMimeType, u32 pWidth, u32 pHeight) const {
+            return mimeType == pMimeType && width == pWidth && height == pHeight;
+        }
+
+        /**
+         * @brief Submits a frame for decoding, this returns once the bitstream has been copied into the codec's input buffer
+         * @param lumaAddress The SMMU address of the luma surface that the frame is decoded into, the decoded frame is inserted into the frame cache with this once it's available
+         * @return If the frame was submitted, this will fail if the codec has errored or doesn't return an input buffer in time
+         */
+        bool Decode(span<u8> frame, u32 lumaAddress);
+    };
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "vp8.h"
+
+namespace skyline::soc::host1x::nvdec {
+    span<u8> Vp8::ComposeFrame(SMMU &smmu, u32 pictureInfoAddress, u32 bitstreamAddress) {
+        pictureInfo = smmu.Read<PictureInfo>(pictureInfoAddress);
+
+        bool isKeyFrame{pictureInfo.keyFrame == 1};
+        size_t headerSize{isKeyFrame ? 10UL : 3UL};
+        frame.resize(headerSize + pictureInfo.vldBufferSize);
+
+        // The 3-byte frame tag consists of the frame type, version, show_frame flag and the 19-bit size of the first partition
+        u32 firstPartSize{pictureInfo.firstPartSize};
+        frame[0] = static_cast<u8>((isKeyFrame ? 0 : 1) | ((pictureInfo.version & 0b111) << 1) | (1 << 4) | ((firstPartSize & 0b111) << 5));
+        frame[1] = static_cast<u8>(firstPartSize >> 3);
+        frame[2] = static_cast<u8>(firstPartSize >> 11);
+
+        if (isKeyFrame) {
+            // Key frames have a start code followed by the 14-bit dimensions, the scaling bits are always zero as NVDEC doesn't expose them
+            frame[3] = 0x9D;
+            frame[4] = 0x01;
+            frame[5] = 0x2A;
+            frame[6] = static_cast<u8>(pictureInfo.frameWidth);
+            frame[7] = static_cast<u8>((pictureInfo.frameWidth >> 8) & 0x3F);
+            frame[8] = static_cast<u8>(pictureInfo.frameHeight);
+            frame[9] = static_cast<u8>((pictureInfo.frameHeight >> 8) & 0x3F);
+        }
+
+        smmu.Read(frame.data() + headerSize, bitstreamAddress, pictureInfo.vldBufferSize);
+        return frame;
+    }
+}
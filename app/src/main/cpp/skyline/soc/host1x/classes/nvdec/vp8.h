@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <soc/smmu.h>
+
+namespace skyline::soc::host1x::nvdec {
+    /**
+     * @brief Reconstructs a VP8 frame from the NVDEC state, the guest strips the uncompressed frame tag and key frame header from the bitstream and supplies their contents in the picture info instead
+     * @url https://datatracker.ietf.org/doc/html/rfc6386#section-9.1
+     */
+    class Vp8 {
+      public:
+        struct PictureInfo {
+            u32 _pad0_[14];
+            u16 frameWidth; //!< 0x38
+            u16 frameHeight; //!< 0x3A
+            u8 keyFrame; //!< 0x3C
+            u8 version; //!< 0x3D
+            u8 surfaceFormat; //!< 0x3E
+            u8 errorConcealOn; //!< 0x3F
+            u32 firstPartSize; //!< 0x40: The size of the first partition, this contains the frame header and the macroblock headers
+            u32 histBufferSize; //!< 0x44
+            u32 vldBufferSize; //!< 0x48: The size of the bitstream in bytes
+            std::array<u32, 2> frameStride; //!< 0x4C
+            u32 lumaTopOffset; //!< 0x54
+            u32 lumaBottomOffset; //!< 0x58
+            u32 lumaFrameOffset; //!< 0x5C
+            u32 chromaTopOffset; //!< 0x60
+            u32 chromaBottomOffset; //!< 0x64
+            u32 chromaFrameOffset; //!< 0x68
+            u32 _pad1_[7]; //!< 0x6C: NvdecDisplayParams
+            i8 currentOutputMemoryLayout; //!< 0x88
+            std::array<i8, 3> outputMemoryLayout; //!< 0x89
+            u8 segmentationFeatureDataUpdate; //!< 0x8C
+            u8 _pad2_[3];
+            u32 resultValue; //!< 0x90
+            std::array<u32, 8> partitionOffset; //!< 0x94
+            u32 _pad3_[3];
+        };
+        static_assert(sizeof(PictureInfo) == 0xC0);
+
+        /**
+         * @brief The indices of the surfaces used by VP8 in the NVDEC output surface registers
+         */
+        enum class SurfaceIndex : u32 {
+            Last = 0,
+            Golden = 1,
+            AltRef = 2,
+            Current = 3,
+        };
+
+      private:
+        std::vector<u8> frame; //!< The buffer the frame is composed into, this is reused across frames
+
+      public:
+        PictureInfo pictureInfo{}; //!< The picture info of the most recently composed frame
+
+        /**
+         * @brief Composes a frame from the picture info and bitstream at the supplied SMMU addresses
+         * @return A span of the frame which is valid until the next call
+         */
+        span<u8> ComposeFrame(SMMU &smmu, u32 pictureInfoAddress, u32 bitstreamAddress);
+
+        /**
+         * @return The index of the output surface that the current frame is decoded into
+         */
+        u32 GetOutputSurfaceIndex() const {
+            return static_cast<u32>(SurfaceIndex::Current);
+        }
+
+        u32 GetWidth() const {
+            return pictureInfo.frameWidth;
+        }
+
+        u32 GetHeight() const {
+            return pictureInfo.frameHeight;
+        }
+    };
+}
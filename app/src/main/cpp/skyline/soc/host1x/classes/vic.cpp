@@ -1,13 +1,99 @@
 // SPDX-License-Identifier: MPL-2.0
 // Copyright © 2021 Skyline Team and Contributors (https://github.com/skyline-emu/)
 
+#include <soc.h>
+#include <gpu.h>
+#include <gpu/interconnect/vic.h>
 #include "vic.h"
 
 namespace skyline::soc::host1x {
-    VicClass::VicClass(std::function<void()> opDoneCallback)
-        : opDoneCallback(std::move(opDoneCallback)) {}
+    VicClass::VicClass(const DeviceState &state, FrameCache &frameCache)
+        : state(state),
+          frameCache(frameCache) {}
+
+    VicClass::~VicClass() = default;
+
+    void VicClass::Execute() {
+        OutputConfig config{state.soc->smmu.Read<u64>((*registers.configStructOffset << 8) + OutputConfigOffset)};
+
+        gpu::texture::Format format;
+        switch (config.pixelFormat) {
+            case PixelFormat::Rgba8:
+            case PixelFormat::Rgbx8:
+                format = gpu::format::R8G8B8A8Unorm;
+                break;
+
+            case PixelFormat::Bgra8:
+                format = gpu::format::B8G8R8A8Unorm;
+                break;
+
+            default:
+                if (!loggedUnsupported) {
+                    Logger::Warn("Unimplemented VIC output format: 0x{:X}", static_cast<u64>(config.pixelFormat));
+                    loggedUnsupported = true;
+                }
+                return;
+        }
+
+        if (!state.gpu->traits.supportsAndroidHardwareBufferImport) {
+            if (!loggedUnsupported) {
+                Logger::Warn("Cannot composite decoded frames without AHardwareBuffer import support");
+                loggedUnsupported = true;
+            }
+            return;
+        }
+
+        auto frame{frameCache.Find(*registers.surfaceLumaOffset << 8)};
+        if (!frame)
+            return; // The decoder hasn't produced any frames yet, the output surface is left untouched
+
+        gpu::GuestTexture texture{};
+        texture.format = format;
+        texture.aspect = format->vkAspect;
+        texture.layerCount = 1;
+        texture.viewType = vk::ImageViewType::e2D;
+        texture.dimensions = gpu::texture::Dimensions{static_cast<u32>(config.widthMinus1 + 1), static_cast<u32>(config.heightMinus1 + 1), 1};
+        if (config.blockLinearKind)
+            texture.tileConfig = gpu::texture::TileConfig{
+                .mode = gpu::texture::TileMode::Block,
+                .blockHeight = static_cast<u8>(1U << config.blockLinearHeightLog2),
+                .blockDepth = 1,
+            };
+        else
+            texture.tileConfig = gpu::texture::TileConfig{
+                .mode = gpu::texture::TileMode::Pitch,
+                .pitch = texture.dimensions.width * format->bpb,
+            };
+
+        auto mappings{state.soc->smmu.TranslateRange(*registers.outputSurfaceLumaOffset << 8, static_cast<u32>(texture.GetSize()))};
+        texture.mappings.assign(mappings.begin(), mappings.end());
+
+        if (!vic)
+            vic = std::make_unique<gpu::interconnect::Vic>(state);
+
+        try {
+            vic->Composite(frame, texture);
+        } catch (const std::exception &e) {
+            Logger::Warn("Failed to composite decoded frame: {}", e.what());
+        }
+    }
 
     void VicClass::CallMethod(u32 method, u32 argument) {
-        Logger::Warn("Unknown VIC class method called: 0x{:X} argument: 0x{:X}", method, argument);
+        if (method >= Registers::RegisterCount) [[unlikely]] {
+            Logger::Warn("Unknown VIC class method called: 0x{:X} argument: 0x{:X}", method, argument);
+            return;
+        }
+
+        registers.raw[method] = argument;
+
+        if (method == ExecuteMethodId)
+            Execute();
+    }
+
+    void VicClass::Signal(std::function<void()> &&callback) {
+        if (vic)
+            vic->Signal(std::move(callback));
+        else
+            callback();
     }
 }
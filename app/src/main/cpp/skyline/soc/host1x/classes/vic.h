@@ -4,18 +4,91 @@
 #pragma once
 
 #include <common.h>
+#include <soc/host1x/frame_cache.h>
+
+namespace skyline::gpu::interconnect {
+    class Vic;
+}
 
 namespace skyline::soc::host1x {
     /**
      * @brief The VIC Host1x class implements hardware accelerated image operations
+     * @note Only compositing a single decoded frame into an RGB output surface is implemented, this is performed on the GPU
      */
     class VicClass {
       private:
-        std::function<void()> opDoneCallback;
+        const DeviceState &state;
+        FrameCache &frameCache;
+
+        /**
+         * @note All offsets are in the SMMU address space in units of 0x100 bytes
+         * @url https://github.com/yuzu-emu/yuzu/blob/0b8f4a6/src/video_core/host1x/vic.h
+         */
+        union Registers {
+            static constexpr size_t RegisterCount{0x200};
+
+            std::array<u32, RegisterCount> raw;
+
+            template<size_t Offset, typename Type>
+            using Register = util::OffsetMember<Offset, Type, u32>;
+
+            Register<0xC0, u32> execute; //!< Composites the output surface with the current state when written to
+            Register<0x100, u32> surfaceLumaOffset; //!< The luma offset of the first surface in the first slot, this is the only source that's supported
+            Register<0x1C1, u32> controlParams;
+            Register<0x1C2, u32> configStructOffset;
+            Register<0x1C8, u32> outputSurfaceLumaOffset;
+            Register<0x1C9, u32> outputSurfaceChromaOffset;
+        } registers{};
+        static_assert(sizeof(Registers) == sizeof(u32) * Registers::RegisterCount);
+
+        static constexpr u32 ExecuteMethodId{0xC0};
+
+        enum class PixelFormat : u64 {
+            Rgba8 = 0x1F,
+            Bgra8 = 0x20,
+            Rgbx8 = 0x23,
+            Yuv420 = 0x44,
+        };
+
+        /**
+         * @brief The output surface configuration within the config struct
+         */
+        union OutputConfig {
+            u64 raw;
+            struct {
+                PixelFormat pixelFormat : 7;
+                u64 chromaLocationHorizontal : 2;
+                u64 chromaLocationVertical : 2;
+                u64 blockLinearKind : 4; //!< 0 for pitch-linear surfaces, block-linear otherwise
+                u64 blockLinearHeightLog2 : 4; //!< The height of a block in GOBs in log2
+                u64 _pad0_ : 13;
+                u64 widthMinus1 : 14;
+                u64 heightMinus1 : 14;
+                u64 _pad1_ : 4;
+            };
+        };
+        static_assert(sizeof(OutputConfig) == sizeof(u64));
+
+        static constexpr u32 OutputConfigOffset{0x20}; //!< The offset of the output surface configuration in the config struct
+
+        std::unique_ptr<gpu::interconnect::Vic> vic; //!< The GPU compositor, this is created on the first composition as most channels never use VIC
+        bool loggedUnsupported{}; //!< If an unsupported composition has been logged, this avoids spamming the log for every frame
+
+        /**
+         * @brief Composites the output surface using the current register state
+         */
+        void Execute();
 
       public:
-        VicClass(std::function<void()> opDoneCallback);
+        VicClass(const DeviceState &state, FrameCache &frameCache);
+
+        ~VicClass();
 
         void CallMethod(u32 method, u32 argument);
+
+        /**
+         * @brief Calls the supplied callback once all previously issued operations have completed, compositions are only complete once the GPU has finished executing them
+         */
+        void Signal(std::function<void()> &&callback);
     };
 }
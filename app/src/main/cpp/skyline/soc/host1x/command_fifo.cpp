@@ -45,7 +45,13 @@ namespace skyline::soc::host1x {
     };
     static_assert(sizeof(ChannelCommandFifoMethodHeader) == sizeof(u32));
 
-    ChannelCommandFifo::ChannelCommandFifo(const DeviceState &state, SyncpointSet &syncpoints) : state(state), gatherQueue(GatherQueueSize), host1XClass(syncpoints), nvDecClass(syncpoints), vicClass(syncpoints) {}
+    ChannelCommandFifo::ChannelCommandFifo(const DeviceState &state, SyncpointSet &syncpoints, FrameCache &frameCache)
+        : state(state),
+          gatherQueue(GatherQueueSize),
+          jobQueue(JobQueueSize),
+          host1XClass(syncpoints),
+          nvDecClass(syncpoints, [this](std::function<void()> &&job) { jobQueue.Push(job); }, state, frameCache),
+          vicClass(syncpoints, [this](std::function<void()> &&job) { jobQueue.Push(job); }, state, frameCache) {}
 
     void ChannelCommandFifo::Send(ClassId targetClass, u32 method, u32 argument) {
         Logger::Verbose("Calling method in class: 0x{:X}, method: 0x{:X}, argument: 0x{:X}", targetClass, method, argument);
@@ -104,27 +110,30 @@ namespace skyline::soc::host1x {
                     throw exception("Unimplemented Host1x command FIFO opcode: 0x{:X}", static_cast<u8>(methodHeader.opcode));
             }
         }
+
+        nvDecClass.Flush();
+        vicClass.Flush();
     }
 
     void ChannelCommandFifo::Start() {
         std::scoped_lock lock(threadStartMutex);
 
-        if (!thread.joinable())
+        if (!thread.joinable()) {
+            jobThread = std::thread(&ChannelCommandFifo::RunJobs, this);
             thread = std::thread(&ChannelCommandFifo::Run, this);
+        }
     }
 
-    void ChannelCommandFifo::Run() {
-        if (int result{pthread_setname_np(pthread_self(), "ChannelCmdFifo")})
+    template<typename Function>
+    void ChannelCommandFifo::RunThread(const char *name, Function &&function) {
+        if (int result{pthread_setname_np(pthread_self(), name)})
             Logger::Warn("Failed to set the thread name: {}", strerror(result));
 
         try {
             signal::SetSignalHandler({SIGINT, SIGILL, SIGTRAP, SIGBUS, SIGFPE}, signal::ExceptionalSignalHandler);
             signal::SetSignalHandler({SIGSEGV}, nce::NCE::HostSignalHandler); // We may access NCE trapped memory
 
-            gatherQueue.Process([this](span<u32> gather) {
-                Logger::Debug("Processing pushbuffer: 0x{:X}, size: 0x{:X}", gather.data(), gather.size());
-                Process(gather);
-            }, [] {});
+            function();
         } catch (const signal::SignalException &e) {
             if (e.signal != SIGINT) {
                 Logger::Error("{}\nStack Trace:{}", e.what(), state.loader->GetStackTrace(e.frames));
@@ -145,6 +154,23 @@ namespace skyline::soc::host1x {
         }
     }
 
+    void ChannelCommandFifo::Run() {
+        RunThread("ChannelCmdFifo", [this]() {
+            gatherQueue.Process([this](span<u32> gather) {
+                Logger::Debug("Processing pushbuffer: 0x{:X}, size: 0x{:X}", gather.data(), gather.size());
+                Process(gather);
+            }, [] {});
+        });
+    }
+
+    void ChannelCommandFifo::RunJobs() {
+        RunThread("ChannelClass", [this]() {
+            jobQueue.Process([](const std::function<void()> &job) {
+                job();
+            }, [] {});
+        });
+    }
+
     void ChannelCommandFifo::Push(span<u32> gather) {
         gatherQueue.Push(gather);
     }
@@ -154,5 +180,10 @@ namespace skyline::soc::host1x {
             pthread_kill(thread.native_handle(), SIGINT);
             thread.join();
         }
+
+        if (jobThread.joinable()) {
+            pthread_kill(jobThread.native_handle(), SIGINT);
+            jobThread.join();
+        }
     }
 }
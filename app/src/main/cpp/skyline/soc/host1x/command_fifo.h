@@ -6,6 +6,7 @@
 #include <common.h>
 #include <common/circular_queue.h>
 #include "syncpoint.h"
+#include "frame_cache.h"
 #include "classes/class.h"
 #include "classes/host1x.h"
 #include "classes/nvdec.h"
@@ -24,7 +25,11 @@ namespace skyline::soc::host1x {
         static constexpr size_t GatherQueueSize{0x1000}; //!< Maximum size of the gather queue, this value is arbritary
         CircularQueue<span<u32>> gatherQueue;
         std::thread thread; //!< The thread that manages processing of pushbuffers within gathers
-        std::mutex threadStartMutex; //!< Protects the thread from being started multiple times
+        std::mutex threadStartMutex; //!< Protects the threads from being started multiple times
+
+        static constexpr size_t JobQueueSize{0x400}; //!< Maximum size of the class job queue, this value is arbritary
+        CircularQueue<std::function<void()>> jobQueue; //!< Batches of class methods which are executed in order on the class thread
+        std::thread jobThread; //!< The thread that executes class jobs, this allows the FIFO to keep processing gathers while classes are busy
 
         Host1xClass host1XClass; //!< The internal Host1x class, used for performing syncpoint waits and other general operations
         TegraHostInterface<NvDecClass> nvDecClass; //!< The THI wrapped NVDEC class for video decoding
@@ -40,18 +45,29 @@ namespace skyline::soc::host1x {
          */
         void Process(span<u32> gather);
 
+        /**
+         * @brief Sets up the calling thread for FIFO processing and runs the supplied function, handling any exceptions it throws
+         */
+        template<typename Function>
+        void RunThread(const char *name, Function &&function);
+
         /**
          * @brief Executes all pending gathers in the FIFO and polls for more
          */
         void Run();
 
+        /**
+         * @brief Executes all pending class jobs and polls for more
+         */
+        void RunJobs();
+
       public:
-        ChannelCommandFifo(const DeviceState &state, SyncpointSet &syncpoints);
+        ChannelCommandFifo(const DeviceState &state, SyncpointSet &syncpoints, FrameCache &frameCache);
 
         ~ChannelCommandFifo();
 
         /**
-         * @brief Starts the pushbuffer processing thread if it hasn't already been started
+         * @brief Starts the pushbuffer processing and class threads if they haven't already been started
          */
         void Start();
 
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "frame_cache.h"
+
+namespace skyline::soc::host1x {
+    DecodedFrame::DecodedFrame(std::shared_ptr<AImageReader> pImageReader, AImage *image) : imageReader{std::move(pImageReader)}, image{image} {
+        i32 imageWidth{}, imageHeight{};
+        AImage_getHardwareBuffer(image, &hardwareBuffer);
+        AImage_getWidth(image, &imageWidth);
+        AImage_getHeight(image, &imageHeight);
+        width = static_cast<u32>(imageWidth);
+        height = static_cast<u32>(imageHeight);
+
+        if (AImage_getCropRect(image, &cropRect) != AMEDIA_OK)
+            cropRect = {0, 0, imageWidth, imageHeight};
+    }
+
+    DecodedFrame::~DecodedFrame() {
+        AImage_delete(image);
+    }
+
+    void FrameCache::Insert(u32 lumaAddress, std::shared_ptr<DecodedFrame> frame) {
+        std::scoped_lock lock{mutex};
+
+        frames[lumaAddress] = std::move(frame);
+        std::erase(frameOrder, lumaAddress);
+        frameOrder.push_back(lumaAddress);
+        while (frameOrder.size() > MaxFrameCount) {
+            frames.erase(frameOrder.front());
+            frameOrder.pop_front();
+        }
+    }
+
+    std::shared_ptr<DecodedFrame> FrameCache::Find(u32 lumaAddress) {
+        std::scoped_lock lock{mutex};
+
+        if (auto it{frames.find(lumaAddress)}; it != frames.end())
+            return it->second;
+
+        // Guests may composite from surfaces that don't directly correspond to the decoder's output, falling back to the latest frame is accurate for typical video playback
+        return frameOrder.empty() ? nullptr : frames[frameOrder.back()];
+    }
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <deque>
+#include <media/NdkImageReader.h>
+#include <common.h>
+
+namespace skyline::soc::host1x {
+    /**
+     * @brief A decoded frame in an AHardwareBuffer, this can be imported directly by Vulkan without any copies
+     */
+    struct DecodedFrame {
+        std::shared_ptr<AImageReader> imageReader; //!< The reader the image was acquired from, this must outlive the image
+        AImage *image; //!< The image that owns the hardware buffer, the buffer is returned to the image reader when this is destroyed
+        AHardwareBuffer *hardwareBuffer;
+        u32 width;
+        u32 height;
+        AImageCropRect cropRect; //!< The region of the image that contains the picture, decoders may pad the image beyond this
+
+        DecodedFrame(std::shared_ptr<AImageReader> imageReader, AImage *image);
+
+        DecodedFrame(const DecodedFrame &) = delete;
+
+        DecodedFrame &operator=(const DecodedFrame &) = delete;
+
+        ~DecodedFrame();
+    };
+
+    /**
+     * @brief A cache of frames decoded by NVDEC that's shared between all channels, frames are keyed by the SMMU address of the luma surface they would be decoded into on hardware so VIC can look them up using its source surfaces
+     */
+    class FrameCache {
+      private:
+        static constexpr size_t MaxFrameCount{6}; //!< The maximum amount of frames that are retained, this must be lower than the amount of images a decoder can have acquired at once
+
+        std::mutex mutex;
+        std::unordered_map<u32, std::shared_ptr<DecodedFrame>> frames;
+        std::deque<u32> frameOrder; //!< The order that surfaces in `frames` were decoded in, this is used to evict the oldest frames
+
+      public:
+        /**
+         * @brief Inserts a frame for the supplied luma surface, replacing any prior frame decoded into it
+         */
+        void Insert(u32 lumaAddress, std::shared_ptr<DecodedFrame> frame);
+
+        /**
+         * @return The last frame decoded into the supplied luma surface or if there's no such frame then the most recently decoded frame, this is nullptr if no frames have been decoded
+         */
+        std::shared_ptr<DecodedFrame> Find(u32 lumaAddress);
+    };
+}
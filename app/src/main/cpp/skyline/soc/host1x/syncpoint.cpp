@@ -5,6 +5,45 @@
 #include "syncpoint.h"
 
 namespace skyline::soc::host1x {
+    void Syncpoint::PushWaiter(u32 threshold, u64 id, std::function<void()> callback) {
+        waiters.emplace_back(threshold, id, std::move(callback));
+        std::push_heap(waiters.begin(), waiters.end(), CompareWaiters);
+        UpdateNextThreshold();
+    }
+
+    void Syncpoint::RemoveWaiter(u64 id) {
+        auto it{std::find_if(waiters.begin(), waiters.end(), [id](const Waiter &waiter) { return waiter.id == id; })};
+        if (it != waiters.end()) {
+            waiters.erase(it);
+            std::make_heap(waiters.begin(), waiters.end(), CompareWaiters);
+            UpdateNextThreshold();
+        }
+    }
+
+    void Syncpoint::UpdateNextThreshold() {
+        // This is sequentially consistent to pair with the increment, which guarantees that either the incrementing thread observes the new threshold or the registering thread observes the new value
+        nextThreshold.store(waiters.empty() ? std::numeric_limits<u32>::max() : waiters.front().threshold, std::memory_order_seq_cst);
+    }
+
+    void Syncpoint::SignalWaiters() {
+        u32 currentValue{value.load(std::memory_order_seq_cst)};
+        bool signalCondition{};
+        while (!waiters.empty() && currentValue >= waiters.front().threshold) {
+            std::pop_heap(waiters.begin(), waiters.end(), CompareWaiters);
+            auto &waiter{waiters.back()};
+            if (waiter.callback)
+                waiter.callback();
+            else
+                signalCondition = true;
+            waiters.pop_back();
+        }
+
+        UpdateNextThreshold();
+
+        if (signalCondition)
+            incrementCondition.notify_all();
+    }
+
     Syncpoint::WaiterHandle Syncpoint::RegisterWaiter(u32 threshold, const std::function<void()> &callback) {
         if (value.load(std::memory_order_acquire) >= threshold) {
             // (Fast path) We don't need to wait on the mutex and can just get away with atomics
@@ -13,49 +52,35 @@ namespace skyline::soc::host1x {
         }
 
         std::scoped_lock lock(mutex);
-        if (value.load(std::memory_order_acquire) >= threshold) {
-            callback();
+        u64 id{nextWaiterId++};
+        PushWaiter(threshold, id, callback);
+
+        // An increment which occurred prior to the threshold being published won't have signalled the waiter, so it has to be done here
+        if (value.load(std::memory_order_seq_cst) >= threshold) {
+            SignalWaiters();
             return {};
         }
 
-        auto it{waiters.begin()};
-        while (it != waiters.end() && threshold >= it->threshold)
-            it++;
-        return waiters.emplace(it, threshold, callback);
+        return id;
     }
 
     void Syncpoint::DeregisterWaiter(WaiterHandle waiter) {
+        if (!waiter)
+            return;
+
         std::scoped_lock lock(mutex);
-        // We want to ensure the iterator still exists prior to erasing it
-        // Otherwise, if an invalid iterator was passed in then it could lead to UB
-        // It is important to avoid UB in that case since the deregister isn't called from a locked context
-        for (auto it{waiters.begin()}; it != waiters.end(); it++) {
-            if (it == waiter) {
-                waiters.erase(it);
-                return;
-            }
-        }
+        RemoveWaiter(waiter); // The waiter may have already been signalled and removed, in which case this does nothing
     }
 
     u32 Syncpoint::Increment() {
-        auto readValue{value.fetch_add(1, std::memory_order_acq_rel) + 1}; // We don't want to constantly do redundant atomic loads
+        auto readValue{value.fetch_add(1, std::memory_order_seq_cst) + 1}; // We don't want to constantly do redundant atomic loads
 
-        std::scoped_lock lock(mutex);
-        bool signalCondition{};
-        auto it{waiters.begin()};
-        while (it != waiters.end() && readValue >= it->threshold) {
-            auto &waiter{*it};
-            if (waiter.callback)
-                waiter.callback();
-            else
-                signalCondition = true;
-            it++;
-        }
+        // (Fast path) No waiter can have been reached by this increment so the mutex doesn't need to be locked
+        if (readValue < nextThreshold.load(std::memory_order_seq_cst))
+            return readValue;
 
-        waiters.erase(waiters.begin(), it);
-
-        if (signalCondition)
-            incrementCondition.notify_all();
+        std::scoped_lock lock(mutex);
+        SignalWaiters();
 
         return readValue;
     }
@@ -63,20 +88,28 @@ namespace skyline::soc::host1x {
     bool Syncpoint::Wait(u32 threshold, std::chrono::steady_clock::duration timeout) {
         if (value.load(std::memory_order_acquire) >= threshold)
             // (Fast Path) We don't need to wait on the mutex and can just get away with atomics
-            return {};
+            return true;
 
         std::unique_lock lock(mutex);
-        auto it{waiters.begin()};
-        while (it != waiters.end() && threshold >= it->threshold)
-            it++;
-        waiters.emplace(it, threshold, nullptr);
+        u64 id{nextWaiterId++};
+        PushWaiter(threshold, id, nullptr);
+
+        if (value.load(std::memory_order_seq_cst) >= threshold) {
+            SignalWaiters();
+            return true;
+        }
 
         if (timeout == std::chrono::steady_clock::duration::max()) {
             incrementCondition.wait(lock, [&] { return value.load(std::memory_order_relaxed) >= threshold; });
             return true;
-        } else {
-            return incrementCondition.wait_for(lock, timeout, [&] { return value.load(std::memory_order_relaxed) >= threshold; });
         }
+
+        if (!incrementCondition.wait_for(lock, timeout, [&] { return value.load(std::memory_order_relaxed) >= threshold; })) {
+            // Timed out waiters are removed immediately as they'd otherwise force every increment onto the slow path until their threshold is reached
+            RemoveWaiter(id);
+            return false;
+        }
+
+        return true;
     }
 }
-
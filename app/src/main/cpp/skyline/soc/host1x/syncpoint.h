@@ -5,6 +5,7 @@
 #pragma once
 
 #include <common.h>
+#include <common/spin_lock.h>
 
 namespace skyline::soc::host1x {
     constexpr size_t SyncpointCount{192}; //!< The number of host1x syncpoints on T210
@@ -15,17 +16,51 @@ namespace skyline::soc::host1x {
     class Syncpoint {
       private:
         std::atomic<u32> value{}; //!< An atomically-incrementing counter at the core of a syncpoint
+        std::atomic<u32> nextThreshold{std::numeric_limits<u32>::max()}; //!< The lowest threshold of any waiter, increments to values below this don't need to lock the mutex
 
-        std::mutex mutex; //!< Synchronizes insertions and deletions of waiters alongside locking the increment condition
-        std::condition_variable incrementCondition; //!< Signalled on thresholds for waiters which are tied to Wait(...)
+        AdaptiveMutex mutex; //!< Synchronizes insertions and deletions of waiters alongside locking the increment condition
+        std::condition_variable_any incrementCondition; //!< Signalled on thresholds for waiters which are tied to Wait(...)
 
         struct Waiter {
             u32 threshold; //!< The syncpoint value to wait on to be reached
+            u64 id; //!< A unique identifier for the waiter which is used as its handle
             std::function<void()> callback; //!< The callback to do after the wait has ended, refers to cvar signal when nullptr
 
-            Waiter(u32 threshold, std::function<void()> callback) : threshold(threshold), callback(std::move(callback)) {}
+            Waiter(u32 threshold, u64 id, std::function<void()> callback) : threshold(threshold), id(id), callback(std::move(callback)) {}
         };
-        std::list<Waiter> waiters; //!< A linked list of all waiters, it's sorted in ascending order by threshold
+        std::vector<Waiter> waiters; //!< A min-heap of all waiters ordered by threshold, this allows the lowest threshold to be retrieved and removed in logarithmic time
+        u64 nextWaiterId{1}; //!< The ID of the next waiter, 0 is reserved for representing an invalid handle
+
+        /**
+         * @brief The comparison for the waiter heap, this is inverted as the standard heap algorithms create max-heaps
+         */
+        static bool CompareWaiters(const Waiter &lhs, const Waiter &rhs) {
+            return lhs.threshold > rhs.threshold;
+        }
+
+        /**
+         * @brief Inserts a waiter into the heap and publishes the new lowest threshold
+         * @note The mutex **must** be locked when calling this
+         */
+        void PushWaiter(u32 threshold, u64 id, std::function<void()> callback);
+
+        /**
+         * @brief Removes the waiter with the supplied ID from the heap if it's present
+         * @note The mutex **must** be locked when calling this
+         */
+        void RemoveWaiter(u64 id);
+
+        /**
+         * @brief Publishes the threshold of the waiter at the top of the heap, this must be called after any modification of the heap
+         * @note The mutex **must** be locked when calling this
+         */
+        void UpdateNextThreshold();
+
+        /**
+         * @brief Signals and removes all waiters with thresholds that have been reached by the current value
+         * @note The mutex **must** be locked when calling this
+         */
+        void SignalWaiters();
 
       public:
         /**
@@ -35,22 +70,23 @@ namespace skyline::soc::host1x {
             return value.load(std::memory_order_acquire);
         }
 
-        using WaiterHandle = decltype(waiters)::iterator; //!< Aliasing an iterator to a Waiter as an opaque handle
+        using WaiterHandle = u64; //!< An opaque handle to a waiter, this is 0 for waiters that were signalled immediately
 
         /**
          * @brief Registers a new waiter with a callback that will be called when the syncpoint reaches the target threshold
          * @note The callback will be called immediately if the syncpoint has already reached the given threshold
-         * @return A handle that can be used to deregister the waiter, its boolean operator will evaluate to false if the threshold has already been reached
+         * @return A handle that can be used to deregister the waiter, it will evaluate to false if the threshold has already been reached
          */
         WaiterHandle RegisterWaiter(u32 threshold, const std::function<void()> &callback);
 
         /**
-         * @note If the supplied handle is invalid then the function will do nothing
+         * @note If the supplied handle is invalid or the waiter has already been signalled then the function will do nothing
          */
         void DeregisterWaiter(WaiterHandle waiter);
 
         /**
          * @return The new value of the syncpoint after the increment
+         * @note This doesn't lock the mutex unless a waiter's threshold has been reached
          */
         u32 Increment();
 
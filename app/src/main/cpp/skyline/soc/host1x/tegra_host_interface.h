@@ -3,7 +3,6 @@
 
 #pragma once
 
-#include <queue>
 #include <common.h>
 #include "syncpoint.h"
 #include "classes/class.h"
@@ -11,39 +10,53 @@
 namespace skyline::soc::host1x {
     /**
      * @brief The 'Tegra Host Interface' or THI sits inbetween the Host1x and the class falcons, implementing syncpoint queueing and a method interface
+     * @note Methods are batched and submitted as a single job which is executed asynchronously to the command FIFO, OpDone syncpoint increments are only signalled once the class has completed all operations issued prior to them
      */
     template<typename ClassType>
     class TegraHostInterface {
       private:
         SyncpointSet &syncpoints;
         ClassType deviceClass; //!< The device class behind the THI, such as NVDEC or VIC
+        std::function<void(std::function<void()> &&)> submitJob; //!< Queues a job to be executed on the class thread of the channel
 
         u32 storedMethod{}; //!< Method that will be used for deviceClass.CallMethod, set using Method0
 
-        std::queue<u32> incrQueue; //!< Queue of syncpoint IDs to be incremented when a device operation is finished, the same syncpoint may be held multiple times within the queue
-        std::mutex incrMutex;
+        std::vector<std::pair<u32, u32>> pendingMethods; //!< Methods that have been called since the last job was submitted alongside their arguments
 
-        void AddIncr(u32 syncpointId) {
-            std::scoped_lock lock(incrMutex);
-            incrQueue.push(syncpointId);
-        }
-
-        void SubmitPendingIncrs() {
-            std::scoped_lock lock(incrMutex);
+        /**
+         * @brief Submits a job that calls all pending methods on the device class followed by the supplied syncpoint increment
+         */
+        void SubmitJob(std::optional<IncrementSyncpointMethod> incrSyncpoint = std::nullopt) {
+            submitJob([this, methods = std::exchange(pendingMethods, {}), incrSyncpoint]() {
+                for (auto [method, argument] : methods)
+                    deviceClass.CallMethod(method, argument);
 
-            while (!incrQueue.empty()) {
-                u32 syncpointId{incrQueue.front()};
-                incrQueue.pop();
+                if (!incrSyncpoint)
+                    return;
 
-                Logger::Debug("Increment syncpoint: {}", syncpointId);
-                syncpoints.at(syncpointId).Increment();
-            }
+                u32 syncpointId{incrSyncpoint->index};
+                if (incrSyncpoint->condition == IncrementSyncpointMethod::Condition::OpDone) {
+                    deviceClass.Signal([this, syncpointId] {
+                        Logger::Debug("Increment syncpoint for OpDone: {}", syncpointId);
+                        syncpoints.at(syncpointId).Increment();
+                    });
+                } else {
+                    Logger::Debug("Increment syncpoint: {}", syncpointId);
+                    syncpoints.at(syncpointId).Increment();
+                }
+            });
         }
 
       public:
-        TegraHostInterface(SyncpointSet &syncpoints)
-            : deviceClass([&] { SubmitPendingIncrs(); }),
-              syncpoints(syncpoints) {}
+        /**
+         * @param submitJob A function which queues the supplied job for asynchronous in-order execution
+         * @param args Any arguments that are passed to the device class
+         */
+        template<typename... Args>
+        TegraHostInterface(SyncpointSet &syncpoints, std::function<void(std::function<void()> &&)> submitJob, Args &&... args)
+            : syncpoints(syncpoints),
+              deviceClass(std::forward<Args>(args)...),
+              submitJob(std::move(submitJob)) {}
 
         void CallMethod(u32 method, u32 argument)  {
             constexpr u32 Method0MethodId{0x10}; //!< Sets the method to be called on the device class upon a call to Method1, see TRM '15.5.6 NV_PVIC_THI_METHOD0'
@@ -55,13 +68,10 @@ namespace skyline::soc::host1x {
 
                     switch (incrSyncpoint.condition) {
                         case IncrementSyncpointMethod::Condition::Immediate:
-                            Logger::Debug("Increment syncpoint: {}", incrSyncpoint.index);
-                            syncpoints.at(incrSyncpoint.index).Increment();
-                            break;
                         case IncrementSyncpointMethod::Condition::OpDone:
-                            Logger::Debug("Queue syncpoint for OpDone: {}", incrSyncpoint.index);
-                            AddIncr(incrSyncpoint.index);
-                            SubmitPendingIncrs(); // FIXME: immediately submit the incrs as classes are not yet implemented
+                            Logger::Debug("Queue syncpoint increment: {} (condition: {})", incrSyncpoint.index, static_cast<u8>(incrSyncpoint.condition));
+                            // Immediate increments still have to be ordered after the methods preceding them, so both kinds terminate the current batch
+                            SubmitJob(incrSyncpoint);
                             break;
                         default:
                             Logger::Warn("Unimplemented syncpoint condition: {}", static_cast<u8>(incrSyncpoint.condition));
@@ -73,12 +83,20 @@ namespace skyline::soc::host1x {
                     storedMethod = argument;
                     break;
                 case Method1MethodId:
-                    deviceClass.CallMethod(storedMethod, argument);
+                    pendingMethods.emplace_back(storedMethod, argument);
                     break;
                 default:
                     Logger::Error("Unknown THI method called: 0x{:X}, argument: 0x{:X}", method, argument);
                     break;
             }
         }
+
+        /**
+         * @brief Submits any pending methods as a job, this should be called after a gather has been processed so methods aren't delayed indefinitely
+         */
+        void Flush() {
+            if (!pendingMethods.empty())
+                SubmitJob();
+        }
     };
 }
@@ -10,12 +10,13 @@ struct AAsset; //!< https://developer.android.com/ndk/reference/group/asset#aass
 namespace skyline::vfs {
     /**
      * @brief The AndroidAssetBacking class provides the backing abstractions for the AAsset Android API
-     * @note This is NOT thread safe NOR should it be shared across threads.
+     * @note Reads are serialized as the AAsset API only supports seeking and reading as separate calls
      * @note This will take ownership of the backing asset passed into it
      */
     class AndroidAssetBacking : public Backing {
       private:
         AAsset *asset; //!< The NDK AAsset object we abstract
+        std::mutex mutex; //!< Synchronizes the asset's position between seeking and reading
 
       protected:
         size_t ReadImpl(span<u8> output, size_t offset) override;
@@ -22,6 +22,12 @@ namespace skyline::vfs {
             throw exception("This backing does not support being resized");
         }
 
+        virtual void PrefetchImpl(size_t offset, size_t pSize) {}
+
+        virtual span<const u8> ViewImpl(size_t offset, size_t pSize) {
+            return {};
+        }
+
       public:
         union Mode {
             struct {
@@ -132,6 +138,27 @@ namespace skyline::vfs {
                 Logger::Warn("Object wasn't written fully into output backing: {}/{}", lSize, sizeof(T));
         }
 
+        /**
+         * @brief Gets a zero-copy view of a region of the backing, this is only supported by backings which have their contents resident in memory
+         * @return A span over the region or an empty span if the backing doesn't support views, in which case it should be read instead
+         * @note The view is only valid for as long as the backing is alive
+         */
+        span<const u8> View(size_t offset, size_t pSize) {
+            if (offset > size || (size - offset) < pSize)
+                throw exception("Trying to view past the end of a backing: 0x{:X}/0x{:X} (Offset: 0x{:X})", pSize, size, offset);
+
+            return ViewImpl(offset, pSize);
+        }
+
+        /**
+         * @brief Hints that a region of the backing will be read soon, backings over storage may start reading it in asynchronously
+         * @note This is purely advisory and doesn't guarantee anything about the performance of later reads
+         */
+        void Prefetch(size_t offset, size_t pSize) {
+            if (offset < size)
+                PrefetchImpl(offset, std::min(pSize, size - offset));
+        }
+
         /**
          * @brief Resizes a backing to the given size
          * @param pSize The new size for the backing
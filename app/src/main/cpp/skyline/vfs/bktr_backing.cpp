@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "bktr_backing.h"
+
+namespace skyline::vfs {
+    namespace {
+        constexpr size_t BucketTreeNodeSize{0x4000}; //!< The size of every node in a bucket tree, the root node holds the offsets of all buckets and is followed by the buckets themselves
+
+        /**
+         * @brief The header of every node in a bucket tree
+         */
+        struct BucketHeader {
+            u32 index;
+            u32 entryCount; //!< The amount of buckets for the root node or the amount of entries for a bucket
+            u64 endOffset; //!< The offset that the last entry of the node extends to
+        };
+        static_assert(sizeof(BucketHeader) == 0x10);
+
+        struct RelocationEntry {
+            u64 virtualOffset;
+            u64 physicalOffset;
+            u32 fromPatch;
+        } __attribute__((packed));
+        static_assert(sizeof(RelocationEntry) == 0x14);
+
+        struct SubsectionEntry {
+            u64 offset;
+            u32 _pad_;
+            u32 generation;
+        };
+        static_assert(sizeof(SubsectionEntry) == 0x10);
+
+        /**
+         * @brief Reads all entries in the buckets of a bucket tree in order
+         * @param endOffset The offset that the last entry of the tree extends to is written here
+         */
+        template<typename EntryType>
+        std::vector<EntryType> ReadBucketTree(Backing &tables, const BucketTreeHeader &header, u64 &endOffset) {
+            if (header.magic != util::MakeMagic<u32>("BKTR"))
+                throw exception("Invalid BKTR bucket tree magic: 0x{:X}", header.magic);
+
+            std::vector<u8> tree(header.size);
+            tables.Read(tree, header.offset);
+            if (tree.size() < sizeof(BucketHeader))
+                throw exception("BKTR bucket tree is too small: 0x{:X}", tree.size());
+
+            auto root{span(tree).as<BucketHeader>()};
+            if (root.entryCount > (BucketTreeNodeSize - sizeof(BucketHeader)) / sizeof(u64))
+                throw exception("BKTR bucket trees with more than two levels are not supported: {} buckets", root.entryCount);
+            endOffset = root.endOffset;
+
+            constexpr size_t EntriesPerBucket{(BucketTreeNodeSize - sizeof(BucketHeader)) / sizeof(EntryType)};
+            std::vector<EntryType> entries;
+            entries.reserve(header.entryCount);
+            for (size_t bucketIndex{}; bucketIndex < root.entryCount; bucketIndex++) {
+                size_t bucketOffset{(bucketIndex + 1) * BucketTreeNodeSize};
+                if (bucketOffset + sizeof(BucketHeader) > tree.size())
+                    throw exception("BKTR bucket {} is out of bounds", bucketIndex);
+
+                auto bucket{span(tree).subspan(bucketOffset).as<BucketHeader>()};
+                size_t entryCount{std::min<size_t>(bucket.entryCount, EntriesPerBucket)};
+                if (bucketOffset + sizeof(BucketHeader) + entryCount * sizeof(EntryType) > tree.size())
+                    throw exception("BKTR bucket {} entries are out of bounds", bucketIndex);
+
+                size_t previousSize{entries.size()};
+                entries.resize(previousSize + entryCount);
+                std::memcpy(entries.data() + previousSize, tree.data() + bucketOffset + sizeof(BucketHeader), entryCount * sizeof(EntryType));
+            }
+            return entries;
+        }
+    }
+
+    BktrBacking::BktrBacking(std::shared_ptr<Backing> pBaseSection, std::shared_ptr<Backing> pPatchSection, Backing &tables, const BucketTreeHeader &relocationHeader, const BucketTreeHeader &subsectionHeader, crypto::KeyStore::Key128 key, crypto::KeyStore::Key128 ctr, size_t sectionOffset, size_t romFsOffset, size_t romFsSize)
+        : Backing({true, false, false}, romFsSize), baseSection(std::move(pBaseSection)), patchSection(std::move(pPatchSection)), cipher(key), ctr(ctr), sectionOffset(sectionOffset), romFsOffset(romFsOffset) {
+        for (const auto &entry : ReadBucketTree<RelocationEntry>(tables, relocationHeader, virtualSize))
+            relocations.push_back(Relocation{entry.virtualOffset, entry.physicalOffset, entry.fromPatch != 0});
+
+        u64 subsectionEnd;
+        for (const auto &entry : ReadBucketTree<SubsectionEntry>(tables, subsectionHeader, subsectionEnd))
+            subsections.push_back(Subsection{entry.offset, entry.generation});
+
+        // The bucket trees themselves are at the end of the patch section and encrypted with the generation of the section, they aren't covered by any subsection
+        u32 sectionGeneration;
+        std::memcpy(&sectionGeneration, ctr.data() + 4, sizeof(sectionGeneration));
+        subsections.push_back(Subsection{relocationHeader.offset, util::SwapEndianness(sectionGeneration)});
+
+        auto byVirtualOffset{[](const Relocation &a, const Relocation &b) { return a.virtualOffset < b.virtualOffset; }};
+        auto byOffset{[](const Subsection &a, const Subsection &b) { return a.offset < b.offset; }};
+        if (!std::is_sorted(relocations.begin(), relocations.end(), byVirtualOffset))
+            std::sort(relocations.begin(), relocations.end(), byVirtualOffset);
+        if (!std::is_sorted(subsections.begin(), subsections.end(), byOffset))
+            std::sort(subsections.begin(), subsections.end(), byOffset);
+
+        if (relocations.empty() || relocations.front().virtualOffset != 0)
+            throw exception("BKTR relocation table doesn't cover the start of the section");
+        if (romFsOffset + romFsSize > virtualSize)
+            throw exception("BKTR RomFS is larger than the patched section: 0x{:X} + 0x{:X} > 0x{:X}", romFsOffset, romFsSize, virtualSize);
+    }
+
+    void BktrBacking::ReadPatch(span<u8> output, u64 offset) {
+        if (patchSection->ReadUnchecked(output, offset) != output.size())
+            throw exception("Failed to read BKTR patch data at 0x{:X}", offset);
+
+        // The first subsection which starts after the offset is found, the offset is in the one prior to it
+        auto subsection{std::upper_bound(subsections.begin(), subsections.end(), offset, [](u64 value, const Subsection &entry) { return value < entry.offset; })};
+        if (subsection == subsections.begin())
+            throw exception("BKTR patch data at 0x{:X} isn't covered by any subsection", offset);
+        subsection--;
+
+        while (!output.empty()) {
+            auto next{std::next(subsection)};
+            size_t length{next != subsections.end() ? std::min<size_t>(output.size(), next->offset - offset) : output.size()};
+
+            auto counter{ctr};
+            u32 generationBe{util::SwapEndianness(subsection->generation)};
+            std::memcpy(counter.data() + 4, &generationBe, sizeof(generationBe));
+            u64 absoluteOffset{sectionOffset + offset};
+            u64 blockIndexBe{util::SwapEndianness(absoluteOffset / crypto::AesCtrCipher::BlockSize)};
+            std::memcpy(counter.data() + 8, &blockIndexBe, sizeof(blockIndexBe));
+
+            cipher.Decrypt(output.first(length), counter, absoluteOffset % crypto::AesCtrCipher::BlockSize);
+            output = output.subspan(length);
+            offset += length;
+            subsection = next;
+        }
+    }
+
+    size_t BktrBacking::ReadImpl(span<u8> output, size_t offset) {
+        if (offset >= size)
+            return 0;
+        output = output.first(std::min(output.size(), size - offset));
+        size_t readSize{output.size()};
+
+        u64 virtualOffset{romFsOffset + offset};
+        auto relocation{std::upper_bound(relocations.begin(), relocations.end(), virtualOffset, [](u64 value, const Relocation &entry) { return value < entry.virtualOffset; })};
+        relocation--; // The first relocation always starts at 0 so there's always one prior to the upper bound
+
+        while (!output.empty()) {
+            auto next{std::next(relocation)};
+            u64 extentEnd{next != relocations.end() ? next->virtualOffset : virtualSize};
+            size_t length{std::min<size_t>(output.size(), extentEnd - virtualOffset)};
+            u64 physicalOffset{relocation->physicalOffset + (virtualOffset - relocation->virtualOffset)};
+
+            if (relocation->fromPatch)
+                ReadPatch(output.first(length), physicalOffset);
+            else if (baseSection->ReadUnchecked(output.first(length), physicalOffset) != length)
+                throw exception("Failed to read BKTR base data at 0x{:X}", physicalOffset);
+
+            output = output.subspan(length);
+            virtualOffset += length;
+            relocation = next;
+        }
+
+        return readSize;
+    }
+}
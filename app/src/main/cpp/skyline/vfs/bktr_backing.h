@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <crypto/aes_ctr_cipher.h>
+#include <crypto/key_store.h>
+#include "backing.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief The header of a BKTR bucket tree from the PatchInfo of an NCA section header
+     * @url https://switchbrew.org/wiki/NCA#PatchInfo
+     */
+    struct BucketTreeHeader {
+        u64 offset; //!< The offset of the bucket tree from the start of the section
+        u64 size; //!< The size of the bucket tree
+        u32 magic; //!< The magic of the bucket tree: 'BKTR'
+        u32 version;
+        u32 entryCount; //!< The total amount of entries in all buckets of the tree
+        u32 _pad_;
+    };
+    static_assert(sizeof(BucketTreeHeader) == 0x20);
+
+    /**
+     * @brief A backing which layers the RomFS section of a patch NCA over that of its base NCA
+     * @details The relocation table of the patch maps which regions of the section come from the base and which come from the patch, while the subsection table maps the counter generation that every region of the patch data is encrypted with
+     * @note Both tables are parsed into sorted extent maps once at construction, every read then only requires a binary search for each extent it spans
+     */
+    class BktrBacking : public Backing {
+      private:
+        /**
+         * @brief A contiguous region of the patched section which is entirely backed by either the base or the patch
+         */
+        struct Relocation {
+            u64 virtualOffset; //!< The offset of the region in the patched section
+            u64 physicalOffset; //!< The offset of the region in the section it's backed by
+            bool fromPatch; //!< If the region is backed by the patch rather than the base
+        };
+
+        /**
+         * @brief A contiguous region of the patch section which is encrypted with the same counter generation
+         */
+        struct Subsection {
+            u64 offset; //!< The offset of the region in the patch section
+            u32 generation; //!< The counter generation that the region is encrypted with
+        };
+
+        std::shared_ptr<Backing> baseSection; //!< The decrypted RomFS section of the base NCA
+        std::shared_ptr<Backing> patchSection; //!< The raw encrypted RomFS section of the patch NCA
+        std::vector<Relocation> relocations; //!< The relocations sorted by their virtual offset
+        std::vector<Subsection> subsections; //!< The subsections sorted by their offset
+        u64 virtualSize; //!< The size of the patched section
+        crypto::AesCtrCipher cipher;
+        crypto::KeyStore::Key128 ctr; //!< The base counter of the patch section, the generation in it is replaced by that of each subsection
+        size_t sectionOffset; //!< The offset of the patch section in its NCA, this is used to calculate the IV
+        size_t romFsOffset; //!< The offset of the RomFS data in the patched section
+
+        /**
+         * @brief Reads and decrypts data from the patch section, this may span multiple subsections
+         */
+        void ReadPatch(span<u8> output, u64 offset);
+
+      protected:
+        size_t ReadImpl(span<u8> output, size_t offset) override;
+
+      public:
+        /**
+         * @param tables The decrypted patch section which the bucket trees are read from, they're encrypted with the counter of the section rather than any subsection
+         * @param romFsOffset The offset of the RomFS data in the patched section, reads are relative to this
+         * @param romFsSize The size of the RomFS data
+         */
+        BktrBacking(std::shared_ptr<Backing> baseSection, std::shared_ptr<Backing> patchSection, Backing &tables, const BucketTreeHeader &relocationHeader, const BucketTreeHeader &subsectionHeader, crypto::KeyStore::Key128 key, crypto::KeyStore::Key128 ctr, size_t sectionOffset, size_t romFsOffset, size_t romFsSize);
+    };
+}
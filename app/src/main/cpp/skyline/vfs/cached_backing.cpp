@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include "cached_backing.h"
+
+namespace skyline::vfs {
+    CachedBacking::CachedBacking(std::shared_ptr<Backing> pBacking, size_t budget) : Backing({true, false, false}, pBacking->size), backing(std::move(pBacking)), shardCapacity(std::max<size_t>(budget / BlockSize / ShardCount, 1)) {
+        prefetchThread = std::thread(&CachedBacking::PrefetchThread, this);
+    }
+
+    CachedBacking::~CachedBacking() {
+        {
+            std::scoped_lock lock{prefetchMutex};
+            exitPrefetch = true;
+        }
+        prefetchCondition.notify_all();
+        prefetchThread.join();
+    }
+
+    size_t CachedBacking::GetCachedSize() {
+        size_t cachedSize{};
+        for (auto &shard : shards) {
+            std::scoped_lock lock{shard.mutex};
+            cachedSize += shard.blocks.size() * BlockSize;
+        }
+        return cachedSize;
+    }
+
+    void CachedBacking::Trim() {
+        for (auto &shard : shards) {
+            std::scoped_lock lock{shard.mutex};
+            shard.lookup.clear();
+            shard.blocks.clear();
+        }
+    }
+
+    std::shared_ptr<const std::vector<u8>> CachedBacking::GetBlock(size_t index) {
+        auto &shard{shards[index % ShardCount]};
+        auto findBlock{[&]() -> std::shared_ptr<const std::vector<u8>> {
+            auto it{shard.lookup.find(index)};
+            if (it == shard.lookup.end())
+                return nullptr;
+
+            shard.blocks.splice(shard.blocks.begin(), shard.blocks, it->second);
+            return it->second->data;
+        }};
+
+        {
+            std::scoped_lock lock{shard.mutex};
+            if (auto data{findBlock()})
+                return data;
+        }
+
+        // The block is read without the shard being locked so a slow read doesn't stall hits on other blocks, concurrent misses on the same block may both read it but only one copy is inserted
+        size_t blockOffset{index * BlockSize};
+        auto data{std::make_shared<std::vector<u8>>(std::min(BlockSize, size - blockOffset))};
+        if (backing->ReadUnchecked(*data, blockOffset) != data->size())
+            return nullptr;
+
+        std::scoped_lock lock{shard.mutex};
+        if (auto existing{findBlock()})
+            return existing;
+
+        if (shard.blocks.size() >= shardCapacity) {
+            shard.lookup.erase(shard.blocks.back().index);
+            shard.blocks.pop_back();
+        }
+
+        shard.blocks.push_front(CachedBlock{index, data});
+        shard.lookup.emplace(index, shard.blocks.begin());
+        return data;
+    }
+
+    size_t CachedBacking::ReadImpl(span<u8> output, size_t offset) {
+        if (output.size() >= BypassSize)
+            return backing->ReadUnchecked(output, offset);
+
+        size_t copied{};
+        while (copied < output.size() && offset + copied < size) {
+            size_t position{offset + copied};
+            auto block{GetBlock(position / BlockSize)};
+            if (!block)
+                break;
+
+            size_t blockOffset{position % BlockSize};
+            size_t length{std::min(output.size() - copied, block->size() - blockOffset)};
+            std::memcpy(output.data() + copied, block->data() + blockOffset, length);
+            copied += length;
+        }
+
+        UpdateStreams(offset, copied);
+        return copied;
+    }
+
+    void CachedBacking::UpdateStreams(size_t offset, size_t readSize) {
+        if (!readSize)
+            return;
+
+        std::pair<size_t, size_t> prefetchRange{};
+        {
+            std::scoped_lock lock{streamMutex};
+            auto stream{std::find_if(streams.begin(), streams.end(), [&](const Stream &stream) { return stream.streak && stream.nextOffset == offset; })};
+            if (stream == streams.end()) {
+                streams[nextStreamSlot] = Stream{.nextOffset = offset + readSize, .streak = 1};
+                nextStreamSlot = (nextStreamSlot + 1) % StreamCount;
+                return;
+            }
+
+            stream->nextOffset = offset + readSize;
+            if (++stream->streak < SequentialThreshold)
+                return;
+
+            // Only blocks past those already queued are prefetched, so the queue is topped up incrementally as the stream advances
+            size_t blockCount{util::DivideCeil(size, BlockSize)};
+            size_t firstBlock{std::max(stream->prefetchEnd, stream->nextOffset / BlockSize)};
+            size_t endBlock{std::min(stream->nextOffset / BlockSize + ReadAheadBlocks, blockCount)};
+            if (firstBlock >= endBlock)
+                return;
+
+            stream->prefetchEnd = endBlock;
+            prefetchRange = {firstBlock, endBlock - firstBlock};
+        }
+
+        {
+            std::scoped_lock lock{prefetchMutex};
+            prefetchQueue.push_back(prefetchRange);
+        }
+        prefetchCondition.notify_one();
+    }
+
+    void CachedBacking::PrefetchThread() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-Prefetch")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        while (true) {
+            std::pair<size_t, size_t> range;
+            {
+                std::unique_lock lock{prefetchMutex};
+                prefetchCondition.wait(lock, [this] { return exitPrefetch || !prefetchQueue.empty(); });
+                if (exitPrefetch)
+                    return;
+
+                range = prefetchQueue.front();
+                prefetchQueue.pop_front();
+            }
+
+            auto [firstBlock, blockCount]{range};
+            try {
+                // The entire range is hinted first so storage can service it while earlier blocks are being decrypted
+                backing->Prefetch(firstBlock * BlockSize, blockCount * BlockSize);
+                for (size_t index{firstBlock}; index < firstBlock + blockCount; index++)
+                    GetBlock(index);
+            } catch (const std::exception &e) {
+                Logger::Warn("Failed to prefetch blocks 0x{:X}-0x{:X}: {}", firstBlock, firstBlock + blockCount, e.what());
+            }
+        }
+    }
+}
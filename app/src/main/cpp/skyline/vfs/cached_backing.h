@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include "backing.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief A read-only backing which caches fixed-size blocks of another backing in memory, this is layered above decryption so hot data is served without being read or decrypted again
+     * @note The cache is split into shards by block index with a lock and LRU list per shard, so concurrent reads of different blocks rarely contend
+     * @note Sequential streams of reads are detected and the blocks ahead of them are read into the cache on a background thread
+     */
+    class CachedBacking : public Backing {
+      public:
+        static constexpr size_t BlockSize{0x10000}; //!< The size of a single cached block (64 KiB)
+        static constexpr size_t BypassSize{0x100000}; //!< Reads at least this large bypass the cache, they're bulk streaming which won't be reread soon and would evict hot blocks (1 MiB)
+
+      private:
+        static constexpr size_t ShardCount{16};
+        static constexpr size_t StreamCount{4}; //!< The amount of sequential streams that are tracked at once, the guest commonly streams a few files concurrently
+        static constexpr size_t SequentialThreshold{2}; //!< The amount of consecutive reads after which a stream is considered sequential
+        static constexpr size_t ReadAheadBlocks{8}; //!< The amount of blocks ahead of a sequential stream that are prefetched (512 KiB)
+
+        struct CachedBlock {
+            size_t index;
+            std::shared_ptr<const std::vector<u8>> data; //!< The contents of the block, this is shared with any readers so eviction doesn't invalidate a block while it's being copied
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::list<CachedBlock> blocks; //!< The cached blocks in order of most to least recently used
+            std::unordered_map<size_t, std::list<CachedBlock>::iterator> lookup; //!< A map from block indices to their position in the LRU list
+        };
+
+        std::shared_ptr<Backing> backing;
+        std::array<Shard, ShardCount> shards;
+        size_t shardCapacity; //!< The maximum amount of blocks held by a single shard
+
+        /**
+         * @brief A stream of reads which each start where the prior one ended
+         */
+        struct Stream {
+            size_t nextOffset; //!< The offset at which the next read in the stream is expected to start
+            size_t streak; //!< The amount of consecutive reads in the stream
+            size_t prefetchEnd; //!< The index of the block after the last one that has been queued for prefetching
+        };
+
+        std::mutex streamMutex;
+        std::array<Stream, StreamCount> streams{};
+        size_t nextStreamSlot{}; //!< The slot which is replaced by the next new stream, slots are replaced in round-robin order
+
+        std::thread prefetchThread;
+        std::mutex prefetchMutex;
+        std::condition_variable prefetchCondition;
+        std::deque<std::pair<size_t, size_t>> prefetchQueue; //!< Queued ranges of blocks to prefetch as the index of the first block and the amount of blocks
+        bool exitPrefetch{};
+
+        /**
+         * @return The contents of the block with the supplied index, it's read from the underlying backing and inserted into the cache on a miss
+         * @note nullptr is returned if the block couldn't be fully read from the underlying backing
+         */
+        std::shared_ptr<const std::vector<u8>> GetBlock(size_t index);
+
+        /**
+         * @brief Records a read in the stream it continues, blocks ahead of the stream are queued for prefetching if it's sequential
+         */
+        void UpdateStreams(size_t offset, size_t readSize);
+
+        /**
+         * @brief A thread which reads queued blocks into the cache ahead of sequential streams
+         */
+        void PrefetchThread();
+
+      protected:
+        size_t ReadImpl(span<u8> output, size_t offset) override;
+
+      public:
+        /**
+         * @param budget The maximum amount of memory in bytes that cached blocks may use
+         */
+        CachedBacking(std::shared_ptr<Backing> backing, size_t budget);
+
+        ~CachedBacking();
+
+        /**
+         * @return The amount of memory in bytes that is used by cached blocks
+         */
+        size_t GetCachedSize();
+
+        /**
+         * @brief Evicts all cached blocks, this is used to release memory when the host is running low on it
+         */
+        void Trim();
+    };
+}
@@ -36,6 +36,8 @@ namespace skyline::vfs {
             throw exception("This filesystem does not support opening directories");
         };
 
+        virtual void CommitImpl() {}
+
       public:
         FileSystem() = default;
 
@@ -152,5 +154,12 @@ namespace skyline::vfs {
         std::shared_ptr<Directory> OpenDirectory(const std::string &path, Directory::ListMode listMode = {true, true}) {
             return OpenDirectoryUnchecked(path, listMode);
         };
+
+        /**
+         * @brief Commits all writes to files in the filesystem to storage, this does nothing on filesystems which write through immediately
+         */
+        void Commit() {
+            CommitImpl();
+        }
     };
 }
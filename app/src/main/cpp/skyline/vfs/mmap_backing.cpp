@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mmap_backing.h"
+
+namespace skyline::vfs {
+    MmapBacking::MmapBacking(int fd) : Backing({true, false, false}) {
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo))
+            throw exception("Failed to stat fd: {}", strerror(errno));
+
+        size = static_cast<size_t>(fileInfo.st_size);
+        if (size == 0)
+            throw exception("Cannot map an empty file");
+
+        mapping = static_cast<u8 *>(mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+        if (mapping == MAP_FAILED)
+            throw exception("Failed to map fd: {}", strerror(errno));
+    }
+
+    MmapBacking::~MmapBacking() {
+        munmap(mapping, size);
+    }
+
+    size_t MmapBacking::ReadImpl(span<u8> output, size_t offset) {
+        if (offset >= size)
+            return 0;
+
+        size_t readSize{std::min(output.size(), size - offset)};
+        std::memcpy(output.data(), mapping + offset, readSize);
+        return readSize;
+    }
+
+    void MmapBacking::PrefetchImpl(size_t offset, size_t pSize) {
+        size_t alignedOffset{util::AlignDown(offset, constant::PageSize)};
+        madvise(mapping + alignedOffset, pSize + (offset - alignedOffset), MADV_WILLNEED);
+    }
+
+    span<const u8> MmapBacking::ViewImpl(size_t offset, size_t pSize) {
+        return span<const u8>{mapping + offset, pSize};
+    }
+}
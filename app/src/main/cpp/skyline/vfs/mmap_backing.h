@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include "backing.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief A read-only backing for a physical linux file which is mapped into memory, reads are served by copying from the mapping and zero-copy views of it are supported
+     * @note This should only be used for files that are small enough to map and aren't on storage that can disappear during emulation, I/O errors on a mapping are delivered as SIGBUS rather than being returned
+     */
+    class MmapBacking : public Backing {
+      private:
+        u8 *mapping; //!< The mapping of the entire file
+
+      protected:
+        size_t ReadImpl(span<u8> output, size_t offset) override;
+
+        void PrefetchImpl(size_t offset, size_t pSize) override;
+
+        span<const u8> ViewImpl(size_t offset, size_t pSize) override;
+
+      public:
+        /**
+         * @param fd The file descriptor of the file to map, this isn't retained past construction
+         */
+        MmapBacking(int fd);
+
+        ~MmapBacking();
+    };
+}
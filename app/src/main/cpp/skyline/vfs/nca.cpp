@@ -14,7 +14,7 @@
 namespace skyline::vfs {
     using namespace loader;
 
-    NCA::NCA(std::shared_ptr<vfs::Backing> pBacking, std::shared_ptr<crypto::KeyStore> pKeyStore, bool pUseKeyArea) : backing(std::move(pBacking)), keyStore(std::move(pKeyStore)), useKeyArea(pUseKeyArea) {
+    NCA::NCA(std::shared_ptr<vfs::Backing> pBacking, std::shared_ptr<crypto::KeyStore> pKeyStore, bool pUseKeyArea, const NCA *base) : backing(std::move(pBacking)), keyStore(std::move(pKeyStore)), useKeyArea(pUseKeyArea) {
         header = backing->Read<NcaHeader>();
 
         if (header.magic != util::MakeMagic<u32>("NCA3")) {
@@ -41,7 +41,7 @@ namespace skyline::vfs {
             if (sectionHeader.fsType == NcaSectionFsType::PFS0 && sectionHeader.hashType == NcaSectionHashType::HierarchicalSha256)
                 ReadPfs0(sectionHeader, sectionEntry);
             else if (sectionHeader.fsType == NcaSectionFsType::RomFs && sectionHeader.hashType == NcaSectionHashType::HierarchicalIntegrity)
-                ReadRomFs(sectionHeader, sectionEntry);
+                ReadRomFs(sectionHeader, sectionEntry, base);
         }
     }
 
@@ -62,11 +62,25 @@ namespace skyline::vfs {
         }
     }
 
-    void NCA::ReadRomFs(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry) {
-        size_t offset{static_cast<size_t>(entry.startOffset) * constant::MediaUnitSize + sectionHeader.integrityHashInfo.levels.back().offset};
-        size_t size{sectionHeader.integrityHashInfo.levels.back().size};
+    void NCA::ReadRomFs(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry, const NCA *base) {
+        size_t sectionOffset{static_cast<size_t>(entry.startOffset) * constant::MediaUnitSize};
+        size_t sectionSize{constant::MediaUnitSize * static_cast<size_t>(entry.endOffset - entry.startOffset)};
+        auto &dataLevel{sectionHeader.integrityHashInfo.levels.back()};
+
+        auto rawSection{std::make_shared<RegionBacking>(backing, sectionOffset, sectionSize)};
+        romFsSection = CreateBacking(sectionHeader, rawSection, sectionOffset);
+        if (!romFsSection)
+            return;
+
+        if (encrypted && sectionHeader.encryptionType == NcaSectionEncryptionType::BKTR) {
+            // A patch section on its own only contains the data that's changed from the base, it can't be read without one
+            romFsPatch = true;
+            if (base && base->romFsSection)
+                romFs = std::make_shared<BktrBacking>(base->romFsSection, std::move(rawSection), *romFsSection, sectionHeader.relocationHeader, sectionHeader.subsectionHeader, GetSectionKey(sectionHeader), GetSectionCtr(sectionHeader), sectionOffset, dataLevel.offset, dataLevel.size);
+            return;
+        }
 
-        romFs = CreateBacking(sectionHeader, std::make_shared<RegionBacking>(backing, offset, size), offset);
+        romFs = std::make_shared<RegionBacking>(romFsSection, dataLevel.offset, dataLevel.size);
     }
 
     std::shared_ptr<Backing> NCA::CreateBacking(const NcaSectionHeader &sectionHeader, std::shared_ptr<Backing> rawBacking, size_t offset) {
@@ -77,22 +91,27 @@ namespace skyline::vfs {
             case NcaSectionEncryptionType::None:
                 return rawBacking;
             case NcaSectionEncryptionType::CTR:
-            case NcaSectionEncryptionType::BKTR: {
-                auto key{!(rightsIdEmpty || useKeyArea) ? GetTitleKey() : GetKeyAreaKey(sectionHeader.encryptionType)};
-
-                std::array<u8, 0x10> ctr{};
-                u32 secureValueLE{util::SwapEndianness(sectionHeader.secureValue)};
-                u32 generationLE{util::SwapEndianness(sectionHeader.generation)};
-                std::memcpy(ctr.data(), &secureValueLE, 4);
-                std::memcpy(ctr.data() + 4, &generationLE, 4);
-
-                return std::make_shared<CtrEncryptedBacking>(ctr, key, std::move(rawBacking), offset);
-            }
+            case NcaSectionEncryptionType::BKTR:
+                // The bucket trees of BKTR sections are encrypted as regular CTR data, the patch data itself is decrypted by BktrBacking
+                return std::make_shared<CtrEncryptedBacking>(GetSectionCtr(sectionHeader), GetSectionKey(sectionHeader), std::move(rawBacking), offset);
             default:
                 return nullptr;
         }
     }
 
+    crypto::KeyStore::Key128 NCA::GetSectionKey(const NcaSectionHeader &sectionHeader) {
+        return !(rightsIdEmpty || useKeyArea) ? GetTitleKey() : GetKeyAreaKey(sectionHeader.encryptionType);
+    }
+
+    crypto::KeyStore::Key128 NCA::GetSectionCtr(const NcaSectionHeader &sectionHeader) {
+        std::array<u8, 0x10> ctr{};
+        u32 secureValueLE{util::SwapEndianness(sectionHeader.secureValue)};
+        u32 generationLE{util::SwapEndianness(sectionHeader.generation)};
+        std::memcpy(ctr.data(), &secureValueLE, 4);
+        std::memcpy(ctr.data() + 4, &generationLE, 4);
+        return ctr;
+    }
+
     u8 NCA::GetKeyGeneration() {
         u8 legacyGen{static_cast<u8>(header.legacyKeyGenerationType)};
         u8 gen{static_cast<u8>(header.keyGenerationType)};
@@ -6,6 +6,7 @@
 #include <crypto/key_store.h>
 #include <crypto/aes_cipher.h>
 #include "filesystem.h"
+#include "bktr_backing.h"
 
 namespace skyline {
     namespace constant {
@@ -137,7 +138,8 @@ namespace skyline {
                     HierarchicalIntegrityHashInfo integrityHashInfo; //!< The HashInfo used for RomFS
                     HierarchicalSha256HashInfo sha256HashInfo; //!< The HashInfo used for PFS0
                 };
-                u8 _pad1_[0x40]; // PatchInfo
+                BucketTreeHeader relocationHeader; //!< The header of the relocation bucket tree for BKTR sections
+                BucketTreeHeader subsectionHeader; //!< The header of the subsection bucket tree for BKTR sections
                 u32 generation; //!< The generation of the NCA section
                 u32 secureValue; //!< The secure value of the section
                 u8 _pad2_[0x30]; //!< SparseInfo
@@ -174,13 +176,24 @@ namespace skyline {
             bool encrypted{false};
             bool rightsIdEmpty;
             bool useKeyArea;
+            std::shared_ptr<Backing> romFsSection; //!< The backing for the entire RomFS section including its hash levels, the relocations of a patch are relative to this
 
             void ReadPfs0(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry);
 
-            void ReadRomFs(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry);
+            /**
+             * @param base The NCA which a BKTR RomFS section is layered over, the RomFS isn't available if this isn't supplied for such a section
+             */
+            void ReadRomFs(const NcaSectionHeader &sectionHeader, const NcaFsEntry &entry, const NCA *base);
 
             std::shared_ptr<Backing> CreateBacking(const NcaSectionHeader &sectionHeader, std::shared_ptr<Backing> rawBacking, size_t offset);
 
+            crypto::KeyStore::Key128 GetSectionKey(const NcaSectionHeader &sectionHeader);
+
+            /**
+             * @return The upper half of the AES-CTR counter for a section, the lower half is the offset of the block in the NCA
+             */
+            static crypto::KeyStore::Key128 GetSectionCtr(const NcaSectionHeader &sectionHeader);
+
             u8 GetKeyGeneration();
 
             crypto::KeyStore::Key128 GetTitleKey();
@@ -193,8 +206,12 @@ namespace skyline {
             std::shared_ptr<FileSystem> cnmt; //!< The PFS0 filesystem for this NCA's CNMT section
             std::shared_ptr<Backing> romFs; //!< The backing for this NCA's RomFS section
             NcaContentType contentType; //!< The content type of the NCA
+            bool romFsPatch{}; //!< If the RomFS section is a BKTR patch over the RomFS of a base NCA, such as in an update
 
-            NCA(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore, bool useKeyArea = false);
+            /**
+             * @param base The base NCA that a BKTR patch RomFS is layered over, this only needs to be alive during construction
+             */
+            NCA(std::shared_ptr<vfs::Backing> backing, std::shared_ptr<crypto::KeyStore> keyStore, bool useKeyArea = false, const NCA *base = nullptr);
         };
     }
 }
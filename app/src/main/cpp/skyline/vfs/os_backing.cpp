@@ -4,6 +4,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include "os_backing.h"
 
 namespace skyline::vfs {
@@ -47,6 +48,11 @@ namespace skyline::vfs {
         return output.size();
     }
 
+    void OsBacking::PrefetchImpl(size_t offset, size_t pSize) {
+        // This starts reading the range into the page cache asynchronously, failures are ignored as it's only a hint
+        posix_fadvise64(fd, static_cast<off64_t>(offset), static_cast<off64_t>(pSize), POSIX_FADV_WILLNEED);
+    }
+
     size_t OsBacking::WriteImpl(span<u8> input, size_t offset) {
         auto ret{pwrite64(fd, input.data(), input.size(), static_cast<off64_t>(offset))};
         if (ret < 0)
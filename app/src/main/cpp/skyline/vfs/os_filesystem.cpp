@@ -9,7 +9,7 @@
 #include "os_filesystem.h"
 
 namespace skyline::vfs {
-    OsFileSystem::OsFileSystem(const std::string &basePath) : FileSystem(), basePath(basePath.ends_with('/') ? basePath : basePath + '/') {
+    OsFileSystem::OsFileSystem(const std::string &basePath, bool writeBack) : FileSystem(), basePath(basePath.ends_with('/') ? basePath : basePath + '/'), committer(writeBack ? std::make_shared<WriteBackCommitter>() : nullptr) {
         if (!DirectoryExists(""))
             if (!CreateDirectory("", true))
                 throw exception("Error creating the OS filesystem backing directory");
@@ -40,11 +40,38 @@ namespace skyline::vfs {
 
     void OsFileSystem::DeleteFileImpl(const std::string &path) {
         auto fullPath{basePath + path};
+        if (committer) {
+            std::scoped_lock lock{stagedMutex};
+            if (auto it{stagedFiles.find(fullPath)}; it != stagedFiles.end()) {
+                if (auto file{it->second.lock()}) {
+                    std::scoped_lock fileLock{file->mutex};
+                    file->discarded = true;
+                }
+                stagedFiles.erase(it);
+            }
+            committer->Discard(fullPath);
+        }
+
         remove(fullPath.c_str());
     }
 
     void OsFileSystem::DeleteDirectoryImpl(const std::string &path) {
         auto fullPath{basePath + path};
+        if (committer) {
+            auto directoryPath{fullPath.ends_with('/') ? fullPath : fullPath + '/'};
+            std::scoped_lock lock{stagedMutex};
+            std::erase_if(stagedFiles, [&](const auto &entry) {
+                if (!entry.first.starts_with(directoryPath))
+                    return false;
+                if (auto file{entry.second.lock()}) {
+                    std::scoped_lock fileLock{file->mutex};
+                    file->discarded = true;
+                }
+                return true;
+            });
+            committer->Discard(directoryPath, true);
+        }
+
         std::filesystem::remove_all(fullPath.c_str());
     }
 
@@ -71,11 +98,38 @@ namespace skyline::vfs {
     }
 
     std::shared_ptr<Backing> OsFileSystem::OpenFileImpl(const std::string &path, Backing::Mode mode) {
-        int fd{open((basePath + path).c_str(), (mode.read && mode.write) ? O_RDWR : (mode.write ? O_WRONLY : O_RDONLY))};
+        auto fullPath{basePath + path};
+        std::unique_lock lock{stagedMutex, std::defer_lock};
+        auto stage{[&](std::vector<u8> contents) {
+            auto file{std::make_shared<StagedFile>(fullPath, std::move(contents))};
+            stagedFiles.insert_or_assign(fullPath, file);
+            return std::make_shared<WriteBackBacking>(std::move(file), committer, mode);
+        }};
+
+        if (committer) {
+            lock.lock();
+            if (auto it{stagedFiles.find(fullPath)}; it != stagedFiles.end())
+                if (auto file{it->second.lock()})
+                    return std::make_shared<WriteBackBacking>(std::move(file), committer, mode);
+
+            // Contents which have been committed but not written yet are newer than the file on storage
+            if (auto pending{committer->GetPending(fullPath)})
+                return stage(*pending);
+        }
+
+        // Files which will be staged are read in their entirety when they're opened, so they must be readable regardless of the requested mode
+        bool writeBack{committer && mode.write};
+        int fd{open(fullPath.c_str(), (writeBack || (mode.read && mode.write)) ? O_RDWR : (mode.write ? O_WRONLY : O_RDONLY))};
         if (fd < 0)
             throw exception("Failed to open file at '{}': {}", path, strerror(errno));
 
-        return std::make_shared<OsBacking>(fd, true, mode);
+        auto backing{std::make_shared<OsBacking>(fd, true, writeBack ? Backing::Mode{true, mode.write, mode.append} : mode)};
+        if (!writeBack || backing->size > WriteBackLimit)
+            return backing;
+
+        std::vector<u8> contents(backing->size);
+        backing->Read(contents);
+        return stage(std::move(contents));
     }
 
     std::optional<Directory::EntryType> OsFileSystem::GetEntryTypeImpl(const std::string &path) {
@@ -102,6 +156,21 @@ namespace skyline::vfs {
             return std::make_shared<OsFileSystemDirectory>(basePath + path, listMode);
     }
 
+    void OsFileSystem::CommitImpl() {
+        if (!committer)
+            return;
+
+        std::scoped_lock lock{stagedMutex};
+        std::erase_if(stagedFiles, [this](const auto &entry) {
+            auto file{entry.second.lock()};
+            if (!file)
+                return true;
+
+            file->Commit(*committer);
+            return false;
+        });
+    }
+
     OsFileSystemDirectory::OsFileSystemDirectory(std::string path, Directory::ListMode listMode) : Directory(listMode), path(std::move(path)) {}
 
     std::vector<Directory::Entry> OsFileSystemDirectory::Read() {
@@ -116,11 +185,14 @@ namespace skyline::vfs {
             throw exception("Failed to open directory: {}, error: {}", path, strerror(errno));
 
         while ((entry = readdir(directory))) {
+            std::string name(entry->d_name);
+            if (name.ends_with(WriteBackCommitter::TemporarySuffix))
+                continue; // Temporary files from in-flight commits are an implementation detail and shouldn't be visible to the guest, they may also be renamed away at any point
+
             struct stat entryInfo;
             if (stat((path + std::string(entry->d_name)).c_str(), &entryInfo))
                 throw exception("Failed to stat directory entry: {}, error: {}", entry->d_name, strerror(errno));
 
-            std::string name(entry->d_name);
             if (S_ISDIR(entryInfo.st_mode) && listMode.directory && (name != ".") && (name != "..")) {
                 outputEntries.push_back(Directory::Entry{
                     .type = Directory::EntryType::Directory,
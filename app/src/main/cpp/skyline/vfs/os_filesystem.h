@@ -4,6 +4,7 @@
 #pragma once
 
 #include "filesystem.h"
+#include "write_back_backing.h"
 
 namespace skyline::vfs {
     /**
@@ -11,7 +12,12 @@ namespace skyline::vfs {
      */
     class OsFileSystem : public FileSystem {
       private:
+        static constexpr size_t WriteBackLimit{0x4000000}; //!< Files larger than this aren't staged in memory and are written through to storage directly (64 MiB)
+
         std::string basePath; //!< The base path for filesystem operations
+        std::shared_ptr<WriteBackCommitter> committer; //!< The committer for staged files, this is nullptr if the filesystem writes through to storage directly
+        std::mutex stagedMutex;
+        std::unordered_map<std::string, std::weak_ptr<StagedFile>> stagedFiles; //!< A map from host paths to the staged contents of files which are currently open
 
       protected:
         bool CreateFileImpl(const std::string &path, size_t size) override;
@@ -28,8 +34,13 @@ namespace skyline::vfs {
 
         std::shared_ptr<Directory> OpenDirectoryImpl(const std::string &path, Directory::ListMode listMode) override;
 
+        void CommitImpl() override;
+
       public:
-        OsFileSystem(const std::string &basePath);
+        /**
+         * @param writeBack If writes to files should be staged in memory and only written to storage when the file is closed or the filesystem is committed, this matches the commit semantics of savedata
+         */
+        OsFileSystem(const std::string &basePath, bool writeBack = false);
     };
 
     /**
@@ -19,15 +19,23 @@ namespace skyline::vfs {
         size_t stringTableOffset{sizeof(FsHeader) + (header.numFiles * entrySize)};
         fileDataOffset = stringTableOffset + header.stringTableSize;
 
-        std::vector<char> stringTable(header.stringTableSize + 1);
-        backing->Read(span(stringTable).first(header.stringTableSize), stringTableOffset);
-        stringTable[header.stringTableSize] = 0;
+        // The string table is parsed in-place when the backing can be viewed, otherwise it's read into a buffer
+        std::vector<u8> stringTableBuffer;
+        auto stringTable{backing->View(stringTableOffset, header.stringTableSize)};
+        if (stringTable.empty() && header.stringTableSize) {
+            stringTableBuffer.resize(header.stringTableSize);
+            backing->Read(span(stringTableBuffer), stringTableOffset);
+            stringTable = stringTableBuffer;
+        }
 
         for (u32 entryOffset{sizeof(FsHeader)}; entryOffset < header.numFiles * entrySize; entryOffset += entrySize) {
             auto entry{backing->Read<PartitionFileEntry>(entryOffset)};
+            if (entry.stringTableOffset >= stringTable.size())
+                throw exception("Partition file entry name is outside the string table: 0x{:X}/0x{:X}", entry.stringTableOffset, stringTable.size());
 
-            std::string name(&stringTable[entry.stringTableOffset]);
-            fileMap.emplace(name, entry);
+            // Names aren't guaranteed to be terminated within the table, so they're bounded by its end
+            auto name{reinterpret_cast<const char *>(stringTable.data() + entry.stringTableOffset)};
+            fileMap.emplace(std::string(name, strnlen(name, stringTable.size() - entry.stringTableOffset)), entry);
         }
     }
 
@@ -19,6 +19,14 @@ namespace skyline::vfs {
             return backing->ReadUnchecked(output, baseOffset + offset);
         }
 
+        void PrefetchImpl(size_t offset, size_t pSize) override {
+            backing->Prefetch(baseOffset + offset, pSize);
+        }
+
+        span<const u8> ViewImpl(size_t offset, size_t pSize) override {
+            return backing->View(baseOffset + offset, pSize);
+        }
+
       public:
         /**
          * @param file The backing to create the RegionBacking from
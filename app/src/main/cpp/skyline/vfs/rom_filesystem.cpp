@@ -7,73 +7,117 @@
 namespace skyline::vfs {
     RomFileSystem::RomFileSystem(std::shared_ptr<Backing> pBacking) : FileSystem(), backing(std::move(pBacking)) {
         header = backing->Read<RomFsHeader>();
-        TraverseDirectory(0, "");
     }
 
-    void RomFileSystem::TraverseFiles(u32 offset, const std::string &path) {
-        RomFsFileEntry entry;
-        do {
-            entry = backing->Read<RomFsFileEntry>(header.fileMetaTableOffset + offset);
-
-            if (entry.nameSize) {
-                std::vector<char> name(entry.nameSize);
-                backing->Read(span(name), header.fileMetaTableOffset + offset + sizeof(RomFsFileEntry));
+    namespace {
+        /**
+         * @brief Calculates the hash of an entry name as it's done when building a RomFS image
+         * @param signExtend If the characters of the name should be sign-extended, tools building images with a signed char type produce different hashes for non-ASCII names
+         */
+        u32 GetEntryHash(u32 parentOffset, std::string_view name, bool signExtend) {
+            u32 hash{parentOffset ^ 123456789};
+            for (char character : name) {
+                hash = (hash >> 5) | (hash << 27);
+                hash ^= signExtend ? static_cast<u32>(static_cast<i32>(static_cast<i8>(character))) : static_cast<u32>(static_cast<u8>(character));
+            }
+            return hash;
+        }
+    }
 
-                std::string fullPath{path + (path.empty() ? "" : "/") + std::string(name.data(), entry.nameSize)};
-                fileMap.emplace(fullPath, entry);
+    template<typename EntryType>
+    std::optional<std::pair<u32, EntryType>> RomFileSystem::FindEntry(u64 hashTableOffset, u64 hashTableSize, u64 metaTableOffset, u32 parentOffset, std::string_view name) {
+        u64 bucketCount{hashTableSize / sizeof(u32)};
+        if (!bucketCount || name.size() > MaxNameSize)
+            return std::nullopt;
+
+        auto search{[&](u32 hash) -> std::optional<std::pair<u32, EntryType>> {
+            auto offset{backing->Read<u32>(hashTableOffset + (hash % bucketCount) * sizeof(u32))};
+            while (offset != constant::RomFsEmptyEntry) {
+                auto entry{backing->Read<EntryType>(metaTableOffset + offset)};
+                if (entry.parentOffset == parentOffset && entry.nameSize == name.size()) {
+                    // Names are only read when they could match and into a stack buffer, so colliding entries don't allocate
+                    std::array<char, MaxNameSize> entryName;
+                    backing->Read(span(entryName).first(entry.nameSize), metaTableOffset + offset + sizeof(EntryType));
+                    if (std::string_view(entryName.data(), entry.nameSize) == name)
+                        return std::pair{offset, entry};
+                }
+                offset = entry.hashSiblingOffset;
             }
+            return std::nullopt;
+        }};
 
-            offset = entry.siblingOffset;
-        } while (offset != constant::RomFsEmptyEntry);
+        if (auto result{search(GetEntryHash(parentOffset, name, false))})
+            return result;
+        if (std::any_of(name.begin(), name.end(), [](char character) { return static_cast<u8>(character) >= 0x80; }))
+            return search(GetEntryHash(parentOffset, name, true));
+        return std::nullopt;
     }
 
-    void RomFileSystem::TraverseDirectory(u32 offset, const std::string &path) {
-        auto entry{backing->Read<RomFsDirectoryEntry>(header.dirMetaTableOffset + offset)};
-
-        std::string childPath(path);
-        if (entry.nameSize) {
-            std::vector<char> name(entry.nameSize);
-            backing->Read(span(name), header.dirMetaTableOffset + offset + sizeof(RomFsDirectoryEntry));
-            childPath = path + (path.empty() ? "" : "/") + std::string(name.data(), entry.nameSize);
+    std::optional<u32> RomFileSystem::ResolveParent(std::string_view path, std::string_view &name) {
+        u32 directoryOffset{RootDirectoryOffset};
+        name = {};
+        while (!path.empty()) {
+            auto separator{path.find('/')};
+            auto component{path.substr(0, separator)};
+            path = separator == std::string_view::npos ? std::string_view{} : path.substr(separator + 1);
+
+            if (component.empty())
+                continue; // Leading, trailing and repeated separators don't denote any entry
+
+            if (!name.empty()) {
+                auto directory{FindEntry<RomFsDirectoryEntry>(header.dirHashTableOffset, header.dirHashTableSize, header.dirMetaTableOffset, directoryOffset, name)};
+                if (!directory)
+                    return std::nullopt;
+                directoryOffset = directory->first;
+            }
+            name = component;
         }
-
-        directoryMap.emplace(childPath, entry);
-
-        if (entry.fileOffset != constant::RomFsEmptyEntry)
-            TraverseFiles(entry.fileOffset, childPath);
-
-        if (entry.childOffset != constant::RomFsEmptyEntry)
-            TraverseDirectory(entry.childOffset, childPath);
-
-        if (entry.siblingOffset != constant::RomFsEmptyEntry)
-            TraverseDirectory(entry.siblingOffset, path);
+        return directoryOffset;
     }
 
     std::shared_ptr<Backing> RomFileSystem::OpenFileImpl(const std::string &path, Backing::Mode mode) {
-        try {
-            const auto &entry{fileMap.at(path)};
-            return std::make_shared<RegionBacking>(backing, header.dataOffset + entry.offset, entry.size, mode);
-        } catch (std::out_of_range &e) {
+        std::string_view name;
+        auto parentOffset{ResolveParent(path, name)};
+        if (!parentOffset || name.empty())
             return nullptr;
-        }
+
+        auto file{FindEntry<RomFsFileEntry>(header.fileHashTableOffset, header.fileHashTableSize, header.fileMetaTableOffset, *parentOffset, name)};
+        if (!file)
+            return nullptr;
+
+        return std::make_shared<RegionBacking>(backing, header.dataOffset + file->second.offset, file->second.size, mode);
     }
 
     std::optional<Directory::EntryType> RomFileSystem::GetEntryTypeImpl(const std::string &path) {
-        if (fileMap.count(path))
+        std::string_view name;
+        auto parentOffset{ResolveParent(path, name)};
+        if (!parentOffset)
+            return std::nullopt;
+
+        if (name.empty())
+            return Directory::EntryType::Directory;
+        if (FindEntry<RomFsFileEntry>(header.fileHashTableOffset, header.fileHashTableSize, header.fileMetaTableOffset, *parentOffset, name))
             return Directory::EntryType::File;
-        else if (directoryMap.count(path))
+        if (FindEntry<RomFsDirectoryEntry>(header.dirHashTableOffset, header.dirHashTableSize, header.dirMetaTableOffset, *parentOffset, name))
             return Directory::EntryType::Directory;
 
         return std::nullopt;
     }
 
     std::shared_ptr<Directory> RomFileSystem::OpenDirectoryImpl(const std::string &path, Directory::ListMode listMode) {
-        try {
-            auto &entry{directoryMap.at(path)};
-            return std::make_shared<RomFileSystemDirectory>(backing, header, entry, listMode);
-        } catch (std::out_of_range &e) {
+        std::string_view name;
+        auto parentOffset{ResolveParent(path, name)};
+        if (!parentOffset)
             return nullptr;
-        }
+
+        if (name.empty())
+            return std::make_shared<RomFileSystemDirectory>(backing, header, backing->Read<RomFsDirectoryEntry>(header.dirMetaTableOffset + RootDirectoryOffset), listMode);
+
+        auto directory{FindEntry<RomFsDirectoryEntry>(header.dirHashTableOffset, header.dirHashTableSize, header.dirMetaTableOffset, *parentOffset, name)};
+        if (!directory)
+            return nullptr;
+
+        return std::make_shared<RomFileSystemDirectory>(backing, header, directory->second, listMode);
     }
 
     RomFileSystemDirectory::RomFileSystemDirectory(std::shared_ptr<Backing> backing, const RomFileSystem::RomFsHeader &header, const RomFileSystem::RomFsDirectoryEntry &ownEntry, ListMode listMode) : Directory(listMode), backing(std::move(backing)), header(header), ownEntry(ownEntry) {}
@@ -13,24 +13,28 @@ namespace skyline {
     namespace vfs {
         /**
          * @brief The RomFileSystem class abstracts access to a RomFS image using the vfs::FileSystem api
+         * @note Paths are resolved a component at a time through the hash tables in the image itself, so nothing is traversed or held in memory up-front
          */
         class RomFileSystem : public FileSystem {
           private:
+            static constexpr size_t MaxNameSize{0x300}; //!< The maximum size of the name of a single entry
+            static constexpr u32 RootDirectoryOffset{0};
+
             std::shared_ptr<Backing> backing;
 
             /**
-             * @brief Traverses the sibling files of the given file and adds them to the file map
-             * @param offset The offset of the file entry to traverses the siblings of
-             * @param path The path to the parent directory of the supplied file entry
+             * @brief Looks up an entry with the supplied parent directory and name in one of the image's hash tables
+             * @return The offset of the entry in its metadata table alongside the entry itself
              */
-            void TraverseFiles(u32 offset, const std::string &path);
+            template<typename EntryType>
+            std::optional<std::pair<u32, EntryType>> FindEntry(u64 hashTableOffset, u64 hashTableSize, u64 metaTableOffset, u32 parentOffset, std::string_view name);
 
             /**
-             * @brief Traverses the directories within the given directory, adds them to the directory map and calls TraverseFiles on them
-             * @param offset The offset of the directory entry to traverses the directories in
-             * @param path The path to the supplied directory entry
+             * @brief Resolves every component of the path aside from the last one as a directory
+             * @param name The last component of the path, this is empty if the path refers to the root directory
+             * @return The offset of the directory entry containing the last component of the path
              */
-            void TraverseDirectory(u32 offset, const std::string &path);
+            std::optional<u32> ResolveParent(std::string_view path, std::string_view &name);
 
           protected:
             std::shared_ptr<Backing> OpenFileImpl(const std::string &path, Backing::Mode mode) override;
@@ -59,7 +63,7 @@ namespace skyline {
                 u32 siblingOffset; //!< The offset from the directory metadata base of a sibling directory
                 u32 childOffset; //!< The offset from the directory metadata base of a child directory
                 u32 fileOffset; //!< The offset from the file metadata base of a child file
-                u32 hash; //!< The hash of the directory
+                u32 hashSiblingOffset; //!< The offset from the directory metadata base of the next directory in the same hash table bucket
                 u32 nameSize; //!< The size of the directory's name in bytes
             };
 
@@ -68,13 +72,10 @@ namespace skyline {
                 u32 siblingOffset; //!< The offset from the file metadata base of a sibling file
                 u64 offset; //!< The offset from the file data base of the file contents
                 u64 size; //!< The size of the file in bytes
-                u32 hash; //!< The hash of the file
+                u32 hashSiblingOffset; //!< The offset from the file metadata base of the next file in the same hash table bucket
                 u32 nameSize; //!< The size of the file's name in bytes
             };
 
-            std::unordered_map<std::string, RomFsFileEntry> fileMap; //!< A map that maps file names to their corresponding entry
-            std::unordered_map<std::string, RomFsDirectoryEntry> directoryMap; //!< A map that maps directory names to their corresponding entry
-
             RomFileSystem(std::shared_ptr<Backing> backing);
         };
 
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "write_back_backing.h"
+
+namespace skyline::vfs {
+    WriteBackCommitter::WriteBackCommitter() {
+        thread = std::thread(&WriteBackCommitter::Run, this);
+    }
+
+    WriteBackCommitter::~WriteBackCommitter() {
+        {
+            std::scoped_lock lock{mutex};
+            exit = true;
+        }
+        pendingCondition.notify_all();
+        thread.join();
+    }
+
+    void WriteBackCommitter::WriteFile(const std::string &path, span<const u8> contents) {
+        auto temporaryPath{path + std::string{TemporarySuffix}};
+        int fd{open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR)};
+        if (fd < 0)
+            throw exception("Failed to create temporary file '{}': {}", temporaryPath, strerror(errno));
+
+        auto fail{[&](std::string_view operation) {
+            int error{errno};
+            close(fd);
+            unlink(temporaryPath.c_str());
+            throw exception("Failed to {} temporary file '{}': {}", operation, temporaryPath, strerror(error));
+        }};
+
+        size_t written{};
+        while (written < contents.size()) {
+            auto ret{write(fd, contents.data() + written, contents.size() - written)};
+            if (ret < 0) {
+                if (errno == EINTR)
+                    continue;
+                fail("write");
+            }
+            written += static_cast<size_t>(ret);
+        }
+
+        // The contents must be on storage before the rename, otherwise a crash could leave a renamed but truncated file
+        if (fsync(fd))
+            fail("sync");
+        close(fd);
+
+        if (rename(temporaryPath.c_str(), path.c_str())) {
+            int error{errno};
+            unlink(temporaryPath.c_str());
+            throw exception("Failed to rename temporary file over '{}': {}", path, strerror(error));
+        }
+    }
+
+    void WriteBackCommitter::Run() {
+        if (int result{pthread_setname_np(pthread_self(), "Sky-WriteBack")})
+            Logger::Warn("Failed to set the thread name: {}", strerror(result));
+
+        std::unique_lock lock{mutex};
+        while (true) {
+            pendingCondition.wait(lock, [this] { return exit || !pending.empty(); });
+            if (pending.empty())
+                return; // We only exit once everything pending has been written, so no committed data is lost
+
+            auto entry{pending.begin()};
+            inFlightPath = entry->first;
+            inFlightContents = std::move(entry->second);
+            pending.erase(entry);
+
+            lock.unlock();
+            try {
+                WriteFile(inFlightPath, *inFlightContents);
+            } catch (const std::exception &e) {
+                Logger::Error("Failed to commit '{}': {}", inFlightPath, e.what());
+            }
+            lock.lock();
+
+            inFlightPath.clear();
+            inFlightContents.reset();
+            writtenCondition.notify_all();
+        }
+    }
+
+    void WriteBackCommitter::Enqueue(const std::string &path, std::shared_ptr<const std::vector<u8>> contents) {
+        {
+            std::scoped_lock lock{mutex};
+            pending.insert_or_assign(path, std::move(contents));
+        }
+        pendingCondition.notify_one();
+    }
+
+    std::shared_ptr<const std::vector<u8>> WriteBackCommitter::GetPending(const std::string &path) {
+        std::scoped_lock lock{mutex};
+        if (auto it{pending.find(path)}; it != pending.end())
+            return it->second;
+        if (inFlightPath == path)
+            return inFlightContents;
+        return nullptr;
+    }
+
+    void WriteBackCommitter::Discard(const std::string &path, bool directory) {
+        auto matches{[&](const std::string &entry) {
+            return directory ? entry.starts_with(path) : entry == path;
+        }};
+
+        std::unique_lock lock{mutex};
+        std::erase_if(pending, [&](const auto &entry) { return matches(entry.first); });
+        writtenCondition.wait(lock, [&] { return inFlightPath.empty() || !matches(inFlightPath); });
+    }
+
+    void StagedFile::Commit(WriteBackCommitter &committer) {
+        std::scoped_lock lock{mutex};
+        if (!dirty || discarded)
+            return;
+
+        // A snapshot is queued rather than the contents themselves so the guest can keep writing while it's written to storage
+        committer.Enqueue(path, std::make_shared<const std::vector<u8>>(contents));
+        dirty = false;
+    }
+
+    WriteBackBacking::WriteBackBacking(std::shared_ptr<StagedFile> pFile, std::shared_ptr<WriteBackCommitter> committer, Mode mode) : Backing(mode), file(std::move(pFile)), committer(std::move(committer)) {
+        std::scoped_lock lock{file->mutex};
+        size = file->contents.size();
+    }
+
+    WriteBackBacking::~WriteBackBacking() {
+        try {
+            file->Commit(*committer);
+        } catch (const std::exception &e) {
+            Logger::Error("Failed to queue the commit of '{}': {}", file->path, e.what());
+        }
+    }
+
+    size_t WriteBackBacking::ReadImpl(span<u8> output, size_t offset) {
+        std::scoped_lock lock{file->mutex};
+        auto &contents{file->contents};
+        if (offset >= contents.size())
+            return 0;
+
+        size_t readSize{std::min(output.size(), contents.size() - offset)};
+        std::memcpy(output.data(), contents.data() + offset, readSize);
+        return readSize;
+    }
+
+    size_t WriteBackBacking::WriteImpl(span<u8> input, size_t offset) {
+        std::scoped_lock lock{file->mutex};
+        auto &contents{file->contents};
+        // Writes past the end extend the file as they would with pwrite
+        if (offset + input.size() > contents.size()) {
+            contents.resize(offset + input.size());
+            size = contents.size();
+        }
+
+        std::memcpy(contents.data() + offset, input.data(), input.size());
+        file->dirty = true;
+        return input.size();
+    }
+
+    void WriteBackBacking::ResizeImpl(size_t pSize) {
+        std::scoped_lock lock{file->mutex};
+        file->contents.resize(pSize);
+        file->dirty = true;
+        size = pSize;
+    }
+}
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2022 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <unordered_map>
+#include "backing.h"
+
+namespace skyline::vfs {
+    /**
+     * @brief A background thread which atomically writes committed file contents to storage, so the guest never waits on flash writes
+     * @note Contents are written to a temporary file which is synced and then renamed over the original, the file on storage is always either entirely old or entirely new
+     */
+    class WriteBackCommitter {
+      public:
+        static constexpr std::string_view TemporarySuffix{".sky-wb"}; //!< The suffix of the temporary files which contents are written to prior to being renamed
+
+      private:
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable pendingCondition; //!< Signalled when contents are queued or the thread should exit
+        std::condition_variable writtenCondition; //!< Signalled when the in-flight write has completed
+        std::unordered_map<std::string, std::shared_ptr<const std::vector<u8>>> pending; //!< A map from host paths to the latest contents queued for them, requeueing a path before it's written only writes the latest contents
+        std::string inFlightPath; //!< The host path which is currently being written, this is empty if there's no write in-flight
+        std::shared_ptr<const std::vector<u8>> inFlightContents;
+        bool exit{};
+
+        /**
+         * @brief Writes the supplied contents to the host path through a temporary file
+         */
+        static void WriteFile(const std::string &path, span<const u8> contents);
+
+        void Run();
+
+      public:
+        WriteBackCommitter();
+
+        /**
+         * @note All pending contents are written prior to this returning
+         */
+        ~WriteBackCommitter();
+
+        /**
+         * @brief Queues the contents to be written to the host path, this replaces any contents for it that haven't started being written yet
+         */
+        void Enqueue(const std::string &path, std::shared_ptr<const std::vector<u8>> contents);
+
+        /**
+         * @return The latest contents queued for the host path which haven't been fully written yet, nullptr if there are none and the file on storage is up-to-date
+         */
+        std::shared_ptr<const std::vector<u8>> GetPending(const std::string &path);
+
+        /**
+         * @brief Drops all queued contents for the host path and waits for any in-flight write to it, this must be done prior to deleting a file
+         * @param directory If the path is a directory (ending with a separator) and all files inside it should be discarded
+         */
+        void Discard(const std::string &path, bool directory = false);
+    };
+
+    /**
+     * @brief The in-memory contents of a file which are staged with all writes to it till they're committed
+     * @note This is shared between all open backings of the same file so they observe each other's writes
+     */
+    struct StagedFile {
+        std::string path; //!< The host path of the file
+        std::mutex mutex;
+        std::vector<u8> contents;
+        bool dirty{}; //!< If the contents have been modified since they were last committed
+        bool discarded{}; //!< If the file has been deleted, its contents are never committed after this
+
+        StagedFile(std::string path, std::vector<u8> contents) : path(std::move(path)), contents(std::move(contents)) {}
+
+        /**
+         * @brief Queues a snapshot of the contents to be written to storage if they've been modified
+         */
+        void Commit(WriteBackCommitter &committer);
+    };
+
+    /**
+     * @brief A backing over a staged file, reads and writes are serviced entirely from memory and the contents are committed when the backing is closed
+     */
+    class WriteBackBacking : public Backing {
+      private:
+        std::shared_ptr<StagedFile> file;
+        std::shared_ptr<WriteBackCommitter> committer;
+
+      protected:
+        size_t ReadImpl(span<u8> output, size_t offset) override;
+
+        size_t WriteImpl(span<u8> input, size_t offset) override;
+
+        void ResizeImpl(size_t pSize) override;
+
+      public:
+        WriteBackBacking(std::shared_ptr<StagedFile> file, std::shared_ptr<WriteBackCommitter> committer, Mode mode);
+
+        ~WriteBackBacking();
+    };
+}
@@ -6,6 +6,7 @@
 package emu.skyline
 
 import android.annotation.SuppressLint
+import android.content.ComponentCallbacks2
 import android.content.Context
 import android.content.Intent
 import android.content.res.AssetManager
@@ -44,6 +45,8 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
     companion object {
         private val Tag = EmulationActivity::class.java.simpleName
         const val ReturnToMainTag = "returnToMain"
+        const val BenchmarkFramesTag = "benchmarkFrames"
+        const val BenchmarkScriptTag = "benchmarkScript"
 
         /**
          * The Kotlin thread on which emulation code executes
@@ -118,12 +121,52 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
     var fps : Int = 0
     var averageFrametime : Float = 0.0f
     var averageFrametimeDeviation : Float = 0.0f
+    var averagePresentLatency : Float = 0.0f
+    var droppedFrames : Int = 0
 
     /**
-     * Writes the current performance statistics into [fps], [averageFrametime] and [averageFrametimeDeviation] fields
+     * Writes the current performance statistics into [fps], [averageFrametime], [averageFrametimeDeviation], [averagePresentLatency] and [droppedFrames] fields
      */
     private external fun updatePerformanceStatistics()
 
+    /**
+     * @return The breakdown of frames presented since the last call as the amount of frames, their average frametime, the average milliseconds spent on guest CPU, GPFIFO, command recording, GPU execution and present waits followed by the amount of shaders compiled
+     */
+    private external fun getFrameStatistics() : FloatArray
+
+    /**
+     * @return A report of the call counts and latencies of every SVC and service command made by each guest thread so far
+     */
+    external fun dumpCallProfile() : String
+
+    /**
+     * @return A report of the timing of every stage of the audio pipeline alongside the fill level and underruns of every audio track
+     */
+    external fun dumpAudioStatistics() : String
+
+    /**
+     * @return A report of the native memory usage of every subsystem, such as guest memory, Vulkan allocations by category and caches
+     */
+    external fun dumpMemoryUsage() : String
+
+    /**
+     * @return The samples of the guest profiler so far in the collapsed stack format used by flame graph tools, this is empty if the profiler isn't enabled
+     */
+    external fun dumpGuestProfile() : String
+
+    /**
+     * Releases all memory held by native caches which can be repopulated on demand
+     */
+    private external fun trimMemory()
+
+    /**
+     * Sets up a benchmark for the next emulation session, it writes a JSON report to the public app files directory and stops emulation after the supplied amount of frames
+     *
+     * @param frames The amount of frames to run for, zero disables benchmarking
+     * @param scriptPath The full path to a script of input events to inject during the benchmark, null for no input
+     */
+    private external fun configureBenchmark(frames : Int, scriptPath : String?)
+
     /**
      * @see [InputHandler.initializeControllers]
      */
@@ -194,6 +237,9 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
         @SuppressLint("Recycle")
         val romFd = contentResolver.openFileDescriptor(rom, "r")!!
 
+        // Benchmarks are started from adb with the frame count and optionally an input script as extras, e.g. `am start -n emu.skyline/.EmulationActivity -d <rom uri> --ei benchmarkFrames 3600`
+        configureBenchmark(intent.getIntExtra(BenchmarkFramesTag, 0), intent.getStringExtra(BenchmarkScriptTag))
+
         GpuDriverHelper.ensureFileRedirectDir(this)
         emulationThread = Thread {
             executeApplication(rom.toString(), romType, romFd.detachFd(), NativeSettings(this, preferenceSettings), applicationContext.getPublicFilesDir().canonicalPath + "/", applicationContext.filesDir.canonicalPath + "/", applicationInfo.nativeLibraryDir + "/", assets)
@@ -245,7 +291,9 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
                 postDelayed(object : Runnable {
                     override fun run() {
                         updatePerformanceStatistics()
-                        text = "$fps FPS\n${"%.1f".format(averageFrametime)}±${"%.2f".format(averageFrametimeDeviation)}ms"
+                        val frameStats = getFrameStatistics()
+                        val frameBreakdown = if (frameStats[0] > 0) "\nCPU ${"%.1f".format(frameStats[2])} GPFIFO ${"%.1f".format(frameStats[3])} Rec ${"%.1f".format(frameStats[4])} GPU ${"%.1f".format(frameStats[5])} Wait ${"%.1f".format(frameStats[6])}ms, ${frameStats[7].toInt()} shaders" else ""
+                        text = "$fps FPS\n${"%.1f".format(averageFrametime)}±${"%.2f".format(averageFrametimeDeviation)}ms\n${"%.1f".format(averagePresentLatency)}ms latency, $droppedFrames dropped$frameBreakdown"
                         postDelayed(this, 250)
                     }
                 }, 250)
@@ -284,6 +332,16 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
         changeAudioStatus(false)
     }
 
+    override fun onTrimMemory(level : Int) {
+        super.onTrimMemory(level)
+
+        // Caches are only dropped once the system is low on memory, dropping them when the UI is merely hidden would only cause stutters when they're repopulated
+        if (level != ComponentCallbacks2.TRIM_MEMORY_UI_HIDDEN && level >= ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW) {
+            Log.i(Tag, "Trimming native memory (level $level):\n${dumpMemoryUsage()}")
+            trimMemory()
+        }
+    }
+
     override fun onStart() {
         super.onStart()
 
@@ -459,6 +517,19 @@ class EmulationActivity : AppCompatActivity(), SurfaceHolder.Callback, View.OnTo
         runOnUiThread { dialog.dismiss() }
     }
 
+    /**
+     * Updates the pipeline cache loading progress, this is hidden once all pipelines have been loaded
+     */
+    @Suppress("unused")
+    fun updatePipelineCacheProgress(progress : Int, total : Int) {
+        runOnUiThread {
+            binding.pipelineCacheProgress.apply {
+                isGone = progress >= total
+                text = getString(R.string.pipeline_cache_progress, progress, total)
+            }
+        }
+    }
+
     @Suppress("unused")
     fun showValidationResult(dialog : SoftwareKeyboardDialog, validationResult : Int, message : String) : Int {
         val confirm = validationResult == SoftwareKeyboardDialog.validationConfirm
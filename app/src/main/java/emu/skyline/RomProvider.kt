@@ -9,30 +9,48 @@ import emu.skyline.loader.AppEntry
 import emu.skyline.loader.RomFile
 import emu.skyline.loader.RomFormat
 import emu.skyline.loader.RomFormat.*
+import java.util.concurrent.Callable
+import java.util.concurrent.Executors
 import javax.inject.Inject
 import javax.inject.Singleton
 
 @Singleton
 class RomProvider @Inject constructor(@ApplicationContext private val context : Context) {
     /**
-     * This adds all files in [directory] with [extension] as an entry using [RomFile] to load metadata
+     * This collects all files in [directory] with an extension in [fileFormats] alongside their format
      */
     @SuppressLint("DefaultLocale")
-    private fun addEntries(fileFormats : Map<String, RomFormat>, directory : DocumentFile, entries : HashMap<RomFormat, ArrayList<AppEntry>>, systemLanguage : Int) {
+    private fun collectFiles(fileFormats : Map<String, RomFormat>, directory : DocumentFile, files : ArrayList<Pair<RomFormat, Uri>>) {
         directory.listFiles().forEach { file ->
             if (file.isDirectory) {
-                addEntries(fileFormats, file, entries, systemLanguage)
+                collectFiles(fileFormats, file, files)
             } else {
-                fileFormats[file.name?.substringAfterLast(".")?.lowercase()]?.let { romFormat->
-                    entries.getOrPut(romFormat, { arrayListOf() }).add(RomFile(context, romFormat, file.uri, systemLanguage).appEntry)
+                fileFormats[file.name?.substringAfterLast(".")?.lowercase()]?.let { romFormat ->
+                    files.add(romFormat to file.uri)
                 }
             }
         }
     }
 
+    /**
+     * This adds an entry for every ROM in [searchLocation] using [RomFile] to load metadata, the ROMs are parsed in parallel as parsing is mostly bound by storage latency and key derivation
+     */
     fun loadRoms(searchLocation : Uri, systemLanguage : Int) = DocumentFile.fromTreeUri(context, searchLocation)!!.let { documentFile ->
+        val files = arrayListOf<Pair<RomFormat, Uri>>()
+        collectFiles(mapOf("nro" to NRO, "nso" to NSO, "nca" to NCA, "nsp" to NSP, "xci" to XCI), documentFile, files)
+
+        val executor = Executors.newFixedThreadPool(Runtime.getRuntime().availableProcessors().coerceAtMost(files.size).coerceAtLeast(1))
+        val appEntries = try {
+            executor.invokeAll(files.map { (romFormat, uri) -> Callable { RomFile(context, romFormat, uri, systemLanguage).appEntry } }).map { it.get() }
+        } finally {
+            executor.shutdown()
+        }
+
+        // Entries are added in the order the files were found in, so the library order is the same as with a sequential scan
         hashMapOf<RomFormat, ArrayList<AppEntry>>().apply {
-            addEntries(mapOf("nro" to NRO, "nso" to NSO, "nca" to NCA, "nsp" to NSP, "xci" to XCI), documentFile, this, systemLanguage)
+            files.zip(appEntries).forEach { (file, appEntry) ->
+                getOrPut(file.first) { arrayListOf() }.add(appEntry)
+            }
         }
     }
 }
@@ -164,7 +164,7 @@ internal class RomFile(context : Context, format : RomFormat, uri : Uri, systemL
 
     init {
         context.contentResolver.openFileDescriptor(uri, "r")!!.use {
-            result = LoaderResult.get(populate(format.ordinal, it.fd, "${context.filesDir.canonicalPath}/keys/", systemLanguage))
+            result = LoaderResult.get(populate(format.ordinal, it.fd, "${context.filesDir.canonicalPath}/keys/", "${context.cacheDir.canonicalPath}/metadata", systemLanguage))
         }
 
         appEntry = applicationName?.let { name ->
@@ -185,7 +185,8 @@ internal class RomFile(context : Context, format : RomFormat, uri : Uri, systemL
      * @param format The format of the ROM
      * @param romFd A file descriptor of the ROM
      * @param appFilesPath Path to internal app data storage, needed to read imported keys
+     * @param metadataCachePath Path to the directory of the native metadata cache, ROMs which haven't changed since they were last parsed are read from it
      * @return A pointer to the newly allocated object, or 0 if the ROM is invalid
      */
-    private external fun populate(format : Int, romFd : Int, appFilesPath : String, systemLanguage : Int) : Int
+    private external fun populate(format : Int, romFd : Int, appFilesPath : String, metadataCachePath : String, systemLanguage : Int) : Int
 }
@@ -18,11 +18,21 @@ class NativeSettings(context : Context, pref : PreferenceSettings) {
     var profilePictureValue : String = pref.profilePictureValue
     var systemLanguage : Int = pref.systemLanguage
     var systemRegion : Int = pref.systemRegion
+    var pinGuestCores : Boolean = pref.pinGuestCores
+    var gpfifoAffinity : Int = pref.gpfifoAffinity
+    var commandRecordAffinity : Int = pref.commandRecordAffinity
+    var pipelineCompileAffinity : Int = pref.pipelineCompileAffinity
+    var audioAffinity : Int = pref.audioAffinity
+    var prefaultGuestMemory : Boolean = pref.prefaultGuestMemory
+    var warmBootSnapshot : Boolean = pref.warmBootSnapshot
+    var romFsCacheSize : Int = pref.romFsCacheSize
 
     // Display
     var forceTripleBuffering : Boolean = pref.forceTripleBuffering
     var disableFrameThrottling : Boolean = pref.disableFrameThrottling
+    var lowLatencyPresentation : Boolean = pref.lowLatencyPresentation
     var disableShaderCache : Boolean = pref.disableShaderCache
+    var disableTextureCache : Boolean = pref.disableTextureCache
 
     // GPU
     var gpuDriver : String = if (pref.gpuDriver == PreferenceSettings.SYSTEM_GPU_DRIVER) "" else pref.gpuDriver
@@ -31,16 +41,28 @@ class NativeSettings(context : Context, pref : PreferenceSettings) {
     var executorFlushThreshold : Int = pref.executorFlushThreshold
     var useDirectMemoryImport : Boolean = pref.useDirectMemoryImport
     var forceMaxGpuClocks : Boolean = pref.forceMaxGpuClocks
+    var useGpuTextureDeswizzle : Boolean = pref.useGpuTextureDeswizzle
+    var asyncWriteTracking : Boolean = pref.asyncWriteTracking
+    var asyncPipelineCreation : Boolean = pref.asyncPipelineCreation
+    var textureMemoryBudget : Int = pref.textureMemoryBudget
+    var resolutionScale : Int = pref.resolutionScale
 
     // Hacks
     var enableFastGpuReadbackHack : Boolean = pref.enableFastGpuReadbackHack
     var disableSubgroupShuffle : Boolean = pref.disableSubgroupShuffle
+    var hleServiceFastPath : Boolean = pref.hleServiceFastPath
 
     // Audio
     var isAudioOutputDisabled : Boolean = pref.isAudioOutputDisabled
+    var highQualityAudioResampling : Boolean = pref.highQualityAudioResampling
+    var audioTimeStretching : Boolean = pref.audioTimeStretching
 
     // Debug
     var validationLayer : Boolean = BuildConfig.BUILD_TYPE != "release" && pref.validationLayer
+    var logUnhandledMacros : Boolean = pref.logUnhandledMacros
+    var guestProfiler : Boolean = pref.guestProfiler
+    var flightRecorderThreshold : Int = pref.flightRecorderThreshold
+    var gpfifoCapture : Boolean = pref.gpfifoCapture
 
     /**
      * Updates settings in libskyline during emulation
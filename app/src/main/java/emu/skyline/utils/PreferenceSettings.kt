@@ -30,15 +30,25 @@ class PreferenceSettings @Inject constructor(@ApplicationContext private val con
     var profilePictureValue by sharedPreferences(context, "")
     var systemLanguage by sharedPreferences(context, 1)
     var systemRegion by sharedPreferences(context, -1)
+    var pinGuestCores by sharedPreferences(context, true)
+    var gpfifoAffinity by sharedPreferences(context, 2)
+    var commandRecordAffinity by sharedPreferences(context, 2)
+    var pipelineCompileAffinity by sharedPreferences(context, 3)
+    var audioAffinity by sharedPreferences(context, 0)
+    var prefaultGuestMemory by sharedPreferences(context, false)
+    var warmBootSnapshot by sharedPreferences(context, false)
+    var romFsCacheSize by sharedPreferences(context, 64)
 
     // Display
     var forceTripleBuffering by sharedPreferences(context, true)
     var disableFrameThrottling by sharedPreferences(context, false)
+    var lowLatencyPresentation by sharedPreferences(context, false)
     var maxRefreshRate by sharedPreferences(context, false)
     var aspectRatio by sharedPreferences(context, 0)
     var orientation by sharedPreferences(context, ActivityInfo.SCREEN_ORIENTATION_SENSOR_LANDSCAPE)
     var respectDisplayCutout by sharedPreferences(context, false)
     var disableShaderCache by sharedPreferences(context, false)
+    var disableTextureCache by sharedPreferences(context, false)
 
     // GPU
     var gpuDriver by sharedPreferences(context, SYSTEM_GPU_DRIVER)
@@ -46,16 +56,28 @@ class PreferenceSettings @Inject constructor(@ApplicationContext private val con
     var executorFlushThreshold by sharedPreferences(context, 256)
     var useDirectMemoryImport by sharedPreferences(context, false)
     var forceMaxGpuClocks by sharedPreferences(context, false)
+    var useGpuTextureDeswizzle by sharedPreferences(context, true)
+    var asyncWriteTracking by sharedPreferences(context, false)
+    var asyncPipelineCreation by sharedPreferences(context, false)
+    var textureMemoryBudget by sharedPreferences(context, 0)
+    var resolutionScale by sharedPreferences(context, 100)
 
     // Hacks
     var enableFastGpuReadbackHack by sharedPreferences(context, false)
     var disableSubgroupShuffle by sharedPreferences(context, false)
+    var hleServiceFastPath by sharedPreferences(context, false)
 
     // Audio
     var isAudioOutputDisabled by sharedPreferences(context, false)
+    var highQualityAudioResampling by sharedPreferences(context, false)
+    var audioTimeStretching by sharedPreferences(context, true)
 
     // Debug
     var validationLayer by sharedPreferences(context, false)
+    var logUnhandledMacros by sharedPreferences(context, false)
+    var guestProfiler by sharedPreferences(context, false)
+    var flightRecorderThreshold by sharedPreferences(context, 0)
+    var gpfifoCapture by sharedPreferences(context, false)
 
     // Input
     var onScreenControl by sharedPreferences(context, true)
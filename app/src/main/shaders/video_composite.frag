@@ -0,0 +1,17 @@
+#version 460
+
+// The source is sampled through an immutable sampler with a YCbCr conversion, this yields RGB without any explicit conversion
+layout (binding = 0, set = 0) uniform sampler2D src;
+layout (location = 0) in vec2 dstUV;
+layout (location = 0) out vec4 colour;
+
+layout (push_constant) uniform constants {
+    layout (offset = 16)
+    vec2 srcOriginUV;
+    vec2 srcScaleUV;
+} PC;
+
+void main()
+{
+    colour = vec4(texture(src, dstUV * PC.srcScaleUV + PC.srcOriginUV).rgb, 1.0);
+}